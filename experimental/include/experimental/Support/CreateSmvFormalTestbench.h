@@ -16,6 +16,7 @@
 #define DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_CREATE_FORMAL_TESTBENCH_H
 
 #include "dynamatic/Support/LLVM.h"
+#include "experimental/Support/SmvModel.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Types.h"
 #include <cstddef>
@@ -62,105 +63,12 @@ struct SmvTestbenchConfig {
 //   capabale of creating an infinite number of tokens will be created.
 // exact: determines if the sequence generator create exactly "nrOfTokens"
 //   tokens, or can non-determinstically create fewer tokens.
-std::string createSmvFormalTestbench(const SmvTestbenchConfig &config);
-
-// SMV module for a sequence generator with a finite number of tokens. The
-// actual number of generated tokens is non-determinstically set between 0
-// and (inclusive) max_tokens.
-const std::string SMV_BOOL_INPUT = R"DELIM(
-MODULE bool_input(nReady0, max_tokens)
-  VAR outs : boolean;
-  VAR counter : 0..31;
-  FROZENVAR exact_tokens : 0..max_tokens;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
-      nReady0 & counter < exact_tokens : counter + 1;
-      TRUE : counter;
-    esac;
-
-  -- make sure outs is persistent
-  ASSIGN
-    next(outs) := case
-      outs_valid & !nReady0 : outs;
-      TRUE : {TRUE, FALSE};
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;)DELIM";
-
-// SMV module for a sequence generator with a finite number of tokens. The
-// number of generated tokens is exact_tokens.
-const std::string SMV_BOOL_INPUT_EXACT = R"DELIM(
-MODULE bool_input_exact(nReady0, exact_tokens)
-  VAR outs : boolean;
-  VAR counter : 0..31;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
-      nReady0 & counter < exact_tokens : counter + 1;
-      TRUE : counter;
-    esac;
-
-  -- make sure outs is persistent
-  ASSIGN
-    next(outs) := case
-      outs_valid & !nReady0 : outs;
-      TRUE : {TRUE, FALSE};
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;)DELIM";
+SmvModel createSmvFormalTestbenchModel(const SmvTestbenchConfig &config);
 
-// SMV module for a sequence generator with an infinite number of tokens
-const std::string SMV_BOOL_INPUT_INF = R"DELIM(
-MODULE bool_input_inf(nReady0)
-    VAR outs : boolean;
-    
-    -- make sure outs is persistent
-    ASSIGN
-    next(outs) := case 
-      outs_valid & !nReady0 : outs;
-      TRUE : {TRUE, FALSE};
-    esac;
-    DEFINE outs_valid := TRUE;)DELIM";
-
-// SMV module for a sequence generator with an infinite number of tokens
-const std::string SMV_CTRL_INPUT_INF = R"DELIM(
-MODULE ctrl_input_inf(nReady0)
-  DEFINE outs_valid := TRUE;)DELIM";
-
-// SMV module for a sequence generator with a finite number of tokens. The
-// actual number of generated tokens is non-determinstically set between 0
-// and (inclusive) max_tokens.
-const std::string SMV_CTRL_INPUT = R"DELIM(
-MODULE ctrl_input(nReady0, max_tokens)
-  VAR counter : 0..31;
-  FROZENVAR exact_tokens : 0..max_tokens;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
-      nReady0 & counter < exact_tokens : counter + 1;
-      TRUE : counter;
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;)DELIM";
-
-// SMV module for a sequence generator with a finite number of tokens. The
-// number of generated tokens is exact_tokens.
-const std::string SMV_CTRL_INPUT_EXACT = R"DELIM(
-MODULE ctrl_input_exact(nReady0, exact_tokens)
-  VAR counter : 0..31;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
-      nReady0 & counter < exact_tokens : counter + 1;
-      TRUE : counter;
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;)DELIM";
-
-const std::string SMV_SINK = R"DELIM(
-MODULE sink(ins_valid)
-  DEFINE ins_ready := TRUE;)DELIM";
+// Same as createSmvFormalTestbenchModel, but returns the wrapper printed in SMV
+// syntax. The main module is printed last, so that callers can append more
+// declarations to it.
+std::string createSmvFormalTestbench(const SmvTestbenchConfig &config);
 
 } // namespace dynamatic::experimental
 #endif // DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_CREATE_FORMAL_TESTBENCH_H
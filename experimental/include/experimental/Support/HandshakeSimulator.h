@@ -1,5 +1,6 @@
 #ifndef EXPERIMENTAL_SUPPORT_HANDSHAKE_SIMULATOR_H
 #define EXPERIMENTAL_SUPPORT_HANDSHAKE_SIMULATOR_H
+#include "dynamatic/Analysis/TokenLineage.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
 #include "dynamatic/Support/LLVM.h"
@@ -59,6 +60,14 @@ class ValueState {
 public:
   ValueState(Value val);
 
+  /// Whether a token is transferred on the value at the next clock edge (i.e.,
+  /// whether both its valid and ready signals are set).
+  virtual bool isTransferring() const { return false; }
+
+  /// Returns the data carried by the value, printed as a string (empty for
+  /// dataless values).
+  virtual std::string getDataString() const { return ""; }
+
   virtual ~ValueState() = default;
 
 protected:
@@ -84,6 +93,10 @@ public:
 
   ChannelState(TypedValue<handshake::ChannelType> channel);
 
+  bool isTransferring() const override { return valid && ready; }
+
+  std::string getDataString() const override;
+
 protected:
   bool valid = false;
   bool ready = false;
@@ -103,6 +116,8 @@ public:
 
   ControlState(TypedValue<handshake::ControlType> control);
 
+  bool isTransferring() const override { return valid && ready; }
+
 protected:
   bool valid = false;
   bool ready = false;
@@ -936,6 +951,13 @@ public:
   // A temporary function
   void printModelStates();
 
+  /// Records all token transfers happening during the simulation in the
+  /// lineage recorder, which must outlive the simulation. Pass `nullptr` to
+  /// stop recording.
+  void setLineageRecorder(TokenLineageRecorder *recorder) {
+    lineage = recorder;
+  }
+
   ~Simulator();
 
 private:
@@ -970,6 +992,8 @@ private:
   /// Maps all operation results (OpResult) and block arguments
   /// (BlockArgument) to their *producer*'s RW object.
   mlir::DenseMap<Value, ProducerRW *> producerViews;
+  /// Optional recorder for the lineage of transferred tokens.
+  TokenLineageRecorder *lineage = nullptr;
 
   // Register the Model inside opNodels
   template <typename Model, typename Op, typename... Args>
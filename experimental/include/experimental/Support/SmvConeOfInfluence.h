@@ -0,0 +1,80 @@
+//===- SmvConeOfInfluence.h - COI reduction of SMV models -------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Cone-of-influence reduction of the netlist-level SMV modules built by
+// export-rtl. The reduction keeps only the instances the module's properties
+// depend on, optionally up to a maximum distance from the properties, and
+// replaces the signals of removed instances with free inputs. Free inputs that
+// stand for the producer side of a handshake channel are constrained by the
+// handshake protocol (a valid token stays valid and unchanged until it is
+// accepted), so the reduced module over-approximates the behavior of the
+// original module at the cut.
+//
+// Properties proven on a reduced module hold on the original module. When the
+// reduction is not exact, counterexamples found on the reduced module may be
+// spurious; they can be expressed in terms of the original module's signals
+// with `SmvReduction::mapTrace`.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_CONE_OF_INFLUENCE_H
+#define DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_CONE_OF_INFLUENCE_H
+
+#include "dynamatic/Support/LLVM.h"
+#include "experimental/Support/SmvModel.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dynamatic::experimental {
+
+/// Summary of a cone-of-influence reduction, which also allows to map
+/// counterexamples on the reduced module back to the original module.
+struct SmvReduction {
+  /// Number of instances in the original module.
+  unsigned numInstances = 0;
+  /// Names of the instances removed from the module.
+  std::vector<std::string> removedInstances;
+  /// Number of handshake channels abstracted at the cut.
+  unsigned numCutChannels = 0;
+  /// Number of constraints removed from the module because they referenced
+  /// the internal state of removed instances.
+  unsigned numDroppedConstraints = 0;
+  /// Maps each free input introduced at the cut to the signal of the original
+  /// module it stands for.
+  llvm::StringMap<std::string> freeInputs;
+  /// Whether the properties' behavior is unaffected by the reduction, in
+  /// which case counterexamples on the reduced module are never spurious.
+  bool exact = true;
+
+  /// Returns the name of the free input standing for the signal.
+  static std::string getFreeInputName(StringRef signal);
+
+  /// Renames the free inputs of the reduced module in the trace to the
+  /// signals of the original module they stand for. Values of removed
+  /// instances' internal state are, by definition, absent from the trace.
+  void mapTrace(SmvTrace &trace) const;
+
+  /// Prints a human-readable report of the reduction.
+  void print(raw_ostream &os) const;
+};
+
+/// Reduces the module to the cone of influence of its properties (`INVARSPEC`,
+/// `LTLSPEC`, and `CTLSPEC` specs). When `maxDepth` is provided, only instances
+/// at most that many instances away from the properties are kept, and the
+/// rest of the circuit is abstracted by free inputs; otherwise, the reduction
+/// is exact. All defines and parameters of the module are kept so that the
+/// reduced module remains a drop-in replacement for the original one.
+SmvReduction reduceToConeOfInfluence(SmvModule &mod,
+                                     std::optional<unsigned> maxDepth = {});
+
+} // namespace dynamatic::experimental
+
+#endif // DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_CONE_OF_INFLUENCE_H
@@ -0,0 +1,283 @@
+//===- SmvModel.h - In-memory SMV models and traces -------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// In-memory representation of SMV models, as checked by NuSMV and nuXmv, and
+// of the counterexample traces these model checkers produce. Models are built
+// programmatically (e.g., from an HW netlist by export-rtl) and only turned
+// into text when printed; traces are parsed once into a sequence of variable
+// assignments. This lets formal tools construct, slice, and inspect models and
+// their counterexamples without matching text.
+//
+// Expressions are kept as SMV text, but the structure of modules (variables,
+// instances of other modules and the signals bound to their parameters,
+// defines, assignments, and specifications) is explicit.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_MODEL_H
+#define DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_MODEL_H
+
+#include "dynamatic/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/raw_ostream.h"
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dynamatic::experimental {
+
+/// A module of an SMV model.
+struct SmvModule {
+  /// A state variable.
+  struct Variable {
+    /// Name of the variable.
+    std::string name;
+    /// SMV type of the variable (e.g., `boolean`, `0..31`).
+    std::string type;
+    /// Whether the variable keeps its initial value forever (`FROZENVAR`).
+    bool frozen = false;
+  };
+
+  /// An instance of another module.
+  struct Instance {
+    /// Name of the instance.
+    std::string name;
+    /// Name of the instantiated module.
+    std::string moduleName;
+    /// Expressions bound to the instantiated module's parameters, in order.
+    std::vector<std::string> args;
+  };
+
+  /// A named expression (`DEFINE`).
+  struct Define {
+    /// Name of the define.
+    std::string name;
+    /// Expression the name stands for.
+    std::string expr;
+  };
+
+  /// Initial and/or next-state assignment of a state variable.
+  struct Assignment {
+    /// Name of the assigned variable.
+    std::string var;
+    /// Expression for the variable's initial value, if constrained.
+    std::optional<std::string> init;
+    /// Expression for the variable's next value, if constrained.
+    std::optional<std::string> next;
+  };
+
+  /// A constraint on, or a property of, the module's behavior.
+  struct Spec {
+    enum class Kind {
+      /// Constraint restricting the module's states (`INVAR`).
+      INVAR,
+      /// Constraint restricting the module's transitions (`TRANS`).
+      TRANS,
+      /// Invariant to check (`INVARSPEC`).
+      INVARSPEC,
+      /// LTL property to check (`LTLSPEC`).
+      LTLSPEC,
+      /// CTL property to check (`CTLSPEC`).
+      CTLSPEC
+    };
+
+    /// Type of spec.
+    Kind kind;
+    /// Expression or temporal formula of the spec.
+    std::string expr;
+    /// Name under which model checkers report on the property, if any.
+    std::string name;
+    /// Comment printed above the spec, if any.
+    std::string comment;
+  };
+
+  /// A typed signal.
+  struct Signal {
+    /// Name of the signal.
+    std::string name;
+    /// SMV type of the signal.
+    std::string type;
+  };
+
+  /// A handshake channel from an instance to another instance or to the
+  /// module's outputs. Channels are not printed; they describe how signals
+  /// bound to instances relate to each other so that transformations can
+  /// reason about the handshake protocol.
+  struct Channel {
+    /// Name of the instance producing the channel's tokens.
+    std::string producer;
+    /// Name of the instance consuming the channel's tokens, or an empty string
+    /// if the channel is an output of the module.
+    std::string consumer;
+    /// Valid signal, set by the producer.
+    std::string valid;
+    /// Ready signal, set by the consumer.
+    std::string ready;
+    /// Data and extra signals carried along with tokens, set by the producer.
+    std::vector<Signal> payload;
+  };
+
+  /// Name of the module.
+  std::string name;
+  /// Names of the module's parameters, in order.
+  std::vector<std::string> params;
+  /// State variables.
+  std::vector<Variable> variables;
+  /// Instances of other modules.
+  std::vector<Instance> instances;
+  /// Named expressions.
+  std::vector<Define> defines;
+  /// Assignments to state variables.
+  std::vector<Assignment> assignments;
+  /// Constraints and properties.
+  std::vector<Spec> specs;
+  /// Handshake channels between instances.
+  std::vector<Channel> channels;
+
+  /// Creates an empty module.
+  SmvModule(StringRef name, ArrayRef<std::string> params = {})
+      : name(name), params(params) {}
+
+  /// Adds a state variable to the module.
+  Variable &addVariable(StringRef varName, StringRef type,
+                        bool frozen = false);
+
+  /// Adds an instance of another module to the module.
+  Instance &addInstance(StringRef instName, StringRef moduleName,
+                        ArrayRef<std::string> args);
+
+  /// Adds a named expression to the module.
+  Define &addDefine(StringRef defName, StringRef expr);
+
+  /// Adds an assignment to a state variable of the module.
+  Assignment &addAssignment(StringRef var,
+                            std::optional<std::string> init = std::nullopt,
+                            std::optional<std::string> next = std::nullopt);
+
+  /// Adds a constraint or property to the module.
+  Spec &addSpec(Spec::Kind kind, StringRef expr, StringRef specName = {},
+                StringRef comment = {});
+
+  /// Adds a handshake channel to the module.
+  Channel &addChannel(StringRef producer, StringRef consumer, StringRef valid,
+                      StringRef ready, ArrayRef<Signal> payload = {});
+
+  /// Returns the instance with the name, or `nullptr` if there is none.
+  const Instance *getInstance(StringRef instName) const;
+
+  /// Returns the define with the name, or `nullptr` if there is none.
+  const Define *getDefine(StringRef defName) const;
+
+  /// Prints the module in SMV syntax.
+  void print(raw_ostream &os) const;
+};
+
+/// An SMV model, made up of modules and of files included by the model
+/// checker's preprocessor.
+struct SmvModel {
+  /// Files included with `#include` at the top of the model (requires the
+  /// model checker's `cpp` preprocessor).
+  std::vector<std::string> includes;
+  /// Modules of the model, in order. References to modules remain valid when
+  /// adding more modules.
+  std::deque<SmvModule> modules;
+
+  /// Adds an include to the model unless it is already present.
+  void addInclude(StringRef filename);
+
+  /// Adds an empty module to the model.
+  SmvModule &addModule(StringRef name, ArrayRef<std::string> params = {});
+
+  /// Returns the module with the name, or `nullptr` if there is none.
+  SmvModule *getModule(StringRef name);
+  const SmvModule *getModule(StringRef name) const;
+
+  /// Prints the model in SMV syntax.
+  void print(raw_ostream &os) const;
+
+  /// Prints the model to the file. Fails if the file cannot be created.
+  LogicalResult writeToFile(const std::filesystem::path &filepath) const;
+};
+
+/// A counterexample trace produced by NuSMV or nuXmv's `show_traces` command,
+/// in its default textual format or in XML format (`-p 4`).
+class SmvTrace {
+public:
+  /// One step of the trace.
+  struct Step {
+    /// Values of all state variables (carried over from previous steps when
+    /// they do not change) and of the inputs and defines reported at this
+    /// step, keyed by their hierarchical name (e.g., `model.fork0.sent_0`).
+    llvm::StringMap<std::string> values;
+  };
+
+  /// Parses the first trace in the file. Fails and prints an error to stderr
+  /// if the file cannot be read or does not contain a trace.
+  static FailureOr<SmvTrace>
+  parseFromFile(const std::filesystem::path &filepath);
+
+  /// Parses the first trace in the text, whose format is detected
+  /// automatically. Fails and prints an error to stderr if the text does not
+  /// contain a trace.
+  static FailureOr<SmvTrace> parse(StringRef text);
+
+  /// Returns the trace's description (e.g., "LTL Counterexample").
+  StringRef getDescription() const { return description; }
+
+  /// Returns all steps of the trace, in order.
+  ArrayRef<Step> getSteps() const { return steps; }
+
+  /// Returns the number of steps in the trace.
+  size_t size() const { return steps.size(); }
+
+  /// Returns the index of the step the trace loops back to after its last
+  /// step, for lasso-shaped counterexamples to liveness properties.
+  std::optional<unsigned> getLoopStart() const { return loopStart; }
+
+  /// Returns the value of the variable at the step, or `std::nullopt` if the
+  /// trace does not report on the variable.
+  std::optional<StringRef> getValue(unsigned step, StringRef var) const;
+
+  /// Returns the variables whose value at the step differs from their value
+  /// at the previous step (all variables reported at the first step).
+  std::vector<std::string> getChanges(unsigned step) const;
+
+  /// Renames all variables of the trace. The function returns the new name of
+  /// each variable.
+  void renameVariables(llvm::function_ref<std::string(StringRef)> rename);
+
+  /// Prints the trace with one line per variable change.
+  void print(raw_ostream &os) const;
+
+private:
+  /// Description of the trace.
+  std::string description;
+  /// Steps of the trace.
+  std::vector<Step> steps;
+  /// Names of the state variables (as opposed to inputs and defines).
+  llvm::StringSet<> stateVars;
+  /// Index of the step the trace loops back to, if any.
+  std::optional<unsigned> loopStart;
+
+  /// Parsers for each supported format.
+  static FailureOr<SmvTrace> parseXML(StringRef text);
+  static FailureOr<SmvTrace> parseText(StringRef text);
+
+  /// Returns the step with the 1-based index used by model checkers, creating
+  /// it (and carrying over the state of the previous step) if needed.
+  Step &getOrCreateStep(unsigned id);
+};
+
+} // namespace dynamatic::experimental
+
+#endif // DYNAMATIC_EXPERIMENTAL_SUPPORT_SMV_MODEL_H
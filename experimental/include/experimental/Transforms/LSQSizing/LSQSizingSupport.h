@@ -15,7 +15,7 @@
 
 #include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
-#include "dynamatic/Support/TimingModels.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/CFDFC.h"
 #include <list>
 #include <mlir/IR/Operation.h>
@@ -53,9 +53,9 @@ struct CFDFCNode {
 class CFDFCGraph {
 public:
   /// Constructor for the graph, which takes a Vector of BBs, which make up a
-  /// single CFDFC
+  /// single CFDFC. Node latencies are given by the cost model
   CFDFCGraph(handshake::FuncOp funcOp, llvm::SetVector<unsigned> cfdfcBBs,
-             TimingDatabase timingDB, unsigned II, double targetCP);
+             CostModel &costModel, unsigned II);
 
   /// Adds the edges between the start node and the start node candidates, with
   /// their respective shifting in the start time These edges are necessary to
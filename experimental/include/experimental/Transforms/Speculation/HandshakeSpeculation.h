@@ -0,0 +1,33 @@
+//===- HandshakeSpeculation.h - Speculative Dataflows -----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Declares the structural verification of speculative units run at the end of
+// the speculation pass.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_TRANSFORMS_SPECULATION_HANDSHAKESPECULATION_H
+#define DYNAMATIC_TRANSFORMS_SPECULATION_HANDSHAKESPECULATION_H
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+
+namespace dynamatic {
+namespace experimental {
+
+/// Verifies that the speculative units of the function form a consistent
+/// structure. Every speculative region must be delimited by commits that belong
+/// to it only, every commit must be controlled by the speculator whose region
+/// it delimits, and every save-commit must be controlled by a single
+/// speculator. Emits an error on the first inconsistent unit.
+LogicalResult verifySpeculativeUnits(handshake::FuncOp funcOp);
+
+} // namespace experimental
+} // namespace dynamatic
+
+#endif // DYNAMATIC_TRANSFORMS_SPECULATION_HANDSHAKESPECULATION_H
@@ -27,8 +27,11 @@ class PlacementFinder {
 
 public:
   /// Initializer with a SpeculationPlacements instance. Assumes that the
-  /// Speculator position is set
-  PlacementFinder(SpeculationPlacements &placements);
+  /// Speculator position is set. `otherSpecBBs` holds the BBs containing other
+  /// speculators of the same function; speculative tokens are committed before
+  /// entering them so that speculative regions do not overlap.
+  PlacementFinder(SpeculationPlacements &placements,
+                  const llvm::DenseSet<unsigned> &otherSpecBBs = {});
 
   /// Find the speculative unit positions. Mutates the internal
   /// SpeculationPlacements data structure
@@ -38,6 +41,9 @@ private:
   /// Mutable SpeculationPlacements data structure to hold the placements
   SpeculationPlacements &placements;
 
+  /// BBs containing the speculators of other speculation points
+  llvm::DenseSet<unsigned> otherSpecBBs;
+
   /// Find save operations positions
   LogicalResult findSaves();
 
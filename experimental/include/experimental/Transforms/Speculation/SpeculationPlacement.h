@@ -54,12 +54,19 @@ public:
   SpeculationPlacements(OpOperand &speculatorPosition)
       : speculator(&speculatorPosition) {};
 
-  /// Set the speculator position from a `dynamatic.speculate` dict attribute
-  /// on the given producer op. Sets both speculatorFifoDepth and
+  /// Set the speculator position from the `dynamatic.speculate` dict
+  /// attribute on the given producer op. Sets both speculatorFifoDepth and
   /// saveCommitsFifoDepth from the attribute's `max_predictions` entry.
-  static LogicalResult readFromAttribute(mlir::ModuleOp modOp,
+  static LogicalResult readFromAttribute(mlir::Operation *producer,
                                          SpeculationPlacements &place);
 
+  /// Create one set of placements per op carrying a `dynamatic.speculate`
+  /// attribute in the module, in IR order. Fails if no op carries the
+  /// attribute or if any of the attributes is malformed.
+  static LogicalResult
+  readFromAttributes(mlir::ModuleOp modOp,
+                     SmallVectorImpl<SpeculationPlacements> &allPlacements);
+
   /// Explicitly set the speculator position
   void setSpeculator(OpOperand &dstOpOperand);
 
@@ -13,23 +13,23 @@
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Support/LogicalResult.h"
-#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace mlir;
 
 namespace dynamatic::experimental {
 
-/// Create the call to the module
-/// The resulting string will look like:
+/// Instantiates the module under test. The resulting instance will look like:
 /// VAR <moduleName> : <moduleName> (seq_generator_A.outs,
 /// seq_generator_A.outs_valid, ..., sink_F.ins_ready, ...)
-static std::string instantiateModuleUnderTest(
-    const std::string &moduleName,
+static void instantiateModuleUnderTest(
+    SmvModule &main, const std::string &moduleName,
     const SmallVector<std::pair<std::string, mlir::Type>> &arguments,
     const SmallVector<std::pair<std::string, mlir::Type>> &results,
     bool syncOutput = false) {
@@ -97,20 +97,7 @@ static std::string instantiateModuleUnderTest(
             llvm::formatv("sink_{0}.{1}", resultName, SINK_READY_NAME.str()));
     }
 
-  return llvm::formatv("  VAR {0} : {1} ({2});\n", moduleName, moduleName,
-                       llvm::join(inputVariables, ", "))
-      .str();
-}
-
-std::optional<std::string> getPrefixTypeName(const Type &type) {
-  return llvm::TypeSwitch<Type, std::optional<std::string>>(type)
-      .Case<handshake::ControlType>(
-          [&](handshake::ControlType cType) { return std::nullopt; })
-      .Case<handshake::ChannelType>([&](handshake::ChannelType cType) {
-        if (cType.getDataBitWidth() == 1)
-          return std::string("bool");
-        return "s" + std::to_string(cType.getDataBitWidth());
-      });
+  main.addInstance(moduleName, moduleName, inputVariables);
 }
 
 static std::optional<std::string> convertMLIRTypeToSMV(const Type &type) {
@@ -125,273 +112,206 @@ static std::optional<std::string> convertMLIRTypeToSMV(const Type &type) {
       });
 }
 
-/// SMV module for a sequence generator with a finite number of tokens. The
-/// actual number of generated tokens is non-determinstically set between 0
-/// and (inclusive) max_tokens.
-std::string smvInput(const Type &type) {
-  return llvm::formatv(R"DELIM(
-MODULE {0}_input(nReady0, max_tokens)
-  VAR outs : {1};
-  VAR counter : 0..31;
-  FROZENVAR exact_tokens : 0..max_tokens;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
+/// Next-state expression of the token counter of sequence generators with a
+/// finite number of tokens.
+static constexpr llvm::StringLiteral NEXT_COUNTER(R"DELIM(case
       nReady0 & counter < exact_tokens : counter + 1;
       TRUE : counter;
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;
-
-)DELIM",
-                       *getPrefixTypeName(type), *convertMLIRTypeToSMV(type));
+    esac)DELIM");
+
+/// Next-state expression keeping the data of sequence generators persistent
+/// while their token is not consumed.
+static constexpr llvm::StringLiteral NEXT_PERSISTENT_OUTS(R"DELIM(case
+      outs_valid & !nReady0 : outs;
+      TRUE : {TRUE, FALSE};
+    esac)DELIM");
+
+/// Returns the prefix of the name of the sequence generator modules for the
+/// type.
+static std::string getGeneratorPrefix(Type type) {
+  return llvm::TypeSwitch<Type, std::string>(type)
+      .Case<handshake::ControlType>([&](auto) { return std::string("ctrl"); })
+      .Case<handshake::ChannelType>([&](handshake::ChannelType cType) {
+        if (cType.getDataBitWidth() == 1)
+          return std::string("bool");
+        return "s" + std::to_string(cType.getDataBitWidth());
+      });
 }
 
-/// SMV module for a sequence generator with a finite number of tokens. The
-/// number of generated tokens is exact_tokens.
-std::string smvInputExact(const Type &type) {
-  return llvm::formatv(R"DELIM(
-MODULE {0}_input_exact(nReady0, exact_tokens)
-  VAR outs : {1};
-  VAR counter : 0..31;
-  ASSIGN
-    init(counter) := 0;
-    next(counter) := case
-      nReady0 & counter < exact_tokens : counter + 1;
-      TRUE : counter;
-    esac;
-
-  DEFINE outs_valid := counter < exact_tokens;
-
-)DELIM",
-                       *getPrefixTypeName(type), *convertMLIRTypeToSMV(type));
+/// Returns the name of the sequence generator module for the type.
+static std::string getGeneratorName(Type type, size_t nrOfTokens,
+                                    bool generateExactNrOfTokens) {
+  std::string name = getGeneratorPrefix(type) + "_input";
+  if (nrOfTokens == 0)
+    return name + "_inf";
+  if (generateExactNrOfTokens)
+    return name + "_exact";
+  return name;
 }
 
-/// SMV module for a sequence generator with an infinite number of tokens
-std::string smvInputInf(const Type &type) {
-  return llvm::formatv(R"DELIM(
-MODULE {0}_input_inf(nReady0)
-  VAR outs : {1};
-
-  -- make sure outs is persistent
-  DEFINE outs_valid := TRUE;
+/// Adds the SMV module of a sequence generator for the type to the model. We
+/// support three different kinds of sequence generators:
+/// 1. Infinite sequence generator: Will create an infinite number of
+/// tokens.
+/// 2. Standard finite generator: Will create 0 to the maximal number of
+/// tokens. The exact number of tokens is non-deterministic.
+/// 3. Exact finite generator: Will create the exact number of tokens (if
+/// it receives enough ready inputs).
+/// When nrOfTokens is set to 0, the infinite sequence generator is created
+/// and the value of generateExactNrOfTokens is ignored.
+static void addSequenceGenerator(SmvModel &model, Type type, size_t nrOfTokens,
+                                 bool generateExactNrOfTokens) {
+  std::string name =
+      getGeneratorName(type, nrOfTokens, generateExactNrOfTokens);
+  std::vector<std::string> params = {"nReady0"};
+  if (nrOfTokens != 0)
+    params.push_back(generateExactNrOfTokens ? "exact_tokens" : "max_tokens");
+  SmvModule &gen = model.addModule(name, params);
+
+  std::optional<std::string> outsType = convertMLIRTypeToSMV(type);
+  if (outsType)
+    gen.addVariable("outs", *outsType);
+
+  if (nrOfTokens == 0) {
+    gen.addDefine("outs_valid", "TRUE");
+  } else {
+    gen.addVariable("counter", "0..31");
+    // The actual number of generated tokens is non-determinstically set
+    // between 0 and (inclusive) max_tokens
+    if (!generateExactNrOfTokens)
+      gen.addVariable("exact_tokens", "0..max_tokens", /*frozen=*/true);
+    gen.addAssignment("counter", "0", NEXT_COUNTER.str());
+    gen.addDefine("outs_valid", "counter < exact_tokens");
+  }
 
-)DELIM",
-                       *getPrefixTypeName(type), *convertMLIRTypeToSMV(type));
+  // Make sure boolean outs are persistent
+  if (auto cType = dyn_cast<handshake::ChannelType>(type);
+      cType && cType.getDataBitWidth() == 1)
+    gen.addAssignment("outs", std::nullopt, NEXT_PERSISTENT_OUTS.str());
 }
 
-static std::string
-createSequenceGenerator(const Type &type, size_t nrOfTokens,
-                        bool generateExactNrOfTokens = false) {
-  return llvm::TypeSwitch<Type, std::string>(type)
-      .Case<handshake::ControlType>([&](auto) {
-        if (nrOfTokens == 0)
-          return SMV_CTRL_INPUT_INF;
-        if (generateExactNrOfTokens)
-          return SMV_CTRL_INPUT_EXACT;
-        return SMV_CTRL_INPUT;
-      })
-      .Case<handshake::ChannelType>([&](handshake::ChannelType type) {
-        if (type.getDataBitWidth() == 1) {
-          if (nrOfTokens == 0)
-            return SMV_BOOL_INPUT_INF;
-          if (generateExactNrOfTokens)
-            return SMV_BOOL_INPUT_EXACT;
-          return SMV_BOOL_INPUT;
-        }
-        {
-          if (nrOfTokens == 0)
-            return smvInputInf(type);
-          if (generateExactNrOfTokens)
-            return smvInputExact(type);
-          return smvInput(type);
-        }
-      });
-}
-
-static std::string createTBJoin(size_t nrOfOutputs) {
-  std::ostringstream tbJoin;
+/// Adds the join synchronizing all outputs of the module under test to the
+/// model.
+static void addTBJoin(SmvModel &model, size_t nrOfOutputs) {
   std::vector<std::string> insValids;
   for (size_t i = 0; i < nrOfOutputs; i++)
     insValids.push_back(llvm::formatv("ins_{0}_valid", i));
 
-  tbJoin << llvm::formatv("MODULE tb_join ({0}, outs_ready)\n",
-                          llvm::join(insValids, ", "))
-                .str();
-
-  tbJoin << llvm::formatv("  DEFINE\n  outs_valid := {0};\n",
-                          llvm::join(insValids, " & "))
-                .str();
-
+  std::vector<std::string> params = insValids;
+  params.push_back("outs_ready");
+  SmvModule &join = model.addModule("tb_join", params);
+  join.addDefine("outs_valid", llvm::join(insValids, " & "));
   for (size_t i = 0; i < nrOfOutputs; i++) {
     std::vector<std::string> tmp = insValids;
     tmp.erase(tmp.begin() + i);
-    tbJoin << llvm::formatv("  ins_{0}_ready := {1} & outs_ready;\n", i,
-                            llvm::join(tmp, " & "))
-                  .str();
+    tmp.push_back("outs_ready");
+    join.addDefine(llvm::formatv("ins_{0}_ready", i).str(),
+                   llvm::join(tmp, " & "));
   }
-  tbJoin << "\n\n";
-  return tbJoin.str();
 }
 
-static std::string createSupportEntities(
-    const SmallVector<std::pair<std::string, Type>> &arguments,
-    const SmallVector<std::pair<std::string, Type>> &results, size_t nrOfTokens,
-    bool generateExactNrOfTokens = false, bool syncOutput = false) {
-
-  llvm::DenseSet<Type> types;
+static void
+addSupportEntities(SmvModel &model,
+                   const SmallVector<std::pair<std::string, Type>> &arguments,
+                   const SmallVector<std::pair<std::string, Type>> &results,
+                   size_t nrOfTokens, bool generateExactNrOfTokens = false,
+                   bool syncOutput = false) {
+  llvm::SetVector<Type> types;
   for (const auto &[_, type] : arguments)
     if (type.isa<handshake::ControlType, handshake::ChannelType>())
       types.insert(type);
-  std::ostringstream supportEntities;
+  for (Type type : types)
+    addSequenceGenerator(model, type, nrOfTokens, generateExactNrOfTokens);
 
-  for (const auto &type : types) {
-    supportEntities << createSequenceGenerator(type, nrOfTokens,
-                                               generateExactNrOfTokens)
-                    << "\n\n";
-  }
   if (syncOutput) {
-    int nrOutChannels = 0;
-    for (const auto &[s, t] : results) {
-      if (isa<handshake::ChannelType, handshake::ControlType>(t)) {
-        nrOutChannels++;
-      }
-    }
-
-    supportEntities << createTBJoin(nrOutChannels);
-  } else
-    supportEntities << "MODULE sink_main (ins_valid)\n"
-                       "  DEFINE ins_ready   := TRUE;\n\n";
-
-  return supportEntities.str();
+    size_t nrOutChannels = llvm::count_if(results, [](const auto &result) {
+      return isa<handshake::ChannelType, handshake::ControlType>(result.second);
+    });
+    addTBJoin(model, nrOutChannels);
+  } else {
+    model.addModule("sink_main", {"ins_valid"}).addDefine("ins_ready", "TRUE");
+  }
 }
 
-/// Create the sequence generator at the inputs of the module
-/// We support three different kinds of sequence generators:
-/// 1. Infinite sequence generator: Will create an infinite number of
-/// tokens.
-/// 2. Standard finite generator: Will create 0 to the maximal number of
-/// tokens. The exact number of tokens is non-deterministic.
-/// 3. Exact finite generator: Will create the exact number of tokens (if
-/// it receives enough ready inputs).
-/// When nrOfTokens is set to 0, the infinite sequence generator is created
-/// and the value of generateExactNrOfTokens is ignored.
-static std::string instantiateSequenceGenerators(
-    const std::string &moduleName,
+/// Create the sequence generators at the inputs of the module
+static void instantiateSequenceGenerators(
+    SmvModule &main, const std::string &moduleName,
     const SmallVector<std::pair<std::string, Type>> &arguments,
     size_t nrOfTokens, bool generateExactNrOfTokens = false) {
-  std::ostringstream sequenceGenerators;
   for (const auto &[argumentName, type] : arguments) {
     if (!type.isa<handshake::ControlType, handshake::ChannelType>())
       continue;
 
-    std::string typePrefixName =
-        llvm::TypeSwitch<Type, std::string>(type)
-            .Case<handshake::ControlType>([&](handshake::ControlType cType) {
-              return std::string("ctrl");
-            })
-            .Case<handshake::ChannelType>([&](handshake::ChannelType cType) {
-              if (cType.getDataBitWidth() == 1)
-                return std::string("bool");
-              return "s" + std::to_string(cType.getDataBitWidth());
-            });
-
-    if (nrOfTokens == 0) {
-      // Example: VAR seq_generator_D : bool_input_inf(model.D_ready);
-      sequenceGenerators
-          << llvm::formatv(
-                 "  VAR seq_generator_{0} : {1}_input_inf({2}.{0}_ready);\n",
-                 argumentName, typePrefixName, moduleName)
-                 .str();
-
-    } else if (generateExactNrOfTokens) {
-      // Example: VAR seq_generator_D : bool_input_exact(model.D_ready, 1);
-      sequenceGenerators << llvm::formatv(
-                                "  VAR seq_generator_{0} : "
-                                "{1}_input_exact({2}.{0}_ready, {3});\n",
-                                argumentName, typePrefixName, moduleName,
-                                nrOfTokens)
-                                .str();
-    } else {
-      // Example: VAR seq_generator_D : bool_input(model.D_ready, 1);
-      sequenceGenerators << llvm::formatv("  VAR seq_generator_{0} : "
-                                          "{1}_input({2}.{0}_ready, {3});\n",
-                                          argumentName, typePrefixName,
-                                          moduleName, nrOfTokens)
-                                .str();
-    }
+    // Example: VAR seq_generator_D : bool_input_exact(model.D_ready, 1);
+    std::vector<std::string> args = {
+        llvm::formatv("{0}.{1}_ready", moduleName, argumentName).str()};
+    if (nrOfTokens != 0)
+      args.push_back(std::to_string(nrOfTokens));
+    std::string genName =
+        getGeneratorName(type, nrOfTokens, generateExactNrOfTokens);
+    main.addInstance("seq_generator_" + argumentName, genName, args);
   }
-  return sequenceGenerators.str();
 }
 
 /// Create the sinks at the outputs of the module
-static std::string
-instantiateSinks(const std::string &moduleName,
+static void
+instantiateSinks(SmvModule &main, const std::string &moduleName,
                  const SmallVector<std::pair<std::string, Type>> &results) {
-  std::ostringstream sinks;
-
   for (const auto &[resultName, type] : results) {
-    if (type.isa<handshake::ControlType, handshake::ChannelType>())
-      sinks << llvm::formatv("  VAR sink_{0} : sink_main({1}.{0}_valid);\n",
-                             resultName, moduleName)
-                   .str();
+    if (!type.isa<handshake::ControlType, handshake::ChannelType>())
+      continue;
+    std::string valid = llvm::formatv("{0}.{1}_valid", moduleName, resultName);
+    main.addInstance("sink_" + resultName, "sink_main", {valid});
   }
-  return sinks.str();
 }
 
 /// Create the join at the outputs of the module
-static std::string
-instantiateJoin(const std::string &moduleName,
+static void
+instantiateJoin(SmvModule &main, const std::string &moduleName,
                 const SmallVector<std::pair<std::string, Type>> &results) {
-  std::ostringstream str;
-  std::vector<std::string> outputValids;
-
-  str << "  VAR join_global : tb_join(";
+  std::vector<std::string> args;
   for (const auto &[resultName, type] : results) {
     if (type.isa<handshake::ControlType, handshake::ChannelType>())
-      outputValids.push_back(
-          llvm::formatv("{0}.{1}_valid", moduleName, resultName));
+      args.push_back(llvm::formatv("{0}.{1}_valid", moduleName, resultName));
   }
-  str << llvm::join(outputValids, ", ") << ", global_ready);\n";
-
-  return str.str();
+  args.push_back("global_ready");
+  main.addInstance("join_global", "tb_join", args);
 }
 
-std::string createSmvFormalTestbench(const SmvTestbenchConfig &config) {
-  std::ostringstream wrapper;
-  wrapper << "#include \"" + config.modelSmvName + ".smv\"\n\n";
-
-  wrapper << createSupportEntities(
-      config.arguments, config.results, config.nrOfTokens,
-      config.generateExactNrOfTokens, config.syncOutput);
-
-  wrapper << "MODULE main\n\n";
+SmvModel createSmvFormalTestbenchModel(const SmvTestbenchConfig &config) {
+  SmvModel model;
+  model.addInclude(config.modelSmvName + ".smv");
+  addSupportEntities(model, config.arguments, config.results,
+                     config.nrOfTokens, config.generateExactNrOfTokens,
+                     config.syncOutput);
 
-  wrapper << instantiateSequenceGenerators(config.modelSmvName,
-                                           config.arguments, config.nrOfTokens,
-                                           config.generateExactNrOfTokens)
-          << "\n";
-
-  wrapper << instantiateModuleUnderTest(config.modelSmvName, config.arguments,
-                                        config.results, config.syncOutput)
-          << "\n";
+  SmvModule &main = model.addModule("main");
+  instantiateSequenceGenerators(main, config.modelSmvName, config.arguments,
+                                config.nrOfTokens,
+                                config.generateExactNrOfTokens);
+  instantiateModuleUnderTest(main, config.modelSmvName, config.arguments,
+                             config.results, config.syncOutput);
 
   if (config.deadBufferOutput) {
-    wrapper << instantiateJoin(config.modelSmvName, config.results) << "\n";
-    wrapper << "  VAR end_full : boolean;\n";
-    wrapper << "  ASSIGN\n";
-    wrapper << "  init(end_full) := FALSE;\n";
-    wrapper << "  next(end_full) := end_full | join_global.outs_valid;\n";
-    wrapper << "  DEFINE global_ready := !end_full;\n";
+    instantiateJoin(main, config.modelSmvName, config.results);
+    main.addVariable("end_full", "boolean");
+    main.addAssignment("end_full", "FALSE",
+                       "end_full | join_global.outs_valid");
+    main.addDefine("global_ready", "!end_full");
   } else if (config.syncOutput) {
-    wrapper << instantiateJoin(config.modelSmvName, config.results) << "\n";
-    wrapper << "  DEFINE global_ready := TRUE;\n";
-
+    instantiateJoin(main, config.modelSmvName, config.results);
+    main.addDefine("global_ready", "TRUE");
   } else {
-    wrapper << instantiateSinks(config.modelSmvName, config.results) << "\n";
+    instantiateSinks(main, config.modelSmvName, config.results);
   }
+  return model;
+}
 
-  return wrapper.str();
+std::string createSmvFormalTestbench(const SmvTestbenchConfig &config) {
+  std::string wrapper;
+  llvm::raw_string_ostream os(wrapper);
+  createSmvFormalTestbenchModel(config).print(os);
+  return wrapper;
 }
 
 } // namespace dynamatic::experimental
@@ -111,6 +111,21 @@ ChannelState::ChannelState(TypedValue<handshake::ChannelType> channel)
       });
 }
 
+std::string ChannelState::getDataString() const {
+  if (!data.hasValue())
+    return "";
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  if (const auto *intVal = llvm::any_cast<APInt>(&data.data)) {
+    os << *intVal;
+  } else if (const auto *floatVal = llvm::any_cast<APFloat>(&data.data)) {
+    SmallVector<char> floatStr;
+    floatVal->toString(floatStr);
+    os << floatStr;
+  }
+  return str;
+}
+
 ControlState::ControlState(TypedValue<handshake::ControlType> control)
     : TypedValueState<handshake::ControlType>(control) {}
 
@@ -1262,6 +1277,15 @@ void Simulator::simulate(llvm::ArrayRef<std::string> inputArgs) {
       isClock = false;
     }
 
+    // Tokens whose valid and ready signals are both set once signals have
+    // settled are transferred at the next clock edge
+    if (lineage) {
+      for (auto [val, state] : oldValuesStates) {
+        if (state->isTransferring())
+          lineage->recordTransfer(val, iterNum, state->getDataString());
+      }
+    }
+
     // If the simulator's result is valid, the simulation can be finished
     if (res->valid) {
       for (auto [val, state] : updaters)
@@ -0,0 +1,374 @@
+//===- SmvConeOfInfluence.cpp - COI reduction of SMV models -----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements cone-of-influence reduction of SMV modules.
+//
+//===----------------------------------------------------------------------===//
+
+#include "experimental/Support/SmvConeOfInfluence.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include <algorithm>
+#include <deque>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::experimental;
+
+/// Character replacing the hierarchy separator in the names of free inputs.
+/// It is a valid character in SMV identifiers that never appears in the
+/// signal names generated by export-rtl, so free inputs cannot clash with
+/// other names.
+static constexpr char FREE_INPUT_SEP = '$';
+
+/// Returns whether the character may appear in an SMV identifier (excluding
+/// '-', which export-rtl never uses in names and which would otherwise be
+/// ambiguous with the minus and implication operators).
+static bool isIdentifierChar(char c) {
+  return isAlnum(c) || c == '_' || c == '.' || c == '$' || c == '#';
+}
+
+/// Calls the callback on each identifier (possibly hierarchical, e.g.,
+/// `fork0.outs_0_valid`) of the SMV expression, and returns the expression in
+/// which each identifier is replaced by the callback's result.
+static std::string
+mapIdentifiers(StringRef expr,
+               function_ref<std::string(StringRef)> callback) {
+  std::string mapped;
+  while (!expr.empty()) {
+    size_t len = 0;
+    while (len < expr.size() && isIdentifierChar(expr[len]))
+      ++len;
+    if (len == 0) {
+      mapped += expr.front();
+      expr = expr.drop_front();
+      continue;
+    }
+    StringRef token = expr.take_front(len);
+    expr = expr.drop_front(len);
+    // Constants (e.g., 0ud8_3) start with a digit
+    if (isDigit(token.front()))
+      mapped += token;
+    else
+      mapped += callback(token);
+  }
+  return mapped;
+}
+
+/// Calls the callback on each identifier of the SMV expression.
+static void forEachIdentifier(StringRef expr,
+                              function_ref<void(StringRef)> callback) {
+  mapIdentifiers(expr, [&](StringRef id) {
+    callback(id);
+    return id.str();
+  });
+}
+
+namespace {
+
+/// Computes the instances of a module that its properties depend on.
+class ConeBuilder {
+public:
+  ConeBuilder(const SmvModule &mod, std::optional<unsigned> maxDepth)
+      : mod(mod), maxDepth(maxDepth) {}
+
+  /// Adds the dependencies of the expression to the cone, the expression
+  /// itself being at the given distance from the properties.
+  void addExpression(StringRef expr, unsigned distance);
+
+  /// Forces the instance to be part of the cone without adding its own
+  /// dependencies to it.
+  void addInstance(StringRef instName) { cone.insert(instName); }
+
+  /// Adds the dependencies of all pending expressions to the cone.
+  void run();
+
+  /// Returns whether the instance is part of the cone.
+  bool contains(StringRef instName) const { return cone.contains(instName); }
+
+private:
+  /// The module being reduced.
+  const SmvModule &mod;
+  /// Maximum distance of instances to the properties, if any.
+  std::optional<unsigned> maxDepth;
+  /// Instances in the cone.
+  llvm::StringSet<> cone;
+  /// Defines whose dependencies were already added to the cone.
+  llvm::StringSet<> visitedDefines;
+  /// Pending expressions along with their distance to the properties.
+  /// Expressions at the same distance are processed first, so that instances
+  /// are always reached through their shortest path.
+  std::deque<std::pair<std::string, unsigned>> worklist;
+};
+
+} // namespace
+
+void ConeBuilder::addExpression(StringRef expr, unsigned distance) {
+  forEachIdentifier(expr, [&](StringRef id) {
+    if (const SmvModule::Define *def = mod.getDefine(id)) {
+      // Defines do not increase the distance to the properties
+      if (visitedDefines.insert(id).second)
+        worklist.emplace_front(def->expr, distance);
+      return;
+    }
+    StringRef instName = id.split('.').first;
+    const SmvModule::Instance *inst = mod.getInstance(instName);
+    if (!inst || !cone.insert(instName).second)
+      return;
+    if (maxDepth && distance >= *maxDepth)
+      return;
+    for (const std::string &arg : inst->args)
+      worklist.emplace_back(arg, distance + 1);
+  });
+}
+
+void ConeBuilder::run() {
+  while (!worklist.empty()) {
+    auto [expr, distance] = worklist.front();
+    worklist.pop_front();
+    addExpression(expr, distance);
+  }
+}
+
+/// Returns whether the spec is a constraint on the module's behavior rather
+/// than a property to check.
+static bool isConstraint(const SmvModule::Spec &spec) {
+  return spec.kind == SmvModule::Spec::Kind::INVAR ||
+         spec.kind == SmvModule::Spec::Kind::TRANS;
+}
+
+std::string SmvReduction::getFreeInputName(StringRef signal) {
+  std::string name = signal.str();
+  std::replace(name.begin(), name.end(), '.', FREE_INPUT_SEP);
+  return name;
+}
+
+void SmvReduction::mapTrace(SmvTrace &trace) const {
+  trace.renameVariables([&](StringRef var) -> std::string {
+    auto [prefix, name] = var.rsplit('.');
+    if (name.empty())
+      std::swap(prefix, name);
+    auto it = freeInputs.find(name);
+    if (it == freeInputs.end())
+      return var.str();
+    return prefix.empty() ? it->second : (prefix + "." + it->second).str();
+  });
+}
+
+void SmvReduction::print(raw_ostream &os) const {
+  unsigned numKept = numInstances - removedInstances.size();
+  os << "Cone of influence: kept " << numKept << "/" << numInstances
+     << " instance(s)";
+  if (numInstances)
+    os << " (" << (100 * numKept) / numInstances << "%)";
+  os << "\n";
+  os << "Abstracted channels: " << numCutChannels << " (" << freeInputs.size()
+     << " free input(s))\n";
+  os << "Dropped constraints: " << numDroppedConstraints << "\n";
+  os << "Reduction is "
+     << (exact ? "exact" : "an over-approximation (counterexamples may be "
+                           "spurious)")
+     << "\n";
+
+  if (!removedInstances.empty()) {
+    os << "\nRemoved instances:\n";
+    for (const std::string &instName : removedInstances)
+      os << "  " << instName << "\n";
+  }
+  if (!freeInputs.empty()) {
+    std::vector<std::pair<std::string, std::string>> inputs;
+    for (const auto &entry : freeInputs)
+      inputs.emplace_back(entry.getKey().str(), entry.getValue());
+    llvm::sort(inputs);
+    os << "\nFree inputs:\n";
+    for (const auto &[input, signal] : inputs)
+      os << "  " << input << " -> " << signal << "\n";
+  }
+}
+
+SmvReduction
+dynamatic::experimental::reduceToConeOfInfluence(SmvModule &mod,
+                                                 std::optional<unsigned>
+                                                     maxDepth) {
+  SmvReduction reduction;
+  reduction.numInstances = mod.instances.size();
+
+  // Seed the cone with the properties' dependencies
+  ConeBuilder cone(mod, maxDepth);
+  for (const SmvModule::Spec &spec : mod.specs) {
+    if (!isConstraint(spec))
+      cone.addExpression(spec.expr, 0);
+  }
+  cone.run();
+
+  // Without a maximum depth, constraints that involve the cone restrict its
+  // behavior, so the instances they depend on belong to the cone as well
+  llvm::DenseSet<const SmvModule::Spec *> coneConstraints;
+  bool changed = !maxDepth;
+  while (changed) {
+    changed = false;
+    for (const SmvModule::Spec &spec : mod.specs) {
+      if (!isConstraint(spec) || coneConstraints.contains(&spec))
+        continue;
+      bool inCone = false;
+      forEachIdentifier(spec.expr, [&](StringRef id) {
+        inCone |= cone.contains(id.split('.').first);
+      });
+      if (inCone) {
+        coneConstraints.insert(&spec);
+        cone.addExpression(spec.expr, 0);
+        cone.run();
+        changed = true;
+      }
+    }
+  }
+
+  // Map each signal produced by an instance to its type and channel
+  llvm::StringMap<std::pair<std::string, const SmvModule::Channel *>>
+      signalInfo;
+  for (const SmvModule::Channel &channel : mod.channels) {
+    signalInfo[channel.valid] = {"boolean", &channel};
+    signalInfo[channel.ready] = {"boolean", &channel};
+    for (const SmvModule::Signal &signal : channel.payload)
+      signalInfo[signal.name] = {signal.type, &channel};
+  }
+
+  // Signals of removed instances that are still referenced must become free
+  // inputs. Instances whose signals cannot be abstracted (because their type
+  // is unknown) are kept.
+  auto isRemoved = [&](StringRef id) -> bool {
+    StringRef instName = id.split('.').first;
+    return mod.getInstance(instName) && !cone.contains(instName);
+  };
+  bool keptMore = true;
+  while (keptMore) {
+    keptMore = false;
+    auto keepUnknown = [&](StringRef id) {
+      if (isRemoved(id) && !signalInfo.count(id)) {
+        cone.addInstance(id.split('.').first);
+        keptMore = true;
+      }
+    };
+    for (const SmvModule::Instance &inst : mod.instances) {
+      if (!cone.contains(inst.name))
+        continue;
+      for (const std::string &arg : inst.args)
+        forEachIdentifier(arg, keepUnknown);
+    }
+    for (const SmvModule::Define &def : mod.defines)
+      forEachIdentifier(def.expr, keepUnknown);
+  }
+
+  // Replaces references to removed instances' signals with free inputs.
+  // Returns false when the expression references the internal state of a
+  // removed instance, which cannot be abstracted.
+  auto abstract = [&](std::string &expr) -> bool {
+    bool valid = true;
+    expr = mapIdentifiers(expr, [&](StringRef id) -> std::string {
+      if (!isRemoved(id))
+        return id.str();
+      if (!signalInfo.count(id)) {
+        valid = false;
+        return id.str();
+      }
+      std::string input = SmvReduction::getFreeInputName(id);
+      reduction.freeInputs[input] = id.str();
+      return input;
+    });
+    return valid;
+  };
+
+  // Remove instances outside the cone and abstract their signals in the rest
+  // of the module
+  std::vector<SmvModule::Instance> instances;
+  for (SmvModule::Instance &inst : mod.instances) {
+    if (!cone.contains(inst.name)) {
+      reduction.removedInstances.push_back(inst.name);
+      continue;
+    }
+    for (std::string &arg : inst.args) {
+      bool valid = abstract(arg);
+      (void)valid;
+      assert(valid && "instance references unknown signal of removed instance");
+    }
+    instances.push_back(std::move(inst));
+  }
+  mod.instances = std::move(instances);
+  // Free inputs bound to kept instances stand for signals the properties
+  // depend on
+  if (!reduction.freeInputs.empty())
+    reduction.exact = false;
+
+  for (SmvModule::Define &def : mod.defines) {
+    bool valid = abstract(def.expr);
+    (void)valid;
+    assert(valid && "define references unknown signal of removed instance");
+  }
+
+  std::vector<SmvModule::Spec> specs;
+  for (SmvModule::Spec &spec : mod.specs) {
+    if (abstract(spec.expr)) {
+      specs.push_back(std::move(spec));
+      continue;
+    }
+    // Constraints are only assumptions on the module's behavior, so dropping
+    // them is sound. Properties always belong to the cone.
+    assert(isConstraint(spec) && "property outside of the cone");
+    ++reduction.numDroppedConstraints;
+    reduction.exact = false;
+  }
+  mod.specs = std::move(specs);
+
+  // Constrain free inputs standing for the producer side of a channel to
+  // follow the handshake protocol. The ready signal of such channels is always
+  // set by a kept instance or by the module's environment.
+  std::vector<SmvModule::Channel> channels;
+  for (SmvModule::Channel &channel : mod.channels) {
+    bool removedProducer = !cone.contains(channel.producer);
+    bool removedConsumer =
+        !channel.consumer.empty() && !cone.contains(channel.consumer);
+    if (removedProducer && removedConsumer)
+      continue;
+    if (!removedProducer && !removedConsumer) {
+      channels.push_back(std::move(channel));
+      continue;
+    }
+    ++reduction.numCutChannels;
+
+    std::string valid = SmvReduction::getFreeInputName(channel.valid);
+    if (!removedProducer || !reduction.freeInputs.count(valid))
+      continue;
+    // A valid token must remain valid and unchanged until it is accepted
+    SmallVector<std::string> stable{"next(" + valid + ")"};
+    for (const SmvModule::Signal &signal : channel.payload) {
+      std::string input = SmvReduction::getFreeInputName(signal.name);
+      if (reduction.freeInputs.count(input))
+        stable.push_back("next(" + input + ") = " + input);
+    }
+    mod.addSpec(SmvModule::Spec::Kind::TRANS,
+                "(" + valid + " & !" + channel.ready + ") -> (" +
+                    llvm::join(stable, " & ") + ")",
+                {}, "handshake protocol of abstracted channel " + valid);
+  }
+  mod.channels = std::move(channels);
+
+  // Declare the free inputs
+  std::vector<std::string> inputs;
+  for (const auto &entry : reduction.freeInputs)
+    inputs.push_back(entry.getKey().str());
+  llvm::sort(inputs);
+  for (const std::string &input : inputs) {
+    const std::string &signal = reduction.freeInputs.at(input);
+    mod.addVariable(input, signalInfo.at(signal).first);
+  }
+
+  return reduction;
+}
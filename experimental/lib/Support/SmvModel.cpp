@@ -0,0 +1,454 @@
+//===- SmvModel.cpp - In-memory SMV models and traces -----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements printing of SMV models and parsing of counterexample traces.
+//
+//===----------------------------------------------------------------------===//
+
+#include "experimental/Support/SmvModel.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstring>
+#include <system_error>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::experimental;
+
+//===----------------------------------------------------------------------===//
+// SmvModule
+//===----------------------------------------------------------------------===//
+
+SmvModule::Variable &SmvModule::addVariable(StringRef varName, StringRef type,
+                                            bool frozen) {
+  return variables.emplace_back(Variable{varName.str(), type.str(), frozen});
+}
+
+SmvModule::Instance &SmvModule::addInstance(StringRef instName,
+                                            StringRef moduleName,
+                                            ArrayRef<std::string> args) {
+  return instances.emplace_back(
+      Instance{instName.str(), moduleName.str(), args.vec()});
+}
+
+SmvModule::Define &SmvModule::addDefine(StringRef defName, StringRef expr) {
+  return defines.emplace_back(Define{defName.str(), expr.str()});
+}
+
+SmvModule::Assignment &
+SmvModule::addAssignment(StringRef var, std::optional<std::string> init,
+                         std::optional<std::string> next) {
+  return assignments.emplace_back(
+      Assignment{var.str(), std::move(init), std::move(next)});
+}
+
+SmvModule::Spec &SmvModule::addSpec(Spec::Kind kind, StringRef expr,
+                                    StringRef specName, StringRef comment) {
+  return specs.emplace_back(
+      Spec{kind, expr.str(), specName.str(), comment.str()});
+}
+
+SmvModule::Channel &SmvModule::addChannel(StringRef producer,
+                                          StringRef consumer, StringRef valid,
+                                          StringRef ready,
+                                          ArrayRef<Signal> payload) {
+  return channels.emplace_back(Channel{producer.str(), consumer.str(),
+                                       valid.str(), ready.str(), payload.vec()});
+}
+
+const SmvModule::Instance *SmvModule::getInstance(StringRef instName) const {
+  auto it = llvm::find_if(
+      instances, [&](const Instance &inst) { return inst.name == instName; });
+  return it == instances.end() ? nullptr : &*it;
+}
+
+const SmvModule::Define *SmvModule::getDefine(StringRef defName) const {
+  auto it = llvm::find_if(
+      defines, [&](const Define &def) { return def.name == defName; });
+  return it == defines.end() ? nullptr : &*it;
+}
+
+/// Returns the SMV keyword introducing the spec.
+static StringRef getKeyword(SmvModule::Spec::Kind kind) {
+  switch (kind) {
+  case SmvModule::Spec::Kind::INVAR:
+    return "INVAR";
+  case SmvModule::Spec::Kind::TRANS:
+    return "TRANS";
+  case SmvModule::Spec::Kind::INVARSPEC:
+    return "INVARSPEC";
+  case SmvModule::Spec::Kind::LTLSPEC:
+    return "LTLSPEC";
+  case SmvModule::Spec::Kind::CTLSPEC:
+    return "CTLSPEC";
+  }
+  llvm_unreachable("unknown spec kind");
+}
+
+void SmvModule::print(raw_ostream &os) const {
+  os << "MODULE " << name;
+  if (!params.empty())
+    os << "(" << llvm::join(params, ", ") << ")";
+  os << "\n";
+
+  for (const Variable &var : variables) {
+    os << "  " << (var.frozen ? "FROZENVAR " : "VAR ") << var.name << " : "
+       << var.type << ";\n";
+  }
+  for (const Instance &inst : instances) {
+    os << "  VAR " << inst.name << " : " << inst.moduleName << "("
+       << llvm::join(inst.args, ", ") << ");\n";
+  }
+  for (const Define &def : defines)
+    os << "  DEFINE " << def.name << " := " << def.expr << ";\n";
+
+  if (!assignments.empty()) {
+    os << "  ASSIGN\n";
+    for (const Assignment &assign : assignments) {
+      if (assign.init)
+        os << "    init(" << assign.var << ") := " << *assign.init << ";\n";
+      if (assign.next)
+        os << "    next(" << assign.var << ") := " << *assign.next << ";\n";
+    }
+  }
+
+  for (const Spec &spec : specs) {
+    if (!spec.comment.empty())
+      os << "  -- " << spec.comment << "\n";
+    os << "  " << getKeyword(spec.kind) << " ";
+    // Constraints cannot be named
+    if (!spec.name.empty() && spec.kind != Spec::Kind::INVAR &&
+        spec.kind != Spec::Kind::TRANS)
+      os << "NAME " << spec.name << " := ";
+    os << spec.expr << ";\n";
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// SmvModel
+//===----------------------------------------------------------------------===//
+
+void SmvModel::addInclude(StringRef filename) {
+  if (!llvm::is_contained(includes, filename))
+    includes.push_back(filename.str());
+}
+
+SmvModule &SmvModel::addModule(StringRef name, ArrayRef<std::string> params) {
+  return modules.emplace_back(name, params);
+}
+
+SmvModule *SmvModel::getModule(StringRef name) {
+  auto it = llvm::find_if(
+      modules, [&](const SmvModule &mod) { return mod.name == name; });
+  return it == modules.end() ? nullptr : &*it;
+}
+
+const SmvModule *SmvModel::getModule(StringRef name) const {
+  auto it = llvm::find_if(
+      modules, [&](const SmvModule &mod) { return mod.name == name; });
+  return it == modules.end() ? nullptr : &*it;
+}
+
+void SmvModel::print(raw_ostream &os) const {
+  for (const std::string &filename : includes)
+    os << "#include \"" << filename << "\"\n";
+  for (const SmvModule &mod : modules) {
+    os << "\n";
+    mod.print(os);
+  }
+}
+
+LogicalResult
+SmvModel::writeToFile(const std::filesystem::path &filepath) const {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(filepath.string(), ec);
+  if (ec) {
+    llvm::errs() << "Failed to create SMV model @ \"" << filepath.string()
+                 << "\": " << ec.message() << "\n";
+    return failure();
+  }
+  print(os);
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// SmvTrace
+//===----------------------------------------------------------------------===//
+
+FailureOr<SmvTrace>
+SmvTrace::parseFromFile(const std::filesystem::path &filepath) {
+  auto fileOrErr = MemoryBuffer::getFile(filepath.string());
+  if (std::error_code ec = fileOrErr.getError()) {
+    llvm::errs() << "Failed to open trace @ \"" << filepath.string()
+                 << "\": " << ec.message() << "\n";
+    return failure();
+  }
+  return parse((*fileOrErr)->getBuffer());
+}
+
+FailureOr<SmvTrace> SmvTrace::parse(StringRef text) {
+  if (text.ltrim().starts_with("<"))
+    return parseXML(text);
+  return parseText(text);
+}
+
+SmvTrace::Step &SmvTrace::getOrCreateStep(unsigned id) {
+  assert(id > 0 && "step identifiers start at 1");
+  while (steps.size() < id) {
+    Step &step = steps.emplace_back();
+    if (steps.size() == 1)
+      continue;
+    // State variables keep their value until the trace reports a change
+    const Step &prevStep = steps[steps.size() - 2];
+    for (const auto &var : stateVars) {
+      if (auto it = prevStep.values.find(var.getKey());
+          it != prevStep.values.end())
+        step.values[var.getKey()] = it->second;
+    }
+  }
+  return steps[id - 1];
+}
+
+/// Replaces the predefined XML entities in the text.
+static std::string decodeXML(StringRef text) {
+  std::string decoded;
+  while (!text.empty()) {
+    size_t amp = text.find('&');
+    decoded += text.take_front(amp).str();
+    if (amp == StringRef::npos)
+      break;
+    text = text.drop_front(amp);
+    std::pair<StringRef, char> entities[] = {{"&lt;", '<'},
+                                             {"&gt;", '>'},
+                                             {"&amp;", '&'},
+                                             {"&quot;", '"'},
+                                             {"&apos;", '\''}};
+    bool matched = false;
+    for (auto [entity, chr] : entities) {
+      if (text.consume_front(entity)) {
+        decoded += chr;
+        matched = true;
+        break;
+      }
+    }
+    if (!matched) {
+      decoded += '&';
+      text = text.drop_front();
+    }
+  }
+  return decoded;
+}
+
+/// Returns the value of the attribute in the XML tag, or an empty string if
+/// the tag does not have the attribute.
+static StringRef getXMLAttribute(StringRef tag, StringRef attr) {
+  std::string prefix = (" " + attr + "=\"").str();
+  size_t start = tag.find(prefix);
+  if (start == StringRef::npos)
+    return {};
+  StringRef value = tag.drop_front(start + prefix.size());
+  return value.take_until([](char c) { return c == '"'; });
+}
+
+// XML traces (show_traces -p 4) look like this:
+//
+// <counter-example type="0" id="1" desc="LTL Counterexample" >
+//   <node>
+//     <state id="1">
+//       <value variable="model.fork0.sent_0">FALSE</value>
+//     </state>
+//     <combinatorial id="1"> ... </combinatorial>
+//     <input id="2"> ... </input>
+//   </node>
+//   ...
+//   <loops> 2 </loops>
+// </counter-example>
+FailureOr<SmvTrace> SmvTrace::parseXML(StringRef text) {
+  SmvTrace trace;
+  bool inTrace = false, inState = false;
+  Step *step = nullptr;
+
+  while (true) {
+    size_t open = text.find('<');
+    if (open == StringRef::npos)
+      break;
+    text = text.drop_front(open + 1);
+    size_t close = text.find('>');
+    if (close == StringRef::npos)
+      break;
+    StringRef tag = text.take_front(close);
+    text = text.drop_front(close + 1);
+
+    StringRef tagName = tag.take_until([](char c) { return isSpace(c); });
+    if (tagName == "counter-example") {
+      // Only parse the first trace
+      if (inTrace)
+        break;
+      inTrace = true;
+      trace.description = decodeXML(getXMLAttribute(tag, "desc"));
+    } else if (tagName == "/counter-example") {
+      break;
+    } else if (tagName == "state" || tagName == "input" ||
+               tagName == "combinatorial") {
+      unsigned id;
+      if (getXMLAttribute(tag, "id").getAsInteger(10, id) || id == 0) {
+        llvm::errs() << "Invalid step identifier in XML trace: <" << tag
+                     << ">\n";
+        return failure();
+      }
+      step = &trace.getOrCreateStep(id);
+      inState = tagName == "state";
+    } else if (tagName == "value" && step) {
+      size_t end = text.find("</value>");
+      if (end == StringRef::npos)
+        break;
+      std::string var = decodeXML(getXMLAttribute(tag, "variable"));
+      step->values[var] = decodeXML(text.take_front(end).trim());
+      if (inState)
+        trace.stateVars.insert(var);
+      text = text.drop_front(end + strlen("</value>"));
+    } else if (tagName == "loops") {
+      size_t end = text.find("</loops>");
+      if (end == StringRef::npos)
+        break;
+      // Loops are listed as comma-separated state identifiers; the first one
+      // is where the trace loops back to
+      StringRef loops = text.take_front(end).split(',').first.trim();
+      unsigned loopID;
+      if (!loops.empty() && !loops.getAsInteger(10, loopID) && loopID > 0)
+        trace.loopStart = loopID - 1;
+      text = text.drop_front(end + strlen("</loops>"));
+    }
+  }
+
+  if (!inTrace || trace.steps.empty()) {
+    llvm::errs() << "No counterexample found in XML trace\n";
+    return failure();
+  }
+  return trace;
+}
+
+// Textual traces (show_traces -p 0) look like this:
+//
+// Trace Description: LTL Counterexample
+// Trace Type: Counterexample
+//   -> State: 1.1 <-
+//     model.fork0.sent_0 = FALSE
+//   -> Input: 1.2 <-
+//     seq_generator_A.outs = TRUE
+//   -- Loop starts here
+//   -> State: 1.2 <-
+//     model.fork0.sent_0 = TRUE
+FailureOr<SmvTrace> SmvTrace::parseText(StringRef text) {
+  SmvTrace trace;
+  bool inTrace = false, inState = false, loopStartsHere = false;
+  Step *step = nullptr;
+
+  SmallVector<StringRef> lines;
+  text.split(lines, '\n');
+  for (StringRef line : lines) {
+    line = line.trim();
+    if (line.consume_front("Trace Description:")) {
+      // Only parse the first trace
+      if (inTrace)
+        break;
+      inTrace = true;
+      trace.description = line.trim().str();
+      continue;
+    }
+    if (!inTrace)
+      continue;
+
+    if (line == "-- Loop starts here") {
+      loopStartsHere = true;
+      continue;
+    }
+    if (line.consume_front("->")) {
+      // Step header, e.g., "-> State: 1.2 <-"
+      line = line.trim();
+      bool isState = line.consume_front("State:");
+      if (!isState && !line.consume_front("Input:"))
+        continue;
+      StringRef stepID = line.rsplit("<-").first.trim().rsplit('.').second;
+      unsigned id;
+      if (stepID.getAsInteger(10, id) || id == 0) {
+        llvm::errs() << "Invalid step identifier in trace: " << line << "\n";
+        return failure();
+      }
+      step = &trace.getOrCreateStep(id);
+      inState = isState;
+      if (isState && loopStartsHere) {
+        trace.loopStart = id - 1;
+        loopStartsHere = false;
+      }
+      continue;
+    }
+
+    // Variable assignment, e.g., "model.fork0.sent_0 = TRUE"
+    auto [var, value] = line.split(" = ");
+    if (!step || value.empty() || var.empty() || var.starts_with("--"))
+      continue;
+    step->values[var.trim()] = value.trim().str();
+    if (inState)
+      trace.stateVars.insert(var.trim());
+  }
+
+  if (!inTrace || trace.steps.empty()) {
+    llvm::errs() << "No counterexample found in trace\n";
+    return failure();
+  }
+  return trace;
+}
+
+std::optional<StringRef> SmvTrace::getValue(unsigned step,
+                                            StringRef var) const {
+  assert(step < steps.size() && "step out of bounds");
+  const llvm::StringMap<std::string> &values = steps[step].values;
+  if (auto it = values.find(var); it != values.end())
+    return StringRef(it->second);
+  return std::nullopt;
+}
+
+std::vector<std::string> SmvTrace::getChanges(unsigned step) const {
+  assert(step < steps.size() && "step out of bounds");
+  std::vector<std::string> changes;
+  for (const auto &entry : steps[step].values) {
+    if (step == 0 || getValue(step - 1, entry.getKey()) != entry.getValue())
+      changes.push_back(entry.getKey().str());
+  }
+  llvm::sort(changes);
+  return changes;
+}
+
+void SmvTrace::renameVariables(
+    llvm::function_ref<std::string(StringRef)> rename) {
+  for (Step &step : steps) {
+    llvm::StringMap<std::string> values;
+    for (auto &entry : step.values)
+      values[rename(entry.getKey())] = std::move(entry.getValue());
+    step.values = std::move(values);
+  }
+  llvm::StringSet<> renamedStateVars;
+  for (const auto &var : stateVars)
+    renamedStateVars.insert(rename(var.getKey()));
+  stateVars = std::move(renamedStateVars);
+}
+
+void SmvTrace::print(raw_ostream &os) const {
+  os << description << " (" << steps.size() << " steps)\n";
+  for (unsigned step = 0, e = steps.size(); step < e; ++step) {
+    os << "step " << step;
+    if (loopStart == step)
+      os << " (loop starts here)";
+    os << "\n";
+    for (const std::string &var : getChanges(step))
+      os << "  " << var << " = " << *getValue(step, var) << "\n";
+  }
+}
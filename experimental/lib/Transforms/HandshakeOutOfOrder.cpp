@@ -0,0 +1,435 @@
+//===- HandshakeOutOfOrder.cpp - Out-of-order execution ------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --handshake-out-of-order pass, which lets the tokens of
+// successive executions of an if-then-else region complete out of order.
+//
+// In a regular dataflow circuit, the muxes at the end of an if-then-else
+// region serve tokens in the order in which branches were taken, so that a
+// short path must wait behind a long path taken by an earlier execution. The
+// pass instead tags all tokens entering the region with a tagger, replaces the
+// muxes and the control merge joining the branches with plain merges that
+// accept tokens as soon as they arrive, and restores program order with an
+// untagger which frees tags back to the tagger.
+//
+// A region is eligible when its entry block only branches to its "then" and
+// (optional) "else" blocks, which themselves only contain dataflow
+// computations (no memory accesses, no control flow, no merges) and jump to the
+// same exit block. Values which only cross the region (e.g., loop-carried
+// induction variables) bypass it instead of being tagged, so that they are not
+// held back by the untagger.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
+#include "dynamatic/Support/Backedge.h"
+#include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/DynamaticPass.h"
+#include "dynamatic/Transforms/HandshakeMaterialize.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+
+#define DEBUG_TYPE "handshake-out-of-order"
+
+using namespace mlir;
+using namespace dynamatic;
+
+// [START Boilerplate code for the MLIR pass]
+#include "experimental/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+namespace experimental {
+#define GEN_PASS_DEF_HANDSHAKEOUTOFORDER
+#include "experimental/Transforms/Passes.h.inc"
+} // namespace experimental
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+namespace {
+
+/// An if-then-else region whose executions may complete out of order.
+struct OutOfOrderRegion {
+  /// Block ending with the branches into the region.
+  unsigned entryBB;
+  /// Block starting with the merges out of the region.
+  unsigned exitBB;
+  /// Branches of the entry block, whose operands are tagged.
+  SmallVector<handshake::ConditionalBranchOp> branches;
+  /// Operations whose results are tagged: the branches, the forks of their
+  /// results in the entry block, and all operations of the branch blocks.
+  llvm::SetVector<Operation *> ops;
+  /// Control merge and muxes of the exit block.
+  handshake::ControlMergeOp cmergeOp;
+  SmallVector<handshake::MuxOp> muxOps;
+  /// Forks of the control merge's index.
+  SmallVector<Operation *> indexForks;
+  /// Branches of the entry block whose results only feed both data operands of
+  /// a mux of the exit block, i.e., which forward a value across the region.
+  SmallVector<std::pair<handshake::ConditionalBranchOp, handshake::MuxOp>>
+      forwarded;
+};
+
+struct HandshakeOutOfOrderPass
+    : public dynamatic::experimental::impl::HandshakeOutOfOrderBase<
+          HandshakeOutOfOrderPass> {
+
+  using HandshakeOutOfOrderBase::HandshakeOutOfOrderBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Tries to identify an eligible region whose entry is the given block.
+  FailureOr<OutOfOrderRegion> findRegion(const LogicBBs &logicBBs,
+                                         unsigned entryBB);
+
+  /// Tags all tokens flowing through the region and lets them leave it out of
+  /// order, restoring program order at the beginning of the exit block.
+  void tagRegion(OutOfOrderRegion &region);
+};
+} // namespace
+
+/// Returns whether the value carries any extra signal.
+static bool hasExtraSignals(Value val) {
+  auto extraType =
+      dyn_cast<handshake::ExtraSignalsTypeInterface>(val.getType());
+  return extraType && extraType.getNumExtraSignals() != 0;
+}
+
+/// Returns the branch whose two results are the data operands of the mux, if
+/// any. In materialized IR, the branch then forwards its data operand to the
+/// mux whatever path is taken.
+static handshake::ConditionalBranchOp
+getForwardingBranch(handshake::MuxOp muxOp) {
+  ValueRange dataOprds = muxOp.getDataOperands();
+  auto condOp = dataOprds[0].getDefiningOp<handshake::ConditionalBranchOp>();
+  if (!condOp || dataOprds[1].getDefiningOp() != condOp ||
+      dataOprds[0] == dataOprds[1])
+    return nullptr;
+  return condOp;
+}
+
+/// Collects the forks through which the value is transitively forwarded in the
+/// given block.
+static void collectForks(Value val, unsigned bb,
+                         llvm::SetVector<Operation *> &forks) {
+  for (Operation *userOp : val.getUsers()) {
+    if (!isa<handshake::ForkOp, handshake::LazyForkOp>(userOp))
+      continue;
+    std::optional<unsigned> userBB = getLogicBB(userOp);
+    if (!userBB || *userBB != bb || !forks.insert(userOp))
+      continue;
+    for (Value res : userOp->getResults())
+      collectForks(res, bb, forks);
+  }
+}
+
+/// Collects the blocks of the operations consuming the value, looking through
+/// forks of the entry block and ignoring sinks. Fails if a consumer belongs to
+/// no block or to the entry block itself.
+static LogicalResult collectSuccessorBBs(Value val, unsigned entryBB,
+                                         llvm::SetVector<unsigned> &succBBs) {
+  for (Operation *userOp : val.getUsers()) {
+    if (isa<handshake::SinkOp>(userOp))
+      continue;
+    std::optional<unsigned> userBB = getLogicBB(userOp);
+    if (!userBB)
+      return failure();
+    if (*userBB != entryBB) {
+      succBBs.insert(*userBB);
+      continue;
+    }
+    if (!isa<handshake::ForkOp, handshake::LazyForkOp>(userOp))
+      return failure();
+    for (Value res : userOp->getResults()) {
+      if (failed(collectSuccessorBBs(res, entryBB, succBBs)))
+        return failure();
+    }
+  }
+  return success();
+}
+
+FailureOr<OutOfOrderRegion>
+HandshakeOutOfOrderPass::findRegion(const LogicBBs &logicBBs,
+                                    unsigned entryBB) {
+  OutOfOrderRegion region;
+  region.entryBB = entryBB;
+  for (Operation *op : logicBBs.blocks.lookup(entryBB)) {
+    if (auto condOp = dyn_cast<handshake::ConditionalBranchOp>(op))
+      region.branches.push_back(condOp);
+  }
+  if (region.branches.empty())
+    return failure();
+
+  // All branches must go to the same two successor blocks
+  llvm::SetVector<unsigned> succBBs;
+  for (handshake::ConditionalBranchOp condOp : region.branches) {
+    for (Value res : condOp->getResults()) {
+      if (failed(collectSuccessorBBs(res, entryBB, succBBs)))
+        return failure();
+    }
+  }
+  if (succBBs.size() != 2)
+    return failure();
+
+  // Successors containing a control merge have other predecessors than the
+  // entry block and must be the exit block. Others are the branch blocks,
+  // which must come after the entry block (i.e., not be a loop header).
+  SmallVector<unsigned, 2> branchBBs;
+  std::optional<unsigned> exitBB;
+  for (unsigned bb : succBBs) {
+    bool hasMerge =
+        llvm::any_of(logicBBs.blocks.lookup(bb), [](Operation *op) {
+          return isa<handshake::MergeLikeOpInterface>(op);
+        });
+    if (!hasMerge && bb > entryBB)
+      branchBBs.push_back(bb);
+    else if (!exitBB)
+      exitBB = bb;
+    else
+      return failure();
+  }
+  if (branchBBs.empty())
+    return failure();
+
+  // Gather the operations whose results will be tagged
+  for (handshake::ConditionalBranchOp condOp : region.branches) {
+    region.ops.insert(condOp);
+    for (Value res : condOp->getResults())
+      collectForks(res, entryBB, region.ops);
+  }
+  for (unsigned bb : branchBBs) {
+    for (Operation *op : logicBBs.blocks.lookup(bb)) {
+      if (isa<handshake::MemPortOpInterface, handshake::MemoryOpInterface,
+              handshake::ConditionalBranchOp, handshake::EndOp>(op)) {
+        LLVM_DEBUG(llvm::dbgs() << "Block " << bb << " contains " << *op
+                                << ", which cannot be executed out of order\n");
+        return failure();
+      }
+      region.ops.insert(op);
+    }
+  }
+
+  // Tokens may only enter the region through the branches of the entry block
+  // and must not already carry extra signals. Tokens produced inside the region
+  // may only come from sources, whose tag is 0 and leaves the tag of the tokens
+  // they are joined with unchanged (tags are OR-ed when joining tokens)
+  for (Operation *op : region.ops) {
+    if (op->getNumOperands() == 0 && !isa<handshake::SourceOp>(op)) {
+      LLVM_DEBUG(llvm::dbgs() << *op << " produces untagged tokens\n");
+      return failure();
+    }
+    for (Value oprd : op->getOperands()) {
+      if (hasExtraSignals(oprd))
+        return failure();
+      if (isa<handshake::ConditionalBranchOp>(op))
+        continue;
+      Operation *defOp = oprd.getDefiningOp();
+      if (!defOp || !region.ops.contains(defOp))
+        return failure();
+    }
+  }
+
+  // Tokens may only leave the region through the exit block's control merge
+  // and muxes, or be dropped
+  for (Operation *op : region.ops) {
+    for (OpOperand &use : op->getUses()) {
+      Operation *userOp = use.getOwner();
+      if (region.ops.contains(userOp) || isa<handshake::SinkOp>(userOp))
+        continue;
+      std::optional<unsigned> userBB = getLogicBB(userOp);
+      if (!userBB || (exitBB && *userBB != *exitBB))
+        return failure();
+      exitBB = *userBB;
+      if (auto cmergeOp = dyn_cast<handshake::ControlMergeOp>(userOp)) {
+        if (region.cmergeOp && region.cmergeOp != cmergeOp)
+          return failure();
+        region.cmergeOp = cmergeOp;
+      } else if (auto muxOp = dyn_cast<handshake::MuxOp>(userOp)) {
+        if (use.get() == muxOp.getSelectOperand())
+          return failure();
+        if (!llvm::is_contained(region.muxOps, muxOp))
+          region.muxOps.push_back(muxOp);
+      } else {
+        return failure();
+      }
+    }
+  }
+  if (!exitBB || !region.cmergeOp)
+    return failure();
+  region.exitBB = *exitBB;
+
+  // The exit block's merges must only join the two paths out of the region
+  for (Operation *op : logicBBs.blocks.lookup(region.exitBB)) {
+    auto mergeOp = dyn_cast<handshake::MergeLikeOpInterface>(op);
+    if (!mergeOp)
+      continue;
+    if (op != region.cmergeOp && !llvm::is_contained(region.muxOps, op))
+      return failure();
+    OperandRange dataOprds = mergeOp.getDataOperands();
+    if (dataOprds.size() != 2)
+      return failure();
+    for (Value oprd : dataOprds) {
+      Operation *defOp = oprd.getDefiningOp();
+      if (!defOp || !region.ops.contains(defOp))
+        return failure();
+    }
+  }
+
+  // The control merge's index must only select the muxes' inputs
+  llvm::SetVector<Operation *> indexForks;
+  SmallVector<Value> indexValues{region.cmergeOp.getIndex()};
+  while (!indexValues.empty()) {
+    Value index = indexValues.pop_back_val();
+    for (Operation *userOp : index.getUsers()) {
+      if (isa<handshake::ForkOp, handshake::LazyForkOp>(userOp)) {
+        indexForks.insert(userOp);
+        llvm::append_range(indexValues, userOp->getResults());
+      } else if (!isa<handshake::SinkOp>(userOp) &&
+                 !llvm::is_contained(region.muxOps, userOp)) {
+        return failure();
+      }
+    }
+  }
+  region.indexForks = indexForks.takeVector();
+
+  // Values which are only forwarded across the region bypass it
+  llvm::erase_if(region.muxOps, [&](handshake::MuxOp muxOp) {
+    handshake::ConditionalBranchOp condOp = getForwardingBranch(muxOp);
+    if (!condOp)
+      return false;
+    region.forwarded.emplace_back(condOp, muxOp);
+    region.ops.remove(condOp);
+    region.branches.erase(llvm::find(region.branches, condOp));
+    return true;
+  });
+  if (region.branches.empty() || region.muxOps.empty())
+    return failure();
+  return region;
+}
+
+void HandshakeOutOfOrderPass::tagRegion(OutOfOrderRegion &region) {
+  MLIRContext *ctx = &getContext();
+  OpBuilder builder(ctx);
+
+  // Forward values crossing the region directly to the exit block
+  for (auto [condOp, muxOp] : region.forwarded) {
+    muxOp.getResult().replaceAllUsesWith(condOp.getDataOperand());
+    builder.setInsertionPoint(condOp);
+    auto sinkOp = builder.create<handshake::SinkOp>(
+        condOp.getLoc(), condOp.getConditionOperand());
+    inheritBB(condOp, sinkOp);
+    muxOp->erase();
+    condOp->erase();
+  }
+
+  // Tag all tokens entering the region together. The tagger's credits come
+  // from the untagger, which is created last.
+  SmallVector<OpOperand *> entering;
+  SmallVector<Value> enteringValues;
+  for (handshake::ConditionalBranchOp condOp : region.branches) {
+    for (OpOperand &oprd : condOp->getOpOperands()) {
+      entering.push_back(&oprd);
+      enteringValues.push_back(oprd.get());
+    }
+  }
+  Location loc = region.branches.front().getLoc();
+  builder.setInsertionPoint(region.branches.front());
+  BackedgeBuilder backedges(builder, loc);
+  Backedge credit = backedges.get(handshake::ControlType::get(ctx));
+  auto taggerOp = builder.create<handshake::TaggerOp>(loc, enteringValues,
+                                                      credit, numTags);
+  setBB(taggerOp, region.entryBB);
+  for (auto [oprd, tagged] : llvm::zip(entering, taggerOp.getDataResults()))
+    oprd->set(tagged);
+
+  for (Operation *op : region.ops) {
+    for (OpResult res : op->getResults())
+      res.setType(handshake::TaggerOp::getTaggedType(res.getType(), numTags));
+  }
+
+  // Let tokens leave the region in the order in which they arrive
+  SmallVector<Value> exitResults, exitValues;
+  builder.setInsertionPoint(region.cmergeOp);
+  for (handshake::MuxOp muxOp : region.muxOps) {
+    auto mergeOp = builder.create<handshake::MergeOp>(muxOp.getLoc(),
+                                                      muxOp.getDataOperands());
+    inheritBB(muxOp, mergeOp);
+    exitResults.push_back(muxOp.getResult());
+    exitValues.push_back(mergeOp.getResult());
+  }
+  auto mergeOp = builder.create<handshake::MergeOp>(
+      region.cmergeOp.getLoc(), region.cmergeOp.getDataOperands());
+  inheritBB(region.cmergeOp, mergeOp);
+  exitResults.push_back(region.cmergeOp.getResult());
+  exitValues.push_back(mergeOp.getResult());
+
+  // Restore program order and free tags once all tokens of the same execution
+  // have left the region
+  auto untaggerOp = builder.create<handshake::UntaggerOp>(
+      region.cmergeOp.getLoc(), exitValues, numTags);
+  setBB(untaggerOp, region.exitBB);
+  for (auto [res, untagged] :
+       llvm::zip(exitResults, untaggerOp.getDataResults()))
+    res.replaceAllUsesWith(untagged);
+  credit.setValue(untaggerOp.getCredit());
+
+  // The index of the control merge no longer selects anything
+  for (handshake::MuxOp muxOp : region.muxOps)
+    muxOp->erase();
+  for (Operation *forkOp : llvm::reverse(region.indexForks)) {
+    // Nested forks were erased first, so only sinks remain
+    for (Operation *userOp : llvm::make_early_inc_range(forkOp->getUsers()))
+      userOp->erase();
+    forkOp->erase();
+  }
+  for (Operation *userOp :
+       llvm::make_early_inc_range(region.cmergeOp.getIndex().getUsers()))
+    userOp->erase();
+  region.cmergeOp->erase();
+}
+
+void HandshakeOutOfOrderPass::runDynamaticPass() {
+  mlir::ModuleOp modOp = getOperation();
+  if (numTags < 2 || !llvm::isPowerOf2_32(numTags)) {
+    modOp->emitError() << "Number of tags must be a power of two greater than "
+                          "one, but got "
+                       << numTags;
+    return signalPassFailure();
+  }
+  if (failed(verifyIRMaterialized(modOp))) {
+    modOp->emitError() << ERR_NON_MATERIALIZED_MOD;
+    return signalPassFailure();
+  }
+
+  for (handshake::FuncOp funcOp : modOp.getOps<handshake::FuncOp>()) {
+    // Identify all regions before modifying the function, since blocks of
+    // consecutive regions may overlap
+    LogicBBs logicBBs = getLogicBBs(funcOp);
+    SmallVector<OutOfOrderRegion> regions;
+    for (unsigned bb : llvm::make_first_range(logicBBs.blocks)) {
+      FailureOr<OutOfOrderRegion> region = findRegion(logicBBs, bb);
+      if (succeeded(region)) {
+        LLVM_DEBUG(llvm::dbgs() << "Tagging region from block " << bb
+                                << " to block " << region->exitBB << "\n");
+        regions.push_back(std::move(*region));
+      }
+    }
+
+    if (regions.empty()) {
+      funcOp.emitWarning()
+          << "Found no if-then-else region that can be executed out of order";
+      continue;
+    }
+    for (OutOfOrderRegion &region : regions)
+      tagRegion(region);
+  }
+}
@@ -25,6 +25,7 @@
 #include "dynamatic/Dialect/Handshake/HandshakeAttributes.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "dynamatic/Transforms/HandshakeMaterialize.h"
 #include "llvm/ADT/StringRef.h"
 
@@ -92,6 +93,7 @@ struct HandshakePlaceBuffersCustomPass
     auto bufOp = builder.create<handshake::BufferOp>(channel.getLoc(), channel,
                                                      slots, bufferType);
     inheritBB(succ, bufOp);
+    setClockDomain(bufOp, getChannelClockDomain(channel));
     Value bufferRes = bufOp->getResult(0);
     succ->replaceUsesOfWith(channel, bufferRes);
   }
@@ -19,6 +19,7 @@
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/Attribute.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Support/TimingModels.h"
 #include "experimental/Transforms/LSQSizing/LSQSizingSupport.h"
 #include "mlir/IR/Value.h"
@@ -77,8 +78,8 @@ private:
   /// Determines the LSQ sizes, given a CFDFC and its II
   std::optional<LSQSizingResult>
   sizeLSQsForCFDFC(handshake::FuncOp funcOp, llvm::SetVector<unsigned> cfdfcBBs,
-                   TimingDatabase timingDB, unsigned initialII,
-                   const std::string &collisions, double targetCP);
+                   CostModel &costModel, unsigned initialII,
+                   const std::string &collisions);
 
   /// Finds the Start Node in a CFDFC
   /// The start node, is the node with the longest non-cyclic path to any other
@@ -146,9 +147,9 @@ void HandshakeSizeLSQsPass::runDynamaticPass() {
   llvm::SmallVector<LSQSizingResult> sizingResults;
 
   // Read component latencies
-  TimingDatabase timingDB;
-  if (failed(TimingDatabase::readFromJSON(timingModels, timingDB)))
-    signalPassFailure();
+  FailureOr<CostModel *> costModel = CostModel::get(timingModels, targetCP);
+  if (failed(costModel))
+    return signalPassFailure();
 
   mlir::ModuleOp mod = getOperation();
   for (handshake::FuncOp funcOp : mod.getOps<handshake::FuncOp>()) {
@@ -199,8 +200,8 @@ void HandshakeSizeLSQsPass::runDynamaticPass() {
         continue;
 
       std::optional<LSQSizingResult> result =
-          sizeLSQsForCFDFC(funcOp, entry.second, timingDB,
-                           cfdfcIIMap.at(entry.first), collisions, targetCP);
+          sizeLSQsForCFDFC(funcOp, entry.second, **costModel,
+                           cfdfcIIMap.at(entry.first), collisions);
 
       if (result) {
         for (auto &entry : result.value()) {
@@ -236,11 +237,9 @@ void HandshakeSizeLSQsPass::runDynamaticPass() {
 
 std::optional<LSQSizingResult> HandshakeSizeLSQsPass::sizeLSQsForCFDFC(
     handshake::FuncOp funcOp, llvm::SetVector<unsigned> cfdfcBBs,
-    TimingDatabase timingDB, unsigned initialII, const std::string &collisions,
-    double targetCP) {
+    CostModel &costModel, unsigned initialII, const std::string &collisions) {
 
-  CFDFCGraph graph(funcOp, std::move(cfdfcBBs), std::move(timingDB), initialII,
-                   targetCP);
+  CFDFCGraph graph(funcOp, std::move(cfdfcBBs), costModel, initialII);
 
   // We only want LSQ loads and stores (not MC loads and stores), therefore we
   // need to check if they are connected to an LSQ
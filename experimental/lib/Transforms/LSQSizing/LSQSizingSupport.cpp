@@ -20,9 +20,10 @@
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/MemoryInterfaces.h"
 #include "dynamatic/Support/CFG.h"
-#include "dynamatic/Support/TimingModels.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/CFDFC.h"
 
+#include <cmath>
 #include <set>
 #include <stack>
 
@@ -30,29 +31,16 @@ using namespace mlir;
 using namespace dynamatic;
 using namespace dynamatic::experimental::lsqsizing;
 
-/// Extracts the latency for each operation
-/// This is done in 3 ways:
-/// 1. If the operation is in the timingDB, the latency is extracted from the
-/// timingDB
-/// 2. If the operation is a buffer operation, the latency is extracted from the
-/// timing attribute
-/// 3. If the operation is neither, then its latency is set to 0
-static int extractNodeLatency(mlir::Operation *op,
-                              const TimingDatabase &timingDB, double targetCP) {
-  auto latencyOrFail = timingDB.getLatency(op, SignalType::DATA, targetCP);
-  if (succeeded(latencyOrFail))
-    return *latencyOrFail;
-
-  if (auto bufferOp = llvm::dyn_cast<handshake::BufferOp>(op)) {
-    return bufferOp.getLatencyDV();
-  }
-
-  return 0;
+/// Extracts the latency of each operation from the cost model, in cycles of
+/// the main clock. Buffers' latency is given by their type, and operations
+/// without a timing model have a latency of 0
+static int extractNodeLatency(mlir::Operation *op, CostModel &costModel) {
+  return static_cast<int>(std::ceil(costModel.getUnitCost(op).latency));
 }
 
 CFDFCGraph::CFDFCGraph(handshake::FuncOp funcOp,
                        llvm::SetVector<unsigned> cfdfcBBs,
-                       TimingDatabase timingDB, unsigned ii, double targetCP) {
+                       CostModel &costModel, unsigned ii) {
 
   for (Operation &op : funcOp.getOps()) {
     // Get operation's basic block
@@ -67,7 +55,7 @@ CFDFCGraph::CFDFCGraph(handshake::FuncOp funcOp,
       continue;
 
     // Add the unit and valid outgoing channels to the CFDFC
-    addNode(&op, extractNodeLatency(&op, timingDB, targetCP));
+    addNode(&op, extractNodeLatency(&op, costModel));
 
     for (OpResult res : op.getResults()) {
       assert(std::distance(res.getUsers().begin(), res.getUsers().end()) == 1 &&
@@ -15,6 +15,7 @@
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
 #include "dynamatic/Support/CFG.h"
+#include "experimental/Transforms/Speculation/HandshakeSpeculation.h"
 #include "experimental/Transforms/Speculation/PlacementFinder.h"
 #include "experimental/Transforms/Speculation/SpeculationPlacement.h"
 #include "mlir/IR/BuiltinOps.h"
@@ -23,6 +24,7 @@
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include <string>
@@ -45,6 +47,19 @@ namespace experimental {
 
 namespace {
 
+/// Placements and placed units of a single speculator. A function may contain
+/// several independent speculation points, each marked by its own
+/// `dynamatic.speculate` attribute.
+struct SpeculationPoint {
+  SpeculationPlacements placements;
+  SpeculatorOp speculatorOp;
+
+  // In the placeCommits method, commit units are temporarily connected to
+  // this value as an alternative to control signals and are subsequently
+  // referenced in the routeCommitControl method.
+  std::optional<Value> fakeControlForCommits;
+};
+
 struct HandshakeSpeculationPass
     : public dynamatic::experimental::impl::HandshakeSpeculationBase<
           HandshakeSpeculationPass> {
@@ -54,26 +69,20 @@ struct HandshakeSpeculationPass
   void runOnOperation() override;
 
 private:
-  SpeculationPlacements placements;
-  SpeculatorOp speculatorOp;
-
-  // In the placeCommits method, commit units are temporarily connected to
-  // this value as an alternative to control signals and are subsequently
-  // referenced in the routeCommitControl method.
-  std::optional<Value> fakeControlForCommits;
+  SmallVector<SpeculationPoint> points;
 
   /// Place the operation handshake::SpeculatorOp
-  LogicalResult placeSpeculator();
+  LogicalResult placeSpeculator(SpeculationPoint &point);
 
   /// Create the control path for commit signals by replicating branches
-  LogicalResult routeCommitControl();
+  LogicalResult routeCommitControl(SpeculationPoint &point);
 
   /// Place commit units. Use fakeControlForCommits as a temporary control
   /// signal.
-  LogicalResult placeCommits();
+  LogicalResult placeCommits(SpeculationPoint &point);
 
   /// Place save-commit units and connect directly to speculator
-  LogicalResult placeSaveCommits();
+  LogicalResult placeSaveCommits(SpeculationPoint &point);
 
   /// Adds a spec tag to the operand/result types in the speculative region.
   /// Traverses both upstream and downstream within the region, starting from
@@ -81,11 +90,11 @@ private:
   /// ConstantOp.
   /// See the documentation for more details:
   /// docs/Speculation/AddingSpecTagsToSpecRegion.md
-  LogicalResult addSpecTagToSpecRegion();
+  LogicalResult addSpecTagToSpecRegion(SpeculationPoint &point);
 
   // Add NonSpecOps to the non-speculative edges of MuxOp/CMergeOp to satisfy
   // their type requirements.
-  LogicalResult addNonSpecOp();
+  LogicalResult addNonSpecOp(FuncOp funcOp);
 };
 
 // The list item to trace the branches that need to be replicated
@@ -157,6 +166,14 @@ static bool forkTreeEquals(Value a, Value b) {
   return findForkTreeTop(a) == findForkTreeTop(b);
 }
 
+/// Returns whether the save-commit is controlled by the speculator, i.e.,
+/// whether its issue control comes from the speculator through forks.
+static bool isSaveCommitOf(SpecSaveCommitOp saveCommitOp,
+                           SpeculatorOp speculatorOp) {
+  return findForkTreeTop(saveCommitOp.getIssueCtrl()) ==
+         speculatorOp.getIssueCtrl();
+}
+
 /// Finds an existing branch op that uses the given condition and data.
 /// Works for both SpeculatingBranchOp and ConditionalBranchOp.
 template <typename BranchOpType>
@@ -182,6 +199,7 @@ static std::optional<BranchOpType> findExistingBranch(Value condition,
 // newly created path with value ctrlSignal
 static void
 routeCommitControlRecursive(MLIRContext *ctx, SpeculatorOp &specOp,
+                            Value fakeControl,
                             llvm::DenseSet<Operation *> &arrived,
                             OpOperand &currOpOperand,
                             std::vector<BranchTracingItem> &branchTrace) {
@@ -202,6 +220,11 @@ routeCommitControlRecursive(MLIRContext *ctx, SpeculatorOp &specOp,
     return;
 
   if (auto commitOp = dyn_cast<handshake::SpecCommitOp>(currOp)) {
+    // Commits of other speculators are routed when their own speculator is
+    // processed
+    if (commitOp.getCtrl() != fakeControl)
+      return;
+
     // We replicate branches only if the traversal reaches a commit.
     // Because sometimes a path of branches does not reach a commit unit.
     Value ctrlSignal = specOp.getCommitCtrl();
@@ -264,8 +287,8 @@ routeCommitControlRecursive(MLIRContext *ctx, SpeculatorOp &specOp,
 
       for (OpOperand &dstOpOperand : result.getUses()) {
         // Continue traversal with new branchTracingList
-        routeCommitControlRecursive(ctx, specOp, arrived, dstOpOperand,
-                                    branchTrace);
+        routeCommitControlRecursive(ctx, specOp, fakeControl, arrived,
+                                    dstOpOperand, branchTrace);
       }
 
       // Pop the current branch info from the vector
@@ -276,8 +299,8 @@ routeCommitControlRecursive(MLIRContext *ctx, SpeculatorOp &specOp,
     // Continue Traversal
     for (OpResult res : currOp->getResults()) {
       for (OpOperand &dstOpOperand : res.getUses()) {
-        routeCommitControlRecursive(ctx, specOp, arrived, dstOpOperand,
-                                    branchTrace);
+        routeCommitControlRecursive(ctx, specOp, fakeControl, arrived,
+                                    dstOpOperand, branchTrace);
       }
     }
   }
@@ -296,7 +319,10 @@ static bool areAllCommitsRouted(Value fakeControl) {
   return true;
 }
 
-LogicalResult HandshakeSpeculationPass::routeCommitControl() {
+LogicalResult
+HandshakeSpeculationPass::routeCommitControl(SpeculationPoint &point) {
+  SpeculatorOp speculatorOp = point.speculatorOp;
+  std::optional<Value> fakeControlForCommits = point.fakeControlForCommits;
   if (!fakeControlForCommits.has_value()) {
     llvm::errs() << "Error: fakeControlForCommits doesn't have a value. Please "
                     "place commit units first.\n";
@@ -307,15 +333,19 @@ LogicalResult HandshakeSpeculationPass::routeCommitControl() {
   std::vector<BranchTracingItem> branchTrace;
   // Start traversal from the speculator
   for (OpOperand &succOpOperand : speculatorOp.getDataOut().getUses()) {
-    routeCommitControlRecursive(&getContext(), speculatorOp, arrived,
-                                succOpOperand, branchTrace);
+    routeCommitControlRecursive(&getContext(), speculatorOp,
+                                *fakeControlForCommits, arrived, succOpOperand,
+                                branchTrace);
   }
-  // Start traversal from save-commit units
+  // Start traversal from the save-commit units of this speculator
   for (auto saveCommitOp : mlir::cast<FuncOp>(speculatorOp->getParentOp())
                                .getOps<SpecSaveCommitOp>()) {
+    if (!isSaveCommitOf(saveCommitOp, speculatorOp))
+      continue;
     for (OpOperand &succOpOperand : saveCommitOp.getDataOut().getUses()) {
       branchTrace.clear();
-      routeCommitControlRecursive(&getContext(), speculatorOp, arrived,
+      routeCommitControlRecursive(&getContext(), speculatorOp,
+                                  *fakeControlForCommits, arrived,
                                   succOpOperand, branchTrace);
     }
   }
@@ -324,7 +354,10 @@ LogicalResult HandshakeSpeculationPass::routeCommitControl() {
   return success(areAllCommitsRouted(fakeControlForCommits.value()));
 }
 
-LogicalResult HandshakeSpeculationPass::placeCommits() {
+LogicalResult HandshakeSpeculationPass::placeCommits(SpeculationPoint &point) {
+  SpeculatorOp speculatorOp = point.speculatorOp;
+  std::optional<Value> &fakeControlForCommits = point.fakeControlForCommits;
+
   // Create a temporal value to connect the commits
   Value commitCtrl = speculatorOp.getCommitCtrl();
   OpBuilder builder(&getContext());
@@ -341,7 +374,7 @@ LogicalResult HandshakeSpeculationPass::placeCommits() {
           .getResult(0);
 
   // Place commits and connect to the fake control signal
-  for (OpOperand *operand : placements.getPlacements<SpecCommitOp>()) {
+  for (OpOperand *operand : point.placements.getPlacements<SpecCommitOp>()) {
     Operation *dstOp = operand->getOwner();
     Value srcOpResult = operand->get();
 
@@ -361,7 +394,9 @@ LogicalResult HandshakeSpeculationPass::placeCommits() {
   return success();
 }
 
-LogicalResult HandshakeSpeculationPass::placeSaveCommits() {
+LogicalResult
+HandshakeSpeculationPass::placeSaveCommits(SpeculationPoint &point) {
+  SpeculatorOp speculatorOp = point.speculatorOp;
   OpBuilder builder(&getContext());
 
   // Save-Commits receive two control inputs from the Speculator:
@@ -378,13 +413,14 @@ LogicalResult HandshakeSpeculationPass::placeSaveCommits() {
   Value historyCtrl = speculatorOp.getHistoryCtrl();
 
   // Get the specified FIFO depth
-  unsigned fifoDepth = placements.getSaveCommitsFifoDepth();
+  unsigned fifoDepth = point.placements.getSaveCommitsFifoDepth();
   if (fifoDepth == 0) {
     llvm::errs() << "Save Commit FIFO depth cannot be 0\n";
     return failure();
   }
 
-  for (OpOperand *operand : placements.getPlacements<SpecSaveCommitOp>()) {
+  for (OpOperand *operand :
+       point.placements.getPlacements<SpecSaveCommitOp>()) {
     Operation *dstOp = operand->getOwner();
     Value srcOpResult = operand->get();
 
@@ -449,10 +485,11 @@ std::optional<Value> findControlInputToBB(handshake::FuncOp &funcOp,
   return triggerChannelOrigin;
 }
 
-LogicalResult HandshakeSpeculationPass::placeSpeculator() {
+LogicalResult
+HandshakeSpeculationPass::placeSpeculator(SpeculationPoint &point) {
   MLIRContext *ctx = &getContext();
 
-  OpOperand &operand = placements.getSpeculatorPlacement();
+  OpOperand &operand = point.placements.getSpeculatorPlacement();
   Operation *dstOp = operand.getOwner();
   Value srcOpResult = operand.get();
 
@@ -480,7 +517,7 @@ LogicalResult HandshakeSpeculationPass::placeSpeculator() {
   builder.setInsertionPoint(dstOp);
 
   // Get the specified FIFO depth
-  unsigned fifoDepth = placements.getSpeculatorFifoDepth();
+  unsigned fifoDepth = point.placements.getSpeculatorFifoDepth();
   if (fifoDepth == 0) {
     llvm::errs() << "Speculator FIFO depth cannot be 0\n";
     return failure();
@@ -488,7 +525,7 @@ LogicalResult HandshakeSpeculationPass::placeSpeculator() {
 
   // dataOutType is tentative and will be updated in the addSpecTag algorithm
   // later.
-  speculatorOp = builder.create<SpeculatorOp>(
+  SpeculatorOp speculatorOp = builder.create<SpeculatorOp>(
       dstOp->getLoc(), /*dataOutType=*/srcOpResult.getType(),
       /*dataIn=*/srcOpResult, /*trigger=*/specTrigger.value(), fifoDepth);
 
@@ -500,6 +537,7 @@ LogicalResult HandshakeSpeculationPass::placeSpeculator() {
   // Assign a Basic Block to the speculator
   inheritBB(dstOp, speculatorOp);
 
+  point.speculatorOp = speculatorOp;
   return success();
 }
 
@@ -525,11 +563,34 @@ static LogicalResult addSpecTagToValue(Value value) {
   return failure();
 }
 
+/// Returns whether the load's address is committed, which is the case for
+/// loads to an LSQ (see PlacementFinder). Such loads issue non-speculative
+/// requests and lie outside of the speculative region.
+static bool hasCommittedAddress(LoadOp loadOp) {
+  return isa_and_nonnull<SpecCommitOp>(
+      loadOp.getAddressInput().getDefiningOp());
+}
+
 static LogicalResult
 addSpecTagToSpecRegionRecursive(MLIRContext &ctx, OpOperand &opOperand,
                                 bool isDownstream,
                                 llvm::DenseSet<Operation *> &visited) {
 
+  // The data of a load with a committed address is non-speculative, so it
+  // enters the speculative region through a non-speculative unit instead of
+  // being tagged
+  if (auto loadOp = opOperand.get().getDefiningOp<LoadOp>();
+      !isDownstream && loadOp && hasCommittedAddress(loadOp)) {
+    Operation *userOp = opOperand.getOwner();
+    OpBuilder builder(&ctx);
+    builder.setInsertionPoint(userOp);
+    auto nonSpecOp = builder.create<NonSpecOp>(
+        userOp->getLoc(), opOperand.get().getType(), opOperand.get());
+    inheritBB(userOp, nonSpecOp);
+    opOperand.set(nonSpecOp.getResult());
+    return addSpecTagToValue(nonSpecOp.getResult());
+  }
+
   if (failed(addSpecTagToValue(opOperand.get())))
     return failure();
 
@@ -555,6 +616,14 @@ addSpecTagToSpecRegionRecursive(MLIRContext &ctx, OpOperand &opOperand,
   visited.insert(op);
 
   // Exceptional cases
+  if (isa<handshake::SpeculatorOp>(op)) {
+    // The traversal starts with the region's own speculator marked as
+    // visited, so this belongs to another speculation point
+    op->emitError("Speculative regions of different speculators should not "
+                  "overlap");
+    return failure();
+  }
+
   if (isa<handshake::SpecCommitOp>(op)) {
     if (isDownstream) {
       // Stop the traversal at the commit unit
@@ -696,7 +765,9 @@ addSpecTagToSpecRegionRecursive(MLIRContext &ctx, OpOperand &opOperand,
   return success();
 }
 
-LogicalResult HandshakeSpeculationPass::addSpecTagToSpecRegion() {
+LogicalResult
+HandshakeSpeculationPass::addSpecTagToSpecRegion(SpeculationPoint &point) {
+  SpeculatorOp speculatorOp = point.speculatorOp;
   llvm::DenseSet<Operation *> visited;
   visited.insert(speculatorOp);
 
@@ -711,8 +782,7 @@ LogicalResult HandshakeSpeculationPass::addSpecTagToSpecRegion() {
   return success();
 }
 
-LogicalResult HandshakeSpeculationPass::addNonSpecOp() {
-  auto funcOp = cast<FuncOp>(speculatorOp->getParentOp());
+LogicalResult HandshakeSpeculationPass::addNonSpecOp(FuncOp funcOp) {
   OpBuilder builder(&getContext());
 
   for (auto mergeLikeOp : funcOp.getOps<MergeLikeOpInterface>()) {
@@ -749,48 +819,219 @@ LogicalResult HandshakeSpeculationPass::addNonSpecOp() {
   return success();
 }
 
+/// Collects the commit units delimiting the speculative region of the
+/// speculator, i.e., those reachable downstream of its data output or of one of
+/// its save-commits without crossing another commit. Fails if the region
+/// reaches another speculator.
+static LogicalResult
+collectRegionCommits(SpeculatorOp specOp,
+                     llvm::DenseSet<Operation *> &commits) {
+  llvm::DenseSet<Operation *> visited;
+  SmallVector<Value> worklist{specOp.getDataOut()};
+  auto funcOp = cast<FuncOp>(specOp->getParentOp());
+  for (auto saveCommitOp : funcOp.getOps<SpecSaveCommitOp>()) {
+    if (isSaveCommitOf(saveCommitOp, specOp))
+      worklist.push_back(saveCommitOp.getDataOut());
+  }
+
+  while (!worklist.empty()) {
+    Value val = worklist.pop_back_val();
+    for (Operation *user : val.getUsers()) {
+      // Speculative tokens may loop back to the speculator itself
+      if (user == specOp || !visited.insert(user).second)
+        continue;
+      if (isa<SpecCommitOp>(user)) {
+        commits.insert(user);
+        continue;
+      }
+      // Speculating branches belong to the commit control network
+      if (isa<SpeculatingBranchOp>(user))
+        continue;
+      // The speculator's own save-commits were added to the worklist already
+      if (auto saveCommitOp = dyn_cast<SpecSaveCommitOp>(user)) {
+        if (isSaveCommitOf(saveCommitOp, specOp))
+          continue;
+      }
+      if (isa<SpeculatorOp, SpecSaveCommitOp>(user)) {
+        return user->emitError()
+               << "unit of another speculator is reachable from the "
+                  "speculative region without crossing a commit";
+      }
+      if (auto loadOp = dyn_cast<LoadOp>(user)) {
+        worklist.push_back(loadOp.getDataResult());
+        continue;
+      }
+      llvm::append_range(worklist, user->getResults());
+    }
+  }
+  return success();
+}
+
+/// Returns the speculator whose commit control output reaches the commit's
+/// control input through the network of replicated branches, or nullptr if the
+/// control input does not originate from a speculator.
+static SpeculatorOp findCommitControlSource(SpecCommitOp commitOp) {
+  Value ctrl = findForkTreeTop(commitOp.getCtrl());
+  while (Operation *defOp = ctrl.getDefiningOp()) {
+    if (auto specOp = dyn_cast<SpeculatorOp>(defOp))
+      return ctrl == specOp.getCommitCtrl() ? specOp : nullptr;
+
+    // Every branch on the path replicates a branch of the speculative region
+    // and must be steered by a speculating branch
+    auto branchOp = dyn_cast<ConditionalBranchOp>(defOp);
+    if (!branchOp || !isa_and_nonnull<SpeculatingBranchOp>(
+                         findForkTreeTop(branchOp.getConditionOperand())
+                             .getDefiningOp()))
+      return nullptr;
+    ctrl = findForkTreeTop(branchOp.getDataOperand());
+  }
+  return nullptr;
+}
+
+LogicalResult dynamatic::experimental::verifySpeculativeUnits(FuncOp funcOp) {
+  // Associate each commit to the speculator whose region it delimits
+  llvm::DenseMap<Operation *, SpeculatorOp> commitOwners;
+  for (auto specOp : funcOp.getOps<SpeculatorOp>()) {
+    llvm::DenseSet<Operation *> commits;
+    if (failed(collectRegionCommits(specOp, commits)))
+      return failure();
+    for (Operation *commitOp : commits) {
+      auto [it, inserted] = commitOwners.try_emplace(commitOp, specOp);
+      if (!inserted) {
+        return commitOp->emitError()
+               << "commit delimits the speculative regions of multiple "
+                  "speculators";
+      }
+    }
+  }
+
+  for (auto commitOp : funcOp.getOps<SpecCommitOp>()) {
+    SpeculatorOp owner = commitOwners.lookup(commitOp);
+    if (!owner) {
+      return commitOp.emitError()
+             << "commit is not reachable from any speculative region";
+    }
+    SpeculatorOp ctrlSource = findCommitControlSource(commitOp);
+    if (!ctrlSource) {
+      return commitOp.emitError() << "commit control does not originate from "
+                                     "a speculator's commit control output";
+    }
+    if (ctrlSource != owner) {
+      return commitOp.emitError()
+             << "commit is controlled by a different speculator than the one "
+                "whose speculative region it delimits";
+    }
+  }
+
+  for (auto saveCommitOp : funcOp.getOps<SpecSaveCommitOp>()) {
+    Value issueCtrl = findForkTreeTop(saveCommitOp.getIssueCtrl());
+    Value historyCtrl = findForkTreeTop(saveCommitOp.getHistoryCtrl());
+    auto specOp = issueCtrl.getDefiningOp<SpeculatorOp>();
+    if (!specOp || issueCtrl != specOp.getIssueCtrl() ||
+        historyCtrl != specOp.getHistoryCtrl()) {
+      return saveCommitOp.emitError()
+             << "save-commit must be controlled by the issue and history "
+                "control outputs of a single speculator";
+    }
+  }
+  return success();
+}
+
 void HandshakeSpeculationPass::runOnOperation() {
   mlir::ModuleOp modOp = getOperation();
+  points.clear();
 
-  if (failed(SpeculationPlacements::readFromAttribute(modOp, this->placements)))
+  SmallVector<SpeculationPlacements> allPlacements;
+  if (failed(SpeculationPlacements::readFromAttributes(modOp, allPlacements)))
     return signalPassFailure();
 
-  PlacementFinder finder(this->placements);
-  if (failed(finder.findPlacements()))
-    return signalPassFailure();
+  // Speculators are triggered by the control branch of their basic block, so
+  // each basic block may contain at most one speculation point
+  llvm::DenseMap<std::pair<Operation *, unsigned>, Operation *> specBBs;
+  for (SpeculationPlacements &placements : allPlacements) {
+    Operation *dstOp = placements.getSpeculatorPlacement().getOwner();
+    auto funcOp = dstOp->getParentOfType<FuncOp>();
+    std::optional<unsigned> bb = getLogicBB(dstOp);
+    if (!funcOp || !bb) {
+      dstOp->emitError("Speculated operation should belong to a BB of a "
+                       "function.");
+      return signalPassFailure();
+    }
+    auto [it, inserted] = specBBs.try_emplace({funcOp, *bb}, dstOp);
+    if (!inserted) {
+      dstOp->emitError("Multiple speculation points in BB #" +
+                       std::to_string(*bb));
+      return signalPassFailure();
+    }
+  }
 
-  if (failed(placeSpeculator()))
-    return signalPassFailure();
+  // Find the placements of all speculation points on the original circuit.
+  // Speculative tokens are committed before entering the basic block of
+  // another speculation point so that speculative regions never overlap.
+  for (SpeculationPlacements &placements : allPlacements) {
+    Operation *dstOp = placements.getSpeculatorPlacement().getOwner();
+    Operation *funcOp = dstOp->getParentOfType<FuncOp>();
+    llvm::DenseSet<unsigned> otherSpecBBs;
+    for (auto &[funcAndBB, otherOp] : specBBs) {
+      if (funcAndBB.first == funcOp && otherOp != dstOp)
+        otherSpecBBs.insert(funcAndBB.second);
+    }
 
-  // Save operations are not supported
-  if (!placements.getPlacements<SpecSaveOp>().empty()) {
-    llvm::errs() << "Error: Placement of save units is not supported.\n";
-    return signalPassFailure();
+    PlacementFinder finder(placements, otherSpecBBs);
+    if (failed(finder.findPlacements()))
+      return signalPassFailure();
+
+    // Save operations are not supported
+    if (!placements.getPlacements<SpecSaveOp>().empty()) {
+      llvm::errs() << "Error: Placement of save units is not supported.\n";
+      return signalPassFailure();
+    }
+    points.push_back(SpeculationPoint{std::move(placements), {}, {}});
   }
 
-  if (!placements.getPlacements<SpecSaveCommitOp>().empty()) {
-    if (failed(placeSaveCommits()))
+  // Place all speculators before anything else, since finding the trigger of a
+  // speculator requires its BB to only contain the original control branch
+  for (SpeculationPoint &point : points) {
+    if (failed(placeSpeculator(point)))
       return signalPassFailure();
   }
 
-  // Place Commit operations
-  if (failed(placeCommits()))
-    return signalPassFailure();
+  llvm::SetVector<FuncOp> funcOps;
+  for (SpeculationPoint &point : points) {
+    funcOps.insert(cast<FuncOp>(point.speculatorOp->getParentOp()));
 
-  // After placing all speculative units, route the commit control signals
-  if (failed(routeCommitControl()))
-    return signalPassFailure();
+    if (!point.placements.getPlacements<SpecSaveCommitOp>().empty()) {
+      if (failed(placeSaveCommits(point)))
+        return signalPassFailure();
+    }
+
+    // Place Commit operations
+    if (failed(placeCommits(point)))
+      return signalPassFailure();
+
+    // After placing all speculative units, route the commit control signals
+    if (failed(routeCommitControl(point)))
+      return signalPassFailure();
+  }
 
   // After placement and routing, add the spec tag to operands/results in the
-  // speculative region. Skipping this update would lead to a type verification
-  // error, as type-checking happens after the pass.
-  if (failed(addSpecTagToSpecRegion()))
-    return signalPassFailure();
+  // speculative regions. Skipping this update would lead to a type
+  // verification error, as type-checking happens after the pass.
+  for (SpeculationPoint &point : points) {
+    if (failed(addSpecTagToSpecRegion(point)))
+      return signalPassFailure();
+  }
 
-  // Finally, add NonSpecOps to the non-speculative edges of MuxOp/CMergeOp
-  // to satisfy their type requirements.
-  if (failed(addNonSpecOp()))
-    return signalPassFailure();
+  for (FuncOp funcOp : funcOps) {
+    // Add NonSpecOps to the non-speculative edges of MuxOp/CMergeOp to satisfy
+    // their type requirements.
+    if (failed(addNonSpecOp(funcOp)))
+      return signalPassFailure();
+
+    // Finally, make sure that the speculative units form a consistent structure
+    if (failed(verifySpeculativeUnits(funcOp)))
+      return signalPassFailure();
+  }
 
   // Name any ops created by this pass; subsequent passes assume every op has
   // a unique name.
@@ -28,8 +28,9 @@ using namespace dynamatic;
 using namespace dynamatic::handshake;
 using namespace dynamatic::experimental;
 
-PlacementFinder::PlacementFinder(SpeculationPlacements &placements)
-    : placements(placements) {
+PlacementFinder::PlacementFinder(SpeculationPlacements &placements,
+                                 const llvm::DenseSet<unsigned> &otherSpecBBs)
+    : placements(placements), otherSpecBBs(otherSpecBBs) {
   OpOperand &specPos = placements.getSpeculatorPlacement();
   assert(specPos.getOwner() && "Speculator position is undefined");
 }
@@ -155,6 +156,13 @@ getSpecRegionTraversalTargets(Operation *op) {
   return targets;
 }
 
+/// Returns whether the load sends its requests to an LSQ.
+static bool isLoadToLSQ(handshake::LoadOp loadOp) {
+  return llvm::any_of(loadOp.getAddressResult().getUsers(), [](Operation *op) {
+    return isa<handshake::LSQOp>(op);
+  });
+}
+
 LogicalResult PlacementFinder::findRegularCommitsTraversal(
     llvm::DenseSet<Operation *> &visited, OpOperand &currOpOperand) {
   Operation *currOp = currOpOperand.getOwner();
@@ -168,13 +176,32 @@ LogicalResult PlacementFinder::findRegularCommitsTraversal(
 
   if (isa<handshake::StoreOp>(currOp) ||
       isa<handshake::MemoryControllerOp>(currOp) ||
-      isa<handshake::EndOp>(currOp)) {
+      isa<handshake::LSQOp>(currOp) || isa<handshake::EndOp>(currOp)) {
     // A Commit is needed in front of these units
     placements.addCommit(currOpOperand);
     // Stop traversal.
     return success();
   }
 
+  // An LSQ matches load requests with the group allocations it receives from
+  // the control network, which are committed above. A load request from an
+  // iteration that is later squashed would never be matched with a group and
+  // stall the LSQ, so the load address must be committed as well
+  if (auto loadOp = dyn_cast<handshake::LoadOp>(currOp)) {
+    if (isLoadToLSQ(loadOp)) {
+      placements.addCommit(currOpOperand);
+      return success();
+    }
+  }
+
+  // Speculative tokens must be committed before entering the BB of another
+  // speculator, whose speculative region must not overlap with this one
+  if (std::optional<unsigned> bb = getLogicBB(currOp);
+      bb && otherSpecBBs.contains(*bb)) {
+    placements.addCommit(currOpOperand);
+    return success();
+  }
+
   auto [_, isNewOp] = visited.insert(currOp);
 
   // End traversal if currOp is already in visited set
@@ -100,8 +100,9 @@ void SpeculationPlacements::setSaveCommitsFifoDepth(unsigned int depth) {
 }
 
 LogicalResult
-SpeculationPlacements::readFromAttribute(mlir::ModuleOp modOp,
-                                         SpeculationPlacements &placements) {
+SpeculationPlacements::readFromAttributes(
+    mlir::ModuleOp modOp,
+    SmallVectorImpl<SpeculationPlacements> &allPlacements) {
   // small vector to store
   // the ops with a speculation attribute
   llvm::SmallVector<mlir::Operation *, 2> speculateOnOps;
@@ -119,16 +120,17 @@ SpeculationPlacements::readFromAttribute(mlir::ModuleOp modOp,
     return failure();
   }
 
-  // if more than one op found, speculation pass fails
-  if (speculateOnOps.size() > 1) {
-    modOp.emitError() << "more than one op carries the `dynamatic.speculate` "
-                         "attribute; only one speculator is supported";
-    return failure();
+  // each op carrying the attribute is an independent speculation point
+  for (mlir::Operation *producer : speculateOnOps) {
+    if (failed(readFromAttribute(producer, allPlacements.emplace_back())))
+      return failure();
   }
+  return success();
+}
 
-  // get the op to speculate on
-  mlir::Operation *producer = speculateOnOps.front();
-
+LogicalResult
+SpeculationPlacements::readFromAttribute(mlir::Operation *producer,
+                                         SpeculationPlacements &placements) {
   // get the dictionary attribute
   // with the options of how to speculate
   auto dictAttr =
@@ -0,0 +1,65 @@
+// RUN: dynamatic-opt --exp-test-speculative-units %s --split-input-file --verify-diagnostics
+
+handshake.func @commitOutsideRegion(%in: !handshake.channel<i32, [spec: i1]>, %other: !handshake.channel<i32, [spec: i1]>, %start: !handshake.control<>) {
+  %out, %issue, %history, %commit = speculator[%start] %in {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %commitCtrl:2 = fork [2] %commit : <i1>
+  %res = spec_commit[%commitCtrl#0] %out : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  // expected-error @below {{commit is not reachable from any speculative region}}
+  %otherRes = spec_commit[%commitCtrl#1] %other : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  end
+}
+
+// -----
+
+handshake.func @commitNotControlledBySpeculator(%in: !handshake.channel<i32, [spec: i1]>, %ctrl: !handshake.channel<i1>, %start: !handshake.control<>) {
+  %out, %issue, %history, %commit = speculator[%start] %in {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  // expected-error @below {{commit control does not originate from a speculator's commit control output}}
+  %res = spec_commit[%ctrl] %out : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  end
+}
+
+// -----
+
+handshake.func @commitControlledByOtherSpeculator(%in0: !handshake.channel<i32, [spec: i1]>, %in1: !handshake.channel<i32, [spec: i1]>, %start: !handshake.control<>) {
+  %startCopies:2 = fork [2] %start : <>
+  %out0, %issue0, %history0, %commit0 = speculator[%startCopies#0] %in0 {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %out1, %issue1, %history1, %commit1 = speculator[%startCopies#1] %in1 {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  // expected-error @below {{commit is controlled by a different speculator than the one whose speculative region it delimits}}
+  %res0 = spec_commit[%commit1] %out0 : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  %res1 = spec_commit[%commit0] %out1 : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  end
+}
+
+// -----
+
+handshake.func @commitSharedBySpeculators(%in0: !handshake.channel<i32, [spec: i1]>, %in1: !handshake.channel<i32, [spec: i1]>, %start: !handshake.control<>) {
+  %startCopies:2 = fork [2] %start : <>
+  %out0, %issue0, %history0, %commit0 = speculator[%startCopies#0] %in0 {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %out1, %issue1, %history1, %commit1 = speculator[%startCopies#1] %in1 {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %sum = addi %out0, %out1 : <i32, [spec: i1]>
+  // expected-error @below {{commit delimits the speculative regions of multiple speculators}}
+  %res = spec_commit[%commit0] %sum : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  end
+}
+
+// -----
+
+handshake.func @nestedSpeculators(%in: !handshake.channel<i32, [spec: i1]>, %start: !handshake.control<>) {
+  %startCopies:2 = fork [2] %start : <>
+  %out0, %issue0, %history0, %commit0 = speculator[%startCopies#0] %in {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  // expected-error @below {{unit of another speculator is reachable from the speculative region without crossing a commit}}
+  %out1, %issue1, %history1, %commit1 = speculator[%startCopies#1] %out0 {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %res = spec_commit[%commit1] %out1 : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  end
+}
+
+// -----
+
+handshake.func @saveCommitWithForeignHistory(%in: !handshake.channel<i32, [spec: i1]>, %history: !handshake.channel<i2>, %start: !handshake.control<>) {
+  %out, %issue, %specHistory, %commit = speculator[%start] %in {fifoDepth = 16 : ui32} : <>, <i32, [spec: i1]>, <i32, [spec: i1]>, <i2>, <i2>, <i1>
+  %outCopies:2 = fork [2] %out : <i32, [spec: i1]>
+  %res = spec_commit[%commit] %outCopies#0 : !handshake.channel<i32, [spec: i1]>, !handshake.channel<i32>, <i1>
+  // expected-error @below {{save-commit must be controlled by the issue and history control outputs of a single speculator}}
+  %saved = spec_save_commit[%issue, %history] %outCopies#1 {fifoDepth = 16 : ui32} : !handshake.channel<i32, [spec: i1]>, <i2>, <i2>
+  end
+}
@@ -0,0 +1,57 @@
+//===- TestSpeculativeUnits.cpp - Speculative units tests -------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Test pass for the verification of speculative units. Run with
+// --exp-test-speculative-units.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+#include "experimental/Transforms/Speculation/HandshakeSpeculation.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+using namespace dynamatic;
+
+namespace {
+
+struct TestSpeculativeUnits
+    : public PassWrapper<TestSpeculativeUnits, OperationPass<mlir::ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestSpeculativeUnits)
+  using Base = PassWrapper<TestSpeculativeUnits, OperationPass<mlir::ModuleOp>>;
+
+  TestSpeculativeUnits() : Base() {};
+  TestSpeculativeUnits(const TestSpeculativeUnits &other) = default;
+
+  StringRef getArgument() const final { return "exp-test-speculative-units"; }
+
+  StringRef getDescription() const final {
+    return "Verify the structure of the speculative units of each Handshake "
+           "function";
+  }
+
+  void runOnOperation() override {
+    for (auto funcOp : getOperation().getOps<handshake::FuncOp>()) {
+      if (failed(experimental::verifySpeculativeUnits(funcOp)))
+        signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+namespace dynamatic {
+namespace experimental {
+namespace test {
+void registerTestSpeculativeUnits() {
+  PassRegistration<TestSpeculativeUnits>();
+}
+} // namespace test
+} // namespace experimental
+} // namespace dynamatic
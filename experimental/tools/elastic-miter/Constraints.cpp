@@ -1,5 +1,6 @@
 #include <cstddef>
 #include <regex>
+#include <sstream>
 #include <string>
 
 #include "llvm/Support/raw_ostream.h"
@@ -265,4 +266,32 @@ std::string TokenLimitConstraint::createSmvConstraint(
 
   return tokenLimitConstraint.str();
 }
+
+// Create the constraints to fix the tokens of a sequence generator.
+std::string InputSequenceConstraint::createSmvConstraint(
+    const std::string &moduleName,
+    const dynamatic::experimental::ElasticMiterConfig &config) const {
+
+  std::ostringstream inputSequenceConstraint;
+  std::string seqGeneratorName = "seq_generator_" + argumentName;
+
+  // The sequence generator creates exactly as many tokens as in the sequence.
+  // Example:
+  // INVAR seq_generator_D.exact_tokens = 3;
+  inputSequenceConstraint << "INVAR " << seqGeneratorName
+                          << ".exact_tokens = " << tokens.size() << ";\n";
+
+  // The value of each token is fixed by the number of tokens generated before.
+  // Example:
+  // INVAR seq_generator_D.counter = 0 -> seq_generator_D.outs = TRUE;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    inputSequenceConstraint << "INVAR " << seqGeneratorName << ".counter = " << i
+                            << " -> " << seqGeneratorName
+                            << ".outs = " << (tokens[i] ? "TRUE" : "FALSE")
+                            << ";\n";
+  }
+  inputSequenceConstraint << "\n";
+
+  return inputSequenceConstraint.str();
+}
 } // namespace dynamatic::experimental
@@ -4,6 +4,7 @@
 #include "FabricGeneration.h"
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace dynamatic::experimental {
 
@@ -90,6 +91,23 @@ public:
     return LoopConstraint::createConstraintString(moduleName, config, true);
   };
 };
+
+// A class to describe an input sequence constraint. The input with the name
+// argumentName produces exactly the given sequence of tokens. This is used to
+// replay the input sequence of a counterexample.
+class InputSequenceConstraint : public ElasticMiterConstraint {
+public:
+  InputSequenceConstraint(const std::string &argumentName,
+                          const std::vector<bool> &tokens)
+      : argumentName(argumentName), tokens(tokens) {};
+  std::string createSmvConstraint(
+      const std::string &moduleName,
+      const dynamatic::experimental::ElasticMiterConfig &config) const override;
+
+private:
+  std::string argumentName;
+  std::vector<bool> tokens;
+};
 } // namespace dynamatic::experimental
 
 #endif // DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_CONSTRAINTS_H
@@ -0,0 +1,117 @@
+//===- Counterexample.cpp --------------------------------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "Counterexample.h"
+
+using namespace mlir;
+using namespace llvm;
+
+namespace dynamatic::experimental {
+
+// Returns the integer value of the variable at the step of the trace.
+static std::optional<unsigned> getIntValue(const SmvTrace &trace, unsigned step,
+                                           const std::string &var) {
+  std::optional<StringRef> value = trace.getValue(step, var);
+  unsigned intValue;
+  if (!value || value->trim().getAsInteger(10, intValue))
+    return std::nullopt;
+  return intValue;
+}
+
+FailureOr<InputSequences>
+extractInputSequences(const SmvTrace &trace, const ElasticMiterConfig &config) {
+  InputSequences sequences;
+  unsigned lastStep = trace.size() - 1;
+
+  for (const auto &[argumentName, _] : config.arguments) {
+    std::string seqGeneratorName = "seq_generator_" + argumentName;
+    std::string counterVar = seqGeneratorName + ".counter";
+    std::string tokensVar = seqGeneratorName + ".exact_tokens";
+    std::string outsVar = seqGeneratorName + ".outs";
+
+    std::optional<unsigned> nrOfTokens = getIntValue(trace, 0, tokensVar);
+    if (!nrOfTokens) {
+      llvm::errs() << "Counterexample does not contain the number of tokens of "
+                   << seqGeneratorName << "\n";
+      return failure();
+    }
+
+    // A token is consumed whenever the counter of the sequence generator
+    // increases. Its value is the one of the generator's output just before.
+    std::vector<bool> &tokens = sequences[argumentName];
+    for (unsigned step = 0; step < lastStep; step++) {
+      std::optional<unsigned> counter = getIntValue(trace, step, counterVar);
+      std::optional<unsigned> nextCounter =
+          getIntValue(trace, step + 1, counterVar);
+      if (!counter || !nextCounter || *nextCounter == *counter)
+        continue;
+      tokens.push_back(trace.getValue(step, outsVar) == StringRef("TRUE"));
+    }
+
+    // Complete the sequence with the tokens that were not consumed
+    if (tokens.size() < *nrOfTokens)
+      tokens.push_back(trace.getValue(lastStep, outsVar) == StringRef("TRUE"));
+    tokens.resize(*nrOfTokens, false);
+  }
+  return sequences;
+}
+
+LogicalResult writeInputSequences(const InputSequences &sequences,
+                                  const std::filesystem::path &jsonPath) {
+  json::Object object;
+  for (const auto &[argumentName, tokens] : sequences)
+    object[argumentName] = json::Array(tokens);
+
+  std::error_code ec;
+  raw_fd_ostream jsonFile(jsonPath.string(), ec);
+  if (ec) {
+    llvm::errs() << "Failed to create " << jsonPath << "\n";
+    return failure();
+  }
+  jsonFile << formatv("{0:2}", json::Value(std::move(object))) << "\n";
+  return success();
+}
+
+FailureOr<InputSequences>
+readInputSequences(const std::filesystem::path &jsonPath) {
+  auto fileOrErr = MemoryBuffer::getFile(jsonPath.string());
+  if (std::error_code ec = fileOrErr.getError()) {
+    llvm::errs() << "Failed to open " << jsonPath << ": " << ec.message()
+                 << "\n";
+    return failure();
+  }
+
+  Expected<json::Value> value = json::parse((*fileOrErr)->getBuffer());
+  if (!value) {
+    llvm::errs() << "Failed to parse " << jsonPath << ": "
+                 << toString(value.takeError()) << "\n";
+    return failure();
+  }
+
+  InputSequences sequences;
+  json::Path::Root root;
+  if (!json::fromJSON(*value, sequences, root)) {
+    llvm::errs() << "Expected " << jsonPath
+                 << " to map each input to an array of booleans\n";
+    return failure();
+  }
+  return sequences;
+}
+
+} // namespace dynamatic::experimental
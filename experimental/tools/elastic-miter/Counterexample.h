@@ -0,0 +1,54 @@
+//===- Counterexample.h - Input sequences of counterexamples ----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides a way to extract the concrete input sequences that lead
+// to a non-equivalence from a counterexample trace. The sequences are stored
+// in a JSON file which can be passed back to elastic-miter to replay the
+// counterexample, e.g., as a regression test.
+//
+// The JSON file maps each input of the circuits to its sequence of tokens:
+// { "A": [true, false], "B": [false] }
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_COUNTEREXAMPLE_H
+#define DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_COUNTEREXAMPLE_H
+
+#include "FabricGeneration.h"
+#include "experimental/Support/SmvModel.h"
+#include "mlir/Support/LogicalResult.h"
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace mlir;
+
+namespace dynamatic::experimental {
+
+// The tokens produced at each input of the circuits, in order.
+using InputSequences = std::map<std::string, std::vector<bool>>;
+
+// Extract the tokens produced by each sequence generator of the testbench in
+// the counterexample. Tokens the circuits did not consume before the end of the
+// trace are also part of the sequence: the first one with the value it had at
+// the end of the trace, the following ones with an arbitrary value (false).
+FailureOr<InputSequences>
+extractInputSequences(const SmvTrace &trace, const ElasticMiterConfig &config);
+
+// Write the input sequences to a JSON file.
+LogicalResult writeInputSequences(const InputSequences &sequences,
+                                  const std::filesystem::path &jsonPath);
+
+// Read input sequences from a JSON file.
+FailureOr<InputSequences>
+readInputSequences(const std::filesystem::path &jsonPath);
+
+} // namespace dynamatic::experimental
+
+#endif // DYNAMATIC_EXPERIMENTAL_ELASTIC_MITER_COUNTEREXAMPLE_H
@@ -89,7 +89,9 @@ std::string createElasticMiterTestBench(
     bool generateExactNrOfTokens) {
   std::ostringstream wrapper;
 
-  // replace all arguments' type with boolean
+  // Replace all arguments' type with boolean. The SMV models of the circuits
+  // abstract all data to a single bit, which is sound since circuits are
+  // checked to only compute on single-bit data (see getModuleFuncOpAndCheck)
   SmallVector<std::pair<std::string, Type>> arguments;
   Type i1Type = IntegerType::get(&context, 1);
   for (auto [argName, _] : config.arguments) {
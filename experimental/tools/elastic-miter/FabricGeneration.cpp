@@ -8,6 +8,8 @@
 
 #include "mlir/IR/OperationSupport.h"
 #include "mlir/Parser/Parser.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/FileSystem.h"
 #include <filesystem>
 #include <string>
@@ -141,11 +143,36 @@ buildEmptyMiterFuncOp(OpBuilder builder, FuncOp &lhsFuncOp, FuncOp &rhsFuncOp) {
                                outputTypes, argNamedAttr, resNamedAttr);
 }
 
+// Determines whether the value is a channel carrying more than one bit of data.
+static bool isWideChannel(Value value) {
+  auto channelType = dyn_cast<ChannelType>(value.getType());
+  return channelType && channelType.getDataBitWidth() > 1;
+}
+
+// Determines whether the operation only routes the data of its wide channels
+// without computing on it, so that the behavior of the operation does not
+// depend on that data. Operands and results that steer tokens (e.g., the select
+// operand of a mux) must carry a single bit.
+static bool isDataTransparent(Operation *op) {
+  return llvm::TypeSwitch<Operation *, bool>(op)
+      .Case<MuxOp>(
+          [](MuxOp muxOp) { return !isWideChannel(muxOp.getSelectOperand()); })
+      .Case<ControlMergeOp>([](ControlMergeOp cmergeOp) {
+        return !isWideChannel(cmergeOp.getIndex());
+      })
+      .Case<ForkOp, LazyForkOp, BufferOp, SinkOp, BranchOp,
+            ConditionalBranchOp, MergeOp, EndOp>([](auto) { return true; })
+      .Default([](auto) { return false; });
+}
+
 // Get the first and only non-external FuncOp from the module.
 // Additionally check some properites:
 // 1. The FuncOp is materialized (each Value is only used once).
 // 2. There are no memory interfaces
 // 3. Arguments  and results are all handshake.channel or handshake.control type
+// 4. Operations only compute on single-bit data. The SMV models of the circuits
+// abstract all data to a single bit, which is only sound when data wider than
+// that is merely routed through the circuit.
 FailureOr<FuncOp> getModuleFuncOpAndCheck(ModuleOp module) {
   // We only support one function per module
   FuncOp funcOp = nullptr;
@@ -192,6 +219,22 @@ FailureOr<FuncOp> getModuleFuncOpAndCheck(ModuleOp module) {
         << "There can be no Memory Interfaces as they are not elastic.";
     return failure();
   }
+
+  // Check that wide data is only routed through the circuit
+  for (Operation &op : funcOp.getOps()) {
+    auto isWide = [](Value value) { return isWideChannel(value); };
+    if ((llvm::any_of(op.getOperands(), isWide) ||
+         llvm::any_of(op.getResults(), isWide)) &&
+        !isDataTransparent(&op)) {
+      llvm::errs() << "Operation " << getUniqueName(&op) << " ("
+                   << op.getName()
+                   << ") computes on data wider than one bit. The "
+                      "equivalence check abstracts all data to a single bit, "
+                      "so it only supports circuits that route wider data "
+                      "without computing on it.\n";
+      return failure();
+    }
+  }
   return funcOp;
 }
 
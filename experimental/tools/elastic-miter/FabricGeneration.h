@@ -67,6 +67,7 @@ buildEmptyMiterFuncOp(OpBuilder builder, FuncOp &lhsFuncOp, FuncOp &rhsFuncOp);
 // 1. The FuncOp is materialized (each Value is only used once).
 // 2. There are no memory interfaces
 // 3. Arguments  and results are all handshake.channel or handshake.control type
+// 4. Operations only compute on single-bit data, wider data is only routed
 FailureOr<FuncOp> getModuleFuncOpAndCheck(ModuleOp module);
 
 LogicalResult createMlirFile(const std::filesystem::path &mlirPath,
@@ -17,13 +17,16 @@
 #include "llvm/Support/CommandLine.h"
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <string>
 
 #include "dynamatic/InitAllDialects.h"
+#include "experimental/Support/SmvModel.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "Constraints.h"
+#include "Counterexample.h"
 #include "ElasticMiterTestbench.h"
 #include "FabricGeneration.h"
 #include "GetSequenceLength.h"
@@ -109,6 +112,28 @@ static cl::opt<bool>
                                    "files in the output directory."),
                           cl::init(false), cl::cat(generalCategory));
 
+// Bound the number of tokens produced at each input. Instead of emulating an
+// infinite number of input tokens (whose required number is determined by a
+// reachability analysis of both circuits), the circuits are only compared on
+// all input sequences of up to this many tokens.
+static cl::opt<unsigned> boundArg(
+    "bound", cl::Prefix,
+    cl::desc("Only check equivalence for input sequences of at most this many "
+             "tokens (at most 31). By default, equivalence is checked for "
+             "sequences of any length."),
+    cl::init(0), cl::cat(generalCategory));
+
+// Replay a counterexample. The JSON file maps each input to the sequence of
+// tokens it produces, as written to counterexample.json when --cex is set.
+static cl::opt<std::string> inputsArg(
+    "inputs", cl::Prefix,
+    cl::desc("Only check equivalence for the input sequences in the JSON "
+             "file (e.g., the counterexample.json of a previous run)."),
+    cl::init(""), cl::cat(generalCategory));
+
+/// Maximal number of tokens a sequence generator of the testbench can produce.
+static constexpr unsigned MAX_NR_OF_TOKENS = 31;
+
 static FailureOr<SmallVector<dynamatic::experimental::ElasticMiterConstraint *>>
 parseSequenceConstraints() {
 
@@ -158,22 +183,27 @@ static FailureOr<bool> checkEquivalence(
     const std::filesystem::path &rhsPath,
     const std::filesystem::path &outputDir,
     const SmallVector<dynamatic::experimental::ElasticMiterConstraint *>
-        &constraints) {
-
-  // Find out needed number of tokens for the LHS
-  auto failOrLHSseqLen = dynamatic::experimental::getSequenceLength(
-      context, outputDir / "lhs_reachability", lhsPath);
-  if (failed(failOrLHSseqLen))
-    return failure();
-
-  // Find out needed number of tokens for the RHS
-  auto failOrRHSseqLen = dynamatic::experimental::getSequenceLength(
-      context, outputDir / "rhs_reachability", rhsPath);
-  if (failed(failOrRHSseqLen))
-    return failure();
-
-  size_t nrOfTokens =
-      std::max(failOrLHSseqLen.value(), failOrRHSseqLen.value());
+        &constraints,
+    std::optional<size_t> bound) {
+
+  size_t nrOfTokens;
+  if (bound) {
+    nrOfTokens = *bound;
+  } else {
+    // Find out needed number of tokens for the LHS
+    auto failOrLHSseqLen = dynamatic::experimental::getSequenceLength(
+        context, outputDir / "lhs_reachability", lhsPath);
+    if (failed(failOrLHSseqLen))
+      return failure();
+
+    // Find out needed number of tokens for the RHS
+    auto failOrRHSseqLen = dynamatic::experimental::getSequenceLength(
+        context, outputDir / "rhs_reachability", rhsPath);
+    if (failed(failOrRHSseqLen))
+      return failure();
+
+    nrOfTokens = std::max(failOrLHSseqLen.value(), failOrRHSseqLen.value());
+  }
 
   std::filesystem::path miterDir = outputDir / "miter";
   // Create the miterDir if it doesn't exist
@@ -232,6 +262,40 @@ static FailureOr<bool> checkEquivalence(
     }
   }
   result.close();
+
+  // Summarize the first counterexample as the sequence of signal changes that
+  // lead to the property violation
+  if (!isEquivalent && enableCounterExamples) {
+    using dynamatic::experimental::SmvTrace;
+    FailureOr<SmvTrace> failOrTrace =
+        SmvTrace::parseFromFile(miterDir / "trace.xml");
+    if (failed(failOrTrace))
+      return failure();
+    std::error_code ec;
+    std::filesystem::path tracePath = miterDir / "trace.txt";
+    llvm::raw_fd_ostream traceFile(tracePath.string(), ec);
+    if (ec) {
+      llvm::errs() << "Failed to create " << tracePath << "\n";
+      return failure();
+    }
+    failOrTrace->print(traceFile);
+    llvm::outs() << "Counterexample of " << failOrTrace->size()
+                 << " steps written to " << tracePath << "\n";
+
+    // Extract the input sequences of the counterexample, so that it can be
+    // replayed with --inputs
+    auto failOrSequences =
+        dynamatic::experimental::extractInputSequences(*failOrTrace, config);
+    if (failed(failOrSequences))
+      return failure();
+    std::filesystem::path sequencesPath = outputDir / "counterexample.json";
+    if (failed(dynamatic::experimental::writeInputSequences(*failOrSequences,
+                                                            sequencesPath)))
+      return failure();
+    llvm::outs() << "Counterexample input sequences written to "
+                 << sequencesPath << " (replay with --inputs="
+                 << sequencesPath.string() << ")\n";
+  }
   return isEquivalent;
 }
 
@@ -269,6 +333,37 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  // Replaying input sequences bounds the number of tokens to the length of the
+  // longest sequence
+  std::optional<size_t> bound;
+  if (boundArg.getNumOccurrences()) {
+    if (boundArg == 0 || boundArg > MAX_NR_OF_TOKENS) {
+      llvm::errs() << "The bound must be between 1 and " << MAX_NR_OF_TOKENS
+                   << "\n";
+      return 1;
+    }
+    bound = boundArg;
+  }
+  if (!inputsArg.empty()) {
+    auto failOrSequences =
+        dynamatic::experimental::readInputSequences(inputsArg.getValue());
+    if (failed(failOrSequences))
+      return 1;
+    size_t longest = 1;
+    for (const auto &[argumentName, tokens] : *failOrSequences) {
+      if (tokens.size() > MAX_NR_OF_TOKENS) {
+        llvm::errs() << "Input " << argumentName << " has more than "
+                     << MAX_NR_OF_TOKENS << " tokens\n";
+        return 1;
+      }
+      longest = std::max(longest, tokens.size());
+      failOrSequenceConstraints->push_back(
+          new dynamatic::experimental::InputSequenceConstraint(argumentName,
+                                                               tokens));
+    }
+    bound = std::max(bound.value_or(0), longest);
+  }
+
   std::filesystem::path lhsPath = lhsFilenameArg.getValue();
   std::filesystem::path rhsPath = rhsFilenameArg.getValue();
   std::filesystem::path outputDir = outputDirArg.getValue();
@@ -276,8 +371,9 @@ int main(int argc, char **argv) {
   // Create the outputDir if it doesn't exist
   std::filesystem::create_directories(outputDir);
 
-  auto failOrEquivalent = checkEquivalence(context, lhsPath, rhsPath, outputDir,
-                                           failOrSequenceConstraints.value());
+  auto failOrEquivalent =
+      checkEquivalence(context, lhsPath, rhsPath, outputDir,
+                       failOrSequenceConstraints.value(), bound);
   if (failed(failOrEquivalent)) {
     llvm::errs() << "Equivalence checking failed.\n";
     return 1;
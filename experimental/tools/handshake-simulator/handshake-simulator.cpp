@@ -1,3 +1,4 @@
+#include "dynamatic/Analysis/TokenLineage.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/LLVM.h"
 #include "dynamatic/Transforms/HandshakeMaterialize.h"
@@ -32,6 +33,12 @@ static cl::opt<std::string> inputFilename(cl::Positional, cl::Required,
 static cl::list<std::string> inputArgs(cl::Positional, cl::desc("<input args>"),
                                        cl::ZeroOrMore, cl::cat(mainCategory));
 
+static cl::opt<std::string>
+    lineageFile("lineage", cl::Optional,
+                cl::desc("Path to a CSV file in which to write the lineage "
+                         "of all tokens transferred during simulation"),
+                cl::init(""), cl::cat(mainCategory));
+
 using namespace dynamatic::experimental;
 
 int main(int argc, char **argv) {
@@ -60,7 +67,21 @@ int main(int argc, char **argv) {
   handshake::FuncOp funcOp = *modOp->getOps<handshake::FuncOp>().begin();
 
   Simulator sim(funcOp);
+  TokenLineageRecorder lineage(funcOp);
+  if (!lineageFile.empty())
+    sim.setLineageRecorder(&lineage);
 
   sim.simulate(inputArgs);
   sim.printResults();
+
+  if (!lineageFile.empty()) {
+    std::error_code ec;
+    llvm::raw_fd_ostream lineageStream(lineageFile, ec);
+    if (ec) {
+      llvm::errs() << "Failed to open lineage file @ \"" << lineageFile
+                   << "\": " << ec.message() << "\n";
+      return 1;
+    }
+    lineage.write(lineageStream);
+  }
 }
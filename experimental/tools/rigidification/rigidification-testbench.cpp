@@ -20,7 +20,6 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/CommandLine.h"
 #include <filesystem>
-#include <fstream>
 #include <string>
 
 #include "dynamatic/InitAllDialects.h"
@@ -104,11 +103,10 @@ integration-tests/fir/out/hdl/ --mlir intregation-tests/fir/out/comp/hw.mlir/n)D
         .syncOutput = true,
         .deadBufferOutput = true};
 
-    std::string wrapper =
-        dynamatic::experimental::createSmvFormalTestbench(smvConfig);
-    std::ofstream mainFile(wrapperPath);
-    mainFile << wrapper;
-    mainFile.close();
+    dynamatic::experimental::SmvModel wrapper =
+        dynamatic::experimental::createSmvFormalTestbenchModel(smvConfig);
+    if (failed(wrapper.writeToFile(wrapperPath)))
+      return 1;
   }
 
   exit(false);
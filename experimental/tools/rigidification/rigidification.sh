@@ -103,13 +103,14 @@ exit_on_fail "Failed to generate property DB" \
 exit_on_fail "Failed to lower to HW" \
   "Lowered to HW"
 
-# generate SMV
+# generate SMV, reduced to the exact cone of influence of the properties
 "$DYNAMATIC_EXPORT_RTL_BIN" \
   "$F_FORMAL_HW" \
   "$MODEL_DIR" \
   "$RTL_CONFIG_SMV" \
   --hdl smv \
   --property-database "$F_FORMAL_PROP" \
+  --smv-coi \
   $SMV_GENERATION_FLAGS \
   --dynamatic-path "$DYNAMATIC_DIR"
 exit_on_fail "Failed to generate SMV model" \
@@ -0,0 +1,86 @@
+//===- ChannelRangeAnalysis.h - Value ranges of Handshake channels -*- C++ -*-//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Interval analysis over integer-typed Handshake channels. Ranges are computed
+// with a classical abstract interpretation fixpoint over the (cyclic) dataflow
+// graph of each Handshake function: an ascending phase that widens ranges
+// flowing through merge-like operations (i.e., loop headers) to guarantee
+// termination, followed by a descending phase that recovers bounds implied by
+// comparisons guarding conditional branches (e.g., loop exit conditions).
+//
+// Ranges are represented as `llvm::ConstantRange`s, whose arithmetic follows
+// the wrapping semantics of hardware integers. As a result, every range
+// returned by the analysis is sound regardless of overflows in the circuit.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_ANALYSIS_CHANNELRANGEANALYSIS_H
+#define DYNAMATIC_ANALYSIS_CHANNELRANGEANALYSIS_H
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+#include "llvm/IR/ConstantRange.h"
+
+namespace dynamatic {
+
+/// Computes the range of values that every integer-typed channel (i.e., a
+/// value of type `handshake::ChannelType` whose data type is an integer) may
+/// carry inside a Handshake function. The analysis is conservative: a value
+/// is guaranteed to always belong to its range, which is the full set when
+/// nothing could be proven. In particular, all integer results of operations
+/// without a transfer function (e.g., loaded data) have the full range. The
+/// empty range only denotes values that were not visited yet while the
+/// analysis runs.
+class ChannelRangeAnalysis {
+public:
+  /// Number of times the range of a merge-like operation's result can grow
+  /// before it is widened.
+  static constexpr unsigned WIDENING_DELAY = 3;
+  /// Number of descending iterations performed after the ascending phase.
+  static constexpr unsigned NARROWING_ITERATIONS = 3;
+
+  /// Runs the analysis on the Handshake function.
+  ChannelRangeAnalysis(handshake::FuncOp funcOp);
+
+  /// Returns the range of the integer-typed channel. Returns a full range for
+  /// values the analysis knows nothing about. Asserts if the value is not an
+  /// integer-typed channel.
+  llvm::ConstantRange getRange(Value val) const;
+
+  /// Returns the minimum number of bits needed to represent every value in
+  /// the channel's range, as well as whether the value must be sign-extended
+  /// (true) or zero-extended (false) to recover its original width.
+  std::pair<unsigned, bool> getRequiredWidth(Value val) const;
+
+private:
+  /// Ranges computed so far, indexed by channel.
+  DenseMap<Value, llvm::ConstantRange> ranges;
+  /// Number of times the range of each merge-like result grew.
+  DenseMap<Value, unsigned> growthCount;
+
+  /// Evaluates the transfer function of the operation and stores the results'
+  /// new ranges in the map. During the ascending phase, new ranges are joined
+  /// with old ones (and widened when appropriate); during the descending
+  /// phase, they replace old ones. Returns whether any result range changed.
+  bool visit(Operation *op, bool ascending);
+
+  /// Updates the range of the result with a newly computed range. Returns
+  /// whether the stored range changed.
+  bool update(Value res, const llvm::ConstantRange &newRange, bool ascending,
+              bool widen);
+
+  /// Refines the range of the conditional branch's data operand using the
+  /// comparison computing its condition, if any. `onTrue` indicates which
+  /// branch result to compute the range of.
+  llvm::ConstantRange refineFromCondition(handshake::ConditionalBranchOp condOp,
+                                          bool onTrue) const;
+};
+
+} // namespace dynamatic
+
+#endif // DYNAMATIC_ANALYSIS_CHANNELRANGEANALYSIS_H
@@ -0,0 +1,181 @@
+//===- TokenLineage.h - Provenance of tokens in execution traces -*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Per-token provenance over execution traces of Handshake functions. A
+// recorder collects the cycles at which tokens are transferred on each channel
+// (e.g., from a simulation or from an RTL waveform) and infers, for each token,
+// the tokens its producer consumed to produce it. The resulting lineage is
+// stored in a CSV file which can then be loaded to answer backward-slice
+// ("where did this token come from") and forward-slice ("what did this token
+// affect") queries.
+//
+// Traces only contain handshake signals, so parents are inferred from the
+// semantics of each operation rather than observed:
+// - most operations consume one token on each input to produce one token on
+//   each output, in order, so the k-th token on an output comes from the k-th
+//   token on each input;
+// - merge-like operations consume their data inputs in arrival order, so the
+//   k-th token on an output comes from the k-th data token to arrive (and from
+//   the k-th token on other inputs, like a mux's select);
+// - conditional branches steer each input token to exactly one output, so
+//   tokens on both outputs are numbered together;
+// - memory interfaces reorder requests, so their output tokens come from the
+//   last token transferred on each input at or before the same cycle.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_ANALYSIS_TOKENLINEAGE_H
+#define DYNAMATIC_ANALYSIS_TOKENLINEAGE_H
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringMap.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dynamatic {
+
+/// Endpoints of a Handshake channel, named as in the CSV traces consumed by
+/// the visualizer and in DOTs produced by `export-dot`.
+struct ChannelEndpoints {
+  /// Name of the producer (operation or function argument).
+  std::string srcComponent;
+  /// Index of the channel among the producer's outputs.
+  unsigned srcPort = 0;
+  /// Name of the consumer (operation or function result).
+  std::string dstComponent;
+  /// Index of the channel among the consumer's inputs.
+  unsigned dstPort = 0;
+
+  /// Derives the endpoints of a channel inside a Handshake function whose
+  /// operations are all named. The channel must have exactly one use.
+  ChannelEndpoints(Value channel);
+
+  ChannelEndpoints() = default;
+};
+
+/// Records token transfers on the channels of a Handshake function and writes
+/// the inferred lineage of all tokens to a CSV file, made up of one line per
+/// token:
+///
+/// id, cycle, src_component, src_port, dst_component, dst_port, seq, data,
+/// parents
+///
+/// where `seq` is the index of the token among all tokens transferred on the
+/// same channel and `parents` is a space-separated list of token IDs. Token IDs
+/// are assigned in order of transfer.
+class TokenLineageRecorder {
+public:
+  /// Creates a recorder for the Handshake function, whose operations must all
+  /// be named.
+  TokenLineageRecorder(handshake::FuncOp funcOp) : funcOp(funcOp) {}
+
+  /// Records that a token carrying the (optional) data was transferred on the
+  /// channel at the cycle. Transfers on the same channel must be recorded in
+  /// order.
+  void recordTransfer(Value channel, unsigned cycle, StringRef data = {});
+
+  /// Infers the parents of all recorded tokens and writes the lineage in CSV
+  /// format to the output stream.
+  void write(raw_ostream &os) const;
+
+private:
+  /// A token transferred on a channel.
+  struct Transfer {
+    /// Cycle at which the transfer happened.
+    unsigned cycle;
+    /// Data carried by the token.
+    std::string data;
+  };
+
+  /// The function whose channels are recorded.
+  handshake::FuncOp funcOp;
+  /// Transfers recorded on each channel, in order.
+  llvm::MapVector<Value, std::vector<Transfer>> transfers;
+
+  /// Returns the transfers recorded on the channel (potentially none).
+  ArrayRef<Transfer> getTransfers(Value channel) const;
+
+  /// Infers, for each token produced by the operation on its results, the
+  /// consumed tokens it originates from. Tokens are identified by their
+  /// channel and sequence number.
+  void inferParents(
+      Operation *op,
+      DenseMap<std::pair<Value, unsigned>,
+               SmallVector<std::pair<Value, unsigned>>> &parents) const;
+};
+
+/// Token lineage loaded from a CSV file produced by a `TokenLineageRecorder`,
+/// which answers slicing queries.
+class TokenLineage {
+public:
+  /// A token in the lineage.
+  struct Token {
+    /// Unique identifier.
+    unsigned id;
+    /// Cycle at which the token was transferred.
+    unsigned cycle;
+    /// Channel the token was transferred on.
+    ChannelEndpoints channel;
+    /// Index of the token among all tokens transferred on the same channel.
+    unsigned seq;
+    /// Data carried by the token (empty for dataless channels).
+    std::string data;
+    /// Tokens consumed to produce this one.
+    SmallVector<unsigned> parents;
+    /// Tokens produced by consuming this one.
+    SmallVector<unsigned> children;
+  };
+
+  /// Direction of a slice.
+  enum class Direction {
+    /// Tokens the sliced token originates from.
+    BACKWARD,
+    /// Tokens the sliced token contributed to.
+    FORWARD
+  };
+
+  /// A token in a slice, along with its distance (in number of operations
+  /// traversed) to the sliced token.
+  using SliceEntry = std::pair<const Token *, unsigned>;
+
+  /// Parses the lineage from a CSV file. Fails and prints an error to stderr
+  /// if the file cannot be read or is malformed.
+  LogicalResult parseFromFile(StringRef filepath);
+
+  /// Returns all tokens, ordered by ID.
+  ArrayRef<Token> getTokens() const { return tokens; }
+
+  /// Returns the token with the ID, or `nullptr` if it does not exist.
+  const Token *getToken(unsigned id) const;
+
+  /// Returns the token with the sequence number on the channel identified by
+  /// its producer's name and output index, or `nullptr` if it does not exist.
+  const Token *getToken(StringRef srcComponent, unsigned srcPort,
+                        unsigned seq) const;
+
+  /// Returns the slice of the token in the direction, in breadth-first order
+  /// starting with the token itself. Tokens more than `maxDepth` operations
+  /// away from the sliced token are omitted when a maximum depth is provided.
+  std::vector<SliceEntry>
+  getSlice(const Token &token, Direction direction,
+           std::optional<unsigned> maxDepth = std::nullopt) const;
+
+private:
+  /// All tokens, indexed by ID.
+  std::vector<Token> tokens;
+  /// Maps channels (identified by "<producer>:<output index>") to the IDs of
+  /// the tokens transferred on them, in order.
+  llvm::StringMap<SmallVector<unsigned>> tokensByChannel;
+};
+
+} // namespace dynamatic
+
+#endif // DYNAMATIC_ANALYSIS_TOKENLINEAGE_H
@@ -0,0 +1,68 @@
+//===- ClockDomains.h - Clock domains of Handshake functions ----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Helpers to interact with the clock domains of Handshake functions. By
+// default, all operations of a Handshake function belong to its main clock
+// domain (domain 0). Operations may optionally have a "clock domain" integer
+// attribute placing them in another domain, in which case the function lists
+// the clock period of each of its additional domains, relative to the period
+// of the main clock. Channels between operations of different domains must go
+// through a `handshake::ClockCrossingOp`.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_SUPPORT_CLOCKDOMAINS_H
+#define DYNAMATIC_SUPPORT_CLOCKDOMAINS_H
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+namespace dynamatic {
+
+/// Operation attribute to identify the clock domain the operation belongs to.
+constexpr llvm::StringLiteral CLOCK_DOMAIN_ATTR_NAME("handshake.clock_domain");
+
+/// Function attribute listing the clock period of each of the function's
+/// additional clock domains (starting at domain 1), relative to the period of
+/// the main clock.
+constexpr llvm::StringLiteral CLOCK_RATIOS_ATTR_NAME("handshake.clock_ratios");
+
+/// Returns the clock domain of the operation (0 if the operation has no clock
+/// domain attribute).
+unsigned getClockDomain(Operation *op);
+
+/// Places the operation in a clock domain.
+void setClockDomain(Operation *op, unsigned domain);
+
+/// Returns the clock domain in which the channel transfers tokens, i.e., the
+/// destination domain of the clock domain crossing producing it, if any, and
+/// the domain of its producer otherwise (the main clock domain for function
+/// arguments). Operations inserted on the channel belong to this domain.
+unsigned getChannelClockDomain(Value channel);
+
+/// Returns the clock period of each clock domain of the function, relative to
+/// the period of the main clock. The first element, corresponding to the main
+/// clock domain, is always 1.
+SmallVector<double> getClockPeriodRatios(handshake::FuncOp funcOp);
+
+/// Adds a clock domain to the function whose clock period is the given ratio
+/// of the main clock's period. Returns the new domain's index.
+unsigned addClockDomain(handshake::FuncOp funcOp, double periodRatio);
+
+/// Returns the clock period of the operation's clock domain, relative to the
+/// period of the main clock.
+double getClockPeriodRatio(Operation *op);
+
+/// Returns the name of the clock port of a clock domain in generated circuits.
+std::string getClockPortName(unsigned domain);
+
+} // namespace dynamatic
+
+#endif // DYNAMATIC_SUPPORT_CLOCKDOMAINS_H
@@ -251,6 +251,11 @@ public:
   virtual double getValue(const CPVar &var) const = 0;
   virtual double getObjective() const = 0;
 
+  /// Gives the solver a starting value for the variable, from which it may
+  /// find a first feasible solution faster. Solvers that do not support MIP
+  /// starts ignore the value.
+  virtual void setStartValue(const CPVar &var, double value) {}
+
   virtual void write(llvm::StringRef filePath) const = 0;
 
   virtual void writeSol(llvm::StringRef filePath) const = 0;
@@ -310,6 +315,8 @@ public:
 
   double getObjective() const override;
 
+  void setStartValue(const CPVar &var, double value) override;
+
   // [START LLVM RTTI prerequisites]
   static bool classof(const CPSolver *b) { return b->getKind() == GUROBI; }
   static bool classof(const GurobiSolver *b) { return true; }
@@ -0,0 +1,134 @@
+//===- CostModel.h - Unified cost model for optimization passes -*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Declares the cost model shared by all optimization passes of a compilation.
+// The cost model answers latency, delay, initiation interval, and area queries
+// about Handshake units from a single timing database, which is parsed once per
+// process no matter how many passes query it. Costs of individual units are
+// cached per unit configuration so that passes querying the same kind of unit
+// repeatedly do not walk the timing models every time. The cost model also
+// provides function-level estimates (total area and critical path delay) that
+// let us report the effect of each pass on the circuit.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_SUPPORT_COSTMODEL_H
+#define DYNAMATIC_SUPPORT_COSTMODEL_H
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/LLVM.h"
+#include "dynamatic/Support/TimingModels.h"
+#include "llvm/ADT/StringMap.h"
+#include <mutex>
+#include <optional>
+
+namespace dynamatic {
+
+/// Cost of a single unit in its circuit. All delays are normalized by the clock
+/// period of the unit's clock domain so that they can be compared against the
+/// target period, and the latency is expressed in cycles of the main clock.
+struct UnitCost {
+  /// Latency of the unit's data path. A zero latency means that the unit is
+  /// combinational.
+  double latency = 0.0;
+  /// Combinational data delay through the unit, for combinational units.
+  double delay = 0.0;
+  /// Data delay from the unit's input ports to its first register, for
+  /// sequential units.
+  double inDelay = 0.0;
+  /// Data delay from the unit's last register to its output ports, for
+  /// sequential units.
+  double outDelay = 0.0;
+  /// Delay of the unit's internal pipeline stages, for sequential units.
+  double stageDelay = 0.0;
+  /// Initiation interval of the unit.
+  int64_t ii = 1;
+  /// Area of the unit, in LUTs, if its timing model characterizes it.
+  std::optional<double> area;
+};
+
+/// Function-level cost estimates.
+struct FuncCost {
+  /// Sum of the area of all units whose area is characterized, in LUTs.
+  double area = 0.0;
+  /// Longest combinational path between registers in the function, normalized
+  /// by the clock period of the path's clock domain.
+  double criticalPathDelay = 0.0;
+  /// Number of units in the function.
+  unsigned numUnits = 0;
+  /// Number of units whose area is not characterized by a timing model.
+  unsigned numUncharacterized = 0;
+};
+
+/// Cost model shared by all passes of a compilation that target the same clock
+/// period with the same timing models. Instances are owned by a process-wide
+/// registry and must be obtained through `CostModel::get`.
+class CostModel {
+public:
+  /// Returns the timing database parsed from the JSON file at the given path.
+  /// The file is parsed the first time it is requested and the same database
+  /// is returned to all subsequent callers. Fails if the file cannot be parsed.
+  static FailureOr<const TimingDatabase *>
+  getTimingDatabase(StringRef timingModels);
+
+  /// Returns the cost model for the timing models at the given path and the
+  /// target clock period (in ns). Fails if the timing models cannot be parsed.
+  static FailureOr<CostModel *> get(StringRef timingModels,
+                                    double targetPeriod);
+
+  /// Returns the cost model for the timing database and the target clock
+  /// period (in ns). Passes that were handed an already parsed timing database
+  /// share the cost model of passes that obtained it from the same file.
+  static CostModel &get(const TimingDatabase &timingDB, double targetPeriod);
+
+  /// Returns the area of a single slot of a buffer of the given type on a
+  /// channel of the given bitwidth, if the timing database characterizes it.
+  /// Buffer areas are stored under the `handshake.buffer.<type>` keys.
+  static std::optional<double>
+  getBufferSlotArea(const TimingDatabase &timingDB,
+                    handshake::BufferType bufferType, unsigned bitwidth);
+
+  /// Returns the timing database the cost model is built on.
+  const TimingDatabase &getTimingDB() const { return timingDB; }
+
+  /// Returns the target clock period (in ns).
+  double getTargetPeriod() const { return targetPeriod; }
+
+  /// Returns the cost of the unit. Units without a timing model are considered
+  /// combinational with no delay and no known area. Buffers are costed from
+  /// their type, latency, and number of slots alone.
+  UnitCost getUnitCost(Operation *op);
+
+  /// Estimates the cost of the entire function. Combinational cycles (which
+  /// exist in circuits before buffer placement) are cut at an arbitrary point
+  /// so the critical path is an underestimation for such circuits.
+  FuncCost getFuncCost(handshake::FuncOp funcOp);
+
+private:
+  /// Timing database the cost model is built on.
+  const TimingDatabase &timingDB;
+  /// Target clock period (in ns).
+  double targetPeriod;
+  /// Costs of all unit configurations queried so far, mapped from a key
+  /// uniquely identifying the configuration.
+  llvm::StringMap<UnitCost> unitCosts;
+  /// Protects the cache, which may be accessed from multiple threads when
+  /// function passes run in parallel.
+  std::mutex cacheMutex;
+
+  /// Private constructor, instances are obtained with `CostModel::get`.
+  CostModel(const TimingDatabase &timingDB, double targetPeriod)
+      : timingDB(timingDB), targetPeriod(targetPeriod) {}
+
+  /// Computes the cost of a unit described by its timing model.
+  UnitCost computeUnitCost(Operation *op, const TimingModel &model);
+};
+
+} // namespace dynamatic
+
+#endif // DYNAMATIC_SUPPORT_COSTMODEL_H
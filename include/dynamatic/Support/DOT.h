@@ -36,7 +36,11 @@ namespace dynamatic {
 ///
 /// Instances of this class do not allow modifications of the underlying graph
 /// elements directly; a friend builder class is available for that purpose to
-/// programatically create graphs.
+/// programatically create graphs and to incrementally edit them.
+///
+/// The graph maintains per-node indices of incoming and outgoing edges as well
+/// as a map of named subgraphs, so adjacency and membership queries never need
+/// to walk the subgraph tree.
 ///
 /// ```cpp
 /// DOTGraph graph;
@@ -144,11 +148,30 @@ public:
     return it->second;
   };
 
+  /// Returns the (potentially empty) list of incoming edges for a node.
+  ArrayRef<const Edge *> getPredecessors(const Node &node) const {
+    auto it = predecessors.find(&node);
+    if (it == predecessors.end())
+      return {};
+    return it->second;
+  };
+
   /// Returns the root subgraph.
   const Subgraph &getRoot() const { return root; }
 
+  /// Attempts to retrieve a subgraph by its identifier. Returns `nullptr` if no
+  /// subgraph has this identifier; if multiple subgraphs share it, returns the
+  /// first one that was added.
+  const Subgraph *getSubgraph(StringRef id) const {
+    return subgraphsByID.lookup(id);
+  }
+
+  /// Determines whether the node belongs to the subgraph, either immediately
+  /// or through one of its nested subgraphs.
+  bool isInSubgraph(const Node &node, const Subgraph &subgraph) const;
+
   /// Returns the list of edges adjacent to a node (ingoing to it or outgoing
-  /// from it).
+  /// from it). Self-loops are only listed once.
   SmallVector<const Edge *> getAdjacentEdges(const Node &node) const;
 
   /// Style in which to render edges in the printed DOTs.
@@ -169,6 +192,10 @@ private:
   llvm::DenseMap<StringRef, Node *> nodesByID;
   /// Maps nodes to their outgoing edges.
   llvm::DenseMap<const Node *, SmallVector<const Edge *>> successors;
+  /// Maps nodes to their incoming edges.
+  llvm::DenseMap<const Node *, SmallVector<const Edge *>> predecessors;
+  /// Maps non-empty subgraph identifiers to the first subgraph added with it.
+  llvm::StringMap<Subgraph *> subgraphsByID;
 };
 
 /// Programmatic builder for DOT graphs. Allows to create the graph one
@@ -193,6 +220,16 @@ public:
   /// a specific subgraph, then returns a reference to it.
   Subgraph &addSubgraph(StringRef id, Subgraph &subgraph);
 
+  /// Removes an edge from the graph and frees it.
+  void removeEdge(const Edge &edge);
+
+  /// Removes a node from the graph and frees it, along with all its adjacent
+  /// edges.
+  void removeNode(const Node &node);
+
+  /// Moves a node to another subgraph. Adjacent edges stay in their subgraph.
+  void moveNode(const Node &node, Subgraph &subgraph);
+
   /// Parses the graph from DOT-formatted file. Fails when the graph could not
   /// be parsed successfully (note that we do not support the full DOT grammar).
   LogicalResult parseFromFile(StringRef filepath);
@@ -210,6 +247,10 @@ protected:
   /// Retrieves the node with the identifier if it exists. If it does not, add a
   /// new node to the subgraph and returns the added node.
   DOTGraph::Node &getOrAddNode(StringRef id, Subgraph &subgraph);
+
+  /// Removes the node from the subgraph that owns it (or from the set of early
+  /// nodes) and returns a mutable pointer to it. Indices are left untouched.
+  DOTGraph::Node *detachNode(const Node &node);
 };
 
 /// Parses a DOT graph from a DOT-formatted file. Right now this only supports a
@@ -0,0 +1,102 @@
+//===- Fingerprint.h - Structural fingerprints of functions -----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Declares structural fingerprints of functions and of each of their basic
+// blocks, which let the compilation flow determine which parts of a kernel
+// changed between two compilations. Fingerprints only depend on the structure
+// of the IR (operation types, attributes, result types, and where operands are
+// defined) and not on source locations or operation names, so they are stable
+// across compilations of the same source.
+//
+// At the CF level, basic blocks are the blocks of the function's region. At the
+// Handshake level, they are the logical basic blocks given by the operations'
+// `handshake.bb` attribute.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_SUPPORT_FINGERPRINT_H
+#define DYNAMATIC_SUPPORT_FINGERPRINT_H
+
+#include "dynamatic/Support/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/JSON.h"
+#include <map>
+#include <optional>
+#include <set>
+
+namespace dynamatic {
+
+/// Identifies the operations and values of a function by the basic block they
+/// belong to and their position within it. Unlike operation names, which are
+/// assigned function-wide, these references remain the same across
+/// compilations as long as the basic block's content does not change.
+class StableIRRefs {
+public:
+  /// Indexes all operations in the (single-region) function.
+  StableIRRefs(Operation *funcOp);
+
+  /// Returns the basic block the operation belongs to, if any.
+  std::optional<unsigned> getBlock(Operation *op) const;
+
+  /// Returns a reference to the operation, of the form "<bb>.<index>" (or
+  /// "x.<index>" for operations outside of all basic blocks).
+  std::string getRef(Operation *op) const;
+
+  /// Returns a reference to the value, of the form "<bb>.<index>#<result>" for
+  /// operation results and "arg<block>.<index>" for block arguments.
+  std::string getRef(Value val) const;
+
+  /// Returns a reference to the operand, of the form "<bb>.<index>@<operand>".
+  std::string getRef(OpOperand &operand) const;
+
+  /// Returns a reference to the block, of the form "^<block>".
+  std::string getRef(Block *block) const;
+
+private:
+  /// Basic block of each operation and its index among the block's operations.
+  llvm::DenseMap<Operation *, std::pair<std::optional<unsigned>, unsigned>>
+      positions;
+  /// Index of each block in the function's region.
+  llvm::DenseMap<Block *, unsigned> blockIndices;
+};
+
+/// Fingerprints of a function and of each of its basic blocks.
+struct FuncFingerprint {
+  /// Fingerprint of the entire function, including its signature and the
+  /// operations that do not belong to any basic block.
+  uint64_t func = 0;
+  /// Maps each basic block to the fingerprint of its operations.
+  std::map<unsigned, uint64_t> blocks;
+
+  /// Computes the fingerprint of the (single-region) function.
+  static FuncFingerprint get(Operation *funcOp, const StableIRRefs &refs);
+
+  /// Computes the fingerprint of the (single-region) function.
+  static FuncFingerprint get(Operation *funcOp) {
+    return get(funcOp, StableIRRefs(funcOp));
+  }
+
+  /// Returns the basic blocks that do not exist in the prior fingerprint of
+  /// the same function or whose fingerprint differs from it.
+  std::set<unsigned> getModifiedBlocks(const FuncFingerprint &prior) const;
+};
+
+/// Returns a human-readable list of basic blocks (e.g., "bb1, bb3").
+std::string getBlockList(const std::set<unsigned> &blocks);
+
+/// Serializes a function fingerprint to JSON. Fingerprints are written as
+/// hexadecimal strings since JSON numbers cannot hold 64-bit integers.
+llvm::json::Value toJSON(const FuncFingerprint &fingerprint);
+
+/// Deserializes a function fingerprint from JSON.
+bool fromJSON(const llvm::json::Value &value, FuncFingerprint &fingerprint,
+              llvm::json::Path path);
+
+} // namespace dynamatic
+
+#endif // DYNAMATIC_SUPPORT_FINGERPRINT_H
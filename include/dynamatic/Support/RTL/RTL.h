@@ -183,6 +183,26 @@ public:
   /// match on the heap and returns it; otherwise returns nullptr.
   virtual RTLMatch *tryToMatch(const RTLComponent &component) const = 0;
 
+  /// Returns the name that matching RTL components must have, if the request
+  /// only matches components with a specific name. RTL configurations use it
+  /// to only consider same-name components during matching.
+  virtual std::optional<StringRef> getComponentName() const {
+    return std::nullopt;
+  }
+
+  /// Returns an attribute uniquely identifying the request's parameter values,
+  /// if the outcome of `tryToMatch` only depends on the component name and on
+  /// these values. RTL configurations use it as a key to memoize which
+  /// component matches a request.
+  virtual std::optional<Attribute> getParametersKey() const {
+    return std::nullopt;
+  }
+
+  /// Pushes to the vector human-readable reasons why the request does not
+  /// match the component. Pushes nothing if the reasons cannot be determined.
+  virtual void getMismatches(const RTLComponent &component,
+                             SmallVectorImpl<std::string> &reasons) const {}
+
   /// Attempts to serialize the request's parameters to a JSON file at the
   /// provided filepath.
   virtual LogicalResult paramsToJSON(const llvm::Twine &filepath) const {
@@ -211,6 +231,20 @@ public:
   /// request's parameters are compatible with the component's parameters.
   RTLMatch *tryToMatch(const RTLComponent &component) const override;
 
+  std::optional<StringRef> getComponentName() const override { return name; }
+
+  /// Returns the request's parameter dictionary, which is uniqued in the MLIR
+  /// context.
+  std::optional<Attribute> getParametersKey() const override {
+    return parameters;
+  }
+
+  /// Reports a name mismatch or, for each component parameter that the request
+  /// does not match, whether it is missing or which of its constraints the
+  /// request's value violates.
+  void getMismatches(const RTLComponent &component,
+                     SmallVectorImpl<std::string> &reasons) const override;
+
 protected:
   /// The name of the component to match.
   std::string name;
@@ -538,6 +572,13 @@ public:
   /// (in component and model list order), if any exists.
   const RTLComponent::Model *getModel(const RTLRequest &request) const;
 
+  /// Attaches notes to the diagnostic explaining why no RTL component matched
+  /// the request. Notes describe the (at most `maxCandidates`) closest
+  /// candidates, i.e., the components with the request's name that violate
+  /// the fewest parameter constraints, and list every violation.
+  void explainNoMatch(const RTLRequest &request, InFlightDiagnostic &diag,
+                      unsigned maxCandidates = 3) const;
+
   RTLConfiguration(RTLConfiguration &&) noexcept = default;
   RTLConfiguration &operator=(RTLConfiguration &&) noexcept = default;
 
@@ -545,6 +586,23 @@ private:
   /// List of RTL component descriptions parsed from one or many RTL
   /// configuration files.
   std::vector<RTLComponent> components;
+  /// Maps each component name to the indices of all components with this name
+  /// in the list, in JSON-parsing-order.
+  llvm::StringMap<SmallVector<unsigned>> componentsByName;
+  /// For each component name, maps parameter keys (see
+  /// `RTLRequest::getParametersKey`) to the index of the first component that
+  /// matched requests with these parameters, or to nothing if none did.
+  llvm::StringMap<DenseMap<Attribute, std::optional<unsigned>>> matchCache;
+
+  /// Returns the indices of all components that may match the request, in
+  /// JSON-parsing-order.
+  SmallVector<unsigned> getCandidates(const RTLRequest &request) const;
+
+  /// Tries to match the request to a component, using and updating the match
+  /// cache when possible. Returns a heap-allocated match to the first matching
+  /// component (in JSON-parsing-order) if one exists; otherwise returns
+  /// nullptr.
+  RTLMatch *findFirstMatch(const RTLRequest &request);
 };
 
 } // namespace dynamatic
@@ -32,6 +32,10 @@ struct RTLTypeConstraints {
   /// value stored in an MLIR attribute.
   virtual bool verify(mlir::Attribute attr) const = 0;
 
+  /// Prints a human-readable description of the constraints (e.g., for
+  /// diagnostics explaining why a parameter value was rejected).
+  virtual void print(llvm::raw_ostream &os) const = 0;
+
   /// Necessary because of virtual methods.
   virtual ~RTLTypeConstraints() = default;
 };
@@ -44,6 +48,8 @@ struct BooleanConstraints : public RTLTypeConstraints {
   std::optional<bool> ne;
 
   bool verify(mlir::Attribute attr) const override;
+
+  void print(llvm::raw_ostream &os) const override;
 };
 
 /// ADL-findable LLVM-standard JSON deserializer for boolean constraints.
@@ -63,6 +69,12 @@ struct UnsignedConstraints : public RTLTypeConstraints {
 
   bool verify(mlir::Attribute attr) const override;
 
+  void print(llvm::raw_ostream &os) const override;
+
+  /// Prints the constraints as applying to a named quantity (e.g., "data
+  /// width >= 1"). Nothing is printed if the object is unconstrained.
+  void print(llvm::raw_ostream &os, StringRef subject) const;
+
   /// Attempts to deserialize the unsigned constraints using the provided
   /// deserializer. Exepcted key names are prefixed using the provided string.
   /// The method does not check for the deserializer's validity.
@@ -88,6 +100,8 @@ struct StringConstraints : public RTLTypeConstraints {
   std::optional<std::string> ne;
 
   bool verify(mlir::Attribute attr) const override;
+
+  void print(llvm::raw_ostream &os) const override;
 };
 
 /// ADL-findable LLVM-standard JSON deserializer for string constraints.
@@ -106,6 +120,8 @@ struct DataflowConstraints : public RTLTypeConstraints {
   UnsignedConstraints numUpstreams;
 
   bool verify(mlir::Attribute attr) const override;
+
+  void print(llvm::raw_ostream &os) const override;
 };
 
 /// ADL-findable LLVM-standard JSON deserializer for channel constraints.
@@ -120,6 +136,8 @@ struct TimingConstraints : public RTLTypeConstraints {
   TimingConstraints();
 
   bool verify(mlir::Attribute attr) const override;
+
+  void print(llvm::raw_ostream &os) const override;
 };
 
 /// ADL-findable LLVM-standard JSON deserializer for channel constraints.
@@ -143,6 +161,7 @@ struct RTLType {
                                      llvm::json::Path path) = 0;
     virtual bool verify(mlir::Attribute attr) const = 0;
     virtual std::string serializeImpl(mlir::Attribute attr) const = 0;
+    virtual void printConstraints(llvm::raw_ostream &os) const = 0;
     virtual ~Concept() = default;
   };
 
@@ -169,6 +188,9 @@ struct RTLType {
     std::string serializeImpl(mlir::Attribute attr) const override {
       return DerivedT::serialize(attr);
     }
+    void printConstraints(llvm::raw_ostream &os) const override {
+      constraints.print(os);
+    }
 
     /// Constraints on the concrete RTL type.
     ConstraintT constraints;
@@ -202,6 +224,11 @@ struct RTLType {
   /// parameter value stored in the MLIR attribute.
   bool verify(mlir::Attribute attr) const { return typeConcept->verify(attr); };
 
+  /// Prints a human-readable description of the type's constraints.
+  void printConstraints(llvm::raw_ostream &os) const {
+    typeConcept->printConstraints(os);
+  }
+
   /// Prohibit copy due to dynamic allocation of the underlying concept.
   RTLType(const RTLType &) = delete;
 
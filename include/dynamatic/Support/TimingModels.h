@@ -32,6 +32,10 @@ namespace dynamatic {
 /// Maximum datawidth supported by the timing models.
 const unsigned MAX_DATAWIDTH = 64;
 
+/// Suffix appended to an operation's name to form the timing model key of the
+/// operation's iterative implementation (e.g., "handshake.divsi.iterative").
+constexpr llvm::StringLiteral ITERATIVE_IMPL = "iterative";
+
 /// Gets the datawidth of an operation, for use in determining which data point
 /// of a bitwidth-dependent metric to pick.
 ///
@@ -241,6 +245,15 @@ public:
   /// because the data structures are coupled to more than one system :(
   PathDepMetric latAndMaxFreqByPath;
 
+  /// Operation's initiation interval, with the same layout as the latency.
+  /// Optional in the JSON; an empty metric means the unit is fully pipelined
+  /// (II = 1) at every data point.
+  PathDepMetric iiByPath;
+
+  /// Operation's area, in LUTs, with the same layout as the latency. Optional
+  /// in the JSON; an empty metric means the area is not characterized.
+  PathDepMetric areaByPath;
+
   /// Operation's data delay, depending on its bitwidth.
   BitwidthDepMetric<double> dataDelay;
   /// Delay of valid wire.
@@ -304,6 +317,11 @@ public:
   /// if any exists
   const TimingModel *getModel(StringRef timingModelKey) const;
 
+  /// Returns the timing model key identifying the operation's implementation.
+  /// Operations with an initiation interval greater than one use the timing
+  /// model of their iterative implementation.
+  static std::string getModelKey(Operation *op);
+
   /// Returns the timing model corresponding to the operation, if any exists.
   const TimingModel *getModel(Operation *op) const;
 
@@ -315,6 +333,15 @@ public:
   FailureOr<double> getLatency(Operation *op, SignalType signalType,
                                double targetPeriod, unsigned pathId = 0) const;
 
+  /// Returns the operation's latency for a specific signal type in cycles of
+  /// the main clock, whose period is the target period. Operations in a slower
+  /// clock domain are characterized at their own domain's clock period, and
+  /// their latency is converted to main clock cycles. Clock domain crossings'
+  /// latency is derived from the periods of both domains they connect.
+  FailureOr<double> getMainClockLatency(Operation *op, SignalType signalType,
+                                        double targetPeriod,
+                                        unsigned pathId = 0) const;
+
   LogicalResult getInternalCombinationalDelay(Operation *op,
                                               SignalType signalType,
                                               double &delay,
@@ -27,6 +27,19 @@ static constexpr const char *RTL_NAME_ATTR_NAME = "hw.name";
 /// of the associated RTL component to be stored.
 static constexpr const char *RTL_PARAMETERS_ATTR_NAME = "hw.parameters";
 
+/// Name of the `StringAttr` marking truncations that the bitwidth optimization
+/// inserted on the sole basis of the value ranges it inferred. It holds the
+/// extension that recovers the original value from the truncated one, either
+/// `NARROWING_SEXT` or `NARROWING_ZEXT`. The backend may check at runtime that
+/// these truncations never discard significant bits under that extension.
+static constexpr const char *NARROWING_ATTR_NAME = "handshake.narrowing";
+
+/// Narrowing of a value that is sign-extended back to its original width.
+static constexpr const char *NARROWING_SEXT = "sext";
+
+/// Narrowing of a value that is zero-extended back to its original width.
+static constexpr const char *NARROWING_ZEXT = "zext";
+
 /// The type of a signal in a handshake channel: DATA, VALID, or READY.
 enum class SignalType { DATA, VALID, READY };
 
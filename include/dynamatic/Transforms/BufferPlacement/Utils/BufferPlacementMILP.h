@@ -19,6 +19,7 @@
 
 #include "dynamatic/Analysis/NameAnalysis.h"
 #include "dynamatic/Support/ConstraintProgramming/ConstraintProgramming.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Support/LLVM.h"
 #include "dynamatic/Support/MILP.h"
 #include "dynamatic/Support/TimingModels.h"
@@ -145,6 +146,9 @@ public:
   const TimingDatabase &timingDB;
   /// Target clock period.
   const double targetPeriod;
+  /// Cost model built on the timing database, which gives the units' II and
+  /// the buffers' area.
+  CostModel &costModel;
 
   /// Starts setting up a the buffer placement MILP for a Handshake function
   /// (with its CFDFCs) with specific component timing models. The constructor
@@ -219,6 +223,14 @@ protected:
   /// only.
   void addChannelVars(Value channel, ArrayRef<SignalType> signalTypes);
 
+  /// Gives the solver the function's prior placement decisions as starting
+  /// values for the buffer presence and slot variables of channels. Channels
+  /// without a prior placement decision are left for the solver to start from.
+  ///
+  /// It is only valid to call this method after having added channel variables
+  /// to the model.
+  void addPriorPlacementStart();
+
   /// Adds CFDFC variables to the MILP model for the provided CFDFC. These are
   /// a pair of retiming variables for each CFDFC unit, a throughput variable
   /// for each CFDFC channel, and an overall CFDFC's throughput variable.
@@ -393,7 +405,9 @@ protected:
   /// the "importance" of the CFDFC compared to the others, which is determined
   /// using an estimation of the total number of executions over each provided
   /// channel. The objective has a negative term for each buffer placement
-  /// decision and for each buffer slot depending on the buffer type.
+  /// decision and for each buffer slot depending on the buffer type. Slot
+  /// penalties are proportional to the area of the buffer type on the channel,
+  /// when the timing models characterize it.
   ///
   /// Choose only one function between 'addMaxThroughputObjective' and
   /// 'addBufferAreaAwareObjective'.
@@ -24,6 +24,29 @@
 namespace dynamatic {
 namespace buffer {
 
+/// Holds information about what type of buffer should be placed on a specific
+/// channel.
+struct PlacementResult {
+  /// The number of ONE_SLOT_BREAK_DV that should be placed.
+  unsigned numOneSlotDV = 0;
+  /// The number of ONE_SLOT_BREAK_R that should be placed.
+  unsigned numOneSlotR = 0;
+  /// The number of FIFO_BREAK_DV slots that should be placed.
+  unsigned numFifoDV = 0;
+  /// The number of FIFO_BREAK_NONE slots that should be placed.
+  unsigned numFifoNone = 0;
+  /// The number of ONE_SLOT_BREAK_DVR that should be placed.
+  unsigned numOneSlotDVR = 0;
+  /// The number of SHIFT_REG_BREAK_DV that should be placed.
+  unsigned numShiftRegDV = 0;
+  /// The per-instance latency for each COUNTER_BUFFER to place. The number of
+  /// counter buffers is counterBufferLatencies.size().
+  SmallVector<unsigned, 2> counterBufferLatencies;
+};
+
+/// Maps channels to buffer placement decisions.
+using BufferPlacement = llvm::MapVector<Value, PlacementResult>;
+
 /// Helper datatype for buffer placement. Simply aggregates all the information
 /// related to the Handshake function under optimization.
 struct FuncInfo {
@@ -35,6 +58,10 @@ struct FuncInfo {
   /// Maps CFDFCs of the function to a boolean indicating whether they each
   /// should be optimized.
   llvm::MapVector<CFDFC *, bool> cfdfcs;
+  /// Placement decisions made by a previous compilation for channels whose
+  /// basic blocks did not change since then. MILPs use them as a starting
+  /// point for their solution.
+  BufferPlacement priorPlacement;
 
   /// Argument-less constructor so that we can use the struct as a value type
   /// for maps.
@@ -162,29 +189,6 @@ struct Channel {
   inline bool isFunArg() const { return isa<handshake::FuncOp>(producer); }
 };
 
-/// Holds information about what type of buffer should be placed on a specific
-/// channel.
-struct PlacementResult {
-  /// The number of ONE_SLOT_BREAK_DV that should be placed.
-  unsigned numOneSlotDV = 0;
-  /// The number of ONE_SLOT_BREAK_R that should be placed.
-  unsigned numOneSlotR = 0;
-  /// The number of FIFO_BREAK_DV slots that should be placed.
-  unsigned numFifoDV = 0;
-  /// The number of FIFO_BREAK_NONE slots that should be placed.
-  unsigned numFifoNone = 0;
-  /// The number of ONE_SLOT_BREAK_DVR that should be placed.
-  unsigned numOneSlotDVR = 0;
-  /// The number of SHIFT_REG_BREAK_DV that should be placed.
-  unsigned numShiftRegDV = 0;
-  /// The per-instance latency for each COUNTER_BUFFER to place. The number of
-  /// counter buffers is counterBufferLatencies.size().
-  SmallVector<unsigned, 2> counterBufferLatencies;
-};
-
-/// Maps channels to buffer placement decisions.
-using BufferPlacement = llvm::MapVector<Value, PlacementResult>;
-
 /// Returns the producer of the channel (in the buffer placement sense), or
 /// nullptr if the channel has no producer in this context. If idx is not
 /// nullptr, it is filled with the definition index of the channel in its
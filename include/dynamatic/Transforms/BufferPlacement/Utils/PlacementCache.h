@@ -0,0 +1,119 @@
+//===- PlacementCache.h - Cached buffer placements -------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Declares the buffer placement cache, which records the buffer placement
+// decisions and CFDFC performance computed for each function during a
+// compilation so that the next compilation of the same kernel only has to
+// re-solve buffer placement for the parts of the circuit that changed.
+//
+// Channels are recorded by their stable reference (see `StableIRRefs`) instead
+// of by the name of their endpoints, since operation names are assigned
+// function-wide and change as soon as operations are added or removed anywhere
+// in the function.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_TRANSFORMS_BUFFERPLACEMENT_PLACEMENTCACHE_H
+#define DYNAMATIC_TRANSFORMS_BUFFERPLACEMENT_PLACEMENTCACHE_H
+
+#include "dynamatic/Support/Fingerprint.h"
+#include "dynamatic/Support/LLVM.h"
+#include "dynamatic/Transforms/BufferPlacement/Utils/BufferingSupport.h"
+#include "dynamatic/Transforms/BufferPlacement/Utils/CFDFC.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/JSON.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dynamatic {
+namespace buffer {
+
+/// A transition between two basic blocks, as seen during profiling.
+struct CachedArch {
+  /// Source basic block ID.
+  unsigned srcBB = 0;
+  /// Destination basic block ID.
+  unsigned dstBB = 0;
+  /// Number of transitions recorded between the two blocks.
+  unsigned numTrans = 0;
+};
+
+/// A CFDFC and its performance after buffer placement.
+struct CachedCFDFC {
+  /// Basic blocks making up the CFDFC's cycle, in order.
+  std::vector<unsigned> cycle;
+  /// Number of executions of the CFDFC.
+  unsigned numExecs = 0;
+  /// Throughput achieved by the buffer placement.
+  double throughput = 0.0;
+  /// Maps the stable reference of each CFDFC channel to its token occupancy.
+  std::map<std::string, double> occupancy;
+
+  /// Determines whether the CFDFC is the same as this cached one.
+  bool matches(const CFDFC &cfdfc) const;
+};
+
+/// Buffer placement of a function in a previous compilation.
+struct CachedFuncPlacement {
+  /// Buffer placement configuration (algorithm, target period, timing models
+  /// and their contents) the placement was computed for. Placements computed
+  /// for another configuration are never reused.
+  std::string config;
+  /// Fingerprint of the function before buffer placement.
+  FuncFingerprint fingerprint;
+  /// Transitions between basic blocks the placement was computed for.
+  std::vector<CachedArch> archs;
+  /// CFDFCs extracted from the function.
+  std::vector<CachedCFDFC> cfdfcs;
+  /// Maps the stable reference of each channel to its placement decision.
+  std::map<std::string, PlacementResult> placement;
+
+  /// Determines whether the function's profiled transitions between basic
+  /// blocks are the ones the placement was computed for.
+  bool hasSameArchs(ArrayRef<experimental::ArchBB> funcArchs) const;
+};
+
+/// Buffer placements of all functions of a kernel in its last compilation.
+struct PlacementCache {
+  /// Maps each function name to its placement.
+  llvm::StringMap<CachedFuncPlacement> functions;
+
+  /// Reads the cache from the JSON file at the given path. Succeeds with an
+  /// empty cache if the file does not exist or was written by an incompatible
+  /// version of the cache.
+  static LogicalResult read(StringRef path, PlacementCache &cache);
+
+  /// Writes the cache to the JSON file at the given path.
+  LogicalResult write(StringRef path) const;
+};
+
+/// Returns the stable reference of a channel, made up of the stable references
+/// of its producer's result and of its (unique) consumer's operand.
+std::string getChannelRef(Value channel, const StableIRRefs &refs);
+
+/// Deserializes a placement decision from JSON.
+bool fromJSON(const llvm::json::Value &value, PlacementResult &result,
+              llvm::json::Path path);
+
+/// Deserializes a transition between basic blocks from JSON.
+bool fromJSON(const llvm::json::Value &value, CachedArch &arch,
+              llvm::json::Path path);
+
+/// Deserializes a cached CFDFC from JSON.
+bool fromJSON(const llvm::json::Value &value, CachedCFDFC &cfdfc,
+              llvm::json::Path path);
+
+/// Deserializes a function's cached placement from JSON.
+bool fromJSON(const llvm::json::Value &value, CachedFuncPlacement &placement,
+              llvm::json::Path path);
+
+} // namespace buffer
+} // namespace dynamatic
+
+#endif // DYNAMATIC_TRANSFORMS_BUFFERPLACEMENT_PLACEMENTCACHE_H
@@ -0,0 +1,47 @@
+// clang-format off
+#include "nested_loop_multi_spec.h"
+#include "dynamatic/Integration.h"
+#include "stdbool.h"
+#include "stdlib.h"
+
+void nested_loop_multi_spec(in_int_t a[N], in_int_t b[N], inout_int_t c[N]) {
+  for (int j = 0; j < 2; j++) {
+    int i = 0;
+    int sum = 0;
+    bool loopAgain;
+    do {
+      sum = a[i] * b[i];
+      c[i + j * 400] = sum;
+      i++;
+      loopAgain = sum < 1000;
+      #pragma DYN speculate variable=loopAgain max_predictions=6 style=standard
+    } while (loopAgain);
+
+    int k = 0;
+    int diff = 0;
+    bool loopAgain2;
+    do {
+      diff = a[k] + b[k];
+      c[k + j * 400 + 200] = diff;
+      k++;
+      loopAgain2 = diff < 150;
+      #pragma DYN speculate variable=loopAgain2 max_predictions=6 style=standard
+    } while (loopAgain2);
+  }
+}
+
+int main(void) {
+  in_int_t a[N];
+  in_int_t b[N];
+  inout_int_t c[N];
+
+  srand(13);
+  for (int j = 0; j < N; ++j) {
+    a[j] = 5;
+    b[j] = j;
+    c[j] = 0;
+  }
+
+  CALL_KERNEL(nested_loop_multi_spec, a, b, c);
+  return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef NESTED_LOOP_MULTI_SPEC_H
+#define NESTED_LOOP_MULTI_SPEC_H
+
+#define N 1000
+
+typedef int in_int_t;
+typedef int inout_int_t;
+
+void nested_loop_multi_spec(in_int_t a[N], in_int_t b[N], inout_int_t c[N]);
+
+#endif
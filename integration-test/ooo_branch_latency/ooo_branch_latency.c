@@ -0,0 +1,40 @@
+//===- ooo_branch_latency.c - Branches with unbalanced latencies --*- C -*-===//
+//
+// Implements a loop whose iterations take a long- or a short-latency path
+// depending on the input data. Only a fifth of the iterations take the long
+// path, which goes through a floating-point division, so that the iterations
+// following them take the short path and may complete first when executed out
+// of order. Iterations are independent and the loop's induction variable does
+// not depend on the path taken.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ooo_branch_latency.h"
+#include "dynamatic/Integration.h"
+#include <stdlib.h>
+
+void ooo_branch_latency(in_float_t a[N], out_float_t b[N]) {
+  for (int i = 0; i < N; i++) {
+    float d = a[i];
+    float p;
+    if (d >= (float)0.8)
+      p = (d * d + (float)0.5) / (d + (float)0.25) * d;
+    else
+      p = d - (float)1.0;
+    b[i] = p;
+  }
+}
+
+int main(void) {
+  in_float_t a[N];
+  out_float_t b[N];
+
+  srand(13);
+  for (int i = 0; i < N; ++i) {
+    a[i] = (float)(rand() % 100) / (float)100;
+    b[i] = 0;
+  }
+
+  CALL_KERNEL(ooo_branch_latency, a, b);
+  return 0;
+}
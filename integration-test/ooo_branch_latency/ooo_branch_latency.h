@@ -0,0 +1,11 @@
+#ifndef OOO_BRANCH_LATENCY_OOO_BRANCH_LATENCY_H
+#define OOO_BRANCH_LATENCY_OOO_BRANCH_LATENCY_H
+
+#define N 1000
+
+typedef float in_float_t;
+typedef float out_float_t;
+
+void ooo_branch_latency(in_float_t a[N], out_float_t b[N]);
+
+#endif // OOO_BRANCH_LATENCY_OOO_BRANCH_LATENCY_H
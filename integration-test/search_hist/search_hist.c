@@ -0,0 +1,44 @@
+//===- search_hist.c -------------------------------------------*- C -*-===//
+//
+// Linear search for a key that counts the occurrences of all values it visits
+// before finding it. The loop exits early, and the histogram update requires
+// an LSQ.
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+#include "search_hist.h"
+#include "dynamatic/Integration.h"
+#include "stdbool.h"
+#include "stdlib.h"
+
+int search_hist(in_int_t a[N], inout_int_t hist[N], in_int_t key) {
+  int i = 0;
+  bool loop_again = false;
+  do {
+    int x = a[i];
+    hist[x] = hist[x] + 1;
+    i++;
+    loop_again = i < N && x != key;
+    #pragma DYN speculate variable = loop_again max_predictions = 8 style = standard
+  } while (loop_again);
+  return i;
+}
+
+int main(void) {
+  in_int_t a[N];
+  inout_int_t hist[N];
+  in_int_t key;
+
+  srand(13);
+  for (int j = 0; j < N; ++j) {
+    a[j] = rand() % (N - 1);
+    hist[j] = 0;
+  }
+  // The key only appears once, in the middle of the array
+  key = N - 1;
+  a[N / 2] = key;
+
+  CALL_KERNEL(search_hist, a, hist, key);
+  return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef SEARCH_HIST_SEARCH_HIST_H
+#define SEARCH_HIST_SEARCH_HIST_H
+
+#define N 1000
+
+typedef int in_int_t;
+typedef int inout_int_t;
+
+int search_hist(in_int_t a[N], inout_int_t hist[N], in_int_t key);
+
+#endif // SEARCH_HIST_SEARCH_HIST_H
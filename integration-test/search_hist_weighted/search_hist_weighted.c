@@ -0,0 +1,48 @@
+//===- search_hist_weighted.c ----------------------------------*- C -*-===//
+//
+// Linear search for a key that accumulates the weights of all values it visits
+// before finding it. The loop exits early, and the histogram update requires
+// an LSQ. The value loaded from the histogram, whose address is committed
+// before reaching the LSQ, is added to a speculative weight.
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+#include "search_hist_weighted.h"
+#include "dynamatic/Integration.h"
+#include "stdbool.h"
+#include "stdlib.h"
+
+int search_hist_weighted(in_int_t a[N], in_int_t w[N], inout_int_t hist[N],
+                         in_int_t key) {
+  int i = 0;
+  bool loop_again = false;
+  do {
+    int x = a[i];
+    hist[x] = hist[x] + w[i];
+    i++;
+    loop_again = i < N && x != key;
+    #pragma DYN speculate variable = loop_again max_predictions = 8 style = standard
+  } while (loop_again);
+  return i;
+}
+
+int main(void) {
+  in_int_t a[N];
+  in_int_t w[N];
+  inout_int_t hist[N];
+  in_int_t key;
+
+  srand(13);
+  for (int j = 0; j < N; ++j) {
+    a[j] = rand() % (N - 1);
+    w[j] = rand() % 10;
+    hist[j] = 0;
+  }
+  // The key only appears once, in the middle of the array
+  key = N - 1;
+  a[N / 2] = key;
+
+  CALL_KERNEL(search_hist_weighted, a, w, hist, key);
+  return 0;
+}
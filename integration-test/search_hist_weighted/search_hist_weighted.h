@@ -0,0 +1,12 @@
+#ifndef SEARCH_HIST_WEIGHTED_SEARCH_HIST_WEIGHTED_H
+#define SEARCH_HIST_WEIGHTED_SEARCH_HIST_WEIGHTED_H
+
+#define N 1000
+
+typedef int in_int_t;
+typedef int inout_int_t;
+
+int search_hist_weighted(in_int_t a[N], in_int_t w[N], inout_int_t hist[N],
+                         in_int_t key);
+
+#endif // SEARCH_HIST_WEIGHTED_SEARCH_HIST_WEIGHTED_H
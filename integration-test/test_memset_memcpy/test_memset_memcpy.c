@@ -0,0 +1,29 @@
+#include "dynamatic/Integration.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define N 100
+#define M 16
+
+int test_memset_memcpy(int a[N]) {
+  int copy[N];
+  int count[M];
+  memset(count, 0, sizeof(count));
+  memcpy(copy, a, sizeof(copy));
+
+  for (unsigned i = 0; i < N; i++)
+    count[copy[i] % M] += 1;
+
+  int sum = 0;
+  for (unsigned i = 0; i < M; i++)
+    sum += count[i] * i;
+  return sum;
+}
+
+int main() {
+  int a[N];
+  srand(13);
+  for (int i = 0; i < N; ++i)
+    a[i] = rand() % 100;
+  CALL_KERNEL(test_memset_memcpy, a);
+}
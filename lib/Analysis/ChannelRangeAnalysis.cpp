@@ -0,0 +1,395 @@
+//===- ChannelRangeAnalysis.cpp - Value ranges of Handshake channels ------===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the interval analysis over integer-typed Handshake channels.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/ChannelRangeAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/IR/InstrTypes.h"
+#include <deque>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+
+/// Returns the data bitwidth of the value if it is an integer-typed channel;
+/// otherwise returns std::nullopt.
+static std::optional<unsigned> getIntChannelWidth(Value val) {
+  if (auto channelType = dyn_cast<handshake::ChannelType>(val.getType())) {
+    if (isa<IntegerType>(channelType.getDataType()))
+      return channelType.getDataBitWidth();
+  }
+  return std::nullopt;
+}
+
+/// Backtracks through operations that forward their single input unmodified
+/// to all their outputs.
+static Value skipForwarders(Value val) {
+  while (Operation *defOp = val.getDefiningOp()) {
+    if (!isa<handshake::ForkOp, handshake::LazyForkOp, handshake::BufferOp>(
+            defOp))
+      break;
+    val = defOp->getOperand(0);
+  }
+  return val;
+}
+
+/// Converts a Handshake comparison predicate into its LLVM equivalent.
+static CmpInst::Predicate toLLVMPredicate(handshake::CmpIPredicate pred) {
+  switch (pred) {
+  case handshake::CmpIPredicate::eq:
+    return CmpInst::ICMP_EQ;
+  case handshake::CmpIPredicate::ne:
+    return CmpInst::ICMP_NE;
+  case handshake::CmpIPredicate::slt:
+    return CmpInst::ICMP_SLT;
+  case handshake::CmpIPredicate::sle:
+    return CmpInst::ICMP_SLE;
+  case handshake::CmpIPredicate::sgt:
+    return CmpInst::ICMP_SGT;
+  case handshake::CmpIPredicate::sge:
+    return CmpInst::ICMP_SGE;
+  case handshake::CmpIPredicate::ult:
+    return CmpInst::ICMP_ULT;
+  case handshake::CmpIPredicate::ule:
+    return CmpInst::ICMP_ULE;
+  case handshake::CmpIPredicate::ugt:
+    return CmpInst::ICMP_UGT;
+  case handshake::CmpIPredicate::uge:
+    return CmpInst::ICMP_UGE;
+  }
+  llvm_unreachable("unknown comparison predicate");
+}
+
+/// Collects the comparisons that `refineWithCondition` may look at to refine a
+/// conditional branch's data operand from its condition.
+static void collectConditionCmps(Value cond,
+                                 SmallVectorImpl<Operation *> &cmpOps) {
+  Operation *defOp = skipForwarders(cond).getDefiningOp();
+  if (!defOp)
+    return;
+  if (isa<handshake::CmpIOp>(defOp)) {
+    cmpOps.push_back(defOp);
+  } else if (isa<handshake::AndIOp, handshake::OrIOp>(defOp)) {
+    for (Value opr : defOp->getOperands())
+      collectConditionCmps(opr, cmpOps);
+  }
+}
+
+ChannelRangeAnalysis::ChannelRangeAnalysis(handshake::FuncOp funcOp) {
+  // Nothing is known about function arguments
+  for (BlockArgument arg : funcOp.getArguments()) {
+    if (std::optional<unsigned> width = getIntChannelWidth(arg))
+      ranges.insert({arg, ConstantRange::getFull(*width)});
+  }
+
+  // Conditional branches also depend on the operands of the comparisons
+  // computing their condition, even though these are not among their operands
+  DenseMap<Operation *, SmallVector<Operation *>> condBranchesOfCmp;
+  for (auto condOp : funcOp.getOps<handshake::ConditionalBranchOp>()) {
+    SmallVector<Operation *> cmpOps;
+    collectConditionCmps(condOp.getConditionOperand(), cmpOps);
+    for (Operation *cmpOp : cmpOps)
+      condBranchesOfCmp[cmpOp].push_back(condOp);
+  }
+
+  // Ascending phase, only revisiting the users of operations whose result
+  // ranges grew
+  std::deque<Operation *> worklist;
+  DenseSet<Operation *> queued;
+  for (Operation &op : funcOp.getOps()) {
+    worklist.push_back(&op);
+    queued.insert(&op);
+  }
+  while (!worklist.empty()) {
+    Operation *op = worklist.front();
+    worklist.pop_front();
+    queued.erase(op);
+    if (!visit(op, true))
+      continue;
+    auto enqueue = [&](Operation *dependentOp) {
+      if (dependentOp->getParentOp() == funcOp &&
+          queued.insert(dependentOp).second)
+        worklist.push_back(dependentOp);
+    };
+    for (Operation *user : op->getUsers()) {
+      enqueue(user);
+      if (auto condBrIt = condBranchesOfCmp.find(user);
+          condBrIt != condBranchesOfCmp.end())
+        llvm::for_each(condBrIt->second, enqueue);
+    }
+  }
+
+  // Descending phase, recovering precision lost to widening
+  for (unsigned i = 0; i < NARROWING_ITERATIONS; ++i) {
+    bool changed = false;
+    for (Operation &op : funcOp.getOps())
+      changed |= visit(&op, false);
+    if (!changed)
+      break;
+  }
+}
+
+ConstantRange ChannelRangeAnalysis::getRange(Value val) const {
+  std::optional<unsigned> width = getIntChannelWidth(val);
+  assert(width && "value must be an integer-typed channel");
+  if (auto rangeIt = ranges.find(val); rangeIt != ranges.end())
+    return rangeIt->second;
+  return ConstantRange::getFull(*width);
+}
+
+std::pair<unsigned, bool>
+ChannelRangeAnalysis::getRequiredWidth(Value val) const {
+  ConstantRange range = getRange(val);
+  unsigned width = range.getBitWidth();
+  if (range.isFullSet() || range.isEmptySet())
+    return {width, false};
+
+  unsigned zextWidth = std::max(range.getUnsignedMax().getActiveBits(), 1U);
+  unsigned sextWidth =
+      std::max(range.getSignedMin().getSignificantBits(),
+               range.getSignedMax().getSignificantBits());
+  if (zextWidth <= sextWidth)
+    return {zextWidth, false};
+  return {sextWidth, true};
+}
+
+bool ChannelRangeAnalysis::update(Value res, const ConstantRange &newRange,
+                                  bool ascending, bool widen) {
+  auto rangeIt = ranges.find(res);
+  if (rangeIt == ranges.end()) {
+    ranges.insert({res, newRange});
+    return !newRange.isEmptySet();
+  }
+
+  ConstantRange &oldRange = rangeIt->second;
+  if (ascending) {
+    ConstantRange joined = oldRange.unionWith(newRange);
+    if (joined == oldRange)
+      return false;
+    // Jump to the full range when a loop-carried value keeps growing
+    if (widen && ++growthCount[res] > WIDENING_DELAY)
+      joined = ConstantRange::getFull(joined.getBitWidth());
+    oldRange = joined;
+    return true;
+  }
+
+  // Only ever refine ranges during the descending phase
+  if (newRange == oldRange || !oldRange.contains(newRange))
+    return false;
+  oldRange = newRange;
+  return true;
+}
+
+/// Refines the range using the condition, assuming it evaluates to `onTrue`.
+/// Only comparisons of the data value with another channel, as well as
+/// conjunctions (on the true side) and disjunctions (on the false side) of
+/// these comparisons, are understood.
+static ConstantRange
+refineWithCondition(ConstantRange range, Value data, Value cond, bool onTrue,
+                    function_ref<ConstantRange(Value)> getRange) {
+  Operation *defOp = skipForwarders(cond).getDefiningOp();
+  if (!defOp)
+    return range;
+
+  if (auto cmpOp = dyn_cast<handshake::CmpIOp>(defOp)) {
+    CmpInst::Predicate pred = toLLVMPredicate(cmpOp.getPredicate());
+    Value other;
+    if (skipForwarders(cmpOp.getLhs()) == data) {
+      other = cmpOp.getRhs();
+    } else if (skipForwarders(cmpOp.getRhs()) == data) {
+      other = cmpOp.getLhs();
+      pred = CmpInst::getSwappedPredicate(pred);
+    } else {
+      return range;
+    }
+    if (!onTrue)
+      pred = CmpInst::getInversePredicate(pred);
+    return range.intersectWith(
+        ConstantRange::makeAllowedICmpRegion(pred, getRange(other)));
+  }
+
+  bool isConj = isa<handshake::AndIOp>(defOp);
+  bool isDisj = isa<handshake::OrIOp>(defOp);
+  if ((isConj && onTrue) || (isDisj && !onTrue)) {
+    for (Value opr : defOp->getOperands())
+      range = refineWithCondition(range, data, opr, onTrue, getRange);
+  }
+  return range;
+}
+
+ConstantRange
+ChannelRangeAnalysis::refineFromCondition(handshake::ConditionalBranchOp condOp,
+                                          bool onTrue) const {
+  Value data = condOp.getDataOperand();
+  auto getRangeOrEmpty = [&](Value val) -> ConstantRange {
+    if (auto rangeIt = ranges.find(val); rangeIt != ranges.end())
+      return rangeIt->second;
+    return ConstantRange::getEmpty(*getIntChannelWidth(val));
+  };
+  return refineWithCondition(getRangeOrEmpty(data), skipForwarders(data),
+                             condOp.getConditionOperand(), onTrue,
+                             getRangeOrEmpty);
+}
+
+bool ChannelRangeAnalysis::visit(Operation *op, bool ascending) {
+  // Ranges of values that have not been visited yet are empty (i.e., bottom).
+  // Every operation is visited at least once during the ascending phase, after
+  // which its users are revisited, so this never leaks into final results
+  auto get = [&](Value val) -> ConstantRange {
+    if (auto rangeIt = ranges.find(val); rangeIt != ranges.end())
+      return rangeIt->second;
+    return ConstantRange::getEmpty(*getIntChannelWidth(val));
+  };
+
+  // Conditional branches refine their data operand on each side
+  if (auto condOp = dyn_cast<handshake::ConditionalBranchOp>(op)) {
+    if (!getIntChannelWidth(condOp.getDataOperand()))
+      return false;
+    bool changed = update(condOp.getTrueResult(),
+                          refineFromCondition(condOp, true), ascending, false);
+    changed |= update(condOp.getFalseResult(),
+                      refineFromCondition(condOp, false), ascending, false);
+    return changed;
+  }
+
+  // Merge-like operations join their data operands and are where loop-carried
+  // values are widened
+  if (auto mergeLikeOp = dyn_cast<handshake::MergeLikeOpInterface>(op)) {
+    bool changed = false;
+    OpResult dataRes = mergeLikeOp.getDataResult();
+    if (std::optional<unsigned> width = getIntChannelWidth(dataRes)) {
+      ConstantRange joined = ConstantRange::getEmpty(*width);
+      for (Value opr : mergeLikeOp.getDataOperands())
+        joined = joined.unionWith(get(opr));
+      changed |= update(dataRes, joined, ascending, true);
+    }
+    if (auto cmergeOp = dyn_cast<handshake::ControlMergeOp>(op)) {
+      Value index = cmergeOp.getIndex();
+      unsigned width = *getIntChannelWidth(index);
+      APInt numInputs(width + 1, cmergeOp.getDataOperands().size());
+      ConstantRange indexRange =
+          ConstantRange::getNonEmpty(APInt::getZero(width),
+                                     numInputs.trunc(width));
+      if (numInputs.getActiveBits() > width)
+        indexRange = ConstantRange::getFull(width);
+      changed |= update(index, indexRange, ascending, false);
+    }
+    return changed;
+  }
+
+  // Data-forwarding operations propagate their input's range to all results
+  if (isa<handshake::ForkOp, handshake::LazyForkOp, handshake::BufferOp,
+          handshake::BranchOp>(op)) {
+    if (!getIntChannelWidth(op->getOperand(0)))
+      return false;
+    ConstantRange range = get(op->getOperand(0));
+    bool changed = false;
+    for (OpResult res : op->getResults())
+      changed |= update(res, range, ascending, false);
+    return changed;
+  }
+
+  // Nothing is known about the results of other multi-result operations (e.g.,
+  // loads, memory controllers, and LSQs)
+  if (op->getNumResults() != 1) {
+    bool changed = false;
+    for (OpResult res : op->getResults()) {
+      if (std::optional<unsigned> width = getIntChannelWidth(res)) {
+        changed |=
+            update(res, ConstantRange::getFull(*width), ascending, false);
+      }
+    }
+    return changed;
+  }
+  OpResult res = op->getResult(0);
+  std::optional<unsigned> resWidth = getIntChannelWidth(res);
+  if (!resWidth)
+    return false;
+
+  auto binary = [&](auto fun) -> ConstantRange {
+    return fun(get(op->getOperand(0)), get(op->getOperand(1)));
+  };
+
+  ConstantRange newRange =
+      TypeSwitch<Operation *, ConstantRange>(op)
+          .Case<handshake::ConstantOp>([&](handshake::ConstantOp cstOp) {
+            if (auto intAttr = dyn_cast<IntegerAttr>(cstOp.getValue()))
+              return ConstantRange(intAttr.getValue());
+            return ConstantRange::getFull(*resWidth);
+          })
+          .Case<handshake::AddIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.add(r); });
+          })
+          .Case<handshake::SubIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.sub(r); });
+          })
+          .Case<handshake::MulIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.multiply(r); });
+          })
+          .Case<handshake::AndIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.binaryAnd(r); });
+          })
+          .Case<handshake::OrIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.binaryOr(r); });
+          })
+          .Case<handshake::XOrIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.binaryXor(r); });
+          })
+          .Case<handshake::ShLIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.shl(r); });
+          })
+          .Case<handshake::ShRUIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.lshr(r); });
+          })
+          .Case<handshake::ShRSIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.ashr(r); });
+          })
+          .Case<handshake::DivUIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.udiv(r); });
+          })
+          .Case<handshake::DivSIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.sdiv(r); });
+          })
+          .Case<handshake::RemSIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.srem(r); });
+          })
+          .Case<handshake::MaxSIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.smax(r); });
+          })
+          .Case<handshake::MaxUIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.umax(r); });
+          })
+          .Case<handshake::MinSIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.smin(r); });
+          })
+          .Case<handshake::MinUIOp>([&](auto) {
+            return binary([](auto l, auto r) { return l.umin(r); });
+          })
+          .Case<handshake::SelectOp>([&](handshake::SelectOp selectOp) {
+            return get(selectOp.getTrueValue())
+                .unionWith(get(selectOp.getFalseValue()));
+          })
+          .Case<handshake::ExtSIOp>([&](handshake::ExtSIOp extOp) {
+            return get(extOp.getIn()).signExtend(*resWidth);
+          })
+          .Case<handshake::ExtUIOp>([&](handshake::ExtUIOp extOp) {
+            return get(extOp.getIn()).zeroExtend(*resWidth);
+          })
+          .Case<handshake::TruncIOp>([&](handshake::TruncIOp truncOp) {
+            return get(truncOp.getIn()).truncate(*resWidth);
+          })
+          .Default(
+              [&](auto) { return ConstantRange::getFull(*resWidth); });
+
+  return update(res, newRange, ascending, false);
+}
@@ -0,0 +1,344 @@
+//===- TokenLineage.cpp - Provenance of tokens in execution traces --------===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the recording, inference, and querying of token lineage.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/TokenLineage.h"
+#include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <deque>
+#include <tuple>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+
+ChannelEndpoints::ChannelEndpoints(Value channel) {
+  assert(channel.hasOneUse() && "channel must have exactly one use");
+
+  // Derive the source component's name and port
+  if (auto res = dyn_cast<OpResult>(channel)) {
+    srcComponent = getUniqueName(res.getOwner()).str();
+    srcPort = res.getResultNumber();
+  } else {
+    auto arg = cast<BlockArgument>(channel);
+    auto funcOp = cast<handshake::FuncOp>(arg.getParentBlock()->getParentOp());
+    srcComponent = funcOp.getArgName(arg.getArgNumber()).str();
+    srcPort = arg.getArgNumber();
+  }
+
+  // Derive the destination component's name and port
+  OpOperand &oprd = *channel.getUses().begin();
+  Operation *consumerOp = oprd.getOwner();
+  dstPort = oprd.getOperandNumber();
+  if (isa<handshake::EndOp>(consumerOp)) {
+    auto funcOp = cast<handshake::FuncOp>(consumerOp->getParentOp());
+    dstComponent = funcOp.getResName(oprd.getOperandNumber()).str();
+  } else {
+    dstComponent = getUniqueName(consumerOp).str();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// TokenLineageRecorder
+//===----------------------------------------------------------------------===//
+
+/// A token, identified by its channel and sequence number on the channel.
+using TokenRef = std::pair<Value, unsigned>;
+
+void TokenLineageRecorder::recordTransfer(Value channel, unsigned cycle,
+                                          StringRef data) {
+  std::vector<Transfer> &channelTransfers = transfers[channel];
+  assert((channelTransfers.empty() ||
+          channelTransfers.back().cycle <= cycle) &&
+         "transfers must be recorded in order");
+  channelTransfers.push_back({cycle, data.str()});
+}
+
+ArrayRef<TokenLineageRecorder::Transfer>
+TokenLineageRecorder::getTransfers(Value channel) const {
+  if (auto it = transfers.find(channel); it != transfers.end())
+    return it->second;
+  return {};
+}
+
+void TokenLineageRecorder::inferParents(
+    Operation *op, DenseMap<TokenRef, SmallVector<TokenRef>> &parents) const {
+  // Adds the token with the sequence number on the operand to the parents of
+  // the token, if it exists
+  auto addParent = [&](TokenRef token, Value oprd, unsigned seq) {
+    if (seq < getTransfers(oprd).size())
+      parents[token].push_back({oprd, seq});
+  };
+
+  // Memory interfaces serve requests out of order; fall back to the last token
+  // transferred on each input no later than the output token
+  if (isa<handshake::MemoryOpInterface>(op)) {
+    for (OpResult res : op->getResults()) {
+      for (auto [seq, transfer] : llvm::enumerate(getTransfers(res))) {
+        for (Value oprd : op->getOperands()) {
+          ArrayRef<Transfer> oprdTransfers = getTransfers(oprd);
+          const auto *it = llvm::upper_bound(
+              oprdTransfers, transfer.cycle,
+              [](unsigned cycle, const Transfer &t) { return cycle < t.cycle; });
+          if (it != oprdTransfers.begin()) {
+            unsigned lastSeq = std::distance(oprdTransfers.begin(), it) - 1;
+            addParent({res, seq}, oprd, lastSeq);
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  // Orders the tokens transferred on a group of channels by cycle, then by
+  // channel order within the group
+  auto orderByArrival = [&](ValueRange channels) {
+    SmallVector<std::tuple<unsigned, unsigned, unsigned>> order;
+    for (auto [idx, channel] : llvm::enumerate(channels)) {
+      for (auto [seq, transfer] : llvm::enumerate(getTransfers(channel)))
+        order.emplace_back(transfer.cycle, idx, seq);
+    }
+    llvm::sort(order);
+    SmallVector<TokenRef> tokens;
+    for (auto [_, idx, seq] : order)
+      tokens.push_back({channels[idx], seq});
+    return tokens;
+  };
+
+  // Conditional branches steer each input token to one of their outputs
+  if (auto condBrOp = dyn_cast<handshake::ConditionalBranchOp>(op)) {
+    SmallVector<TokenRef> outTokens = orderByArrival(op->getResults());
+    for (auto [idx, token] : llvm::enumerate(outTokens)) {
+      addParent(token, condBrOp.getConditionOperand(), idx);
+      addParent(token, condBrOp.getDataOperand(), idx);
+    }
+    return;
+  }
+
+  // Merge-like operations consume their data inputs in arrival order, and
+  // their other inputs in order
+  SmallVector<TokenRef> mergedTokens;
+  SmallPtrSet<OpOperand *, 4> mergedOperands;
+  if (auto mergeOp = dyn_cast<handshake::MergeLikeOpInterface>(op)) {
+    OperandRange dataOprds = mergeOp.getDataOperands();
+    mergedTokens = orderByArrival(dataOprds);
+    for (OpOperand &oprd : op->getOpOperands()) {
+      if (llvm::is_contained(dataOprds, oprd.get()))
+        mergedOperands.insert(&oprd);
+    }
+  }
+
+  for (OpResult res : op->getResults()) {
+    for (unsigned seq = 0, e = getTransfers(res).size(); seq < e; ++seq) {
+      TokenRef token(res, seq);
+      if (seq < mergedTokens.size())
+        parents[token].push_back(mergedTokens[seq]);
+      for (OpOperand &oprd : op->getOpOperands()) {
+        if (!mergedOperands.contains(&oprd))
+          addParent(token, oprd.get(), seq);
+      }
+    }
+  }
+}
+
+void TokenLineageRecorder::write(raw_ostream &os) const {
+  // Channels in the order in which they appear in the function
+  SmallVector<Value> channels;
+  for (BlockArgument arg : funcOp.getArguments()) {
+    if (transfers.count(arg))
+      channels.push_back(arg);
+  }
+  for (Operation &op : funcOp.getOps()) {
+    for (OpResult res : op.getResults()) {
+      if (transfers.count(res))
+        channels.push_back(res);
+    }
+  }
+
+  // Assign identifiers to tokens in order of transfer
+  SmallVector<std::tuple<unsigned, unsigned, unsigned>> order;
+  for (auto [idx, channel] : llvm::enumerate(channels)) {
+    for (auto [seq, transfer] : llvm::enumerate(getTransfers(channel)))
+      order.emplace_back(transfer.cycle, idx, seq);
+  }
+  llvm::sort(order);
+  DenseMap<TokenRef, unsigned> tokenIDs;
+  for (auto [id, cycleChannelSeq] : llvm::enumerate(order)) {
+    auto [_, idx, seq] = cycleChannelSeq;
+    tokenIDs[{channels[idx], seq}] = id;
+  }
+
+  DenseMap<TokenRef, SmallVector<TokenRef>> parents;
+  for (Operation &op : funcOp.getOps())
+    inferParents(&op, parents);
+
+  DenseMap<Value, ChannelEndpoints> endpoints;
+  for (Value channel : channels)
+    endpoints.try_emplace(channel, channel);
+
+  os << "id, cycle, src_component, src_port, dst_component, dst_port, seq, "
+        "data, parents\n";
+  for (auto [id, cycleChannelSeq] : llvm::enumerate(order)) {
+    auto [cycle, idx, seq] = cycleChannelSeq;
+    Value channel = channels[idx];
+    const ChannelEndpoints &ends = endpoints.at(channel);
+    os << id << ", " << cycle << ", " << ends.srcComponent << ", "
+       << ends.srcPort << ", " << ends.dstComponent << ", " << ends.dstPort
+       << ", " << seq << ", " << getTransfers(channel)[seq].data << ", ";
+    auto it = parents.find({channel, seq});
+    if (it != parents.end()) {
+      llvm::interleave(
+          it->second, os,
+          [&](TokenRef parent) { os << tokenIDs.at(parent); }, " ");
+    }
+    os << "\n";
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// TokenLineage
+//===----------------------------------------------------------------------===//
+
+/// Number of comma-separated fields on each line of a lineage CSV.
+static constexpr unsigned NUM_FIELDS = 9;
+
+/// Returns the key identifying a channel by its producer.
+static std::string getChannelKey(StringRef srcComponent, unsigned srcPort) {
+  return srcComponent.str() + ":" + std::to_string(srcPort);
+}
+
+LogicalResult TokenLineage::parseFromFile(StringRef filepath) {
+  auto fileOrErr = MemoryBuffer::getFile(filepath);
+  if (std::error_code error = fileOrErr.getError()) {
+    llvm::errs() << "Failed to open lineage file @ \"" << filepath
+                 << "\": " << error.message() << "\n";
+    return failure();
+  }
+
+  tokens.clear();
+  tokensByChannel.clear();
+
+  SmallVector<StringRef> lines;
+  (*fileOrErr)->getBuffer().split(lines, '\n', -1, false);
+  for (auto [lineIdx, line] : llvm::enumerate(lines)) {
+    auto error = [&](const Twine &msg) -> LogicalResult {
+      llvm::errs() << filepath << ":" << lineIdx + 1 << ": " << msg << "\n";
+      return failure();
+    };
+
+    // Skip the header
+    if (lineIdx == 0 && line.starts_with("id"))
+      continue;
+    line = line.trim();
+    if (line.empty())
+      continue;
+
+    SmallVector<StringRef> fields;
+    line.split(fields, ',');
+    if (fields.size() != NUM_FIELDS) {
+      return error("expected " + Twine(NUM_FIELDS) + " fields, but got " +
+                   Twine(fields.size()));
+    }
+    for (StringRef &field : fields)
+      field = field.trim();
+
+    Token &token = tokens.emplace_back();
+    if (fields[0].getAsInteger(10, token.id) || token.id != tokens.size() - 1)
+      return error("expected token ID " + Twine(tokens.size() - 1));
+    if (fields[1].getAsInteger(10, token.cycle))
+      return error("expected integer cycle, but got " + fields[1]);
+    token.channel.srcComponent = fields[2].str();
+    if (fields[3].getAsInteger(10, token.channel.srcPort))
+      return error("expected integer source port, but got " + fields[3]);
+    token.channel.dstComponent = fields[4].str();
+    if (fields[5].getAsInteger(10, token.channel.dstPort))
+      return error("expected integer destination port, but got " + fields[5]);
+    if (fields[6].getAsInteger(10, token.seq))
+      return error("expected integer sequence number, but got " + fields[6]);
+    token.data = fields[7].str();
+
+    SmallVector<StringRef> parentIDs;
+    fields[8].split(parentIDs, ' ', -1, false);
+    for (StringRef parentID : parentIDs) {
+      unsigned parent;
+      if (parentID.getAsInteger(10, parent))
+        return error("expected integer parent ID, but got " + parentID);
+      token.parents.push_back(parent);
+    }
+
+    SmallVector<unsigned> &channelTokens = tokensByChannel[getChannelKey(
+        token.channel.srcComponent, token.channel.srcPort)];
+    if (token.seq != channelTokens.size()) {
+      return error("expected sequence number " + Twine(channelTokens.size()) +
+                   " on channel, but got " + Twine(token.seq));
+    }
+    channelTokens.push_back(token.id);
+  }
+
+  // Link tokens to their children once all tokens are known
+  for (Token &token : tokens) {
+    for (unsigned parent : token.parents) {
+      if (parent >= tokens.size()) {
+        llvm::errs() << filepath << ": token " << token.id
+                     << " has unknown parent " << parent << "\n";
+        return failure();
+      }
+      tokens[parent].children.push_back(token.id);
+    }
+  }
+  return success();
+}
+
+const TokenLineage::Token *TokenLineage::getToken(unsigned id) const {
+  if (id < tokens.size())
+    return &tokens[id];
+  return nullptr;
+}
+
+const TokenLineage::Token *TokenLineage::getToken(StringRef srcComponent,
+                                                  unsigned srcPort,
+                                                  unsigned seq) const {
+  auto it = tokensByChannel.find(getChannelKey(srcComponent, srcPort));
+  if (it == tokensByChannel.end() || seq >= it->second.size())
+    return nullptr;
+  return &tokens[it->second[seq]];
+}
+
+std::vector<TokenLineage::SliceEntry>
+TokenLineage::getSlice(const Token &token, Direction direction,
+                       std::optional<unsigned> maxDepth) const {
+  std::vector<SliceEntry> slice;
+  DenseSet<unsigned> visited;
+  std::deque<SliceEntry> queue;
+  queue.push_back({&token, 0});
+  visited.insert(token.id);
+  while (!queue.empty()) {
+    SliceEntry entry = queue.front();
+    queue.pop_front();
+    slice.push_back(entry);
+    auto [current, depth] = entry;
+    if (maxDepth && depth >= *maxDepth)
+      continue;
+
+    ArrayRef<unsigned> next = direction == Direction::BACKWARD
+                                  ? current->parents
+                                  : current->children;
+    for (unsigned id : next) {
+      if (visited.insert(id).second)
+        queue.push_back({&tokens[id], depth + 1});
+    }
+  }
+  return slice;
+}
@@ -22,6 +22,7 @@
 #include "dynamatic/Dialect/Handshake/MemoryInterfaces.h"
 #include "dynamatic/Support/Attribute.h"
 #include "dynamatic/Support/Backedge.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "dynamatic/Support/RTL/RTL.h"
 #include "dynamatic/Support/Utils/Utils.h"
 #include "dynamatic/Transforms/HandshakeMaterialize.h"
@@ -430,7 +431,8 @@ public:
       unsigned int resultIdx = 0;
       auto modType = mlir::cast<hw::HWModuleExternOp>(extModOp).getModuleType();
       for (const hw::ModulePort &port : modType.getPorts()) {
-        if (port.name == "clk" || port.name == "rst")
+        if (port.name == "clk" || port.name == "rst" ||
+            port.name == "ins_clk" || port.name == "outs_clk")
           continue;
         if (port.dir == hw::ModulePort::Direction::Input) {
           if (operandIdx >= op->getNumOperands()) {
@@ -594,6 +596,12 @@ ModuleDiscriminator::ModuleDiscriminator(Operation *op) {
         // Bitwidth
         addType("DATA_TYPE", op->getOperand(0));
       })
+      .Case<handshake::ClockCrossingOp>(
+          [&](handshake::ClockCrossingOp crossingOp) {
+            // Bitwidth and number of slots
+            addType("DATA_TYPE", crossingOp.getOperand());
+            addUnsigned("NUM_SLOTS", crossingOp.getNumSlots());
+          })
       .Case<handshake::BufferOp>([&](handshake::BufferOp bufferOp) {
         // Bitwidth
         addType("DATA_TYPE", bufferOp.getOperand());
@@ -763,6 +771,20 @@ ModuleDiscriminator::ModuleDiscriminator(Operation *op) {
       .Case<handshake::ReadyRemoverOp, handshake::ValidMergerOp>([&](auto) {
         // No parameters needed for these operations
       })
+      .Case<handshake::TaggerOp, handshake::UntaggerOp>([&](auto taggingOp) {
+        // Number of tags and bitwidth of each data channel. Data channels may
+        // have different bitwidths, so these are encoded as a space-separated
+        // string and passed to the generator.
+        addUnsigned("NUM_TAGS", taggingOp.getNumTags());
+        std::string bitwidths;
+        for (auto [idx, oprd] : llvm::enumerate(taggingOp.getDataOperands())) {
+          if (idx > 0)
+            bitwidths += " ";
+          bitwidths += std::to_string(
+              handshake::getHandshakeTypeBitWidth(oprd.getType()));
+        }
+        addString("BITWIDTHS", bitwidths);
+      })
       .Case<handshake::RAMOp>([&](handshake::RAMOp ramOp) {
         MemRefType resType = ramOp.getResult().getType();
         addUnsigned("DATA_WIDTH", resType.getElementTypeBitWidth());
@@ -792,6 +814,7 @@ ModuleDiscriminator::ModuleDiscriminator(Operation *op) {
       return;
     }
     addUnsigned("LATENCY", latency.value());
+    addUnsigned("II", latencyInterface.getInitiationInterval());
   }
 }
 
@@ -990,8 +1013,8 @@ public:
 
   /// Adds clock and reset ports from the parent module to the future external
   /// module's input port information and to the operands to the future
-  /// hardware instance.
-  void addClkAndRst(hw::HWModuleOp modOp);
+  /// hardware instance. The clock is the one of the given clock domain.
+  void addClkAndRst(hw::HWModuleOp modOp, unsigned domain = 0);
 
   /// Creates the instance using all the inputs added so far as operands. If no
   /// external module matching the current port information currently exists,
@@ -1036,6 +1059,9 @@ public:
     hw::InstanceOp instOp = createInstanceFromOp(opToConvert, rewriter);
     if (!instOp)
       return nullptr;
+    // The backend checks narrowing truncations at runtime
+    if (Attribute narrowing = opToConvert->getAttr(NARROWING_ATTR_NAME))
+      instOp->setAttr(NARROWING_ATTR_NAME, narrowing);
     rewriter.replaceOp(opToConvert, instOp);
     return instOp;
   }
@@ -1130,14 +1156,28 @@ static std::pair<Value, Value> getClkAndRst(hw::HWModuleOp hwModOp) {
   return {blockArgs.drop_back().back(), blockArgs.back()};
 }
 
-void HWBuilder::addClkAndRst(hw::HWModuleOp hwModOp) {
+/// Returns the module input holding the clock of the given clock domain. The
+/// main clock is the module's clock input, and each additional clock domain's
+/// clock is a module input named after the domain.
+static Value getDomainClock(hw::HWModuleOp hwModOp, unsigned domain) {
+  if (domain == 0)
+    return getClkAndRst(hwModOp).first;
+  std::string clkName = getClockPortName(domain);
+  hw::ModuleType modType = hwModOp.getModuleType();
+  for (unsigned i = 0, e = hwModOp.getNumInputPorts(); i < e; ++i) {
+    if (modType.getInputName(i) == clkName)
+      return hwModOp.getBodyBlock()->getArgument(i);
+  }
+  llvm_unreachable("module has no clock for the clock domain");
+}
+
+void HWBuilder::addClkAndRst(hw::HWModuleOp hwModOp, unsigned domain) {
   // Let the parent class add clock and reset to the input ports
   modBuilder.addClkAndRst();
 
   // Add clock and reset to the instance's operands
-  auto [clkVal, rstVal] = getClkAndRst(hwModOp);
-  instOperands.push_back(clkVal);
-  instOperands.push_back(rstVal);
+  instOperands.push_back(getDomainClock(hwModOp, domain));
+  instOperands.push_back(getClkAndRst(hwModOp).second);
 }
 
 hw::InstanceOp HWBuilder::createInstance(ModuleDiscriminator &discriminator,
@@ -1223,6 +1263,12 @@ static hw::ModulePortInfo getFuncPortInfo(handshake::FuncOp funcOp,
       modBuilder.addInput(portNames.getInputName(idx), lowerType(type));
   }
 
+  // Add one clock input per additional clock domain
+  Type i1Type = IntegerType::get(funcOp.getContext(), 1);
+  unsigned numDomains = getClockPeriodRatios(funcOp).size();
+  for (unsigned domain = 1; domain < numDomains; ++domain)
+    modBuilder.addInput(getClockPortName(domain), i1Type);
+
   modBuilder.addClkAndRst();
   return modBuilder.getPortInfo();
 }
@@ -1332,7 +1378,9 @@ ConvertFunc::matchAndRewrite(handshake::FuncOp funcOp, OpAdaptor adaptor,
   Block *funcBlock = funcOp.getBodyBlock();
   Block *modBlock = modOp.getBodyBlock();
   Operation *termOp = modBlock->getTerminator();
-  ValueRange modBlockArgs = modBlock->getArguments().drop_back(2);
+  // Drop the clock of each clock domain and the reset
+  unsigned numClocks = getClockPeriodRatios(funcOp).size();
+  ValueRange modBlockArgs = modBlock->getArguments().drop_back(numClocks + 1);
   rewriter.inlineBlockBefore(funcBlock, termOp, modBlockArgs);
   rewriter.eraseOp(funcOp);
 
@@ -1661,7 +1709,8 @@ LogicalResult ConvertToHWInstance<T>::matchAndRewrite(
   // Add all operation operands to the inputs
   for (auto [idx, oprd] : llvm::enumerate(adaptor.getOperands()))
     converter.addInput(portNames.getInputName(idx), oprd);
-  converter.addClkAndRst(((Operation *)op)->getParentOfType<hw::HWModuleOp>());
+  converter.addClkAndRst(((Operation *)op)->getParentOfType<hw::HWModuleOp>(),
+                         getClockDomain(op));
 
   // Add all operation results to the outputs
   for (auto [idx, type] : llvm::enumerate(op->getResultTypes()))
@@ -1673,6 +1722,44 @@ LogicalResult ConvertToHWInstance<T>::matchAndRewrite(
 
 namespace {
 
+/// Converts a clock domain crossing to an equivalent HW instance whose input
+/// and output sides are clocked by the clocks of the crossing's source and
+/// destination clock domains, respectively.
+class ConvertClockCrossing
+    : public OpConversionPattern<handshake::ClockCrossingOp> {
+public:
+  using OpConversionPattern<handshake::ClockCrossingOp>::OpConversionPattern;
+  using OpAdaptor = typename handshake::ClockCrossingOp::Adaptor;
+
+  /// Always succeeds in replacing the matched operation with an equivalent
+  /// HW instance operation, potentially creating an external HW module in
+  /// the process.
+  LogicalResult
+  matchAndRewrite(handshake::ClockCrossingOp crossingOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override;
+};
+} // namespace
+
+LogicalResult ConvertClockCrossing::matchAndRewrite(
+    handshake::ClockCrossingOp crossingOp, OpAdaptor adaptor,
+    ConversionPatternRewriter &rewriter) const {
+  HWConverter converter(getContext());
+  auto parentModOp = crossingOp->getParentOfType<hw::HWModuleOp>();
+
+  converter.addInput("ins", adaptor.getOperand());
+  converter.addInput("ins_clk",
+                     getDomainClock(parentModOp, crossingOp.getSrcDomain()));
+  converter.addInput("outs_clk",
+                     getDomainClock(parentModOp, crossingOp.getDstDomain()));
+  converter.addInput(RST_PORT, getClkAndRst(parentModOp).second);
+  converter.addOutput("outs", lowerType(crossingOp.getResult().getType()));
+
+  hw::InstanceOp instOp = converter.convertToInstance(crossingOp, rewriter);
+  return instOp ? success() : failure();
+}
+
+namespace {
+
 /// Converts a Handshake-level instance operation to an equivalent HW-level one.
 /// The pattern assumes that the module the Handshake instance references has
 /// already been converted to a `hw::HWExternModuleOp`.
@@ -2235,7 +2322,14 @@ public:
         ConvertToHWInstance<handshake::SpecSaveCommitOp>,
         ConvertToHWInstance<handshake::SpeculatorOp>,
         ConvertToHWInstance<handshake::SpeculatingBranchOp>,
-        ConvertToHWInstance<handshake::NonSpecOp>
+        ConvertToHWInstance<handshake::NonSpecOp>,
+
+        // Out-of-order execution operations
+        ConvertToHWInstance<handshake::TaggerOp>,
+        ConvertToHWInstance<handshake::UntaggerOp>,
+
+        // Clock domain crossings
+        ConvertClockCrossing
         // clang-format on
         >(typeConverter, funcOp->getContext());
 
@@ -41,6 +41,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include <cassert>
 
 using namespace mlir;
@@ -1659,6 +1660,102 @@ LogicalResult EndOp::verify() {
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// TaggerOp
+//===----------------------------------------------------------------------===//
+
+IntegerType TaggerOp::getTagType(MLIRContext *ctx, unsigned numTags) {
+  return IntegerType::get(ctx, llvm::Log2_32_Ceil(numTags));
+}
+
+Type TaggerOp::getTaggedType(Type type, unsigned numTags) {
+  auto extraType = cast<ExtraSignalsTypeInterface>(type);
+  SmallVector<ExtraSignal> extraSignals(extraType.getExtraSignals());
+  extraSignals.emplace_back(TAG_SIGNAL_NAME,
+                            getTagType(type.getContext(), numTags));
+  return extraType.copyWithExtraSignals(extraSignals);
+}
+
+Type TaggerOp::getUntaggedType(Type type) {
+  auto extraType = cast<ExtraSignalsTypeInterface>(type);
+  SmallVector<ExtraSignal> extraSignals;
+  for (const ExtraSignal &extra : extraType.getExtraSignals()) {
+    if (extra.name != TAG_SIGNAL_NAME)
+      extraSignals.push_back(extra);
+  }
+  return extraType.copyWithExtraSignals(extraSignals);
+}
+
+/// Verifies that the number of tags of a tagger or untagger is a power of two
+/// greater than one, and that each untagged type is the tagged type without
+/// its tag.
+static LogicalResult verifyTaggingOp(Operation *op, unsigned numTags,
+                                     TypeRange untaggedTypes,
+                                     TypeRange taggedTypes) {
+  if (numTags < 2 || !llvm::isPowerOf2_32(numTags)) {
+    return op->emitError() << "number of tags must be a power of two greater "
+                              "than one, but got "
+                           << numTags;
+  }
+  if (untaggedTypes.size() != taggedTypes.size()) {
+    return op->emitError() << "expected as many data results as data operands, "
+                              "but got "
+                           << untaggedTypes.size() << " and "
+                           << taggedTypes.size();
+  }
+  for (auto [idx, types] :
+       llvm::enumerate(llvm::zip_equal(untaggedTypes, taggedTypes))) {
+    auto &[untagged, tagged] = types;
+    if (cast<ExtraSignalsTypeInterface>(untagged).hasExtraSignal(
+            TaggerOp::TAG_SIGNAL_NAME)) {
+      return op->emitError() << "untagged channel " << idx
+                             << " must not carry a tag, but got " << untagged;
+    }
+    Type expected = TaggerOp::getTaggedType(untagged, numTags);
+    if (tagged != expected) {
+      return op->emitError() << "tagged channel " << idx << "'s type must be "
+                             << expected << ", but got " << tagged;
+    }
+  }
+  return success();
+}
+
+LogicalResult TaggerOp::verify() {
+  return verifyTaggingOp(*this, getNumTags(), getDataOperands().getTypes(),
+                         getDataResults().getTypes());
+}
+
+//===----------------------------------------------------------------------===//
+// UntaggerOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult UntaggerOp::verify() {
+  return verifyTaggingOp(*this, getNumTags(), getDataResults().getTypes(),
+                         getDataOperands().getTypes());
+}
+
+//===----------------------------------------------------------------------===//
+// ClockCrossingOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult ClockCrossingOp::verify() {
+  unsigned numSlots = getNumSlots();
+  if (numSlots < 2 || !llvm::isPowerOf2_32(numSlots)) {
+    return emitError() << "number of slots must be a power of two greater "
+                          "than one, but got "
+                       << numSlots;
+  }
+  if (getSrcDomain() == getDstDomain()) {
+    return emitError() << "source and destination clock domains must differ, "
+                          "but both are "
+                       << getSrcDomain();
+  }
+  if (cast<ExtraSignalsTypeInterface>(getOperand().getType())
+          .getNumExtraSignals() != 0)
+    return emitError() << "crossing channel must not carry extra signals";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // BundleOp
 //===----------------------------------------------------------------------===//
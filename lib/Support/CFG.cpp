@@ -444,8 +444,9 @@ HandshakeCFG::getControlValues(DenseMap<unsigned, Value> &ctrlVals) {
     LogicalResult res =
         llvm::TypeSwitch<Operation *, LogicalResult>(ctrlOp)
             .Case<handshake::ForkOp, handshake::LazyForkOp, handshake::BufferOp,
-                  handshake::BranchOp, handshake::ConditionalBranchOp,
-                  handshake::MuxOp, handshake::MergeOp>([&](auto) {
+                  handshake::ClockCrossingOp, handshake::BranchOp,
+                  handshake::ConditionalBranchOp, handshake::MuxOp,
+                  handshake::MergeOp>([&](auto) {
               addToCtrlOps(ctrlOp->getUsers());
               return success();
             })
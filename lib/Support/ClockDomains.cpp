@@ -0,0 +1,83 @@
+//===- ClockDomains.cpp - Clock domains of Handshake functions --*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements helpers to interact with the clock domains of Handshake functions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Support/ClockDomains.h"
+#include "dynamatic/Support/RTL/RTL.h"
+#include "mlir/IR/BuiltinAttributes.h"
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+
+unsigned dynamatic::getClockDomain(Operation *op) {
+  if (auto domain = op->getAttrOfType<IntegerAttr>(CLOCK_DOMAIN_ATTR_NAME))
+    return domain.getUInt();
+  return 0;
+}
+
+void dynamatic::setClockDomain(Operation *op, unsigned domain) {
+  if (domain == 0) {
+    op->removeAttr(CLOCK_DOMAIN_ATTR_NAME);
+    return;
+  }
+  auto ui32 = IntegerType::get(op->getContext(), 32,
+                               IntegerType::SignednessSemantics::Unsigned);
+  op->setAttr(CLOCK_DOMAIN_ATTR_NAME, IntegerAttr::get(ui32, domain));
+}
+
+unsigned dynamatic::getChannelClockDomain(Value channel) {
+  Operation *defOp = channel.getDefiningOp();
+  if (!defOp)
+    return 0;
+  if (auto crossingOp = dyn_cast<handshake::ClockCrossingOp>(defOp))
+    return crossingOp.getDstDomain();
+  return getClockDomain(defOp);
+}
+
+SmallVector<double> dynamatic::getClockPeriodRatios(handshake::FuncOp funcOp) {
+  SmallVector<double> ratios{1.0};
+  if (auto ratiosAttr =
+          funcOp->getAttrOfType<ArrayAttr>(CLOCK_RATIOS_ATTR_NAME)) {
+    for (auto ratio : ratiosAttr.getAsRange<FloatAttr>())
+      ratios.push_back(ratio.getValueAsDouble());
+  }
+  return ratios;
+}
+
+unsigned dynamatic::addClockDomain(handshake::FuncOp funcOp,
+                                   double periodRatio) {
+  SmallVector<Attribute> ratios;
+  if (auto ratiosAttr =
+          funcOp->getAttrOfType<ArrayAttr>(CLOCK_RATIOS_ATTR_NAME))
+    llvm::append_range(ratios, ratiosAttr.getValue());
+  Builder builder(funcOp.getContext());
+  ratios.push_back(builder.getF64FloatAttr(periodRatio));
+  funcOp->setAttr(CLOCK_RATIOS_ATTR_NAME, builder.getArrayAttr(ratios));
+  return ratios.size();
+}
+
+double dynamatic::getClockPeriodRatio(Operation *op) {
+  unsigned domain = getClockDomain(op);
+  if (domain == 0)
+    return 1.0;
+  auto funcOp = op->getParentOfType<handshake::FuncOp>();
+  assert(funcOp && "operation in clock domain must be inside a function");
+  SmallVector<double> ratios = getClockPeriodRatios(funcOp);
+  assert(domain < ratios.size() && "clock domain does not exist");
+  return ratios[domain];
+}
+
+std::string dynamatic::getClockPortName(unsigned domain) {
+  if (domain == 0)
+    return CLK_PORT.str();
+  return (CLK_PORT + "_" + Twine(domain)).str();
+}
@@ -573,6 +573,10 @@ double GurobiSolver::getObjective() const {
   return model->get(GRB_DoubleAttr_ObjVal);
 }
 
+void GurobiSolver::setStartValue(const CPVar &var, double value) {
+  variables.at(var).set(GRB_DoubleAttr_Start, value);
+}
+
 #endif // DYNAMATIC_GUROBI_NOT_INSTALLED
 
 // -------------------------------------------------------------
@@ -0,0 +1,300 @@
+//===- CostModel.cpp - Unified cost model for optimizations -----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the cost model shared by all optimization passes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Support/CostModel.h"
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Support/ClockDomains.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/FormatVariadic.h"
+#include <functional>
+#include <map>
+#include <memory>
+
+using namespace mlir;
+using namespace dynamatic;
+
+namespace {
+
+/// Owns all timing databases and cost models created in the process.
+struct CostModelRegistry {
+  /// Protects the registry against concurrent accesses.
+  std::mutex mutex;
+  /// Timing databases, mapped from the path they were parsed from.
+  llvm::StringMap<std::unique_ptr<TimingDatabase>> databases;
+  /// Cost models, mapped from their timing database and target period.
+  std::map<std::pair<const TimingDatabase *, double>,
+           std::unique_ptr<CostModel>>
+      models;
+};
+
+} // namespace
+
+static CostModelRegistry &getRegistry() {
+  static CostModelRegistry registry;
+  return registry;
+}
+
+/// Returns the timing database parsed from the JSON file at the given path,
+/// parsing it if it is not yet in the registry. The registry's mutex must be
+/// held by the caller.
+static FailureOr<const TimingDatabase *>
+getOrLoadTimingDatabase(CostModelRegistry &registry, StringRef timingModels) {
+  if (auto it = registry.databases.find(timingModels);
+      it != registry.databases.end())
+    return it->second.get();
+
+  auto timingDB = std::make_unique<TimingDatabase>();
+  std::string path = timingModels.str();
+  if (failed(TimingDatabase::readFromJSON(path, *timingDB)))
+    return failure();
+  const TimingDatabase *db = timingDB.get();
+  registry.databases[timingModels] = std::move(timingDB);
+  return db;
+}
+
+FailureOr<const TimingDatabase *>
+CostModel::getTimingDatabase(StringRef timingModels) {
+  CostModelRegistry &registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return getOrLoadTimingDatabase(registry, timingModels);
+}
+
+FailureOr<CostModel *> CostModel::get(StringRef timingModels,
+                                      double targetPeriod) {
+  FailureOr<const TimingDatabase *> timingDB = getTimingDatabase(timingModels);
+  if (failed(timingDB))
+    return failure();
+  return &get(**timingDB, targetPeriod);
+}
+
+CostModel &CostModel::get(const TimingDatabase &timingDB,
+                          double targetPeriod) {
+  CostModelRegistry &registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::unique_ptr<CostModel> &model =
+      registry.models[{&timingDB, targetPeriod}];
+  if (!model)
+    model.reset(new CostModel(timingDB, targetPeriod));
+  return *model;
+}
+
+/// Returns the internal combinational delay identifying the implementation of
+/// the operation in its timing model. Iterative implementations are identified
+/// by their initiation interval, other implementations by the target period
+/// they are selected for.
+static std::optional<double> getImplDelay(Operation *op,
+                                          const TimingModel &model, int64_t ii,
+                                          double unitCP) {
+  const PathDepMetric &metric =
+      ii > 1 ? model.iiByPath : model.latAndMaxFreqByPath;
+  auto metricByBitwidth = metric.select(0);
+  if (failed(metricByBitwidth))
+    return std::nullopt;
+  auto metricByDelay = metricByBitwidth->get().select(op);
+  if (failed(metricByDelay))
+    return std::nullopt;
+
+  if (ii <= 1) {
+    FailureOr<double> delay = metricByDelay->get().selectDelay(unitCP);
+    if (failed(delay))
+      return std::nullopt;
+    return *delay;
+  }
+  for (const auto &[delay, iiValue] : metricByDelay->get().data) {
+    if (static_cast<int64_t>(iiValue) == ii)
+      return delay;
+  }
+  return std::nullopt;
+}
+
+/// Returns the area of an implementation of the unit at the given bitwidth, if
+/// its timing model characterizes it.
+static std::optional<double> getArea(const TimingModel &model,
+                                     unsigned bitwidth, double implDelay) {
+  auto areaByBitwidth = model.areaByPath.select(0);
+  if (failed(areaByBitwidth))
+    return std::nullopt;
+  auto areaByDelay = areaByBitwidth->get().select(bitwidth);
+  if (failed(areaByDelay))
+    return std::nullopt;
+  const std::map<double, double> &areas = areaByDelay->get().data;
+  if (auto it = areas.find(implDelay); it != areas.end())
+    return it->second;
+  return std::nullopt;
+}
+
+UnitCost CostModel::computeUnitCost(Operation *op, const TimingModel &model) {
+  // Units in a slower clock domain are implemented for that domain's period
+  double periodRatio = getClockPeriodRatio(op);
+  double unitCP = targetPeriod * periodRatio;
+
+  UnitCost cost;
+  if (auto latencyOp = dyn_cast<handshake::LatencyInterface>(op))
+    cost.ii = latencyOp.getInitiationInterval();
+  if (FailureOr<double> latency =
+          timingDB.getMainClockLatency(op, SignalType::DATA, targetPeriod);
+      succeeded(latency))
+    cost.latency = *latency;
+
+  double delay;
+  if (cost.latency == 0.0) {
+    if (succeeded(timingDB.getTotalDelay(op, SignalType::DATA, delay)))
+      cost.delay = delay / periodRatio;
+  } else {
+    if (succeeded(timingDB.getPortDelay(op, SignalType::DATA, PortType::IN,
+                                        delay)))
+      cost.inDelay = delay / periodRatio;
+    if (succeeded(timingDB.getPortDelay(op, SignalType::DATA, PortType::OUT,
+                                        delay)))
+      cost.outDelay = delay / periodRatio;
+  }
+
+  std::optional<double> implDelay = getImplDelay(op, model, cost.ii, unitCP);
+  if (!implDelay)
+    return cost;
+  if (cost.latency > 0.0)
+    cost.stageDelay = *implDelay / periodRatio;
+  cost.area = getArea(model, getOpDatawidth(op), *implDelay);
+  return cost;
+}
+
+std::optional<double>
+CostModel::getBufferSlotArea(const TimingDatabase &timingDB,
+                             handshake::BufferType bufferType,
+                             unsigned bitwidth) {
+  std::string key = ("handshake.buffer." + stringifyEnum(bufferType)).str();
+  const TimingModel *model = timingDB.getModel(key);
+  if (!model)
+    return std::nullopt;
+  return getArea(*model, bitwidth, 0.0);
+}
+
+UnitCost CostModel::getUnitCost(Operation *op) {
+  // Buffers have no timing model, their data path is either transparent or
+  // cut by their registers, and their area grows with their number of slots
+  if (auto bufferOp = dyn_cast<handshake::BufferOp>(op)) {
+    UnitCost cost;
+    if (!bufferOp.isBypassDV())
+      cost.latency = static_cast<double>(bufferOp.getLatencyDV());
+    if (std::optional<double> slotArea = getBufferSlotArea(
+            timingDB, bufferOp.getBufferType(), getOpDatawidth(op)))
+      cost.area = *slotArea * bufferOp.getNumSlots();
+    return cost;
+  }
+
+  // Clock domain crossings' latency depends on the function's clock domains
+  if (isa<handshake::ClockCrossingOp>(op)) {
+    UnitCost cost;
+    if (FailureOr<double> latency =
+            timingDB.getMainClockLatency(op, SignalType::DATA, targetPeriod);
+        succeeded(latency))
+      cost.latency = *latency;
+    return cost;
+  }
+
+  const TimingModel *model = timingDB.getModel(op);
+  if (!model) {
+    UnitCost cost;
+    if (auto latencyOp = dyn_cast<handshake::LatencyInterface>(op))
+      cost.ii = latencyOp.getInitiationInterval();
+    return cost;
+  }
+
+  // The latency of memory ports depends on the memory interface they connect
+  // to, so their cost cannot be shared with other ports of the same type
+  if (isa<handshake::LoadOp, handshake::StoreOp>(op))
+    return computeUnitCost(op, *model);
+
+  UnitCost cost;
+  int64_t ii = 1;
+  if (auto latencyOp = dyn_cast<handshake::LatencyInterface>(op))
+    ii = latencyOp.getInitiationInterval();
+  std::string key =
+      llvm::formatv("{0}|{1}|{2:f6}|{3}", TimingDatabase::getModelKey(op),
+                    getOpDatawidth(op), getClockPeriodRatio(op), ii);
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = unitCosts.find(key);
+    if (it == unitCosts.end())
+      it = unitCosts.insert({key, computeUnitCost(op, *model)}).first;
+    cost = it->second;
+  }
+
+  // Shifts by a constant amount are just wires
+  if (auto shiftOp = dyn_cast<handshake::ShiftLikeArithOpInterface>(op);
+      shiftOp && shiftOp.isShiftByConstant()) {
+    cost.delay = 0.0;
+    if (cost.area)
+      cost.area = 0.0;
+  }
+  return cost;
+}
+
+FuncCost CostModel::getFuncCost(handshake::FuncOp funcOp) {
+  FuncCost funcCost;
+  llvm::DenseMap<Operation *, UnitCost> costs;
+  for (Operation &op : funcOp.getOps()) {
+    UnitCost cost = getUnitCost(&op);
+    ++funcCost.numUnits;
+    if (cost.area)
+      funcCost.area += *cost.area;
+    else
+      ++funcCost.numUncharacterized;
+    costs.insert({&op, cost});
+  }
+
+  // Arrival time of data at each unit's output ports, relative to the last
+  // register it went through
+  llvm::DenseMap<Operation *, double> arrivals;
+  llvm::DenseSet<Operation *> visiting;
+  std::function<double(Operation *)> getArrival;
+
+  // Arrival time of data at the unit's input ports
+  auto getInputArrival = [&](Operation *op) -> double {
+    double arrival = 0.0;
+    for (Value operand : op->getOperands()) {
+      Operation *defOp = operand.getDefiningOp();
+      if (defOp && costs.count(defOp))
+        arrival = std::max(arrival, getArrival(defOp));
+    }
+    return arrival;
+  };
+
+  getArrival = [&](Operation *op) -> double {
+    if (auto it = arrivals.find(op); it != arrivals.end())
+      return it->second;
+    const UnitCost &cost = costs[op];
+    if (cost.latency > 0.0)
+      return arrivals[op] = cost.outDelay;
+    // Cut combinational cycles where we first detect them
+    if (!visiting.insert(op).second)
+      return 0.0;
+    double arrival = getInputArrival(op) + cost.delay;
+    visiting.erase(op);
+    return arrivals[op] = arrival;
+  };
+
+  for (Operation &op : funcOp.getOps()) {
+    const UnitCost &cost = costs[&op];
+    double pathDelay;
+    if (cost.latency > 0.0) {
+      pathDelay = std::max({getInputArrival(&op) + cost.inDelay, cost.outDelay,
+                            cost.stageDelay});
+    } else {
+      pathDelay = getArrival(&op);
+    }
+    funcCost.criticalPathDelay =
+        std::max(funcCost.criticalPathDelay, pathDelay);
+  }
+  return funcCost;
+}
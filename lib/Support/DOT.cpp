@@ -36,23 +36,30 @@ DOTGraph::Builder DOTGraph::getBuilder() { return Builder(*this); }
 
 SmallVector<const DOTGraph::Edge *>
 DOTGraph::getAdjacentEdges(const Node &node) const {
-  SmallVector<const Edge *> adjacentEdges;
-  const Node *nodeAddr = &node;
-
-  std::function<void(const Subgraph &)> addFromSubgraph =
-      [&](const Subgraph &subgraph) -> void {
-    for (const Edge *edge : subgraph.edges) {
-      if (edge->srcNode == nodeAddr || edge->dstNode == nodeAddr)
-        adjacentEdges.push_back(edge);
-    }
-    for (const Subgraph *subsub : subgraph.subgraphs)
-      addFromSubgraph(*subsub);
-  };
-
-  addFromSubgraph(root);
+  SmallVector<const Edge *> adjacentEdges(getPredecessors(node));
+  for (const Edge *edge : getSuccessors(node)) {
+    // Self-loops were already added as incoming edges
+    if (edge->dstNode != &node)
+      adjacentEdges.push_back(edge);
+  }
   return adjacentEdges;
 }
 
+bool DOTGraph::isInSubgraph(const Node &node, const Subgraph &subgraph) const {
+  for (const Subgraph *sub = node.subgraph; sub; sub = sub->parent) {
+    if (sub == &subgraph)
+      return true;
+  }
+  return false;
+}
+
+/// Removes the first occurence of an element from a vector, if present.
+template <typename Vector, typename T>
+static void eraseFrom(Vector &vec, const T &elem) {
+  if (auto it = llvm::find(vec, elem); it != vec.end())
+    vec.erase(it);
+}
+
 bool DOTGraph::WithAttributes::addAttr(const Twine &name, const Twine &value) {
   std::string nameStr = name.str();
   if (auto it = attrs.find(nameStr); it != attrs.end()) {
@@ -107,6 +114,7 @@ DOTGraph::Edge &DOTGraph::Builder::addEdge(StringRef srcID, StringRef dstID,
   auto *edge = new DOTGraph::Edge(srcNode, dstNode, subgraph);
   subgraph.edges.push_back(edge);
   graph.successors[&srcNode].push_back(edge);
+  graph.predecessors[&dstNode].push_back(edge);
   return *edge;
 }
 
@@ -114,9 +122,49 @@ DOTGraph::Subgraph &DOTGraph::Builder::addSubgraph(StringRef id,
                                                    Subgraph &subgraph) {
   auto *subsub = new DOTGraph::Subgraph(id, &subgraph);
   subgraph.subgraphs.push_back(subsub);
+  if (!id.empty())
+    graph.subgraphsByID.try_emplace(id, subsub);
   return *subsub;
 }
 
+void DOTGraph::Builder::removeEdge(const Edge &edge) {
+  eraseFrom(graph.successors[edge.srcNode], &edge);
+  eraseFrom(graph.predecessors[edge.dstNode], &edge);
+
+  // The subgraph owns the edge
+  std::vector<Edge *> &edges = edge.subgraph->edges;
+  auto it = llvm::find(edges, &edge);
+  assert(it != edges.end() && "edge not owned by its subgraph");
+  Edge *ownedEdge = *it;
+  edges.erase(it);
+  delete ownedEdge;
+}
+
+DOTGraph::Node *DOTGraph::Builder::detachNode(const Node &node) {
+  // Nodes that were only ever used by edges are not owned by any subgraph yet
+  earlyNodes.erase(node.id);
+  eraseFrom(node.subgraph->nodes, &node);
+  return graph.nodesByID.lookup(node.id);
+}
+
+void DOTGraph::Builder::removeNode(const Node &node) {
+  // Copy the adjacent edges since removing them invalidates the indices
+  for (const Edge *edge : graph.getAdjacentEdges(node))
+    removeEdge(*edge);
+  graph.successors.erase(&node);
+  graph.predecessors.erase(&node);
+
+  Node *ownedNode = detachNode(node);
+  graph.nodesByID.erase(ownedNode->id);
+  delete ownedNode;
+}
+
+void DOTGraph::Builder::moveNode(const Node &node, Subgraph &subgraph) {
+  Node *ownedNode = detachNode(node);
+  ownedNode->subgraph = &subgraph;
+  subgraph.nodes.push_back(ownedNode);
+}
+
 DOTGraph::Node &DOTGraph::Builder::getOrAddNode(StringRef id,
                                                 Subgraph &subgraph) {
   if (auto srcNodeIt = graph.nodesByID.find(id.str());
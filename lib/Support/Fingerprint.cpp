@@ -0,0 +1,238 @@
+//===- Fingerprint.cpp - Structural fingerprints of functions ---*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements structural fingerprints of functions and of their basic blocks.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Support/Fingerprint.h"
+#include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/JSON/JSON.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::json;
+namespace ljson = llvm::json;
+
+StableIRRefs::StableIRRefs(Operation *funcOp) {
+  // Operations of Handshake functions are grouped in logical basic blocks,
+  // whereas CF-level functions use actual blocks
+  bool useLogicBBs = isa<handshake::FuncOp>(funcOp);
+
+  std::map<std::optional<unsigned>, unsigned> numOpsPerBlock;
+  for (auto [blockIdx, block] : llvm::enumerate(funcOp->getRegion(0))) {
+    blockIndices[&block] = blockIdx;
+    for (Operation &op : block) {
+      std::optional<unsigned> bb =
+          useLogicBBs ? getLogicBB(&op) : std::optional<unsigned>(blockIdx);
+      positions[&op] = {bb, numOpsPerBlock[bb]++};
+    }
+  }
+}
+
+std::optional<unsigned> StableIRRefs::getBlock(Operation *op) const {
+  if (auto it = positions.find(op); it != positions.end())
+    return it->second.first;
+  return std::nullopt;
+}
+
+std::string StableIRRefs::getRef(Operation *op) const {
+  // Operations nested inside other operations are not indexed
+  auto it = positions.find(op);
+  if (it == positions.end())
+    return "?";
+  auto [bb, idx] = it->second;
+  return (bb ? std::to_string(*bb) : "x") + "." + std::to_string(idx);
+}
+
+std::string StableIRRefs::getRef(Value val) const {
+  if (auto arg = dyn_cast<BlockArgument>(val)) {
+    auto it = blockIndices.find(arg.getOwner());
+    if (it == blockIndices.end())
+      return "?";
+    return "arg" + std::to_string(it->second) + "." +
+           std::to_string(arg.getArgNumber());
+  }
+  OpResult res = cast<OpResult>(val);
+  return getRef(res.getOwner()) + "#" + std::to_string(res.getResultNumber());
+}
+
+std::string StableIRRefs::getRef(OpOperand &operand) const {
+  return getRef(operand.getOwner()) + "@" +
+         std::to_string(operand.getOperandNumber());
+}
+
+std::string StableIRRefs::getRef(Block *block) const {
+  auto it = blockIndices.find(block);
+  if (it == blockIndices.end())
+    return "^?";
+  return "^" + std::to_string(it->second);
+}
+
+/// Writes a description of the operation's structure to the stream. Operation
+/// names are left out since they are assigned function-wide and would make
+/// unrelated basic blocks look modified.
+static void describeOp(Operation *op, const StableIRRefs &refs,
+                       llvm::raw_ostream &os) {
+  os << op->getName() << "(";
+  llvm::interleaveComma(op->getOperands(), os,
+                        [&](Value operand) { os << refs.getRef(operand); });
+  os << ")";
+  if (op->getNumSuccessors() != 0) {
+    os << "[";
+    llvm::interleaveComma(op->getSuccessors(), os,
+                          [&](Block *succ) { os << refs.getRef(succ); });
+    os << "]";
+  }
+  os << "{";
+  for (NamedAttribute attr : op->getAttrs()) {
+    if (attr.getName() != NameAnalysis::ATTR_NAME)
+      os << attr.getName().getValue() << "=" << attr.getValue() << ";";
+  }
+  os << "}:";
+  llvm::interleaveComma(op->getResultTypes(), os);
+  for (Region &region : op->getRegions()) {
+    os << "{";
+    for (Block &block : region) {
+      os << "^(";
+      llvm::interleaveComma(block.getArgumentTypes(), os);
+      os << ")";
+      for (Operation &nestedOp : block)
+        describeOp(&nestedOp, refs, os);
+    }
+    os << "}";
+  }
+  os << "\n";
+}
+
+/// Returns the 64-bit fingerprint computed by the hasher.
+static uint64_t getFingerprint(llvm::MD5 &hasher) {
+  llvm::MD5::MD5Result result;
+  hasher.final(result);
+  return result.low();
+}
+
+FuncFingerprint FuncFingerprint::get(Operation *funcOp,
+                                     const StableIRRefs &refs) {
+  // Operations outside of all basic blocks and the function's signature only
+  // contribute to the function's fingerprint
+  llvm::MD5 funcHasher;
+  std::map<unsigned, llvm::MD5> blockHashers;
+  if (Attribute funcType = funcOp->getAttr("function_type")) {
+    std::string desc;
+    llvm::raw_string_ostream descStream(desc);
+    descStream << funcType << "\n";
+    funcHasher.update(descStream.str());
+  }
+
+  for (Block &block : funcOp->getRegion(0)) {
+    for (Operation &op : block) {
+      std::string desc;
+      llvm::raw_string_ostream descStream(desc);
+      describeOp(&op, refs, descStream);
+      descStream.flush();
+      if (std::optional<unsigned> bb = refs.getBlock(&op))
+        blockHashers[*bb].update(desc);
+      else
+        funcHasher.update(desc);
+    }
+  }
+
+  FuncFingerprint fingerprint;
+  for (auto &[bb, hasher] : blockHashers) {
+    uint64_t blockFingerprint = getFingerprint(hasher);
+    fingerprint.blocks[bb] = blockFingerprint;
+    funcHasher.update(std::to_string(bb) + ":" +
+                      llvm::utohexstr(blockFingerprint) + "\n");
+  }
+  fingerprint.func = getFingerprint(funcHasher);
+  return fingerprint;
+}
+
+std::set<unsigned>
+FuncFingerprint::getModifiedBlocks(const FuncFingerprint &prior) const {
+  std::set<unsigned> modified;
+  for (auto [bb, blockFingerprint] : blocks) {
+    auto it = prior.blocks.find(bb);
+    if (it == prior.blocks.end() || it->second != blockFingerprint)
+      modified.insert(bb);
+  }
+  return modified;
+}
+
+std::string dynamatic::getBlockList(const std::set<unsigned> &blocks) {
+  std::string list;
+  llvm::raw_string_ostream os(list);
+  llvm::interleaveComma(blocks, os, [&](unsigned bb) { os << "bb" << bb; });
+  return os.str();
+}
+
+/// Deserializes a fingerprint from its hexadecimal representation.
+static bool fingerprintFromJSON(const ljson::Value &value,
+                                uint64_t &fingerprint, ljson::Path path) {
+  std::optional<StringRef> hex = value.getAsString();
+  if (!hex) {
+    path.report(ERR_EXPECTED_STRING);
+    return false;
+  }
+  if (hex->getAsInteger(16, fingerprint)) {
+    path.report("expected hexadecimal fingerprint");
+    return false;
+  }
+  return true;
+}
+
+ljson::Value dynamatic::toJSON(const FuncFingerprint &fingerprint) {
+  ljson::Object blocks;
+  for (auto [bb, blockFingerprint] : fingerprint.blocks)
+    blocks[std::to_string(bb)] = llvm::utohexstr(blockFingerprint);
+  return ljson::Object{
+      {"function", llvm::utohexstr(fingerprint.func)},
+      {"blocks", std::move(blocks)},
+  };
+}
+
+bool dynamatic::fromJSON(const ljson::Value &value,
+                         FuncFingerprint &fingerprint, ljson::Path path) {
+  const ljson::Object *object = value.getAsObject();
+  if (!object) {
+    path.report(ERR_EXPECTED_OBJECT);
+    return false;
+  }
+  const ljson::Value *func = object->get("function");
+  if (!func) {
+    path.field("function").report(ERR_MISSING_VALUE);
+    return false;
+  }
+  if (!fingerprintFromJSON(*func, fingerprint.func, path.field("function")))
+    return false;
+
+  const ljson::Object *blocks = object->getObject("blocks");
+  if (!blocks) {
+    path.field("blocks").report(ERR_EXPECTED_OBJECT);
+    return false;
+  }
+  ljson::Path blocksPath = path.field("blocks");
+  for (const auto &[bbKey, blockValue] : *blocks) {
+    unsigned bb;
+    if (StringRef(bbKey).getAsInteger(10, bb)) {
+      blocksPath.field(bbKey).report("expected basic block number");
+      return false;
+    }
+    if (!fingerprintFromJSON(blockValue, fingerprint.blocks[bb],
+                             blocksPath.field(bbKey)))
+      return false;
+  }
+  return true;
+}
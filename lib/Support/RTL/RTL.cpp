@@ -22,6 +22,7 @@
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
@@ -174,6 +175,40 @@ ParamMatch RTLRequestFromOp::matchParameter(const RTLParameter &param) const {
   return ParamMatch::success(serialized);
 }
 
+void RTLRequestFromOp::getMismatches(
+    const RTLComponent &component,
+    SmallVectorImpl<std::string> &reasons) const {
+  if (name != component.getName()) {
+    reasons.push_back("component is named \"" + component.getName().str() +
+                      "\", expected \"" + name + "\"");
+    return;
+  }
+
+  for (const RTLParameter *parameter : component.getParameters()) {
+    std::string reason;
+    llvm::raw_string_ostream os(reason);
+    os << "parameter \"" << parameter->getName() << "\" ";
+    switch (matchParameter(*parameter).state) {
+    case ParamMatch::State::DOES_NOT_EXIST:
+      os << "is missing";
+      break;
+    case ParamMatch::State::FAILED_VERIFICATION:
+      os << "has value " << getParameter(*parameter)
+         << ", which violates constraints (";
+      parameter->getType().printConstraints(os);
+      os << ")";
+      break;
+    case ParamMatch::State::FAILED_SERIALIZATION:
+      os << "has value " << getParameter(*parameter)
+         << ", which cannot be serialized";
+      break;
+    case ParamMatch::State::SUCCESS:
+      continue;
+    }
+    reasons.push_back(os.str());
+  }
+}
+
 LogicalResult
 RTLRequestFromOp::paramsToJSON(const llvm::Twine &filepath) const {
   return serializeToJSON(parameters, filepath.str(), loc);
@@ -303,6 +338,7 @@ LogicalResult RTLMatch::registerBitwidthParameter(hw::HWModuleExternOp &modOp,
       handshakeOp == "handshake.addi" ||
       handshakeOp == "handshake.andi" ||
       handshakeOp == "handshake.buffer" ||
+      handshakeOp == "handshake.clock_crossing" ||
       handshakeOp == "handshake.cmpi" ||
       handshakeOp == "handshake.fork" ||
       handshakeOp == "handshake.lazy_fork" ||
@@ -410,7 +446,9 @@ LogicalResult RTLMatch::registerBitwidthParameter(hw::HWModuleExternOp &modOp,
              handshakeOp == "handshake.extf" ||
              handshakeOp == "handshake.maximumf" ||
              handshakeOp == "handshake.minimumf" ||
-             handshakeOp == "handshake.join") {
+             handshakeOp == "handshake.join" ||
+             handshakeOp == "handshake.tagger" ||
+             handshakeOp == "handshake.untagger") {
     // Skip
   } else if (handshakeOp == "handshake.ram") {
     // NOTE: this port order is currently hardcoded in HandshakeToHW.cpp
@@ -441,6 +479,7 @@ RTLMatch::registerExtraSignalParameters(hw::HWModuleExternOp &modOp,
       handshakeOp == "handshake.addi" ||
       handshakeOp == "handshake.andi" ||
       handshakeOp == "handshake.buffer" ||
+      handshakeOp == "handshake.clock_crossing" ||
       handshakeOp == "handshake.cmpf" ||
       handshakeOp == "handshake.cmpi" ||
       handshakeOp == "handshake.cond_br" ||
@@ -513,7 +552,10 @@ RTLMatch::registerExtraSignalParameters(hw::HWModuleExternOp &modOp,
       handshakeOp == "mem_to_bram" ||
       handshakeOp == "handshake.lsq" ||
       handshakeOp == "handshake.sharing_wrapper" ||
-      handshakeOp == "handshake.ram"
+      handshakeOp == "handshake.ram" ||
+      // the tag is the only extra signal of tagging operations
+      handshakeOp == "handshake.tagger" ||
+      handshakeOp == "handshake.untagger"
       // clang-format on
   ) {
     // Skip
@@ -1020,12 +1062,16 @@ LogicalResult RTLConfiguration::addComponentsFromJSON(StringRef filepath) {
     return failure();
   }
 
+  // New components may match requests that previously had no match
+  matchCache.clear();
+
   for (auto [idx, jsonComponent] : llvm::enumerate(*jsonComponents)) {
     RTLComponent &component = components.emplace_back();
     if (!fromJSON(jsonComponent, component, jsonPath.index(idx))) {
       jsonRoot.printErrorContext(*value, llvm::errs());
       return failure();
     }
+    componentsByName[component.getName()].push_back(components.size() - 1);
   }
 
   return success();
@@ -1037,32 +1083,65 @@ static inline void notifyRequest(const RTLRequest &request) {
              << request.loc << "\n");
 }
 
+SmallVector<unsigned>
+RTLConfiguration::getCandidates(const RTLRequest &request) const {
+  if (std::optional<StringRef> name = request.getComponentName())
+    return componentsByName.lookup(*name);
+  return llvm::to_vector(llvm::seq<unsigned>(0, components.size()));
+}
+
+RTLMatch *RTLConfiguration::findFirstMatch(const RTLRequest &request) {
+  std::optional<StringRef> name = request.getComponentName();
+  std::optional<Attribute> key = request.getParametersKey();
+  if (!name || !key) {
+    for (unsigned idx : getCandidates(request)) {
+      if (RTLMatch *match = request.tryToMatch(components[idx]))
+        return match;
+    }
+    return nullptr;
+  }
+
+  // Requests with identical names and parameters match the same component, so
+  // only the first one needs to go through the candidate list. The matching
+  // component is re-matched on cache hits since the match object itself may
+  // depend on request-specific information
+  DenseMap<Attribute, std::optional<unsigned>> &cache = matchCache[*name];
+  if (auto cached = cache.find(*key); cached != cache.end()) {
+    LLVM_DEBUG(llvm::dbgs() << "\t-> Using cached match result\n");
+    if (std::optional<unsigned> idx = cached->second)
+      return request.tryToMatch(components[*idx]);
+    return nullptr;
+  }
+
+  for (unsigned idx : getCandidates(request)) {
+    if (RTLMatch *match = request.tryToMatch(components[idx])) {
+      cache[*key] = idx;
+      return match;
+    }
+  }
+  cache[*key] = std::nullopt;
+  return nullptr;
+}
+
 bool RTLConfiguration::hasMatchingComponent(const RTLRequest &request) {
   notifyRequest(request);
-  return llvm::any_of(components, [&](const RTLComponent &component) {
-    if (RTLMatch *match = request.tryToMatch(component)) {
-      delete match;
-      return true;
-    }
-    return false;
-  });
+  if (RTLMatch *match = findFirstMatch(request)) {
+    delete match;
+    return true;
+  }
+  return false;
 }
 
 RTLMatch *RTLConfiguration::getMatchingComponent(const RTLRequest &request) {
   notifyRequest(request);
-  std::vector<RTLMatch> matches;
-  for (const RTLComponent &component : components) {
-    if (RTLMatch *match = request.tryToMatch(component))
-      return match;
-  }
-  return nullptr;
+  return findFirstMatch(request);
 }
 
 void RTLConfiguration::findMatchingComponents(
     const RTLRequest &request, std::vector<RTLMatch *> &matches) const {
   notifyRequest(request);
-  for (const RTLComponent &component : components) {
-    if (RTLMatch *match = request.tryToMatch(component))
+  for (unsigned idx : getCandidates(request)) {
+    if (RTLMatch *match = request.tryToMatch(components[idx]))
       matches.push_back(match);
   }
   LLVM_DEBUG(llvm::dbgs() << matches.size()
@@ -1071,9 +1150,56 @@ void RTLConfiguration::findMatchingComponents(
 
 const RTLComponent::Model *
 RTLConfiguration::getModel(const RTLRequest &request) const {
-  for (const RTLComponent &component : components) {
-    if (const RTLComponent::Model *model = component.getModel(request))
+  for (unsigned idx : getCandidates(request)) {
+    if (const RTLComponent::Model *model = components[idx].getModel(request))
       return model;
   }
   return nullptr;
 }
+
+void RTLConfiguration::explainNoMatch(const RTLRequest &request,
+                                      InFlightDiagnostic &diag,
+                                      unsigned maxCandidates) const {
+  // Without a component name every component is a candidate, so there is
+  // nothing meaningful to report
+  if (!request.getComponentName())
+    return;
+  SmallVector<unsigned> candidates = getCandidates(request);
+  if (candidates.empty()) {
+    diag.attachNote() << "RTL configuration has no component with this name";
+    return;
+  }
+
+  // Rank candidates by number of violations, keeping JSON-parsing-order
+  // between equally close candidates
+  using Mismatches = std::pair<unsigned, SmallVector<std::string>>;
+  SmallVector<Mismatches> mismatches;
+  for (unsigned idx : candidates) {
+    Mismatches &mis = mismatches.emplace_back(idx, SmallVector<std::string>{});
+    request.getMismatches(components[idx], mis.second);
+  }
+  llvm::stable_sort(mismatches, [](const Mismatches &a, const Mismatches &b) {
+    return a.second.size() < b.second.size();
+  });
+
+  unsigned numNotes = std::min<unsigned>(maxCandidates, mismatches.size());
+  for (auto &[idx, reasons] :
+       ArrayRef<Mismatches>(mismatches).take_front(numNotes)) {
+    const RTLComponent &component = components[idx];
+    Diagnostic &note = diag.attachNote();
+    note << "candidate #" << idx << " (\"" << component.getName() << "\"";
+    if (!component.getModuleName().empty())
+      note << ", module \"" << component.getModuleName() << "\"";
+    note << ") does not match";
+    if (reasons.empty())
+      continue;
+    note << ": ";
+    llvm::interleave(
+        reasons, [&](StringRef reason) { note << reason; },
+        [&]() { note << "; "; });
+  }
+  if (numNotes < mismatches.size()) {
+    diag.attachNote() << (mismatches.size() - numNotes)
+                      << " other candidate(s) omitted";
+  }
+}
@@ -67,6 +67,17 @@ bool BooleanConstraints::verify(Attribute attr) const {
   return (!eq || value == eq) && (!ne || value != ne);
 }
 
+void BooleanConstraints::print(llvm::raw_ostream &os) const {
+  if (!eq && !ne) {
+    os << "unconstrained";
+    return;
+  }
+  if (eq)
+    os << "== " << (*eq ? "true" : "false");
+  if (ne)
+    os << (eq ? ", " : "") << "!= " << (*ne ? "true" : "false");
+}
+
 bool dynamatic::fromJSON(const ljson::Value &value, BooleanConstraints &cons,
                          ljson::Path path) {
   return ObjectDeserializer(value, path)
@@ -102,6 +113,27 @@ bool UnsignedConstraints::unconstrained() const {
   return !lb && !ub && !eq && !ne;
 }
 
+void UnsignedConstraints::print(llvm::raw_ostream &os) const {
+  if (unconstrained())
+    os << "unconstrained";
+  else
+    print(os, "value");
+}
+
+void UnsignedConstraints::print(llvm::raw_ostream &os,
+                                StringRef subject) const {
+  SmallVector<std::string, 4> terms;
+  if (lb)
+    terms.push_back((subject + " >= " + Twine(*lb)).str());
+  if (ub)
+    terms.push_back((subject + " <= " + Twine(*ub)).str());
+  if (eq)
+    terms.push_back((subject + " == " + Twine(*eq)).str());
+  if (ne)
+    terms.push_back((subject + " != " + Twine(*ne)).str());
+  llvm::interleave(terms, os, ", ");
+}
+
 /// Deserialization errors for unsigned constraints.
 static constexpr llvm::StringLiteral
     ERR_ARRAY_FORMAT = "expected array to have [lb, ub] format",
@@ -173,6 +205,17 @@ bool StringConstraints::verify(Attribute attr) const {
   return (!eq || stringAttr == eq) && (!ne || stringAttr != ne);
 }
 
+void StringConstraints::print(llvm::raw_ostream &os) const {
+  if (!eq && !ne) {
+    os << "unconstrained";
+    return;
+  }
+  if (eq)
+    os << "== \"" << *eq << "\"";
+  if (ne)
+    os << (eq ? ", " : "") << "!= \"" << *ne << "\"";
+}
+
 bool dynamatic::fromJSON(const ljson::Value &value, StringConstraints &cons,
                          ljson::Path path) {
   return ObjectDeserializer(value, path)
@@ -210,6 +253,25 @@ bool DataflowConstraints::verify(Attribute attr) const {
   return false;
 }
 
+void DataflowConstraints::print(llvm::raw_ostream &os) const {
+  std::pair<const UnsignedConstraints *, StringRef> fields[] = {
+      {&dataWidth, "data width"},
+      {&numExtras, "extra signals"},
+      {&numDownstreams, "downstream extra signals"},
+      {&numUpstreams, "upstream extra signals"}};
+  bool first = true;
+  for (auto [cons, subject] : fields) {
+    if (cons->unconstrained())
+      continue;
+    if (!first)
+      os << ", ";
+    cons->print(os, subject);
+    first = false;
+  }
+  if (first)
+    os << "any dataflow type";
+}
+
 bool dynamatic::fromJSON(const ljson::Value &value, DataflowConstraints &cons,
                          ljson::Path path) {
   ObjectDeserializer deserial(value, path);
@@ -15,6 +15,7 @@
 #include "dynamatic/Support/TimingModels.h"
 #include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "dynamatic/Support/JSON/JSON.h"
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/TypeSwitch.h"
@@ -118,19 +119,26 @@ const TimingModel *TimingDatabase::getModel(StringRef timingModelKey) const {
   return &it->second;
 }
 
-const TimingModel *TimingDatabase::getModel(Operation *op) const {
+std::string TimingDatabase::getModelKey(Operation *op) {
   StringRef baseName = op->getName().getStringRef();
+  if (auto latencyInterface = dyn_cast<handshake::LatencyInterface>(op);
+      latencyInterface && latencyInterface.getInitiationInterval() > 1)
+    return (baseName + "." + ITERATIVE_IMPL).str();
+
   // if the operation is a floating point operation with multiple
   // possible implementations
   if (auto fpuImplInterface =
           llvm::dyn_cast<dynamatic::handshake::FPUImplInterface>(op)) {
     // include the implementation in the key
-    std::string timingModelKey =
-        (baseName + "." + stringifyEnum(fpuImplInterface.getFPUImpl())).str();
-    return getModel(timingModelKey);
+    return (baseName + "." + stringifyEnum(fpuImplInterface.getFPUImpl()))
+        .str();
   }
 
-  return getModel(baseName);
+  return baseName.str();
+}
+
+const TimingModel *TimingDatabase::getModel(Operation *op) const {
+  return getModel(getModelKey(op));
 }
 
 FailureOr<double> TimingDatabase::getLatency(Operation *op,
@@ -142,6 +150,14 @@ FailureOr<double> TimingDatabase::getLatency(Operation *op,
   if (signalType != SignalType::DATA)
     return 0.0;
 
+  // Iterative units produce their result exactly one initiation interval after
+  // accepting their operands
+  if (auto latencyInterface = dyn_cast<handshake::LatencyInterface>(op)) {
+    int64_t ii = latencyInterface.getInitiationInterval();
+    if (ii > 1)
+      return static_cast<double>(ii);
+  }
+
   const TimingModel *model = getModel(op);
   if (!model) {
     op->emitWarning() << "TimingDatabase::getLatency: no timing model for op";
@@ -186,6 +202,30 @@ FailureOr<double> TimingDatabase::getLatency(Operation *op,
   return latency;
 }
 
+FailureOr<double> TimingDatabase::getMainClockLatency(Operation *op,
+                                                      SignalType signalType,
+                                                      double targetPeriod,
+                                                      unsigned pathId) const {
+  if (auto crossingOp = dyn_cast<handshake::ClockCrossingOp>(op)) {
+    if (signalType != SignalType::DATA)
+      return 0.0;
+    // A token is written into the FIFO on the source clock, after which the
+    // write pointer goes through a two-flop synchronizer on the destination
+    // clock
+    SmallVector<double> ratios =
+        getClockPeriodRatios(op->getParentOfType<handshake::FuncOp>());
+    return ratios[crossingOp.getSrcDomain()] +
+           2 * ratios[crossingOp.getDstDomain()];
+  }
+
+  double ratio = getClockPeriodRatio(op);
+  FailureOr<double> latency =
+      getLatency(op, signalType, targetPeriod * ratio, pathId);
+  if (failed(latency))
+    return failure();
+  return *latency * ratio;
+}
+
 LogicalResult TimingDatabase::getInternalCombinationalDelay(
     Operation *op, SignalType signalType, double &delay,
     double targetPeriod) const // Our current timing model doesn't have latency
@@ -476,6 +516,8 @@ bool dynamatic::fromJSON(const ljson::Value &value,
 }
 
 static const std::string LATENCY[] = {"latency"};
+static const std::string II[] = {"ii"};
+static const std::string AREA[] = {"area"};
 static const std::string DELAY[] = {"delay", "data"};
 static const std::string DELAY_VALID[] = {"delay", "valid", "1"};
 static const std::string DELAY_READY[] = {"delay", "ready", "1"};
@@ -512,6 +554,12 @@ bool dynamatic::fromJSON(const ljson::Value &value, TimingModel &model,
 
   // Deserialize the latency and max frequency
   FW_FALSE(deserializeNested(LATENCY, object, model.latAndMaxFreqByPath, path));
+  // Deserialize the initiation interval, if present
+  if (object->get(II[0]))
+    FW_FALSE(deserializeNested(II, object, model.iiByPath, path));
+  // Deserialize the area, if present
+  if (object->get(AREA[0]))
+    FW_FALSE(deserializeNested(AREA, object, model.areaByPath, path));
   // Deserialize the data delays
   FW_FALSE(deserializeNested(DELAY, object, model.dataDelay, path));
   // Deserialize the valid/ready delay
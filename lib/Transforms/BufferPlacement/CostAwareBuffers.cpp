@@ -181,6 +181,9 @@ void CostAwareBuffers::setup() {
     addUnitThroughputConstraints(*cfdfc);
   }
 
+  // Start from the placement decisions of the previous compilation
+  addPriorPlacementStart();
+
   // Add the MILP objective and mark the MILP ready to be optimized
   addBufferAreaAwareObjective(allChannels, cfdfcs);
   markReadyToOptimize();
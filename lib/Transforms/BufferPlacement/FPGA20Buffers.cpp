@@ -197,6 +197,9 @@ void FPGA20Buffers::setup() {
     addUnitThroughputConstraints(*cfdfc);
   }
 
+  // Start from the placement decisions of the previous compilation
+  addPriorPlacementStart();
+
   // Add the MILP objective and mark the MILP ready to be optimized
   addMaxThroughputObjective(allChannels, cfdfcs);
   markReadyToOptimize();
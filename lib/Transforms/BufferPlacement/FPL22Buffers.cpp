@@ -387,6 +387,9 @@ void CFDFCUnionBuffers::setup() {
     addUnitThroughputConstraints(*cfdfc);
   }
 
+  // Start from the placement decisions of the previous compilation
+  addPriorPlacementStart();
+
   // Add the MILP objective and mark the MILP ready to be optimized
   std::vector<Value> allChannels;
   llvm::copy(cfUnion.channels, std::back_inserter(allChannels));
@@ -489,6 +492,9 @@ void OutOfCycleBuffers::setup() {
     addUnitMixedPathConstraints(&unit, channelFilter);
   }
 
+  // Start from the placement decisions of the previous compilation
+  addPriorPlacementStart();
+
   // Set MILP objective and mark it ready to be optimized
   model->setMaximizeObjective(objective);
   markReadyToOptimize();
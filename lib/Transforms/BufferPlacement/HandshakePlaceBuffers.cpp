@@ -20,6 +20,9 @@
 #include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
 #include "dynamatic/Support/Attribute.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
+#include "dynamatic/Support/CostModel.h"
+#include "dynamatic/Support/Fingerprint.h"
 #include "dynamatic/Transforms/BufferPlacement/CostAwareBuffers.h"
 #include "dynamatic/Transforms/BufferPlacement/FPGA20Buffers.h"
 #include "dynamatic/Transforms/BufferPlacement/FPGA24Buffers.h"
@@ -27,6 +30,7 @@
 #include "dynamatic/Transforms/BufferPlacement/MAPBUFBuffers.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/BufferingSupport.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/CFDFC.h"
+#include "dynamatic/Transforms/BufferPlacement/Utils/PlacementCache.h"
 #include "dynamatic/Transforms/HandshakeMaterialize.h"
 #include "experimental/Support/StdProfiler.h"
 #include "mlir/IR/BuiltinOps.h"
@@ -34,8 +38,13 @@
 #include "mlir/Support/IndentedOstream.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include <chrono>
 #include <filesystem>
+#include <set>
 #include <string>
 
 using namespace mlir;
@@ -68,6 +77,19 @@ static void logFuncInfo(FuncInfo &info);
 namespace dynamatic {
 namespace buffer {
 
+/// Buffer placement of a function in a previous compilation, along with the
+/// basic blocks of the function that changed since then.
+struct PriorCompilation {
+  /// Cached placement of the function.
+  const CachedFuncPlacement &cached;
+  /// Stable references to the function's operations and values.
+  const StableIRRefs &refs;
+  /// Basic blocks that changed since the previous compilation.
+  std::set<unsigned> modifiedBlocks;
+  /// Number of CFDFCs whose placement was reused instead of being solved.
+  unsigned numReusedCFDFCs = 0;
+};
+
 /// Public pass driver for the buffer placement pass. Unlike most other
 /// Dynamatic passes, users may wish to access the pass's internal state to
 /// derive insights useful for different kinds of IR processing. To facilitate
@@ -109,10 +131,33 @@ protected:
   /// Computes an optimal buffer placement for a Handhsake function by solving
   /// a large MILP over the entire dataflow circuit represented by the
   /// function. Fills the `placement` map with placement decisions derived
-  /// from the MILP's solution.
+  /// from the MILP's solution. When the function's placement in a previous
+  /// compilation is provided, algorithms solving an MILP per CFDFC union
+  /// reuse the placement of unions made up of unchanged CFDFCs.
   LogicalResult solveBufferPlacementMILP(FuncInfo &info,
-                                         TimingDatabase &timingDB,
-                                         BufferPlacement &placement);
+                                         const TimingDatabase &timingDB,
+                                         BufferPlacement &placement,
+                                         PriorCompilation *prior = nullptr);
+
+  /// Reuses the function's entire placement from a previous compilation,
+  /// recreating its CFDFCs along with their throughput and channel occupancy.
+  /// Fails if the cached placement does not cover the function, in which case
+  /// the CFDFCs vector and the placement are left empty.
+  LogicalResult reuseFuncPlacement(FuncInfo &info,
+                                   const PriorCompilation &prior,
+                                   std::vector<CFDFC> &cfdfcs,
+                                   BufferPlacement &placement);
+
+  /// Sets the prior placement of all channels of the function that already
+  /// existed in a previous compilation, for MILPs to use it as a starting
+  /// point.
+  void setPriorPlacement(FuncInfo &info, const PriorCompilation &prior);
+
+  /// Returns the buffer placement configuration, which must match for a cached
+  /// placement to be reused. The configuration includes the contents of the
+  /// timing models and BLIF files, so that editing them in place invalidates
+  /// cached placements.
+  std::string getPlacementConfig();
   /// Called for all buffer placement strategies that do not require Gurobi to
   /// be installed on the host system.
   LogicalResult placeWithoutUsingMILP();
@@ -196,6 +241,14 @@ void HandshakePlaceBuffersPass::runOnOperation() {
   markAnalysesPreserved<NameAnalysis>();
 }
 
+/// Returns the number of milliseconds elapsed since the given time point.
+static unsigned
+getElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
 LogicalResult HandshakePlaceBuffersPass::placeUsingMILP() {
   // Make sure that all operations in the IR are named (used to generate
   // variable names in the MILP)
@@ -210,12 +263,22 @@ LogicalResult HandshakePlaceBuffersPass::placeUsingMILP() {
   ModuleOp modOp = llvm::dyn_cast<ModuleOp>(getOperation());
   //
   // Read the operations' timing models from disk
-  TimingDatabase timingDB;
-  if (failed(TimingDatabase::readFromJSON(timingModels, timingDB)))
+  FailureOr<const TimingDatabase *> timingDBOrFail =
+      CostModel::getTimingDatabase(timingModels);
+  if (failed(timingDBOrFail))
     return failure();
+  const TimingDatabase &timingDB = **timingDBOrFail;
 
   auto &cfdfcAnalysis = getAnalysis<dynamatic::CFDFCAnalysis>();
 
+  // Read the placements of the previous compilation, and start recording those
+  // of this compilation
+  PlacementCache priorCache, newCache;
+  std::string config = getPlacementConfig();
+  if (!placementCache.empty() &&
+      failed(PlacementCache::read(placementCache, priorCache)))
+    return failure();
+
   for (handshake::FuncOp funcOp : modOp.getOps<handshake::FuncOp>()) {
     auto info = FuncInfo(funcOp);
 
@@ -232,23 +295,55 @@ LogicalResult HandshakePlaceBuffersPass::placeUsingMILP() {
     if (failed(checkFuncInvariants(info)))
       return failure();
 
+    // Fingerprint the function and look for its placement in the previous
+    // compilation, which is only relevant if it was made with the same
+    // configuration
+    std::optional<StableIRRefs> refs;
+    std::optional<PriorCompilation> prior;
+    FuncFingerprint fingerprint;
+    if (!placementCache.empty()) {
+      refs.emplace(funcOp);
+      fingerprint = FuncFingerprint::get(funcOp, *refs);
+      auto cachedIt = priorCache.functions.find(funcOp.getName());
+      if (cachedIt != priorCache.functions.end() &&
+          cachedIt->second.config == config) {
+        const CachedFuncPlacement &cached = cachedIt->second;
+        prior.emplace(PriorCompilation{
+            cached, *refs, fingerprint.getModifiedBlocks(cached.fingerprint)});
+      }
+    }
+
     // Get CFDFCs from the function unless the functions has no archs (i.e.,
     // it has a single block) in which case there are no CFDFCs
     std::vector<CFDFC> cfdfcs;
+    BufferPlacement placement;
 
-    // If the CFG does not have any backedges (e.g., it only has one or many
-    // if-else blocks), then we don't need to size buffers for performance
-    // reasons.
-    bool cfgHasBackedge =
-        std::any_of(info.archs.begin(), info.archs.end(),
-                    [](ArchBB arch) { return arch.isBackEdge; });
-
-    assert(
-        (not info.archs.empty() or not cfgHasBackedge) &&
-        "Sanity check failed: no BB edges -> CFG does not have any backedges");
-
-    if (cfgHasBackedge && failed(getCFDFCs(info, cfdfcs)))
-      return failure();
+    // The entire placement is reused when neither the function nor its
+    // profiling information changed since the previous compilation
+    bool sameArchs = prior && prior->cached.hasSameArchs(info.archs);
+    bool reuseFunc =
+        sameArchs && prior->cached.fingerprint.func == fingerprint.func;
+    if (reuseFunc &&
+        failed(reuseFuncPlacement(info, *prior, cfdfcs, placement)))
+      reuseFunc = false;
+
+    if (!reuseFunc) {
+      // If the CFG does not have any backedges (e.g., it only has one or many
+      // if-else blocks), then we don't need to size buffers for performance
+      // reasons.
+      bool cfgHasBackedge =
+          std::any_of(info.archs.begin(), info.archs.end(),
+                      [](ArchBB arch) { return arch.isBackEdge; });
+
+      assert((not info.archs.empty() or not cfgHasBackedge) &&
+             "Sanity check failed: no BB edges -> CFG does not have any "
+             "backedges");
+
+      auto extractionStart = std::chrono::steady_clock::now();
+      if (cfgHasBackedge && failed(getCFDFCs(info, cfdfcs)))
+        return failure();
+      cfdfcExtractionTime += getElapsedMilliseconds(extractionStart);
+    }
 
     // All extracted CFDFCs must be optimized
     for (CFDFC &cf : cfdfcs)
@@ -274,19 +369,226 @@ LogicalResult HandshakePlaceBuffersPass::placeUsingMILP() {
 
     LLVM_DEBUG(logFuncInfo(info););
 
-    // Solve the MILP to obtain a buffer placement
-    BufferPlacement placement;
-    if (failed(solveBufferPlacementMILP(info, timingDB, placement)))
-      return failure();
+    if (reuseFunc) {
+      prior->numReusedCFDFCs = cfdfcs.size();
+    } else {
+      // Start from the placement of the previous compilation for channels
+      // that did not change since then
+      if (prior)
+        setPriorPlacement(info, *prior);
+
+      // Solve the MILP to obtain a buffer placement
+      auto milpStart = std::chrono::steady_clock::now();
+      if (failed(solveBufferPlacementMILP(info, timingDB, placement,
+                                          prior ? &*prior : nullptr)))
+        return failure();
+      milpSolvingTime += getElapsedMilliseconds(milpStart);
+    }
+
+    if (refs) {
+      // Record the placement before buffers are instantiated, since buffers
+      // change the channels' consumers
+      CachedFuncPlacement &entry = newCache.functions[funcOp.getName()];
+      entry.config = config;
+      entry.fingerprint = fingerprint;
+      for (ArchBB &arch : info.archs)
+        entry.archs.push_back({arch.srcBB, arch.dstBB, arch.numTrans});
+      for (CFDFC &cf : cfdfcs) {
+        CachedCFDFC &cachedCF = entry.cfdfcs.emplace_back();
+        cachedCF.cycle.assign(cf.cycle.begin(), cf.cycle.end());
+        cachedCF.numExecs = cf.numExecs;
+        cachedCF.throughput = cf.throughput;
+        for (auto &[channel, occupancy] : cf.channelOccupancy)
+          cachedCF.occupancy[getChannelRef(channel, *refs)] = occupancy;
+      }
+      for (auto &[channel, result] : placement)
+        entry.placement[getChannelRef(channel, *refs)] = result;
+
+      // Report which parts of the function were placed again
+      unsigned numReused = prior ? prior->numReusedCFDFCs : 0;
+      reusedCFDFCs += numReused;
+      std::string changes;
+      if (!prior)
+        changes = "no prior placement";
+      else if (reuseFunc)
+        changes = "unchanged";
+      else if (!prior->modifiedBlocks.empty())
+        changes = getBlockList(prior->modifiedBlocks) + " modified";
+      else if (!sameArchs)
+        changes = "profiling information changed";
+      else
+        changes = "function-level changes";
+      llvm::errs() << llvm::formatv(
+          "[incremental] {0}: {1}, reused placement of {2} of {3} CFDFCs, "
+          "re-solved {4}\n",
+          funcOp.getName(), changes, numReused, cfdfcs.size(),
+          cfdfcs.size() - numReused);
+    }
 
     instantiateBuffers(placement, cfdfcs);
     cfdfcAnalysis.mapFuncOpToCFDFCs[info.funcOp] = cfdfcs;
   }
 
+  if (!placementCache.empty() && failed(newCache.write(placementCache)))
+    return failure();
+
   markAnalysesPreserved<NameAnalysis, CFDFCAnalysis>();
   return success();
 }
 
+/// Adds the contents of the file at the path to the hasher, or the contents of
+/// all files it contains (along with their relative path) if it is a
+/// directory. Paths that cannot be read contribute nothing.
+static void hashContents(StringRef path, llvm::MD5 &hasher) {
+  if (path.empty())
+    return;
+  auto hashFile = [&](StringRef filePath) {
+    if (auto buffer = llvm::MemoryBuffer::getFile(filePath))
+      hasher.update((*buffer)->getBuffer());
+  };
+
+  std::error_code ec;
+  std::filesystem::path root(path.str());
+  if (!std::filesystem::is_directory(root, ec)) {
+    hashFile(path);
+    return;
+  }
+
+  // Visit files in a deterministic order
+  std::vector<std::filesystem::path> files;
+  for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+       !ec && it != std::filesystem::recursive_directory_iterator();
+       it.increment(ec)) {
+    if (it->is_regular_file(ec))
+      files.push_back(it->path());
+  }
+  llvm::sort(files);
+  for (const std::filesystem::path &file : files) {
+    hasher.update(file.lexically_relative(root).generic_string());
+    hashFile(file.string());
+  }
+}
+
+std::string HandshakePlaceBuffersPass::getPlacementConfig() {
+  llvm::MD5 hasher;
+  hashContents(timingModels, hasher);
+  hashContents(blifFiles, hasher);
+  llvm::MD5::MD5Result contentsHash;
+  hasher.final(contentsHash);
+
+  return llvm::formatv("{0}|{1}|{2}|{3}|{4}|{5}|{6}|{7}|{8}", algorithm,
+                       targetCP, timingModels, firstCFDFC, blifFiles, lutDelay,
+                       lutSize, acyclicType, contentsHash.digest())
+      .str();
+}
+
+/// Restores the throughput and channel occupancy of a CFDFC from its placement
+/// in a previous compilation. Fails if the occupancy of one of the CFDFC's
+/// channels is unknown.
+static LogicalResult restoreCFDFC(CFDFC &cf, const CachedCFDFC &cached,
+                                  const StableIRRefs &refs) {
+  DenseMap<Value, double> channelOccupancy;
+  for (Value channel : cf.channels) {
+    auto occupancyIt = cached.occupancy.find(getChannelRef(channel, refs));
+    if (occupancyIt == cached.occupancy.end())
+      return failure();
+    channelOccupancy[channel] = occupancyIt->second;
+  }
+  cf.throughput = cached.throughput;
+  cf.channelOccupancy = std::move(channelOccupancy);
+  return success();
+}
+
+/// Adds the placement decisions of a previous compilation for the channels to
+/// the placement. Channels without cached decisions had no buffers.
+static void restorePlacement(ArrayRef<Value> channels,
+                             const PriorCompilation &prior,
+                             BufferPlacement &placement) {
+  for (Value channel : channels) {
+    auto resultIt =
+        prior.cached.placement.find(getChannelRef(channel, prior.refs));
+    if (resultIt != prior.cached.placement.end())
+      placement[channel] = resultIt->second;
+  }
+}
+
+LogicalResult
+HandshakePlaceBuffersPass::reuseFuncPlacement(FuncInfo &info,
+                                              const PriorCompilation &prior,
+                                              std::vector<CFDFC> &cfdfcs,
+                                              BufferPlacement &placement) {
+  for (const CachedCFDFC &cached : prior.cached.cfdfcs) {
+    if (cached.cycle.empty()) {
+      cfdfcs.clear();
+      return failure();
+    }
+
+    // Recreate the archs making up the CFDFC's cycle. The CFDFC's cycle starts
+    // at the first block that appears twice in the archs, so the arch closing
+    // the cycle must come first
+    SmallVector<ArchBB> cycleArchs;
+    cycleArchs.emplace_back(cached.cycle.back(), cached.cycle.front(), 0,
+                            false);
+    for (size_t i = 0, e = cached.cycle.size() - 1; i < e; ++i)
+      cycleArchs.emplace_back(cached.cycle[i], cached.cycle[i + 1], 0, false);
+    ArchSet archs;
+    for (ArchBB &arch : cycleArchs)
+      archs.insert(&arch);
+
+    CFDFC &cf = cfdfcs.emplace_back(info.funcOp, archs, cached.numExecs);
+    if (failed(restoreCFDFC(cf, cached, prior.refs))) {
+      cfdfcs.clear();
+      return failure();
+    }
+  }
+
+  SmallVector<Value> channels;
+  llvm::append_range(channels, info.funcOp.getArguments());
+  for (Operation &op : info.funcOp.getOps())
+    llvm::append_range(channels, op.getResults());
+  restorePlacement(channels, prior, placement);
+
+  // Restore the throughput of each CFDFC as well, as the MILPs would
+  llvm::MapVector<size_t, double> cfdfcTPResult;
+  for (auto [idx, cf] : llvm::enumerate(cfdfcs))
+    cfdfcTPResult[idx] = cf.throughput;
+  auto cfdfcTPMap = handshake::CFDFCThroughputAttr::get(
+      info.funcOp.getContext(), cfdfcTPResult);
+  setDialectAttr(info.funcOp, cfdfcTPMap);
+  return success();
+}
+
+void HandshakePlaceBuffersPass::setPriorPlacement(
+    FuncInfo &info, const PriorCompilation &prior) {
+  auto isUnmodified = [&](std::optional<unsigned> bb) {
+    return bb && !prior.modifiedBlocks.count(*bb);
+  };
+  auto addChannel = [&](Value channel) {
+    // The consumer's fingerprint covers where its operands are defined, so the
+    // channel already existed if both of its endpoints are unchanged
+    Operation *user = *channel.getUsers().begin();
+    if (!isUnmodified(prior.refs.getBlock(user)))
+      return;
+    Operation *defOp = channel.getDefiningOp();
+    if (defOp && !isUnmodified(prior.refs.getBlock(defOp)))
+      return;
+
+    auto resultIt =
+        prior.cached.placement.find(getChannelRef(channel, prior.refs));
+    if (resultIt != prior.cached.placement.end())
+      info.priorPlacement[channel] = resultIt->second;
+    else
+      info.priorPlacement[channel] = PlacementResult();
+  };
+
+  for (BlockArgument arg : info.funcOp.getArguments())
+    addChannel(arg);
+  for (Operation &op : info.funcOp.getOps()) {
+    for (OpResult res : op.getResults())
+      addChannel(res);
+  }
+}
+
 LogicalResult HandshakePlaceBuffersPass::checkFuncInvariants(FuncInfo &info) {
   // Store all archs in a map for fast query time
   DenseMap<unsigned, llvm::SmallDenseSet<unsigned, 2>> transitions;
@@ -474,8 +776,32 @@ static void logCFDFCUnions(FuncInfo &info,
   }
 }
 
+/// Reuses the placement of a CFDFC union from a previous compilation, which is
+/// possible if none of its basic blocks changed since then and all of its
+/// CFDFCs were already extracted then. Fails if the placement cannot be reused.
+static LogicalResult reuseUnionPlacement(CFDFCUnion &cfUnion,
+                                         const PriorCompilation &prior,
+                                         BufferPlacement &placement) {
+  if (llvm::any_of(cfUnion.blocks,
+                   [&](unsigned bb) { return prior.modifiedBlocks.count(bb); }))
+    return failure();
+
+  for (CFDFC *cf : cfUnion.cfdfcs) {
+    auto cachedIt =
+        llvm::find_if(prior.cached.cfdfcs, [&](const CachedCFDFC &cached) {
+          return cached.matches(*cf);
+        });
+    if (cachedIt == prior.cached.cfdfcs.end() ||
+        failed(restoreCFDFC(*cf, *cachedIt, prior.refs)))
+      return failure();
+  }
+  restorePlacement(cfUnion.channels.getArrayRef(), prior, placement);
+  return success();
+}
+
 LogicalResult HandshakePlaceBuffersPass::solveBufferPlacementMILP(
-    FuncInfo &info, TimingDatabase &timingDB, BufferPlacement &placement) {
+    FuncInfo &info, const TimingDatabase &timingDB, BufferPlacement &placement,
+    PriorCompilation *prior) {
 
   LLVM_DEBUG(llvm::errs() << "\n";
              llvm::errs() << "# =========================== #\n";
@@ -516,6 +842,11 @@ LogicalResult HandshakePlaceBuffersPass::solveBufferPlacementMILP(
     // accumulated over all MILPs. It's not possible to override a previous
     // placement decision because each CFDFC union is disjoint from the others
     for (auto [idx, cfUnion] : llvm::enumerate(disjointUnions)) {
+      // Reuse the placement of unchanged unions from the previous compilation
+      if (prior && succeeded(reuseUnionPlacement(cfUnion, *prior, placement))) {
+        prior->numReusedCFDFCs += cfUnion.cfdfcs.size();
+        continue;
+      }
       if (dumpMILPModels) {
         writeTo = dumpDir + sep + funcName + "-cfunion" + std::to_string(idx);
       }
@@ -567,9 +898,11 @@ LogicalResult HandshakePlaceBuffersPass::placeWithoutUsingMILP() {
   // buffering constraints
 
   // Read the operations' timing models from disk
-  TimingDatabase timingDB;
-  if (failed(TimingDatabase::readFromJSON(timingModels, timingDB)))
+  FailureOr<const TimingDatabase *> timingDBOrFail =
+      CostModel::getTimingDatabase(timingModels);
+  if (failed(timingDBOrFail))
     return failure();
+  const TimingDatabase &timingDB = **timingDBOrFail;
 
   auto modOp = llvm::dyn_cast<ModuleOp>(getOperation());
 
@@ -720,6 +1053,8 @@ void HandshakePlaceBuffersPass::instantiateBuffers(BufferPlacement &placement,
     builder.setInsertionPoint(opDst);
 
     Value bufferIn = channel;
+    // Buffers are clocked like the channel they are placed on
+    unsigned domain = getChannelClockDomain(channel);
 
     // We need to record the list of placed buffers. We will calculate their
     // token occupancy in each CFDFC below.
@@ -733,6 +1068,7 @@ void HandshakePlaceBuffersPass::instantiateBuffers(BufferPlacement &placement,
           bufferIn.getLoc(), bufferIn, numSlots, bufferType, dvLatency);
       placedBuffers.push_back(bufOp);
       inheritBB(opDst, bufOp);
+      setClockDomain(bufOp, domain);
       nameAnalysis.setName(bufOp);
 
       Value bufferRes = bufOp->getResult(0);
@@ -14,6 +14,7 @@
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/Attribute.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "dynamatic/Transforms/BufferPlacement/FPGA24Buffers.h"
 #include "dynamatic/Transforms/BufferPlacement/LatencyAndOccupancyBalancingSupport.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/BufferingSupport.h"
@@ -137,7 +138,7 @@ static LinExpr computeCycleLatency(const SimpleCycle &cycle,
       continue;
     Operation *op = node.op;
     auto unitLatencyOrFail =
-        timingDB.getLatency(op, SignalType::DATA, targetPeriod);
+        timingDB.getMainClockLatency(op, SignalType::DATA, targetPeriod);
     if (succeeded(unitLatencyOrFail))
       latency += *unitLatencyOrFail;
   }
@@ -176,7 +177,7 @@ computeCycleBaseLatency(const SimpleCycle &cycle,
       continue;
     Operation *op = node.op;
     auto unitLatencyOrFail =
-        timingDB.getLatency(op, SignalType::DATA, targetPeriod);
+        timingDB.getMainClockLatency(op, SignalType::DATA, targetPeriod);
     if (succeeded(unitLatencyOrFail))
       latency += *unitLatencyOrFail;
   }
@@ -239,7 +240,8 @@ BufferPlacementMILP::BufferPlacementMILP(CPSolver::SolverKind solverKind,
                                          double targetPeriod,
                                          llvm::StringRef writeTo)
     : MILP<BufferPlacement>(solverKind, timeout, writeTo), timingDB(timingDB),
-      targetPeriod(targetPeriod), funcInfo(funcInfo) {
+      targetPeriod(targetPeriod),
+      costModel(CostModel::get(timingDB, targetPeriod)), funcInfo(funcInfo) {
   initialize();
 }
 
@@ -271,6 +273,34 @@ void BufferPlacementMILP::addChannelVars(Value channel,
   chVars.shiftReg = createVar("shiftReg", BOOLEAN);
 }
 
+void BufferPlacementMILP::addPriorPlacementStart() {
+  for (auto &[channel, chVars] : vars.channelVars) {
+    auto priorIt = funcInfo.priorPlacement.find(channel);
+    if (priorIt == funcInfo.priorPlacement.end())
+      continue;
+    const PlacementResult &prior = priorIt->second;
+
+    unsigned numSlotsDV = prior.numOneSlotDV + prior.numFifoDV +
+                          prior.numOneSlotDVR + prior.numShiftRegDV +
+                          prior.counterBufferLatencies.size();
+    unsigned numSlots = numSlotsDV + prior.numFifoNone;
+    // Algorithms without variables for the ready signal place transparent
+    // slots outside of the MILP
+    bool hasReadyVars = chVars.signalVars.count(SignalType::READY);
+    if (hasReadyVars)
+      numSlots += prior.numOneSlotR;
+
+    model->setStartValue(chVars.bufPresent, numSlots > 0 ? 1.0 : 0.0);
+    model->setStartValue(chVars.bufNumSlots, numSlots);
+    for (auto &[signalType, signalVars] : chVars.signalVars) {
+      bool isBuffered = signalType == SignalType::READY
+                            ? prior.numOneSlotR + prior.numOneSlotDVR > 0
+                            : numSlotsDV > 0;
+      model->setStartValue(signalVars.bufPresent, isBuffered ? 1.0 : 0.0);
+    }
+  }
+}
+
 void BufferPlacementMILP::addCFDFCVars(CFDFC &cfdfc) {
   // Create a set of variables for each CFDFC
   std::string prefix = "cfdfc" + std::to_string(vars.cfdfcVars.size()) + "_";
@@ -296,8 +326,8 @@ void BufferPlacementMILP::addCFDFCVars(CFDFC &cfdfc) {
       // to its latency)
 
       // try get the latency from the timingDB
-      auto pathLatencyOrFail =
-          timingDB.getLatency(unit, SignalType::DATA, targetPeriod, pathIdx);
+      auto pathLatencyOrFail = timingDB.getMainClockLatency(
+          unit, SignalType::DATA, targetPeriod, pathIdx);
       if (succeeded(pathLatencyOrFail))
         pathVars.latency = *pathLatencyOrFail;
       else
@@ -412,10 +442,17 @@ void BufferPlacementMILP::addUnitTimingConstraints(Operation *unit,
                                                    ChannelFilter filter) {
   // Add path constraints for units
   double latency = 0.0;
-  auto latencyOrFail = timingDB.getLatency(unit, signalType, targetPeriod);
+  auto latencyOrFail =
+      timingDB.getMainClockLatency(unit, signalType, targetPeriod);
   if (succeeded(latencyOrFail))
     latency = *latencyOrFail;
 
+  // Channels never cross clock domains without going through a pipelined clock
+  // domain crossing, so all timing paths through the unit are in its own clock
+  // domain. Delays are normalized by the domain's clock period so that they
+  // can be compared against the target period
+  double periodRatio = getClockPeriodRatio(unit);
+
   if (latency == 0.0) {
     double delay;
     if (failed(timingDB.getTotalDelay(unit, signalType, delay)))
@@ -430,7 +467,7 @@ void BufferPlacementMILP::addUnitTimingConstraints(Operation *unit,
     }
 
     // The delay of the unit must be positive.
-    delay = std::max(delay, 0.001);
+    delay = std::max(delay / periodRatio, 0.001);
 
     // The unit is not pipelined, add a path constraint for each input/output
     // port pair in the unit
@@ -465,6 +502,7 @@ void BufferPlacementMILP::addUnitTimingConstraints(Operation *unit,
     if (failed(
             timingDB.getPortDelay(unit, signalType, PortType::IN, inPortDelay)))
       inPortDelay = 0.0;
+    inPortDelay /= periodRatio;
 
     TimeVars &path = vars.channelVars[in].signalVars[signalType].path;
     CPVar &tInPort = path.tOut;
@@ -482,6 +520,7 @@ void BufferPlacementMILP::addUnitTimingConstraints(Operation *unit,
     if (failed(timingDB.getPortDelay(unit, signalType, PortType::OUT,
                                      outPortDelay)))
       outPortDelay = 0.0;
+    outPortDelay /= periodRatio;
 
     TimeVars &path = vars.channelVars[out].signalVars[signalType].path;
     CPVar &tOutPort = path.tIn;
@@ -804,6 +843,13 @@ void BufferPlacementMILP::addUnitThroughputConstraints(CFDFC &cfdfc) {
                            *retPath.retOut - *retPath.retIn,
                        "through_unitRetiming");
     }
+
+    // units that can only accept a new token every II cycles (of their own
+    // clock domain) bound the throughput of the CFDFC
+    if (int64_t ii = costModel.getUnitCost(unit).ii; ii > 1) {
+      double mainClockII = ii * getClockPeriodRatio(unit);
+      model->addConstr(cfVars.throughput * mainClockII <= 1, "through_unitII");
+    }
   }
 }
 
@@ -1208,23 +1254,44 @@ void BufferPlacementMILP::addBufferAreaAwareObjective(
   // The following parameters control penalties in the MILP objective. The
   // penalty for buffer presence is an empirical value, consistent with
   // 'addMaxThroughputObjective'. The slot penalties for each buffer type are
-  // rough estimates, based on the number of LUTs as logic observed when each
-  // buffer type was synthesized individually. To adjust these parameters during
-  // tuning, simply modify the values here.
+  // proportional to the area of a slot of that type on the channel, as given
+  // by the timing models. The default slot penalties are rough estimates for
+  // 32-bit channels, based on the number of LUTs as logic observed when each
+  // buffer type was synthesized individually, and are used when the timing
+  // models do not characterize a buffer type's area. To adjust these
+  // parameters during tuning, simply modify the values here.
 
   // For each channel, add a "penalty" in case a buffer is added to the channel,
   // and another penalty that depends on the number of slots
   double bufPenaltyMul = 1e-4;
   // In general, buffers that break data paths have a lower area cost per slot,
   // while other types incur a higher cost
-  double largeSlotPenaltyMul = 1e-4;
-  double smallSlotPenaltyMul = 1e-5;
+  double defaultLargeSlotPenaltyMul = 1e-4;
+  double defaultSmallSlotPenaltyMul = 1e-5;
+  double slotPenaltyPerLUT = 3e-6;
+  auto getSlotPenaltyMul = [&](handshake::BufferType bufferType,
+                               unsigned bitwidth, double defaultMul) {
+    if (std::optional<double> area =
+            CostModel::getBufferSlotArea(timingDB, bufferType, bitwidth))
+      return slotPenaltyPerLUT * *area;
+    return defaultMul;
+  };
   // For SHIFT_REG_BREAK_DV, a small area cost is incurred when the buffer
   // exists Increasing the slot number only requires additional registers, not
   // LUTs We assign a minimal cost only to constrain its slot number
   double shiftRegPenaltyMul = 1e-5;
   double shiftRegSlotPenaltyMul = 1e-7;
   for (Value channel : channels) {
+    // Slots that do not break the data path are transparent slots, the others
+    // are slots cutting the data path with a register
+    unsigned bitwidth = handshake::getHandshakeTypeBitWidth(channel.getType());
+    double largeSlotPenaltyMul =
+        getSlotPenaltyMul(handshake::BufferType::ONE_SLOT_BREAK_R, bitwidth,
+                          defaultLargeSlotPenaltyMul);
+    double smallSlotPenaltyMul =
+        getSlotPenaltyMul(handshake::BufferType::ONE_SLOT_BREAK_DV, bitwidth,
+                          defaultSmallSlotPenaltyMul);
+
     ChannelVars &chVars = vars.channelVars[channel];
     CPVar &bufPresent = chVars.bufPresent;
     CPVar &bufNumSlots = chVars.bufNumSlots;
@@ -1384,8 +1451,8 @@ void BufferPlacementMILP::addReconvergentPathConstraints(
         if (node.type != DataflowGraphNode::REGULAR)
           continue;
         Operation *unitOp = node.op;
-        auto unitLatOrFail =
-            timingDB.getLatency(unitOp, SignalType::DATA, targetPeriod);
+        auto unitLatOrFail = timingDB.getMainClockLatency(
+            unitOp, SignalType::DATA, targetPeriod);
         if (succeeded(unitLatOrFail))
           pathLatency += *unitLatOrFail;
       }
@@ -0,0 +1,285 @@
+//===- PlacementCache.cpp - Cached buffer placements -----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the buffer placement cache and its (de)serialization to JSON.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Transforms/BufferPlacement/Utils/PlacementCache.h"
+#include "dynamatic/Support/JSON/JSON.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
+#include <fstream>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::buffer;
+using namespace dynamatic::experimental;
+using namespace dynamatic::json;
+namespace ljson = llvm::json;
+
+/// Version of the cache's format, to be bumped on incompatible changes.
+static constexpr int64_t CACHE_FORMAT_VERSION = 1;
+
+/// JSON keys of placement decisions.
+static constexpr llvm::StringLiteral KEY_ONE_SLOT_DV("one_slot_dv"),
+    KEY_ONE_SLOT_R("one_slot_r"), KEY_FIFO_DV("fifo_dv"),
+    KEY_FIFO_NONE("fifo_none"), KEY_ONE_SLOT_DVR("one_slot_dvr"),
+    KEY_SHIFT_REG_DV("shift_reg_dv"),
+    KEY_COUNTER_LATENCIES("counter_latencies");
+
+bool CachedCFDFC::matches(const CFDFC &cfdfc) const {
+  return numExecs == cfdfc.numExecs &&
+         llvm::equal(cycle, cfdfc.cycle.getArrayRef());
+}
+
+bool CachedFuncPlacement::hasSameArchs(ArrayRef<ArchBB> funcArchs) const {
+  if (archs.size() != funcArchs.size())
+    return false;
+  for (auto [cached, arch] : llvm::zip_equal(archs, funcArchs)) {
+    if (cached.srcBB != arch.srcBB || cached.dstBB != arch.dstBB ||
+        cached.numTrans != arch.numTrans)
+      return false;
+  }
+  return true;
+}
+
+std::string dynamatic::buffer::getChannelRef(Value channel,
+                                             const StableIRRefs &refs) {
+  return refs.getRef(channel) + "->" +
+         refs.getRef(*channel.getUses().begin());
+}
+
+//===----------------------------------------------------------------------===//
+// Serialization
+//===----------------------------------------------------------------------===//
+
+static ljson::Value toJSON(const PlacementResult &result) {
+  // Only write the buffer types that are actually placed
+  ljson::Object object;
+  auto addCount = [&](StringRef key, unsigned count) {
+    if (count != 0)
+      object[key] = count;
+  };
+  addCount(KEY_ONE_SLOT_DV, result.numOneSlotDV);
+  addCount(KEY_ONE_SLOT_R, result.numOneSlotR);
+  addCount(KEY_FIFO_DV, result.numFifoDV);
+  addCount(KEY_FIFO_NONE, result.numFifoNone);
+  addCount(KEY_ONE_SLOT_DVR, result.numOneSlotDVR);
+  addCount(KEY_SHIFT_REG_DV, result.numShiftRegDV);
+  if (!result.counterBufferLatencies.empty()) {
+    ljson::Array latencies;
+    for (unsigned latency : result.counterBufferLatencies)
+      latencies.push_back(latency);
+    object[KEY_COUNTER_LATENCIES] = std::move(latencies);
+  }
+  return object;
+}
+
+static ljson::Value toJSON(const CachedCFDFC &cfdfc) {
+  ljson::Array cycle;
+  for (unsigned bb : cfdfc.cycle)
+    cycle.push_back(bb);
+  ljson::Object occupancy;
+  for (const auto &[channelRef, numTokens] : cfdfc.occupancy)
+    occupancy[channelRef] = numTokens;
+  return ljson::Object{
+      {"cycle", std::move(cycle)},
+      {"num_execs", cfdfc.numExecs},
+      {"throughput", cfdfc.throughput},
+      {"occupancy", std::move(occupancy)},
+  };
+}
+
+static ljson::Value toJSON(const CachedFuncPlacement &placement) {
+  ljson::Array archs;
+  for (const CachedArch &arch : placement.archs) {
+    archs.push_back(ljson::Object{
+        {"src", arch.srcBB}, {"dst", arch.dstBB}, {"trans", arch.numTrans}});
+  }
+  ljson::Array cfdfcs;
+  for (const CachedCFDFC &cfdfc : placement.cfdfcs)
+    cfdfcs.push_back(toJSON(cfdfc));
+  ljson::Object channels;
+  for (const auto &[channelRef, result] : placement.placement)
+    channels[channelRef] = toJSON(result);
+  return ljson::Object{
+      {"config", placement.config},
+      {"fingerprint", toJSON(placement.fingerprint)},
+      {"archs", std::move(archs)},
+      {"cfdfcs", std::move(cfdfcs)},
+      {"placement", std::move(channels)},
+  };
+}
+
+LogicalResult PlacementCache::write(StringRef path) const {
+  std::error_code ec;
+  llvm::raw_fd_ostream out(path, ec, llvm::sys::fs::OF_Text);
+  if (ec) {
+    llvm::errs() << "Failed to open buffer placement cache at \"" << path
+                 << "\": " << ec.message() << "\n";
+    return failure();
+  }
+
+  ljson::Object jsonFunctions;
+  for (const auto &[funcName, placement] : functions)
+    jsonFunctions[funcName] = toJSON(placement);
+  ljson::Value jsonCache = ljson::Object{
+      {"format_version", CACHE_FORMAT_VERSION},
+      {"functions", std::move(jsonFunctions)},
+  };
+  out << llvm::formatv("{0:2}", jsonCache) << "\n";
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Deserialization
+//===----------------------------------------------------------------------===//
+
+/// Deserializes a non-negative integer from JSON.
+static bool countFromJSON(const ljson::Value &value, unsigned &count,
+                          ljson::Path path) {
+  std::optional<int64_t> number = value.getAsInteger();
+  if (!number || *number < 0) {
+    path.report("expected non-negative integer");
+    return false;
+  }
+  count = *number;
+  return true;
+}
+
+/// Deserializes a list of non-negative integers from JSON.
+template <typename Container>
+static bool countsFromJSON(const ljson::Value &value, Container &counts,
+                           ljson::Path path) {
+  const ljson::Array *array = value.getAsArray();
+  if (!array) {
+    path.report(ERR_EXPECTED_ARRAY);
+    return false;
+  }
+  for (auto [idx, elem] : llvm::enumerate(*array)) {
+    if (!countFromJSON(elem, counts.emplace_back(), path.index(idx)))
+      return false;
+  }
+  return true;
+}
+
+bool dynamatic::buffer::fromJSON(const ljson::Value &value,
+                                 PlacementResult &result, ljson::Path path) {
+  const ljson::Object *object = value.getAsObject();
+  if (!object) {
+    path.report(ERR_EXPECTED_OBJECT);
+    return false;
+  }
+  // Buffer types that are not placed are omitted
+  auto mapCount = [&](StringRef key, unsigned &count) {
+    const ljson::Value *countValue = object->get(key);
+    return !countValue || countFromJSON(*countValue, count, path.field(key));
+  };
+  if (!mapCount(KEY_ONE_SLOT_DV, result.numOneSlotDV) ||
+      !mapCount(KEY_ONE_SLOT_R, result.numOneSlotR) ||
+      !mapCount(KEY_FIFO_DV, result.numFifoDV) ||
+      !mapCount(KEY_FIFO_NONE, result.numFifoNone) ||
+      !mapCount(KEY_ONE_SLOT_DVR, result.numOneSlotDVR) ||
+      !mapCount(KEY_SHIFT_REG_DV, result.numShiftRegDV))
+    return false;
+  if (const ljson::Value *latencies = object->get(KEY_COUNTER_LATENCIES)) {
+    return countsFromJSON(*latencies, result.counterBufferLatencies,
+                          path.field(KEY_COUNTER_LATENCIES));
+  }
+  return true;
+}
+
+bool dynamatic::buffer::fromJSON(const ljson::Value &value, CachedArch &arch,
+                                 ljson::Path path) {
+  const ljson::Object *object = value.getAsObject();
+  if (!object) {
+    path.report(ERR_EXPECTED_OBJECT);
+    return false;
+  }
+  auto mapCount = [&](StringRef key, unsigned &count) {
+    const ljson::Value *countValue = object->get(key);
+    if (!countValue) {
+      path.field(key).report(ERR_MISSING_VALUE);
+      return false;
+    }
+    return countFromJSON(*countValue, count, path.field(key));
+  };
+  return mapCount("src", arch.srcBB) && mapCount("dst", arch.dstBB) &&
+         mapCount("trans", arch.numTrans);
+}
+
+bool dynamatic::buffer::fromJSON(const ljson::Value &value, CachedCFDFC &cfdfc,
+                                 ljson::Path path) {
+  ljson::ObjectMapper mapper(value, path);
+  int64_t numExecs;
+  if (!mapper || !mapper.map("num_execs", numExecs) ||
+      !mapper.map("throughput", cfdfc.throughput) ||
+      !mapper.map("occupancy", cfdfc.occupancy))
+    return false;
+  cfdfc.numExecs = numExecs;
+
+  const ljson::Value *cycle = value.getAsObject()->get("cycle");
+  if (!cycle) {
+    path.field("cycle").report(ERR_MISSING_VALUE);
+    return false;
+  }
+  return countsFromJSON(*cycle, cfdfc.cycle, path.field("cycle"));
+}
+
+bool dynamatic::buffer::fromJSON(const ljson::Value &value,
+                                 CachedFuncPlacement &placement,
+                                 ljson::Path path) {
+  ljson::ObjectMapper mapper(value, path);
+  return mapper && mapper.map("config", placement.config) &&
+         mapper.map("fingerprint", placement.fingerprint) &&
+         mapper.map("archs", placement.archs) &&
+         mapper.map("cfdfcs", placement.cfdfcs) &&
+         mapper.map("placement", placement.placement);
+}
+
+LogicalResult PlacementCache::read(StringRef path, PlacementCache &cache) {
+  std::ifstream inputFile(path.str());
+  if (!inputFile.is_open())
+    return success();
+
+  std::string jsonString;
+  std::string line;
+  while (std::getline(inputFile, line))
+    jsonString += line;
+
+  llvm::Expected<ljson::Value> value = ljson::parse(jsonString);
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    llvm::errs() << "Failed to parse buffer placement cache at \"" << path
+                 << "\"\n";
+    return failure();
+  }
+  const ljson::Object *obj = value->getAsObject();
+  const ljson::Object *functions = obj ? obj->getObject("functions") : nullptr;
+  if (!functions || obj->getInteger("format_version") != CACHE_FORMAT_VERSION) {
+    // A cache from an incompatible version of the flow is discarded, which
+    // places buffers from scratch
+    llvm::errs() << "Ignoring buffer placement cache at \"" << path
+                 << "\" with an unsupported format\n";
+    return success();
+  }
+
+  ljson::Path::Root jsonRoot(path);
+  ljson::Path functionsPath = ljson::Path(jsonRoot).field("functions");
+  for (const auto &[funcName, funcValue] : *functions) {
+    if (!fromJSON(funcValue, cache.functions[funcName],
+                  functionsPath.field(funcName))) {
+      llvm::errs() << "Failed to deserialize buffer placement cache at \""
+                   << path << "\"\n";
+      return failure();
+    }
+  }
+  return success();
+}
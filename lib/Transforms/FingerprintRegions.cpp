@@ -0,0 +1,161 @@
+//===- FingerprintRegions.cpp - Detect modified regions ---------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --fingerprint-regions pass, which fingerprints each function
+// and basic block of the IR and reports which of them changed since the
+// fingerprints were last recorded.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/Fingerprint.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include <fstream>
+
+// [START Boilerplate code for the MLIR pass]
+#include "dynamatic/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+#define GEN_PASS_DEF_FINGERPRINTREGIONS
+#include "dynamatic/Transforms/Passes.h.inc"
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+using namespace mlir;
+using namespace dynamatic;
+namespace ljson = llvm::json;
+
+/// Version of the fingerprints file's format, to be bumped on incompatible
+/// changes.
+static constexpr int64_t FINGERPRINTS_FORMAT_VERSION = 1;
+
+namespace {
+
+struct FingerprintRegionsPass
+    : public dynamatic::impl::FingerprintRegionsBase<FingerprintRegionsPass> {
+
+  using FingerprintRegionsBase::FingerprintRegionsBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Reads the previously recorded fingerprints of each function. Succeeds
+  /// without reading anything if no fingerprints were recorded yet.
+  LogicalResult
+  readFingerprints(llvm::StringMap<FuncFingerprint> &priorFingerprints);
+
+  /// Records the fingerprints of each function to disk.
+  LogicalResult writeFingerprints(ljson::Object &functions);
+};
+
+} // namespace
+
+LogicalResult FingerprintRegionsPass::readFingerprints(
+    llvm::StringMap<FuncFingerprint> &priorFingerprints) {
+  std::ifstream inputFile(fingerprints);
+  if (!inputFile.is_open())
+    return success();
+
+  std::string jsonString;
+  std::string line;
+  while (std::getline(inputFile, line))
+    jsonString += line;
+
+  llvm::Expected<ljson::Value> value = ljson::parse(jsonString);
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    llvm::errs() << "Failed to parse fingerprints at \"" << fingerprints
+                 << "\"\n";
+    return failure();
+  }
+  const ljson::Object *obj = value->getAsObject();
+  const ljson::Object *functions = obj ? obj->getObject("functions") : nullptr;
+  if (!functions ||
+      obj->getInteger("format_version") != FINGERPRINTS_FORMAT_VERSION) {
+    // Fingerprints from an incompatible version of the flow are discarded,
+    // which recompiles everything
+    llvm::errs() << "Ignoring fingerprints at \"" << fingerprints
+                 << "\" with an unsupported format\n";
+    return success();
+  }
+
+  ljson::Path::Root jsonRoot(fingerprints);
+  ljson::Path functionsPath = ljson::Path(jsonRoot).field("functions");
+  for (const auto &[funcName, funcValue] : *functions) {
+    if (!fromJSON(funcValue, priorFingerprints[funcName],
+                  functionsPath.field(funcName))) {
+      llvm::errs() << "Failed to deserialize fingerprints at \"" << fingerprints
+                   << "\"\n";
+      return failure();
+    }
+  }
+  return success();
+}
+
+LogicalResult
+FingerprintRegionsPass::writeFingerprints(ljson::Object &functions) {
+  std::error_code ec;
+  llvm::raw_fd_ostream out(fingerprints, ec, llvm::sys::fs::OF_Text);
+  if (ec) {
+    llvm::errs() << "Failed to open fingerprints at \"" << fingerprints
+                 << "\": " << ec.message() << "\n";
+    return failure();
+  }
+  ljson::Value jsonFingerprints = ljson::Object{
+      {"format_version", FINGERPRINTS_FORMAT_VERSION},
+      {"functions", std::move(functions)},
+  };
+  out << llvm::formatv("{0:2}", jsonFingerprints) << "\n";
+  return success();
+}
+
+void FingerprintRegionsPass::runDynamaticPass() {
+  llvm::StringMap<FuncFingerprint> priorFingerprints;
+  if (!fingerprints.empty() && failed(readFingerprints(priorFingerprints)))
+    return signalPassFailure();
+
+  ljson::Object functions;
+  for (Operation &op : getOperation().getOps()) {
+    // Skip external functions, which have nothing to fingerprint
+    if (!isa<func::FuncOp, handshake::FuncOp>(op) || op.getRegion(0).empty())
+      continue;
+    StringRef funcName = SymbolTable::getSymbolName(&op).getValue();
+
+    FuncFingerprint fingerprint = FuncFingerprint::get(&op);
+    functions[funcName] = toJSON(fingerprint);
+
+    size_t numBlocks = fingerprint.blocks.size();
+    auto priorIt = priorFingerprints.find(funcName);
+    if (priorIt == priorFingerprints.end()) {
+      llvm::errs() << llvm::formatv(
+          "[{0}] {1}: no prior fingerprint, all {2} basic blocks modified\n",
+          label, funcName, numBlocks);
+      continue;
+    }
+    if (priorIt->second.func == fingerprint.func) {
+      llvm::errs() << llvm::formatv("[{0}] {1}: unchanged\n", label, funcName);
+      continue;
+    }
+
+    // The function may also differ only in its signature or in operations
+    // outside of all basic blocks
+    std::set<unsigned> modified =
+        fingerprint.getModifiedBlocks(priorIt->second);
+    llvm::errs() << llvm::formatv(
+        "[{0}] {1}: {2} of {3} basic blocks modified{4}\n", label, funcName,
+        modified.size(), numBlocks,
+        modified.empty() ? "" : " (" + getBlockList(modified) + ")");
+  }
+
+  if (!fingerprints.empty() && failed(writeFingerprints(functions)))
+    return signalPassFailure();
+  markAllAnalysesPreserved();
+}
@@ -0,0 +1,160 @@
+//===- HandshakeEstimateCosts.cpp - Per-pass cost report --------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --handshake-estimate-costs pass, which reports the area and
+// critical path delay of Handshake functions estimated by the shared cost
+// model.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/CostModel.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include <fstream>
+
+// [START Boilerplate code for the MLIR pass]
+#include "dynamatic/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+#define GEN_PASS_DEF_HANDSHAKEESTIMATECOSTS
+#include "dynamatic/Transforms/Passes.h.inc"
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+using namespace mlir;
+using namespace dynamatic;
+namespace ljson = llvm::json;
+
+/// Version of the report's format, to be bumped on incompatible changes.
+static constexpr int64_t REPORT_FORMAT_VERSION = 1;
+
+namespace {
+
+struct HandshakeEstimateCostsPass
+    : public dynamatic::impl::HandshakeEstimateCostsBase<
+          HandshakeEstimateCostsPass> {
+
+  using HandshakeEstimateCostsBase::HandshakeEstimateCostsBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Reads the entries of the existing report into the array. Succeeds without
+  /// adding anything if the report does not exist yet.
+  LogicalResult readReport(ljson::Array &entries);
+
+  /// Writes the report with the given entries to disk.
+  LogicalResult writeReport(ljson::Array &entries);
+};
+
+} // namespace
+
+/// Returns the most recent entry of the report for the function, if any.
+static const ljson::Object *findLastEntry(const ljson::Array &entries,
+                                          StringRef funcName) {
+  for (const ljson::Value &entry : llvm::reverse(entries)) {
+    const ljson::Object *obj = entry.getAsObject();
+    if (!obj)
+      continue;
+    if (std::optional<StringRef> name = obj->getString("function");
+        name && *name == funcName)
+      return obj;
+  }
+  return nullptr;
+}
+
+LogicalResult HandshakeEstimateCostsPass::readReport(ljson::Array &entries) {
+  std::ifstream inputFile(report);
+  if (!inputFile.is_open())
+    return success();
+
+  std::string jsonString;
+  std::string line;
+  while (std::getline(inputFile, line))
+    jsonString += line;
+
+  llvm::Expected<ljson::Value> value = ljson::parse(jsonString);
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    llvm::errs() << "Failed to parse cost report at \"" << report << "\"\n";
+    return failure();
+  }
+  const ljson::Object *obj = value->getAsObject();
+  const ljson::Array *oldEntries = obj ? obj->getArray("entries") : nullptr;
+  if (!oldEntries ||
+      obj->getInteger("format_version") != REPORT_FORMAT_VERSION) {
+    llvm::errs() << "Cost report at \"" << report
+                 << "\" has an unsupported format\n";
+    return failure();
+  }
+  entries = *oldEntries;
+  return success();
+}
+
+LogicalResult HandshakeEstimateCostsPass::writeReport(ljson::Array &entries) {
+  std::error_code ec;
+  llvm::raw_fd_ostream out(report, ec, llvm::sys::fs::OF_Text);
+  if (ec) {
+    llvm::errs() << "Failed to open cost report at \"" << report
+                 << "\": " << ec.message() << "\n";
+    return failure();
+  }
+  ljson::Value jsonReport = ljson::Object{
+      {"format_version", REPORT_FORMAT_VERSION},
+      {"entries", std::move(entries)},
+  };
+  out << llvm::formatv("{0:2}", jsonReport) << "\n";
+  return success();
+}
+
+void HandshakeEstimateCostsPass::runDynamaticPass() {
+  FailureOr<CostModel *> costModel = CostModel::get(timingModels, targetCP);
+  if (failed(costModel))
+    return signalPassFailure();
+
+  ljson::Array entries;
+  if (!report.empty() && failed(readReport(entries)))
+    return signalPassFailure();
+
+  for (handshake::FuncOp funcOp :
+       getOperation().getOps<handshake::FuncOp>()) {
+    FuncCost cost = (*costModel)->getFuncCost(funcOp);
+    StringRef funcName = funcOp.getName();
+
+    if (report.empty()) {
+      llvm::errs() << llvm::formatv(
+          "[{0}] {1}: area = {2:f1} LUTs ({3} of {4} units uncharacterized), "
+          "critical path = {5:f3} ns\n",
+          label, funcName, cost.area, cost.numUncharacterized, cost.numUnits,
+          cost.criticalPathDelay);
+      continue;
+    }
+
+    ljson::Object entry{
+        {"label", label},
+        {"function", funcName.str()},
+        {"area", cost.area},
+        {"critical_path_delay", cost.criticalPathDelay},
+        {"num_units", cost.numUnits},
+        {"num_uncharacterized_units", cost.numUncharacterized},
+    };
+    if (const ljson::Object *lastEntry = findLastEntry(entries, funcName)) {
+      entry["delta_area"] =
+          cost.area - lastEntry->getNumber("area").value_or(0.0);
+      entry["delta_critical_path_delay"] =
+          cost.criticalPathDelay -
+          lastEntry->getNumber("critical_path_delay").value_or(0.0);
+    }
+    entries.push_back(std::move(entry));
+  }
+
+  if (!report.empty() && failed(writeReport(entries)))
+    return signalPassFailure();
+}
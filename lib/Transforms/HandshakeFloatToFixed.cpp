@@ -0,0 +1,813 @@
+//===- HandshakeFloatToFixed.cpp - Floating to fixed-point ------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --handshake-float-to-fixed pass, which converts regions of
+// floating-point arithmetic into fixed-point integer arithmetic.
+//
+// A region is a connected set of floating-point additions, subtractions,
+// multiplications, divisions, forks, branches, and loop-carried merges whose
+// outputs all go to floating-point to integer conversions. Its inputs may come
+// from integer to floating-point conversions, floating-point constants, or
+// loads and function arguments whose range of values is declared with the
+// `handshake.float_range` attribute, e.g., by the user or from profiling.
+// Merges and muxes, which carry values around loops, also need a declared
+// range, since interval arithmetic cannot bound them. Converted loads and
+// function arguments keep a scaling multiplication and a floating-point to
+// integer conversion at the region's boundary; other regions are replaced by
+// integer arithmetic without any floating-point unit left.
+//
+// For each region, value ranges are derived from the declared ranges and from
+// the integer ranges of the region's inputs (see `ChannelRangeAnalysis`) using
+// interval arithmetic. The pass then picks the smallest number of fractional
+// bits for which the estimated worst-case error at every region output stays
+// within the user-provided error bound, and the number of integer bits needed
+// to never overflow. Errors on loop-carried values are accumulated over at
+// most a user-provided number of loop iterations. The bitwidth optimization
+// pass is expected to run afterwards to narrow each value individually.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/ChannelRangeAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
+#include "dynamatic/Support/CFG.h"
+#include "mlir/IR/PatternMatch.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include <cmath>
+
+// [START Boilerplate code for the MLIR pass]
+#include "dynamatic/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+#define GEN_PASS_DEF_HANDSHAKEFLOATTOFIXED
+#include "dynamatic/Transforms/Passes.h.inc"
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+using namespace mlir;
+using namespace dynamatic;
+
+/// Maximum bitwidth of the fixed-point datapath.
+static constexpr unsigned MAX_FIXED_WIDTH = 64;
+
+/// Bitwidth of the integers floating-point inputs are converted to.
+static constexpr unsigned INPUT_CONVERSION_WIDTH = 32;
+
+/// Name of the `DenseF64ArrayAttr` declaring the lower and upper bounds of the
+/// values carried by a floating-point channel. It may be set on loads, merges,
+/// and muxes, or on function arguments.
+static constexpr llvm::StringLiteral FLOAT_RANGE_ATTR = "handshake.float_range";
+
+namespace {
+
+/// A closed interval of real numbers.
+struct Interval {
+  double lb, ub;
+
+  /// Returns the largest absolute value in the interval.
+  double maxAbs() const { return std::max(std::abs(lb), std::abs(ub)); }
+
+  /// Returns the smallest absolute value in the interval.
+  double minAbs() const {
+    if (lb <= 0 && ub >= 0)
+      return 0;
+    return std::min(std::abs(lb), std::abs(ub));
+  }
+};
+
+/// A connected region of floating-point operations convertible to fixed-point.
+struct FloatRegion {
+  /// All floating-point values in the region.
+  llvm::SetVector<Value> values;
+  /// Operations producing the region's floating-point inputs.
+  llvm::SetVector<Operation *> inputs;
+  /// Loaded values and function arguments converted to fixed-point at the
+  /// region's boundary.
+  llvm::SetVector<Value> floatInputs;
+  /// Operations internal to the region.
+  llvm::SetVector<Operation *> internal;
+  /// Conversions consuming the region's floating-point outputs.
+  llvm::SetVector<handshake::FPToSIOp> outputs;
+};
+
+/// A fixed-point format shared by all values of a region.
+struct FixedFormat {
+  /// Number of fractional bits.
+  unsigned fracBits;
+  /// Total bitwidth.
+  unsigned width;
+  /// Estimated worst-case absolute error over all region outputs.
+  double maxError;
+};
+
+} // namespace
+
+/// Returns the declared range of the value, if any.
+static std::optional<Interval> getDeclaredRange(Value val) {
+  DenseF64ArrayAttr attr;
+  if (auto arg = dyn_cast<BlockArgument>(val)) {
+    Operation *parentOp = arg.getOwner()->getParentOp();
+    if (auto funcOp = dyn_cast<handshake::FuncOp>(parentOp))
+      attr = funcOp.getArgAttrOfType<DenseF64ArrayAttr>(arg.getArgNumber(),
+                                                        FLOAT_RANGE_ATTR);
+  } else {
+    attr = val.getDefiningOp()->getAttrOfType<DenseF64ArrayAttr>(
+        FLOAT_RANGE_ATTR);
+  }
+  if (!attr || attr.size() != 2 || attr[0] > attr[1])
+    return std::nullopt;
+  return Interval{attr[0], attr[1]};
+}
+
+/// Determines whether the value is a channel carrying floating-point data.
+static bool isFloatChannel(Value val) {
+  auto channelType = dyn_cast<handshake::ChannelType>(val.getType());
+  return channelType && isa<FloatType>(channelType.getDataType());
+}
+
+/// Determines whether the value is a loaded value or function argument that
+/// can be converted to fixed-point at the region's boundary. Such values need
+/// a declared range, and must be single-precision like the inputs of
+/// floating-point to integer conversions.
+static bool isFloatInput(Value val) {
+  if (!isa<BlockArgument>(val) && !val.getDefiningOp<handshake::LoadOp>())
+    return false;
+  auto channelType = dyn_cast<handshake::ChannelType>(val.getType());
+  return channelType && channelType.getDataType().isF32() &&
+         getDeclaredRange(val);
+}
+
+/// Determines whether the operation produces a region input.
+static bool isRegionInput(Operation *op) {
+  if (isa<handshake::SIToFPOp, handshake::UIToFPOp>(op))
+    return true;
+  if (auto cstOp = dyn_cast<handshake::ConstantOp>(op))
+    return isa<FloatAttr>(cstOp.getValue());
+  return false;
+}
+
+/// Determines whether the operation may be internal to a region.
+static bool isRegionInternal(Operation *op) {
+  if (isa<handshake::AddFOp, handshake::SubFOp, handshake::MulFOp,
+          handshake::DivFOp>(op))
+    return true;
+  if (isa<handshake::ForkOp, handshake::ConditionalBranchOp>(op))
+    return isFloatChannel(op->getResult(0));
+  // Values carried around loops cannot be bounded by interval arithmetic
+  if (isa<handshake::MergeOp, handshake::MuxOp>(op))
+    return isFloatChannel(op->getResult(0)) &&
+           getDeclaredRange(op->getResult(0));
+  return false;
+}
+
+/// Collects the region containing the internal operation. Fails if the
+/// region has inputs or outputs that cannot be converted.
+static FailureOr<FloatRegion> collectRegion(Operation *startOp) {
+  FloatRegion region;
+  SmallVector<Value> worklist;
+  auto addInternal = [&](Operation *op) {
+    if (!region.internal.insert(op))
+      return;
+    // Mux selects and branch conditions remain integers
+    llvm::append_range(worklist,
+                       llvm::make_filter_range(op->getOperands(),
+                                               isFloatChannel));
+    llvm::append_range(worklist, op->getResults());
+  };
+  addInternal(startOp);
+
+  while (!worklist.empty()) {
+    Value val = worklist.pop_back_val();
+    if (!region.values.insert(val))
+      continue;
+
+    Operation *defOp = val.getDefiningOp();
+    if (isFloatInput(val))
+      region.floatInputs.insert(val);
+    else if (!defOp)
+      return failure();
+    else if (isRegionInput(defOp))
+      region.inputs.insert(defOp);
+    else if (isRegionInternal(defOp))
+      addInternal(defOp);
+    else
+      return failure();
+
+    for (Operation *user : val.getUsers()) {
+      if (auto fptosiOp = dyn_cast<handshake::FPToSIOp>(user))
+        region.outputs.insert(fptosiOp);
+      else if (isRegionInternal(user))
+        addInternal(user);
+      else if (!isa<handshake::SinkOp>(user))
+        return failure();
+    }
+  }
+  return region;
+}
+
+/// Creates an operation of the given type at the location and in the basic
+/// block of an existing operation.
+template <typename OpTy, typename... Args>
+static OpTy createFrom(Operation *fromOp, RewriterBase &rewriter,
+                       Args &&...args) {
+  OpTy newOp =
+      rewriter.create<OpTy>(fromOp->getLoc(), std::forward<Args>(args)...);
+  inheritBB(fromOp, newOp);
+  return newOp;
+}
+
+namespace {
+
+/// Estimates value ranges and errors within a region, and rewrites it in
+/// fixed-point arithmetic.
+class RegionConverter {
+public:
+  RegionConverter(FloatRegion &region, ChannelRangeAnalysis &intRanges,
+                  unsigned maxLoopIterations)
+      : region(region), intRanges(intRanges),
+        maxLoopIterations(maxLoopIterations) {}
+
+  /// Returns the real-valued interval of the region value.
+  Interval getInterval(Value val);
+
+  /// Returns the worst-case absolute error of the region value when
+  /// represented with the given number of fractional bits, or std::nullopt if
+  /// the error cannot be bounded.
+  std::optional<double> getError(Value val, unsigned fracBits);
+
+  /// Returns the bitwidth needed to hold all region values, as well as all
+  /// intermediate products, with the given number of fractional bits.
+  unsigned getRequiredWidth(unsigned fracBits);
+
+  /// Determines whether all floating-point inputs, scaled by the given number
+  /// of fractional bits, fit in the integers they are converted to.
+  bool canConvertInputs(unsigned fracBits);
+
+  /// Replaces the region with fixed-point arithmetic in the given format.
+  void rewrite(const FixedFormat &format, RewriterBase &rewriter);
+
+private:
+  FloatRegion &region;
+  ChannelRangeAnalysis &intRanges;
+  /// Maximum number of iterations over which errors on loop-carried values
+  /// accumulate.
+  unsigned maxLoopIterations;
+  DenseMap<Value, Interval> intervals;
+  DenseMap<Value, std::optional<double>> errors;
+  /// Number of fractional bits the cached errors were computed for.
+  unsigned errorsFracBits = 0;
+  DenseMap<Value, Value> fixedValues;
+
+  /// Returns the worst-case absolute error of a merged value, which may be
+  /// carried around a loop, or std::nullopt if it cannot be bounded.
+  std::optional<double> getMergeError(Value val, ValueRange inputs,
+                                      unsigned fracBits);
+
+  /// Returns the fixed-point version of a region value, creating it if needed.
+  Value getFixed(Value val, const FixedFormat &format, RewriterBase &rewriter);
+
+  /// Creates a sourced integer constant of the given width.
+  Value createConstant(Operation *fromOp, int64_t value, unsigned width,
+                       RewriterBase &rewriter);
+};
+} // namespace
+
+Interval RegionConverter::getInterval(Value val) {
+  if (auto it = intervals.find(val); it != intervals.end())
+    return it->second;
+
+  // Declared ranges are the only ones known for floating-point inputs and
+  // loop-carried values
+  if (std::optional<Interval> declared = getDeclaredRange(val)) {
+    intervals.insert({val, *declared});
+    return *declared;
+  }
+
+  Operation *defOp = val.getDefiningOp();
+  Interval itv =
+      llvm::TypeSwitch<Operation *, Interval>(defOp)
+          .Case<handshake::SIToFPOp>([&](handshake::SIToFPOp op) {
+            llvm::ConstantRange range = intRanges.getRange(op.getIn());
+            return Interval{
+                static_cast<double>(range.getSignedMin().getSExtValue()),
+                static_cast<double>(range.getSignedMax().getSExtValue())};
+          })
+          .Case<handshake::UIToFPOp>([&](handshake::UIToFPOp op) {
+            llvm::ConstantRange range = intRanges.getRange(op.getIn());
+            return Interval{
+                static_cast<double>(range.getUnsignedMin().getZExtValue()),
+                static_cast<double>(range.getUnsignedMax().getZExtValue())};
+          })
+          .Case<handshake::ConstantOp>([&](handshake::ConstantOp op) {
+            double cst = cast<FloatAttr>(op.getValue()).getValueAsDouble();
+            return Interval{cst, cst};
+          })
+          .Case<handshake::ForkOp>([&](handshake::ForkOp op) {
+            return getInterval(op.getOperand());
+          })
+          .Case<handshake::ConditionalBranchOp>(
+              [&](handshake::ConditionalBranchOp op) {
+                return getInterval(op.getDataOperand());
+              })
+          .Case<handshake::AddFOp>([&](handshake::AddFOp op) {
+            Interval l = getInterval(op.getLhs()), r = getInterval(op.getRhs());
+            return Interval{l.lb + r.lb, l.ub + r.ub};
+          })
+          .Case<handshake::SubFOp>([&](handshake::SubFOp op) {
+            Interval l = getInterval(op.getLhs()), r = getInterval(op.getRhs());
+            return Interval{l.lb - r.ub, l.ub - r.lb};
+          })
+          .Case<handshake::MulFOp>([&](handshake::MulFOp op) {
+            Interval l = getInterval(op.getLhs()), r = getInterval(op.getRhs());
+            double p[] = {l.lb * r.lb, l.lb * r.ub, l.ub * r.lb, l.ub * r.ub};
+            return Interval{*std::min_element(p, p + 4),
+                            *std::max_element(p, p + 4)};
+          })
+          .Case<handshake::DivFOp>([&](handshake::DivFOp op) {
+            Interval l = getInterval(op.getLhs()), r = getInterval(op.getRhs());
+            if (r.minAbs() == 0)
+              return Interval{-INFINITY, INFINITY};
+            double q[] = {l.lb / r.lb, l.lb / r.ub, l.ub / r.lb, l.ub / r.ub};
+            return Interval{*std::min_element(q, q + 4),
+                            *std::max_element(q, q + 4)};
+          })
+          .Default([](auto) { return Interval{-INFINITY, INFINITY}; });
+  intervals.insert({val, itv});
+  return itv;
+}
+
+std::optional<double> RegionConverter::getError(Value val, unsigned fracBits) {
+  // Cached errors are only valid for a single format
+  if (fracBits != errorsFracBits) {
+    errors.clear();
+    errorsFracBits = fracBits;
+  }
+  if (auto it = errors.find(val); it != errors.end())
+    return it->second;
+
+  // Error introduced by truncating the result of a multiplication or division
+  double ulp = std::ldexp(1.0, -static_cast<int>(fracBits));
+
+  // Converting floating-point inputs truncates them toward zero
+  if (region.floatInputs.contains(val)) {
+    errors.insert({val, ulp});
+    return ulp;
+  }
+  Operation *defOp = val.getDefiningOp();
+
+  auto binary = [&](Value lhs, Value rhs,
+                    auto fun) -> std::optional<double> {
+    std::optional<double> el = getError(lhs, fracBits);
+    std::optional<double> er = getError(rhs, fracBits);
+    if (!el || !er)
+      return std::nullopt;
+    return fun(*el, *er, getInterval(lhs), getInterval(rhs));
+  };
+
+  std::optional<double> err =
+      llvm::TypeSwitch<Operation *, std::optional<double>>(defOp)
+          .Case<handshake::SIToFPOp, handshake::UIToFPOp>(
+              [&](auto) { return 0.0; })
+          .Case<handshake::ConstantOp>([&](handshake::ConstantOp op) {
+            double cst = cast<FloatAttr>(op.getValue()).getValueAsDouble();
+            return std::abs(cst - std::round(cst / ulp) * ulp);
+          })
+          .Case<handshake::ForkOp>([&](handshake::ForkOp op) {
+            return getError(op.getOperand(), fracBits);
+          })
+          .Case<handshake::ConditionalBranchOp>(
+              [&](handshake::ConditionalBranchOp op) {
+                return getError(op.getDataOperand(), fracBits);
+              })
+          .Case<handshake::MergeOp, handshake::MuxOp>([&](auto op) {
+            return getMergeError(val, op.getDataOperands(), fracBits);
+          })
+          .Case<handshake::AddFOp, handshake::SubFOp>([&](auto op) {
+            return binary(op.getLhs(), op.getRhs(),
+                          [](double el, double er, Interval, Interval) {
+                            return el + er;
+                          });
+          })
+          .Case<handshake::MulFOp>([&](handshake::MulFOp op) {
+            return binary(op.getLhs(), op.getRhs(),
+                          [&](double el, double er, Interval l, Interval r) {
+                            return l.maxAbs() * er + r.maxAbs() * el +
+                                   el * er + ulp;
+                          });
+          })
+          .Case<handshake::DivFOp>(
+              [&](handshake::DivFOp op) -> std::optional<double> {
+                Interval r = getInterval(op.getRhs());
+                std::optional<double> rhsErr = getError(op.getRhs(), fracBits);
+                // The divisor's representation must never get close to 0
+                if (!rhsErr || r.minAbs() <= *rhsErr)
+                  return std::nullopt;
+                double q = getInterval(op.getResult()).maxAbs();
+                return binary(op.getLhs(), op.getRhs(),
+                              [&](double el, double er, Interval, Interval) {
+                                return (el + q * er) / (r.minAbs() - er) + ulp;
+                              });
+              });
+  errors.insert({val, err});
+  return err;
+}
+
+std::optional<double> RegionConverter::getMergeError(Value val,
+                                                     ValueRange inputs,
+                                                     unsigned fracBits) {
+  // The error on a loop-carried value may grow with every iteration. Starting
+  // from an exact value, propagate errors around the loop until they stop
+  // growing or the maximum number of iterations is reached. Errors computed
+  // from a provisional error on the merged value are discarded after each step
+  double err = 0;
+  for (unsigned iter = 0; iter < std::max(maxLoopIterations, 1u); ++iter) {
+    DenseMap<Value, std::optional<double>> savedErrors = errors;
+    errors[val] = err;
+    std::optional<double> nextErr = 0.0;
+    for (Value in : inputs) {
+      std::optional<double> inErr = getError(in, fracBits);
+      if (!inErr) {
+        nextErr = std::nullopt;
+        break;
+      }
+      nextErr = std::max(*nextErr, *inErr);
+    }
+    errors = std::move(savedErrors);
+    if (!nextErr)
+      return std::nullopt;
+    if (*nextErr <= err)
+      return err;
+    err = *nextErr;
+  }
+  return err;
+}
+
+unsigned RegionConverter::getRequiredWidth(unsigned fracBits) {
+  double scale = std::ldexp(1.0, fracBits);
+  double maxMagnitude = 0;
+  for (Value val : region.values)
+    maxMagnitude = std::max(maxMagnitude, getInterval(val).maxAbs() * scale);
+
+  // Products and shifted dividends are computed before rescaling
+  for (Operation *op : region.internal) {
+    if (isa<handshake::MulFOp, handshake::DivFOp>(op)) {
+      double lhs = getInterval(op->getOperand(0)).maxAbs() * scale;
+      double rhs = isa<handshake::MulFOp>(op)
+                       ? getInterval(op->getOperand(1)).maxAbs() * scale
+                       : scale;
+      maxMagnitude = std::max(maxMagnitude, lhs * rhs);
+    }
+  }
+  if (!std::isfinite(maxMagnitude))
+    return std::numeric_limits<unsigned>::max();
+
+  // One sign bit and one bit of slack to absorb representation errors
+  return static_cast<unsigned>(std::ceil(std::log2(maxMagnitude + 1))) + 2;
+}
+
+bool RegionConverter::canConvertInputs(unsigned fracBits) {
+  double limit = std::ldexp(1.0, INPUT_CONVERSION_WIDTH - 1);
+  return llvm::all_of(region.floatInputs, [&](Value val) {
+    return std::ldexp(getInterval(val).maxAbs(), fracBits) < limit;
+  });
+}
+
+Value RegionConverter::createConstant(Operation *fromOp, int64_t value,
+                                      unsigned width, RewriterBase &rewriter) {
+  auto srcOp = createFrom<handshake::SourceOp>(fromOp, rewriter);
+  IntegerAttr attr =
+      rewriter.getIntegerAttr(rewriter.getIntegerType(width), value);
+  return createFrom<handshake::ConstantOp>(fromOp, rewriter, attr,
+                                           srcOp.getResult())
+      .getResult();
+}
+
+Value RegionConverter::getFixed(Value val, const FixedFormat &format,
+                                RewriterBase &rewriter) {
+  if (auto it = fixedValues.find(val); it != fixedValues.end())
+    return it->second;
+
+  Operation *defOp = val.getDefiningOp();
+  auto floatType = cast<handshake::ChannelType>(val.getType());
+  handshake::ChannelType fixedType =
+      floatType.withDataType(rewriter.getIntegerType(format.width));
+  auto shiftAmount = [&]() {
+    return createConstant(defOp, format.fracBits, format.width, rewriter);
+  };
+
+  // Resizes an integer to the datapath's width
+  auto resize = [&](Operation *fromOp, Value in, bool isSigned) -> Value {
+    unsigned inWidth = cast<handshake::ChannelType>(in.getType())
+                           .getDataBitWidth();
+    if (inWidth < format.width && isSigned)
+      return createFrom<handshake::ExtSIOp>(fromOp, rewriter, fixedType, in);
+    if (inWidth < format.width)
+      return createFrom<handshake::ExtUIOp>(fromOp, rewriter, fixedType, in);
+    if (inWidth > format.width)
+      return createFrom<handshake::TruncIOp>(fromOp, rewriter, fixedType, in);
+    return in;
+  };
+
+  // Floating-point inputs are scaled and converted to integers, truncating
+  // toward zero
+  if (region.floatInputs.contains(val)) {
+    Operation *fromOp = defOp;
+    if (defOp) {
+      rewriter.setInsertionPointAfter(defOp);
+    } else {
+      fromOp = *val.getUsers().begin();
+      rewriter.setInsertionPoint(fromOp);
+    }
+    Value scaled = val;
+    if (format.fracBits != 0) {
+      auto srcOp = createFrom<handshake::SourceOp>(fromOp, rewriter);
+      FloatAttr attr =
+          rewriter.getF32FloatAttr(std::ldexp(1.0f, format.fracBits));
+      auto scaleOp = createFrom<handshake::ConstantOp>(fromOp, rewriter, attr,
+                                                       srcOp.getResult());
+      scaled = createFrom<handshake::MulFOp>(fromOp, rewriter, floatType, val,
+                                             scaleOp.getResult());
+    }
+    handshake::ChannelType intType = floatType.withDataType(
+        rewriter.getIntegerType(INPUT_CONVERSION_WIDTH));
+    Value in =
+        createFrom<handshake::FPToSIOp>(fromOp, rewriter, intType, scaled);
+    Value fixed = resize(fromOp, in, true);
+    fixedValues.insert({val, fixed});
+    return fixed;
+  }
+
+  // Results of forks and branches are all created at once
+  if (isa<handshake::ForkOp, handshake::ConditionalBranchOp>(defOp)) {
+    Operation *newOp;
+    if (auto forkOp = dyn_cast<handshake::ForkOp>(defOp)) {
+      Value fixedIn = getFixed(forkOp.getOperand(), format, rewriter);
+      rewriter.setInsertionPoint(forkOp);
+      newOp = createFrom<handshake::ForkOp>(forkOp, rewriter, fixedIn,
+                                            forkOp->getNumResults());
+    } else {
+      auto brOp = cast<handshake::ConditionalBranchOp>(defOp);
+      Value fixedIn = getFixed(brOp.getDataOperand(), format, rewriter);
+      rewriter.setInsertionPoint(brOp);
+      newOp = createFrom<handshake::ConditionalBranchOp>(
+          brOp, rewriter, brOp.getConditionOperand(), fixedIn);
+    }
+    for (auto [oldRes, newRes] :
+         llvm::zip(defOp->getResults(), newOp->getResults()))
+      fixedValues.insert({oldRes, newRes});
+    return fixedValues.lookup(val);
+  }
+
+  // Integer inputs are resized to the datapath's width and scaled
+  auto fromInt = [&](Value in, bool isSigned) -> Value {
+    rewriter.setInsertionPoint(defOp);
+    Value resized = resize(defOp, in, isSigned);
+    if (format.fracBits == 0)
+      return resized;
+    return createFrom<handshake::ShLIOp>(defOp, rewriter, fixedType, resized,
+                                         shiftAmount());
+  };
+
+  // Binary operations first convert both their operands
+  auto binary = [&](auto fun) -> Value {
+    Value lhs = getFixed(defOp->getOperand(0), format, rewriter);
+    Value rhs = getFixed(defOp->getOperand(1), format, rewriter);
+    rewriter.setInsertionPoint(defOp);
+    return fun(lhs, rhs);
+  };
+
+  Value fixed =
+      llvm::TypeSwitch<Operation *, Value>(defOp)
+          .Case<handshake::SIToFPOp>([&](handshake::SIToFPOp op) {
+            return fromInt(op.getIn(), true);
+          })
+          .Case<handshake::UIToFPOp>([&](handshake::UIToFPOp op) {
+            return fromInt(op.getIn(), false);
+          })
+          .Case<handshake::ConstantOp>([&](handshake::ConstantOp op) {
+            rewriter.setInsertionPoint(op);
+            double cst = cast<FloatAttr>(op.getValue()).getValueAsDouble();
+            auto fixedCst = static_cast<int64_t>(
+                std::round(std::ldexp(cst, format.fracBits)));
+            IntegerAttr attr = rewriter.getIntegerAttr(
+                rewriter.getIntegerType(format.width), fixedCst);
+            return createFrom<handshake::ConstantOp>(op, rewriter, attr,
+                                                     op.getCtrl())
+                .getResult();
+          })
+          .Case<handshake::AddFOp>([&](auto) {
+            return binary([&](Value lhs, Value rhs) -> Value {
+              return createFrom<handshake::AddIOp>(defOp, rewriter, fixedType,
+                                                   lhs, rhs);
+            });
+          })
+          .Case<handshake::SubFOp>([&](auto) {
+            return binary([&](Value lhs, Value rhs) -> Value {
+              return createFrom<handshake::SubIOp>(defOp, rewriter, fixedType,
+                                                   lhs, rhs);
+            });
+          })
+          .Case<handshake::MulFOp>([&](auto) {
+            return binary([&](Value lhs, Value rhs) -> Value {
+              Value prod = createFrom<handshake::MulIOp>(defOp, rewriter,
+                                                         fixedType, lhs, rhs);
+              if (format.fracBits == 0)
+                return prod;
+              return createFrom<handshake::ShRSIOp>(defOp, rewriter, fixedType,
+                                                    prod, shiftAmount());
+            });
+          })
+          .Case<handshake::DivFOp>([&](auto) {
+            return binary([&](Value lhs, Value rhs) -> Value {
+              if (format.fracBits != 0)
+                lhs = createFrom<handshake::ShLIOp>(defOp, rewriter, fixedType,
+                                                    lhs, shiftAmount());
+              return createFrom<handshake::DivSIOp>(defOp, rewriter, fixedType,
+                                                    lhs, rhs);
+            });
+          });
+  fixedValues.insert({val, fixed});
+  return fixed;
+}
+
+void RegionConverter::rewrite(const FixedFormat &format,
+                              RewriterBase &rewriter) {
+  // Loop-carried values are created first and only get their fixed-point
+  // operands at the end, so that converting the loop they close does not
+  // come back to them
+  SmallVector<Operation *> newMergeOps;
+  for (Operation *op : region.internal) {
+    if (!isa<handshake::MergeOp, handshake::MuxOp>(op))
+      continue;
+    auto floatType = cast<handshake::ChannelType>(op->getResult(0).getType());
+    handshake::ChannelType fixedType =
+        floatType.withDataType(rewriter.getIntegerType(format.width));
+    rewriter.setInsertionPoint(op);
+    Operation *newOp =
+        llvm::TypeSwitch<Operation *, Operation *>(op)
+            .Case<handshake::MergeOp>([&](handshake::MergeOp mergeOp) {
+              return createFrom<handshake::MergeOp>(
+                  mergeOp, rewriter, fixedType, mergeOp.getDataOperands());
+            })
+            .Case<handshake::MuxOp>([&](handshake::MuxOp muxOp) {
+              return createFrom<handshake::MuxOp>(
+                  muxOp, rewriter, fixedType, muxOp.getSelectOperand(),
+                  muxOp.getDataOperands());
+            });
+    fixedValues.insert({op->getResult(0), newOp->getResult(0)});
+    newMergeOps.push_back(newOp);
+  }
+
+  // Convert outputs back to integers, truncating toward zero like the original
+  // floating-point to integer conversions
+  for (handshake::FPToSIOp fptosiOp : region.outputs) {
+    Value fixed = getFixed(fptosiOp.getIn(), format, rewriter);
+    rewriter.setInsertionPoint(fptosiOp);
+    auto fixedType = cast<handshake::ChannelType>(fixed.getType());
+    Value res = fixed;
+    if (format.fracBits != 0) {
+      // Shifting rounds toward negative infinity, so it is only equivalent to
+      // truncation for positive values
+      if (getInterval(fptosiOp.getIn()).lb >= 0) {
+        Value amount =
+            createConstant(fptosiOp, format.fracBits, format.width, rewriter);
+        res = createFrom<handshake::ShRSIOp>(fptosiOp, rewriter, fixedType,
+                                             fixed, amount);
+      } else {
+        Value scale = createConstant(fptosiOp, int64_t{1} << format.fracBits,
+                                     format.width, rewriter);
+        res = createFrom<handshake::DivSIOp>(fptosiOp, rewriter, fixedType,
+                                             fixed, scale);
+      }
+    }
+
+    auto outType = fptosiOp.getOut().getType();
+    unsigned outWidth = outType.getDataBitWidth();
+    if (format.width > outWidth)
+      res = createFrom<handshake::TruncIOp>(fptosiOp, rewriter, outType, res);
+    else if (format.width < outWidth)
+      res = createFrom<handshake::ExtSIOp>(fptosiOp, rewriter, outType, res);
+    rewriter.replaceOp(fptosiOp, res);
+  }
+
+  // Sinks simply consume the fixed-point values instead
+  for (Value val : region.values) {
+    for (OpOperand &use : llvm::make_early_inc_range(val.getUses())) {
+      if (isa<handshake::SinkOp>(use.getOwner()))
+        use.set(getFixed(val, format, rewriter));
+    }
+  }
+
+  // Loop-carried values finally take their fixed-point operands
+  for (Operation *newOp : newMergeOps) {
+    for (OpOperand &opr : newOp->getOpOperands()) {
+      if (isFloatChannel(opr.get()))
+        opr.set(getFixed(opr.get(), format, rewriter));
+    }
+  }
+
+  // Erase the now unused floating-point operations, which may form cycles
+  // through loop-carried values
+  SmallVector<Operation *> toErase(region.internal.begin(),
+                                   region.internal.end());
+  llvm::append_range(toErase, region.inputs);
+  for (Operation *op : toErase)
+    op->dropAllReferences();
+  for (Operation *op : toErase) {
+    assert(op->use_empty() && "region operations still have uses");
+    rewriter.eraseOp(op);
+  }
+}
+
+namespace {
+
+/// Driver for the floating-point to fixed-point conversion pass.
+struct HandshakeFloatToFixedPass
+    : public dynamatic::impl::HandshakeFloatToFixedBase<
+          HandshakeFloatToFixedPass> {
+
+  using HandshakeFloatToFixedBase::HandshakeFloatToFixedBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Tries to find a format for the region meeting the error bound.
+  std::optional<FixedFormat> findFormat(RegionConverter &converter,
+                                        FloatRegion &region);
+};
+} // namespace
+
+std::optional<FixedFormat>
+HandshakeFloatToFixedPass::findFormat(RegionConverter &converter,
+                                      FloatRegion &region) {
+  for (unsigned fracBits = 0; fracBits <= maxFracBits; ++fracBits) {
+    unsigned width = converter.getRequiredWidth(fracBits);
+    if (width > MAX_FIXED_WIDTH || !converter.canConvertInputs(fracBits))
+      return std::nullopt;
+
+    std::optional<double> maxError = 0.0;
+    for (handshake::FPToSIOp fptosiOp : region.outputs) {
+      std::optional<double> err =
+          converter.getError(fptosiOp.getIn(), fracBits);
+      if (!err) {
+        maxError = std::nullopt;
+        break;
+      }
+      maxError = std::max(*maxError, *err);
+    }
+    if (maxError && *maxError <= errorBound)
+      return FixedFormat{fracBits, width, *maxError};
+  }
+  return std::nullopt;
+}
+
+void HandshakeFloatToFixedPass::runDynamaticPass() {
+  IRRewriter rewriter(&getContext());
+  for (handshake::FuncOp funcOp : getOperation().getOps<handshake::FuncOp>()) {
+    ChannelRangeAnalysis intRanges(funcOp);
+
+    // Collect all convertible regions first, since conversion invalidates
+    // operations
+    DenseSet<Operation *> visited;
+    SmallVector<FloatRegion> regions;
+    for (Operation &op : funcOp.getOps()) {
+      if (!isa<handshake::AddFOp, handshake::SubFOp, handshake::MulFOp,
+               handshake::DivFOp>(op) ||
+          visited.contains(&op))
+        continue;
+      FailureOr<FloatRegion> region = collectRegion(&op);
+      if (failed(region)) {
+        visited.insert(&op);
+        continue;
+      }
+      visited.insert(region->internal.begin(), region->internal.end());
+      if (!region->outputs.empty())
+        regions.push_back(std::move(*region));
+    }
+
+    for (FloatRegion &region : regions) {
+      RegionConverter converter(region, intRanges, maxLoopIterations);
+      std::optional<FixedFormat> format = findFormat(converter, region);
+      Operation *reportOp = region.outputs.front();
+      if (!format) {
+        reportOp->emitRemark()
+            << "could not find a fixed-point format for the floating-point "
+               "region of "
+            << region.internal.size()
+            << " operation(s) meeting the error bound of " << errorBound;
+        continue;
+      }
+      reportOp->emitRemark()
+          << "converted floating-point region of " << region.internal.size()
+          << " operation(s) to fixed-point with " << format->fracBits
+          << " fractional bit(s) on " << format->width
+          << " bit(s); estimated maximum error is " << format->maxError;
+      converter.rewrite(*format, rewriter);
+    }
+  }
+}
@@ -7,20 +7,26 @@
 //===----------------------------------------------------------------------===//
 //
 // The basic block inference pass is implemented as a single operation
-// conversion pattern that iterates over all operations in a function repeatedly
-// until no more inferences can be performed, at which point it succeeds.
+// conversion pattern that propagates basic block information through each
+// function using a worklist, at which point it succeeds.
 //
 // A local inference heuristic is applied on each operation eligible for
-// inference. The locality of the heuristic may require the pass to run the
-// inference logic on eligible operations multiple times in order to let
-// inference results propagate incrementally to their immediate graph neighbors.
+// inference. The locality of the heuristic requires inference results to
+// propagate incrementally to their immediate graph neighbors. Instead of
+// sweeping over the entire function until a fixpoint is reached, only the
+// untagged neighbors of newly tagged operations are revisited, which keeps the
+// pass linear in the size of the circuit in practice.
 //
 //===----------------------------------------------------------------------===//
 
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/CFG.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include <functional>
+#include <queue>
 
 using namespace mlir;
 using namespace dynamatic;
@@ -92,8 +98,14 @@ static LogicalResult inferLogicBB(Operation *op, unsigned &logicBB) {
   return failure();
 }
 
-/// Iterates over all operations legal for inference that do not have a "bb"
-/// attribute and tries to infer it.
+/// Determines whether the operation is legal for inference and does not yet
+/// have a "bb" attribute.
+static bool needsInference(Operation *op) {
+  return isLegalForInference(op) && !getLogicBB(op).has_value();
+}
+
+/// Tries to infer the basic block of an operation legal for inference that
+/// does not have a "bb" attribute. Returns true when the attribute was set.
 static bool inferBasicBlocks(Operation *op, PatternRewriter &rewriter) {
   // Check whether we even need to run inference for the operation
   if (!isLegalForInference(op))
@@ -121,12 +133,49 @@ struct FuncOpInferBasicBlocks : public OpConversionPattern<handshake::FuncOp> {
   matchAndRewrite(handshake::FuncOp funcOp, OpAdaptor /*adaptor*/,
                   ConversionPatternRewriter &rewriter) const override {
     rewriter.updateRootInPlace(funcOp, [&] {
-      bool progress = false;
-      do {
-        progress = false;
-        for (Operation &op : funcOp.getOps())
-          progress |= inferBasicBlocks(&op, rewriter);
-      } while (progress);
+      // Inference results depend on the order in which operations are
+      // visited, so visits happen in the order of the program-order sweeps
+      // over the function that the worklist replaces. Each visit is keyed by
+      // the sweep it would happen in and the operation's index in the function
+      using Visit = std::pair<unsigned, unsigned>;
+      std::priority_queue<Visit, std::vector<Visit>, std::greater<Visit>>
+          worklist;
+      SmallVector<Operation *> ops;
+      DenseMap<Operation *, unsigned> opIndices;
+      DenseSet<Operation *> queued;
+      for (Operation &op : funcOp.getOps()) {
+        opIndices[&op] = ops.size();
+        if (needsInference(&op)) {
+          worklist.push({0, ops.size()});
+          queued.insert(&op);
+        }
+        ops.push_back(&op);
+      }
+
+      // An operation's inference result may only change when one of its
+      // immediate neighbors gets tagged, so only those need to be revisited.
+      // Neighbors that come after the tagged operation are revisited in the
+      // current sweep, the others in the next one
+      while (!worklist.empty()) {
+        auto [sweep, idx] = worklist.top();
+        worklist.pop();
+        Operation *op = ops[idx];
+        queued.erase(op);
+        if (!inferBasicBlocks(op, rewriter))
+          continue;
+
+        auto enqueue = [&](Operation *neighbor) {
+          if (!neighbor || neighbor->getParentOp() != funcOp ||
+              !needsInference(neighbor) || !queued.insert(neighbor).second)
+            return;
+          unsigned neighborIdx = opIndices[neighbor];
+          worklist.push({neighborIdx > idx ? sweep : sweep + 1, neighborIdx});
+        };
+        for (Operation *user : op->getUsers())
+          enqueue(user);
+        for (Value opr : op->getOperands())
+          enqueue(opr.getDefiningOp());
+      }
     });
     return success();
   }
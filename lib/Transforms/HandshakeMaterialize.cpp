@@ -16,6 +16,7 @@
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/MemoryInterfaces.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
@@ -98,7 +99,8 @@ static void materializeValue(Value val, OpBuilder &builder) {
     return;
   if (val.use_empty()) {
     builder.setInsertionPointAfterValue(val);
-    builder.create<handshake::SinkOp>(val.getLoc(), val);
+    auto sinkOp = builder.create<handshake::SinkOp>(val.getLoc(), val);
+    setClockDomain(sinkOp, getChannelClockDomain(val));
     return;
   }
   if (val.hasOneUse())
@@ -115,6 +117,7 @@ static void materializeValue(Value val, OpBuilder &builder) {
   auto forkOp = builder.create<handshake::ForkOp>(val.getLoc(), val, numUses);
   if (Operation *defOp = val.getDefiningOp())
     inheritBB(defOp, forkOp);
+  setClockDomain(forkOp, getChannelClockDomain(val));
 
   // Replace original uses of the value with the fork's results
   for (auto [user, forkRes] : llvm::zip_equal(valUsers, forkOp->getResults()))
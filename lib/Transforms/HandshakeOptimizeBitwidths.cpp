@@ -26,11 +26,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "dynamatic/Analysis/ChannelRangeAnalysis.h"
 #include "dynamatic/Analysis/NameAnalysis.h"
 #include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/Utils/Utils.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/PatternMatch.h"
@@ -276,7 +278,7 @@ static unsigned getUsefulResultWidth(ChannelVal val) {
 /// unknown, the value's signedness determines whether the extension should be
 /// logical or arithmetic.
 static ChannelVal modBitWidth(const MinimalValue &extVal, unsigned targetWidth,
-                              PatternRewriter &rewriter) {
+                              RewriterBase &rewriter) {
   // Return the original value when it already has the target width
   unsigned width = extVal.getDataBitWidth();
   if (width == targetWidth)
@@ -310,6 +312,52 @@ static ChannelVal modBitWidth(const MinimalValue &extVal, unsigned targetWidth,
   return cast<ChannelVal>(newOp->getResult(0));
 }
 
+/// Marks the truncation defining the value as narrowing the channel on the
+/// sole basis of inferred value ranges (see `NARROWING_ATTR_NAME`), assuming
+/// that extending the truncated value with the given extension type recovers
+/// the original one. Like `modBitWidth`, values of unknown extension type are
+/// assumed signed unless their type is unsigned. Does nothing if the value is
+/// not the result of a truncation.
+static void markNarrowing(Value truncVal, ExtType ext) {
+  auto truncOp = truncVal.getDefiningOp<handshake::TruncIOp>();
+  if (!truncOp)
+    return;
+  Type dataType = truncOp.getIn().getType().getDataType();
+  bool isSigned = ext == ExtType::SEXT ||
+                  (ext == ExtType::NONE && !dataType.isUnsignedInteger());
+  truncOp->setAttr(NARROWING_ATTR_NAME,
+                   StringAttr::get(truncOp.getContext(),
+                                   isSigned ? NARROWING_SEXT : NARROWING_ZEXT));
+}
+
+/// Returns the extension type under which the operation narrows its operand
+/// if it is a truncation marked as narrowing, and `ExtType::NONE` otherwise.
+static ExtType getNarrowingExt(Operation *op) {
+  auto truncOp = dyn_cast<handshake::TruncIOp>(op);
+  if (!truncOp)
+    return ExtType::NONE;
+  auto kindAttr = truncOp->getAttrOfType<StringAttr>(NARROWING_ATTR_NAME);
+  if (!kindAttr)
+    return ExtType::NONE;
+  return kindAttr.getValue() == NARROWING_SEXT ? ExtType::SEXT : ExtType::ZEXT;
+}
+
+/// Returns the extension type shared by all truncations marked as narrowing
+/// the value feeds, in which case every token it carries is assumed to fit in
+/// the width of these truncations under this extension type. Returns
+/// `ExtType::NONE` if the value feeds anything else or if the truncations
+/// assume different extension types.
+static ExtType getFedNarrowingExt(Value val) {
+  if (val.use_empty())
+    return ExtType::NONE;
+  ExtType ext = getNarrowingExt(*val.getUsers().begin());
+  for (Operation *user : val.getUsers()) {
+    if (getNarrowingExt(user) != ext)
+      return ExtType::NONE;
+  }
+  return ext;
+}
+
 /// Recursive version of isOperandInCycle which includes an additional
 /// parameter to keep track of which operations were already visited during
 /// backtracking to avoid looping forever. See overload's documentation for more
@@ -874,6 +922,23 @@ struct HandshakeOptData : public OpRewritePattern<Op> {
     Type newChannelType = channelVal.getType().withDataType(newDataType);
     cfg.getNewOperands(resultWidth.bitWidth, minDataOperands, rewriter,
                        newOperands);
+
+    // Data flows unchanged through the operation, so new truncations of its
+    // data operands (always the last new operands) rely on the same range
+    // assumptions as the truncations of its data results
+    ExtType narrowingExt = getFedNarrowingExt(dataResults.front());
+    if (!forward && narrowingExt != ExtType::NONE &&
+        llvm::all_of(dataResults, [&](Value res) {
+          return getFedNarrowingExt(res) == narrowingExt;
+        })) {
+      ArrayRef<Value> newDataOperands =
+          ArrayRef<Value>(newOperands).take_back(minDataOperands.size());
+      for (auto [minVal, newOprd] :
+           llvm::zip_equal(minDataOperands, newDataOperands)) {
+        if (minVal.getDataBitWidth() > resultWidth.bitWidth)
+          markNarrowing(newOprd, narrowingExt);
+      }
+    }
     cfg.getResultTypes(newChannelType, newResTypes);
     rewriter.setInsertionPoint(op);
     Op newOp = cfg.createOp(newResTypes, newOperands, rewriter);
@@ -1766,6 +1831,8 @@ struct ArithExtToTruncOpt : public OpRewritePattern<handshake::TruncIOp> {
     // Bypass all extensions and truncation operation and replace it with a
     // single bitwidth modification operation
     auto newExtRes = modBitWidth(minVal, finalWidth, rewriter);
+    if (ExtType ext = getNarrowingExt(truncOp); ext != ExtType::NONE)
+      markNarrowing(newExtRes, ext);
     namer.replaceOp(truncOp, newExtRes.getDefiningOp());
     rewriter.replaceOp(truncOp, {newExtRes});
     ++bitwidthReduced;
@@ -2054,6 +2121,7 @@ bool ArithBoundOpt::optBranchIfPossible(ChannelVal optBranch, unsigned optWidth,
   // to optimize and its users, to let the rest of the rewrite patterns know
   // that some bits of the value can be safely discarded
   ChannelVal truncVal = modBitWidth({optBranch, ext}, optWidth, rewriter);
+  markNarrowing(truncVal, ext);
   ChannelVal extVal = modBitWidth({truncVal, ext}, dataWidth, rewriter);
   rewriter.replaceAllUsesExcept(optBranch, extVal, truncVal.getDefiningOp());
   return true;
@@ -2098,6 +2166,11 @@ struct HandshakeOptimizeBitwidthsPass
       return signalPassFailure();
 
     for (auto funcOp : modOp.getOps<handshake::FuncOp>()) {
+      // Narrow values to their proven ranges first, letting the iterative
+      // process below propagate the gains through the rest of the circuit
+      if (rangeAnalysis)
+        narrowToProvenRanges(funcOp);
+
       bool fwChanged, bwChanged;
       SmallVector<Operation *> ops;
 
@@ -2126,6 +2199,13 @@ struct HandshakeOptimizeBitwidthsPass
   }
 
 private:
+  /// Runs a value range analysis on the function and, for every integer
+  /// channel whose proven range fits on fewer bits than its users consume,
+  /// inserts a truncation followed by an extension between the channel and its
+  /// users. This lets the rewrite patterns know that the discarded bits carry
+  /// no information.
+  void narrowToProvenRanges(handshake::FuncOp funcOp);
+
   template <typename Op>
   using HandshakeOptDataNoCfg = HandshakeOptData<Op, OptDataConfig<Op>>;
 
@@ -2144,6 +2224,38 @@ private:
   void addBackwardPatterns(RewritePatternSet &bwPatterns);
 };
 
+void HandshakeOptimizeBitwidthsPass::narrowToProvenRanges(
+    handshake::FuncOp funcOp) {
+  ChannelRangeAnalysis ranges(funcOp);
+  IRRewriter rewriter(&getContext());
+
+  SmallVector<ChannelVal> candidates;
+  for (Operation &op : funcOp.getOps()) {
+    // Constants and bitwidth modifiers are already handled by the patterns
+    if (isa<handshake::ConstantOp, handshake::ExtSIOp, handshake::ExtUIOp,
+            handshake::TruncIOp>(op))
+      continue;
+    for (OpResult res : op.getResults()) {
+      if (ChannelVal channelVal = asTypedIfLegal(res))
+        candidates.push_back(channelVal);
+    }
+  }
+
+  for (ChannelVal val : candidates) {
+    unsigned dataWidth = getUsefulResultWidth(val);
+    auto [optWidth, isSigned] = ranges.getRequiredWidth(val);
+    if (optWidth >= dataWidth)
+      continue;
+
+    ExtType ext = isSigned ? ExtType::SEXT : ExtType::ZEXT;
+    ChannelVal truncVal = modBitWidth({val, ext}, optWidth, rewriter);
+    markNarrowing(truncVal, ext);
+    ChannelVal extVal = modBitWidth({truncVal, ext}, dataWidth, rewriter);
+    rewriter.replaceAllUsesExcept(val, extVal, truncVal.getDefiningOp());
+    ++bitwidthReduced;
+  }
+}
+
 void HandshakeOptimizeBitwidthsPass::addArithPatterns(
     RewritePatternSet &patterns, bool forward) {
   MLIRContext *ctx = patterns.getContext();
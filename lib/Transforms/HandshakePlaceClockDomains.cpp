@@ -0,0 +1,134 @@
+//===- HandshakePlaceClockDomains.cpp - Slow clock domains ------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --handshake-place-clock-domains pass, which moves slow
+// operations to a slower clock domain and inserts clock domain crossings on
+// all channels between domains.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
+#include "mlir/IR/Builders.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/MathExtras.h"
+
+// [START Boilerplate code for the MLIR pass]
+#include "dynamatic/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+#define GEN_PASS_DEF_HANDSHAKEPLACECLOCKDOMAINS
+#include "dynamatic/Transforms/Passes.h.inc"
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+using namespace mlir;
+using namespace dynamatic;
+
+namespace {
+
+struct HandshakePlaceClockDomainsPass
+    : public dynamatic::impl::HandshakePlaceClockDomainsBase<
+          HandshakePlaceClockDomainsPass> {
+
+  using HandshakePlaceClockDomainsBase::HandshakePlaceClockDomainsBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Moves all operations of the listed kinds inside the function to a new
+  /// clock domain, then makes all channels between domains go through a clock
+  /// domain crossing.
+  LogicalResult placeClockDomains(handshake::FuncOp funcOp,
+                                  const llvm::StringSet<> &names);
+};
+
+} // namespace
+
+/// Returns the clock domain of the value's producer (the main clock domain for
+/// function arguments).
+static unsigned getProducerDomain(Value val) {
+  if (Operation *defOp = val.getDefiningOp())
+    return getClockDomain(defOp);
+  return 0;
+}
+
+LogicalResult HandshakePlaceClockDomainsPass::placeClockDomains(
+    handshake::FuncOp funcOp, const llvm::StringSet<> &names) {
+  SmallVector<Operation *> slowOps;
+  for (Operation &op : funcOp.getOps()) {
+    if (!names.contains(op.getName().getStringRef()))
+      continue;
+    if (isa<handshake::MemPortOpInterface, handshake::MemoryOpInterface>(op)) {
+      return op.emitError()
+             << "memory operations cannot be moved to another clock domain";
+    }
+    slowOps.push_back(&op);
+  }
+  if (slowOps.empty())
+    return success();
+
+  unsigned domain = addClockDomain(funcOp, periodRatio);
+  for (Operation *op : slowOps)
+    setClockDomain(op, domain);
+
+  // Collect all channels between domains before modifying the IR
+  SmallVector<OpOperand *> crossings;
+  for (Operation &op : funcOp.getOps()) {
+    for (OpOperand &oprd : op.getOpOperands()) {
+      if (getProducerDomain(oprd.get()) != getClockDomain(&op))
+        crossings.push_back(&oprd);
+    }
+  }
+
+  OpBuilder builder(&getContext());
+  for (OpOperand *oprd : crossings) {
+    Value channel = oprd->get();
+    Operation *consumer = oprd->getOwner();
+    if (cast<handshake::ExtraSignalsTypeInterface>(channel.getType())
+            .getNumExtraSignals() != 0) {
+      return consumer->emitError()
+             << "channel carrying extra signals cannot cross clock domains";
+    }
+    builder.setInsertionPoint(consumer);
+    auto crossingOp = builder.create<handshake::ClockCrossingOp>(
+        consumer->getLoc(), channel, getProducerDomain(channel),
+        getClockDomain(consumer), numSlots);
+    inheritBB(consumer, crossingOp);
+    oprd->set(crossingOp.getResult());
+  }
+  return success();
+}
+
+void HandshakePlaceClockDomainsPass::runDynamaticPass() {
+  if (opNames.empty())
+    return;
+  if (periodRatio < 1.0) {
+    llvm::errs() << "Clock period ratio of the slow clock domain must be at "
+                    "least 1, but got "
+                 << periodRatio << "\n";
+    return signalPassFailure();
+  }
+  if (numSlots < 2 || !llvm::isPowerOf2_32(numSlots)) {
+    llvm::errs() << "Number of slots of clock domain crossings must be a "
+                    "power of two greater than one, but got "
+                 << numSlots << "\n";
+    return signalPassFailure();
+  }
+
+  llvm::StringSet<> names;
+  for (const std::string &name : opNames)
+    names.insert(name);
+
+  for (handshake::FuncOp funcOp :
+       getOperation().getOps<handshake::FuncOp>()) {
+    if (failed(placeClockDomains(funcOp, names)))
+      return signalPassFailure();
+  }
+}
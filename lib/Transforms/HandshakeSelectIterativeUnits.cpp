@@ -0,0 +1,190 @@
+//===- HandshakeSelectIterativeUnits.cpp - Iterative dividers ---*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the --handshake-select-iterative-units pass, which replaces
+// pipelined dividers with iterative implementations whose initiation interval
+// still sustains the throughput achieved by buffer placement.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Dialect/Handshake/HandshakeAttributes.h"
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/Attribute.h"
+#include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
+#include "dynamatic/Support/CostModel.h"
+#include "llvm/ADT/DenseMap.h"
+#include <cmath>
+#include <limits>
+
+// [START Boilerplate code for the MLIR pass]
+#include "dynamatic/Transforms/Passes.h" // IWYU pragma: keep
+namespace dynamatic {
+#define GEN_PASS_DEF_HANDSHAKESELECTITERATIVEUNITS
+#include "dynamatic/Transforms/Passes.h.inc"
+} // namespace dynamatic
+// [END Boilerplate code for the MLIR pass]
+
+using namespace mlir;
+using namespace dynamatic;
+
+namespace {
+
+/// An implementation of a unit, as described by its timing model.
+struct UnitImpl {
+  int64_t latency;
+  int64_t ii;
+};
+
+struct HandshakeSelectIterativeUnitsPass
+    : public dynamatic::impl::HandshakeSelectIterativeUnitsBase<
+          HandshakeSelectIterativeUnitsPass> {
+
+  using HandshakeSelectIterativeUnitsBase::HandshakeSelectIterativeUnitsBase;
+
+  void runDynamaticPass() override;
+
+private:
+  /// Selects an iterative implementation for all dividers inside the function
+  /// whose throughput allows it. Fails if the function's CFDFC attributes are
+  /// malformed.
+  LogicalResult selectIterativeUnits(handshake::FuncOp funcOp,
+                                     const TimingDatabase &timingDB);
+};
+
+} // namespace
+
+/// Maps each basic block of the function to the largest throughput among the
+/// CFDFCs it belongs to, as recorded by buffer placement. Fails if the
+/// attributes are malformed.
+static LogicalResult
+getThroughputByBB(handshake::FuncOp funcOp,
+                  handshake::CFDFCToBBListAttr cfdfcAttr,
+                  handshake::CFDFCThroughputAttr throughputAttr,
+                  llvm::DenseMap<unsigned, double> &throughputByBB) {
+  DictionaryAttr throughputDict = throughputAttr.getThroughputMap();
+  for (const NamedAttribute &attr : cfdfcAttr.getCfdfcMap()) {
+    auto throughput = dyn_cast_if_present<FloatAttr>(
+        throughputDict.get(attr.getName().getValue()));
+    auto bbList = dyn_cast<ArrayAttr>(attr.getValue());
+    if (!throughput || !bbList) {
+      return funcOp.emitError()
+             << "no throughput for CFDFC " << attr.getName().getValue();
+    }
+    for (Attribute bb : bbList) {
+      double &bbThroughput =
+          throughputByBB[cast<IntegerAttr>(bb).getValue().getZExtValue()];
+      bbThroughput = std::max(bbThroughput, throughput.getValueAsDouble());
+    }
+  }
+  return success();
+}
+
+/// Returns the iterative implementation of the operation with the largest
+/// initiation interval that meets the clock period, has at most the given
+/// latency, and has at most the given initiation interval, if any.
+static std::optional<UnitImpl>
+findIterativeImpl(Operation *op, const TimingDatabase &timingDB,
+                  double clockPeriod, int64_t maxLatency, int64_t maxII) {
+  std::string key =
+      (op->getName().getStringRef() + "." + ITERATIVE_IMPL).str();
+  const TimingModel *model = timingDB.getModel(key);
+  if (!model)
+    return std::nullopt;
+
+  // Latencies and initiation intervals share the same path -> bitwidth ->
+  // clock-period nesting
+  auto latByBitwidth = model->latAndMaxFreqByPath.select(0);
+  auto iiByBitwidth = model->iiByPath.select(0);
+  if (failed(latByBitwidth) || failed(iiByBitwidth))
+    return std::nullopt;
+  auto latByDelay = latByBitwidth->get().select(op);
+  auto iiByDelay = iiByBitwidth->get().select(op);
+  if (failed(latByDelay) || failed(iiByDelay))
+    return std::nullopt;
+
+  std::optional<UnitImpl> best;
+  for (const auto &[delay, iiValue] : iiByDelay->get().data) {
+    auto latIt = latByDelay->get().data.find(delay);
+    if (delay > clockPeriod || latIt == latByDelay->get().data.end())
+      continue;
+    UnitImpl impl{static_cast<int64_t>(latIt->second),
+                  static_cast<int64_t>(iiValue)};
+    if (impl.ii <= 1 || impl.ii > maxII || impl.latency > maxLatency)
+      continue;
+    if (!best || impl.ii > best->ii ||
+        (impl.ii == best->ii && impl.latency < best->latency))
+      best = impl;
+  }
+  return best;
+}
+
+LogicalResult HandshakeSelectIterativeUnitsPass::selectIterativeUnits(
+    handshake::FuncOp funcOp, const TimingDatabase &timingDB) {
+  auto cfdfcAttr = getDialectAttr<handshake::CFDFCToBBListAttr>(funcOp);
+  auto throughputAttr = getDialectAttr<handshake::CFDFCThroughputAttr>(funcOp);
+  if (!cfdfcAttr || !throughputAttr)
+    return success();
+
+  llvm::DenseMap<unsigned, double> throughputByBB;
+  if (failed(getThroughputByBB(funcOp, cfdfcAttr, throughputAttr,
+                               throughputByBB)))
+    return failure();
+
+  for (Operation &op : funcOp.getOps()) {
+    if (!isa<handshake::DivSIOp, handshake::DivUIOp>(op))
+      continue;
+    auto latencyOp = cast<handshake::LatencyInterface>(op);
+    FailureOr<int64_t> latency = latencyOp.getLatency();
+    if (failed(latency) || latencyOp.getInitiationInterval() > 1)
+      continue;
+
+    // A shared unit serves multiple operations, so its throughput is not the
+    // one of its own CFDFCs
+    if (llvm::any_of(op.getUsers(), [](Operation *user) {
+          return isa<handshake::SharingWrapperOp>(user);
+        }))
+      continue;
+
+    // Both the clock period and the throughput are expressed with respect to
+    // the unit's own clock domain. Operations outside of any CFDFC are not on
+    // the critical path of any loop and do not constrain their II.
+    double ratio = getClockPeriodRatio(&op);
+    int64_t maxII = std::numeric_limits<int64_t>::max();
+    if (std::optional<unsigned> bb = getLogicBB(&op)) {
+      double throughput = throughputByBB.lookup(*bb) * ratio;
+      if (throughput > 0.0)
+        maxII = static_cast<int64_t>(std::floor(1.0 / throughput + 1e-6));
+    }
+    if (maxII <= 1)
+      continue;
+
+    std::optional<UnitImpl> impl =
+        findIterativeImpl(&op, timingDB, targetCP * ratio, *latency, maxII);
+    if (!impl)
+      continue;
+    latencyOp.setLatency(impl->latency);
+    latencyOp.setInitiationInterval(impl->ii);
+    ++numIterativeUnits;
+  }
+  return success();
+}
+
+void HandshakeSelectIterativeUnitsPass::runDynamaticPass() {
+  FailureOr<const TimingDatabase *> timingDB =
+      CostModel::getTimingDatabase(timingModels);
+  if (failed(timingDB))
+    return signalPassFailure();
+
+  for (handshake::FuncOp funcOp :
+       getOperation().getOps<handshake::FuncOp>()) {
+    if (failed(selectIterativeUnits(funcOp, **timingDB)))
+      return signalPassFailure();
+  }
+}
@@ -6,6 +6,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "dynamatic/Support/ClockDomains.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Support/TimingModels.h"
 
 // [START Boilerplate code for the MLIR pass]
@@ -43,9 +45,13 @@ struct HandshakeSetUnitImplAttributesPass
 
   void runOnOperation() override {
 
-    TimingDatabase timingDB;
-    if (failed(TimingDatabase::readFromJSON(timingModels, timingDB)))
+    FailureOr<const TimingDatabase *> timingDBOrFail =
+        CostModel::getTimingDatabase(timingModels);
+    if (failed(timingDBOrFail)) {
       llvm::errs() << "=== TimindDB read failed ===\n";
+      return signalPassFailure();
+    }
+    const TimingDatabase &timingDB = **timingDBOrFail;
 
     auto implOpt = symbolizeFPUImplOrEmitError(this->impl);
     if (!implOpt.has_value()) {
@@ -62,10 +68,13 @@ struct HandshakeSetUnitImplAttributesPass
       // mark the FPU vendor
       fpuImplInterfaceOp.setFPUImpl(impl);
 
+      // Units in a slower clock domain are implemented for that domain's period
+      double unitCP = targetCP * getClockPeriodRatio(fpuImplInterfaceOp);
+
       double delay;
       // [START mark the internal delay of the FPU units]
       if (succeeded(timingDB.getInternalCombinationalDelay(
-              fpuImplInterfaceOp, SignalType::DATA, delay, targetCP))) {
+              fpuImplInterfaceOp, SignalType::DATA, delay, unitCP))) {
         std::string delayStr = std::to_string(delay);
         std::replace(delayStr.begin(), delayStr.end(), '.', '_');
         fpuImplInterfaceOp.setInternalDelay(delayStr);
@@ -79,8 +88,9 @@ struct HandshakeSetUnitImplAttributesPass
 
     getOperation().walk([&](LatencyInterface latencyInterfaceOp) {
       // [START mark the latency]
+      double unitCP = targetCP * getClockPeriodRatio(latencyInterfaceOp);
       auto latencyOrFail =
-          timingDB.getLatency(latencyInterfaceOp, SignalType::DATA, targetCP);
+          timingDB.getLatency(latencyInterfaceOp, SignalType::DATA, unitCP);
       if (succeeded(latencyOrFail)) {
         int64_t latencyInt = static_cast<int64_t>(*latencyOrFail);
         latencyInterfaceOp.setLatency(latencyInt);
@@ -22,6 +22,8 @@
 #include "dynamatic/Analysis/NameAnalysis.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Support/CFG.h"
+#include "dynamatic/Support/ClockDomains.h"
+#include "dynamatic/Support/CostModel.h"
 #include "dynamatic/Support/LLVM.h"
 #include "dynamatic/Support/TimingModels.h"
 #include "dynamatic/Transforms/BufferPlacement/Utils/BufferingSupport.h"
@@ -145,7 +147,7 @@ void loadFuncPerfInfoFromAnalysis(handshake::FuncOp funcOp,
 // For two sharing groups, check if the following criteria hold (see
 // descriptions below).
 bool checkGroupMergable(const Group &g1, const Group &g2,
-                        FuncPerfInfo funcPerfInfo) {
+                        FuncPerfInfo funcPerfInfo, CostModel &costModel) {
   if (g1.empty() || g2.empty())
     return false;
 
@@ -162,19 +164,35 @@ bool checkGroupMergable(const Group &g1, const Group &g2,
   Type groupType = (*(gMerged.begin()))->getResultTypes().front();
 
   // 1. The merged group must have operations of the same type (both op type and
-  // data type).
+  // data type), clocked by the same clock.
+  unsigned groupDomain = getClockDomain(*gMerged.begin());
   for (Operation *op : gMerged) {
     if (op->getName() != opName)
       return false;
     if (op->getResultTypes().front() != groupType)
       return false;
+    if (getClockDomain(op) != groupDomain)
+      return false;
   }
 
-  // 2. For each CFC, the sum of occupancy must be smaller than the capacity
-  // (i.e., units in CFC must no greater than the II).
-  // This is equivalent to checking that throughput * n_ops <= 1;
+  // 2. The shared unit must be larger than the multiplexers the sharing
+  // wrapper adds in front of its operands, which take roughly one LUT per
+  // operand bit for each additional operation. Units whose area is not
+  // characterized are assumed to be worth sharing.
+  Operation *groupOp = *gMerged.begin();
+  UnitCost cost = costModel.getUnitCost(groupOp);
+  if (cost.area &&
+      *cost.area <= groupOp->getNumOperands() * getOpDatawidth(groupOp))
+    return false;
+
+  // 3. For each CFC, the sum of occupancy must be smaller than the capacity
+  // (i.e., units in CFC must no greater than the II). Each operation
+  // occupies the shared unit for one initiation interval of the unit (in main
+  // clock cycles) per token. This is equivalent to checking that throughput *
+  // n_ops * II <= 1;
+  double mainClockII = cost.ii * getClockPeriodRatio(groupOp);
 
-  // 3. For each CFC, there must be no two operations have the same SCC ID (this
+  // 4. For each CFC, there must be no two operations have the same SCC ID (this
   // is simplified). TODO: we could try to check that if two operations in the
   // same SCC never start at the same time, then we can put them into the same
   // group without hurting the performance.
@@ -200,9 +218,9 @@ bool checkGroupMergable(const Group &g1, const Group &g2,
     }
     // Check if there are any duplicates:
     std::set<size_t> setOfSccIds(listOfSccIds.begin(), listOfSccIds.end());
-    // Check if numOps * cfcThroughput <= 1 and no duplicate SCC
+    // Check if numOps * cfcThroughput * II <= 1 and no duplicate SCC
     // IDs.
-    if (numOps * (funcPerfInfo.cfThroughput)[cf] > 1)
+    if (numOps * (funcPerfInfo.cfThroughput)[cf] * mainClockII > 1)
       return false;
     if ((listOfSccIds.size() != setOfSccIds.size()))
       return false;
@@ -215,11 +233,12 @@ bool checkGroupMergable(const Group &g1, const Group &g2,
 // A greedy algorithm that test checkGroupMergable on combination of
 // 2 groups, if success then the 2 given groups are merged, and immediately
 // returns true if successfully merged groups, otherwise it returns false.
-bool tryMergeGroups(SharingGroups &sharingGroups, const FuncPerfInfo &info) {
+bool tryMergeGroups(SharingGroups &sharingGroups, const FuncPerfInfo &info,
+                    CostModel &costModel) {
   for (auto g1 = sharingGroups.begin(); g1 != sharingGroups.end(); g1++)
     for (auto g2 = std::next(g1); g2 != sharingGroups.end(); g2++)
-      if (checkGroupMergable(*g1, *g2, info)) {
-        // If all three criteria met, then merge the second group into the
+      if (checkGroupMergable(*g1, *g2, info, costModel)) {
+        // If all four criteria met, then merge the second group into the
         // first group.
         Group unionGroup = *g1;
         unionGroup.insert(unionGroup.end(), g2->begin(), g2->end());
@@ -261,8 +280,7 @@ void sortGroups(SharingGroups &sharingGroups, FuncPerfInfo &info) {
 // of all performance critical CFCs.
 void getOpOccupancy(const SmallVector<Operation *> &sharingTargets,
                     llvm::MapVector<Operation *, double> &opOccupancy,
-                    TimingDatabase &timingDB, FuncPerfInfo &funcPerfInfo,
-                    double targetCP) {
+                    CostModel &costModel, FuncPerfInfo &funcPerfInfo) {
 
   for (Operation *target : sharingTargets) {
     // By default, the op is assigned with no occupancy. If a performance
@@ -272,11 +290,8 @@ void getOpOccupancy(const SmallVector<Operation *> &sharingTargets,
     for (auto cf : funcPerfInfo.critCfcs) {
       if (funcPerfInfo.cfUnits[cf].find(target) !=
           funcPerfInfo.cfUnits[cf].end()) {
-        double latency = 0.0;
-        auto latencyOrFail =
-            timingDB.getLatency(target, SignalType::DATA, targetCP);
-        if (succeeded(latencyOrFail))
-          latency = *latencyOrFail;
+        // The latency is expressed in main clock cycles, like the throughput
+        double latency = costModel.getUnitCost(target).latency;
         // Formula for operation occupancy:
         // Occupancy = Latency / II = Latency * Throughput.
         opOccupancy[target] = latency * funcPerfInfo.cfThroughput[cf];
@@ -307,11 +322,13 @@ struct CreditBasedSharingPass
 
   LogicalResult sharingInFuncOp(handshake::FuncOp funcOp,
                                 FuncPerfInfo &funcPerfInfo, NameAnalysis &namer,
-                                TimingDatabase &timingDB, double targetCP);
+                                CostModel &costModel);
 
-  LogicalResult sharingWrapperInsertion(
-      handshake::FuncOp &funcOp, SharingGroups &sharingGroups,
-      MapVector<Operation *, double> &opOccupancy, TimingDatabase &timingDB);
+  LogicalResult
+  sharingWrapperInsertion(handshake::FuncOp &funcOp,
+                          SharingGroups &sharingGroups,
+                          MapVector<Operation *, double> &opOccupancy,
+                          CostModel &costModel);
 
   // This class method finds all sharing targets for a given handshake function
   SmallVector<mlir::Operation *> getSharingTargets(handshake::FuncOp funcOp) {
@@ -347,7 +364,7 @@ struct CreditBasedSharingPass
 //    operations and dispatches the result to the correct outputs.
 LogicalResult CreditBasedSharingPass::sharingWrapperInsertion(
     handshake::FuncOp &funcOp, SharingGroups &sharingGroups,
-    MapVector<Operation *, double> &opOccupancy, TimingDatabase &timingDB) {
+    MapVector<Operation *, double> &opOccupancy, CostModel &costModel) {
   MLIRContext *ctx = &getContext();
   OpBuilder builder(ctx);
   for (Group group : sharingGroups) {
@@ -360,11 +377,9 @@ LogicalResult CreditBasedSharingPass::sharingWrapperInsertion(
     // Elect one operation as the shared operation.
     Operation *sharedOp = *group.begin();
 
-    double latency = 0.0;
-    auto latencyOrFail =
-        timingDB.getLatency(sharedOp, SignalType::DATA, targetCP);
-    if (succeeded(latencyOrFail))
-      latency = *latencyOrFail;
+    // The wrapper counts the latency in cycles of its own clock domain
+    double latency = costModel.getUnitCost(sharedOp).latency /
+                     getClockPeriodRatio(sharedOp);
 
     // Maps each original successor and the input operand (Value)
     std::vector<std::tuple<Operation *, Value>> succValueMap;
@@ -421,6 +436,8 @@ LogicalResult CreditBasedSharingPass::sharingWrapperInsertion(
             sharedOp->getResult(0), llvm::ArrayRef<int64_t>(credits),
             credits.size(), sharedOp->getNumOperands(),
             (unsigned)round(latency));
+    // The wrapper is clocked like the operations it shares
+    setClockDomain(wrapperOp, getClockDomain(sharedOp));
 
     // Replace original connection from op->successor to
     // sharingWrapper->successor
@@ -461,7 +478,7 @@ LogicalResult CreditBasedSharingPass::sharingWrapperInsertion(
 
 LogicalResult CreditBasedSharingPass::sharingInFuncOp(
     handshake::FuncOp funcOp, FuncPerfInfo &funcPerfInfo, NameAnalysis &namer,
-    TimingDatabase &timingDB, double targetCP) {
+    CostModel &costModel) {
 
   // Get all the sharing targets within the funcOp
   SmallVector<Operation *> sharingTargets = getSharingTargets(funcOp);
@@ -469,7 +486,7 @@ LogicalResult CreditBasedSharingPass::sharingInFuncOp(
   // opOccupancy: maps each operation to the maximum occupancy it has to
   // achieve.
   llvm::MapVector<Operation *, double> opOccupancy;
-  getOpOccupancy(sharingTargets, opOccupancy, timingDB, funcPerfInfo, targetCP);
+  getOpOccupancy(sharingTargets, opOccupancy, costModel, funcPerfInfo);
 
   // Initialize the sharing groups:
   SharingGroups sharingGroups;
@@ -485,22 +502,25 @@ LogicalResult CreditBasedSharingPass::sharingInFuncOp(
 
   // Merge groups
   for (bool continueMerging = true; continueMerging;)
-    continueMerging = tryMergeGroups(sharingGroups, funcPerfInfo);
+    continueMerging = tryMergeGroups(sharingGroups, funcPerfInfo, costModel);
 
   // Sort each sharing group according to their SCC ID.
   sortGroups(sharingGroups, funcPerfInfo);
 
   // For each sharing group, unite them with a sharing wrapper and shared
   // operation.
-  return sharingWrapperInsertion(funcOp, sharingGroups, opOccupancy, timingDB);
+  return sharingWrapperInsertion(funcOp, sharingGroups, opOccupancy,
+                                 costModel);
 }
 
 void CreditBasedSharingPass::runOnOperation() {
   NameAnalysis &namer = getAnalysis<NameAnalysis>();
 
-  TimingDatabase timingDB;
-  if (failed(TimingDatabase::readFromJSON(timingModels, timingDB)))
-    signalPassFailure();
+  FailureOr<CostModel *> costModelOrFail =
+      CostModel::get(timingModels, targetCP);
+  if (failed(costModelOrFail))
+    return signalPassFailure();
+  CostModel &costModel = **costModelOrFail;
 
   // Buffer placement requires that all values are used exactly once
   auto modOp = dyn_cast<ModuleOp>(getOperation());
@@ -533,8 +553,7 @@ void CreditBasedSharingPass::runOnOperation() {
 
   // Apply resource sharing for each function in the module op.
   for (auto &[funcOp, funcPerfInfo] : sharingInfo) {
-    if (failed(
-            sharingInFuncOp(funcOp, funcPerfInfo, namer, timingDB, targetCP))) {
+    if (failed(sharingInFuncOp(funcOp, funcPerfInfo, namer, costModel))) {
       signalPassFailure();
     }
   }
@@ -0,0 +1,21 @@
+// RUN: dynamatic-opt --lower-handshake-to-hw %s | FileCheck %s
+
+// Units of the slow clock domain, including buffers placed on its channels,
+// are clocked by the domain's clock port. Clock domain crossings are clocked
+// by both domains.
+
+// CHECK-LABEL:   hw.module @twoDomains(
+// CHECK-SAME:      in %[[CLK1:clk_1]] : i1, in %[[CLK:clk]] : i1, in %[[RST:rst]] : i1
+// CHECK:           hw.instance "{{.*}}" @handshake_clock_crossing_{{[0-9]+}}(ins: %a: !handshake.channel<f32>, ins_clk: %[[CLK]]: i1, outs_clk: %[[CLK1]]: i1, rst: %[[RST]]: i1)
+// CHECK:           hw.instance "{{.*}}" @handshake_clock_crossing_{{[0-9]+}}(ins: %b: !handshake.channel<f32>, ins_clk: %[[CLK]]: i1, outs_clk: %[[CLK1]]: i1, rst: %[[RST]]: i1)
+// CHECK:           hw.instance "{{.*}}" @handshake_buffer_{{[0-9]+}}(ins: %{{.*}}: !handshake.channel<f32>, clk: %[[CLK1]]: i1, rst: %[[RST]]: i1)
+// CHECK:           hw.instance "{{.*}}" @handshake_divf_{{[0-9]+}}(lhs: %{{.*}}: !handshake.channel<f32>, rhs: %{{.*}}: !handshake.channel<f32>, clk: %[[CLK1]]: i1, rst: %[[RST]]: i1)
+// CHECK:           hw.instance "{{.*}}" @handshake_clock_crossing_{{[0-9]+}}(ins: %{{.*}}: !handshake.channel<f32>, ins_clk: %[[CLK1]]: i1, outs_clk: %[[CLK]]: i1, rst: %[[RST]]: i1)
+handshake.func @twoDomains(%a: !handshake.channel<f32>, %b: !handshake.channel<f32>, %start: !handshake.control<>) -> (!handshake.channel<f32>, !handshake.control<>) attributes {argNames = ["a", "b", "start"], resNames = ["out0", "end"], handshake.clock_ratios = [2.000000e+00]} {
+  %slowA = clock_crossing %a {srcDomain = 0 : ui32, dstDomain = 1 : ui32, numSlots = 4 : ui32} : <f32>
+  %slowB = clock_crossing %b {srcDomain = 0 : ui32, dstDomain = 1 : ui32, numSlots = 4 : ui32} : <f32>
+  %buf = buffer %slowA, bufferType = ONE_SLOT_BREAK_DV, numSlots = 1, dvLatency = 1 {handshake.clock_domain = 1 : ui32} : <f32>
+  %quot = divf %buf, %slowB {handshake.clock_domain = 1 : ui32, latency = 29} : <f32>
+  %res = clock_crossing %quot {srcDomain = 1 : ui32, dstDomain = 0 : ui32, numSlots = 4 : ui32} : <f32>
+  end %res, %start : !handshake.channel<f32>, !handshake.control<>
+}
@@ -228,3 +228,35 @@ handshake.func @invalidSpecCommitWithInvalidDataTypes(
   %dataOut = spec_commit[%ctrl] %dataIn : !handshake.channel<i32, [spec: i1]>, !handshake.control<>, <i1>
   end
 }
+
+// -----
+
+handshake.func @invalidTaggerNumTags(%a : !handshake.channel<i32>, %credit : !handshake.control<>) {
+  // expected-error @below {{'handshake.tagger' op number of tags must be a power of two greater than one, but got 3}}
+  %tagged = tagger [%credit] %a {numTags = 3 : ui32} : <i32> -> <i32, [tag: i2]>
+  end
+}
+
+// -----
+
+handshake.func @invalidUntaggerType(%a : !handshake.channel<i32, [tag: i1]>) {
+  // expected-error @below {{'handshake.untagger' op tagged channel 0's type must be '!handshake.channel<i32, [tag: i2]>', but got '!handshake.channel<i32, [tag: i1]>'}}
+  %untagged, %credit = untagger %a {numTags = 4 : ui32} : <i32, [tag: i1]> -> <i32>
+  end
+}
+
+// -----
+
+handshake.func @invalidClockCrossingNumSlots(%a : !handshake.channel<i32>) {
+  // expected-error @below {{'handshake.clock_crossing' op number of slots must be a power of two greater than one, but got 3}}
+  %b = clock_crossing %a {srcDomain = 0 : ui32, dstDomain = 1 : ui32, numSlots = 3 : ui32} : <i32>
+  end
+}
+
+// -----
+
+handshake.func @invalidClockCrossingDomains(%a : !handshake.channel<i32>) {
+  // expected-error @below {{'handshake.clock_crossing' op source and destination clock domains must differ, but both are 1}}
+  %b = clock_crossing %a {srcDomain = 1 : ui32, dstDomain = 1 : ui32, numSlots = 4 : ui32} : <i32>
+  end
+}
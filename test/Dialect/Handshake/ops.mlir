@@ -63,3 +63,19 @@ handshake.func @cmergeWithExtraSignal(
   %data, %idx = control_merge [%data1, %data2, %data3, %data4] : [<[spec: i1]>, <[spec: i1]>, <[spec: i1]>, <[spec: i1]>] to <[spec: i1]>, <i2, [spec: i1]>
   end %ctrl : !handshake.control<>
 }
+
+// -----
+
+handshake.func @taggedRegion(%a : !handshake.channel<i32>, %b : !handshake.channel<i1>, %ctrl : !handshake.control<>) -> (!handshake.channel<i32>, !handshake.channel<i1>, !handshake.control<>) {
+  %tagged:2 = tagger [%credit] %a, %b {numTags = 4 : ui32} : <i32>, <i1> -> <i32, [tag: i2]>, <i1, [tag: i2]>
+  %untagged:2, %credit = untagger %tagged#0, %tagged#1 {numTags = 4 : ui32} : <i32, [tag: i2]>, <i1, [tag: i2]> -> <i32>, <i1>
+  end %untagged#0, %untagged#1, %ctrl : !handshake.channel<i32>, !handshake.channel<i1>, !handshake.control<>
+}
+
+// -----
+
+handshake.func @clockCrossing(%a : !handshake.channel<f32>, %ctrl : !handshake.control<>) -> (!handshake.channel<f32>, !handshake.control<>) {
+  %slow = clock_crossing %a {srcDomain = 0 : ui32, dstDomain = 1 : ui32, numSlots = 4 : ui32} : <f32>
+  %fast = clock_crossing %slow {srcDomain = 1 : ui32, dstDomain = 0 : ui32, numSlots = 4 : ui32} : <f32>
+  end %fast, %ctrl : !handshake.channel<f32>, !handshake.control<>
+}
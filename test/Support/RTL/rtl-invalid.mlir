@@ -0,0 +1,38 @@
+// RUN: dynamatic-opt %s --test-rtl-support="rtl-config-path=%S/rtl.json" --split-input-file --verify-diagnostics
+
+// expected-error @below {{no matching component}}
+// expected-note @below {{RTL configuration has no component with this name}}
+hw.module.extern @unknown_name() attributes {hw.name = "test_unknown", hw.parameters = {}}
+
+// -----
+
+// expected-error @below {{no matching component}}
+// expected-note @below {{candidate #0 ("test_boolean", module "test_boolean") does not match: parameter "PARAM_3" is missing}}
+hw.module.extern @missing_param() attributes {hw.name = "test_boolean", hw.parameters = {
+  PARAM_1 = true,
+  PARAM_2 = true
+}}
+
+// -----
+
+// expected-error @below {{no matching component}}
+// expected-note @below {{candidate #1 ("test_unsigned", module "test_unsigned") does not match: parameter "PARAM_2" has value 7 : ui32, which violates constraints (value >= 1, value <= 5); parameter "PARAM_4" has value 2 : ui32, which violates constraints (value == 1)}}
+hw.module.extern @unsigned_violations() attributes {hw.name = "test_unsigned", hw.parameters = {
+  PARAM_1 = 32 : ui32,
+  PARAM_2 = 7 : ui32,
+  PARAM_3 = 3 : ui32,
+  PARAM_4 = 2 : ui32,
+  PARAM_5 = 2 : ui32
+}}
+
+// -----
+
+// expected-error @below {{no matching component}}
+// expected-note @below {{parameter "PARAM_2" has value !handshake.channel<i4>, which violates constraints (data width >= 0, data width <= 10, data width != 4)}}
+hw.module.extern @dataflow_violation() attributes {hw.name = "test_dataflow", hw.parameters = {
+  PARAM_1 = !handshake.channel<i32>,
+  PARAM_2 = !handshake.channel<i4>,
+  PARAM_3 = !handshake.control<>,
+  PARAM_4 = !handshake.channel<i32, [down1: i1, down2: i4]>,
+  PARAM_5 = !handshake.channel<i32, [down1: i4, up1: i1 (U)]>
+}}
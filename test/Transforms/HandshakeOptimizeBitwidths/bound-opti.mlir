@@ -151,7 +151,7 @@ handshake.func @mulCmps(%arg0: !handshake.channel<i32>, %bound: !handshake.chann
 // CHECK:           %[[VAL_9:.*]] = cmpi ult, %[[VAL_7]], %[[VAL_8]] : <i5>
 // CHECK:           %[[VAL_10:.*]], %[[VAL_11:.*]] = cond_br %[[VAL_9]], %[[VAL_7]] : <i1>, <i5>
 // CHECK:           %[[VAL_12:.*]] = extui %[[VAL_11]] : <i5> to <i32>
-// CHECK:           %[[VAL_4]] = trunci %[[VAL_10]] : <i5> to <i4>
+// CHECK:           %[[VAL_4]] = trunci %[[VAL_10]] {handshake.narrowing = "zext"} : <i5> to <i4>
 // CHECK:           end %[[VAL_12]] : <i32>
 // CHECK:         }
 handshake.func @simpleLoop(%start: !handshake.control<>) -> !handshake.channel<i32> {
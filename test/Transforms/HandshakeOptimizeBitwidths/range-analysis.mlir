@@ -0,0 +1,72 @@
+// RUN: dynamatic-opt --handshake-optimize-bitwidths="range-analysis=true" --remove-operation-names %s --split-input-file | FileCheck %s
+
+// CHECK-LABEL:   handshake.func @divuiByConstant(
+// CHECK:           %[[DIV:.*]] = divui %{{.*}}, %{{.*}} : <i32>
+// CHECK:           %[[TRUNC:.*]] = trunci %[[DIV]] {handshake.narrowing = "zext"} : <i32> to <i23>
+// CHECK:           %[[EXT:.*]] = extui %[[TRUNC]] : <i23> to <i32>
+// CHECK:           end %[[EXT]] : <i32>
+handshake.func @divuiByConstant(%arg0: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %cst = handshake.constant %start {value = 1000 : i32} : <>, <i32>
+  %res = divui %arg0, %cst : <i32>
+  end %res : <i32>
+}
+
+
+// -----
+
+// The loop bound is only known after the branch is first visited, which must
+// still refine the loop counter to [0, 100].
+
+// CHECK-LABEL:   handshake.func @loopCounter(
+// CHECK:           <i7>
+// CHECK-NOT:       to <i1>
+handshake.func @loopCounter(%start: !handshake.control<>) -> !handshake.channel<i32> {
+  %c0 = constant %start {value = 0 : i32} : <>, <i32>
+  %i = merge %c0, %next : <i32>
+  %cond = cmpi ult, %i, %bound : <i32>
+  %true, %false = cond_br %cond, %i : <i1>, <i32>
+  %c1 = constant %start {value = 1 : i32} : <>, <i32>
+  %next = addi %true, %c1 : <i32>
+  %bound = constant %start {value = 100 : i32} : <>, <i32>
+  end %false : <i32>
+}
+
+// -----
+
+// The accumulator is widened to the full range, then narrowed back to
+// [0, 1002] by the exit condition whose bound is only known late.
+
+// CHECK-LABEL:   handshake.func @accumulator(
+// CHECK:           <i10>
+// CHECK-NOT:       to <i1>
+handshake.func @accumulator(%start: !handshake.control<>) -> !handshake.channel<i32> {
+  %c0 = constant %start {value = 0 : i32} : <>, <i32>
+  %acc = merge %c0, %next : <i32>
+  %cond = cmpi ult, %acc, %bound : <i32>
+  %true, %false = cond_br %cond, %acc : <i1>, <i32>
+  %c3 = constant %start {value = 3 : i32} : <>, <i32>
+  %next = addi %true, %c3 : <i32>
+  %bound = constant %start {value = 1000 : i32} : <>, <i32>
+  end %false : <i32>
+}
+
+// -----
+
+// Nothing is known about loaded data, so the merge joining it with a constant
+// must keep its full width.
+
+// CHECK-LABEL:   handshake.func @mergeWithLoad(
+// CHECK-NOT:       handshake.narrowing
+// CHECK:           %[[ADDR:.*]], %[[DATA:.*]] = load
+// CHECK-NOT:       handshake.narrowing
+// CHECK:           %[[MERGE:.*]] = merge %{{.*}}, %[[DATA]] : <i32>
+// CHECK-NOT:       handshake.narrowing
+// CHECK:           end %[[MERGE]], %{{.*}} : <i32>, <>
+handshake.func @mergeWithLoad(%mem: memref<1000xi32>, %mem_start: !handshake.control<>, %start: !handshake.control<>) -> (!handshake.channel<i32>, !handshake.control<>) {
+  %ldData, %done = mem_controller[%mem : memref<1000xi32>] %mem_start (%ldAddr) %start {connectedBlocks = [0 : i32]} : (!handshake.channel<i32>) -> !handshake.channel<i32>
+  %addr = constant %start {value = 0 : i32} : <>, <i32>
+  %ldAddr, %ldVal = load[%addr] %ldData {handshake.bb = 0 : ui32} : <i32>, <i32>, <i32>, <i32>
+  %c0 = constant %start {value = 0 : i32} : <>, <i32>
+  %res = merge %c0, %ldVal : <i32>
+  end %res, %done : <i32>, <>
+}
@@ -0,0 +1,44 @@
+// RUN: rm -f %t.json
+// RUN: dynamatic-opt %s --fingerprint-regions="fingerprints=%t.json label=first" 2>&1 >/dev/null | FileCheck %s --check-prefix=FIRST
+// RUN: dynamatic-opt %s --fingerprint-regions="fingerprints=%t.json label=second" 2>&1 >/dev/null | FileCheck %s --check-prefix=SECOND
+// RUN: sed 's/constant 1 :/constant 2 :/' %s | dynamatic-opt --fingerprint-regions="fingerprints=%t.json label=third" 2>&1 >/dev/null | FileCheck %s --check-prefix=THIRD
+// RUN: FileCheck %s --check-prefix=JSON --input-file=%t.json
+
+// FIRST: [first] select: no prior fingerprint, all 3 basic blocks modified
+// FIRST: [first] identity: no prior fingerprint, all 1 basic blocks modified
+// FIRST-NOT: external
+
+// SECOND: [second] select: unchanged
+// SECOND: [second] identity: unchanged
+
+// THIRD: [third] select: 1 of 3 basic blocks modified (bb1)
+// THIRD: [third] identity: unchanged
+
+// JSON:      "format_version": 1,
+// JSON-NEXT: "functions": {
+// JSON-NEXT:   "identity": {
+// JSON-NEXT:     "blocks": {
+// JSON-NEXT:       "0": "{{[0-9A-F]+}}"
+// JSON:        "select": {
+// JSON-NEXT:     "blocks": {
+// JSON-NEXT:       "0": "{{[0-9A-F]+}}",
+// JSON-NEXT:       "1": "{{[0-9A-F]+}}",
+// JSON-NEXT:       "2": "{{[0-9A-F]+}}"
+
+func.func @select(%arg0: i32) -> i32 {
+  %c10 = arith.constant 10 : i32
+  %eq = arith.cmpi eq, %arg0, %c10 : i32
+  cf.cond_br %eq, ^bb1, ^bb2
+^bb1:
+  %one = arith.constant 1 : i32
+  return %one : i32
+^bb2:
+  %zero = arith.constant 0 : i32
+  return %zero : i32
+}
+
+func.func @identity(%arg0: i32) -> i32 {
+  return %arg0 : i32
+}
+
+func.func private @external(i32) -> i32
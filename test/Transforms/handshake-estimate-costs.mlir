@@ -0,0 +1,48 @@
+// RUN: dynamatic-opt --handshake-estimate-costs="timing-models=%S/../../data/components.json target-period=4 label=test" %s 2>&1 >/dev/null | FileCheck %s
+// RUN: rm -f %t.json
+// RUN: dynamatic-opt %s --handshake-estimate-costs="timing-models=%S/../../data/components.json target-period=4 report=%t.json label=before" --handshake-select-iterative-units="timing-models=%S/../../data/components.json target-period=4" --handshake-estimate-costs="timing-models=%S/../../data/components.json target-period=4 report=%t.json label=after" > /dev/null
+// RUN: FileCheck %s --check-prefix=REPORT --input-file=%t.json
+
+// CHECK: [test] pipelined: area = 1184.0 LUTs (1 of 2 units uncharacterized), critical path = 2.488 ns
+// CHECK: [test] iterative: area = 206.0 LUTs (1 of 2 units uncharacterized), critical path = 2.800 ns
+// CHECK: [test] chain: area = 68.0 LUTs (1 of 3 units uncharacterized), critical path = 5.135 ns
+// CHECK: [test] bufferedChain: area = 71.0 LUTs (1 of 4 units uncharacterized), critical path = 3.266 ns
+// CHECK: [test] slowLoop: area = 1184.0 LUTs (1 of 2 units uncharacterized), critical path = 2.488 ns
+
+// REPORT:      "function": "pipelined",
+// REPORT-NEXT: "label": "before",
+// REPORT:      "delta_area": -978,
+// REPORT-NEXT: "delta_critical_path_delay": 0.31{{[0-9]*}},
+// REPORT-NEXT: "function": "slowLoop",
+// REPORT-NEXT: "label": "after",
+// REPORT-NEXT: "num_uncharacterized_units": 1,
+// REPORT-NEXT: "num_units": 2
+// REPORT:      "format_version": 1
+
+handshake.func @pipelined(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %quot = divsi %a, %b {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+  end %quot : <i32>
+}
+
+handshake.func @iterative(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %quot = divsi %a, %b {handshake.bb = 1 : ui32, ii = 8 : i64, latency = 8 : i64} : <i32>
+  end %quot : <i32>
+}
+
+handshake.func @chain(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %sum = addi %a, %b : <i32>
+  %res = addi %sum, %b : <i32>
+  end %res : <i32>
+}
+
+handshake.func @bufferedChain(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %sum = addi %a, %b : <i32>
+  %buf = buffer %sum, bufferType = ONE_SLOT_BREAK_DV, numSlots = 1, dvLatency = 1 : <i32>
+  %res = addi %buf, %b : <i32>
+  end %res : <i32>
+}
+
+handshake.func @slowLoop(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> attributes {handshake.cfdfcThroughput = #handshake<cfdfcThroughput {"0" = 1.250000e-01 : f64}>, handshake.cfdfcToBBList = #handshake<cfdfcToBBList {"0" = [1 : ui32]}>} {
+  %quot = divsi %a, %b {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+  end %quot : <i32>
+}
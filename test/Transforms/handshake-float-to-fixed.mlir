@@ -0,0 +1,84 @@
+// RUN: dynamatic-opt --handshake-float-to-fixed --remove-operation-names %s --split-input-file --verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   handshake.func @scaleByHalf(
+// CHECK-NOT:       mulf
+// CHECK:           muli
+// CHECK:           shrsi
+// CHECK-NOT:       fptosi
+// CHECK:           end
+handshake.func @scaleByHalf(%arg0: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %half = handshake.constant %start {value = 5.000000e-01 : f32} : <>, <f32>
+  %x = sitofp %arg0 : <i32> to <f32>
+  %prod = mulf %x, %half : <f32>
+  // expected-remark @below {{converted floating-point region of 1 operation(s) to fixed-point with 10 fractional bit(s) on 53 bit(s)}}
+  %res = fptosi %prod : <f32> to <i32>
+  end %res : <i32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @divisorMayBeZero(
+// CHECK:           divf
+handshake.func @divisorMayBeZero(%arg0: !handshake.channel<i32>, %arg1: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %x = sitofp %arg0 : <i32> to <f32>
+  %y = sitofp %arg1 : <i32> to <f32>
+  %quot = divf %x, %y : <f32>
+  // expected-remark @below {{could not find a fixed-point format for the floating-point region of 1 operation(s) meeting the error bound}}
+  %res = fptosi %quot : <f32> to <i32>
+  end %res : <i32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @scaleArgument(
+// CHECK:           %[[SCALED:.*]] = mulf %[[ARG:.*]], %{{.*}} : <f32>
+// CHECK:           %[[CONV:.*]] = fptosi %[[SCALED]] {{.*}}: <f32> to <i32>
+// CHECK:           %[[EXT:.*]] = trunci %[[CONV]] {{.*}}: <i32> to <i26>
+// CHECK:           muli %[[EXT]], %{{.*}} : <i26>
+// CHECK-NOT:       fptosi
+// CHECK:           end
+handshake.func @scaleArgument(%arg0: !handshake.channel<f32> {handshake.float_range = array<f64: 0.0, 4.0>}, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %half = handshake.constant %start {value = 5.000000e-01 : f32} : <>, <f32>
+  %prod = mulf %arg0, %half : <f32>
+  // expected-remark @below {{converted floating-point region of 1 operation(s) to fixed-point with 11 fractional bit(s) on 26 bit(s)}}
+  %res = fptosi %prod : <f32> to <i32>
+  end %res : <i32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @accumulateLoads(
+// CHECK:           %[[ACC:.*]] = merge %{{.*}}, %[[NEXT:[a-zA-Z0-9_]+]] {{.*}}: <i26>
+// CHECK:           %{{.*}}, %[[DATA:.*]] = load
+// CHECK:           %[[SCALED:.*]] = mulf %[[DATA]], %{{.*}} : <f32>
+// CHECK:           %[[CONV:.*]] = fptosi %[[SCALED]] {{.*}}: <f32> to <i32>
+// CHECK:           %[[EXT:.*]] = trunci %[[CONV]] {{.*}}: <i32> to <i26>
+// CHECK:           %[[SUM:.*]] = addi %[[ACC]], %[[EXT]] {{.*}}: <i26>
+// CHECK-NOT:       addf
+// CHECK:           %[[NEXT]], %[[EXIT:.*]] = cond_br %{{.*}}, %[[SUM]] {{.*}}: <i1>, <i26>
+// CHECK:           divsi %[[EXIT]], %{{.*}} : <i26>
+handshake.func @accumulateLoads(%mem: memref<8xf32>, %mem_start: !handshake.control<>, %start: !handshake.control<>) -> (!handshake.channel<i32>, !handshake.control<>) {
+  %ldData, %done = mem_controller[%mem : memref<8xf32>] %mem_start (%ldAddr) %start {connectedBlocks = [1 : i32]} : (!handshake.channel<i32>) -> !handshake.channel<f32>
+  %startFork:2 = fork [2] %start : <>
+  %zero = constant %startFork#0 {value = 0 : i32} : <>, <i32>
+  %fzero = constant %startFork#1 {value = 0.000000e+00 : f32} : <>, <f32>
+  %i = merge %zero, %iNext {handshake.bb = 1 : ui32} : <i32>
+  %iFork:2 = fork [2] %i {handshake.bb = 1 : ui32} : <i32>
+  %acc = merge %fzero, %accNext {handshake.bb = 1 : ui32, handshake.float_range = array<f64: -8.0, 8.0>} : <f32>
+  %ldAddr, %x = load[%iFork#0] %ldData {handshake.bb = 1 : ui32, handshake.float_range = array<f64: -1.0, 1.0>} : <i32>, <f32>, <i32>, <f32>
+  %sum = addf %acc, %x {handshake.bb = 1 : ui32} : <f32>
+  %src = source {handshake.bb = 1 : ui32} : <>
+  %srcFork:2 = fork [2] %src {handshake.bb = 1 : ui32} : <>
+  %one = constant %srcFork#0 {value = 1 : i32} : <>, <i32>
+  %eight = constant %srcFork#1 {value = 8 : i32} : <>, <i32>
+  %iInc = addi %iFork#1, %one {handshake.bb = 1 : ui32} : <i32>
+  %iIncFork:2 = fork [2] %iInc {handshake.bb = 1 : ui32} : <i32>
+  %cond = cmpi ult, %iIncFork#0, %eight {handshake.bb = 1 : ui32} : <i32>
+  %condFork:2 = fork [2] %cond {handshake.bb = 1 : ui32} : <i1>
+  %iNext, %iExit = cond_br %condFork#0, %iIncFork#1 {handshake.bb = 1 : ui32} : <i1>, <i32>
+  %accNext, %accExit = cond_br %condFork#1, %sum {handshake.bb = 1 : ui32} : <i1>, <f32>
+  sink %iExit : <i32>
+  // expected-remark @below {{converted floating-point region of 3 operation(s) to fixed-point with 20 fractional bit(s) on 26 bit(s)}}
+  %res = fptosi %accExit {handshake.bb = 2 : ui32} : <f32> to <i32>
+  end {handshake.bb = 2 : ui32} %res, %done : <i32>, <>
+}
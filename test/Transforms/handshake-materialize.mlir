@@ -289,3 +289,16 @@ handshake.func @makeLSQForkLazyDoubleLSQ(%memref: memref<64xi32>, %start: !hands
   %stAddrToMem2, %stDataToMem2 = store [%addr2] %ldDataToSucc2 {handshake.bb = 1 : ui32} : <i32>, <i32>, <i32>, <i32>
   end {handshake.bb = 1 : ui32} %ctrlTo1 : <>
 }
+
+// -----
+
+// CHECK-LABEL:   handshake.func @materializeInClockDomain(
+// CHECK:           %[[SLOW:.*]] = clock_crossing %{{.*}} {dstDomain = 1 : ui32, numSlots = 4 : ui32, srcDomain = 0 : ui32} : <f32>
+// CHECK:           %[[FORK:.*]]:2 = fork [2] %[[SLOW]] {handshake.clock_domain = 1 : ui32} : <f32>
+// CHECK:           %[[QUOT:.*]] = divf %[[FORK]]#0, %[[FORK]]#1 {handshake.clock_domain = 1 : ui32} : <f32>
+// CHECK:           sink %[[QUOT]] {handshake.clock_domain = 1 : ui32} : <f32>
+handshake.func @materializeInClockDomain(%a: !handshake.channel<f32>, %start: !handshake.control<>) -> !handshake.control<> attributes {handshake.clock_ratios = [2.000000e+00]} {
+  %slow = clock_crossing %a {srcDomain = 0 : ui32, dstDomain = 1 : ui32, numSlots = 4 : ui32} : <f32>
+  %quot = divf %slow, %slow {handshake.clock_domain = 1 : ui32} : <f32>
+  end %start : <>
+}
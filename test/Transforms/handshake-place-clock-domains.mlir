@@ -0,0 +1,32 @@
+// RUN: dynamatic-opt --handshake-place-clock-domains="ops=handshake.divf period-ratio=3" --remove-operation-names %s --split-input-file --verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   handshake.func @slowDivider(
+// CHECK-SAME:      handshake.clock_ratios = [3.000000e+00]
+// CHECK:           %[[LHS:.*]] = clock_crossing %{{.*}} {dstDomain = 1 : ui32, numSlots = 4 : ui32, srcDomain = 0 : ui32} : <f32>
+// CHECK:           %[[RHS:.*]] = clock_crossing %{{.*}} {dstDomain = 1 : ui32, numSlots = 4 : ui32, srcDomain = 0 : ui32} : <f32>
+// CHECK:           %[[QUOT:.*]] = divf %[[LHS]], %[[RHS]] {handshake.clock_domain = 1 : ui32} : <f32>
+// CHECK:           %[[RES:.*]] = clock_crossing %[[QUOT]] {dstDomain = 0 : ui32, numSlots = 4 : ui32, srcDomain = 1 : ui32} : <f32>
+// CHECK:           addf %[[RES]], %{{.*}} : <f32>
+handshake.func @slowDivider(%a: !handshake.channel<f32>, %b: !handshake.channel<f32>, %start: !handshake.control<>) -> !handshake.channel<f32> {
+  %quot = divf %a, %b : <f32>
+  %sum = addf %quot, %a : <f32>
+  end %sum : <f32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @noSlowUnit(
+// CHECK-NOT:       handshake.clock_ratios
+// CHECK-NOT:       clock_crossing
+handshake.func @noSlowUnit(%a: !handshake.channel<f32>, %b: !handshake.channel<f32>, %start: !handshake.control<>) -> !handshake.channel<f32> {
+  %sum = addf %a, %b : <f32>
+  end %sum : <f32>
+}
+
+// -----
+
+handshake.func @speculativeDivider(%a: !handshake.channel<f32, [spec: i1]>, %b: !handshake.channel<f32, [spec: i1]>, %start: !handshake.control<>) -> !handshake.channel<f32, [spec: i1]> {
+  // expected-error @below {{channel carrying extra signals cannot cross clock domains}}
+  %quot = divf %a, %b : <f32, [spec: i1]>
+  end %quot : <f32, [spec: i1]>
+}
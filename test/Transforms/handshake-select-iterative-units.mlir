@@ -0,0 +1,28 @@
+// RUN: dynamatic-opt --handshake-select-iterative-units="timing-models=%S/../../data/components.json target-period=4" %s --split-input-file | FileCheck %s
+
+// CHECK-LABEL:   handshake.func @slowLoop(
+// CHECK:           divsi %{{.*}}, %{{.*}} {handshake.bb = 1 : ui32, ii = 8 : i64, latency = 8 : i64} : <i32>
+// CHECK:           divsi %{{.*}}, %{{.*}} {handshake.bb = 2 : ui32, ii = 32 : i64, latency = 32 : i64} : <i32>
+handshake.func @slowLoop(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> attributes {handshake.cfdfcThroughput = #handshake<cfdfcThroughput {"0" = 1.250000e-01 : f64}>, handshake.cfdfcToBBList = #handshake<cfdfcToBBList {"0" = [1 : ui32]}>} {
+  %quot = divsi %a, %b {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+  %res = divsi %quot, %b {handshake.bb = 2 : ui32, latency = 35 : i64} : <i32>
+  end %res : <i32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @fastLoop(
+// CHECK:           divui %{{.*}}, %{{.*}} {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+handshake.func @fastLoop(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> attributes {handshake.cfdfcThroughput = #handshake<cfdfcThroughput {"0" = 1.000000e+00 : f64}>, handshake.cfdfcToBBList = #handshake<cfdfcToBBList {"0" = [1 : ui32]}>} {
+  %quot = divui %a, %b {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+  end %quot : <i32>
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @noPlacement(
+// CHECK:           divsi %{{.*}}, %{{.*}} {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+handshake.func @noPlacement(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %start: !handshake.control<>) -> !handshake.channel<i32> {
+  %quot = divsi %a, %b {handshake.bb = 1 : ui32, latency = 35 : i64} : <i32>
+  end %quot : <i32>
+}
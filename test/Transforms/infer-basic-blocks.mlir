@@ -128,3 +128,65 @@ handshake.func @backwardOverForward(%start: !handshake.control<>) {
   %3 = merge %1#1 {handshake.bb = 3 : ui32} : <>
   end
 }
+
+// -----
+
+// CHECK-LABEL:   handshake.func @producerFirst(
+// CHECK-SAME:                                  %[[VAL_0:.*]]: !handshake.control<>, ...) attributes {argNames = ["start"], resNames = []} {
+// CHECK:           %[[VAL_1:.*]] = merge %[[VAL_0]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_2:.*]] = fork  [1] %[[VAL_1]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_3:.*]] = fork  [1] %[[VAL_2]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_4:.*]] = br %[[VAL_3]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           end
+// CHECK:         }
+handshake.func @producerFirst(%start: !handshake.control<>) {
+  %0 = merge %start {handshake.bb = 1 : ui32} : <>
+  %1 = fork [1] %0 : <>
+  %2 = fork [1] %1 : <>
+  %3 = br %2 {handshake.bb = 2 : ui32} : <>
+  end
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @userFirst(
+// CHECK-SAME:                              %[[VAL_0:.*]]: !handshake.control<>, ...) attributes {argNames = ["start"], resNames = []} {
+// CHECK:           %[[VAL_1:.*]] = merge %[[VAL_0]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_2:.*]] = fork  [1] %[[VAL_3:.*]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_3]] = fork  [1] %[[VAL_1]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_4:.*]] = br %[[VAL_2]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           end
+// CHECK:         }
+handshake.func @userFirst(%start: !handshake.control<>) {
+  %0 = merge %start {handshake.bb = 1 : ui32} : <>
+  %2 = fork [1] %1 : <>
+  %1 = fork [1] %0 : <>
+  %3 = br %2 {handshake.bb = 2 : ui32} : <>
+  end
+}
+
+// -----
+
+// CHECK-LABEL:   handshake.func @sweepOrder(
+// CHECK-SAME:                               %[[VAL_0:.*]]: !handshake.control<>, ...) attributes {argNames = ["start"], resNames = []} {
+// CHECK:           %[[VAL_1:.*]] = merge %[[VAL_0]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_2:.*]]:2 = fork  [2] %[[VAL_3:.*]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_4:.*]] = fork  [1] %[[VAL_2]]#0 {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_5:.*]] = fork  [1] %[[VAL_4]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_6:.*]] = br %[[VAL_5]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_3]] = fork  [1] %[[VAL_1]] {handshake.bb = 1 : ui32} : <>
+// CHECK:           %[[VAL_7:.*]] = fork  [1] %[[VAL_2]]#1 {handshake.bb = 2 : ui32} : <>
+// CHECK:           %[[VAL_8:.*]] = br %[[VAL_7]] {handshake.bb = 2 : ui32} : <>
+// CHECK:           end
+// CHECK:         }
+handshake.func @sweepOrder(%start: !handshake.control<>) {
+  %0 = merge %start {handshake.bb = 1 : ui32} : <>
+  %1:2 = fork [2] %5 : <>
+  %2 = fork [1] %1#0 : <>
+  %3 = fork [1] %2 : <>
+  %4 = br %3 {handshake.bb = 2 : ui32} : <>
+  %5 = fork [1] %0 : <>
+  %6 = fork [1] %1#1 : <>
+  %7 = br %6 {handshake.bb = 2 : ui32} : <>
+  end
+}
@@ -46,7 +46,8 @@ struct TestRTLSupport
     for (auto modOp : getOperation().getOps<hw::HWModuleExternOp>()) {
       RTLRequestFromHWModule request(modOp);
       if (!config.hasMatchingComponent(request)) {
-        modOp->emitError() << "no matching component";
+        InFlightDiagnostic diag = modOp->emitError() << "no matching component";
+        config.explainNoMatch(request, diag);
         return signalPassFailure();
       }
     }
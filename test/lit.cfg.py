@@ -43,13 +43,15 @@ llvm_config.with_environment("PATH", config.llvm_tools_dir, append_path=True)
 
 tool_dirs = [config.dynamatic_tools_dir,
              config.mlir_tools_dir, config.llvm_tools_dir]
-tools = ["dynamatic-opt", "hls-fuzzer-check-bitwidth",
+tools = ["dynamatic-opt", "hls-fuzzer-check-bitwidth", "trace-profiler",
          ToolSubst("%source-rewriter",
                    command=f"cp %s %t.c && {config.dynamatic_tools_dir}/source-rewriter %t.c --"),
          ToolSubst("%export-vhdl",
                    command=f"rm -rf %t; mkdir %t; {config.dynamatic_tools_dir}/export-rtl %s %t {config.dynamatic_src_root}/data/rtl-config-vhdl.json --dynamatic-path {config.dynamatic_src_root} --hdl vhdl"),
          ToolSubst("%translate-llvm-to-std",
                    command=f"{config.llvm_tools_dir}/split-file %s %t; {config.dynamatic_tools_dir}/translate-llvm-to-std %t/test.ll -csource %t/test.c -function-name=test --dynamatic-path {config.dynamatic_src_root}"),
+         ToolSubst("%translate-llvm-to-std-errors",
+                   command=f"{config.llvm_tools_dir}/split-file %s %t; not {config.dynamatic_tools_dir}/translate-llvm-to-std %t/test.ll -csource %t/test.c -function-name=test --dynamatic-path {config.dynamatic_src_root} 2>&1"),
          ToolSubst("%dyn-clang-pragmas",
                    command=f"{config.llvm_tools_dir}/clang "
                    f"-fplugin={config.dynamatic_shlib_dir}/DynPragmasPlugin{config.llvm_shlib_ext} "
@@ -0,0 +1,32 @@
+// RUN: %export-vhdl --runtime-checks
+// RUN: FileCheck %s -input-file %t/test.vhd
+
+// Only the truncations marked as narrowing by bitwidth optimization are
+// checked, under the extension they were narrowed for.
+
+// CHECK-LABEL: architecture {{.*}} of test
+// CHECK:       -- pragma translate_off
+// CHECK-NEXT:  runtime_checks : process (clk)
+// CHECK-NEXT:    file log_file : text open write_mode is "assertions.log";
+// CHECK:         if rst = '0' then
+// CHECK-NEXT:      if a_valid = '1' and a(31 downto 7) /= (31 downto 7 => '0') and a(31 downto 7) /= (31 downto 7 => '1') then
+// CHECK:             write(log_line, string'(": trunci0 (handshake.trunci): value on ins does not fit in 8 bits as a signed integer"));
+// CHECK-NEXT:        writeline(log_file, log_line);
+// CHECK-NEXT:      end if;
+// CHECK-NOT:       trunci1
+// CHECK:           if c_valid = '1' and c(31 downto 8) /= (31 downto 8 => '0') then
+// CHECK:             write(log_line, string'(": trunci2 (handshake.trunci): value on ins does not fit in 8 bits as an unsigned integer"));
+// CHECK-NEXT:        writeline(log_file, log_line);
+// CHECK-NEXT:      end if;
+// CHECK:         cycle := cycle + 1;
+// CHECK:       -- pragma translate_on
+
+module {
+  hw.module @test(in %a : !handshake.channel<i32>, in %b : !handshake.channel<i32>, in %c : !handshake.channel<i32>, in %start : !handshake.control<>, in %clk : i1, in %rst : i1, out out0 : !handshake.channel<i8>, out out1 : !handshake.channel<i8>, out out2 : !handshake.channel<i8>, out end : !handshake.control<>) {
+    %trunci0.outs = hw.instance "trunci0" @handshake_trunci_0(ins: %a: !handshake.channel<i32>, clk: %clk: i1, rst: %rst: i1) -> (outs: !handshake.channel<i8>) {handshake.narrowing = "sext"}
+    %trunci1.outs = hw.instance "trunci1" @handshake_trunci_0(ins: %b: !handshake.channel<i32>, clk: %clk: i1, rst: %rst: i1) -> (outs: !handshake.channel<i8>)
+    %trunci2.outs = hw.instance "trunci2" @handshake_trunci_0(ins: %c: !handshake.channel<i32>, clk: %clk: i1, rst: %rst: i1) -> (outs: !handshake.channel<i8>) {handshake.narrowing = "zext"}
+    hw.output %trunci0.outs, %trunci1.outs, %trunci2.outs, %start : !handshake.channel<i8>, !handshake.channel<i8>, !handshake.channel<i8>, !handshake.control<>
+  }
+  hw.module.extern @handshake_trunci_0(in %ins : !handshake.channel<i32>, in %clk : i1, in %rst : i1, out outs : !handshake.channel<i8>) attributes {hw.name = "handshake.trunci", hw.parameters = {INPUT_TYPE = !handshake.channel<i32>, OUTPUT_TYPE = !handshake.channel<i8>}}
+}
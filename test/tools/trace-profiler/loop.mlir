@@ -0,0 +1,28 @@
+// RUN: trace-profiler %s %S/Inputs/loop.csv | FileCheck %s
+
+// CHECK:      Total cycles: 9
+// CHECK-EMPTY:
+// CHECK-NEXT: Basic blocks (cycles during which a token is transferred inside the block):
+// CHECK-NEXT:   BB 0: 2 cycles (22.2%), 4 transfers
+// CHECK-NEXT:   BB 1: 4 cycles (44.4%), 4 transfers
+// CHECK-NEXT:   Cycles without any transfer: 3
+// CHECK-EMPTY:
+// CHECK-NEXT: CFDFCs:
+// CHECK-NEXT:   CFDFC 0 (BBs 1): 3 iterations over 1 execution(s), achieved II 2.00, predicted II 1.00 [BELOW ESTIMATE]
+// CHECK-EMPTY:
+// CHECK-NEXT: 1 CFDFC(s) achieved a lower throughput than estimated by buffer placement
+
+handshake.func @loop(%start: !handshake.control<>, ...) -> (!handshake.channel<i32>, !handshake.control<>) attributes {argNames = ["start"], resNames = ["out0", "end"], handshake.cfdfcThroughput = #handshake<cfdfcThroughput {"0" = 1.000000e+00 : f64}>, handshake.cfdfcToBBList = #handshake<cfdfcToBBList {"0" = [1 : ui32]}>} {
+  %start0:2 = fork [2] %start {handshake.bb = 0 : ui32, handshake.name = "fork0"} : <>
+  %c0 = constant %start0#0 {value = 0 : i32, handshake.bb = 0 : ui32, handshake.name = "constant0"} : <>, <i32>
+  %i = merge %c0, %next {handshake.bb = 1 : ui32, handshake.name = "merge0"} : <i32>
+  %iCopies:2 = fork [2] %i {handshake.bb = 1 : ui32, handshake.name = "fork1"} : <i32>
+  %src0 = source {handshake.bb = 1 : ui32, handshake.name = "source0"} : <>
+  %c1 = constant %src0 {value = 1 : i32, handshake.bb = 1 : ui32, handshake.name = "constant1"} : <>, <i32>
+  %src1 = source {handshake.bb = 1 : ui32, handshake.name = "source1"} : <>
+  %bound = constant %src1 {value = 3 : i32, handshake.bb = 1 : ui32, handshake.name = "constant2"} : <>, <i32>
+  %cond = cmpi ult, %iCopies#0, %bound {handshake.bb = 1 : ui32, handshake.name = "cmpi0"} : <i32>
+  %inc = addi %iCopies#1, %c1 {handshake.bb = 1 : ui32, handshake.name = "addi0"} : <i32>
+  %next, %exit = cond_br %cond, %inc {handshake.bb = 1 : ui32, handshake.name = "cond_br0"} : <i1>, <i32>
+  end {handshake.bb = 2 : ui32, handshake.name = "end0"} %exit, %start0#1 : <i32>, <>
+}
@@ -0,0 +1,18 @@
+; RUN: %translate-llvm-to-std -o - | FileCheck %s
+
+;--- test.ll
+
+; CHECK-LABEL: func.func @test(
+; CHECK-SAME: %[[A:.*]]: i32
+define i32 @test(i32 %a) {
+  ; CHECK-NOT: llvm.mlir.undef
+  ; CHECK: %[[SUM:.*]] = arith.addi %[[A]], %{{.*}} : i32
+  ; CHECK: return %[[SUM]] : i32
+  %f = freeze i32 %a
+  %sum = add i32 %f, 1
+  ret i32 %sum
+}
+
+;--- test.c
+
+int test(int a);
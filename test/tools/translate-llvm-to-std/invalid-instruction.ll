@@ -0,0 +1,14 @@
+; RUN: %translate-llvm-to-std-errors | FileCheck %s
+
+;--- test.ll
+
+define i32 @test(i32 %a) {
+  ; CHECK: error: unsupported instruction 'fence'
+  ; CHECK: note: while translating LLVM instruction: fence seq_cst
+  fence seq_cst
+  ret i32 %a
+}
+
+;--- test.c
+
+int test(int a);
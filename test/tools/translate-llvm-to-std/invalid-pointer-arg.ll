@@ -0,0 +1,14 @@
+; RUN: %translate-llvm-to-std-errors | FileCheck %s
+
+;--- test.ll
+
+; CHECK: error: argument 'a' has unsupported type 'int *'
+; CHECK: note: pointer arguments must have a fixed extent, e.g., 'int a[8]' or 'int (*a)[8]'
+define i32 @test(ptr %a) {
+  %v = load i32, ptr %a
+  ret i32 %v
+}
+
+;--- test.c
+
+int test(int *a);
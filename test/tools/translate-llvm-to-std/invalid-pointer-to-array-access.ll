@@ -0,0 +1,15 @@
+; RUN: %translate-llvm-to-std-errors | FileCheck %s
+
+;--- test.ll
+
+define i32 @test(ptr %a, i64 %i) {
+  ; CHECK: error: access outside of the array pointed to by argument 'a' of type 'int (*)[8]'
+  ; CHECK: note: while translating LLVM instruction: %elem = getelementptr inbounds [8 x i32], ptr %a, i64 %i, i64 1
+  %elem = getelementptr inbounds [8 x i32], ptr %a, i64 %i, i64 1
+  %v = load i32, ptr %elem
+  ret i32 %v
+}
+
+;--- test.c
+
+int test(int (*a)[8], long i);
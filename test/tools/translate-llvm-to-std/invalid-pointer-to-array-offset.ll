@@ -0,0 +1,15 @@
+; RUN: %translate-llvm-to-std-errors | FileCheck %s
+
+;--- test.ll
+
+define i32 @test(ptr %a) {
+  ; CHECK: error: access outside of the array pointed to by argument 'a' of type 'int (*)[8]'
+  ; CHECK: note: the argument is translated to an array of the pointee's extent
+  %elem = getelementptr inbounds i8, ptr %a, i64 32
+  %v = load i32, ptr %elem
+  ret i32 %v
+}
+
+;--- test.c
+
+int test(int (*a)[8]);
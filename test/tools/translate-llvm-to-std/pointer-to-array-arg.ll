@@ -0,0 +1,22 @@
+; RUN: %translate-llvm-to-std -o - | FileCheck %s
+
+;--- test.ll
+
+; CHECK-LABEL: func.func @test(
+; CHECK-SAME: %[[A:.*]]: memref<8xi32>, %[[I:.*]]: i64
+define i32 @test(ptr %a, i64 %i) {
+  ; CHECK: %[[V:.*]] = memref.load %[[A]][%{{.*}}] {{.*}}: memref<8xi32>
+  ; CHECK: %[[W:.*]] = memref.load %[[A]][%{{.*}}] {{.*}}: memref<8xi32>
+  ; CHECK: %[[SUM:.*]] = arith.addi %[[V]], %[[W]] : i32
+  ; CHECK: return %[[SUM]] : i32
+  %elem = getelementptr inbounds [8 x i32], ptr %a, i64 0, i64 %i
+  %v = load i32, ptr %elem
+  %last = getelementptr inbounds i8, ptr %a, i64 28
+  %w = load i32, ptr %last
+  %sum = add i32 %v, %w
+  ret i32 %sum
+}
+
+;--- test.c
+
+int test(int (*a)[8], long i);
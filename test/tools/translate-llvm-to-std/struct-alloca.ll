@@ -0,0 +1,23 @@
+; RUN: %translate-llvm-to-std -o - | FileCheck %s
+
+;--- test.ll
+
+%struct.pair = type { i32, i32 }
+
+; CHECK-LABEL: func.func @test(
+; CHECK-SAME: %[[X:.*]]: i32
+define i32 @test(i32 %x) {
+  ; CHECK: %[[P:.*]] = memref.alloca() : memref<2xi32>
+  ; CHECK: memref.store %[[X]], %[[P]][%{{.*}}] {{.*}}: memref<2xi32>
+  ; CHECK: %[[V:.*]] = memref.load %[[P]][%{{.*}}] {{.*}}: memref<2xi32>
+  ; CHECK: return %[[V]] : i32
+  %p = alloca %struct.pair
+  %second = getelementptr inbounds %struct.pair, ptr %p, i64 0, i32 1
+  store i32 %x, ptr %second
+  %v = load i32, ptr %second
+  ret i32 %v
+}
+
+;--- test.c
+
+int test(int x);
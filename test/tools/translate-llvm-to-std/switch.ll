@@ -0,0 +1,37 @@
+; RUN: %translate-llvm-to-std -o - | FileCheck %s
+
+;--- test.ll
+
+; CHECK-LABEL: func.func @test(
+; CHECK-SAME: %[[SEL:.*]]: i32
+define i32 @test(i32 %sel) {
+entry:
+  ; CHECK: %[[IS_ONE:.*]] = arith.cmpi eq, %[[SEL]], %{{.*}} : i32
+  ; CHECK: cf.cond_br %[[IS_ONE]], ^bb{{[0-9]+}}, ^[[NEXT:bb[0-9]+]]
+  ; CHECK: ^[[NEXT]]:
+  ; CHECK: %[[IS_TWO:.*]] = arith.cmpi eq, %[[SEL]], %{{.*}} : i32
+  ; CHECK: cf.cond_br %[[IS_TWO]], ^bb{{[0-9]+}}, ^bb{{[0-9]+}}
+  switch i32 %sel, label %default [
+    i32 1, label %one
+    i32 2, label %two
+  ]
+
+one:
+  br label %exit
+
+two:
+  br label %exit
+
+default:
+  br label %exit
+
+exit:
+  ; CHECK: ^bb{{[0-9]+}}(%[[RES:.*]]: i32):
+  ; CHECK: return %[[RES]] : i32
+  %res = phi i32 [ 10, %one ], [ 20, %two ], [ 30, %default ]
+  ret i32 %res
+}
+
+;--- test.c
+
+int test(int sel);
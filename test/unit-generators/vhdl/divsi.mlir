@@ -0,0 +1,15 @@
+// RUN: %export-vhdl
+// RUN: FileCheck %s -input-file %t/handshake_divsi_0.vhd
+
+module {
+  hw.module @test(in %var0 : !handshake.channel<i32>, in %var3 : !handshake.channel<i32>, in %start : !handshake.control<>, in %clk : i1, in %rst : i1, out out0 : !handshake.channel<i32>, out end : !handshake.control<>) {
+    %divsi0.result = hw.instance "divsi0" @handshake_divsi_0(lhs: %var0: !handshake.channel<i32>, rhs: %var3: !handshake.channel<i32>, clk: %clk: i1, rst: %rst: i1) -> (result: !handshake.channel<i32>)
+    hw.output %divsi0.result, %start : !handshake.channel<i32>, !handshake.control<>
+  }
+
+  // CHECK-LABEL: architecture {{.*}} of handshake_divsi_0
+  // CHECK: join_ready <= (not busy) and ((not out_valid) or result_ready);
+  // CHECK: for i in 0 to 4 - 1 loop
+  // CHECK: count <= to_unsigned(7, 3);
+  hw.module.extern @handshake_divsi_0(in %lhs : !handshake.channel<i32>, in %rhs : !handshake.channel<i32>, in %clk : i1, in %rst : i1, out result : !handshake.channel<i32>) attributes {hw.name = "handshake.divsi", hw.parameters = {DATA_TYPE = !handshake.channel<i32>, II = 8 : ui32, LATENCY = 8 : ui32}}
+}
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Analysis/TokenLineage.h"
 #include "dynamatic/Dialect/HW/PortImplementation.h"
 #include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
 #include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
@@ -30,6 +31,7 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -69,18 +71,21 @@ static cl::opt<std::string> kernelName(cl::Positional, cl::Required,
                                        cl::desc("<kernel name>"), cl::init(""),
                                        cl::cat(mainCategory));
 
+static cl::opt<std::string>
+    lineageFile("lineage", cl::Optional,
+                cl::desc("Path to a CSV file in which to write the lineage "
+                         "of all tokens transferred during simulation"),
+                cl::init(""), cl::cat(mainCategory));
+
 namespace {
 
 enum class WireState { UNDEFINED, LOGIC_0, LOGIC_1 };
 
-struct SignalInfo {
+struct SignalInfo : public ChannelEndpoints {
   std::string signalName;
-  std::string srcComponent;
-  unsigned srcPortID;
-  std::string dstComponent;
-  unsigned dstPortID;
 
-  SignalInfo(Value val, StringRef signalName);
+  SignalInfo(Value val, StringRef signalName)
+      : ChannelEndpoints(val), signalName(signalName) {}
 };
 
 struct ChannelState {
@@ -147,33 +152,6 @@ struct WireReference {
 };
 } // namespace
 
-SignalInfo::SignalInfo(Value val, StringRef signalName)
-    : signalName(signalName) {
-  // Derive the source component's name and ID
-  if (auto res = dyn_cast<OpResult>(val)) {
-    Operation *producerOp = res.getOwner();
-    srcPortID = res.getResultNumber();
-    srcComponent = getUniqueName(producerOp);
-  } else {
-    auto arg = cast<BlockArgument>(val);
-    auto funcOp = cast<handshake::FuncOp>(arg.getParentBlock()->getParentOp());
-    srcPortID = arg.getArgNumber();
-    srcComponent = funcOp.getArgName(arg.getArgNumber()).str();
-  }
-
-  // Derive the destination component's name and ID
-  OpOperand &oprd = *val.getUses().begin();
-  Operation *consumerOp = oprd.getOwner();
-  if (!isa<MemRefType>(oprd.get().getType()))
-    dstPortID = oprd.getOperandNumber();
-  if (isa<handshake::EndOp>(consumerOp)) {
-    auto funcOp = cast<handshake::FuncOp>(val.getParentBlock()->getParentOp());
-    dstComponent = funcOp.getResName(oprd.getOperandNumber()).str();
-  } else {
-    dstComponent = getUniqueName(consumerOp);
-  }
-}
-
 std::optional<WireReference>
 WireReference::fromSignal(StringRef signalName,
                           const llvm::StringMap<Value> &ports) {
@@ -325,6 +303,24 @@ int main(int argc, char **argv) {
   std::map<size_t, WireReference> wires;
   mlir::DenseSet<Value> toUpdate;
   size_t cycle = 0;
+
+  // Optionally record the lineage of tokens, sampling channels that are in the
+  // transfer state at the end of each cycle
+  std::optional<TokenLineageRecorder> lineage;
+  if (!lineageFile.empty()) {
+    for (auto funcOp : modOp->getOps<handshake::FuncOp>()) {
+      if (!funcOp.isExternal())
+        lineage.emplace(funcOp);
+    }
+  }
+  SetVector<Value> transferring;
+  auto recordTransfers = [&]() {
+    if (!lineage)
+      return;
+    for (Value val : transferring)
+      lineage->recordTransfer(val, cycle, state.at(val).decodeData());
+  };
+
   unsigned long long period = PERIOD_NS, halfPeriod = period >> 1;
 
   // Read the LOG file line by line
@@ -416,9 +412,13 @@ int main(int argc, char **argv) {
 
         const SignalInfo &info = valueToSignalInfo.at(val);
         llvm::outs() << cycle << ", " << info.srcComponent << ", "
-                     << info.srcPortID << ", " << info.dstComponent << ", "
-                     << info.dstPortID << ", " << dataflowState.str() << ", "
+                     << info.srcPort << ", " << info.dstComponent << ", "
+                     << info.dstPort << ", " << dataflowState.str() << ", "
                      << channelState.decodeData() << "\n";
+        if (dataflowState == TRANSFER)
+          transferring.insert(val);
+        else
+          transferring.remove(val);
       }
       toUpdate.clear();
 
@@ -431,7 +431,9 @@ int main(int argc, char **argv) {
         return error("expected integer identifier for time, but got " +
                      timeStr);
       }
-      cycle = (time < period) ? 0 : (time - halfPeriod) / period + 1;
+      size_t newCycle = (time < period) ? 0 : (time - halfPeriod) / period + 1;
+      for (; cycle < newCycle; ++cycle)
+        recordTransfers();
       return success();
     };
 
@@ -483,5 +485,16 @@ int main(int argc, char **argv) {
     tokens.clear();
   }
 
+  if (lineage) {
+    recordTransfers();
+    std::error_code ec;
+    llvm::raw_fd_ostream lineageStream(lineageFile, ec);
+    if (ec) {
+      llvm::errs() << "Failed to open lineage file @ \"" << lineageFile
+                   << "\": " << ec.message() << "\n";
+      return 1;
+    }
+    lineage->write(lineageStream);
+  }
   return 0;
 }
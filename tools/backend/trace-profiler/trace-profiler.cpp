@@ -0,0 +1,400 @@
+//===- trace-profiler.cpp - Loop and BB profile from traces -----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Builds a cycle-level performance profile of a dataflow circuit from the CSV
+// sequence of channel state changes produced by log2csv. Every cycle is
+// attributed to the basic blocks inside which at least one token is
+// transferred, and the initiation interval achieved by each CFDFC during
+// simulation is compared with the one predicted by buffer placement (stored
+// as attributes on the Handshake function). CFDFCs whose achieved throughput
+// falls below the estimate are flagged.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Analysis/TokenLineage.h"
+#include "dynamatic/Dialect/Handshake/HandshakeAttributes.h"
+#include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
+#include "dynamatic/Dialect/Handshake/HandshakeInterfaces.h"
+#include "dynamatic/Dialect/Handshake/HandshakeOps.h"
+#include "dynamatic/Support/Attribute.h"
+#include "dynamatic/Support/CFG.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Support/LLVM.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+
+static cl::OptionCategory mainCategory("Tool options");
+
+static cl::opt<std::string> handshakeIRFile(cl::Positional, cl::Required,
+                                            cl::desc("<input file>"),
+                                            cl::cat(mainCategory));
+
+static cl::opt<std::string> csvFile(cl::Positional, cl::Required,
+                                   cl::desc("<path to CSV file>"),
+                                   cl::cat(mainCategory));
+
+static cl::opt<double> tolerance(
+    "tolerance", cl::Optional,
+    cl::desc("Relative amount by which a CFDFC's achieved II may exceed the "
+             "II predicted by buffer placement before being flagged"),
+    cl::init(0.05), cl::cat(mainCategory));
+
+static constexpr StringLiteral TRANSFER("transfer");
+
+namespace {
+
+/// Placement-time information on a CFDFC, along with what was measured on the
+/// trace.
+struct CFDFCProfile {
+  /// Basic blocks in the CFDFC.
+  SmallVector<unsigned> bbs;
+  /// Throughput predicted by buffer placement, if any.
+  std::optional<double> predictedThroughput;
+  /// Channels going back to the CFDFC's first block.
+  SmallVector<Value> backedges;
+  /// Channels entering the CFDFC from outside through merge-like operations.
+  SmallVector<Value> entries;
+
+  /// Number of iterations (tokens on the busiest backedge) observed.
+  unsigned iterations = 0;
+  /// Number of times the CFDFC was (re-)entered between iterations.
+  unsigned numEntries = 0;
+  /// Achieved II, averaged over consecutive iterations of the same execution of
+  /// the CFDFC.
+  std::optional<double> achievedII;
+
+  /// Returns the II predicted by buffer placement, if any.
+  std::optional<double> getPredictedII() const {
+    if (!predictedThroughput || *predictedThroughput <= 0.0)
+      return std::nullopt;
+    return 1.0 / *predictedThroughput;
+  }
+
+  /// Whether the achieved II exceeds the prediction by more than the
+  /// tolerance.
+  bool isBelowEstimate() const {
+    std::optional<double> predictedII = getPredictedII();
+    return predictedII && achievedII &&
+           *achievedII > *predictedII * (1.0 + tolerance);
+  }
+};
+
+/// Activity of a basic block during simulation.
+struct BBProfile {
+  /// Number of cycles during which at least one token was transferred on a
+  /// channel produced inside the block.
+  unsigned activeCycles = 0;
+  /// Total number of transfers on channels produced inside the block.
+  unsigned transfers = 0;
+};
+} // namespace
+
+/// Returns the basic block a channel is attributed to, i.e., the one of its
+/// producer or, for function arguments, of its consumer.
+static std::optional<unsigned> getChannelBB(Value channel) {
+  if (Operation *defOp = channel.getDefiningOp())
+    return getLogicBB(defOp);
+  return getLogicBB(*channel.getUsers().begin());
+}
+
+/// Reads the CFDFCs identified by buffer placement, along with their predicted
+/// throughput, from the function's attributes.
+static LogicalResult readCFDFCs(handshake::FuncOp funcOp,
+                                std::map<unsigned, CFDFCProfile> &cfdfcs) {
+  auto bbListAttr = getDialectAttr<handshake::CFDFCToBBListAttr>(funcOp);
+  if (!bbListAttr)
+    return success();
+  for (const NamedAttribute &attr : bbListAttr.getCfdfcMap()) {
+    unsigned idx;
+    if (attr.getName().getValue().getAsInteger(10, idx))
+      return funcOp.emitError() << "invalid CFDFC index " << attr.getName();
+    CFDFCProfile &cfdfc = cfdfcs[idx];
+    for (Attribute bb : cast<ArrayAttr>(attr.getValue()))
+      cfdfc.bbs.push_back(cast<IntegerAttr>(bb).getUInt());
+  }
+
+  auto throughputAttr = getDialectAttr<handshake::CFDFCThroughputAttr>(funcOp);
+  if (!throughputAttr)
+    return success();
+  for (const NamedAttribute &attr : throughputAttr.getThroughputMap()) {
+    unsigned idx;
+    if (attr.getName().getValue().getAsInteger(10, idx))
+      return funcOp.emitError() << "invalid CFDFC index " << attr.getName();
+    auto cfdfcIt = cfdfcs.find(idx);
+    if (cfdfcIt != cfdfcs.end()) {
+      cfdfcIt->second.predictedThroughput =
+          cast<FloatAttr>(attr.getValue()).getValueAsDouble();
+    }
+  }
+  return success();
+}
+
+/// Classifies the channels crossing the boundaries of each CFDFC.
+static void findCFDFCChannels(ArrayRef<Value> channels,
+                              std::map<unsigned, CFDFCProfile> &cfdfcs) {
+  for (Value channel : channels) {
+    BBEndpoints ends;
+    if (!getBBEndpoints(channel, ends))
+      continue;
+    bool backedge = isBackedge(channel);
+    Operation *user = *channel.getUsers().begin();
+    for (auto &[_, cfdfc] : cfdfcs) {
+      bool srcIn = llvm::is_contained(cfdfc.bbs, ends.srcBB);
+      bool dstIn = llvm::is_contained(cfdfc.bbs, ends.dstBB);
+      if (srcIn && dstIn && backedge)
+        cfdfc.backedges.push_back(channel);
+      else if (!srcIn && dstIn && isa<handshake::MergeLikeOpInterface>(user))
+        cfdfc.entries.push_back(channel);
+    }
+  }
+}
+
+/// Measures the II achieved by the CFDFC from the cycles at which tokens were
+/// transferred on its channels. Gaps between consecutive iterations during
+/// which a token entered the CFDFC from outside separate distinct executions
+/// of the CFDFC and are not counted.
+static void measureII(CFDFCProfile &cfdfc,
+                      const DenseMap<Value, std::vector<unsigned>> &transfers) {
+  auto getTransfers = [&](Value channel) -> ArrayRef<unsigned> {
+    if (auto it = transfers.find(channel); it != transfers.end())
+      return it->second;
+    return {};
+  };
+
+  // Iterations are counted on the busiest backedge
+  ArrayRef<unsigned> iterations;
+  for (Value backedge : cfdfc.backedges) {
+    ArrayRef<unsigned> cycles = getTransfers(backedge);
+    if (cycles.size() > iterations.size())
+      iterations = cycles;
+  }
+  cfdfc.iterations = iterations.size();
+
+  std::vector<unsigned> entryCycles;
+  for (Value entry : cfdfc.entries)
+    llvm::append_range(entryCycles, getTransfers(entry));
+  llvm::sort(entryCycles);
+
+  unsigned totalGap = 0, numGaps = 0;
+  for (size_t i = 1; i < iterations.size(); ++i) {
+    unsigned prev = iterations[i - 1], next = iterations[i];
+    const auto *entryIt = llvm::upper_bound(entryCycles, prev);
+    if (entryIt != entryCycles.end() && *entryIt <= next) {
+      ++cfdfc.numEntries;
+      continue;
+    }
+    totalGap += next - prev;
+    ++numGaps;
+  }
+  if (numGaps)
+    cfdfc.achievedII = (double)totalGap / numGaps;
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Builds a cycle-level loop and basic block performance profile from the "
+      "CSV\nproduced by log2csv, and compares the II achieved by each CFDFC "
+      "with the one\npredicted by buffer placement.");
+
+  auto fileOrErr = MemoryBuffer::getFileOrSTDIN(handshakeIRFile.c_str());
+  if (std::error_code error = fileOrErr.getError()) {
+    llvm::errs() << argv[0] << ": could not open input file '"
+                 << handshakeIRFile << "': " << error.message() << "\n";
+    return 1;
+  }
+
+  MLIRContext context;
+  context.loadDialect<memref::MemRefDialect, arith::ArithDialect,
+                      handshake::HandshakeDialect, math::MathDialect>();
+
+  // Load the MLIR module
+  SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(std::move(*fileOrErr), SMLoc());
+  mlir::OwningOpRef<mlir::ModuleOp> modOp(
+      mlir::parseSourceFile<ModuleOp>(sourceMgr, &context));
+  if (!modOp)
+    return 1;
+
+  handshake::FuncOp funcOp = nullptr;
+  for (auto op : modOp->getOps<handshake::FuncOp>()) {
+    if (op.isExternal())
+      continue;
+    if (funcOp) {
+      modOp->emitError() << "we currently only support one non-external "
+                            "handshake function per module";
+      return 1;
+    }
+    funcOp = op;
+  }
+  if (!funcOp) {
+    modOp->emitError() << "No Handshake function in input module";
+    return 1;
+  }
+  if (!NameAnalysis(funcOp).areAllOpsNamed()) {
+    funcOp.emitError() << "Not all operations in the function have names, "
+                          "this is a requirement";
+    return 1;
+  }
+
+  // Identify channels by their endpoints, as in the CSV
+  SmallVector<Value> channels;
+  for (BlockArgument arg : funcOp.getArguments())
+    channels.push_back(arg);
+  for (Operation &op : funcOp.getOps())
+    llvm::append_range(channels, op.getResults());
+  llvm::erase_if(channels, [](Value channel) {
+    return isa<MemRefType>(channel.getType()) || !channel.hasOneUse();
+  });
+  llvm::StringMap<Value> channelsByName;
+  for (Value channel : channels) {
+    ChannelEndpoints ends(channel);
+    channelsByName[ends.srcComponent + ":" + std::to_string(ends.srcPort)] =
+        channel;
+  }
+
+  // Replay the sequence of state changes to find the cycles at which each
+  // channel transfers a token
+  auto csvOrErr = MemoryBuffer::getFile(csvFile);
+  if (std::error_code error = csvOrErr.getError()) {
+    llvm::errs() << "Failed to open CSV file @ \"" << csvFile
+                 << "\": " << error.message() << "\n";
+    return 1;
+  }
+  SmallVector<StringRef> lines;
+  (*csvOrErr)->getBuffer().split(lines, '\n', -1, false);
+
+  DenseMap<Value, std::vector<unsigned>> transfers;
+  SetVector<Value> transferring;
+  std::map<unsigned, BBProfile> bbs;
+  unsigned cycle = 0, numIdleCycles = 0;
+  auto endCycle = [&]() {
+    if (transferring.empty())
+      ++numIdleCycles;
+    SmallVector<unsigned> activeBBs;
+    for (Value channel : transferring) {
+      transfers[channel].push_back(cycle);
+      if (std::optional<unsigned> bb = getChannelBB(channel)) {
+        ++bbs[*bb].transfers;
+        if (!llvm::is_contained(activeBBs, *bb))
+          activeBBs.push_back(*bb);
+      }
+    }
+    for (unsigned bb : activeBBs)
+      ++bbs[bb].activeCycles;
+  };
+
+  for (auto [lineIdx, line] : llvm::enumerate(lines)) {
+    // Skip the header
+    if (lineIdx == 0)
+      continue;
+    SmallVector<StringRef> fields;
+    line.split(fields, ',');
+    if (fields.size() < 6) {
+      llvm::errs() << csvFile << ":" << lineIdx + 1
+                   << ": expected at least 6 fields\n";
+      return 1;
+    }
+    unsigned lineCycle;
+    if (fields[0].trim().getAsInteger(10, lineCycle)) {
+      llvm::errs() << csvFile << ":" << lineIdx + 1
+                   << ": expected integer cycle\n";
+      return 1;
+    }
+    for (; cycle < lineCycle; ++cycle)
+      endCycle();
+
+    std::string name = (fields[1].trim() + ":" + fields[2].trim()).str();
+    Value channel = channelsByName.lookup(name);
+    if (!channel) {
+      llvm::errs() << csvFile << ":" << lineIdx + 1 << ": unknown channel "
+                   << name << "\n";
+      return 1;
+    }
+    if (fields[5].trim() == TRANSFER)
+      transferring.insert(channel);
+    else
+      transferring.remove(channel);
+  }
+  endCycle();
+  unsigned numCycles = cycle + 1;
+
+  std::map<unsigned, CFDFCProfile> cfdfcs;
+  if (failed(readCFDFCs(funcOp, cfdfcs)))
+    return 1;
+  findCFDFCChannels(channels, cfdfcs);
+  for (auto &[_, cfdfc] : cfdfcs)
+    measureII(cfdfc, transfers);
+
+  // Print the report
+  raw_ostream &os = llvm::outs();
+  os << "Total cycles: " << numCycles << "\n\nBasic blocks (cycles during "
+     << "which a token is transferred inside the block):\n";
+  for (auto &[bb, profile] : bbs) {
+    os << "  BB " << bb << ": " << profile.activeCycles << " cycles ("
+       << llvm::format("%.1f", 100.0 * profile.activeCycles / numCycles)
+       << "%), " << profile.transfers << " transfers\n";
+  }
+  os << "  Cycles without any transfer: " << numIdleCycles << "\n";
+
+  os << "\nCFDFCs:\n";
+  if (cfdfcs.empty())
+    os << "  No CFDFC information in the input IR\n";
+  unsigned numFlagged = 0;
+  for (auto &[idx, cfdfc] : cfdfcs) {
+    os << "  CFDFC " << idx << " (BBs ";
+    llvm::interleave(cfdfc.bbs, os, " ");
+    os << "): " << cfdfc.iterations << " iterations over "
+       << cfdfc.numEntries + (cfdfc.iterations ? 1 : 0) << " execution(s)";
+    os << ", achieved II ";
+    if (cfdfc.achievedII)
+      os << llvm::format("%.2f", *cfdfc.achievedII);
+    else
+      os << "unknown";
+    os << ", predicted II ";
+    if (std::optional<double> predictedII = cfdfc.getPredictedII())
+      os << llvm::format("%.2f", *predictedII);
+    else
+      os << "unknown";
+    if (cfdfc.isBelowEstimate()) {
+      os << " [BELOW ESTIMATE]";
+      ++numFlagged;
+    }
+    os << "\n";
+  }
+  if (numFlagged) {
+    os << "\n"
+       << numFlagged << " CFDFC(s) achieved a lower throughput than estimated "
+       << "by buffer placement\n";
+  }
+  return 0;
+}
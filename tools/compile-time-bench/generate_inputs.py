@@ -0,0 +1,424 @@
+"""
+This script generates large parametric inputs to measure how Dynamatic's
+compilation time scales with the size of the circuit. Inputs are generated
+directly at the CF level (i.e., what the frontend feeds to
+--lower-cf-to-handshake) or at the Handshake level, so that no part of the C
+frontend is involved in the measurements.
+
+Each input family is parameterized by a single size. Next to each input, the
+script writes the basic block transition frequencies that the buffer placement
+pass expects, in the same CSV format as the CF-level profiler.
+"""
+
+import argparse
+import os
+import sys
+
+# Largest number of transitions that the buffer placement pass can parse
+MAX_TRANSITIONS = 2**31 - 1
+
+
+class CFEmitter:
+    """
+    Emits the body of a CF-level function made up of numbered basic blocks and
+    records the number of transitions between them.
+    """
+
+    def __init__(self):
+        self.lines = []
+        self.num_values = 0
+        self.num_ops = 0
+        self.arcs = {}
+
+    def value(self):
+        """
+        Returns a fresh SSA value name.
+        """
+        name = f"%v{self.num_values}"
+        self.num_values += 1
+        return name
+
+    def op(self, rhs):
+        """
+        Emits an operation with a single result and returns the result's name.
+        """
+        res = self.value()
+        self.lines.append(f"    {res} = {rhs}")
+        self.num_ops += 1
+        return res
+
+    def stmt(self, text):
+        """
+        Emits an operation without results.
+        """
+        self.lines.append(f"    {text}")
+        self.num_ops += 1
+
+    def const(self, value, type):
+        """
+        Emits a constant of the given type and returns its name.
+        """
+        return self.op(f"arith.constant {value} : {type}")
+
+    def block(self, idx, args=None):
+        """
+        Starts a new basic block with the given arguments, given as a list of
+        (name, type) pairs.
+        """
+        args_str = ""
+        if args:
+            args_str = "(" + ", ".join(f"{n}: {t}" for n, t in args) + ")"
+        self.lines.append(f"  ^bb{idx}{args_str}:")
+
+    def arc(self, src, dst, transitions):
+        """
+        Records the number of transitions between two basic blocks.
+        """
+        transitions = max(1, min(transitions, MAX_TRANSITIONS))
+        self.arcs[(src, dst)] = transitions
+
+    def frequencies(self):
+        """
+        Returns the recorded transitions in the profiler's CSV format.
+        """
+        csv = "srcBlock,dstBlock,numTransitions,is_backedge\n"
+        for (src, dst), transitions in sorted(self.arcs.items()):
+            csv += f"{src},{dst},{transitions},{int(dst <= src)}\n"
+        return csv
+
+    def function(self, name, args):
+        """
+        Returns the textual function made up of all emitted blocks.
+        """
+        args_str = ", ".join(f"{n}: {t}" for n, t in args)
+        body = "\n".join(self.lines)
+        return f"module {{\n  func.func @{name}({args_str}) {{\n{body}\n  }}\n}}\n"
+
+
+def mem_attr():
+    return "{handshake.mem_interface = #handshake.mem_interface<MC>}"
+
+
+def load(em, mem, idx, size):
+    return em.op(f"memref.load {mem}[{idx}] {mem_attr()} : memref<{size}xi32>")
+
+
+def store(em, val, mem, idx, size):
+    em.stmt(f"memref.store {val}, {mem}[{idx}] {mem_attr()} : memref<{size}xi32>")
+
+
+def loop_latch(em, iv, trip_count, header, exit):
+    """
+    Increments the induction variable and branches back to the loop header
+    while it is lower than the trip count.
+    """
+    one = em.const(1, "index")
+    bound = em.const(trip_count, "index")
+    next_iv = em.op(f"arith.addi {iv}, {one} : index")
+    cond = em.op(f"arith.cmpi ult, {next_iv}, {bound} : index")
+    em.stmt(f"cf.cond_br {cond}, ^bb{header}({next_iv} : index), ^bb{exit}")
+
+
+def gen_loop_nest(name, size, trip_count):
+    """
+    Perfect loop nest of depth `size` whose innermost loop copies an array.
+    Block 0 is the entry, blocks 1 to `size` are the loop headers (the last
+    one being the innermost loop's body), then come the latches of all outer
+    loops from the innermost to the outermost one, and finally the exit.
+    """
+    em = CFEmitter()
+    depth = size
+    exit = 2 * depth
+    # Number of times each loop header executes
+    execs = [trip_count**k for k in range(depth + 1)]
+
+    def latch_idx(level):
+        return depth + (depth - level) if level > 0 else exit
+
+    zero = em.const(0, "index")
+    em.stmt(f"cf.br ^bb1({zero} : index)")
+    em.arc(0, 1, 1)
+
+    ivs = [None]
+    for level in range(1, depth + 1):
+        iv = em.value()
+        ivs.append(iv)
+        em.block(level, [(iv, "index")])
+        if level < depth:
+            zero = em.const(0, "index")
+            em.stmt(f"cf.br ^bb{level + 1}({zero} : index)")
+            em.arc(level, level + 1, execs[level])
+            continue
+        x = load(em, "%in", iv, trip_count)
+        one = em.const(1, "i32")
+        y = em.op(f"arith.addi {x}, {one} : i32")
+        store(em, y, "%out", iv, trip_count)
+        loop_latch(em, iv, trip_count, level, latch_idx(level - 1))
+        em.arc(level, level, execs[level] - execs[level - 1])
+        em.arc(level, latch_idx(level - 1), execs[level - 1])
+
+    for level in range(depth - 1, 0, -1):
+        em.block(latch_idx(level))
+        loop_latch(em, ivs[level], trip_count, level, latch_idx(level - 1))
+        em.arc(latch_idx(level), level, execs[level] - execs[level - 1])
+        em.arc(latch_idx(level), latch_idx(level - 1), execs[level - 1])
+
+    em.block(exit)
+    em.stmt("return")
+    args = [("%in", f"memref<{trip_count}xi32>"),
+            ("%out", f"memref<{trip_count}xi32>")]
+    return em.function(name, args), em.frequencies(), em.num_ops
+
+
+def gen_unrolled_body(name, size, trip_count):
+    """
+    Single loop whose body is unrolled `size` times, each copy loading from
+    and storing to a different port of the same two memories.
+    """
+    em = CFEmitter()
+    mem_size = trip_count * size
+    zero = em.const(0, "index")
+    em.stmt(f"cf.br ^bb1({zero} : index)")
+    em.arc(0, 1, 1)
+
+    iv = em.value()
+    em.block(1, [(iv, "index")])
+    width = em.const(size, "index")
+    base = em.op(f"arith.muli {iv}, {width} : index")
+    for lane in range(size):
+        offset = em.const(lane, "index")
+        idx = em.op(f"arith.addi {base}, {offset} : index")
+        x = load(em, "%in", idx, mem_size)
+        factor = em.const(lane + 1, "i32")
+        y = em.op(f"arith.muli {x}, {factor} : i32")
+        z = em.op(f"arith.addi {y}, {x} : i32")
+        store(em, z, "%out", idx, mem_size)
+    loop_latch(em, iv, trip_count, 1, 2)
+    em.arc(1, 1, trip_count - 1)
+    em.arc(1, 2, 1)
+
+    em.block(2)
+    em.stmt("return")
+    args = [("%in", f"memref<{mem_size}xi32>"),
+            ("%out", f"memref<{mem_size}xi32>")]
+    return em.function(name, args), em.frequencies(), em.num_ops
+
+
+def gen_memory_ports(name, size, trip_count):
+    """
+    Single loop updating `size` distinct memories, each of which gets its own
+    memory interface with a load and a store port.
+    """
+    em = CFEmitter()
+    zero = em.const(0, "index")
+    em.stmt(f"cf.br ^bb1({zero} : index)")
+    em.arc(0, 1, 1)
+
+    iv = em.value()
+    em.block(1, [(iv, "index")])
+    for mem in range(size):
+        x = load(em, f"%mem{mem}", iv, trip_count)
+        inc = em.const(mem + 1, "i32")
+        y = em.op(f"arith.addi {x}, {inc} : i32")
+        store(em, y, f"%mem{mem}", iv, trip_count)
+    loop_latch(em, iv, trip_count, 1, 2)
+    em.arc(1, 1, trip_count - 1)
+    em.arc(1, 2, 1)
+
+    em.block(2)
+    em.stmt("return")
+    args = [(f"%mem{mem}", f"memref<{trip_count}xi32>") for mem in range(size)]
+    return em.function(name, args), em.frequencies(), em.num_ops
+
+
+def gen_large_cfg(name, size, trip_count):
+    """
+    Single loop whose body is a chain of `size` if-then-else diamonds, each
+    branching on a different bit of the loaded value. Block 1 is the loop
+    header, diamond d is made up of blocks 2 + 3d (then), 3 + 3d (else), and
+    4 + 3d (join), and the last block is the exit.
+    """
+    em = CFEmitter()
+    exit = 2 + 3 * size
+    taken = trip_count // 2
+    zero = em.const(0, "index")
+    em.stmt(f"cf.br ^bb1({zero} : index)")
+    em.arc(0, 1, 1)
+
+    iv = em.value()
+    em.block(1, [(iv, "index")])
+    x = load(em, "%in", iv, trip_count)
+    pred = 1
+    for d in range(size):
+        then_bb, else_bb, join_bb = 2 + 3 * d, 3 + 3 * d, 4 + 3 * d
+        mask = em.const(1 << (d % 31), "i32")
+        bit = em.op(f"arith.andi {x}, {mask} : i32")
+        zero = em.const(0, "i32")
+        cond = em.op(f"arith.cmpi ne, {bit}, {zero} : i32")
+        em.stmt(f"cf.cond_br {cond}, ^bb{then_bb}, ^bb{else_bb}")
+        em.arc(pred, then_bb, taken)
+        em.arc(pred, else_bb, trip_count - taken)
+
+        for bb, arith_op in ((then_bb, "addi"), (else_bb, "subi")):
+            em.block(bb)
+            cst = em.const(d + 1, "i32")
+            y = em.op(f"arith.{arith_op} {x}, {cst} : i32")
+            em.stmt(f"cf.br ^bb{join_bb}({y} : i32)")
+        em.arc(then_bb, join_bb, taken)
+        em.arc(else_bb, join_bb, trip_count - taken)
+
+        x = em.value()
+        em.block(join_bb, [(x, "i32")])
+        pred = join_bb
+
+    store(em, x, "%out", iv, trip_count)
+    loop_latch(em, iv, trip_count, 1, exit)
+    em.arc(pred, 1, trip_count - 1)
+    em.arc(pred, exit, 1)
+
+    em.block(exit)
+    em.stmt("return")
+    args = [("%in", f"memref<{trip_count}xi32>"),
+            ("%out", f"memref<{trip_count}xi32>")]
+    return em.function(name, args), em.frequencies(), em.num_ops
+
+
+def gen_dataflow(name, size, chain_length):
+    """
+    Handshake-level function made up of `size` independent chains of
+    arithmetic operations, each `chain_length` long, whose results are summed
+    by a balanced adder tree. The function has a single basic block.
+    """
+    lines = []
+    num_ops = 0
+    num_values = 0
+    bb = "{handshake.bb = 0 : ui32}"
+
+    def op(rhs):
+        nonlocal num_ops, num_values
+        res = f"%v{num_values}"
+        num_values += 1
+        num_ops += 1
+        lines.append(f"    {res} = {rhs}")
+        return res
+
+    arith_ops = ["addi", "muli", "xori", "subi"]
+    values = []
+    for chain in range(size):
+        x = f"%in{chain}"
+        for k in range(chain_length):
+            src = op(f"source {bb} : <>")
+            cst = op(f"constant {src} {{handshake.bb = 0 : ui32, value = "
+                     f"{k + 1} : i32}} : <>, <i32>")
+            x = op(f"{arith_ops[k % len(arith_ops)]} {x}, {cst} {bb} : <i32>")
+        values.append(x)
+
+    while len(values) > 1:
+        reduced = []
+        for i in range(0, len(values) - 1, 2):
+            reduced.append(op(f"addi {values[i]}, {values[i + 1]} {bb} : <i32>"))
+        if len(values) % 2:
+            reduced.append(values[-1])
+        values = reduced
+
+    lines.append(f"    end {bb} {values[0]}, %start : <i32>, <>")
+    num_ops += 1
+
+    args = [f"%in{chain}: !handshake.channel<i32>" for chain in range(size)]
+    args.append("%start: !handshake.control<>")
+    body = "\n".join(lines)
+    func = (f"module {{\n  handshake.func @{name}({', '.join(args)}) -> "
+            f"(!handshake.channel<i32>, !handshake.control<>) {{\n{body}\n  }}\n}}\n")
+    # The function has a single basic block, so there are no transitions
+    freqs = "srcBlock,dstBlock,numTransitions,is_backedge\n"
+    return func, freqs, num_ops
+
+
+def gen_untagged_chain(name, size, _):
+    """
+    Handshake-level function made up of a single chain of `size` forks fed by
+    a source, in which only the function's terminator belongs to a basic
+    block. Basic block inference can only tag the chain's operations one at a
+    time, from the terminator backwards, i.e., in reverse program order.
+    """
+    lines = ["    %v0 = source : <>"]
+    for k in range(size):
+        lines.append(f"    %v{k + 1} = fork [1] %v{k} : <>")
+    lines.append(f"    end {{handshake.bb = 0 : ui32}} %v{size} : <>")
+    num_ops = size + 2
+
+    body = "\n".join(lines)
+    func = (f"module {{\n  handshake.func @{name}(%start: !handshake.control<>) "
+            f"-> !handshake.control<> {{\n{body}\n  }}\n}}\n")
+    freqs = "srcBlock,dstBlock,numTransitions,is_backedge\n"
+    return func, freqs, num_ops
+
+
+# Maps each input family to its abstraction level, generator, the meaning of
+# its size parameter, and the value of the generator's last parameter
+FAMILIES = {
+    "loop_nest": ("cf", gen_loop_nest, "loop depth", 2),
+    "unrolled_body": ("cf", gen_unrolled_body, "unroll factor", 16),
+    "memory_ports": ("cf", gen_memory_ports, "number of memories", 16),
+    "large_cfg": ("cf", gen_large_cfg, "number of if-then-else", 16),
+    "dataflow": ("handshake", gen_dataflow, "number of chains", 8),
+    "untagged_chain": ("untagged", gen_untagged_chain, "chain length", None),
+}
+
+
+def generate(family, size, out_dir):
+    """
+    Generates an input of the given family and size inside the output
+    directory.
+
+    Returns: Dictionary describing the generated input, with its abstraction
+    level, the path to the input and frequencies files, and its number of
+    operations.
+    """
+    level, gen, _, param = FAMILIES[family]
+    name = f"{family}_{size}"
+    text, freqs, num_ops = gen(name, size, param)
+
+    os.makedirs(out_dir, exist_ok=True)
+    input_path = os.path.join(out_dir, f"{name}.mlir")
+    freqs_path = os.path.join(out_dir, f"{name}_frequencies.csv")
+    with open(input_path, "w") as f:
+        f.write(text)
+    with open(freqs_path, "w") as f:
+        f.write(freqs)
+
+    return {
+        "family": family,
+        "size": size,
+        "level": level,
+        "input": input_path,
+        "frequencies": freqs_path,
+        "num_ops": num_ops,
+    }
+
+
+def main():
+    """
+    Entry point.
+    """
+    parser = argparse.ArgumentParser(
+        description="Generates parametric inputs for compile-time benchmarks.")
+    parser.add_argument("family", choices=sorted(FAMILIES.keys()),
+                        help="Family of the generated input.")
+    parser.add_argument("sizes", type=int, nargs="+",
+                        help="Sizes of the generated inputs.")
+    parser.add_argument("-o", "--out-dir", type=str, default=".",
+                        help="Directory in which to write the inputs.")
+    args = parser.parse_args()
+
+    for size in args.sizes:
+        if size < 1:
+            print(f"Error: size must be strictly positive, got {size}",
+                  file=sys.stderr)
+            sys.exit(1)
+        desc = generate(args.family, size, args.out_dir)
+        print(f"{desc['input']} ({desc['num_ops']} operations)")
+
+
+if __name__ == "__main__":
+    main()
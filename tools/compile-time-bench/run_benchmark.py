@@ -0,0 +1,376 @@
+"""
+This script measures how the compilation time of Dynamatic's passes scales
+with the size of the circuit being compiled. It generates inputs of increasing
+sizes from each family defined in generate_inputs.py, compiles them down to
+the HW level with dynamatic-opt, and records the time spent in each pass as
+well as in the buffer placement MILPs.
+
+Results are written as JSON. For each family and each pass, the script also
+fits the growth of the pass's execution time with the number of operations in
+the input (time ~ num_ops^exponent) and flags passes whose exponent exceeds a
+threshold as superlinear.
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+from generate_inputs import FAMILIES, generate
+
+DYNAMATIC_ROOT = Path(__file__).parent.parent.parent
+
+# Version of the results' format, to be incremented on incompatible changes
+FORMAT_VERSION = 1
+
+DEFAULT_SIZES = {
+    "loop_nest": [2, 4, 8, 16],
+    "unrolled_body": [8, 16, 32, 64],
+    "memory_ports": [4, 8, 16, 32],
+    "large_cfg": [8, 16, 32, 64],
+    "dataflow": [16, 32, 64, 128],
+    "untagged_chain": [4000, 8000, 16000, 32000],
+}
+
+# Name of the statistics reported by the buffer placement pass
+MILP_STATISTICS = {
+    "CFDFC extraction time (ms)": "cfdfc_extraction",
+    "Buffer placement MILP time (ms)": "buffer_placement_milp",
+}
+
+
+class CLIHandler:
+    """
+    This class parses the script's command line arguments.
+    """
+
+    def __init__(self):
+        self.parser = argparse.ArgumentParser()
+        self.add_arguments()
+
+    def add_arguments(self):
+        """
+        Configures all available command line arguments.
+        """
+        self.parser.add_argument(
+            "-f",
+            "--families",
+            nargs="+",
+            choices=sorted(FAMILIES.keys()),
+            default=sorted(FAMILIES.keys()),
+            help="Input families to benchmark (default: all).",
+        )
+        self.parser.add_argument(
+            "-s",
+            "--sizes",
+            nargs="+",
+            type=int,
+            default=None,
+            help="Input sizes to benchmark for all families, overriding the "
+            "default sizes of each family.",
+        )
+        self.parser.add_argument(
+            "-o",
+            "--output",
+            type=str,
+            default="compile-time-results.json",
+            help="Path to which the JSON results should be written.",
+        )
+        self.parser.add_argument(
+            "-w",
+            "--work-dir",
+            type=str,
+            default="compile-time-bench",
+            help="Directory in which generated inputs and outputs are stored.",
+        )
+        self.parser.add_argument(
+            "--dynamatic-opt",
+            type=str,
+            default=str(DYNAMATIC_ROOT / "bin" / "dynamatic-opt"),
+            help="Path to the dynamatic-opt binary.",
+        )
+        self.parser.add_argument(
+            "--buffer-algorithm",
+            type=str,
+            default="fpga20",
+            help="Buffer placement algorithm (default: fpga20). Use "
+            "'on-merges' when no MILP solver is available.",
+        )
+        self.parser.add_argument(
+            "--milp-solver",
+            type=str,
+            default="gurobi",
+            help="MILP solver used for buffer placement (default: gurobi).",
+        )
+        self.parser.add_argument(
+            "--target-period",
+            type=float,
+            default=4.0,
+            help="Target clock period, in ns (default: 4).",
+        )
+        self.parser.add_argument(
+            "--timeout",
+            type=int,
+            default=180,
+            help="Timeout of each buffer placement MILP, in seconds "
+            "(default: 180).",
+        )
+        self.parser.add_argument(
+            "--threshold",
+            type=float,
+            default=1.2,
+            help="Growth exponent above which a pass is flagged as "
+            "superlinear (default: 1.2).",
+        )
+        self.parser.add_argument(
+            "--min-time",
+            type=float,
+            default=0.01,
+            help="Execution times below this value, in seconds, are considered "
+            "noise and ignored when fitting growth (default: 0.01).",
+        )
+        self.parser.add_argument(
+            "--fail-on-superlinear",
+            action="store_true",
+            help="Return a non-zero exit code if any pass is flagged as "
+            "superlinear.",
+        )
+
+    def parse_args(self, args=None):
+        """
+        Parses the command-line arguments.
+
+        Arguments:
+        `args` -- List of arguments to parse (default: sys.argv)
+
+        Returns: Parsed arguments namespace
+        """
+        return self.parser.parse_args(args)
+
+
+def get_pipeline(args, level, freqs_path):
+    """
+    Returns the dynamatic-opt passes compiling an input of the given level
+    down to the HW level, mirroring the default compilation flow. Inputs whose
+    operations do not belong to basic blocks only go through basic block
+    inference.
+    """
+    timing_models = DYNAMATIC_ROOT / "data" / "components.json"
+    if level == "untagged":
+        # Inputs without basic blocks only measure basic block inference
+        return ["--handshake-infer-basic-blocks"]
+    passes = []
+    if level == "cf":
+        passes += [
+            "--lower-cf-to-handshake",
+            "--handshake-deactivate-mem-dependencies",
+            "--handshake-replace-memory-interfaces",
+            "--handshake-remove-unused-memrefs",
+        ]
+    passes += [
+        "--handshake-optimize-bitwidths",
+        "--handshake-materialize",
+        "--handshake-infer-basic-blocks",
+        f"--handshake-set-unit-impl-attr=target-period={args.target_period} "
+        f"timing-models={timing_models}",
+        "--handshake-set-buffering-properties=version=fpga20",
+        f"--handshake-place-buffers=algorithm={args.buffer_algorithm} "
+        f"solver={args.milp_solver} frequencies={freqs_path} "
+        f"timing-models={timing_models} target-period={args.target_period} "
+        f"timeout={args.timeout}",
+        "--handshake-materialize",
+        "--handshake-canonicalize",
+        "--handshake-hoist-ext-instances",
+        "--lower-handshake-to-hw",
+    ]
+    return passes
+
+
+def parse_timing(report):
+    """
+    Parses MLIR's execution time report, in list display mode and with
+    threading disabled.
+
+    Returns: Dictionary mapping each timer name to its wall time in seconds.
+    """
+    timers = {}
+    for line in report.splitlines():
+        match = re.match(r"^\s+(\d+\.\d+)\s+\(\s*\d+\.\d+%\)\s+(.+?)\s*$", line)
+        if match:
+            timers[match.group(2)] = float(match.group(1))
+    return timers
+
+
+def parse_statistics(report):
+    """
+    Parses MLIR's pass statistics report, in list display mode.
+
+    Returns: Dictionary mapping each pass name to a dictionary mapping each of
+    its statistics to its value.
+    """
+    stats = {}
+    curr_pass = None
+    for line in report.splitlines():
+        match = re.match(r"^\s+\(S\)\s+(\d+)\s+(.+?)\s+-\s+", line)
+        if match and curr_pass:
+            stats[curr_pass][match.group(2)] = int(match.group(1))
+        elif line and not line[0].isspace() and not line.startswith("="):
+            curr_pass = line.strip()
+            stats[curr_pass] = {}
+    return {name: values for name, values in stats.items() if values}
+
+
+def run_one(args, family, size):
+    """
+    Generates and compiles a single input, timing all passes.
+
+    Returns: Dictionary describing the results for this input.
+    """
+    out_dir = os.path.join(args.work_dir, family)
+    desc = generate(family, size, out_dir)
+    output = os.path.join(out_dir, f"{family}_{size}_hw.mlir")
+    cmd = [
+        args.dynamatic_opt,
+        os.path.abspath(desc["input"]),
+        *get_pipeline(args, desc["level"], os.path.abspath(desc["frequencies"])),
+        "--mlir-timing",
+        "--mlir-timing-display=list",
+        "--mlir-disable-threading",
+        "--mlir-pass-statistics",
+        "--mlir-pass-statistics-display=list",
+        "-o",
+        os.path.abspath(output),
+    ]
+
+    result = {
+        "family": family,
+        "size": size,
+        "level": desc["level"],
+        "num_ops": desc["num_ops"],
+    }
+    # The buffer placement pass may create solver logs in the current
+    # directory, so run from the output directory
+    proc = subprocess.run(cmd, cwd=out_dir, capture_output=True, text=True)
+    if proc.returncode != 0:
+        result["status"] = "failed"
+        result["error"] = proc.stderr.strip().splitlines()[-20:]
+        return result
+
+    timers = parse_timing(proc.stderr)
+    total = timers.pop("Total", None)
+    stats = parse_statistics(proc.stderr)
+    result["status"] = "ok"
+    result["total_time"] = total
+    result["pass_times"] = timers
+    result["statistics"] = stats
+    for values in stats.values():
+        for name, key in MILP_STATISTICS.items():
+            if name in values:
+                result["pass_times"][key] = values[name] / 1000.0
+    return result
+
+
+def fit_growth(points, min_time):
+    """
+    Fits time = a * num_ops^exponent on the points above the noise floor using
+    least squares in log-log space.
+
+    Returns: The exponent, or None if there are less than 3 usable points.
+    """
+    points = [(x, t) for x, t in points if t is not None and t >= min_time]
+    if len(points) < 3:
+        return None
+    xs = [math.log(x) for x, _ in points]
+    ys = [math.log(t) for _, t in points]
+    mean_x = sum(xs) / len(xs)
+    mean_y = sum(ys) / len(ys)
+    var_x = sum((x - mean_x)**2 for x in xs)
+    if var_x == 0:
+        return None
+    cov = sum((x - mean_x) * (y - mean_y) for x, y in zip(xs, ys))
+    return cov / var_x
+
+
+def analyze_growth(results, args):
+    """
+    Fits the growth of the total time and of each pass's time for each family.
+
+    Returns: List of dictionaries describing each fit.
+    """
+    growth = []
+    for family in args.families:
+        runs = [r for r in results if r["family"] == family and
+                r["status"] == "ok"]
+        metrics = {"Total"}
+        for run in runs:
+            metrics.update(run["pass_times"].keys())
+        for metric in sorted(metrics):
+            points = []
+            for run in runs:
+                t = run["total_time"] if metric == "Total" else \
+                    run["pass_times"].get(metric)
+                points.append((run["num_ops"], t))
+            exponent = fit_growth(points, args.min_time)
+            if exponent is None:
+                continue
+            growth.append({
+                "family": family,
+                "metric": metric,
+                "exponent": round(exponent, 3),
+                "superlinear": exponent > args.threshold,
+            })
+    return growth
+
+
+def main():
+    """
+    Entry point.
+    """
+    cli = CLIHandler()
+    args = cli.parse_args()
+
+    results = []
+    for family in args.families:
+        sizes = args.sizes or DEFAULT_SIZES[family]
+        for size in sorted(sizes):
+            print(f"Compiling {family} with size {size}...", flush=True)
+            result = run_one(args, family, size)
+            if result["status"] != "ok":
+                print(f"Error: failed to compile {family} with size {size}",
+                      file=sys.stderr)
+            else:
+                print(f"  {result['num_ops']} operations, "
+                      f"{result['total_time']:.3f}s")
+            results.append(result)
+
+    growth = analyze_growth(results, args)
+    with open(args.output, "w") as f:
+        json.dump({
+            "format_version": FORMAT_VERSION,
+            "config": {
+                "buffer_algorithm": args.buffer_algorithm,
+                "milp_solver": args.milp_solver,
+                "target_period": args.target_period,
+                "threshold": args.threshold,
+            },
+            "results": results,
+            "growth": growth,
+        }, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+    flagged = [g for g in growth if g["superlinear"]]
+    for g in flagged:
+        print(f"Warning: {g['metric']} grows superlinearly on {g['family']} "
+              f"(exponent {g['exponent']})", file=sys.stderr)
+
+    failed = any(r["status"] != "ok" for r in results)
+    if failed or (args.fail_on_superlinear and flagged):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
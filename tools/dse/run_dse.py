@@ -0,0 +1,451 @@
+"""
+This script explores the design space of a kernel by compiling, simulating,
+and estimating the cost of the circuits Dynamatic generates for it under
+different configurations of the compilation flow's main knobs: target clock
+period, buffer placement algorithm, resource sharing, and speculation.
+
+Each configuration (or point) is compiled and simulated through the dynamatic
+frontend in its own directory, using the kernel's profiler during buffer
+placement and the selected simulator to measure the circuit's latency in
+cycles. The area and critical path of each circuit are taken from the cost
+report written during compilation. Points run in parallel, with a bounded
+number of concurrent jobs, and their results are cached so that rerunning the
+exploration only evaluates new or outdated points.
+
+The script writes the results of all points as JSON, along with the Pareto
+front of the points that are not dominated in execution time (cycles times
+estimated clock period), area, and number of units. Each point records the
+frontend script and command line that reproduce it.
+"""
+
+import argparse
+import hashlib
+import itertools
+import json
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+DYNAMATIC_ROOT = Path(__file__).parent.parent.parent
+
+# Version of the results' format, to be incremented on incompatible changes
+FORMAT_VERSION = 1
+
+# Name of the frontend's output directory inside each point's directory
+OUT_DIR = "out"
+
+# Objectives of the Pareto front, all to be minimized
+OBJECTIVES = ["execution_time", "area", "num_units"]
+
+# Files of the compilation flow whose contents the results of a point depend
+# on, relative to Dynamatic's root
+FLOW_FILES = [
+    Path("tools") / "dynamatic" / "scripts" / "compile.sh",
+    Path("data") / "components.json",
+]
+
+
+class CLIHandler:
+    """
+    This class parses the script's command line arguments.
+    """
+
+    def __init__(self):
+        self.parser = argparse.ArgumentParser()
+        self.add_arguments()
+
+    def add_arguments(self):
+        """
+        Configures all available command line arguments.
+        """
+        self.parser.add_argument(
+            "source",
+            type=str,
+            help="Path to the kernel's C source file.",
+        )
+        self.parser.add_argument(
+            "-p",
+            "--target-periods",
+            nargs="+",
+            type=float,
+            default=[4.0, 6.0, 8.0],
+            help="Target clock periods to explore, in ns (default: 4 6 8).",
+        )
+        self.parser.add_argument(
+            "-b",
+            "--buffer-algorithms",
+            nargs="+",
+            default=["on-merges", "fpga20", "fpl22"],
+            help="Buffer placement algorithms to explore (default: on-merges "
+            "fpga20 fpl22).",
+        )
+        self.parser.add_argument(
+            "--sharing",
+            choices=["off", "on", "both"],
+            default="both",
+            help="Whether to explore circuits with credit-based sharing "
+            "(default: both).",
+        )
+        self.parser.add_argument(
+            "--speculation",
+            choices=["off", "on", "both"],
+            default="off",
+            help="Whether to explore circuits with speculation, which "
+            "requires a speculation pragma in the kernel (default: off).",
+        )
+        self.parser.add_argument(
+            "-s",
+            "--strategy",
+            choices=["grid", "random"],
+            default="grid",
+            help="Evaluate all points of the design space ('grid') or a "
+            "random sample of them ('random') (default: grid).",
+        )
+        self.parser.add_argument(
+            "--budget",
+            type=int,
+            default=8,
+            help="Number of points to evaluate with the random strategy "
+            "(default: 8).",
+        )
+        self.parser.add_argument(
+            "--seed",
+            type=int,
+            default=0,
+            help="Seed of the random strategy (default: 0).",
+        )
+        self.parser.add_argument(
+            "-j",
+            "--jobs",
+            type=int,
+            default=max(1, (os.cpu_count() or 2) // 2),
+            help="Maximum number of points evaluated concurrently (default: "
+            "half the number of CPUs).",
+        )
+        self.parser.add_argument(
+            "-w",
+            "--work-dir",
+            type=str,
+            default="dse",
+            help="Directory in which each point is compiled and simulated, "
+            "and in which results are cached (default: dse).",
+        )
+        self.parser.add_argument(
+            "-o",
+            "--output",
+            type=str,
+            default=None,
+            help="Path to which the JSON results should be written (default: "
+            "results.json in the work directory).",
+        )
+        self.parser.add_argument(
+            "--milp-solver",
+            type=str,
+            default="gurobi",
+            help="MILP solver used for buffer placement (default: gurobi).",
+        )
+        self.parser.add_argument(
+            "--simulator",
+            type=str,
+            default="ghdl",
+            help="Simulator used to measure latency (default: ghdl).",
+        )
+        self.parser.add_argument(
+            "--dynamatic",
+            type=str,
+            default=str(DYNAMATIC_ROOT / "bin" / "dynamatic"),
+            help="Path to the dynamatic frontend binary.",
+        )
+        self.parser.add_argument(
+            "--no-cache",
+            action="store_true",
+            help="Evaluate all points, even those whose cached results are "
+            "up-to-date.",
+        )
+
+    def parse_args(self, args=None):
+        """
+        Parses the command-line arguments.
+
+        Arguments:
+        `args` -- List of arguments to parse (default: sys.argv)
+
+        Returns: Parsed arguments namespace
+        """
+        return self.parser.parse_args(args)
+
+
+def get_flag_values(choice):
+    """
+    Returns the values a boolean knob takes for the given command line choice.
+    """
+    return {"off": [False], "on": [True], "both": [False, True]}[choice]
+
+
+def get_design_space(args):
+    """
+    Returns the list of configurations to evaluate, in a deterministic order.
+    """
+    space = [
+        {
+            "target_period": period,
+            "buffer_algorithm": algorithm,
+            "sharing": sharing,
+            "speculation": speculation,
+        }
+        for period, algorithm, sharing, speculation in itertools.product(
+            args.target_periods,
+            args.buffer_algorithms,
+            get_flag_values(args.sharing),
+            get_flag_values(args.speculation),
+        )
+    ]
+    if args.strategy == "random" and args.budget < len(space):
+        space = random.Random(args.seed).sample(space, args.budget)
+    return space
+
+
+def get_point_id(config):
+    """
+    Returns a name uniquely identifying the configuration, used as the name of
+    the point's directory.
+    """
+    point_id = f"cp{config['target_period']:g}_{config['buffer_algorithm']}"
+    if config["sharing"]:
+        point_id += "_sharing"
+    if config["speculation"]:
+        point_id += "_spec"
+    return point_id
+
+
+def get_kernel_sources(source):
+    """
+    Returns the kernel's C sources and headers, which are copied to each point's
+    directory.
+    """
+    kernel_dir = Path(source).parent
+    return sorted(p for p in kernel_dir.iterdir()
+                  if p.is_file() and p.suffix in (".c", ".h"))
+
+
+def get_cache_key(args, config, sources):
+    """
+    Returns a hash of everything the results of a point depend on: its
+    configuration, the kernel's sources, the compiler binaries, the compilation
+    script, and the timing models.
+    """
+    hasher = hashlib.sha256()
+    hasher.update(json.dumps(config, sort_keys=True).encode())
+    hasher.update(f"{args.milp_solver} {args.simulator}".encode())
+    for path in sources:
+        hasher.update(path.name.encode())
+        hasher.update(path.read_bytes())
+    # Binaries are identified by their size and modification time, which is
+    # much cheaper than reading them
+    binaries = [Path(args.dynamatic), DYNAMATIC_ROOT / "bin" / "dynamatic-opt"]
+    for path in binaries:
+        hasher.update(path.name.encode())
+        if path.exists():
+            stat = os.stat(path)
+            hasher.update(f"{stat.st_size} {stat.st_mtime_ns}".encode())
+    for path in FLOW_FILES:
+        hasher.update(str(path).encode())
+        if (DYNAMATIC_ROOT / path).exists():
+            hasher.update((DYNAMATIC_ROOT / path).read_bytes())
+    return hasher.hexdigest()
+
+
+def write_script(args, config, point_dir, kernel_name):
+    """
+    Writes the frontend script compiling and simulating the point.
+
+    Returns: Path to the script.
+    """
+    compile_cmd = (f"compile --buffer-algorithm {config['buffer_algorithm']} "
+                   f"--milp-solver {args.milp_solver}")
+    if config["sharing"]:
+        compile_cmd += " --sharing"
+    if config["speculation"]:
+        compile_cmd += " --speculation"
+    script = point_dir / "dse.dyn"
+    script.write_text("\n".join([
+        f"set-dynamatic-path {DYNAMATIC_ROOT.resolve()}",
+        f"set-src {point_dir / (kernel_name + '.c')}",
+        f"set-clock-period {config['target_period']:g}",
+        f"set-output-dir {OUT_DIR}",
+        compile_cmd,
+        "write-hdl --hdl vhdl",
+        f"simulate --simulator {args.simulator}",
+        "exit",
+    ]) + "\n")
+    return script
+
+
+def parse_cycles(report):
+    """
+    Parses the latency of the simulated circuit from the simulation report.
+
+    Returns: The number of cycles, or None if the report does not contain it.
+    """
+    if not report.exists():
+        return None
+    matches = re.findall(r"Simulation done! Latency = (\d+) cycles",
+                         report.read_text(errors="replace"))
+    return int(matches[-1]) if matches else None
+
+
+def parse_costs(report, kernel_name):
+    """
+    Parses the last cost estimates of the kernel's circuit from the cost report
+    written during compilation.
+
+    Returns: The last entry of the report for the kernel, or None if there is
+    none.
+    """
+    if not report.exists():
+        return None
+    entries = json.loads(report.read_text()).get("entries", [])
+    entries = [e for e in entries if e.get("function") == kernel_name]
+    return entries[-1] if entries else None
+
+
+def evaluate(args, config, sources, kernel_name):
+    """
+    Compiles and simulates a single point, unless its cached results are
+    up-to-date.
+
+    Returns: Dictionary describing the results for this point.
+    """
+    point_id = get_point_id(config)
+    point_dir = (Path(args.work_dir) / point_id).resolve()
+    result_path = point_dir / "result.json"
+    cache_key = get_cache_key(args, config, sources)
+
+    if not args.no_cache and result_path.exists():
+        cached = json.loads(result_path.read_text())
+        if cached.get("cache_key") == cache_key and cached["status"] == "ok":
+            cached["cached"] = True
+            return cached
+
+    # Start from a clean directory containing a copy of the kernel, so that
+    # concurrent points never share intermediate files
+    shutil.rmtree(point_dir, ignore_errors=True)
+    point_dir.mkdir(parents=True)
+    for path in sources:
+        shutil.copy(path, point_dir / path.name)
+    script = write_script(args, config, point_dir, kernel_name)
+    cmd = [os.path.abspath(args.dynamatic), "--exit-on-failure", "--run",
+           str(script)]
+
+    result = {
+        "id": point_id,
+        "config": config,
+        "cache_key": cache_key,
+        "script": str(script),
+        "command": " ".join(cmd),
+        "cached": False,
+    }
+    with open(point_dir / "dynamatic_out.txt", "w") as out, \
+            open(point_dir / "dynamatic_err.txt", "w") as err:
+        proc = subprocess.run(cmd, cwd=point_dir, stdout=out, stderr=err)
+
+    out_dir = point_dir / OUT_DIR
+    cycles = parse_cycles(out_dir / "sim" / "report.txt")
+    costs = parse_costs(out_dir / "comp" / "cost_report.json", kernel_name)
+    if proc.returncode != 0 or cycles is None or costs is None:
+        result["status"] = "failed"
+    else:
+        # The circuit cannot run faster than its estimated critical path
+        period = max(config["target_period"], costs["critical_path_delay"])
+        result.update({
+            "status": "ok",
+            "cycles": cycles,
+            "critical_path_delay": costs["critical_path_delay"],
+            "estimated_period": period,
+            "execution_time": cycles * period,
+            "area": costs["area"],
+            "num_units": costs["num_units"],
+            "num_uncharacterized_units": costs["num_uncharacterized_units"],
+        })
+
+    result_path.write_text(json.dumps(result, indent=2, sort_keys=True) + "\n")
+    return result
+
+
+def dominates(lhs, rhs):
+    """
+    Returns whether the first point is at least as good as the second one on
+    all objectives, and strictly better on at least one.
+    """
+    return (all(lhs[o] <= rhs[o] for o in OBJECTIVES) and
+            any(lhs[o] < rhs[o] for o in OBJECTIVES))
+
+
+def get_pareto_front(results):
+    """
+    Returns the successful points that no other successful point dominates,
+    sorted by execution time.
+    """
+    points = [r for r in results if r["status"] == "ok"]
+    front = [p for p in points if not any(dominates(q, p) for q in points)]
+    return sorted(front, key=lambda p: p["execution_time"])
+
+
+def main():
+    """
+    Entry point.
+    """
+    cli = CLIHandler()
+    args = cli.parse_args()
+
+    source = Path(args.source).resolve()
+    if source.suffix != ".c" or not source.exists():
+        print(f"Error: {args.source} is not a C source file", file=sys.stderr)
+        sys.exit(1)
+    kernel_name = source.stem
+    sources = get_kernel_sources(source)
+    space = get_design_space(args)
+
+    print(f"Exploring {len(space)} points with up to {args.jobs} jobs...",
+          flush=True)
+    with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = [executor.submit(evaluate, args, config, sources,
+                                   kernel_name) for config in space]
+        results = []
+        for future in futures:
+            result = future.result()
+            status = "cached" if result["cached"] else result["status"]
+            print(f"  {result['id']}: {status}", flush=True)
+            results.append(result)
+
+    front = get_pareto_front(results)
+    output = args.output or os.path.join(args.work_dir, "results.json")
+    with open(output, "w") as f:
+        json.dump({
+            "format_version": FORMAT_VERSION,
+            "kernel": kernel_name,
+            "objectives": OBJECTIVES,
+            "results": results,
+            "pareto_front": [p["id"] for p in front],
+        }, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+    print("Pareto front:")
+    for p in front:
+        print(f"  {p['id']}: {p['cycles']} cycles x "
+              f"{p['estimated_period']:.3f} ns = "
+              f"{p['execution_time']:.1f} ns, {p['area']:.0f} LUTs, "
+              f"{p['num_units']} units")
+        print(f"    {p['command']}")
+
+    if any(r["status"] != "ok" for r in results):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -42,6 +42,7 @@ namespace dynamatic {
 namespace experimental {
 namespace test {
 void registerTestHandshakeSimulator();
+void registerTestSpeculativeUnits();
 } // namespace test
 } // namespace experimental
 } // namespace dynamatic
@@ -49,6 +50,7 @@ void registerTestHandshakeSimulator();
 void registerTestPasses() {
   dynamatic::test::registerTestRTLSuppport();
   dynamatic::experimental::test::registerTestHandshakeSimulator();
+  dynamatic::experimental::test::registerTestSpeculativeUnits();
 }
 
 int main(int argc, char **argv) {
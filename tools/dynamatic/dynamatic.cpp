@@ -304,6 +304,13 @@ public:
   static constexpr llvm::StringLiteral ENABLE_SHORT_CIRCUIT =
       "enable-short-circuit";
   static constexpr llvm::StringLiteral SPECULATION = "speculation";
+  static constexpr llvm::StringLiteral OUT_OF_ORDER = "out-of-order";
+  static constexpr llvm::StringLiteral CLOCK_DOMAIN_UNITS =
+      "clock-domain-units";
+  static constexpr llvm::StringLiteral CLOCK_DOMAIN_RATIO =
+      "clock-domain-ratio";
+  static constexpr llvm::StringLiteral ITERATIVE_UNITS = "iterative-units";
+  static constexpr llvm::StringLiteral INCREMENTAL = "incremental";
 
   Compile(FrontendState &state)
       : Command("compile",
@@ -340,6 +347,24 @@ public:
     addFlag({SPECULATION,
              "Enable speculation. Requires a #pragma DYN speculate "
              "`in the source code file."});
+    addFlag({OUT_OF_ORDER,
+             "Let successive executions of if-then-else regions complete out "
+             "of order, using tags to restore program order"});
+    addOption({CLOCK_DOMAIN_UNITS,
+               "Comma-separated list of operation kinds (e.g., "
+               "'handshake.divf,handshake.divsi') to move to a slower clock "
+               "domain"});
+    addOption({CLOCK_DOMAIN_RATIO,
+               "Clock period of the slower clock domain, as a multiple of the "
+               "target clock period (default: 2)"});
+    addFlag({ITERATIVE_UNITS,
+             "Replace pipelined dividers with iterative ones when this does "
+             "not lower throughput (requires a throughput-driven buffer "
+             "placement algorithm)"});
+    addFlag({INCREMENTAL,
+             "Report which functions and basic blocks changed since the last "
+             "incremental compilation, and reuse the buffer placement of "
+             "unchanged CFDFCs"});
   }
 
   CommandResult execute(CommandArguments &args) override;
@@ -348,6 +373,7 @@ public:
 class WriteHDL : public Command {
 public:
   static constexpr llvm::StringLiteral HDL = "hdl";
+  static constexpr llvm::StringLiteral RUNTIME_CHECKS = "runtime-checks";
 
   WriteHDL(FrontendState &state)
       : Command(
@@ -356,6 +382,9 @@ public:
             "export-dot tool",
             state) {
     addOption({HDL, "HDL to use for design's top-level"});
+    addFlag({RUNTIME_CHECKS,
+             "Emit simulation-only checks of the invariants the compiler "
+             "relies on; violations are reported by simulate"});
   }
 
   CommandResult execute(CommandArguments &args) override;
@@ -782,13 +811,26 @@ CommandResult Compile::execute(CommandArguments &args) {
   std::string enableShortCircuit =
       args.flags.contains(ENABLE_SHORT_CIRCUIT) ? "1" : "0";
   std::string speculation = args.flags.contains(SPECULATION) ? "1" : "0";
+  std::string outOfOrder = args.flags.contains(OUT_OF_ORDER) ? "1" : "0";
+  std::string clockDomainUnits = "\"\"";
+  if (auto it = args.options.find(CLOCK_DOMAIN_UNITS);
+      it != args.options.end())
+    clockDomainUnits = it->second;
+  std::string clockDomainRatio = "2";
+  if (auto it = args.options.find(CLOCK_DOMAIN_RATIO);
+      it != args.options.end())
+    clockDomainRatio = it->second;
+  std::string iterativeUnits =
+      args.flags.contains(ITERATIVE_UNITS) ? "1" : "0";
+  std::string incremental = args.flags.contains(INCREMENTAL) ? "1" : "0";
 
   return execCmd(script, state.dynamaticPath, state.getKernelDir(),
                  state.getOutputDir(), state.getKernelName(), buffers,
                  floatToString(state.targetCP, 3), sharing,
                  state.fpUnitsGenerator, rigidification, kInduction, disableLSQ,
                  fastTokenDelivery, milpSolver, straightToQueue, speculation,
-                 enableShortCircuit);
+                 enableShortCircuit, outOfOrder, clockDomainUnits,
+                 clockDomainRatio, iterativeUnits, incremental);
 }
 
 CommandResult WriteHDL::execute(CommandArguments &args) {
@@ -815,8 +857,10 @@ CommandResult WriteHDL::execute(CommandArguments &args) {
     }
   }
 
+  std::string runtimeChecks = args.flags.contains(RUNTIME_CHECKS) ? "1" : "0";
+
   return execCmd(script, state.dynamaticPath, state.getOutputDir(),
-                 state.getKernelName(), hdl);
+                 state.getKernelName(), hdl, runtimeChecks);
 }
 
 CommandResult Simulate::execute(CommandArguments &args) {
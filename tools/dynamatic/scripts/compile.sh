@@ -23,6 +23,11 @@ MILP_SOLVER=${13}
 STRAIGHT_TO_QUEUE=${14}
 SPECULATION=${15}
 ENABLE_SHORT_CIRCUIT=${16}
+OUT_OF_ORDER=${17}
+CLOCK_DOMAIN_UNITS=${18}
+CLOCK_DOMAIN_RATIO=${19}
+ITERATIVE_UNITS=${20}
+INCREMENTAL=${21}
 
 LLVM=$DYNAMATIC_DIR/llvm-project
 DYNAMATIC_BINS=$DYNAMATIC_DIR/bin
@@ -56,12 +61,20 @@ F_PROFILER_INPUTS="$COMP_DIR/profiler-inputs.txt"
 F_HANDSHAKE="$COMP_DIR/handshake.mlir"
 F_HANDSHAKE_TRANSFORMED="$COMP_DIR/handshake_transformed.mlir"
 F_HANDSHAKE_SPECULATION="$COMP_DIR/handshake_speculation.mlir"
+F_HANDSHAKE_OUT_OF_ORDER="$COMP_DIR/handshake_out_of_order.mlir"
+F_HANDSHAKE_CLOCK_DOMAINS="$COMP_DIR/handshake_clock_domains.mlir"
 F_HANDSHAKE_BUFFERED="$COMP_DIR/handshake_buffered.mlir"
 F_HANDSHAKE_EXPORT="$COMP_DIR/handshake_export.mlir"
 F_HANDSHAKE_RIGIDIFIED="$COMP_DIR/handshake_rigidified.mlir"
 F_HANDSHAKE_SQ="$COMP_DIR/handshake_sq.mlir"
 F_HW="$COMP_DIR/hw.mlir"
 F_FREQUENCIES="$COMP_DIR/frequencies.csv"
+F_COST_REPORT="$COMP_DIR/cost_report.json"
+
+# Incremental compilation state, which must outlive the compilation directory
+INCREMENTAL_DIR="$OUTPUT_DIR/incremental"
+F_FINGERPRINTS="$INCREMENTAL_DIR/fingerprints.json"
+F_PLACEMENT_CACHE="$INCREMENTAL_DIR/buffer_placement.json"
 
 # ============================================================================ #
 # Helper funtions
@@ -123,11 +136,15 @@ fi
 # ------------------------------------------------------------------------------
 # NOTE:
 # - ffp-contract will prevent clang from adding "fused add mul" into the IR
+# - gline-tables-only attaches source locations to the instructions (without
+# any variable information), which are used to locate translation errors in
+# the C source
 # We need to check out the clang language extensions carefully for more
 # optimizations, e.g., loop unrolling:
 # https://clang.llvm.org/docs/LanguageExtensions.html#loop-unrolling
 # ------------------------------------------------------------------------------
-$DYNAMATIC_BINS/clang -O0 -funroll-loops -S -emit-llvm "$F_C_REWRITTEN" \
+$DYNAMATIC_BINS/clang -O0 -funroll-loops -gline-tables-only -S -emit-llvm \
+  "$F_C_REWRITTEN" \
   -I "$DYNAMATIC_DIR/include"  \
   -I "$SRC_DIR" \
   -I "$DYNAMATIC_DIR/build/include/clang_headers" \
@@ -254,6 +271,17 @@ else
     "Marked memory accesses with the corresponding interfaces in cf"
 fi
 
+# Report which parts of the kernel changed since the last compilation, and
+# reuse the buffer placement of those that did not
+if [[ $INCREMENTAL -ne 0 ]]; then
+  mkdir -p "$INCREMENTAL_DIR"
+  "$DYNAMATIC_OPT_BIN" "$F_CF_DYN_TRANSFORMED_MEM_DEP_MARKED" \
+    --fingerprint-regions="fingerprints=$F_FINGERPRINTS label=incremental" \
+    > /dev/null
+  exit_on_fail "Failed to fingerprint cf" "Fingerprinted cf"
+  PLACEMENT_CACHE_OPT="placement-cache=$F_PLACEMENT_CACHE"
+fi
+
 # cf level -> handshake level
 if [[ $FAST_TOKEN_DELIVERY -ne 0 ]]; then
   echo_info "Running FTD algorithm for handshake conversion"
@@ -314,6 +342,26 @@ if [[ "$SPECULATION" == "1" ]]; then
   F_HANDSHAKE_TRANSFORMED="$F_HANDSHAKE_SPECULATION"
 fi
 
+# Out-of-order execution: tag if-then-else regions and then materialize.
+if [[ "$OUT_OF_ORDER" == "1" ]]; then
+  "$DYNAMATIC_OPT_BIN" "$F_HANDSHAKE_TRANSFORMED" \
+    --handshake-out-of-order \
+    --handshake-materialize \
+    > "$F_HANDSHAKE_OUT_OF_ORDER"
+  exit_on_fail "Failed to tag out-of-order regions" \
+    "Tagged out-of-order regions"
+  F_HANDSHAKE_TRANSFORMED="$F_HANDSHAKE_OUT_OF_ORDER"
+fi
+
+# Clock domains: move slow units to a slower clock domain
+if [[ -n "$CLOCK_DOMAIN_UNITS" ]]; then
+  "$DYNAMATIC_OPT_BIN" "$F_HANDSHAKE_TRANSFORMED" \
+    --handshake-place-clock-domains="ops=$CLOCK_DOMAIN_UNITS period-ratio=$CLOCK_DOMAIN_RATIO" \
+    > "$F_HANDSHAKE_CLOCK_DOMAINS"
+  exit_on_fail "Failed to place clock domains" "Placed clock domains"
+  F_HANDSHAKE_TRANSFORMED="$F_HANDSHAKE_CLOCK_DOMAINS"
+fi
+
 # Credit-based sharing
 if [[ $USE_SHARING -ne 0 ]]; then
   # NOTE: to use this in dynamatic-opt, do ${SHARING_PASS:+"$SHARING_PASS"} to
@@ -322,6 +370,17 @@ if [[ $USE_SHARING -ne 0 ]]; then
   echo_info "Set to apply credit-based sharing after buffer placement."
 fi
 
+# Iterative units
+if [[ $ITERATIVE_UNITS -ne 0 ]]; then
+  ITERATIVE_UNITS_PASS="--handshake-select-iterative-units=timing-models=$DYNAMATIC_DIR/data/components.json target-period=$TARGET_CP"
+  echo_info "Set to select iterative units after buffer placement."
+fi
+
+# Area and critical path estimates, reported after each optimization pass
+rm -f "$F_COST_REPORT"
+cost_pass() {
+  echo "--handshake-estimate-costs=timing-models=$DYNAMATIC_DIR/data/components.json target-period=$TARGET_CP report=$F_COST_REPORT label=$1"
+}
 
 # Buffer placement
 if [[ "$BUFFER_ALGORITHM" == "on-merges" ]]; then
@@ -329,9 +388,12 @@ if [[ "$BUFFER_ALGORITHM" == "on-merges" ]]; then
   echo_info "Running simple buffer placement (on-merges)."
   "$DYNAMATIC_OPT_BIN" "$F_HANDSHAKE_TRANSFORMED" \
     --handshake-set-unit-impl-attr="target-period=$TARGET_CP timing-models=$DYNAMATIC_DIR/data/components.json impl=$FPUNITS_GEN" \
+    "$(cost_pass set-unit-impl-attr)" \
     --handshake-set-buffering-properties="version=fpga20" \
     --handshake-place-buffers="algorithm=$BUFFER_ALGORITHM solver=$MILP_SOLVER timing-models=$DYNAMATIC_DIR/data/components.json" \
+    "$(cost_pass place-buffers)" \
     ${SHARING_PASS:+"$SHARING_PASS"} \
+    ${SHARING_PASS:+"$(cost_pass credit-based-sharing)"} \
     > "$F_HANDSHAKE_BUFFERED"
   exit_on_fail "Failed to place simple buffers" "Placed simple buffers"
 else
@@ -359,10 +421,15 @@ else
   # out the value of <DEBUG_TYPE> in the cpp source files.
   "$DYNAMATIC_OPT_BIN" "$F_HANDSHAKE_TRANSFORMED" \
     --handshake-set-unit-impl-attr="target-period=$TARGET_CP timing-models=$DYNAMATIC_DIR/data/components.json impl=$FPUNITS_GEN" \
+    "$(cost_pass set-unit-impl-attr)" \
     --handshake-set-buffering-properties="version=fpga20" \
     --handshake-place-buffers="algorithm=$BUFFER_ALGORITHM solver=$MILP_SOLVER frequencies=$F_FREQUENCIES timing-models=$DYNAMATIC_DIR/data/components.json target-period=$TARGET_CP timeout=300 dump-milp-models \
-    blif-files=$DYNAMATIC_DIR/data/aig/ lut-delay=0.55 lut-size=6 acyclic-type" \
+    blif-files=$DYNAMATIC_DIR/data/aig/ lut-delay=0.55 lut-size=6 acyclic-type $PLACEMENT_CACHE_OPT" \
+    "$(cost_pass place-buffers)" \
     ${SHARING_PASS:+"$SHARING_PASS"} \
+    ${SHARING_PASS:+"$(cost_pass credit-based-sharing)"} \
+    ${ITERATIVE_UNITS_PASS:+"$ITERATIVE_UNITS_PASS"} \
+    ${ITERATIVE_UNITS_PASS:+"$(cost_pass select-iterative-units)"} \
     > "$F_HANDSHAKE_BUFFERED"
   exit_on_fail "Failed to place smart buffers" "Placed smart buffers"
   cd - > /dev/null
@@ -21,6 +21,8 @@ SIM_DIR="$OUTPUT_DIR/sim"
 F_WLF="$SIM_DIR/HLS_VERIFY/vsim.wlf"
 F_LOG="$VISUAL_DIR/$KERNEL_NAME.log"
 F_CSV="$VISUAL_DIR/$KERNEL_NAME.csv"
+F_LINEAGE="$VISUAL_DIR/$KERNEL_NAME.lineage.csv"
+F_PROFILE="$VISUAL_DIR/$KERNEL_NAME.profile.txt"
 F_DOT_POS_TMP="$VISUAL_DIR/$KERNEL_NAME.tmp.dot"
 F_DOT_POS="$VISUAL_DIR/$KERNEL_NAME.dot"
 
@@ -43,9 +45,14 @@ exit_on_fail "Failed to convert WLF file into LOG file" "Generated LOG file"
 
 # Convert the log file to a CSV for the visualizer
 "$DYNAMATIC_DIR/bin/log2csv" "$COMP_DIR/handshake_export.mlir" \
-  $LEVEL "$F_LOG" $KERNEL_NAME > $F_CSV
+  $LEVEL "$F_LOG" $KERNEL_NAME "--lineage=$F_LINEAGE" > $F_CSV
 exit_on_fail "Failed to generate channel changes from waveform" "Generated channel changes"
 
+# Attribute cycles to basic blocks and compare achieved and predicted IIs
+"$DYNAMATIC_DIR/bin/trace-profiler" "$COMP_DIR/handshake_export.mlir" \
+  "$F_CSV" > "$F_PROFILE"
+exit_on_fail "Failed to profile channel changes" "Generated performance profile"
+
 # Generate a version of the DOT with positioning information
 sed -e 's/splines=spline/splines=ortho/g' "$F_DOT" > "$F_DOT_POS_TMP"
 dot -Tdot "$F_DOT_POS_TMP" > "$F_DOT_POS"
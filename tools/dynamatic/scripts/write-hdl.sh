@@ -11,6 +11,7 @@ DYNAMATIC_DIR=$1
 OUTPUT_DIR=$2
 KERNEL_NAME=$3
 HDL=$4
+RUNTIME_CHECKS=$5
 
 # Generated directories/files
 HDL_DIR="$OUTPUT_DIR/hdl"
@@ -39,8 +40,14 @@ elif [ "$HDL" == "verilog-beta" ]; then
   HDL="verilog"
 fi
 
+# Optionally emit simulation-only runtime checks
+RUNTIME_CHECKS_FLAG=""
+if [ "$RUNTIME_CHECKS" == "1" ]; then
+  RUNTIME_CHECKS_FLAG="--runtime-checks"
+fi
+
 "$DYNAMATIC_DIR/bin/export-rtl" "$COMP_DIR/hw.mlir" "$HDL_DIR" $RTL_CONFIG \
-  --dynamatic-path "$DYNAMATIC_DIR" --hdl $HDL
+  --dynamatic-path "$DYNAMATIC_DIR" --hdl $HDL $RUNTIME_CHECKS_FLAG
 exit_on_fail "Failed to export RTL ($HDL)" "Exported RTL ($HDL)"
 
 echo_info "HDL generation succeeded"
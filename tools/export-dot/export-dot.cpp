@@ -152,6 +152,12 @@ static std::string getPrettyNodeLabel(Operation *op) {
                 stringifyEnum(bufferOp.getBufferType()).str();
             return bufferType + " [" + numSlots + "]";
           })
+      .Case<handshake::ClockCrossingOp>(
+          [&](handshake::ClockCrossingOp crossingOp) -> std::string {
+            return "clk" + std::to_string(crossingOp.getSrcDomain()) +
+                   " -> clk" + std::to_string(crossingOp.getDstDomain()) +
+                   " [" + std::to_string(crossingOp.getNumSlots()) + "]";
+          })
       .Case<handshake::MemoryControllerOp>([&](MemoryControllerOp mcOp) {
         return getMemLabel("MC", getMemName(mcOp.getMemRef()));
       })
@@ -254,6 +260,7 @@ static StringRef getNodeColor(Operation *op) {
           [&](auto) { return "lavender"; })
       .Case<handshake::BlockerOp>([&](auto) { return "cyan"; })
       .Case<handshake::BufferOp>([&](auto) { return "palegreen"; })
+      .Case<handshake::ClockCrossingOp>([&](auto) { return "khaki"; })
       .Case<handshake::EndOp>([&](auto) { return "gold"; })
       .Case<handshake::SourceOp, handshake::SinkOp>(
           [&](auto) { return "gainsboro"; })
@@ -268,6 +275,8 @@ static StringRef getNodeColor(Operation *op) {
             handshake::SpecSaveOp, handshake::SpecSaveCommitOp,
             handshake::SpeculatingBranchOp, handshake::NonSpecOp>(
           [&](auto) { return "salmon"; })
+      .Case<handshake::TaggerOp, handshake::UntaggerOp>(
+          [&](auto) { return "lightpink"; })
       .Default([&](auto) { return "moccasin"; });
 }
 
@@ -21,6 +21,8 @@
 #include "dynamatic/Support/System.h"
 #include "dynamatic/Support/Utils/Utils.h"
 #include "experimental/Support/FormalProperty.h"
+#include "experimental/Support/SmvConeOfInfluence.h"
+#include "experimental/Support/SmvModel.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/OwningOpRef.h"
@@ -51,13 +53,15 @@
 #include <set>
 #include <string>
 #include <system_error>
-#include <unordered_set>
 #include <utility>
 
 using namespace llvm;
 using namespace mlir;
 using namespace dynamatic;
 using namespace dynamatic::handshake;
+using dynamatic::experimental::SmvModel;
+using dynamatic::experimental::SmvModule;
+using dynamatic::experimental::SmvReduction;
 
 static cl::OptionCategory mainCategory("Tool options");
 
@@ -91,6 +95,29 @@ static cl::opt<bool> verifyInvariants(
     cl::desc("generate INVARs as INVARSPEC to verify if they are correct"),
     cl::init(false), cl::cat(mainCategory));
 
+static cl::opt<bool> runtimeChecks(
+    "runtime-checks", cl::Optional,
+    cl::desc("generate simulation-only checks of the invariants the compiler "
+             "relies on (non-speculative memory accesses and results, "
+             "lossless truncations); violations are logged to "
+             "assertions.log in the simulator's working directory"),
+    cl::init(false), cl::cat(mainCategory));
+
+static cl::opt<bool> smvCOI(
+    "smv-coi", cl::Optional,
+    cl::desc("reduce SMV models to the cone of influence of their "
+             "properties; a report of the reduction is written next to each "
+             "model"),
+    cl::init(false), cl::cat(mainCategory));
+
+static cl::opt<unsigned> smvCOIDepth(
+    "smv-coi-depth", cl::Optional,
+    cl::desc("maximum distance, in units, between the properties and the "
+             "units kept by the cone-of-influence reduction; the rest of the "
+             "circuit is abstracted by free inputs that follow the handshake "
+             "protocol (implies --smv-coi, unlimited by default)"),
+    cl::cat(mainCategory));
+
 static cl::list<std::string>
     rtlConfigs(cl::Positional, cl::OneOrMore,
                cl::desc("<RTL configuration files...>"), cl::cat(mainCategory));
@@ -177,13 +204,9 @@ LogicalResult ExportInfo::concretizeExternalModules() {
     // Try to find a matching component
     RTLMatch *match = config.getMatchingComponent(request);
     if (!match) {
-      extOp->emitError(
-          "Failed to find matching RTL component for external module");
-      llvm::errs() << extOp->getAttrOfType<DictionaryAttr>(
-                          RTL_PARAMETERS_ATTR_NAME)
-                   << "\n";
-      llvm::errs() << extOp->getAttrOfType<StringAttr>(RTL_NAME_ATTR_NAME)
-                   << "\n";
+      InFlightDiagnostic diag = emitError(request.loc)
+                                << "Failed to find matching RTL component";
+      config.explainNoMatch(request, diag);
       return failure();
     }
     // If match is not external, it must be freed when function returns
@@ -268,22 +291,14 @@ struct WriteModData {
   /// Writes the module's internal signal declarations.
   void writeSignalDeclarations(SignalDeclarationWriter writeDeclaration);
 
-  using SignalAssignmentWriter = void (*)(const llvm::Twine &dst,
-                                          const llvm::Twine &src,
-                                          raw_indented_ostream &os);
+  using SignalAssignmentWriter =
+      llvm::function_ref<void(const llvm::Twine &dst, const llvm::Twine &src,
+                              raw_indented_ostream &os)>;
 
   /// Writes signal assignments between the top-level module's outputs and
   /// the implementation's internal signals.
   void writeSignalAssignments(SignalAssignmentWriter writeAssignment);
 
-  using PropertyWriter = void (*)(const unsigned long &id,
-                                  const std::string &property,
-                                  FormalProperty::TAG tag,
-                                  raw_indented_ostream &os);
-
-  /// Writes properties
-  void writeProperties(PropertyWriter writeProperty);
-
   /// Returns a function that maps SSA values to the name of the internal RTl
   /// signal that corresponds to it. The returned function asserts if the value
   /// is unknown.
@@ -612,12 +627,6 @@ void WriteModData::writeSignalAssignments(
   }
 }
 
-void WriteModData::writeProperties(PropertyWriter writeProperty) {
-  for (auto const &[id, property] : properties) {
-    writeProperty(id, property.first, property.second, os);
-  }
-}
-
 RTLWriter::EntityIO::EntityIO(hw::HWModuleOp modOp) {
   auto addValidAndReady = [&](StringRef portName, std::vector<IOPort> &down,
                               std::vector<IOPort> &up) -> void {
@@ -785,6 +794,136 @@ void RTLWriter::fillIOMappings(hw::InstanceOp instOp,
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Runtime checks
+//===----------------------------------------------------------------------===//
+
+/// Name of the file, relative to the simulator's working directory, to which
+/// violated runtime checks are logged.
+static constexpr StringLiteral RUNTIME_CHECKS_LOG("assertions.log");
+
+namespace {
+
+/// A simulation-only check of an invariant the compiler relies on, evaluated
+/// on every rising clock edge outside of reset when the checked channel holds
+/// a valid token.
+struct RuntimeCheck {
+  enum class Kind {
+    /// The token on the channel must not be speculative.
+    NON_SPECULATIVE,
+    /// The data on the channel must fit in fewer bits, as a signed or as an
+    /// unsigned integer.
+    FITS_IN_WIDTH
+  };
+
+  /// The invariant to check.
+  Kind kind;
+  /// Name of the Handshake operation the check originates from.
+  std::string opName;
+  /// Name of the Handshake operation's type (e.g., `handshake.store`).
+  std::string opType;
+  /// Name of the operation's port the checked channel connects to.
+  std::string portName;
+  /// Base name of the internal signal the checked channel maps to.
+  std::string signal;
+  /// Data width of the checked channel (`FITS_IN_WIDTH` only).
+  unsigned dataWidth = 0;
+  /// Number of bits the data must fit in (`FITS_IN_WIDTH` only).
+  unsigned width = 0;
+  /// Whether the data must fit as a signed integer rather than as an unsigned
+  /// one (`FITS_IN_WIDTH` only).
+  bool isSigned = false;
+
+  RuntimeCheck(Kind kind, StringRef opName, StringRef opType,
+               StringRef portName, StringRef signal)
+      : kind(kind), opName(opName), opType(opType), portName(portName),
+        signal(signal) {}
+
+  /// Returns the message logged when the check is violated.
+  std::string getMessage() const {
+    std::string msg = opName + " (" + opType + "): ";
+    switch (kind) {
+    case Kind::NON_SPECULATIVE:
+      return msg + "speculative token on " + portName;
+    case Kind::FITS_IN_WIDTH:
+      return msg + "value on " + portName + " does not fit in " +
+             std::to_string(width) + " bits as " +
+             (isSigned ? "a signed" : "an unsigned") + " integer";
+    }
+  }
+};
+
+} // namespace
+
+/// Determines whether operations of the type commit memory accesses, in
+/// which case speculative tokens must never reach them. Load-store queues, in
+/// particular, order accesses in program order and cannot squash one once it
+/// has been issued.
+static bool commitsMemoryAccesses(StringRef opType) {
+  return opType == "handshake.store" || opType == "handshake.lsq" ||
+         opType == "handshake.mem_controller";
+}
+
+/// Collects the runtime checks to emit inside the module:
+/// - tokens going to stores, LSQs, memory controllers, and out of the module
+///   must not be speculative;
+/// - integer truncations that bitwidth optimization introduced on the sole
+///   basis of inferred value ranges (see `NARROWING_ATTR_NAME`) must not drop
+///   information. Other truncations are lossless by construction or by the
+///   semantics of the source program.
+static void collectRuntimeChecks(const WriteModData &data,
+                                 std::vector<RuntimeCheck> &checks) {
+  auto isSpeculative = [](Type type) -> bool {
+    auto extraType = dyn_cast<ExtraSignalsTypeInterface>(type);
+    return extraType && extraType.hasExtraSignal("spec");
+  };
+  FGetValueName getValueName = data.getSignalNameFunc();
+
+  for (hw::InstanceOp instOp : data.modOp.getOps<hw::InstanceOp>()) {
+    hw::HWModuleLike refModOp = getHWModule(instOp);
+    auto nameAttr = refModOp->getAttrOfType<StringAttr>(RTL_NAME_ATTR_NAME);
+    if (!nameAttr)
+      continue;
+    StringRef opName = instOp.getInstanceName();
+    StringRef opType = nameAttr.getValue();
+
+    if (commitsMemoryAccesses(opType)) {
+      for (auto [oprd, portName] : llvm::zip_equal(
+               instOp.getOperands(), refModOp.getInputNamesStr())) {
+        if (isSpeculative(oprd.getType())) {
+          checks.emplace_back(RuntimeCheck::Kind::NON_SPECULATIVE, opName,
+                              opType, portName.strref(), getValueName(oprd));
+        }
+      }
+    }
+
+    auto narrowing = instOp->getAttrOfType<StringAttr>(NARROWING_ATTR_NAME);
+    if (opType == "handshake.trunci" && narrowing) {
+      auto inType = dyn_cast<ChannelType>(instOp.getOperand(0).getType());
+      auto outType = dyn_cast<ChannelType>(instOp.getResult(0).getType());
+      if (!inType || !outType)
+        continue;
+      RuntimeCheck &check = checks.emplace_back(
+          RuntimeCheck::Kind::FITS_IN_WIDTH, opName, opType,
+          refModOp.getInputNamesStr().front().strref(),
+          getValueName(instOp.getOperand(0)));
+      check.dataWidth = inType.getDataBitWidth();
+      check.width = outType.getDataBitWidth();
+      check.isSigned = narrowing.getValue() == NARROWING_SEXT;
+    }
+  }
+
+  StringRef funcName = data.modOp.getSymName();
+  for (auto [val, portName] :
+       llvm::zip(data.outputs, data.modOp.getOutputNamesStr())) {
+    if (isSpeculative(val.getType())) {
+      checks.emplace_back(RuntimeCheck::Kind::NON_SPECULATIVE, funcName,
+                          "handshake.func", portName.strref(),
+                          getValueName(val));
+    }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // VHDLWriter
 //===----------------------------------------------------------------------===//
@@ -810,6 +949,9 @@ private:
 
   /// Writes all module instantiations inside the entity's architecture.
   void writeModuleInstantiations(WriteModData &data) const;
+
+  /// Writes a simulation-only process logging violated runtime checks.
+  void writeRuntimeChecks(WriteModData &data) const;
 };
 
 } // namespace
@@ -823,7 +965,10 @@ LogicalResult VHDLWriter::write(hw::HWModuleOp modOp,
   // Generic imports
   os << "library ieee;\n";
   os << "use ieee.std_logic_1164.all;\n";
-  os << "use ieee.numeric_std.all;\n\n";
+  os << "use ieee.numeric_std.all;\n";
+  if (runtimeChecks)
+    os << "use std.textio.all;\n";
+  os << "\n";
 
   // Declare the entity
   os << "entity " << modOp.getSymName() << " is\n";
@@ -873,6 +1018,8 @@ LogicalResult VHDLWriter::write(hw::HWModuleOp modOp,
          raw_indented_ostream &os) { os << dst << " <= " << src << ";\n"; });
   os << "\n";
   writeModuleInstantiations(data);
+  if (runtimeChecks)
+    writeRuntimeChecks(data);
 
   // Close the entity's architecture
   os.unindent();
@@ -880,6 +1027,73 @@ LogicalResult VHDLWriter::write(hw::HWModuleOp modOp,
   return success();
 }
 
+void VHDLWriter::writeRuntimeChecks(WriteModData &data) const {
+  std::vector<RuntimeCheck> checks;
+  collectRuntimeChecks(data, checks);
+  if (checks.empty())
+    return;
+
+  auto getAllBits = [](unsigned hi, unsigned lo, char bit) -> std::string {
+    return "(" + std::to_string(hi) + " downto " + std::to_string(lo) +
+           " => '" + bit + "')";
+  };
+
+  raw_indented_ostream &os = data.os;
+  os << "-- pragma translate_off\n";
+  os << "runtime_checks : process (" << CLK_PORT << ")\n";
+  os.indent();
+  os << "file log_file : text open write_mode is \"" << RUNTIME_CHECKS_LOG
+     << "\";\n";
+  os << "variable log_line : line;\n";
+  os << "variable cycle : natural := 0;\n";
+  os.unindent();
+  os << "begin\n";
+  os.indent();
+  os << "if rising_edge(" << CLK_PORT << ") then\n";
+  os.indent();
+  os << "if " << RST_PORT << " = '0' then\n";
+  os.indent();
+  for (const RuntimeCheck &check : checks) {
+    os << "if " << getInternalSignalName(check.signal, SignalType::VALID)
+       << " = '1' and ";
+    switch (check.kind) {
+    case RuntimeCheck::Kind::NON_SPECULATIVE: {
+      std::string spec = check.signal + "_spec";
+      os << spec << " /= (" << spec << "'range => '0')";
+      break;
+    }
+    case RuntimeCheck::Kind::FITS_IN_WIDTH: {
+      // The upper bits must all be 0 for an unsigned value. For a signed value,
+      // they must all be copies of the narrowed value's sign bit.
+      unsigned hi = check.dataWidth - 1;
+      unsigned lo = check.isSigned ? check.width - 1 : check.width;
+      std::string upperBits = check.signal + "(" + std::to_string(hi) +
+                              " downto " + std::to_string(lo) + ")";
+      os << upperBits << " /= " << getAllBits(hi, lo, '0');
+      if (check.isSigned)
+        os << " and " << upperBits << " /= " << getAllBits(hi, lo, '1');
+      break;
+    }
+    }
+    os << " then\n";
+    os.indent();
+    os << "write(log_line, string'(\"cycle \"));\n";
+    os << "write(log_line, cycle);\n";
+    os << "write(log_line, string'(\": " << check.getMessage() << "\"));\n";
+    os << "writeline(log_file, log_line);\n";
+    os.unindent();
+    os << "end if;\n";
+  }
+  os.unindent();
+  os << "end if;\n";
+  os << "cycle := cycle + 1;\n";
+  os.unindent();
+  os << "end if;\n";
+  os.unindent();
+  os << "end process;\n";
+  os << "-- pragma translate_on\n\n";
+}
+
 void VHDLWriter::writeModuleInstantiations(WriteModData &data) const {
   using KeyValuePair = std::pair<StringRef, StringRef>;
 
@@ -972,6 +1186,9 @@ private:
 
   /// Writes all module instantiations inside the entity's architecture.
   void writeModuleInstantiations(WriteModData &data) const;
+
+  /// Writes a simulation-only block logging violated runtime checks.
+  void writeRuntimeChecks(WriteModData &data) const;
 };
 
 } // namespace
@@ -1018,12 +1235,64 @@ LogicalResult VerilogWriter::write(hw::HWModuleOp modOp,
   });
   os << "\n";
   writeModuleInstantiations(data);
+  if (runtimeChecks)
+    writeRuntimeChecks(data);
 
   os.unindent();
   os << "endmodule\n";
   return success();
 }
 
+void VerilogWriter::writeRuntimeChecks(WriteModData &data) const {
+  std::vector<RuntimeCheck> checks;
+  collectRuntimeChecks(data, checks);
+  if (checks.empty())
+    return;
+
+  raw_indented_ostream &os = data.os;
+  os << "// synthesis translate_off\n";
+  os << "integer runtime_checks_log;\n";
+  os << "integer runtime_checks_cycle = 0;\n";
+  os << "initial runtime_checks_log = $fopen(\"" << RUNTIME_CHECKS_LOG
+     << "\", \"w\");\n";
+  os << "always @(posedge " << CLK_PORT << ") begin\n";
+  os.indent();
+  os << "if (!" << RST_PORT << ") begin\n";
+  os.indent();
+  for (const RuntimeCheck &check : checks) {
+    os << "if (" << getInternalSignalName(check.signal, SignalType::VALID)
+       << " && ";
+    switch (check.kind) {
+    case RuntimeCheck::Kind::NON_SPECULATIVE:
+      os << "|" << check.signal << "_spec";
+      break;
+    case RuntimeCheck::Kind::FITS_IN_WIDTH: {
+      // The upper bits must all be 0 for an unsigned value. For a signed value,
+      // they must all be copies of the narrowed value's sign bit.
+      unsigned hi = check.dataWidth - 1;
+      unsigned lo = check.isSigned ? check.width - 1 : check.width;
+      std::string upperBits = check.signal + "[" + std::to_string(hi) + ":" +
+                              std::to_string(lo) + "]";
+      os << "|" << upperBits;
+      if (check.isSigned)
+        os << " && !(&" << upperBits << ")";
+      break;
+    }
+    }
+    os << ")\n";
+    os.indent();
+    os << "$fdisplay(runtime_checks_log, \"cycle %0d: " << check.getMessage()
+       << "\", runtime_checks_cycle);\n";
+    os.unindent();
+  }
+  os.unindent();
+  os << "end\n";
+  os << "runtime_checks_cycle <= runtime_checks_cycle + 1;\n";
+  os.unindent();
+  os << "end\n";
+  os << "// synthesis translate_on\n\n";
+}
+
 void VerilogWriter::writeModuleInstantiations(WriteModData &data) const {
   using KeyValuePair = std::pair<StringRef, StringRef>;
 
@@ -1126,10 +1395,12 @@ private:
   /// Associates each property ID with the textual representation of the
   /// property and tag
   LogicalResult createProperties(WriteModData &data) const;
-  /// Writes all module instantiations inside the entity's architecture.
-  void writeModuleInstantiations(WriteModData &data) const;
-  /// Writes the preprocessor directives to include the external modules
-  void writeIncludes(WriteModData &data) const;
+  /// Adds an instance to the SMV module for each module instantiation, and a
+  /// channel for each handshake channel produced by an instance.
+  void addModuleInstances(WriteModData &data, SmvModule &smvMod) const;
+  /// Reduces the SMV module to the cone of influence of its properties and
+  /// writes a report of the reduction to the output directory.
+  LogicalResult reduceModule(SmvModule &smvMod) const;
   /// Returns the name of the value from the user's perspective.
   /// For example if val is mux0.outs and it is connected to buffer0 thorugh
   /// the ins port getUserSignal will return buffer0.ins.
@@ -1138,16 +1409,6 @@ private:
 
 } // namespace
 
-void SMVWriter::writeIncludes(WriteModData &data) const {
-  std::unordered_set<std::string> incNames;
-  for (auto m : exportInfo.externals) {
-    incNames.insert(m.getSecond()->getConcreteModuleName().str());
-  }
-  for (const std::string &name : incNames) {
-    data.os << "#include \"" << name << ".smv\"\n";
-  }
-}
-
 std::optional<std::string> SMVWriter::getUserSignal(Value val) const {
   auto *userOp = *val.getUsers().begin();
   std::optional<hw::InstanceOp> userInstance =
@@ -1529,97 +1790,162 @@ LogicalResult SMVWriter::write(hw::HWModuleOp modOp,
   if (failed(createProperties(data)))
     return failure();
 
-  writeIncludes(data);
-  os << "\n\n";
-
-  os << "MODULE " << modOp.getSymName() << " (testbench, ";
-
-  data.writeIO([](const llvm::Twine &name, PortType dir,
-                  std::optional<unsigned> type,
-                  raw_indented_ostream &os) { os << name; },
-               ", ", hdl);
-
-  os << ")\n\n";
+  // Include the external modules, in a deterministic order
+  SmvModel model;
+  std::set<std::string> incNames;
+  for (auto m : exportInfo.externals)
+    incNames.insert(m.getSecond()->getConcreteModuleName().str());
+  for (const std::string &name : incNames)
+    model.addInclude(name + ".smv");
+
+  // The module's parameters are the testbench and all input ports except the
+  // clock and reset (outputs are accessed through the module instance)
+  SmvModule &smvMod = model.addModule(modOp.getSymName(), {"testbench"});
+  for (const IOPort &port : RTLWriter::EntityIO(modOp).inputs) {
+    if (port.first != CLK_PORT && port.first != RST_PORT)
+      smvMod.params.push_back(port.first);
+  }
 
-  os << "\n-- input and output\n";
-  data.writeSignalAssignments([](const llvm::Twine &dst, const llvm::Twine &src,
-                                 raw_indented_ostream &os) {
-    os << "DEFINE " << dst << " := " << src << ";\n";
+  data.writeSignalAssignments([&](const llvm::Twine &dst,
+                                  const llvm::Twine &src,
+                                  raw_indented_ostream &) {
+    smvMod.addDefine(dst.str(), src.str());
   });
-
-  os << "\n\n";
-
-  writeModuleInstantiations(data);
-  os << "\n-- properties\n";
-  data.writeProperties([](const unsigned long &id, const std::string &property,
-                          FormalProperty::TAG tag, raw_indented_ostream &os) {
+  addModuleInstances(data, smvMod);
+
+  // Properties are written in order of their ID so that the model is
+  // deterministic
+  std::vector<long unsigned> ids;
+  for (const auto &[id, _] : data.properties)
+    ids.push_back(id);
+  llvm::sort(ids);
+  for (long unsigned id : ids) {
+    const auto &[property, tag] = data.properties.at(id);
+    std::string strID = std::to_string(id);
     if (verifyInvariants) {
       if (tag == FormalProperty::TAG::INVAR) {
-        os << "INVARSPEC NAME invariant" << id << " := " << property << ";\n";
+        smvMod.addSpec(SmvModule::Spec::Kind::INVARSPEC, property,
+                       "invariant" + strID);
       }
     } else {
-      if (tag == FormalProperty::TAG::OPT)
-        os << "INVARSPEC NAME p" << id << " := " << property << ";\n";
-      else if (tag == FormalProperty::TAG::INVAR) {
-        os << "-- invariant" << id << "\n";
-        os << "INVAR " << property << ";\n";
+      if (tag == FormalProperty::TAG::OPT) {
+        smvMod.addSpec(SmvModule::Spec::Kind::INVARSPEC, property, "p" + strID);
+      } else if (tag == FormalProperty::TAG::INVAR) {
+        smvMod.addSpec(SmvModule::Spec::Kind::INVAR, property, {},
+                       "invariant" + strID);
       }
     }
-  });
+  }
+
+  if ((smvCOI || smvCOIDepth.getNumOccurrences()) &&
+      failed(reduceModule(smvMod)))
+    return failure();
 
+  model.print(os);
   return success();
 }
 
-void SMVWriter::writeModuleInstantiations(WriteModData &data) const {
-  using KeyValuePair = std::pair<StringRef, StringRef>;
+/// Returns the SMV type of a signal of the given bitwidth, matching the one
+/// used by the SMV unit generators.
+static std::string getSMVType(unsigned bitwidth) {
+  if (bitwidth == 1)
+    return "boolean";
+  return "unsigned word [" + std::to_string(bitwidth) + "]";
+}
 
+void SMVWriter::addModuleInstances(WriteModData &data,
+                                   SmvModule &smvMod) const {
   for (hw::InstanceOp instOp : data.modOp.getOps<hw::InstanceOp>()) {
-    HDL hdl(HDL::SMV);
     std::string moduleName;
-    std::string archName;
-    SmallVector<KeyValuePair> genericParams;
-
     llvm::TypeSwitch<Operation *, void>(getHWModule(instOp).getOperation())
         .Case<hw::HWModuleOp>(
             [&](hw::HWModuleOp hwModOp) { moduleName = hwModOp.getSymName(); })
         .Case<hw::HWModuleExternOp>([&](hw::HWModuleExternOp extModOp) {
-          const RTLMatch &match = *exportInfo.externals.at(extModOp);
-          hdl = match.component->getHDL();
-          moduleName = match.getConcreteModuleName();
-          archName = match.getConcreteArchName();
-          genericParams = match.getGenericParameterValues().takeVector();
+          moduleName =
+              exportInfo.externals.at(extModOp)->getConcreteModuleName();
         })
         .Default([&](auto) { llvm_unreachable("unknown module type"); });
 
-    raw_indented_ostream &os = data.os;
-    // Declare the instance
-    os << "VAR " << instOp.getInstanceName() << " : " << moduleName;
-
-    os << "(";
-
-    PortMapWriter writePortMap = [](const Port &port,
-                                    ArrayRef<std::string> signalNames,
-                                    raw_indented_ostream &os) {
+    // Signals of array ports are passed one after the other
+    IOMap mappings;
+    fillIOMappings(instOp, data.getSignalNameFunc(), mappings);
+    std::vector<std::string> args;
+    for (auto &[port, signalNames] : mappings) {
       assert(!signalNames.empty() && "no signal name associated to port");
-      if (!port.second) {
-        assert(signalNames.size() == 1 &&
-               "more than one signal for non-array port");
-        os << signalNames.front();
-        return;
+      assert((port.second || signalNames.size() == 1) &&
+             "more than one signal for non-array port");
+      llvm::append_range(args, signalNames);
+    }
+    smvMod.addInstance(instOp.getInstanceName(), moduleName, args);
+
+    // Record the handshake channels produced by the instance
+    for (OpResult res : instOp->getResults()) {
+      auto channelType = dyn_cast<ChannelType>(res.getType());
+      auto controlType = dyn_cast<ControlType>(res.getType());
+      if (!channelType && !controlType)
+        continue;
+      std::string signal = data.signals[res];
+
+      // Channels going to the module's outputs are ready when the module's
+      // environment is (see constructIOMappings)
+      std::string consumer, ready;
+      if (std::optional<std::string> user = getUserSignal(res)) {
+        consumer = StringRef(*user).split('.').first.str();
+        ready = getInternalSignalName(*user, SignalType::READY);
+      } else {
+        std::string signalName = signal;
+        std::replace(signalName.begin(), signalName.end(), '.', '_');
+        ready = getInternalSignalName(signalName, SignalType::READY);
       }
 
-      ArrayRef<std::string> signals(signalNames);
-      for (const std::string &sig : signals.drop_back())
-        os << sig << ", ";
-      os << signals.back();
-    };
+      std::vector<SmvModule::Signal> payload;
+      ArrayRef<ExtraSignal> extraSignals;
+      if (channelType) {
+        if (unsigned width = channelType.getDataBitWidth())
+          payload.push_back({signal, getSMVType(width)});
+        extraSignals = channelType.getExtraSignals();
+      } else {
+        extraSignals = controlType.getExtraSignals();
+      }
+      for (const ExtraSignal &extra : extraSignals) {
+        if (extra.downstream) {
+          payload.push_back({getExtraSignalName(signal, extra),
+                             getSMVType(extra.getBitWidth())});
+        }
+      }
+      smvMod.addChannel(instOp.getInstanceName(), consumer,
+                        getInternalSignalName(signal, SignalType::VALID),
+                        ready, payload);
+    }
+  }
+}
 
-    // Write IO mappings
-    IOMap mappings;
-    fillIOMappings(instOp, data.getSignalNameFunc(), mappings);
-    writeIOMap(mappings, writePortMap, ", ", os);
-    os << ");\n";
+LogicalResult SMVWriter::reduceModule(SmvModule &smvMod) const {
+  std::optional<unsigned> maxDepth;
+  if (smvCOIDepth.getNumOccurrences())
+    maxDepth = smvCOIDepth;
+  SmvReduction reduction =
+      dynamatic::experimental::reduceToConeOfInfluence(smvMod, maxDepth);
+
+  std::string filepath = exportInfo.outputPath.str() +
+                         sys::path::get_separator().str() + smvMod.name +
+                         "_coi.rpt";
+  std::error_code ec;
+  llvm::raw_fd_ostream reportStream(filepath, ec);
+  if (ec.value() != 0) {
+    llvm::errs() << "Failed to create cone-of-influence report @ ""
+                 << filepath << "": " << ec.message() << "
+";
+    return failure();
   }
+  reduction.print(reportStream);
+
+  llvm::outs() << smvMod.name << ": kept "
+               << reduction.numInstances - reduction.removedInstances.size()
+               << "/" << reduction.numInstances
+               << " unit(s) in the cone of influence of the properties"
+               << (reduction.exact ? "" : " (over-approximated)") << "\n";
+  return success();
 }
 
 /// Writes the RTL implementation corresponding to the hardware module in a
@@ -29,6 +29,7 @@
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <filesystem>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <utility>
@@ -118,6 +119,30 @@ mlir::LogicalResult compareCAndVhdlOutputs(const VerificationContext &ctx) {
   return mlir::success();
 }
 
+/// Reports all runtime checks that were violated during simulation, if the
+/// design was exported with runtime checks. Each line of the log identifies
+/// the cycle of the violation and the Handshake operation it originates from.
+/// Fails if at least one runtime check was violated.
+mlir::LogicalResult reportRuntimeChecks(const VerificationContext &ctx) {
+  std::ifstream logFile(ctx.getRuntimeChecksLogPath());
+  if (!logFile.is_open())
+    return mlir::success();
+
+  unsigned numViolations = 0;
+  std::string line;
+  while (std::getline(logFile, line)) {
+    if (line.empty())
+      continue;
+    logErr(LOG_TAG, "Runtime check violated at " + line);
+    ++numViolations;
+  }
+  if (numViolations == 0)
+    return mlir::success();
+  logErr(LOG_TAG, std::to_string(numViolations) +
+                      " runtime check violation(s) during simulation");
+  return mlir::failure();
+}
+
 } // namespace
 
 int main(int argc, char **argv) {
@@ -220,6 +245,9 @@ int main(int argc, char **argv) {
     logInf(LOG_TAG, "Failed to generate Simulation Script");
   }
 
+  // Remove runtime check violations logged by a previous simulation
+  std::filesystem::remove(ctx.getRuntimeChecksLogPath());
+
   // Run the simulator to simulate the testbench and write the outputs to the
   // VHDL_OUT
   {
@@ -229,11 +257,15 @@ int main(int argc, char **argv) {
     timer.stopTimer();
   }
 
+  // Report violated runtime checks before comparing outputs, as they usually
+  // explain mismatches
+  bool checksPassed = succeeded(reportRuntimeChecks(ctx));
+
   if (succeeded(compareCAndVhdlOutputs(ctx))) {
     logInf(LOG_TAG, "C and VHDL outputs match");
   } else {
     logErr(LOG_TAG, "C and VHDL outputs do not match");
     return 1;
   }
-  return 0;
+  return checksPassed ? 0 : 1;
 }
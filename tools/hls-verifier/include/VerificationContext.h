@@ -31,6 +31,9 @@ static const std::string GHDL_SCRIPT_FILE = "simulation_ghdl.sh";
 static const std::string XSIM_SCRIPT_FILE = "simulation_xsim.prj";
 static const std::string VERILATOR_SCRIPT_FILE = "simulation_verilator.sh";
 static const std::string HLS_VERIFY_DIR = "HLS_VERIFY";
+// Log of runtime checks violated during simulation (see export-rtl's
+// --runtime-checks), relative to HLS_VERIFY
+static const std::string RUNTIME_CHECKS_LOG_FILE = "assertions.log";
 
 enum HdlType { VHDL, VERILOG };
 
@@ -87,6 +90,10 @@ struct VerificationContext {
 
   std::string getHlsVerifyDir() const { return simPath + "/" + HLS_VERIFY_DIR; }
 
+  std::string getRuntimeChecksLogPath() const {
+    return getHlsVerifyDir() + SEP + RUNTIME_CHECKS_LOG_FILE;
+  }
+
   std::string getHdlSrcDir() const { return simPath + "/" + HDL_SRC_DIR; }
 };
 
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cmath>
 #include <optional>
 #include <string>
 #include <vector>
@@ -14,8 +15,10 @@
 #include "VerificationContext.h"
 #include "dynamatic/Dialect/Handshake/HandshakeOps.h"
 #include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
+#include "dynamatic/Support/ClockDomains.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/Support/IndentedOstream.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -414,6 +417,9 @@ struct ControlToEndConnector {
   }
 };
 
+// Half of the main clock's period in the testbench, in nanoseconds.
+static constexpr double HALF_CLK_PERIOD = 2.0;
+
 // function to get the port name in the entity for each paramter
 void getConstantDeclaration(mlir::raw_indented_ostream &os,
                             VerificationContext &ctx) {
@@ -445,8 +451,16 @@ void getConstantDeclaration(mlir::raw_indented_ostream &os,
     ChannelToEndConnector c(type, argName);
     c.declareConstants(os, ctx, inputVectorPath, outputFilePath);
   }
-  declareConstant(ctx, os, "HALF_CLK_PERIOD", TIME, "2.00");
-  declareConstant(ctx, os, "RESET_LATENCY", TIME, "8.00");
+  // Reset lasts for two periods of the slowest clock, so that every clock
+  // domain sees it. This is a whole number of main clock periods, which keeps
+  // latencies reported in main clock cycles exact
+  SmallVector<double> ratios = getClockPeriodRatios(*funcOp);
+  double resetLatency =
+      4 * HALF_CLK_PERIOD * std::ceil(*llvm::max_element(ratios));
+  declareConstant(ctx, os, "HALF_CLK_PERIOD", TIME,
+                  llvm::formatv("{0:f2}", HALF_CLK_PERIOD).str());
+  declareConstant(ctx, os, "RESET_LATENCY", TIME,
+                  llvm::formatv("{0:f2}", resetLatency).str());
   declareConstant(ctx, os, "TRANSACTION_NUM", INTEGER, to_string(1));
 }
 
@@ -460,6 +474,10 @@ void getSignalDeclaration(mlir::raw_indented_ostream &os,
   handshake::FuncOp *funcOp = ctx.funcOp;
 
   declareReg(ctx, os, "tb_clk", std::nullopt, 0);
+  // One clock per additional clock domain of the kernel
+  unsigned numDomains = getClockPeriodRatios(*funcOp).size();
+  for (unsigned domain = 1; domain < numDomains; ++domain)
+    declareReg(ctx, os, "tb_" + getClockPortName(domain), std::nullopt, 0);
   declareReg(ctx, os, "tb_rst", std::nullopt, 0);
 
   // The interface that indicates the global "start" signal.
@@ -559,6 +577,13 @@ void getDuvInstanceGeneration(mlir::raw_indented_ostream &os,
 
   handshake::FuncOp *funcOp = ctx.funcOp;
 
+  // Connect the clocks of additional clock domains to the DUV
+  unsigned numDomains = getClockPeriodRatios(*funcOp).size();
+  for (unsigned domain = 1; domain < numDomains; ++domain) {
+    std::string clkName = getClockPortName(domain);
+    duvInst.connect(clkName, "tb_" + clkName);
+  }
+
   // Connect the input data channels to the DUV
   for (auto &[type, argName] :
        getInputArguments<handshake::ChannelType>(funcOp)) {
@@ -709,6 +734,42 @@ end
   }
 }
 
+// Generates a clock for each additional clock domain of the kernel, whose
+// period is a multiple of the main clock's period. All clocks start low at the
+// same time.
+static void generateClockDomainProcesses(mlir::raw_indented_ostream &os,
+                                         VerificationContext &ctx) {
+  SmallVector<double> ratios = getClockPeriodRatios(*ctx.funcOp);
+  for (unsigned domain = 1; domain < ratios.size(); ++domain) {
+    std::string clkName = "tb_" + getClockPortName(domain);
+    std::string ratio = llvm::formatv("{0:f6}", ratios[domain]).str();
+    if (ctx.simLanguage == VHDL) {
+      os << llvm::formatv(R"(
+gen_clock_{0}_proc : process
+begin
+  {1} <= '0';
+  while (true) loop
+    wait for HALF_CLK_PERIOD * {2};
+    {1} <= not {1};
+  end loop;
+  wait;
+end process;
+)",
+                          domain, clkName, ratio);
+    } else {
+      os << llvm::formatv(R"(
+initial begin
+    {0} = 1'b0;
+    forever begin
+        #(HALF_CLK_PERIOD * {1}) {0} = ~{0};
+    end
+end
+)",
+                          clkName, ratio);
+    }
+  }
+}
+
 void vhdlTbCodegen(VerificationContext &ctx) {
 
   std::error_code ec;
@@ -741,6 +802,7 @@ void vhdlTbCodegen(VerificationContext &ctx) {
     deriveGlobalCompletionSignal(os, ctx);
     getOutputTagGeneration(os, ctx);
     os << VHDL_COMMON_TB_BODY;
+    generateClockDomainProcesses(os, ctx);
     generateTimeoutProcess(os, ctx);
     os.unindent();
     os << "end architecture behavior;\n";
@@ -756,6 +818,7 @@ void vhdlTbCodegen(VerificationContext &ctx) {
     deriveGlobalCompletionSignal(os, ctx);
     getOutputTagGeneration(os, ctx);
     os << VERILOG_COMMON_TB_BODY;
+    generateClockDomainProcesses(os, ctx);
     generateTimeoutProcess(os, ctx);
     os.unindent();
     os << "endmodule\n";
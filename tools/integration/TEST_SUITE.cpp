@@ -71,6 +71,12 @@ struct IntegrationTest {
   bool verifyInvariants = false;
   // Enable speculation, using the speculate pragma
   bool useSpeculation = false;
+  // Let if-then-else regions execute out of order
+  bool useOutOfOrder = false;
+  // Move units of these kinds to a slower clock domain, if not empty
+  std::string clockDomainUnits;
+  // Clock period of the slower clock domain, relative to the main one
+  unsigned clockDomainRatio = 2;
   std::string milpSolver = "gurobi";
   std::string bufferAlgorithm = "fpga20";
   unsigned clockPeriod = 5;
@@ -110,6 +116,11 @@ int IntegrationTest::run() {
              << (this->useSharing ? " --sharing" : "")
              << (this->useRigidification ? " --rigidification" : "")
              << (this->useSpeculation ? " --speculation" : "")
+             << (this->useOutOfOrder ? " --out-of-order" : "")
+             << (this->clockDomainUnits.empty() ? ""
+                    : " --clock-domain-units " + this->clockDomainUnits +
+                      " --clock-domain-ratio " +
+                      std::to_string(this->clockDomainRatio))
              << " --milp-solver " << this->milpSolver << std::endl;
   // clang-format on
 
@@ -210,6 +221,9 @@ class MemoryFixture : public BaseFixture {};
 class SharingFixture : public BaseFixture {};
 class SharingUnitTestFixture : public BaseFixture {};
 class SpecFixture : public BaseFixture {};
+class SpecEarlyExitFixture : public BaseFixture {};
+class OutOfOrderFixture : public BaseFixture {};
+class ClockDomainFixture : public BaseFixture {};
 
 class RigidificationFixture : public BaseFixture {};
 class VerifyInvariantsFixture : public BaseFixture {};
@@ -389,6 +403,115 @@ TEST_P(SpecFixture, spec) {
   logPerformance(config.simTime);
 }
 
+/// This testing fixture runs loops with data-dependent exits with and without
+/// speculation. It checks that the tokens of squashed iterations are correctly
+/// killed and that speculating on the loop exit does not take more cycles than
+/// waiting for it.
+TEST_P(SpecEarlyExitFixture, spec_early_exit) {
+  IntegrationTest configSpec{
+      // clang-format off
+      .name = GetParam(),
+      .testName = getVerboseOutdirSuffix() + "_spec",
+      .benchmarkPath = fs::path(DYNAMATIC_ROOT) / "integration-test",
+      .testVerilog = false,
+      .useSharing = false,
+      .useSpeculation = true,
+      .milpSolver = "gurobi",
+      .bufferAlgorithm = "fpga20",
+      .clockPeriod = 7,
+      .simTime = -1
+      // clang-format on
+  };
+  EXPECT_EQ(configSpec.run(), 0);
+
+  IntegrationTest configNoSpec{
+      // clang-format off
+      .name = GetParam(),
+      .testName = getVerboseOutdirSuffix(),
+      .benchmarkPath = fs::path(DYNAMATIC_ROOT) / "integration-test",
+      .testVerilog = false,
+      .useSharing = false,
+      .milpSolver = "gurobi",
+      .bufferAlgorithm = "fpga20",
+      .clockPeriod = 7,
+      .simTime = -1
+      // clang-format on
+  };
+  EXPECT_EQ(configNoSpec.run(), 0);
+
+  EXPECT_LE(configSpec.simTime, configNoSpec.simTime);
+
+  RecordProperty("cycles", std::to_string(configSpec.simTime));
+  RecordProperty("no_spec_cycles", std::to_string(configNoSpec.simTime));
+  logPerformance(configSpec.simTime);
+}
+
+/// This testing fixture runs the test with and without out-of-order execution.
+/// It checks that the out-of-order circuit is functionally correct and does not
+/// take more cycles than the in-order one.
+TEST_P(OutOfOrderFixture, out_of_order) {
+  IntegrationTest configOutOfOrder{
+      // clang-format off
+      .name = GetParam(),
+      .testName = getVerboseOutdirSuffix() + "_ooo",
+      .benchmarkPath = fs::path(DYNAMATIC_ROOT) / "integration-test",
+      .testVerilog = false,
+      .useSharing = false,
+      .useOutOfOrder = true,
+      .milpSolver = "gurobi",
+      .bufferAlgorithm = "fpga20",
+      .simTime = -1
+      // clang-format on
+  };
+  EXPECT_EQ(configOutOfOrder.run(), 0);
+
+  IntegrationTest configInOrder{
+      // clang-format off
+      .name = GetParam(),
+      .testName = getVerboseOutdirSuffix(),
+      .benchmarkPath = fs::path(DYNAMATIC_ROOT) / "integration-test",
+      .testVerilog = false,
+      .useSharing = false,
+      .milpSolver = "gurobi",
+      .bufferAlgorithm = "fpga20",
+      .simTime = -1
+      // clang-format on
+  };
+  EXPECT_EQ(configInOrder.run(), 0);
+
+  // Iterations taking the short path no longer wait behind earlier ones taking
+  // the long path
+  EXPECT_LT(configOutOfOrder.simTime, configInOrder.simTime);
+
+  RecordProperty("cycles", std::to_string(configOutOfOrder.simTime));
+  RecordProperty("in_order_cycles", std::to_string(configInOrder.simTime));
+  logPerformance(configOutOfOrder.simTime);
+}
+
+/// This testing fixture moves the dividers of each benchmark to a clock domain
+/// four times slower than the main one. The slow clock's first edges only come
+/// after several main clock cycles, so this checks that the whole circuit is
+/// reset and computes the right results.
+TEST_P(ClockDomainFixture, clock_domains) {
+  IntegrationTest config{
+      // clang-format off
+      .name = GetParam(),
+      .testName = getVerboseOutdirSuffix(),
+      .benchmarkPath = fs::path(DYNAMATIC_ROOT) / "integration-test",
+      .testVerilog = false,
+      .useSharing = false,
+      .clockDomainUnits = "handshake.divsi,handshake.divui",
+      .clockDomainRatio = 4,
+      .milpSolver = "gurobi",
+      .bufferAlgorithm = "fpga20",
+      .simTime = -1
+      // clang-format on
+  };
+  EXPECT_EQ(config.run(), 0);
+  RecordProperty("cycles", std::to_string(config.simTime));
+  logPerformance(config.simTime);
+}
+
 // clang-format off
 INSTANTIATE_TEST_SUITE_P(
     MiscBenchmarks, BasicFixture,
@@ -462,7 +585,8 @@ INSTANTIATE_TEST_SUITE_P(
       "unused_arg",
       "test_bool_array",
       "test_divui",
-      "test_fneg"
+      "test_fneg",
+      "test_memset_memcpy"
       ),
       [](const auto &info) { return info.param; });
 
@@ -556,12 +680,34 @@ INSTANTIATE_TEST_SUITE_P(SpecBenchmarks, SpecFixture,
       "if_convert",
       "loop_path",
       "nested_loop",
+      "nested_loop_multi_spec",
       "sparse",
       "subdiag",
       "subdiag_fast"
       ),
     [](const auto &info) { return "spec_" + info.param; });
 
+INSTANTIATE_TEST_SUITE_P(SpecEarlyExitBenchmarks, SpecEarlyExitFixture,
+    testing::Values(
+      "search_hist",
+      "search_hist_weighted",
+      "subdiag"
+      ),
+    [](const auto &info) { return "spec_exit_" + info.param; });
+
+INSTANTIATE_TEST_SUITE_P(OutOfOrderBenchmarks, OutOfOrderFixture,
+    testing::Values(
+      "ooo_branch_latency"
+      ),
+    [](const auto &info) { return "ooo_" + info.param; });
+
+INSTANTIATE_TEST_SUITE_P(ClockDomainBenchmarks, ClockDomainFixture,
+    testing::Values(
+      "complexdiv",
+      "test_divui"
+      ),
+    [](const auto &info) { return "clk_" + info.param; });
+
 // Smoke test: Using the CBC MILP solver to optimize some simple benchmarks
 // clang-format on
 
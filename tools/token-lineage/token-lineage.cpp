@@ -0,0 +1,237 @@
+//===- token-lineage.cpp - Query the lineage of tokens ----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Answers backward-slice ("where did this token come from") and forward-slice
+// ("what did this token affect") queries over the token lineage recorded
+// during a simulation (see `log2csv --lineage` and `handshake-simulator
+// --lineage`). The slice is printed as text or, when a DOT of the circuit is
+// provided, as the same DOT with the slice highlighted.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/TokenLineage.h"
+#include "dynamatic/Support/DOT.h"
+#include "dynamatic/Support/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/raw_ostream.h"
+#include <functional>
+#include <optional>
+#include <string>
+
+using namespace llvm;
+using namespace mlir;
+using namespace dynamatic;
+
+static cl::OptionCategory mainCategory("Tool options");
+
+static cl::opt<std::string> lineageFile(cl::Positional, cl::Required,
+                                        cl::desc("<path to lineage CSV>"),
+                                        cl::cat(mainCategory));
+
+static cl::opt<unsigned> tokenID("token", cl::Optional,
+                                 cl::desc("ID of the token to slice"),
+                                 cl::cat(mainCategory));
+
+static cl::opt<std::string>
+    channel("channel", cl::Optional,
+            cl::desc("Channel of the token to slice, identified by its "
+                     "producer and output index as <component>:<port>"),
+            cl::init(""), cl::cat(mainCategory));
+
+static cl::opt<unsigned>
+    seq("seq", cl::Optional,
+        cl::desc("Sequence number of the token to slice on the channel "
+                 "(defaults to the last token transferred on it)"),
+        cl::cat(mainCategory));
+
+static cl::opt<TokenLineage::Direction> direction(
+    "direction", cl::Optional, cl::desc("Direction of the slice"),
+    cl::init(TokenLineage::Direction::BACKWARD),
+    cl::values(clEnumValN(TokenLineage::Direction::BACKWARD, "backward",
+                          "Tokens the sliced token originates from"),
+               clEnumValN(TokenLineage::Direction::FORWARD, "forward",
+                          "Tokens the sliced token contributed to")),
+    cl::cat(mainCategory));
+
+static cl::opt<unsigned>
+    depth("depth", cl::Optional,
+          cl::desc("Maximum number of operations to traverse from the sliced "
+                   "token (unlimited by default)"),
+          cl::cat(mainCategory));
+
+static cl::opt<std::string>
+    dotFile("dot", cl::Optional,
+            cl::desc("Path to the circuit's DOT (as produced by export-dot); "
+                     "when provided, prints the DOT with the slice "
+                     "highlighted instead of a textual slice"),
+            cl::init(""), cl::cat(mainCategory));
+
+/// Color of nodes and edges which are not part of the slice.
+static constexpr StringLiteral FADED_COLOR("gray80");
+/// Color of nodes and edges which are part of the slice.
+static constexpr StringLiteral SLICE_COLOR("red");
+/// Color of the edge carrying the sliced token.
+static constexpr StringLiteral ORIGIN_COLOR("darkgreen");
+
+/// Returns the key identifying a channel by its endpoints.
+static std::string getChannelKey(StringRef srcComponent, unsigned srcPort,
+                                 StringRef dstComponent, unsigned dstPort) {
+  return srcComponent.str() + ":" + std::to_string(srcPort) + "->" +
+         dstComponent.str() + ":" + std::to_string(dstPort);
+}
+
+/// Returns the key identifying the channel a token was transferred on.
+static std::string getChannelKey(const TokenLineage::Token &token) {
+  const ChannelEndpoints &ch = token.channel;
+  return getChannelKey(ch.srcComponent, ch.srcPort, ch.dstComponent,
+                       ch.dstPort);
+}
+
+/// Prints a one-line description of the token.
+static void printToken(raw_ostream &os, const TokenLineage::Token &token) {
+  const ChannelEndpoints &ch = token.channel;
+  os << "#" << token.id << " @ cycle " << token.cycle << ": "
+     << ch.srcComponent << ":" << ch.srcPort << " -> " << ch.dstComponent
+     << ":" << ch.dstPort << " (token " << token.seq << ")";
+  if (!token.data.empty())
+    os << " = " << token.data;
+}
+
+/// Prints the slice as text, indenting each token by its distance to the
+/// sliced token.
+static void printSlice(raw_ostream &os,
+                       ArrayRef<TokenLineage::SliceEntry> slice) {
+  os << (direction == TokenLineage::Direction::BACKWARD ? "Backward"
+                                                         : "Forward")
+     << " slice of ";
+  printToken(os, *slice.front().first);
+  os << ": " << slice.size() - 1 << " other token(s)\n";
+  for (auto [token, distance] : slice.drop_front()) {
+    os.indent(2 * distance);
+    printToken(os, *token);
+    os << "\n";
+  }
+}
+
+/// Highlights the slice in the DOT graph and prints the latter.
+static LogicalResult printSliceDOT(raw_ostream &os,
+                                   ArrayRef<TokenLineage::SliceEntry> slice) {
+  DOTGraph graph;
+  DOTGraph::Builder builder = graph.getBuilder();
+  if (failed(builder.parseFromFile(dotFile)))
+    return failure();
+
+  // Count the tokens of the slice on each channel, and collect the nodes they
+  // go through
+  llvm::StringMap<unsigned> numTokens;
+  llvm::StringSet<> sliceNodes;
+  for (auto [token, _] : slice) {
+    ++numTokens[getChannelKey(*token)];
+    sliceNodes.insert(token->channel.srcComponent);
+    sliceNodes.insert(token->channel.dstComponent);
+  }
+  std::string originKey = getChannelKey(*slice.front().first);
+
+  std::function<void(DOTGraph::Subgraph &)> highlight =
+      [&](DOTGraph::Subgraph &subgraph) -> void {
+    for (DOTGraph::Node *node : subgraph.nodes) {
+      bool inSlice = sliceNodes.contains(node->id);
+      node->addAttr("color", inSlice ? SLICE_COLOR : FADED_COLOR);
+      if (inSlice)
+        node->addAttr("penwidth", "3");
+    }
+    for (DOTGraph::Edge *edge : subgraph.edges) {
+      unsigned fromIdx = 0, toIdx = 0;
+      StringRef(edge->attrs.lookup("from_idx")).getAsInteger(10, fromIdx);
+      StringRef(edge->attrs.lookup("to_idx")).getAsInteger(10, toIdx);
+      std::string key = getChannelKey(edge->srcNode->id, fromIdx,
+                                      edge->dstNode->id, toIdx);
+      auto tokenIt = numTokens.find(key);
+      if (tokenIt == numTokens.end()) {
+        edge->addAttr("color", FADED_COLOR);
+        continue;
+      }
+      edge->addAttr("color", key == originKey ? ORIGIN_COLOR : SLICE_COLOR);
+      edge->addAttr("penwidth", "3");
+      edge->addAttr("label", std::to_string(tokenIt->second) + " token(s)");
+    }
+    for (DOTGraph::Subgraph *nested : subgraph.subgraphs)
+      highlight(*nested);
+  };
+  highlight(builder.getRoot());
+
+  graph.print(os);
+  return success();
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Queries the lineage of tokens recorded during a simulation.\n\n"
+      "The token to slice is identified either by its ID (--token) or by the\n"
+      "channel it was transferred on and its sequence number on it\n"
+      "(--channel and --seq).");
+
+  TokenLineage lineage;
+  if (failed(lineage.parseFromFile(lineageFile)))
+    return 1;
+
+  // Find the token to slice
+  const TokenLineage::Token *token = nullptr;
+  if (tokenID.getNumOccurrences()) {
+    if (!channel.empty()) {
+      llvm::errs() << "--token and --channel are mutually exclusive\n";
+      return 1;
+    }
+    if (!(token = lineage.getToken(tokenID))) {
+      llvm::errs() << "No token with ID " << tokenID << "\n";
+      return 1;
+    }
+  } else if (!channel.empty()) {
+    auto [component, portStr] = StringRef(channel).rsplit(':');
+    unsigned port;
+    if (portStr.getAsInteger(10, port)) {
+      llvm::errs() << "Expected channel as <component>:<port>, but got "
+                   << channel << "\n";
+      return 1;
+    }
+
+    // By default, slice the last token transferred on the channel
+    unsigned tokenSeq = seq;
+    if (!seq.getNumOccurrences()) {
+      for (tokenSeq = 0; lineage.getToken(component, port, tokenSeq + 1);)
+        ++tokenSeq;
+    }
+    if (!(token = lineage.getToken(component, port, tokenSeq))) {
+      llvm::errs() << "No token " << tokenSeq << " on channel " << channel
+                   << "\n";
+      return 1;
+    }
+  } else {
+    llvm::errs() << "Expected one of --token or --channel\n";
+    return 1;
+  }
+
+  std::optional<unsigned> maxDepth;
+  if (depth.getNumOccurrences())
+    maxDepth = depth;
+  std::vector<TokenLineage::SliceEntry> slice =
+      lineage.getSlice(*token, direction, maxDepth);
+
+  if (dotFile.empty()) {
+    printSlice(llvm::outs(), slice);
+    return 0;
+  }
+  return failed(printSliceDOT(llvm::outs(), slice)) ? 1 : 0;
+}
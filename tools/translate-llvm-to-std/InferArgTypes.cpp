@@ -42,10 +42,10 @@ Type ArgType::getMlirType(OpBuilder &builder, bool flattenArray) const {
       case LongDouble: baseMLIRElemType = builder.getF128Type(); break;
       // clang-format on
     case Elaborated:
-      assert(false &&
-             "Dynamatic currently cannot handle elaborated types (e.g., "
-             "struct, typedef, etc).");
-      break;
+      // Dynamatic currently cannot handle elaborated types (e.g., struct,
+      // typedef, etc).
+    case Unsupported:
+      return nullptr;
     }
   } else {
     baseMLIRElemType =
@@ -133,7 +133,8 @@ static std::optional<CXScalarType> processScalarType(CXType clangType) {
       width = std::stoi(match[1].str());
       return BitIntType{width, isUnsigned};
     }
-    llvm_unreachable("Unhandled CXType_Unexposed type!");
+    LLVM_DEBUG(llvm::errs() << "Unhandled CXType_Unexposed type: "
+                            << typeName << "\n");
     return std::nullopt;
   }
 
@@ -170,7 +171,15 @@ static std::optional<ArgType> fromCXType(CXType type) {
     return ArgType{*scalarType, {}, false};
   }
 
-  // Handle array type with constant sizes
+  // Handle array type with constant sizes, and pointers to them (e.g., int
+  // (*a)[8][8]), whose extent is fixed by the type of the pointee.
+  bool isPassedByReference = false;
+  if (type.kind == CXType_Pointer &&
+      clang_getPointeeType(type).kind == CXType_ConstantArray) {
+    type = clang_getPointeeType(type);
+    isPassedByReference = true;
+  }
+
   if (type.kind == CXType_ConstantArray) {
     std::vector<int64_t> arrayDimSizes;
     CXType arrayType = type;
@@ -182,7 +191,7 @@ static std::optional<ArgType> fromCXType(CXType type) {
 
     if (auto scalarType = processScalarType(arrayType);
         scalarType.has_value()) {
-      return ArgType{scalarType.value(), arrayDimSizes, false};
+      return ArgType{scalarType.value(), arrayDimSizes, isPassedByReference};
     }
   }
 
@@ -216,17 +225,15 @@ static CXChildVisitResult visitParamDecl(CXCursor cursor, CXCursor parent,
     CFuncArgs *args = reinterpret_cast<CFuncArgs *>(argsPtr);
     CXType type = clang_getCursorType(cursor);
 
-    auto argType = fromCXType(type);
-    if (argType.has_value()) {
-      args->push_back(argType.value());
-    } else {
-      LLVM_DEBUG(llvm::errs()
-                 << "Warning - unable to parse " << getCursorSpelling(cursor)
-                 << " with type "
-                 << clang_getCString(clang_getTypeSpelling(type)) << "!\n");
-    }
-    // else: Maybe instead of push nothing here, we should have a ArgType that
-    // is specifically for "I don't know what it is?"
+    // Arguments that we cannot parse are kept as unsupported, so that we can
+    // report them if the function gets translated.
+    ArgType argType =
+        fromCXType(type).value_or(ArgType{Unsupported, {}, false});
+    argType.name = getCursorSpelling(cursor);
+    CXString typeSpelling = clang_getTypeSpelling(type);
+    argType.typeSpelling = clang_getCString(typeSpelling);
+    clang_disposeString(typeSpelling);
+    args->push_back(argType);
 
 #ifdef LOG_CLANG_AST
     llvm::errs() << "Name " << getCursorSpelling(cursor) << "\n";
@@ -266,6 +273,8 @@ FuncNameToCFuncArgsMap inferArgTypes(const std::string &source,
       index, source.c_str(), args, 0, nullptr, 0, CXTranslationUnit_None);
   if (unit == nullptr) {
     llvm::errs() << "Unable to parse translation unit\n";
+    clang_disposeIndex(index);
+    return {};
   }
   CXCursor cursor = clang_getTranslationUnitCursor(unit);
 
@@ -280,12 +289,28 @@ FuncNameToCFuncArgsMap inferArgTypes(const std::string &source,
   return data;
 }
 
-SmallVector<Type> getFuncArgTypes(const std::string &funcName,
-                                  FuncNameToCFuncArgsMap map,
-                                  OpBuilder &builder) {
+FailureOr<SmallVector<Type>>
+getFuncArgTypes(const std::string &funcName, const FuncNameToCFuncArgsMap &map,
+                OpBuilder &builder, Location loc) {
+  auto funcArgs = map.find(funcName);
+  if (funcArgs == map.end())
+    return emitError(loc) << "cannot find the declaration of '" << funcName
+                          << "' in the C source";
+
   SmallVector<Type> mlirArgTypes;
-  for (const ArgType &clangType : map.at(funcName)) {
-    mlirArgTypes.push_back(clangType.getMlirType(builder, true));
+  for (const ArgType &clangType : funcArgs->second) {
+    Type mlirType = clangType.getMlirType(builder, true);
+    if (!mlirType) {
+      InFlightDiagnostic diag = emitError(loc)
+                                << "argument '" << clangType.name
+                                << "' has unsupported type '"
+                                << clangType.typeSpelling << "'";
+      if (StringRef(clangType.typeSpelling).contains('*'))
+        diag.attachNote() << "pointer arguments must have a fixed extent, "
+                             "e.g., 'int a[8]' or 'int (*a)[8]'";
+      return diag;
+    }
+    mlirArgTypes.push_back(mlirType);
   }
 
   return mlirArgTypes;
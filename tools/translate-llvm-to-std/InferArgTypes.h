@@ -25,6 +25,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/DerivedTypes.h"
+#include <string>
 #include <variant>
 
 using namespace mlir;
@@ -44,6 +45,8 @@ enum CXBuiltInScalarTypes {
   // Use this as a placeholder for all elaborated types. e.g., typedef, struct,
   // etc.
   Elaborated,
+  // Use this as a placeholder for all types that we do not know how to handle.
+  Unsupported,
 };
 
 /// Used to denote _BitInt(..)---a type introduced in C23.
@@ -63,14 +66,19 @@ using CXScalarType = std::variant<CXBuiltInScalarTypes, BitIntType>;
 /// element.
 /// - arrayDimensions: The size of each dimension of the constant sized array.
 /// Note that Dynamatic does not allow dynamically sized arrays.
-/// - isPassedByReference: not used now. But will be used to indicate whether
-/// the value is passed by reference in the future (we can (and probably should)
-/// use this to determine whether we return the value at the output).
+/// - isPassedByReference: whether the argument is a pointer to a constant sized
+/// array (e.g., int (*a)[8]). Will be used to determine whether we return the
+/// value at the output in the future.
+/// - name, typeSpelling: the name and the type of the argument as written in
+/// the C code, used to report unsupported arguments.
 struct ArgType {
   CXScalarType baseElemType;
   std::vector<int64_t> arrayDimensions;
   bool isPassedByReference;
+  std::string name = "";
+  std::string typeSpelling = "";
 
+  /// Returns a null type when the argument type is not supported.
   mlir::Type getMlirType(OpBuilder &builder, bool flattenArray) const;
 };
 
@@ -82,10 +90,11 @@ using CFuncArgs = SmallVector<ArgType>;
 using FuncNameToCFuncArgsMap = std::map<std::string, CFuncArgs>;
 
 /// \brief: Read the function arguments in the C source code, and convert them
-/// into the corresponding types in MLIR that we support.
-SmallVector<mlir::Type> getFuncArgTypes(const std::string &funcName,
-                                        FuncNameToCFuncArgsMap map,
-                                        OpBuilder &builder);
+/// into the corresponding types in MLIR that we support. Emits an error at
+/// `loc` and fails when one of the arguments has an unsupported type.
+FailureOr<SmallVector<mlir::Type>>
+getFuncArgTypes(const std::string &funcName, const FuncNameToCFuncArgsMap &map,
+                OpBuilder &builder, Location loc);
 
 /// \brief: for a given function "funcName", get the corresponding types that
 /// will be used in Dynamatic.
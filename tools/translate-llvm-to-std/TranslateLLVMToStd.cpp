@@ -15,6 +15,8 @@
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
@@ -25,7 +27,10 @@
 #include "llvm/IR/Value.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
 #include <cstdint>
+#include <optional>
+#include <utility>
 
 #include "dynamatic/Support/Attribute.h"
 #include "dynamatic/Support/MemoryDependency.h"
@@ -34,7 +39,8 @@
 
 #define DEBUG_TYPE "translate-llvm-to-std"
 
-/// Returns the corresponding scalar MLIR Type from a given LLVM type
+/// Returns the corresponding scalar MLIR Type from a given LLVM type, or a null
+/// type if the LLVM type has no MLIR counterpart (e.g., pointers).
 static mlir::Type getMLIRType(llvm::Type *llvmType,
                               mlir::MLIRContext *context) {
   if (llvmType->isIntegerTy()) {
@@ -53,11 +59,39 @@ static mlir::Type getMLIRType(llvm::Type *llvmType,
                     "type is not currently supported\n";
     return mlir::FloatType::getF80(context);
   }
-  if (llvmType->isPointerTy())
-    llvm::report_fatal_error("Pointer values are unsupported");
   LLVM_DEBUG(llvm::errs() << "Unhandled LLVM scalar type:\n";);
+  return nullptr;
+}
+
+/// Returns the textual LLVM IR of the given LLVM type or value.
+template <typename T>
+static std::string printToString(const T &llvmObj) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  llvmObj.print(os);
+  return StringRef(str).trim().str();
+}
 
-  llvm::report_fatal_error("Unhandled scalar type");
+/// Returns the type of the elements of an aggregate type that can be laid out
+/// as an array in memory: an array, or a struct whose fields all have the same
+/// type (e.g., struct { int re; int im; }). Returns nullptr for other types.
+static llvm::Type *getArrayLikeElementType(llvm::Type *type) {
+  if (type->isArrayTy())
+    return type->getArrayElementType();
+  if (auto *structType = dyn_cast<llvm::StructType>(type);
+      structType && !structType->isOpaque() &&
+      structType->getNumElements() > 0 &&
+      llvm::all_equal(structType->elements()))
+    return structType->getElementType(0);
+  return nullptr;
+}
+
+/// Returns the number of elements of a type for which getArrayLikeElementType
+/// returns an element type.
+static int64_t getArrayLikeNumElements(llvm::Type *type) {
+  if (type->isArrayTy())
+    return type->getArrayNumElements();
+  return type->getStructNumElements();
 }
 
 /// NOTE: This is taken literally from "mlir/lib/Target/LLVMIR/ModuleImport.cpp"
@@ -104,7 +138,7 @@ static void translateMemDepAndNameAttrs(llvm::Instruction *inst, Operation *op,
   }
 }
 
-static void
+static LogicalResult
 convertInitializerToDenseElemAttrRecursive(llvm::Constant *constValue,
                                            SmallVector<mlir::Attribute> &values,
                                            const mlir::Type &baseMLIRElemType);
@@ -115,7 +149,8 @@ convertInitializerToDenseElemAttrRecursive(llvm::Constant *constValue,
 //
 // Converts a LLVM IR multidimension array initialization constant data into an
 // 1D MLIR dense array in row major. This function recursively visits the
-// dimensions and push the scalar elements into a flat array (values).
+// dimensions and push the scalar elements into a flat array (values). Returns
+// a null attribute if the initializer contains unhandled constants.
 static DenseElementsAttr
 convertInitializerToDenseElemAttr(llvm::GlobalVariable *globVar,
                                   MLIRContext *ctx) {
@@ -131,38 +166,71 @@ convertInitializerToDenseElemAttr(llvm::GlobalVariable *globVar,
   auto baseMLIRElemType = getMLIRType(baseElementType, ctx);
   SmallVector<mlir::Attribute> values;
   values.reserve(numElems);
-  convertInitializerToDenseElemAttrRecursive(globVar->getInitializer(), values,
-                                             baseMLIRElemType);
+  if (!baseMLIRElemType ||
+      failed(convertInitializerToDenseElemAttrRecursive(
+          globVar->getInitializer(), values, baseMLIRElemType)))
+    return nullptr;
 
   return mlir::DenseElementsAttr::get(
       mlir::RankedTensorType::get(/*shape = */ {numElems}, baseMLIRElemType),
       values);
 }
 
-void convertInitializerToDenseElemAttrRecursive(
+LogicalResult convertInitializerToDenseElemAttrRecursive(
     llvm::Constant *constValue, SmallVector<mlir::Attribute> &values,
     const mlir::Type &baseMLIRElemType) {
-  auto *arrType = llvm::dyn_cast<llvm::ArrayType>(constValue->getType());
-  for (unsigned i = 0; i < arrType->getNumElements(); ++i) {
-    auto *elem = constValue->getAggregateElement(i);
-    if (auto *constInt = llvm::dyn_cast<llvm::ConstantInt>(elem)) {
-      values.push_back(
-          mlir::IntegerAttr::get(baseMLIRElemType, constInt->getSExtValue()));
-    } else if (auto *constFloat = llvm::dyn_cast<llvm::ConstantFP>(elem)) {
-      values.push_back(
-          mlir::FloatAttr::get(baseMLIRElemType, constFloat->getValueAPF()));
-    } else if (llvm::isa<llvm::ConstantDataArray>(elem)) {
-      convertInitializerToDenseElemAttrRecursive(elem, values,
-                                                 baseMLIRElemType);
-    } else {
-      llvm::errs() << "Unhandled constant element type:\n";
-      llvm::report_fatal_error("Unhandled base element type.");
+  if (auto *constInt = llvm::dyn_cast<llvm::ConstantInt>(constValue)) {
+    values.push_back(
+        mlir::IntegerAttr::get(baseMLIRElemType, constInt->getSExtValue()));
+    return success();
+  }
+  if (auto *constFloat = llvm::dyn_cast<llvm::ConstantFP>(constValue)) {
+    values.push_back(
+        mlir::FloatAttr::get(baseMLIRElemType, constFloat->getValueAPF()));
+    return success();
+  }
+  // Arrays may be given as constant data, as constant aggregates, or as
+  // "zeroinitializer"; all of them provide their elements the same way.
+  if (auto *arrType = llvm::dyn_cast<llvm::ArrayType>(constValue->getType())) {
+    for (unsigned i = 0; i < arrType->getNumElements(); ++i) {
+      llvm::Constant *elem = constValue->getAggregateElement(i);
+      if (!elem || failed(convertInitializerToDenseElemAttrRecursive(
+                       elem, values, baseMLIRElemType)))
+        return failure();
     }
+    return success();
   }
+  LLVM_DEBUG(llvm::errs() << "Unhandled constant element type:\n";);
+  return failure();
+}
+
+Location TranslateLLVMToStd::getLoc(llvm::Function *llvmFunc) {
+  if (llvm::DISubprogram *subprogram = llvmFunc->getSubprogram())
+    return FileLineColLoc::get(ctx, subprogram->getFilename(),
+                               subprogram->getLine(), 0);
+  // Without debug information, we can only point to the C source file.
+  return NameLoc::get(
+      StringAttr::get(ctx, llvmFunc->getName()),
+      FileLineColLoc::get(ctx, llvmModule->getSourceFileName(), 0, 0));
+}
+
+Location TranslateLLVMToStd::getLoc(llvm::Instruction *inst) {
+  if (const llvm::DebugLoc &debugLoc = inst->getDebugLoc())
+    return FileLineColLoc::get(ctx, debugLoc->getFilename(), debugLoc.getLine(),
+                               debugLoc.getCol());
+  return getLoc(inst->getFunction());
+}
+
+InFlightDiagnostic TranslateLLVMToStd::emitError(llvm::Instruction *inst) {
+  InFlightDiagnostic diag = mlir::emitError(getLoc(inst));
+  diag.attachNote() << "while translating LLVM instruction: "
+                    << printToString(*inst);
+  return diag;
 }
 
-void TranslateLLVMToStd::translateLLVMModule() {
-  translateGlobalVars();
+LogicalResult TranslateLLVMToStd::translateLLVMModule() {
+  if (failed(translateGlobalVars()))
+    return failure();
 
   for (auto &f : llvmModule->functions()) {
     if (f.isDeclaration())
@@ -171,28 +239,40 @@ void TranslateLLVMToStd::translateLLVMModule() {
     if (f.getName() != funcName)
       continue;
 
-    translateFunction(&f);
+    return translateFunction(&f);
   }
+
+  return mlir::emitError(UnknownLoc::get(ctx))
+         << "cannot find function '" << funcName << "' in the LLVM IR";
 }
 
-void TranslateLLVMToStd::translateFunction(llvm::Function *llvmFunc) {
+LogicalResult TranslateLLVMToStd::translateFunction(llvm::Function *llvmFunc) {
 
-  SmallVector<mlir::Type> argTypes =
-      getFuncArgTypes(llvmFunc->getName().str(), argMap, builder);
+  FailureOr<SmallVector<mlir::Type>> argTypes = getFuncArgTypes(
+      llvmFunc->getName().str(), argMap, builder, getLoc(llvmFunc));
+  if (failed(argTypes))
+    return failure();
 
   builder.setInsertionPointToEnd(mlirModule.getBody());
 
   SmallVector<mlir::Type> resTypes;
 
   if (!llvmFunc->getReturnType()->isVoidTy()) {
-    resTypes.push_back(getMLIRType(llvmFunc->getReturnType(), ctx));
+    mlir::Type resType = getMLIRType(llvmFunc->getReturnType(), ctx);
+    if (!resType)
+      return mlir::emitError(getLoc(llvmFunc))
+             << "function '" << llvmFunc->getName()
+             << "' has unsupported return type '"
+             << printToString(*llvmFunc->getReturnType()) << "'";
+    resTypes.push_back(resType);
   }
 
-  auto funcType = builder.getFunctionType(argTypes, resTypes);
-  auto funcOp = builder.create<func::FuncOp>(builder.getUnknownLoc(),
+  auto funcType = builder.getFunctionType(*argTypes, resTypes);
+  auto funcOp = builder.create<func::FuncOp>(getLoc(llvmFunc),
                                              llvmFunc->getName(), funcType);
 
-  initializeBlocksAndBlockMapping(llvmFunc, funcOp);
+  if (failed(initializeBlocksAndBlockMapping(llvmFunc, funcOp)))
+    return failure();
 
   auto &entryBlock = funcOp.getBody().front();
   builder.setInsertionPointToStart(&entryBlock);
@@ -205,12 +285,16 @@ void TranslateLLVMToStd::translateFunction(llvm::Function *llvmFunc) {
   for (auto *block : blocks) {
     builder.setInsertionPointToEnd(blockMap[block]);
     for (auto &inst : *block) {
-      translateInstruction(&inst);
+      if (failed(translateInstruction(&inst)))
+        return failure();
     }
   }
+
+  addMemIntrinsicDependencies(funcOp);
+  return success();
 }
 
-void TranslateLLVMToStd::translateGlobalVars() {
+LogicalResult TranslateLLVMToStd::translateGlobalVars() {
   builder.setInsertionPointToEnd(mlirModule.getBody());
   for (auto &constant : llvmModule->global_values()) {
 
@@ -219,6 +303,8 @@ void TranslateLLVMToStd::translateGlobalVars() {
     if (!globalVar || /* e.g., stderr */ globalVar->isDeclaration())
       continue;
 
+    Location loc = NameLoc::get(StringAttr::get(ctx, constant.getName()));
+
     auto *baseElemType = globalVar->getValueType();
     int64_t numElements = 1;
     while (baseElemType->isArrayTy()) {
@@ -227,6 +313,11 @@ void TranslateLLVMToStd::translateGlobalVars() {
     }
 
     auto baseMLIRElemType = getMLIRType(baseElemType, ctx);
+    if (!baseMLIRElemType)
+      return mlir::emitError(loc)
+             << "global variable '" << constant.getName()
+             << "' has unsupported type '"
+             << printToString(*globalVar->getValueType()) << "'";
     auto memrefType =
         MemRefType::get(/* shape = */ {numElements}, baseMLIRElemType);
 
@@ -242,11 +333,15 @@ void TranslateLLVMToStd::translateGlobalVars() {
 
     if (globalVar->hasInitializer()) {
       initialValueAttr = convertInitializerToDenseElemAttr(globalVar, ctx);
+      if (!initialValueAttr)
+        return mlir::emitError(loc)
+               << "cannot translate the initializer of global variable '"
+               << constant.getName() << "'";
     }
 
     auto globalOp = builder.create<memref::GlobalOp>(
         // clang-format off
-        UnknownLoc::get(ctx),
+        loc,
         symNameAttr,
         visibilityAttr,
         typeAttr,
@@ -257,24 +352,35 @@ void TranslateLLVMToStd::translateGlobalVars() {
     );
     globalValToGlobalOpMap[&constant] = globalOp;
   }
+  return success();
 }
 
-void TranslateLLVMToStd::translateInstruction(llvm::Instruction *inst) {
-  Location loc = UnknownLoc::get(ctx);
+LogicalResult
+TranslateLLVMToStd::translateInstruction(llvm::Instruction *inst) {
+  Location loc = getLoc(inst);
+
+  // Apart from the pointers produced by allocas and GEPs (which are translated
+  // to memrefs and indices), values must have a scalar type.
+  if (!inst->getType()->isVoidTy() &&
+      !isa<llvm::GetElementPtrInst, llvm::AllocaInst>(inst) &&
+      !getMLIRType(inst->getType(), ctx))
+    return emitError(inst) << "unsupported value type '"
+                           << printToString(*inst->getType()) << "'";
+
   if (auto *binaryOp = dyn_cast<llvm::BinaryOperator>(inst)) {
-    translateBinaryInst(binaryOp);
+    return translateBinaryInst(binaryOp);
   } else if (auto *castOp = dyn_cast<llvm::CastInst>(inst)) {
-    translateCastInst(castOp);
+    return translateCastInst(castOp);
   } else if (auto *gepInst = dyn_cast<llvm::GetElementPtrInst>(inst)) {
-    translateGEPInst(gepInst);
+    return translateGEPInst(gepInst);
   } else if (auto *loadInst = dyn_cast<llvm::LoadInst>(inst)) {
-    translateLoadInst(loadInst);
+    return translateLoadInst(loadInst);
   } else if (auto *storeInst = dyn_cast<llvm::StoreInst>(inst)) {
-    translateStoreInst(storeInst);
+    return translateStoreInst(storeInst);
   } else if (auto *icmpInst = dyn_cast<llvm::ICmpInst>(inst)) {
-    translateICmpInst(icmpInst);
+    return translateICmpInst(icmpInst);
   } else if (auto *fcmpInst = dyn_cast<FCmpInst>(inst)) {
-    translateFCmpInst(fcmpInst);
+    return translateFCmpInst(fcmpInst);
   } else if (auto *selInst = dyn_cast<llvm::SelectInst>(inst)) {
     mlir::Value condition = valueMap[selInst->getOperand(0)];
     mlir::Value trueOperand = valueMap[selInst->getOperand(1)];
@@ -288,9 +394,11 @@ void TranslateLLVMToStd::translateInstruction(llvm::Instruction *inst) {
         // clang-format on
     );
   } else if (auto *branchInst = dyn_cast<llvm::BranchInst>(inst)) {
-    translateBranchInst(branchInst);
+    return translateBranchInst(branchInst);
+  } else if (auto *switchInst = dyn_cast<llvm::SwitchInst>(inst)) {
+    return translateSwitchInst(switchInst);
   } else if (auto *allocaOp = dyn_cast<llvm::AllocaInst>(inst)) {
-    translateAllocaInst(allocaOp);
+    return translateAllocaInst(allocaOp);
   } else if (auto *returnOp = dyn_cast<llvm::ReturnInst>(inst)) {
     if (returnOp->getNumOperands() == 1) {
       mlir::Value arg = valueMap[inst->getOperand(0)];
@@ -300,15 +408,24 @@ void TranslateLLVMToStd::translateInstruction(llvm::Instruction *inst) {
     }
   } else if (isa<llvm::PHINode>(inst)) {
     // At this stage, Phi nodes are all converted to the block arguments
-    return;
+    return success();
   } else if (auto *callInst = dyn_cast<llvm::CallInst>(inst)) {
-    translateCallInst(callInst);
+    return translateCallInst(callInst);
   } else if (inst->getOpcode() == Instruction::FNeg) {
     naiveTranslation<arith::NegFOp>(getMLIRType(inst->getType(), ctx),
                                     valueMap[inst->getOperand(0)], inst);
+  } else if (isa<llvm::FreezeInst>(inst)) {
+    // We do not model poison values: freezing a value is the value itself.
+    mlir::Value operand = valueMap[inst->getOperand(0)];
+    if (!operand)
+      operand = builder.create<LLVM::UndefOp>(
+          loc, getMLIRType(inst->getType(), ctx));
+    valueMap[inst] = operand;
   } else {
-    llvm_unreachable("Not implemented");
+    return emitError(inst) << "unsupported instruction '"
+                           << inst->getOpcodeName() << "'";
   }
+  return success();
 }
 
 SmallVector<mlir::Value>
@@ -330,7 +447,7 @@ TranslateLLVMToStd::getBranchOperandsForCFGEdge(BasicBlock *currBB,
   return operands;
 }
 
-void TranslateLLVMToStd::initializeBlocksAndBlockMapping(
+LogicalResult TranslateLLVMToStd::initializeBlocksAndBlockMapping(
     llvm::Function *llvmFunc, func::FuncOp funcOp) {
   // Convert the entry block (specially handled, because its arguments are also
   // the function arguments). NOTE: "funcOp.addEntryBlock()" automatically adds
@@ -341,9 +458,10 @@ void TranslateLLVMToStd::initializeBlocksAndBlockMapping(
   blockMap[&entryBB] = entryBlock;
 
   if (llvmFunc->arg_size() != entryBlock->getNumArguments()) {
-    llvm_unreachable(
-        "Inferred fewer arguments for MLIR function! The original "
-        "C function potentially contains unhandled argument types.");
+    return mlir::emitError(getLoc(llvmFunc))
+           << "inferred " << entryBlock->getNumArguments()
+           << " arguments from the C source but the LLVM function has "
+           << llvmFunc->arg_size();
   }
 
   for (auto [llvmArg, mlirArg] :
@@ -358,10 +476,14 @@ void TranslateLLVMToStd::initializeBlocksAndBlockMapping(
     blockMap[&bb] = block;
     for (auto &phi : bb.phis()) {
       auto argType = getMLIRType(phi.getType(), ctx);
+      if (!argType)
+        return emitError(&phi) << "unsupported value type '"
+                               << printToString(*phi.getType()) << "'";
       auto mlirArg = block->addArgument(argType, mlir::UnknownLoc::get(ctx));
       valueMap[&phi] = mlirArg;
     }
   }
+  return success();
 }
 
 void TranslateLLVMToStd::createConstants(llvm::Function *llvmFunc) {
@@ -429,7 +551,8 @@ void TranslateLLVMToStd::createGetGlobals(llvm::Function *llvmFunc) {
   }
 }
 
-void TranslateLLVMToStd::translateBinaryInst(llvm::BinaryOperator *inst) {
+LogicalResult
+TranslateLLVMToStd::translateBinaryInst(llvm::BinaryOperator *inst) {
   mlir::Value lhs = valueMap[inst->getOperand(0)];
   mlir::Value rhs = valueMap[inst->getOperand(1)];
   mlir::Type resType = getMLIRType(inst->getType(), ctx);
@@ -453,15 +576,14 @@ void TranslateLLVMToStd::translateBinaryInst(llvm::BinaryOperator *inst) {
     case Instruction::Or:   naiveTranslation<arith::OrIOp>( resType, {lhs, rhs}, inst); break;
     case Instruction::Xor:  naiveTranslation<arith::XOrIOp>( resType, {lhs, rhs}, inst); break;
     // clang-format on
-  default: {
-    llvm::errs() << "Not yet handled binary operation type "
-                 << inst->getOpcodeName() << "\n";
-    llvm_unreachable("Not handled operation type");
-  }
+  default:
+    return emitError(inst) << "unsupported binary operation '"
+                           << inst->getOpcodeName() << "'";
   }
+  return success();
 }
 
-void TranslateLLVMToStd::translateCastInst(llvm::CastInst *inst) {
+LogicalResult TranslateLLVMToStd::translateCastInst(llvm::CastInst *inst) {
   mlir::Value arg = valueMap[inst->getOperand(0)];
   mlir::Type resType = getMLIRType(inst->getType(), ctx);
 
@@ -477,15 +599,14 @@ void TranslateLLVMToStd::translateCastInst(llvm::CastInst *inst) {
     case Instruction::FPToUI:  naiveTranslation<arith::FPToUIOp>( resType, {arg}, inst); break;
     case Instruction::UIToFP:  naiveTranslation<arith::UIToFPOp>( resType, {arg}, inst); break;
     // clang-format on
-  default: {
-    llvm::errs() << "Not yet handled unary operation type "
-                 << inst->getOpcodeName() << "\n";
-    llvm_unreachable("Not implemented");
-  }
+  default:
+    return emitError(inst) << "unsupported cast operation '"
+                           << inst->getOpcodeName() << "'";
   }
+  return success();
 }
 
-void TranslateLLVMToStd::translateICmpInst(llvm::ICmpInst *inst) {
+LogicalResult TranslateLLVMToStd::translateICmpInst(llvm::ICmpInst *inst) {
   mlir::Value lhs = valueMap[inst->getOperand(0)];
   mlir::Value rhs = valueMap[inst->getOperand(1)];
   arith::CmpIPredicate predicate;
@@ -502,16 +623,17 @@ void TranslateLLVMToStd::translateICmpInst(llvm::ICmpInst *inst) {
     case llvm::CmpInst::Predicate::ICMP_SLT: predicate = arith::CmpIPredicate::slt; break;
     case llvm::CmpInst::Predicate::ICMP_SLE: predicate = arith::CmpIPredicate::sle; break;
 
-    default: llvm_unreachable("Unsupported ICMP predicate");
     // clang-format on
+  default:
+    return emitError(inst) << "unsupported integer comparison predicate";
   }
 
-  auto op =
-      builder.create<arith::CmpIOp>(UnknownLoc::get(ctx), predicate, lhs, rhs);
+  auto op = builder.create<arith::CmpIOp>(getLoc(inst), predicate, lhs, rhs);
   valueMap[inst] = op->getResult(0);
+  return success();
 }
 
-void TranslateLLVMToStd::translateFCmpInst(llvm::FCmpInst *inst) {
+LogicalResult TranslateLLVMToStd::translateFCmpInst(llvm::FCmpInst *inst) {
   mlir::Value lhs = valueMap[inst->getOperand(0)];
   mlir::Value rhs = valueMap[inst->getOperand(1)];
   arith::CmpFPredicate predicate;
@@ -534,15 +656,63 @@ void TranslateLLVMToStd::translateFCmpInst(llvm::FCmpInst *inst) {
     case llvm::CmpInst::FCMP_FALSE: predicate = arith::CmpFPredicate::AlwaysFalse; break;
     case llvm::CmpInst::FCMP_TRUE:  predicate = arith::CmpFPredicate::AlwaysTrue; break;
 
-    default: llvm_unreachable("Unsupported FCMP predicate");
     // clang-format on
+  default:
+    return emitError(inst) << "unsupported floating-point comparison predicate";
   }
-  auto op =
-      builder.create<arith::CmpFOp>(UnknownLoc::get(ctx), predicate, lhs, rhs);
+  auto op = builder.create<arith::CmpFOp>(getLoc(inst), predicate, lhs, rhs);
   valueMap[inst] = op->getResult(0);
+  return success();
 }
 
-void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
+LogicalResult
+TranslateLLVMToStd::checkPointerToArrayAccess(llvm::GetElementPtrInst *gepInst,
+                                              mlir::Value memref) {
+  auto *arg = dyn_cast<llvm::Argument>(gepInst->getPointerOperand());
+  if (!arg || gepInst->getNumIndices() == 0)
+    return success();
+  auto funcArgs = argMap.find(arg->getParent()->getName().str());
+  if (funcArgs == argMap.end())
+    return success();
+  const ArgType &argType = funcArgs->second[arg->getArgNo()];
+  if (!argType.isPassedByReference)
+    return success();
+
+  // Indexing into the pointee (e.g., (*a)[i] or a[0][i]) starts with a zero
+  // index, whereas an access through the scalar element type (e.g., after
+  // the leading zero index was folded) is a flattened offset into the pointee
+  auto *leadingIdx = dyn_cast<ConstantInt>(gepInst->getOperand(1));
+  bool inBounds;
+  if (getArrayLikeElementType(gepInst->getSourceElementType())) {
+    inBounds = leadingIdx && leadingIdx->isZero();
+  } else {
+    auto memrefType = cast<MemRefType>(memref.getType());
+    int64_t memrefBits =
+        memrefType.getNumElements() * memrefType.getElementTypeBitWidth();
+    int64_t gepElemBits = gepInst->getSourceElementType()
+                              ->getPrimitiveSizeInBits()
+                              .getFixedValue();
+    // Dynamic offsets cannot be checked here
+    inBounds = !leadingIdx || gepElemBits == 0 ||
+               (leadingIdx->getSExtValue() >= 0 &&
+                leadingIdx->getSExtValue() * gepElemBits < memrefBits);
+  }
+  if (inBounds)
+    return success();
+
+  InFlightDiagnostic diag = emitError(gepInst)
+                            << "access outside of the array pointed to by "
+                               "argument '"
+                            << argType.name << "' of type '"
+                            << argType.typeSpelling << "'";
+  diag.attachNote() << "the argument is translated to an array of the "
+                       "pointee's extent; declare it with the extent of all "
+                       "accessed elements instead, e.g., 'int a[4][8]'";
+  return diag;
+}
+
+LogicalResult
+TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
 
   // The GEP instruction calculates the index that the load/store need to use
   // the access memory.
@@ -565,12 +735,18 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
   llvm::Type *baseElementType = gepInst->getSourceElementType();
 
   // Get the dimensions of the original array from the function type.
-  // For the example above, it would be {A, B, C, D}
+  // For the example above, it would be {A, B, C, D}. Structs whose fields all
+  // have the same type are accessed like arrays.
   SmallVector<int64_t> multipliers;
-  while (baseElementType->isArrayTy()) {
-    multipliers.push_back(baseElementType->getArrayNumElements());
-    baseElementType = baseElementType->getArrayElementType();
+  while (llvm::Type *elemType = getArrayLikeElementType(baseElementType)) {
+    multipliers.push_back(getArrayLikeNumElements(baseElementType));
+    baseElementType = elemType;
   }
+  if (baseElementType->isAggregateType())
+    return emitError(gepInst) << "unsupported access into a value of type '"
+                              << printToString(*baseElementType)
+                              << "'; only arrays and structs whose fields all "
+                                 "have the same type are supported";
 
   SmallVector<llvm::Value *> gepIndices(gepInst->indices());
 
@@ -586,6 +762,11 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
     // assumption). The base address is the result of the previous GEP.
     baseAddress = valueMap[gepInst->getPointerOperand()];
   }
+  if (!baseAddress || !isa<MemRefType>(baseAddress.getType()))
+    return emitError(gepInst)
+           << "cannot determine the array accessed by the pointer";
+  if (failed(checkPointerToArrayAccess(gepInst, baseAddress)))
+    return failure();
   this->getInstToMemRefMap[gepInst] = baseAddress;
 
   // A list of value to be accumulated. For the example above:
@@ -596,6 +777,15 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
   for (size_t i = 0; i < gepIndices.size(); ++i) {
     mlir::Value mlirIndexValue = valueMap[gepIndices[i]];
 
+    // Struct field indices are i32 constants, whereas we compute the
+    // flattened index on i64.
+    if (auto *constIdx = dyn_cast<ConstantInt>(gepIndices[i]);
+        constIdx && !constIdx->getType()->isIntegerTy(64)) {
+      mlirIndexValue = builder.create<arith::ConstantOp>(
+          getLoc(gepInst),
+          builder.getI64IntegerAttr(constIdx->getSExtValue()));
+    }
+
     // Calculate the partitial index
     int64_t coeff = 1;
     for (size_t j = i; j < multipliers.size(); j++)
@@ -611,8 +801,7 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
         // Here we are using GEP to advance 4 * i8 = 32 bits. If the
         // element of the original array was 32-bit wide, then here we need to
         // increment 1 step (instead of 4).
-        auto memrefType = dyn_cast<MemRefType>(baseAddress.getType());
-        assert(memrefType);
+        auto memrefType = cast<MemRefType>(baseAddress.getType());
 
         // This is the size of the actual element (i.e., for 32 in the example
         // above).
@@ -627,9 +816,11 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
         // (i.e., 4 in the example above).
         int64_t constInt = *constVal->getUniqueInteger().getRawData();
 
-        assert((currBaseElementBitWidth * constInt) % actualBaseElementWidth ==
-                   0 &&
-               "Incorrect alignment!");
+        if ((currBaseElementBitWidth * constInt) % actualBaseElementWidth != 0)
+          return emitError(gepInst)
+                 << "pointer offset of " << currBaseElementBitWidth * constInt
+                 << " bits is not aligned to the array elements of "
+                 << actualBaseElementWidth << " bits";
 
         unsigned actualAdvanceValue =
             (currBaseElementBitWidth * constInt) / actualBaseElementWidth;
@@ -688,9 +879,10 @@ void TranslateLLVMToStd::translateGEPInst(llvm::GetElementPtrInst *gepInst) {
   // [END accumulate the array index]
 
   valueMap[gepInst] = accumulatedArrayIndex;
+  return success();
 }
 
-void TranslateLLVMToStd::translateBranchInst(llvm::BranchInst *inst) {
+LogicalResult TranslateLLVMToStd::translateBranchInst(llvm::BranchInst *inst) {
   BasicBlock *currLLVMBB = inst->getParent();
   Location loc = UnknownLoc::get(ctx);
   if (inst->isUnconditional()) {
@@ -730,9 +922,64 @@ void TranslateLLVMToStd::translateBranchInst(llvm::BranchInst *inst) {
         // clang-format on
     );
   }
+  return success();
 }
 
-void TranslateLLVMToStd::translateLoadInst(llvm::LoadInst *loadInst) {
+LogicalResult TranslateLLVMToStd::translateSwitchInst(llvm::SwitchInst *inst) {
+  // A switch is converted into a chain of conditional branches, each comparing
+  // the condition with one case value. The chain starts in the block of the
+  // switch and continues in new blocks; the last one branches to the default
+  // destination:
+  //
+  // ^bb0: cond_br (cond == c0), ^case0, ^bb0.1
+  // ^bb0.1: cond_br (cond == c1), ^case1, ^default
+  BasicBlock *currLLVMBB = inst->getParent();
+  Location loc = getLoc(inst);
+  mlir::Value condition = valueMap[inst->getCondition()];
+
+  // NOTE: The branch operands must be created in the block of the switch, so
+  // that they dominate all the blocks of the chain.
+  BasicBlock *defaultBB = inst->getDefaultDest();
+  SmallVector<mlir::Value> defaultOperands =
+      getBranchOperandsForCFGEdge(currLLVMBB, defaultBB);
+  SmallVector<std::pair<llvm::ConstantInt *, BasicBlock *>> cases;
+  SmallVector<SmallVector<mlir::Value>> caseOperands;
+  for (auto caseIt : inst->cases()) {
+    cases.emplace_back(caseIt.getCaseValue(), caseIt.getCaseSuccessor());
+    caseOperands.push_back(
+        getBranchOperandsForCFGEdge(currLLVMBB, caseIt.getCaseSuccessor()));
+  }
+
+  if (cases.empty()) {
+    builder.create<cf::BranchOp>(loc, blockMap[defaultBB], defaultOperands);
+    return success();
+  }
+
+  for (auto [idx, caseAndDest] : llvm::enumerate(cases)) {
+    auto [caseValue, caseBB] = caseAndDest;
+    auto isCase = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, condition, valueMap[caseValue]);
+
+    if (idx == cases.size() - 1) {
+      builder.create<cf::CondBranchOp>(loc, isCase, blockMap[caseBB],
+                                       caseOperands[idx], blockMap[defaultBB],
+                                       defaultOperands);
+      break;
+    }
+
+    Block *currBlock = builder.getBlock();
+    Block *nextBlock = new Block();
+    currBlock->getParent()->getBlocks().insertAfter(
+        Region::iterator(currBlock), nextBlock);
+    builder.create<cf::CondBranchOp>(loc, isCase, blockMap[caseBB],
+                                     caseOperands[idx], nextBlock,
+                                     ValueRange{});
+    builder.setInsertionPointToEnd(nextBlock);
+  }
+  return success();
+}
+
+LogicalResult TranslateLLVMToStd::translateLoadInst(llvm::LoadInst *loadInst) {
   auto *instAddr = loadInst->getPointerOperand();
   mlir::Value memref;
   mlir::Value index = valueMap[loadInst->getPointerOperand()];
@@ -746,20 +993,23 @@ void TranslateLLVMToStd::translateLoadInst(llvm::LoadInst *loadInst) {
     indexOp = builder.create<arith::IndexCastOp>(UnknownLoc::get(ctx),
                                                  builder.getIndexType(), index);
   } else {
-    assert(isa<MemRefType>(index.getType()));
+    if (!index || !isa<MemRefType>(index.getType()))
+      return emitError(loadInst)
+             << "cannot determine the array accessed by the load";
     memref = index;
     indexOp = builder.create<arith::ConstantOp>(UnknownLoc::get(ctx),
                                                 builder.getIndexAttr(0));
   }
 
-  auto newOp =
-      builder.create<memref::LoadOp>(UnknownLoc::get(ctx), resType, memref,
-                                     /*indices = */ indexOp);
+  auto newOp = builder.create<memref::LoadOp>(getLoc(loadInst), resType, memref,
+                                              /*indices = */ indexOp);
   valueMap[loadInst] = newOp.getResult();
   translateMemDepAndNameAttrs(loadInst, newOp, *ctx, builder);
+  return success();
 }
 
-void TranslateLLVMToStd::translateStoreInst(llvm::StoreInst *storeInst) {
+LogicalResult
+TranslateLLVMToStd::translateStoreInst(llvm::StoreInst *storeInst) {
   auto *instAddr = storeInst->getPointerOperand();
   mlir::Value memref;
   mlir::Value index = valueMap[storeInst->getPointerOperand()];
@@ -772,140 +1022,345 @@ void TranslateLLVMToStd::translateStoreInst(llvm::StoreInst *storeInst) {
     indexOp = builder.create<arith::IndexCastOp>(UnknownLoc::get(ctx),
                                                  builder.getIndexType(), index);
   } else {
-    assert(isa<MemRefType>(index.getType()));
+    if (!index || !isa<MemRefType>(index.getType()))
+      return emitError(storeInst)
+             << "cannot determine the array accessed by the store";
     memref = index;
     indexOp = builder.create<arith::ConstantOp>(UnknownLoc::get(ctx),
                                                 builder.getIndexAttr(0));
   }
 
   mlir::Value storeValue = valueMap[storeInst->getValueOperand()];
+  if (!storeValue)
+    return emitError(storeInst) << "unsupported stored value";
   auto newOp =
-      builder.create<memref::StoreOp>(UnknownLoc::get(ctx), storeValue, memref,
+      builder.create<memref::StoreOp>(getLoc(storeInst), storeValue, memref,
                                       /*indices = */ indexOp);
   translateMemDepAndNameAttrs(storeInst, newOp, *ctx, builder);
+  return success();
 }
 
-void TranslateLLVMToStd::translateAllocaInst(llvm::AllocaInst *allocaInst) {
-  Location loc = UnknownLoc::get(ctx);
+LogicalResult
+TranslateLLVMToStd::translateAllocaInst(llvm::AllocaInst *allocaInst) {
+  Location loc = getLoc(allocaInst);
 
-  // flatten the MD array into 1D
+  // flatten the MD array into 1D. Structs whose fields all have the same type
+  // are flattened like arrays.
   int64_t arraySize = 1;
   llvm::Type *baseElementType = allocaInst->getAllocatedType();
 
-  while (baseElementType->isArrayTy()) {
-    arraySize *= baseElementType->getArrayNumElements();
-    baseElementType = baseElementType->getArrayElementType();
+  while (llvm::Type *elemType = getArrayLikeElementType(baseElementType)) {
+    arraySize *= getArrayLikeNumElements(baseElementType);
+    baseElementType = elemType;
   }
 
-  assert(arraySize > 0 && "The size of the array must be positive!");
+  if (auto *numElements =
+          dyn_cast<llvm::ConstantInt>(allocaInst->getArraySize()))
+    arraySize *= numElements->getSExtValue();
+  else
+    return emitError(allocaInst) << "unsupported dynamically sized allocation";
+
+  if (arraySize <= 0)
+    return emitError(allocaInst) << "the size of the array must be positive";
+
+  mlir::Type baseMLIRElemType = getMLIRType(baseElementType, ctx);
+  if (!baseMLIRElemType) {
+    InFlightDiagnostic diag = emitError(allocaInst)
+                              << "unsupported allocation of type '"
+                              << printToString(*baseElementType) << "'";
+    if (baseElementType->isStructTy())
+      diag.attachNote() << "only structs whose fields all have the same type "
+                           "are supported";
+    return diag;
+  }
 
-  auto memrefType = MemRefType::get(/*shape =*/{arraySize},
-                                    getMLIRType(baseElementType, ctx));
+  auto memrefType = MemRefType::get(/*shape =*/{arraySize}, baseMLIRElemType);
 
   auto allocaOp = builder.create<memref::AllocaOp>(loc, memrefType);
   valueMap[allocaInst] = allocaOp->getResult(0);
+  return success();
 }
 
-void TranslateLLVMToStd::translateMemsetIntrinsic(llvm::CallInst *callInst) {
-  Function *calledFunc = callInst->getCalledFunction();
-  assert(calledFunc);
-  assert(calledFunc->getIntrinsicID() == Intrinsic::memset);
-  // -- Semantic of the memset intrinsic: --
-  //
-  // memset(dest : ptr, val : i8, length : i64, isVolatile : i1);
-  // TODO: For now, we convert it to a set of stores; maybe in the future it
-  // can be implemented using something smarter.
-  mlir::Value memref;
+void TranslateLLVMToStd::registerMemIntrinsicAccess(Operation *op,
+                                                    StringRef prefix) {
+  StringAttr name =
+      builder.getStringAttr(prefix + Twine(memIntrinsicAccesses.size()));
+  op->setAttr(StringRef(dynamatic::NameAnalysis::ATTR_NAME), name);
+  memIntrinsicAccesses.push_back(op);
+}
+
+void TranslateLLVMToStd::addMemIntrinsicDependencies(func::FuncOp funcOp) {
+  // The memory dependency analysis runs on the LLVM IR, where a memset or a
+  // memcpy is a single call that it ignores. Conservatively, the accesses in
+  // their loops depend on all other accesses to the same memory, so that they
+  // all connect to an LSQ which keeps them in program order.
+  auto getMemRef = [](Operation *op) -> mlir::Value {
+    if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+      return loadOp.getMemRef();
+    if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+      return storeOp.getMemRef();
+    return nullptr;
+  };
+
+  for (Operation *intrinsicOp : memIntrinsicAccesses) {
+    mlir::Value memref = getMemRef(intrinsicOp);
+    SmallVector<dynamatic::handshake::MemDependenceAttr> deps;
+    funcOp.walk([&](Operation *op) {
+      if (op == intrinsicOp || getMemRef(op) != memref)
+        return;
+      // There are no RAR dependencies
+      if (isa<memref::LoadOp>(op) && isa<memref::LoadOp>(intrinsicOp))
+        return;
+      auto dstName = op->getAttrOfType<StringAttr>(
+          StringRef(dynamatic::NameAnalysis::ATTR_NAME));
+      if (!dstName)
+        return;
+      deps.push_back(dynamatic::handshake::MemDependenceAttr::get(
+          ctx, dstName, /*loopDepth=*/0, /*distance=*/0));
+    });
+    if (!deps.empty()) {
+      dynamatic::setDialectAttr<dynamatic::handshake::MemDependenceArrayAttr>(
+          intrinsicOp, ctx, deps);
+    }
+  }
+}
 
-  // We will treat dest as memref[offset], and store the specified values there
-  // - When the ptr a function argument, the offset is zero.
+std::optional<std::pair<mlir::Value, mlir::Value>>
+TranslateLLVMToStd::getMemRefAndOffset(llvm::Value *ptr) {
+  // We will treat the pointer as memref[offset]
+  // - When the ptr is a function argument or an alloca, the offset is zero.
   // - When the ptr is from a GEP, the offset is the value calculated from
   // there.
-  mlir::Value offset;
-
-  if (valueMap.count(callInst->getArgOperand(0)) &&
-      isa_and_nonnull<MemRefType>(
-          valueMap[callInst->getArgOperand(0)].getType())) {
-    // Case: When the ptr operand is a function argument
-    memref = valueMap[callInst->getArgOperand(0)];
-    offset = builder.create<arith::ConstantOp>(
-        UnknownLoc::get(ctx), IntegerAttr::get(builder.getIndexType(), 0));
-  } else if (getInstToMemRefMap.count(callInst->getArgOperand(0))) {
-    // Case: When the ptr operand is a GEP
-    memref = getInstToMemRefMap[callInst->getArgOperand(0)];
-    offset = valueMap[callInst->getArgOperand(0)];
+  if (auto it = valueMap.find(ptr);
+      it != valueMap.end() && it->second &&
+      isa<MemRefType>(it->second.getType())) {
+    auto zero = builder.create<arith::ConstantOp>(
+        UnknownLoc::get(ctx), builder.getIntegerAttr(builder.getI64Type(), 0));
+    return std::make_pair(it->second, mlir::Value(zero));
+  }
+  if (auto it = getInstToMemRefMap.find(ptr); it != getInstToMemRefMap.end())
+    return std::make_pair(it->second, valueMap[ptr]);
+  return std::nullopt;
+}
+
+void TranslateLLVMToStd::createElementLoop(
+    Location loc, mlir::Value numElems, bool mayBeEmpty,
+    function_ref<void(mlir::Value)> buildBody) {
+  // The loop is bottom-tested, so that it only needs a single block:
+  //
+  // ^bb0:
+  //   cf.cond_br (0 < numElems), ^body(%c0), ^exit  (or cf.br ^body(%c0))
+  // ^body(%i: i64):
+  //   <buildBody(%i)>
+  //   %next = %i + 1
+  //   cf.cond_br (%next < numElems), ^body(%next), ^exit
+  // ^exit:
+  //   <rest of the LLVM basic block>
+  Block *currBlock = builder.getBlock();
+  Region::BlockListType &blocks = currBlock->getParent()->getBlocks();
+  Block *bodyBlock = new Block();
+  Block *exitBlock = new Block();
+  blocks.insertAfter(Region::iterator(currBlock), bodyBlock);
+  blocks.insertAfter(Region::iterator(bodyBlock), exitBlock);
+  mlir::Value iv = bodyBlock->addArgument(builder.getI64Type(), loc);
+
+  auto zero = builder.create<arith::ConstantOp>(
+      loc, builder.getIntegerAttr(builder.getI64Type(), 0));
+  if (mayBeEmpty) {
+    auto isNotEmpty = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, zero, numElems);
+    builder.create<cf::CondBranchOp>(loc, isNotEmpty, bodyBlock,
+                                     ValueRange{zero}, exitBlock, ValueRange{});
   } else {
-    llvm::report_fatal_error(
-        "Cannot determine the base ptr of the memset intrinsic!");
+    builder.create<cf::BranchOp>(loc, bodyBlock, ValueRange{zero});
   }
 
-  mlir::Value valToSet = valueMap[callInst->getArgOperand(1)];
-  if (!valToSet || !isa<mlir::IntegerType>(valToSet.getType()))
-    llvm::report_fatal_error(
-        "Cannot determine the value to set of the memset intrinsic!");
+  builder.setInsertionPointToEnd(bodyBlock);
+  buildBody(iv);
+  auto one = builder.create<arith::ConstantOp>(
+      loc, builder.getIntegerAttr(builder.getI64Type(), 1));
+  auto next = builder.create<arith::AddIOp>(loc, iv, one);
+  auto isNotDone = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::ult, next, numElems);
+  builder.create<cf::CondBranchOp>(loc, isNotDone, bodyBlock,
+                                   ValueRange{next}, exitBlock, ValueRange{});
+
+  builder.setInsertionPointToEnd(exitBlock);
+}
 
-  assert(valToSet.getType().getIntOrFloatBitWidth() == 8 &&
-         "We assume that memset sets values of i8.");
+FailureOr<std::pair<mlir::Value, bool>>
+TranslateLLVMToStd::getNumElemsFromLength(llvm::CallInst *callInst,
+                                          unsigned elemWidth) {
+  Location loc = getLoc(callInst);
+  llvm::Value *llvmLength = callInst->getArgOperand(2);
+  mlir::Value length = valueMap[llvmLength];
+  if (!length || !isa<mlir::IntegerType>(length.getType()))
+    return emitError(callInst) << "cannot determine the length of the "
+                               << callInst->getCalledFunction()->getName()
+                               << " intrinsic";
+
+  unsigned elemBytes = elemWidth / 8;
+  if (elemWidth % 8 != 0 || !llvm::isPowerOf2_32(elemBytes))
+    return emitError(callInst)
+           << "unsupported " << callInst->getCalledFunction()->getName()
+           << " intrinsic on an array of " << elemWidth << "-bit elements";
+
+  // Say we set 64 bytes of an array of i32: the loop stores 64 * 8 / 32 = 16
+  // elements
+  if (auto *constLength = dyn_cast<llvm::ConstantInt>(llvmLength)) {
+    uint64_t numBytes = constLength->getLimitedValue();
+    if (numBytes % elemBytes != 0)
+      return emitError(callInst)
+             << "length of " << numBytes
+             << " bytes is not a multiple of the array elements' size";
+    auto numElems = builder.create<arith::ConstantOp>(
+        loc,
+        builder.getIntegerAttr(builder.getI64Type(), numBytes / elemBytes));
+    return std::make_pair(mlir::Value(numElems), numBytes == 0);
+  }
 
-  mlir::Value mlirLengthVal = valueMap[callInst->getArgOperand(2)];
-  if (!mlirLengthVal || !isa<mlir::IntegerType>(mlirLengthVal.getType()))
-    llvm::report_fatal_error(
-        "Cannot determine the length to set of the memset intrinsic!");
+  // The length is only known at runtime, we assume that it is a multiple of
+  // the size of the array elements
+  if (length.getType() != builder.getI64Type())
+    length = builder.create<arith::ExtUIOp>(loc, builder.getI64Type(), length);
+  auto shiftValue = builder.create<arith::ConstantOp>(
+      loc,
+      builder.getIntegerAttr(builder.getI64Type(), llvm::Log2_32(elemBytes)));
+  auto numElems = builder.create<arith::ShRUIOp>(loc, length, shiftValue);
+  return std::make_pair(mlir::Value(numElems), true);
+}
 
+LogicalResult
+TranslateLLVMToStd::translateMemsetIntrinsic(llvm::CallInst *callInst) {
+  Function *calledFunc = callInst->getCalledFunction();
+  assert(calledFunc);
+  assert(calledFunc->getIntrinsicID() == Intrinsic::memset);
+  // -- Semantic of the memset intrinsic: --
   //
-  unsigned length = 0;
-  if (auto *constLength =
-          llvm::dyn_cast<llvm::ConstantInt>(callInst->getArgOperand(2))) {
-    length = constLength->getLimitedValue();
-  } else {
-    llvm::report_fatal_error(
-        "Cannot determine the length to set of the memset intrinsic!");
-  }
+  // memset(dest : ptr, val : i8, length : i64, isVolatile : i1);
+  //
+  // We convert it into a loop that stores the value to each element, so that
+  // the size of the circuit does not depend on the length.
+  Location loc = getLoc(callInst);
+
+  auto memrefAndOffset = getMemRefAndOffset(callInst->getArgOperand(0));
+  if (!memrefAndOffset)
+    return emitError(callInst)
+           << "cannot determine the base pointer of the memset intrinsic";
+  mlir::Value memref = memrefAndOffset->first;
+  mlir::Value offset = memrefAndOffset->second;
+
+  mlir::Value valToSet = valueMap[callInst->getArgOperand(1)];
+  if (!valToSet || !isa<mlir::IntegerType>(valToSet.getType()) ||
+      valToSet.getType().getIntOrFloatBitWidth() != 8)
+    return emitError(callInst)
+           << "cannot determine the value to set of the memset intrinsic";
 
   // Determine:
   // - the value to be stored in the data type of the memref
   // - the number of elements
   auto memrefElemType =
       mlir::cast<MemRefType>(memref.getType()).getElementType();
-
   unsigned elemWidth = memrefElemType.getIntOrFloatBitWidth();
-
-  // Say we store 1 (in i8) for length 64, with the element type i32
-  // Here we need to store 64 * i8 / i32 = 16 elements
-  int64_t valueInTargetType = 0;
-  assert(elemWidth % 8 == 0 && "");
+  auto numElems = getNumElemsFromLength(callInst, elemWidth);
+  if (failed(numElems))
+    return failure();
+  auto [numElemsVal, mayBeEmpty] = *numElems;
+
+  // Say we store 1 (in i8) with the element type i32; the stored value is
+  // 0x01010101
+  auto intElemType = builder.getIntegerType(elemWidth);
+  mlir::Value valueToSave;
   if (auto *constInst =
           llvm::dyn_cast<llvm::ConstantInt>(callInst->getArgOperand(1))) {
-    auto i8value = constInst->getLimitedValue();
-
-    for (size_t bytePos = 0; bytePos < elemWidth / 8; ++bytePos) {
-      valueInTargetType += i8value << (bytePos * 8);
-    }
-    unsigned numElemsToStore = length * 8 / elemWidth;
-
-    auto valueToSave = builder.create<arith::ConstantIntOp>(
-        UnknownLoc::get(ctx), valueInTargetType, elemWidth);
-
-    for (size_t elemPos = 0; elemPos < numElemsToStore; ++elemPos) {
-
-      LLVM_DEBUG(llvm::errs()
-                     << "Converting element position: " << elemPos << "\n";);
-      auto constIdx = builder.create<arith::ConstantOp>(
-          UnknownLoc::get(ctx),
-          builder.getIntegerAttr(offset.getType(), elemPos));
-      // Add the constant op with the offset
-      auto offsetPlusPos =
-          builder.create<arith::AddIOp>(UnknownLoc::get(ctx), offset, constIdx);
-
-      mlir::Value storeIndex = offsetPlusPos;
-      if (!isa<IndexType>(offsetPlusPos.getType())) {
-        storeIndex = builder.create<arith::IndexCastOp>(
-            UnknownLoc::get(ctx), builder.getIndexType(), offsetPlusPos);
+    APInt i8value = constInst->getValue();
+    valueToSave = builder.create<arith::ConstantOp>(
+        loc, builder.getIntegerAttr(intElemType,
+                                    APInt::getSplat(elemWidth, i8value)));
+  } else {
+    valueToSave = valToSet;
+    if (elemWidth != 8) {
+      auto valExt = builder.create<arith::ExtUIOp>(loc, intElemType, valToSet);
+      valueToSave = valExt;
+      for (unsigned bytePos = 1; bytePos < elemWidth / 8; ++bytePos) {
+        auto shiftValue = builder.create<arith::ConstantOp>(
+            loc, builder.getIntegerAttr(intElemType, bytePos * 8));
+        auto shifted = builder.create<arith::ShLIOp>(loc, valExt, shiftValue);
+        valueToSave = builder.create<arith::OrIOp>(loc, valueToSave, shifted);
       }
-      builder.create<memref::StoreOp>(UnknownLoc::get(ctx), valueToSave, memref,
-                                      storeIndex);
     }
   }
+  if (memrefElemType != intElemType)
+    valueToSave =
+        builder.create<arith::BitcastOp>(loc, memrefElemType, valueToSave);
+
+  createElementLoop(loc, numElemsVal, mayBeEmpty, [&](mlir::Value iv) {
+    auto offsetPlusPos = builder.create<arith::AddIOp>(loc, offset, iv);
+    auto storeIndex = builder.create<arith::IndexCastOp>(
+        loc, builder.getIndexType(), offsetPlusPos);
+    auto storeOp = builder.create<memref::StoreOp>(loc, valueToSave, memref,
+                                                   ValueRange{storeIndex});
+    registerMemIntrinsicAccess(storeOp, "memset_store");
+  });
+  return success();
+}
+
+LogicalResult
+TranslateLLVMToStd::translateMemcpyIntrinsic(llvm::CallInst *callInst) {
+  Function *calledFunc = callInst->getCalledFunction();
+  assert(calledFunc);
+  assert(calledFunc->getIntrinsicID() == Intrinsic::memcpy ||
+         calledFunc->getIntrinsicID() == Intrinsic::memcpy_inline);
+  // -- Semantic of the memcpy intrinsic: --
+  //
+  // memcpy(dest : ptr, src : ptr, length : i64, isVolatile : i1);
+  //
+  // We convert it into a loop that loads each element of the source and
+  // stores it to the destination. The source and the destination do not
+  // overlap, so the order of the copies does not matter.
+  Location loc = getLoc(callInst);
+
+  auto dstMemrefAndOffset = getMemRefAndOffset(callInst->getArgOperand(0));
+  if (!dstMemrefAndOffset)
+    return emitError(callInst)
+           << "cannot determine the destination pointer of the memcpy "
+              "intrinsic";
+  mlir::Value dstMemref = dstMemrefAndOffset->first;
+  mlir::Value dstOffset = dstMemrefAndOffset->second;
+
+  auto srcMemrefAndOffset = getMemRefAndOffset(callInst->getArgOperand(1));
+  if (!srcMemrefAndOffset)
+    return emitError(callInst)
+           << "cannot determine the source pointer of the memcpy intrinsic";
+  mlir::Value srcMemref = srcMemrefAndOffset->first;
+  mlir::Value srcOffset = srcMemrefAndOffset->second;
+
+  auto elemType = mlir::cast<MemRefType>(dstMemref.getType()).getElementType();
+  if (mlir::cast<MemRefType>(srcMemref.getType()).getElementType() != elemType)
+    return emitError(callInst) << "unsupported memcpy intrinsic between arrays "
+                                  "of different element types";
+
+  auto numElems =
+      getNumElemsFromLength(callInst, elemType.getIntOrFloatBitWidth());
+  if (failed(numElems))
+    return failure();
+  auto [numElemsVal, mayBeEmpty] = *numElems;
+
+  createElementLoop(loc, numElemsVal, mayBeEmpty, [&](mlir::Value iv) {
+    auto srcPos = builder.create<arith::AddIOp>(loc, srcOffset, iv);
+    auto loadIndex = builder.create<arith::IndexCastOp>(
+        loc, builder.getIndexType(), srcPos);
+    auto loadOp = builder.create<memref::LoadOp>(loc, elemType, srcMemref,
+                                                 ValueRange{loadIndex});
+    registerMemIntrinsicAccess(loadOp, "memcpy_load");
+    auto dstPos = builder.create<arith::AddIOp>(loc, dstOffset, iv);
+    auto storeIndex = builder.create<arith::IndexCastOp>(
+        loc, builder.getIndexType(), dstPos);
+    auto storeOp = builder.create<memref::StoreOp>(loc, loadOp, dstMemref,
+                                                   ValueRange{storeIndex});
+    registerMemIntrinsicAccess(storeOp, "memcpy_store");
+  });
+  return success();
 }
 
 void TranslateLLVMToStd::translateFunnelShiftIntrinsic(
@@ -979,18 +1434,19 @@ void TranslateLLVMToStd::translateFunnelShiftIntrinsic(
   valueMap[callInst] = result;
 }
 
-void TranslateLLVMToStd::translateCallInst(llvm::CallInst *callInst) {
+LogicalResult TranslateLLVMToStd::translateCallInst(llvm::CallInst *callInst) {
 
   Function *calledFunc = callInst->getCalledFunction();
-  assert(calledFunc);
+  if (!calledFunc)
+    return emitError(callInst) << "unsupported indirect function call";
 
-  if (calledFunc->getName().starts_with("__dyn_speculate")) {
-    handleSpeculateMarker(callInst);
-    return;
-  }
+  if (calledFunc->getName().starts_with("__dyn_speculate"))
+    return handleSpeculateMarker(callInst);
 
-  assert(calledFunc->isIntrinsic() &&
-         "Function calls are not currently supported");
+  if (!calledFunc->isIntrinsic())
+    return emitError(callInst)
+           << "unsupported call to function '" << calledFunc->getName()
+           << "'; function calls must be inlined";
 
   if (calledFunc->getIntrinsicID() == Intrinsic::smax) {
     mlir::Value lhs = valueMap[callInst->getArgOperand(0)];
@@ -1017,7 +1473,10 @@ void TranslateLLVMToStd::translateCallInst(llvm::CallInst *callInst) {
     auto retType = getMLIRType(callInst->getType(), ctx);
     naiveTranslation<math::AbsFOp>(retType, {arg}, callInst);
   } else if (calledFunc->getIntrinsicID() == Intrinsic::memset) {
-    this->translateMemsetIntrinsic(callInst);
+    return this->translateMemsetIntrinsic(callInst);
+  } else if (calledFunc->getIntrinsicID() == Intrinsic::memcpy ||
+             calledFunc->getIntrinsicID() == Intrinsic::memcpy_inline) {
+    return this->translateMemcpyIntrinsic(callInst);
   } else if (calledFunc->getIntrinsicID() == Intrinsic::fshl ||
              calledFunc->getIntrinsicID() == Intrinsic::fshr) {
     this->translateFunnelShiftIntrinsic(callInst);
@@ -1026,17 +1485,21 @@ void TranslateLLVMToStd::translateCallInst(llvm::CallInst *callInst) {
     // besides causing undefined behavior.
   } else if (calledFunc->getIntrinsicID() == Intrinsic::bitreverse) {
     if (!callInst->getType()->isIntegerTy(1))
-      llvm::report_fatal_error("Non i1 '@llvm.bitreverse' unimplemented");
+      return emitError(callInst)
+             << "unsupported '" << calledFunc->getName() << "' intrinsic on "
+             << printToString(*callInst->getType());
 
     mlir::Value operand = valueMap[callInst->getArgOperand(0)];
     valueMap[callInst] = operand;
   } else {
-    llvm::report_fatal_error(
-        "Not implemented llvm intrinsic function handling!");
+    return emitError(callInst) << "unsupported intrinsic '"
+                               << calledFunc->getName() << "'";
   }
+  return success();
 }
 
-void TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
+LogicalResult
+TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
 
   // try cast arg1 (max_predictions) to a llvm::ConstantInt
   auto *maxPredConst =
@@ -1046,8 +1509,8 @@ void TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
   // a constant int value for max predictions
   // and so conversion fails
   if (!maxPredConst)
-    llvm::report_fatal_error(
-        "__dyn_speculate: max_predictions arg is not a ConstantInt");
+    return emitError(callInst)
+           << "__dyn_speculate: max_predictions arg is not a ConstantInt";
 
   // pulling a uint64_t from a llvm::ConstantInt is annoying
   // since they store the value as an APInt (arbitrary precision)
@@ -1064,8 +1527,8 @@ void TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
   // for the speculation style
   // and so conversion fails
   if (!llvm::getConstantStringInfo(callInst->getArgOperand(2), style))
-    llvm::report_fatal_error(
-        "__dyn_speculate: style arg is not a constant C string");
+    return emitError(callInst)
+           << "__dyn_speculate: style arg is not a constant C string";
 
   // get the value we want to speculate on
   llvm::Value *specVal = callInst->getArgOperand(0);
@@ -1087,7 +1550,7 @@ void TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
   // if we don't find the value to speculate on
   // conversion fails
   if (it == valueMap.end())
-    llvm::report_fatal_error("__dyn_speculate: arg0 not found in valueMap");
+    return emitError(callInst) << "__dyn_speculate: arg0 not found in valueMap";
   // actually get the cf value
   mlir::Value v = it->second;
 
@@ -1125,4 +1588,5 @@ void TranslateLLVMToStd::handleSpeculateMarker(llvm::CallInst *callInst) {
   // speculator function's output use
   // the output of our edge attr op
   valueMap[callInst] = markerOp->getResult(0);
+  return success();
 }
@@ -1,3 +1,4 @@
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/BasicBlock.h"
@@ -20,8 +21,11 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Location.h"
 #include "mlir/IR/MLIRContext.h"
+#include <optional>
+#include <utility>
 
 using namespace llvm;
 using namespace mlir;
@@ -39,7 +43,11 @@ public:
 
   /// Calling this method will translate the funcName to mlirModule. TODO: maybe
   /// we could return a newly created "OwnOpReference<ModuleOp>" instead?
-  void translateLLVMModule();
+  ///
+  /// Fails after emitting an error when the function contains a construct
+  /// that cannot be translated. The error is located in the C source when the
+  /// LLVM IR carries debug locations.
+  LogicalResult translateLLVMModule();
 
 private:
   /// FIXME: This module importer only converts for one given function (name).
@@ -77,52 +85,101 @@ private:
   /// The (C-code-level) argument types of the LLVM functions.
   FuncNameToCFuncArgsMap &argMap;
 
+  /// Memory accesses created when translating memset and memcpy intrinsics.
+  SmallVector<Operation *> memIntrinsicAccesses;
+
   /// Construct an op without adding any attributes. TODO: maybe return the op
   /// to enable it?
   template <typename MLIRTy>
   void naiveTranslation(mlir::Type returnType, mlir::ValueRange values,
                         Instruction *inst) {
-    MLIRTy op =
-        builder.create<MLIRTy>(UnknownLoc::get(ctx), returnType, values);
+    MLIRTy op = builder.create<MLIRTy>(getLoc(inst), returnType, values);
     // Register the corresponding MLIR value of the result of the original
     // instruction.
     valueMap[inst] = op.getResult();
   }
 
-  void initializeBlocksAndBlockMapping(llvm::Function *llvmFunc,
-                                       func::FuncOp funcOp);
+  /// Returns the location of the function in the C source, or a location
+  /// naming the function when the LLVM IR has no debug information.
+  Location getLoc(llvm::Function *llvmFunc);
+
+  /// Returns the location of the instruction in the C source, or the location
+  /// of its function when the instruction has no debug location.
+  Location getLoc(llvm::Instruction *inst);
+
+  /// Emits an error at the location of the instruction, with a note showing
+  /// the instruction that could not be translated.
+  InFlightDiagnostic emitError(llvm::Instruction *inst);
+
+  LogicalResult initializeBlocksAndBlockMapping(llvm::Function *llvmFunc,
+                                                func::FuncOp funcOp);
 
-  void translateFunction(llvm::Function *llvmFunc);
+  LogicalResult translateFunction(llvm::Function *llvmFunc);
 
   /// LLVM embeds constants into the instructions, wheres in MLIR we need to
   /// explicitly create them.
   void createConstants(llvm::Function *llvmFunc);
 
   /// LLVM "GlobalVariables" are converted to "memref.global"
-  void translateGlobalVars();
+  LogicalResult translateGlobalVars();
 
   /// LLVM GEP instructions can directly take a global pointer. We need to
   /// explicitly create memref::GetGlobalOp here
   void createGetGlobals(llvm::Function *llvmFunc);
 
   /// Dispatches to specialized functions:
-  void translateInstruction(llvm::Instruction *inst);
+  LogicalResult translateInstruction(llvm::Instruction *inst);
 
   /// Specialized translation functions:
-  void translateBinaryInst(llvm::BinaryOperator *inst);
-  void translateCastInst(llvm::CastInst *inst);
-  void translateICmpInst(llvm::ICmpInst *inst);
-  void translateFCmpInst(llvm::FCmpInst *inst);
-  void translateBranchInst(llvm::BranchInst *inst);
-  void translateGEPInst(llvm::GetElementPtrInst *gepInst);
-  void translateLoadInst(llvm::LoadInst *loadInst);
-  void translateStoreInst(llvm::StoreInst *storeInst);
-  void translateAllocaInst(llvm::AllocaInst *allocaInst);
-  void translateCallInst(llvm::CallInst *callInst);
+  LogicalResult translateBinaryInst(llvm::BinaryOperator *inst);
+  LogicalResult translateCastInst(llvm::CastInst *inst);
+  LogicalResult translateICmpInst(llvm::ICmpInst *inst);
+  LogicalResult translateFCmpInst(llvm::FCmpInst *inst);
+  LogicalResult translateBranchInst(llvm::BranchInst *inst);
+  LogicalResult translateSwitchInst(llvm::SwitchInst *inst);
+  LogicalResult translateGEPInst(llvm::GetElementPtrInst *gepInst);
+
+  /// Pointers to constant sized arrays passed as arguments (e.g., int
+  /// (*a)[8]) are translated to memrefs of the pointee's extent. Fails after
+  /// emitting an error when the GEP accesses the argument outside of the
+  /// pointee, which the memref does not cover.
+  LogicalResult checkPointerToArrayAccess(llvm::GetElementPtrInst *gepInst,
+                                          mlir::Value memref);
+  LogicalResult translateLoadInst(llvm::LoadInst *loadInst);
+  LogicalResult translateStoreInst(llvm::StoreInst *storeInst);
+  LogicalResult translateAllocaInst(llvm::AllocaInst *allocaInst);
+  LogicalResult translateCallInst(llvm::CallInst *callInst);
 
   void translateFunnelShiftIntrinsic(llvm::CallInst *callInst);
-  void translateMemsetIntrinsic(llvm::CallInst *callInst);
-  void handleSpeculateMarker(llvm::CallInst *callInst);
+  LogicalResult translateMemsetIntrinsic(llvm::CallInst *callInst);
+  LogicalResult translateMemcpyIntrinsic(llvm::CallInst *callInst);
+
+  /// Returns the memref and the (i64) offset in the memref that the pointer
+  /// points to, if the pointer is a memref or the result of a GEP.
+  std::optional<std::pair<mlir::Value, mlir::Value>>
+  getMemRefAndOffset(llvm::Value *ptr);
+
+  /// Returns the number of elements of `elemWidth` bits covered by the length
+  /// (in bytes) of a memset/memcpy intrinsic, and whether it may be zero.
+  FailureOr<std::pair<mlir::Value, bool>>
+  getNumElemsFromLength(llvm::CallInst *callInst, unsigned elemWidth);
+
+  /// Creates a loop whose i64 induction variable goes from 0 to `numElems`
+  /// (excluded), with a body built by `buildBody`, at the current insertion
+  /// point. The loop is created in new blocks; the insertion point is moved to
+  /// the block after the loop. If `mayBeEmpty` is false, the loop body is
+  /// executed at least once.
+  void createElementLoop(Location loc, mlir::Value numElems, bool mayBeEmpty,
+                         function_ref<void(mlir::Value)> buildBody);
+
+  /// Names a memory access created for a memset/memcpy intrinsic and records
+  /// it, so that its dependencies are added once the function is translated.
+  void registerMemIntrinsicAccess(Operation *op, StringRef prefix);
+
+  /// Makes the memory accesses created for memset/memcpy intrinsics depend on
+  /// all other accesses to the same memory.
+  void addMemIntrinsicDependencies(func::FuncOp funcOp);
+  LogicalResult handleSpeculateMarker(llvm::CallInst *callInst);
 
   SmallVector<mlir::Value> getBranchOperandsForCFGEdge(BasicBlock *currBB,
                                                        BasicBlock *nextBB);
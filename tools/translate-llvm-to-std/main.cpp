@@ -107,7 +107,8 @@ int main(int argc, char **argv) {
 
   TranslateLLVMToStd importer(llvmModule.get(), module, builder,
                               nameToArgTypesMap, &context, funcName);
-  importer.translateLLVMModule();
+  if (failed(importer.translateLLVMModule()))
+    return 1;
 
   if (failed(module.verify())) {
     return 1;
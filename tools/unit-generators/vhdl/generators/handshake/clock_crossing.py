@@ -0,0 +1,113 @@
+from generators.support.utils import data
+
+
+def generate_clock_crossing(name, params):
+    # Number of slots, always a power of two
+    num_slots = params["num_slots"]
+    bitwidth = params["bitwidth"]
+    if params.get("extra_signals", None):
+        raise ValueError("Clock crossings do not support extra signals")
+
+    addr_bitwidth = (num_slots - 1).bit_length()
+
+    # The FIFO is full when the write pointer has wrapped around once more
+    # than the read pointer, i.e., when both Gray-coded pointers only differ
+    # in their two most significant bits
+    if addr_bitwidth == 1:
+        full_ptr = "not rptr_wclk"
+    else:
+        full_ptr = (f"(not rptr_wclk({addr_bitwidth} downto {addr_bitwidth - 1})) & "
+                    f"rptr_wclk({addr_bitwidth - 2} downto 0)")
+
+    entity = f"""
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- Entity of clock_crossing
+entity {name} is
+  port (
+    ins_clk, outs_clk, rst : in std_logic;
+    -- input channel (clocked by ins_clk)
+    {data(f"ins : in std_logic_vector({bitwidth} - 1 downto 0);", bitwidth)}
+    ins_valid : in std_logic;
+    ins_ready : out std_logic;
+    -- output channel (clocked by outs_clk)
+    {data(f"outs : out std_logic_vector({bitwidth} - 1 downto 0);", bitwidth)}
+    outs_valid : out std_logic;
+    outs_ready : in std_logic
+  );
+end entity;
+"""
+
+    architecture = f"""
+-- Architecture of clock_crossing
+architecture arch of {name} is
+  {data(f"type slots_t is array (0 to {num_slots} - 1) of std_logic_vector({bitwidth} - 1 downto 0);", bitwidth)}
+  {data("signal slots : slots_t;", bitwidth)}
+  -- Binary and Gray-coded pointers, with one more bit than needed to address
+  -- the slots to distinguish a full FIFO from an empty one
+  signal wbin, rbin : unsigned({addr_bitwidth} downto 0);
+  signal wptr, rptr : unsigned({addr_bitwidth} downto 0);
+  -- Gray-coded pointers synchronized to the other clock domain
+  signal wptr_sync, wptr_rclk : unsigned({addr_bitwidth} downto 0);
+  signal rptr_sync, rptr_wclk : unsigned({addr_bitwidth} downto 0);
+  signal full, empty, write, read : std_logic;
+  signal wbin_next, rbin_next : unsigned({addr_bitwidth} downto 0);
+begin
+  full <= '1' when wptr = {full_ptr} else '0';
+  empty <= '1' when rptr = wptr_rclk else '0';
+
+  ins_ready <= not full;
+  write <= ins_valid and not full;
+  outs_valid <= not empty;
+  read <= outs_ready and not empty;
+  {data(f"outs <= slots(to_integer(rbin({addr_bitwidth} - 1 downto 0)));", bitwidth)}
+
+  wbin_next <= wbin + 1;
+  rbin_next <= rbin + 1;
+
+  -- Write side
+  process (ins_clk)
+  begin
+    if rising_edge(ins_clk) then
+      if rst = '1' then
+        wbin <= (others => '0');
+        wptr <= (others => '0');
+        rptr_sync <= (others => '0');
+        rptr_wclk <= (others => '0');
+      else
+        if write = '1' then
+          {data(f"slots(to_integer(wbin({addr_bitwidth} - 1 downto 0))) <= ins;", bitwidth)}
+          wbin <= wbin_next;
+          wptr <= wbin_next xor shift_right(wbin_next, 1);
+        end if;
+        rptr_sync <= rptr;
+        rptr_wclk <= rptr_sync;
+      end if;
+    end if;
+  end process;
+
+  -- Read side
+  process (outs_clk)
+  begin
+    if rising_edge(outs_clk) then
+      if rst = '1' then
+        rbin <= (others => '0');
+        rptr <= (others => '0');
+        wptr_sync <= (others => '0');
+        wptr_rclk <= (others => '0');
+      else
+        if read = '1' then
+          rbin <= rbin_next;
+          rptr <= rbin_next xor shift_right(rbin_next, 1);
+        end if;
+        wptr_sync <= wptr;
+        wptr_rclk <= wptr_sync;
+      end if;
+    end if;
+  end process;
+end architecture;
+"""
+
+    return entity + architecture
@@ -1,12 +1,30 @@
 from generators.support.arith_ip import generate_vivado_ip_wrapper
+from generators.support.iterative_divider import generate_iterative_divider
 
 
 def generate_divui(name, params):
 
     latency = params["latency"]
+    ii = params.get("ii", 1)
 
     extra_signals = params.get("extra_signals", None)
 
+    # Units that only accept a new division every few cycles are implemented
+    # by an iterative divider, whose latency is its initiation interval
+    if ii > 1:
+        if latency != ii:
+            raise ValueError(
+                f"Iterative dividers have a latency equal to their initiation "
+                f"interval, but got latency {latency} and II {ii}")
+        return generate_iterative_divider(
+            name=name,
+            handshake_op="divui",
+            bitwidth=params["bitwidth"],
+            ii=ii,
+            is_signed=False,
+            extra_signals=extra_signals
+        )
+
     return generate_vivado_ip_wrapper(
         name=name,
         handshake_op="divui",
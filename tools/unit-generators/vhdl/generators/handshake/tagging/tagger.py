@@ -0,0 +1,127 @@
+from generators.handshake.fork import generate_fork
+from generators.handshake.join import generate_join
+from generators.support.utils import data
+
+
+def generate_tagger(name, params):
+    # Number of tags, always a power of two
+    num_tags = params["num_tags"]
+    # Bitwidth of each data channel, space-separated
+    bitwidths = [int(bitwidth) for bitwidth in params["bitwidths"].split()]
+
+    size = len(bitwidths)
+    tag_bitwidth = (num_tags - 1).bit_length()
+
+    join_name = f"{name}_join"
+    fork_name = f"{name}_fork"
+
+    # The tag is issued when all inputs and a free tag are available, which
+    # is modelled as an additional input of the join
+    dependencies = \
+        generate_join(join_name, {"size": size + 1}) + \
+        generate_fork(fork_name, {"size": size, "bitwidth": 0})
+
+    ports = []
+    for i, bitwidth in enumerate(bitwidths):
+        ports.append(data(
+            f"ins_{i} : in std_logic_vector({bitwidth} - 1 downto 0);", bitwidth))
+        ports.append(f"ins_{i}_valid : in std_logic;")
+        ports.append(f"ins_{i}_ready : out std_logic;")
+    ports.append("credit_valid : in std_logic;")
+    ports.append("credit_ready : out std_logic;")
+    for i, bitwidth in enumerate(bitwidths):
+        ports.append(data(
+            f"outs_{i} : out std_logic_vector({bitwidth} - 1 downto 0);", bitwidth))
+        ports.append(f"outs_{i}_valid : out std_logic;")
+        ports.append(f"outs_{i}_ready : in std_logic;")
+        ports.append(
+            f"outs_{i}_tag : out std_logic_vector({tag_bitwidth} - 1 downto 0);")
+    # The last port declaration cannot end with a semicolon
+    ports[-1] = ports[-1].rstrip(";")
+
+    entity = f"""
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use work.types.all;
+
+-- Entity of tagger
+entity {name} is
+  port (
+    clk, rst : in std_logic;
+    {"\n    ".join(port for port in ports if port)}
+  );
+end entity;
+"""
+
+    assignments = []
+    for i, bitwidth in enumerate(bitwidths):
+        assignments.append(f"join_ins_valid({i}) <= ins_{i}_valid;")
+        assignments.append(f"ins_{i}_ready <= join_ins_ready({i});")
+        assignments.append(data(f"outs_{i} <= ins_{i};", bitwidth))
+        assignments.append(f"outs_{i}_valid <= fork_outs_valid({i});")
+        assignments.append(f"fork_outs_ready({i}) <= outs_{i}_ready;")
+        assignments.append(
+            f"outs_{i}_tag <= std_logic_vector(tag);")
+
+    architecture = f"""
+-- Architecture of tagger
+architecture arch of {name} is
+  signal join_ins_valid, join_ins_ready : std_logic_vector({size} downto 0);
+  signal join_outs_valid, join_outs_ready : std_logic;
+  signal fork_outs_valid, fork_outs_ready : std_logic_vector({size} - 1 downto 0);
+  signal has_credit, issue : std_logic;
+  signal credits : integer range 0 to {num_tags};
+  signal tag : unsigned({tag_bitwidth} - 1 downto 0);
+begin
+  -- Wait for all inputs and a free tag
+  join_ins_valid({size}) <= has_credit;
+  {"\n  ".join(assignment for assignment in assignments if assignment)}
+
+  join : entity work.{join_name}(arch)
+    port map(
+      ins_valid => join_ins_valid,
+      outs_ready => join_outs_ready,
+      outs_valid => join_outs_valid,
+      ins_ready => join_ins_ready
+    );
+
+  -- Send the tagged tokens to all outputs
+  fork : entity work.{fork_name}(arch)
+    port map(
+      clk => clk,
+      rst => rst,
+      ins_valid => join_outs_valid,
+      ins_ready => join_outs_ready,
+      outs_valid => fork_outs_valid,
+      outs_ready => fork_outs_ready
+    );
+
+  has_credit <= '1' when credits /= 0 else '0';
+  issue <= join_outs_valid and join_outs_ready;
+  -- Freed tags are always accepted since at most {num_tags} tags are in use
+  credit_ready <= '1';
+
+  process (clk)
+  begin
+    if rising_edge(clk) then
+      if rst = '1' then
+        credits <= {num_tags};
+        tag <= (others => '0');
+      else
+        if issue = '1' and credit_valid = '0' then
+          credits <= credits - 1;
+        elsif issue = '0' and credit_valid = '1' then
+          credits <= credits + 1;
+        end if;
+        -- Tags are issued in order and wrap around
+        if issue = '1' then
+          tag <= tag + 1;
+        end if;
+      end if;
+    end if;
+  end process;
+end architecture;
+"""
+
+    return dependencies + entity + architecture
@@ -0,0 +1,122 @@
+from generators.support.utils import data
+
+
+def generate_untagger(name, params):
+    # Number of tags, always a power of two
+    num_tags = params["num_tags"]
+    # Bitwidth of each data channel, space-separated
+    bitwidths = [int(bitwidth) for bitwidth in params["bitwidths"].split()]
+
+    size = len(bitwidths)
+    tag_bitwidth = (num_tags - 1).bit_length()
+
+    ports = []
+    for i, bitwidth in enumerate(bitwidths):
+        ports.append(data(
+            f"ins_{i} : in std_logic_vector({bitwidth} - 1 downto 0);", bitwidth))
+        ports.append(f"ins_{i}_valid : in std_logic;")
+        ports.append(f"ins_{i}_ready : out std_logic;")
+        ports.append(
+            f"ins_{i}_tag : in std_logic_vector({tag_bitwidth} - 1 downto 0);")
+    for i, bitwidth in enumerate(bitwidths):
+        ports.append(data(
+            f"outs_{i} : out std_logic_vector({bitwidth} - 1 downto 0);", bitwidth))
+        ports.append(f"outs_{i}_valid : out std_logic;")
+        ports.append(f"outs_{i}_ready : in std_logic;")
+    ports.append("credit_valid : out std_logic;")
+    ports.append("credit_ready : in std_logic")
+
+    entity = f"""
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use work.types.all;
+
+-- Entity of untagger
+entity {name} is
+  port (
+    clk, rst : in std_logic;
+    {"\n    ".join(port for port in ports if port)}
+  );
+end entity;
+"""
+
+    # Each channel has its own reorder buffer, indexed by tag. A slot is full
+    # when it holds a token that was not released yet, and retired once its
+    # token was released but the tag was not freed yet.
+    declarations = []
+    channels = []
+    for i, bitwidth in enumerate(bitwidths):
+        declarations.append(data(
+            f"type slots_{i}_t is array (0 to {num_tags} - 1) of std_logic_vector({bitwidth} - 1 downto 0);", bitwidth))
+        declarations.append(data(f"signal slots_{i} : slots_{i}_t;", bitwidth))
+        declarations.append(
+            f"signal full_{i}, retired_{i} : std_logic_vector({num_tags} - 1 downto 0);")
+        declarations.append(
+            f"signal head_{i} : unsigned({tag_bitwidth} - 1 downto 0);")
+        declarations.append(f"signal write_{i}, read_{i} : std_logic;")
+
+        channel = f"""
+  -- Reorder buffer of channel {i}
+  ins_{i}_ready <= not full_{i}(to_integer(unsigned(ins_{i}_tag)));
+  write_{i} <= ins_{i}_valid and not full_{i}(to_integer(unsigned(ins_{i}_tag)));
+  {data(f"outs_{i} <= slots_{i}(to_integer(head_{i}));", bitwidth)}
+  outs_{i}_valid <= full_{i}(to_integer(head_{i}));
+  read_{i} <= full_{i}(to_integer(head_{i})) and outs_{i}_ready;
+
+  process (clk)
+  begin
+    if rising_edge(clk) then
+      if rst = '1' then
+        full_{i} <= (others => '0');
+        retired_{i} <= (others => '0');
+        head_{i} <= (others => '0');
+      else
+        if write_{i} = '1' then
+          {data(f"slots_{i}(to_integer(unsigned(ins_{i}_tag))) <= ins_{i};", bitwidth)}
+          full_{i}(to_integer(unsigned(ins_{i}_tag))) <= '1';
+        end if;
+        if read_{i} = '1' then
+          full_{i}(to_integer(head_{i})) <= '0';
+          retired_{i}(to_integer(head_{i})) <= '1';
+          head_{i} <= head_{i} + 1;
+        end if;
+        if free = '1' then
+          retired_{i}(to_integer(free_tag)) <= '0';
+        end if;
+      end if;
+    end if;
+  end process;
+"""
+        channels.append(channel)
+
+    all_retired = " and ".join(
+        f"retired_{i}(to_integer(free_tag))" for i in range(size))
+
+    architecture = f"""
+-- Architecture of untagger
+architecture arch of {name} is
+  {"\n  ".join(declaration for declaration in declarations if declaration)}
+  signal free : std_logic;
+  signal free_tag : unsigned({tag_bitwidth} - 1 downto 0);
+begin
+{"".join(channels)}
+  -- A tag is freed once its token was released on all outputs. Tags are
+  -- released in order on each output, so they are also freed in order.
+  credit_valid <= {all_retired};
+  free <= ({all_retired}) and credit_ready;
+
+  process (clk)
+  begin
+    if rising_edge(clk) then
+      if rst = '1' then
+        free_tag <= (others => '0');
+      elsif free = '1' then
+        free_tag <= free_tag + 1;
+      end if;
+    end if;
+  end process;
+end architecture;
+"""
+
+    return entity + architecture
@@ -0,0 +1,201 @@
+import math
+
+from generators.handshake.join import generate_join
+from generators.support.signal_manager import generate_arith_binary_signal_manager
+
+
+def generate_iterative_divider(name, handshake_op, bitwidth, ii, is_signed,
+                               extra_signals):
+    """
+    Generates an iterative (non-pipelined) integer divider that computes one
+    quotient every `ii` cycles using a single radix-2 restoring division
+    datapath, instead of instantiating a fully pipelined IP core.
+
+    The datapath processes ceil(bitwidth / ii) dividend bits per cycle, so that
+    a division takes exactly `ii` cycles. The unit accepts new operands only
+    once the previous quotient has been consumed (or is being consumed), hence
+    it holds at most one token and has both a latency and an initiation
+    interval of `ii`.
+
+    Args:
+        name: Unique name based on MLIR op name (e.g. divsi0).
+        handshake_op: What kind of handshake op this RTL entity corresponds to. Only used in comments.
+        bitwidth: Unit bitwidth.
+        ii: Initiation interval (and latency) of the unit, at least 2.
+        is_signed: Whether operands and result are signed integers.
+        extra_signals: Extra signals on input/output channels, from IR.
+
+    Returns:
+        VHDL code as a string.
+    """
+
+    if ii < 2:
+        raise ValueError(
+            f"Iterative dividers require an initiation interval of at least 2, but got {ii}")
+
+    def generate_inner(name): return _generate_iterative_divider(
+        name,
+        handshake_op,
+        bitwidth,
+        ii,
+        is_signed
+    )
+
+    if extra_signals:
+        return generate_arith_binary_signal_manager(
+            name=name,
+            bitwidth=bitwidth,
+            extra_signals=extra_signals,
+            generate_inner=generate_inner,
+            latency=ii
+        )
+    return generate_inner(name)
+
+
+def _generate_iterative_divider(name, handshake_op, bitwidth, ii, is_signed):
+    # Number of quotient bits computed each cycle, and width of the dividend
+    # once padded so that it is consumed in exactly ii cycles
+    bits_per_step = math.ceil(bitwidth / ii)
+    padded_bitwidth = bits_per_step * ii
+    count_bitwidth = (ii - 1).bit_length()
+
+    join_name = f"{name}_join"
+    dependencies = generate_join(join_name, {"size": 2})
+
+    if is_signed:
+        operands = f"""
+  abs_lhs <= unsigned(lhs) when lhs({bitwidth} - 1) = '0' else unsigned(-signed(lhs));
+  abs_rhs <= unsigned(rhs) when rhs({bitwidth} - 1) = '0' else unsigned(-signed(rhs));
+  negate_next <= lhs({bitwidth} - 1) xor rhs({bitwidth} - 1);
+  result <= std_logic_vector(quotient({bitwidth} - 1 downto 0)) when negate = '0' else
+            std_logic_vector(-signed(quotient({bitwidth} - 1 downto 0)));"""
+    else:
+        operands = f"""
+  abs_lhs <= unsigned(lhs);
+  abs_rhs <= unsigned(rhs);
+  negate_next <= '0';
+  result <= std_logic_vector(quotient({bitwidth} - 1 downto 0));"""
+
+    entity = f"""
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- Entity of iterative {handshake_op}
+entity {name} is
+  port(
+    clk: in std_logic;
+    rst: in std_logic;
+    -- input channel lhs
+    lhs: in std_logic_vector({bitwidth} - 1 downto 0);
+    lhs_valid: in std_logic;
+    lhs_ready: out std_logic;
+    -- input channel rhs
+    rhs: in std_logic_vector({bitwidth} - 1 downto 0);
+    rhs_valid: in std_logic;
+    rhs_ready: out std_logic;
+    -- output channel result
+    result : out std_logic_vector({bitwidth} - 1 downto 0);
+    result_valid: out std_logic;
+    result_ready: in std_logic
+  );
+end entity;
+"""
+
+    architecture = f"""
+-- Architecture of iterative {handshake_op}
+architecture arch of {name} is
+  signal join_valid, join_ready, accept : std_logic;
+  signal busy, out_valid, negate, negate_next : std_logic;
+  signal count : unsigned({count_bitwidth} - 1 downto 0);
+  signal abs_lhs, abs_rhs : unsigned({bitwidth} - 1 downto 0);
+  -- Partial remainder, dividend bits still to be consumed shifted in with the
+  -- quotient bits computed so far, and divisor
+  signal remainder, remainder_next : unsigned({bitwidth} downto 0);
+  signal quotient, quotient_next : unsigned({padded_bitwidth} - 1 downto 0);
+  signal divisor, divisor_next : unsigned({bitwidth} - 1 downto 0);
+begin
+  join_inputs : entity work.{join_name}(arch)
+    port map(
+      -- input valids
+      ins_valid(0) => lhs_valid,
+      ins_valid(1) => rhs_valid,
+      -- input readys
+      ins_ready(0) => lhs_ready,
+      ins_ready(1) => rhs_ready,
+      -- output channel to the datapath
+      outs_valid   => join_valid,
+      outs_ready   => join_ready
+    );
+
+  -- New operands are accepted when the datapath is idle and the previous
+  -- quotient is gone or leaving
+  join_ready <= (not busy) and ((not out_valid) or result_ready);
+  accept <= join_valid and join_ready;
+  result_valid <= out_valid;
+{operands}
+
+  -- The first division step is performed while accepting the operands, so
+  -- that the quotient is ready {ii} cycles after the operands were accepted
+  step : process (accept, abs_lhs, abs_rhs, remainder, quotient, divisor)
+    variable r : unsigned({bitwidth} downto 0);
+    variable q : unsigned({padded_bitwidth} - 1 downto 0);
+    variable d : unsigned({bitwidth} - 1 downto 0);
+  begin
+    if accept = '1' then
+      r := (others => '0');
+      q := resize(abs_lhs, {padded_bitwidth});
+      d := abs_rhs;
+    else
+      r := remainder;
+      q := quotient;
+      d := divisor;
+    end if;
+    for i in 0 to {bits_per_step} - 1 loop
+      r := r({bitwidth} - 1 downto 0) & q({padded_bitwidth} - 1);
+      q := q({padded_bitwidth} - 2 downto 0) & '0';
+      if r >= ('0' & d) then
+        r := r - ('0' & d);
+        q(0) := '1';
+      end if;
+    end loop;
+    remainder_next <= r;
+    quotient_next <= q;
+    divisor_next <= d;
+  end process;
+
+  control : process (clk)
+  begin
+    if rising_edge(clk) then
+      if rst = '1' then
+        busy <= '0';
+        out_valid <= '0';
+        count <= (others => '0');
+        negate <= '0';
+      else
+        if result_ready = '1' then
+          out_valid <= '0';
+        end if;
+        if accept = '1' then
+          busy <= '1';
+          count <= to_unsigned({ii - 1}, {count_bitwidth});
+          negate <= negate_next;
+        elsif busy = '1' then
+          count <= count - 1;
+          if count = 1 then
+            busy <= '0';
+            out_valid <= '1';
+          end if;
+        end if;
+      end if;
+      if accept = '1' or busy = '1' then
+        remainder <= remainder_next;
+        quotient <= quotient_next;
+        divisor <= divisor_next;
+      end if;
+    end if;
+  end process;
+end architecture;
+"""
+
+    return dependencies + entity + architecture
@@ -4,7 +4,13 @@ def get_default_extra_signal_value(extra_signal_name: str):
     Return the default VHDL value for an extra signal
     when there are no input sources to forward from.
     """
-    return "\"0\""
+    if extra_signal_name == "spec":
+        return "\"0\""
+    # Other extra signals (e.g., tag) may be wider than one bit. Tag 0 leaves
+    # the tags OR-ed with it unchanged; the out-of-order pass only accepts
+    # regions in which tokens without inputs come from sources, so that the
+    # constants they trigger carry this tag.
+    return "(others => '0')"
 
 
 def generate_forwarding_expression_for_signal(signal_name: str, in_extra_signal_names: list[str]) -> str:
@@ -13,8 +19,11 @@ def generate_forwarding_expression_for_signal(signal_name: str, in_extra_signal_
     based on a list of input extra signal names.
 
     If the list is empty, a default value is returned.
-    Currently, only the "spec" signal is supported,
-    which is forwarded using a logical OR.
+    Currently, the "spec" and "tag" signals are supported,
+    which are forwarded using a logical OR. Tokens joined inside a tagged
+    region carry the same tag, except constants triggered by a source which
+    carry the default tag 0 (see get_default_extra_signal_value), so OR-ing
+    the tags yields the common tag.
 
     Example: "0", lhs_spec or rhs_spec
     """
@@ -22,7 +31,7 @@ def generate_forwarding_expression_for_signal(signal_name: str, in_extra_signal_
     if not in_extra_signal_names:
         return get_default_extra_signal_value(signal_name)
 
-    if signal_name == "spec":
+    if signal_name in ("spec", "tag"):
         return " or ".join(in_extra_signal_names)
 
     raise ValueError(
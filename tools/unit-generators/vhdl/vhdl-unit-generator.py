@@ -78,6 +78,7 @@ if __name__ == "__main__":
     generators.add("handshake", "addi")
     generators.add("handshake", "andi")
     generators.add("handshake", "buffer")
+    generators.add("handshake", "clock_crossing")
     generators.add("handshake", "cmpi")
     generators.add("handshake", "cmpf")
     generators.add("handshake", "cond_br")
@@ -117,6 +118,8 @@ if __name__ == "__main__":
     generators.add("handshake.speculation", "speculating_branch")
     generators.add("handshake.speculation", "speculator")
     generators.add("handshake.speculation", "non_spec")
+    generators.add("handshake.tagging", "tagger")
+    generators.add("handshake.tagging", "untagger")
     generators.add("support", "mem_to_bram")
     generators.add("handshake", "extui")
     generators.add("handshake", "shli")
@@ -0,0 +1,182 @@
+//===- TokenLineageTest.cpp - Tests for token lineage -----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for the inference of token parents from recorded transfers, the
+// parsing of lineage files, and slicing queries on the parsed lineage.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Analysis/TokenLineage.h"
+#include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace mlir;
+using namespace dynamatic;
+
+namespace {
+
+/// An adder whose sum is steered by a branch, then merged back.
+constexpr llvm::StringLiteral KERNEL = R"mlir(
+handshake.func @kernel(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %cond: !handshake.channel<i1>, %start: !handshake.control<>, ...) -> (!handshake.channel<i32>, !handshake.control<>) attributes {argNames = ["a", "b", "cond", "start"], resNames = ["out0", "end"]} {
+  %sum = addi %a, %b {handshake.name = "addi0"} : <i32>
+  %true, %false = cond_br %cond, %sum {handshake.name = "cond_br0"} : <i1>, <i32>
+  %merged = merge %true, %false {handshake.name = "merge0"} : <i32>
+  end {handshake.name = "end0"} %merged, %start : <i32>, <>
+}
+)mlir";
+
+/// Writes the content to a temporary file and returns its path.
+std::string writeTemporaryFile(StringRef content) {
+  llvm::SmallString<128> path;
+  int fd;
+  EXPECT_FALSE(
+      llvm::sys::fs::createTemporaryFile("token-lineage", "csv", fd, path));
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  os << content;
+  return path.str().str();
+}
+
+/// Returns the IDs of the tokens in the slice, in order.
+std::vector<unsigned> getIDs(ArrayRef<TokenLineage::SliceEntry> slice) {
+  std::vector<unsigned> ids;
+  for (auto [token, _] : slice)
+    ids.push_back(token->id);
+  return ids;
+}
+
+/// Records two tokens flowing through the kernel, one through each side of the
+/// branch, and parses back the lineage written by the recorder.
+class TokenLineageTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ctx.loadDialect<handshake::HandshakeDialect>();
+    modOp = parseSourceString<ModuleOp>(KERNEL, &ctx);
+    ASSERT_TRUE(modOp);
+    auto funcOp = *modOp->getOps<handshake::FuncOp>().begin();
+
+    DenseMap<StringRef, Operation *> ops;
+    for (Operation &op : funcOp.getOps())
+      ops[getUniqueName(&op)] = &op;
+    Value a = funcOp.getArgument(0), b = funcOp.getArgument(1),
+          cond = funcOp.getArgument(2), start = funcOp.getArgument(3);
+    Value sum = ops["addi0"]->getResult(0);
+    Value trueRes = ops["cond_br0"]->getResult(0);
+    Value falseRes = ops["cond_br0"]->getResult(1);
+    Value merged = ops["merge0"]->getResult(0);
+
+    TokenLineageRecorder recorder(funcOp);
+    recorder.recordTransfer(a, 0, "5");
+    recorder.recordTransfer(b, 0, "1");
+    recorder.recordTransfer(start, 0);
+    recorder.recordTransfer(a, 1, "6");
+    recorder.recordTransfer(b, 1, "2");
+    recorder.recordTransfer(cond, 1, "1");
+    recorder.recordTransfer(sum, 1, "6");
+    recorder.recordTransfer(cond, 2, "0");
+    recorder.recordTransfer(sum, 2, "8");
+    recorder.recordTransfer(trueRes, 2, "6");
+    recorder.recordTransfer(merged, 2, "6");
+    recorder.recordTransfer(falseRes, 3, "8");
+    recorder.recordTransfer(merged, 3, "8");
+
+    std::string csv;
+    llvm::raw_string_ostream os(csv);
+    recorder.write(os);
+    ASSERT_TRUE(succeeded(lineage.parseFromFile(writeTemporaryFile(csv))));
+  }
+
+  MLIRContext ctx;
+  OwningOpRef<ModuleOp> modOp;
+  TokenLineage lineage;
+};
+
+} // namespace
+
+TEST_F(TokenLineageTest, inferParents) {
+  // Tokens are numbered by cycle, then by channel order in the function
+  ASSERT_EQ(lineage.getTokens().size(), 13u);
+  auto parentsOf = [&](StringRef component, unsigned port, unsigned seq) {
+    const TokenLineage::Token *token = lineage.getToken(component, port, seq);
+    EXPECT_NE(token, nullptr);
+    return token ? std::vector<unsigned>(token->parents.begin(),
+                                         token->parents.end())
+                 : std::vector<unsigned>{};
+  };
+
+  // Arguments have no parents
+  EXPECT_TRUE(parentsOf("a", 0, 1).empty());
+  // The k-th sum comes from the k-th token on each input
+  EXPECT_EQ(parentsOf("addi0", 0, 0), (std::vector<unsigned>{0, 1}));
+  EXPECT_EQ(parentsOf("addi0", 0, 1), (std::vector<unsigned>{3, 4}));
+  // Tokens on both branch outputs are numbered together
+  EXPECT_EQ(parentsOf("cond_br0", 0, 0), (std::vector<unsigned>{5, 6}));
+  EXPECT_EQ(parentsOf("cond_br0", 1, 0), (std::vector<unsigned>{7, 8}));
+  // Merged tokens come from data inputs in arrival order
+  EXPECT_EQ(parentsOf("merge0", 0, 0), (std::vector<unsigned>{9}));
+  EXPECT_EQ(parentsOf("merge0", 0, 1), (std::vector<unsigned>{11}));
+
+  const TokenLineage::Token *sum = lineage.getToken(8);
+  ASSERT_NE(sum, nullptr);
+  EXPECT_EQ(sum->cycle, 2u);
+  EXPECT_EQ(sum->data, "8");
+  EXPECT_EQ(sum->channel.dstComponent, "cond_br0");
+  EXPECT_EQ(sum->channel.dstPort, 1u);
+  EXPECT_EQ(lineage.getToken(13), nullptr);
+  EXPECT_EQ(lineage.getToken("addi0", 0, 2), nullptr);
+}
+
+TEST_F(TokenLineageTest, getSlice) {
+  const TokenLineage::Token *last = lineage.getToken("merge0", 0, 1);
+  ASSERT_NE(last, nullptr);
+  std::vector<TokenLineage::SliceEntry> backward =
+      lineage.getSlice(*last, TokenLineage::Direction::BACKWARD);
+  EXPECT_EQ(getIDs(backward), (std::vector<unsigned>{12, 11, 7, 8, 3, 4}));
+  std::vector<unsigned> depths;
+  for (auto [_, depth] : backward)
+    depths.push_back(depth);
+  EXPECT_EQ(depths, (std::vector<unsigned>{0, 1, 2, 2, 3, 3}));
+
+  EXPECT_EQ(getIDs(lineage.getSlice(*last, TokenLineage::Direction::BACKWARD,
+                                    /*maxDepth=*/1)),
+            (std::vector<unsigned>{12, 11}));
+
+  const TokenLineage::Token *first = lineage.getToken("a", 0, 0);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(getIDs(lineage.getSlice(*first, TokenLineage::Direction::FORWARD)),
+            (std::vector<unsigned>{0, 6, 9, 10}));
+}
+
+TEST(TokenLineageParseTest, malformedFiles) {
+  constexpr llvm::StringLiteral HEADER =
+      "id, cycle, src_component, src_port, dst_component, dst_port, seq, "
+      "data, parents\n";
+  auto parse = [&](StringRef body) {
+    TokenLineage lineage;
+    return lineage.parseFromFile(writeTemporaryFile(HEADER.str() + body.str()));
+  };
+
+  EXPECT_TRUE(succeeded(parse("0, 0, a, 0, addi0, 0, 0, 5, \n"
+                              "1, 1, addi0, 0, end0, 0, 0, 5, 0\n")));
+  // Missing field
+  EXPECT_TRUE(failed(parse("0, 0, a, 0, addi0, 0, 0, 5\n")));
+  // Non-consecutive IDs
+  EXPECT_TRUE(failed(parse("1, 0, a, 0, addi0, 0, 0, 5, \n")));
+  // Gap in the sequence numbers of a channel
+  EXPECT_TRUE(failed(parse("0, 0, a, 0, addi0, 0, 1, 5, \n")));
+  // Unknown parent
+  EXPECT_TRUE(failed(parse("0, 0, a, 0, addi0, 0, 0, 5, 3\n")));
+
+  TokenLineage lineage;
+  EXPECT_TRUE(failed(lineage.parseFromFile("/nonexistent/lineage.csv")));
+}
@@ -0,0 +1,180 @@
+//===- DOTTest.cpp - Tests for DOT graphs -----------------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for building, editing, parsing, and querying DOT graphs. The last
+// test doubles as a benchmark of parsing and adjacency queries on a large
+// generated graph.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Support/DOT.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <gtest/gtest.h>
+
+using namespace dynamatic;
+
+namespace {
+
+/// Writes a DOT graph with `numSubgraphs` subgraphs of `nodesPerSubgraph`
+/// nodes each to a temporary file and returns its path. Nodes form a chain
+/// within their subgraph, and the last node of each subgraph connects to the
+/// first node of the next subgraph.
+std::string writeChainGraph(unsigned numSubgraphs, unsigned nodesPerSubgraph) {
+  llvm::SmallString<128> path;
+  int fd;
+  EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("dot-test", "dot", fd, path));
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+
+  auto name = [&](unsigned sub, unsigned idx) {
+    return "\"n" + std::to_string(sub) + "_" + std::to_string(idx) + "\"";
+  };
+  os << "digraph G {\n";
+  for (unsigned sub = 0; sub < numSubgraphs; ++sub) {
+    os << "  subgraph cluster_" << sub << " {\n";
+    for (unsigned idx = 0; idx < nodesPerSubgraph; ++idx)
+      os << "    " << name(sub, idx) << " [\"type\"=\"op\"]\n";
+    for (unsigned idx = 1; idx < nodesPerSubgraph; ++idx)
+      os << "    " << name(sub, idx - 1) << " -> " << name(sub, idx) << "\n";
+    os << "  }\n";
+  }
+  for (unsigned sub = 1; sub < numSubgraphs; ++sub) {
+    os << "  " << name(sub - 1, nodesPerSubgraph - 1) << " -> "
+       << name(sub, 0) << "\n";
+  }
+  os << "}\n";
+  return path.str().str();
+}
+
+TEST(DOTGraphTest, adjacency) {
+  DOTGraph graph;
+  DOTGraph::Builder builder = graph.getBuilder();
+  DOTGraph::Subgraph &sub = builder.addSubgraph("cluster", builder.getRoot());
+  DOTGraph::Subgraph &subsub = builder.addSubgraph("inner", sub);
+  builder.addNode("a", builder.getRoot());
+  builder.addNode("b", subsub);
+  const DOTGraph::Edge &ab = builder.addEdge("a", "b", sub);
+  const DOTGraph::Edge &bb = builder.addEdge("b", "b", subsub);
+  // Node "c" is used before being defined
+  const DOTGraph::Edge &bc = builder.addEdge("b", "c", builder.getRoot());
+  builder.addNode("c", sub);
+
+  const DOTGraph::Node *a = graph.getNode("a");
+  const DOTGraph::Node *b = graph.getNode("b");
+  const DOTGraph::Node *c = graph.getNode("c");
+  ASSERT_TRUE(a && b && c);
+
+  EXPECT_EQ(graph.getSuccessors(*a).size(), 1u);
+  EXPECT_EQ(graph.getPredecessors(*a).size(), 0u);
+  EXPECT_EQ(graph.getSuccessors(*b).size(), 2u);
+  EXPECT_EQ(graph.getPredecessors(*b).size(), 2u);
+  EXPECT_EQ(graph.getPredecessors(*c).front(), &bc);
+
+  SmallVector<const DOTGraph::Edge *> adjB = graph.getAdjacentEdges(*b);
+  EXPECT_EQ(adjB.size(), 3u);
+  EXPECT_TRUE(llvm::is_contained(adjB, &ab));
+  EXPECT_TRUE(llvm::is_contained(adjB, &bb));
+  EXPECT_TRUE(llvm::is_contained(adjB, &bc));
+
+  EXPECT_EQ(graph.getSubgraph("cluster"), &sub);
+  EXPECT_EQ(graph.getSubgraph("inner"), &subsub);
+  EXPECT_EQ(graph.getSubgraph("missing"), nullptr);
+  EXPECT_TRUE(graph.isInSubgraph(*b, sub));
+  EXPECT_TRUE(graph.isInSubgraph(*c, sub));
+  EXPECT_FALSE(graph.isInSubgraph(*c, subsub));
+  EXPECT_FALSE(graph.isInSubgraph(*a, sub));
+}
+
+TEST(DOTGraphTest, incrementalEdits) {
+  DOTGraph graph;
+  DOTGraph::Builder builder = graph.getBuilder();
+  DOTGraph::Subgraph &sub = builder.addSubgraph("cluster", builder.getRoot());
+  builder.addNode("a", builder.getRoot());
+  builder.addNode("b", sub);
+  builder.addNode("c", sub);
+  const DOTGraph::Edge &ab = builder.addEdge("a", "b", builder.getRoot());
+  builder.addEdge("b", "c", sub);
+  builder.addEdge("c", "a", builder.getRoot());
+
+  const DOTGraph::Node *a = graph.getNode("a");
+  const DOTGraph::Node *b = graph.getNode("b");
+  const DOTGraph::Node *c = graph.getNode("c");
+
+  builder.removeEdge(ab);
+  EXPECT_TRUE(graph.getSuccessors(*a).empty());
+  EXPECT_EQ(graph.getPredecessors(*b).size(), 0u);
+  EXPECT_EQ(graph.getRoot().edges.size(), 1u);
+
+  builder.moveNode(*c, builder.getRoot());
+  EXPECT_EQ(c->subgraph, &graph.getRoot());
+  EXPECT_FALSE(graph.isInSubgraph(*c, sub));
+  EXPECT_EQ(sub.nodes.size(), 1u);
+
+  builder.removeNode(*b);
+  EXPECT_EQ(graph.getNode("b"), nullptr);
+  EXPECT_TRUE(sub.nodes.empty());
+  EXPECT_TRUE(sub.edges.empty());
+  EXPECT_TRUE(graph.getPredecessors(*c).empty());
+  EXPECT_EQ(graph.getAdjacentEdges(*a).size(), 1u);
+}
+
+TEST(DOTGraphTest, parse) {
+  std::string path = writeChainGraph(3, 4);
+
+  DOTGraph parsed;
+  ASSERT_TRUE(succeeded(parsed.getBuilder().parseFromFile(path)));
+  llvm::sys::fs::remove(path);
+
+  const DOTGraph::Subgraph *sub = parsed.getSubgraph("cluster_1");
+  ASSERT_NE(sub, nullptr);
+  EXPECT_EQ(sub->nodes.size(), 4u);
+  EXPECT_EQ(sub->edges.size(), 3u);
+
+  const DOTGraph::Node *first = parsed.getNode("n1_0");
+  ASSERT_NE(first, nullptr);
+  EXPECT_TRUE(parsed.isInSubgraph(*first, *sub));
+  ASSERT_EQ(parsed.getPredecessors(*first).size(), 1u);
+  EXPECT_EQ(parsed.getPredecessors(*first).front()->srcNode->id, "n0_3");
+  EXPECT_EQ(parsed.getAdjacentEdges(*first).size(), 2u);
+}
+
+/// Parses a large generated graph and queries the adjacent edges of all its
+/// nodes. With indexed adjacency, the queries take time linear in the number
+/// of edges instead of quadratic.
+TEST(DOTGraphTest, largeGraphBenchmark) {
+  constexpr unsigned numSubgraphs = 200, nodesPerSubgraph = 200;
+  std::string path = writeChainGraph(numSubgraphs, nodesPerSubgraph);
+
+  using Clock = std::chrono::steady_clock;
+  auto toMs = [](Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+  };
+
+  Clock::time_point start = Clock::now();
+  DOTGraph parsed;
+  ASSERT_TRUE(succeeded(parsed.getBuilder().parseFromFile(path)));
+  Clock::time_point parsedTime = Clock::now();
+  llvm::sys::fs::remove(path);
+
+  size_t numAdjacencies = 0;
+  for (const DOTGraph::Subgraph *sub : parsed.getRoot().subgraphs) {
+    for (const DOTGraph::Node *node : sub->nodes)
+      numAdjacencies += parsed.getAdjacentEdges(*node).size();
+  }
+  Clock::time_point queriedTime = Clock::now();
+
+  // Every edge is adjacent to exactly two nodes
+  constexpr size_t numEdges = numSubgraphs * nodesPerSubgraph - 1;
+  EXPECT_EQ(numAdjacencies, 2 * numEdges);
+
+  RecordProperty("parse_ms", std::to_string(toMs(parsedTime - start)));
+  RecordProperty("query_ms", std::to_string(toMs(queriedTime - parsedTime)));
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+//===- SmvConeOfInfluenceTest.cpp - Tests for COI reduction -----*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for the exact and depth-bounded cone-of-influence reduction of
+// SMV modules, and for mapping counterexamples of reduced modules back to the
+// full circuit.
+//
+//===----------------------------------------------------------------------===//
+
+#include "experimental/Support/SmvConeOfInfluence.h"
+#include "experimental/Support/SmvModel.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::experimental;
+
+namespace {
+
+using Kind = SmvModule::Spec::Kind;
+
+/// Builds a chain of three buffers whose output is checked by a property,
+/// next to a counter whose internal state is exposed by a define and to an
+/// unrelated source feeding a sink.
+SmvModule buildKernel() {
+  SmvModule mod("kernel", {"ins", "ins_valid", "outs_ready"});
+  mod.addInstance("buf0", "buffer", {"ins", "ins_valid", "buf1.ins_ready"});
+  mod.addInstance("buf1", "buffer",
+                  {"buf0.outs", "buf0.outs_valid", "buf2.ins_ready"});
+  mod.addInstance("buf2", "buffer",
+                  {"buf1.outs", "buf1.outs_valid", "outs_ready"});
+  mod.addInstance("cnt0", "counter", {"outs_ready"});
+  mod.addInstance("src0", "source", {});
+  mod.addInstance("snk0", "sink", {"src0.outs_valid"});
+  mod.addDefine("outs", "buf2.outs");
+  mod.addDefine("outs_valid", "buf2.outs_valid");
+  mod.addDefine("count", "cnt0.count");
+  mod.addSpec(Kind::INVAR, "buf0.count <= 1");
+  mod.addSpec(Kind::INVARSPEC, "buf2.outs_valid -> buf2.outs < 4", "p0");
+
+  mod.addChannel("buf0", "buf1", "buf0.outs_valid", "buf1.ins_ready",
+                 {{"buf0.outs", "0..7"}});
+  mod.addChannel("buf1", "buf2", "buf1.outs_valid", "buf2.ins_ready",
+                 {{"buf1.outs", "0..7"}});
+  mod.addChannel("buf2", "", "buf2.outs_valid", "outs_ready",
+                 {{"buf2.outs", "0..7"}});
+  mod.addChannel("src0", "snk0", "src0.outs_valid", "snk0.ins_ready");
+  return mod;
+}
+
+/// Returns the names of the module's instances, in order.
+std::vector<std::string> getInstanceNames(const SmvModule &mod) {
+  std::vector<std::string> names;
+  for (const SmvModule::Instance &inst : mod.instances)
+    names.push_back(inst.name);
+  return names;
+}
+
+} // namespace
+
+TEST(SmvConeOfInfluenceTest, exactReduction) {
+  SmvModule mod = buildKernel();
+  SmvReduction reduction = reduceToConeOfInfluence(mod);
+
+  // The counter is kept because a define exposes its internal state
+  EXPECT_EQ(reduction.numInstances, 6u);
+  EXPECT_EQ(reduction.removedInstances,
+            (std::vector<std::string>{"src0", "snk0"}));
+  EXPECT_EQ(getInstanceNames(mod),
+            (std::vector<std::string>{"buf0", "buf1", "buf2", "cnt0"}));
+  EXPECT_TRUE(reduction.exact);
+  EXPECT_TRUE(reduction.freeInputs.empty());
+  EXPECT_EQ(reduction.numCutChannels, 0u);
+  EXPECT_EQ(reduction.numDroppedConstraints, 0u);
+  EXPECT_TRUE(mod.variables.empty());
+
+  // The constraint on the cone is kept, as are the channels between kept units
+  ASSERT_EQ(mod.specs.size(), 2u);
+  EXPECT_EQ(mod.specs[0].expr, "buf0.count <= 1");
+  EXPECT_EQ(mod.channels.size(), 3u);
+}
+
+TEST(SmvConeOfInfluenceTest, boundedReduction) {
+  SmvModule mod = buildKernel();
+  SmvReduction reduction = reduceToConeOfInfluence(mod, /*maxDepth=*/1);
+
+  EXPECT_EQ(reduction.removedInstances,
+            (std::vector<std::string>{"buf0", "src0", "snk0"}));
+  EXPECT_EQ(getInstanceNames(mod),
+            (std::vector<std::string>{"buf1", "buf2", "cnt0"}));
+  EXPECT_FALSE(reduction.exact);
+  EXPECT_EQ(reduction.numCutChannels, 1u);
+  EXPECT_EQ(reduction.numDroppedConstraints, 1u);
+  EXPECT_EQ(mod.channels.size(), 2u);
+
+  // Signals of the removed buffer become free inputs
+  ASSERT_EQ(reduction.freeInputs.size(), 2u);
+  EXPECT_EQ(reduction.freeInputs.lookup("buf0$outs"), "buf0.outs");
+  EXPECT_EQ(reduction.freeInputs.lookup("buf0$outs_valid"), "buf0.outs_valid");
+  EXPECT_EQ(mod.instances.front().args,
+            (std::vector<std::string>{"buf0$outs", "buf0$outs_valid",
+                                      "buf2.ins_ready"}));
+  ASSERT_EQ(mod.variables.size(), 2u);
+  EXPECT_EQ(mod.variables[0].name, "buf0$outs");
+  EXPECT_EQ(mod.variables[0].type, "0..7");
+  EXPECT_EQ(mod.variables[1].name, "buf0$outs_valid");
+  EXPECT_EQ(mod.variables[1].type, "boolean");
+
+  // The constraint on the removed buffer's state is dropped, and the free
+  // inputs follow the handshake protocol
+  ASSERT_EQ(mod.specs.size(), 2u);
+  EXPECT_EQ(mod.specs[0].name, "p0");
+  EXPECT_EQ(mod.specs[1].kind, Kind::TRANS);
+  EXPECT_EQ(mod.specs[1].expr,
+            "(buf0$outs_valid & !buf1.ins_ready) -> (next(buf0$outs_valid) & "
+            "next(buf0$outs) = buf0$outs)");
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  reduction.print(os);
+  EXPECT_NE(report.find("kept 3/6 instance(s) (50%)"), std::string::npos);
+  EXPECT_NE(report.find("buf0$outs_valid -> buf0.outs_valid"),
+            std::string::npos);
+  EXPECT_NE(report.find("over-approximation"), std::string::npos);
+}
+
+TEST(SmvConeOfInfluenceTest, mapTrace) {
+  SmvModule mod = buildKernel();
+  SmvReduction reduction = reduceToConeOfInfluence(mod, /*maxDepth=*/1);
+
+  FailureOr<SmvTrace> trace =
+      SmvTrace::parse("Trace Description: Counterexample\n"
+                      "  -> State: 1.1 <-\n"
+                      "    kernel.buf0$outs_valid = TRUE\n"
+                      "    buf0$outs = 3\n"
+                      "    kernel.buf1.full = FALSE\n");
+  ASSERT_TRUE(succeeded(trace));
+  reduction.mapTrace(*trace);
+  EXPECT_EQ(trace->getValue(0, "kernel.buf0.outs_valid"), "TRUE");
+  EXPECT_EQ(trace->getValue(0, "buf0.outs"), "3");
+  EXPECT_EQ(trace->getValue(0, "kernel.buf1.full"), "FALSE");
+  EXPECT_EQ(trace->getValue(0, "kernel.buf0$outs_valid"), std::nullopt);
+}
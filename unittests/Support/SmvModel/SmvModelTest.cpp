@@ -0,0 +1,268 @@
+//===- SmvModelTest.cpp - Tests for SMV models and traces -------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for printing in-memory SMV models, building formal testbenches,
+// and parsing counterexample traces in NuSMV/nuXmv's text and XML formats.
+//
+//===----------------------------------------------------------------------===//
+
+#include "experimental/Support/SmvModel.h"
+#include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
+#include "dynamatic/Dialect/Handshake/HandshakeTypes.h"
+#include "experimental/Support/CreateSmvFormalTestbench.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/MLIRContext.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::experimental;
+
+namespace {
+
+/// Returns the module printed in SMV syntax.
+std::string print(const SmvModule &mod) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  mod.print(os);
+  return str;
+}
+
+/// Returns the trace printed with one line per variable change.
+std::string print(const SmvTrace &trace) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  trace.print(os);
+  return str;
+}
+
+/// First counterexample of a textual trace (show_traces -p 0), followed by a
+/// second one that must be ignored.
+constexpr llvm::StringLiteral TEXT_TRACE = R"(
+-- invariant model.count <= 1 is false
+-- as demonstrated by the following execution sequence
+Trace Description: LTL Counterexample
+Trace Type: Counterexample
+  -> State: 1.1 <-
+    model.count = 0
+    model.full = FALSE
+  -> Input: 1.2 <-
+    seq.outs = TRUE
+  -- Loop starts here
+  -> State: 1.2 <-
+    model.count = 1
+  -> State: 1.3 <-
+    model.full = TRUE
+Trace Description: Second Counterexample
+Trace Type: Counterexample
+  -> State: 2.1 <-
+    model.count = 3
+)";
+
+/// The same kind of trace in XML format (show_traces -p 4).
+constexpr llvm::StringLiteral XML_TRACE = R"(<?xml version="1.0"?>
+<counter-example type="0" id="1" desc="LTL &quot;Counterexample&quot;" >
+  <node>
+    <state id="1">
+      <value variable="model.count">0</value>
+      <value variable="model.cmp">a &lt; b</value>
+    </state>
+    <input id="2">
+      <value variable="seq.outs">TRUE</value>
+    </input>
+  </node>
+  <node>
+    <state id="2">
+      <value variable="model.count">1</value>
+    </state>
+  </node>
+  <loops> 2 </loops>
+</counter-example>
+)";
+
+} // namespace
+
+TEST(SmvModelTest, printModule) {
+  SmvModule mod("counter", {"inc"});
+  mod.addVariable("count", "0..3");
+  mod.addVariable("limit", "0..3", /*frozen=*/true);
+  mod.addInstance("fork0", "fork", {"inc", "TRUE"});
+  mod.addDefine("full", "count = limit");
+  mod.addAssignment("count", "0", "full ? count : count + 1");
+  mod.addSpec(SmvModule::Spec::Kind::INVAR, "limit > 0", "ignored");
+  mod.addSpec(SmvModule::Spec::Kind::INVARSPEC, "count <= limit", "p0",
+              "count stays bounded");
+
+  EXPECT_EQ(print(mod), "MODULE counter(inc)\n"
+                        "  VAR count : 0..3;\n"
+                        "  FROZENVAR limit : 0..3;\n"
+                        "  VAR fork0 : fork(inc, TRUE);\n"
+                        "  DEFINE full := count = limit;\n"
+                        "  ASSIGN\n"
+                        "    init(count) := 0;\n"
+                        "    next(count) := full ? count : count + 1;\n"
+                        "  INVAR limit > 0;\n"
+                        "  -- count stays bounded\n"
+                        "  INVARSPEC NAME p0 := count <= limit;\n");
+
+  ASSERT_NE(mod.getInstance("fork0"), nullptr);
+  EXPECT_EQ(mod.getInstance("fork0")->moduleName, "fork");
+  EXPECT_EQ(mod.getInstance("fork1"), nullptr);
+  ASSERT_NE(mod.getDefine("full"), nullptr);
+  EXPECT_EQ(mod.getDefine("full")->expr, "count = limit");
+}
+
+TEST(SmvModelTest, printModel) {
+  SmvModel model;
+  model.addInclude("kernel.smv");
+  model.addInclude("kernel.smv");
+  model.addModule("main").addDefine("ok", "TRUE");
+
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  model.print(os);
+  EXPECT_EQ(str, "#include \"kernel.smv\"\n"
+                 "\n"
+                 "MODULE main\n"
+                 "  DEFINE ok := TRUE;\n");
+  EXPECT_NE(model.getModule("main"), nullptr);
+  EXPECT_EQ(model.getModule("kernel"), nullptr);
+}
+
+TEST(SmvModelTest, formalTestbench) {
+  MLIRContext ctx;
+  ctx.loadDialect<handshake::HandshakeDialect>();
+  Type i1 = IntegerType::get(&ctx, 1);
+  Type boolChannel = handshake::ChannelType::get(i1, {});
+  Type control = handshake::ControlType::get(&ctx);
+
+  SmvTestbenchConfig config;
+  config.arguments = {{"A", boolChannel}, {"start", control}, {"clk", i1}};
+  config.results = {{"out0", boolChannel}, {"end", control}};
+  config.modelSmvName = "kernel";
+  config.nrOfTokens = 1;
+  config.generateExactNrOfTokens = true;
+  config.syncOutput = true;
+  config.deadBufferOutput = true;
+  SmvModel model = createSmvFormalTestbenchModel(config);
+
+  EXPECT_EQ(model.includes, std::vector<std::string>{"kernel.smv"});
+  std::vector<std::string> moduleNames;
+  for (const SmvModule &mod : model.modules)
+    moduleNames.push_back(mod.name);
+  EXPECT_EQ(moduleNames,
+            (std::vector<std::string>{"bool_input_exact", "ctrl_input_exact",
+                                      "tb_join", "main"}));
+
+  // Boolean generators keep their data until it is consumed
+  const SmvModule *boolGen = model.getModule("bool_input_exact");
+  ASSERT_NE(boolGen, nullptr);
+  EXPECT_EQ(boolGen->params,
+            (std::vector<std::string>{"nReady0", "exact_tokens"}));
+  ASSERT_EQ(boolGen->assignments.size(), 2u);
+  EXPECT_EQ(boolGen->assignments[0].init, "0");
+  EXPECT_EQ(boolGen->assignments[1].var, "outs");
+  EXPECT_FALSE(boolGen->assignments[1].init);
+
+  const SmvModule *join = model.getModule("tb_join");
+  ASSERT_NE(join, nullptr);
+  ASSERT_NE(join->getDefine("ins_0_ready"), nullptr);
+  EXPECT_EQ(join->getDefine("ins_0_ready")->expr, "ins_1_valid & outs_ready");
+
+  const SmvModule *main = model.getModule("main");
+  ASSERT_NE(main, nullptr);
+  ASSERT_NE(main->getInstance("seq_generator_A"), nullptr);
+  EXPECT_EQ(main->getInstance("seq_generator_A")->args,
+            (std::vector<std::string>{"kernel.A_ready", "1"}));
+  const SmvModule::Instance *mut = main->getInstance("kernel");
+  ASSERT_NE(mut, nullptr);
+  EXPECT_EQ(mut->args,
+            (std::vector<std::string>{
+                "self", "seq_generator_A.outs", "seq_generator_A.outs_valid",
+                "seq_generator_start.outs_valid", "join_global.ins_0_ready",
+                "join_global.ins_1_ready"}));
+  ASSERT_NE(main->getInstance("join_global"), nullptr);
+  EXPECT_EQ(main->getInstance("join_global")->args,
+            (std::vector<std::string>{"kernel.out0_valid", "kernel.end_valid",
+                                      "global_ready"}));
+  ASSERT_NE(main->getDefine("global_ready"), nullptr);
+  EXPECT_EQ(main->getDefine("global_ready")->expr, "!end_full");
+}
+
+TEST(SmvTraceTest, parseText) {
+  FailureOr<SmvTrace> trace = SmvTrace::parse(TEXT_TRACE);
+  ASSERT_TRUE(succeeded(trace));
+  EXPECT_EQ(trace->getDescription(), "LTL Counterexample");
+  ASSERT_EQ(trace->size(), 3u);
+  EXPECT_EQ(trace->getLoopStart(), 1u);
+
+  // State variables are carried over, inputs are not
+  EXPECT_EQ(trace->getValue(1, "model.count"), "1");
+  EXPECT_EQ(trace->getValue(1, "model.full"), "FALSE");
+  EXPECT_EQ(trace->getValue(1, "seq.outs"), "TRUE");
+  EXPECT_EQ(trace->getValue(2, "model.count"), "1");
+  EXPECT_EQ(trace->getValue(2, "model.full"), "TRUE");
+  EXPECT_EQ(trace->getValue(2, "seq.outs"), std::nullopt);
+  EXPECT_EQ(trace->getValue(0, "model.unknown"), std::nullopt);
+
+  EXPECT_EQ(trace->getChanges(0),
+            (std::vector<std::string>{"model.count", "model.full"}));
+  EXPECT_EQ(trace->getChanges(1),
+            (std::vector<std::string>{"model.count", "seq.outs"}));
+  EXPECT_EQ(trace->getChanges(2), (std::vector<std::string>{"model.full"}));
+
+  EXPECT_EQ(print(*trace), "LTL Counterexample (3 steps)\n"
+                           "step 0\n"
+                           "  model.count = 0\n"
+                           "  model.full = FALSE\n"
+                           "step 1 (loop starts here)\n"
+                           "  model.count = 1\n"
+                           "  seq.outs = TRUE\n"
+                           "step 2\n"
+                           "  model.full = TRUE\n");
+}
+
+TEST(SmvTraceTest, parseXML) {
+  FailureOr<SmvTrace> trace = SmvTrace::parse(XML_TRACE);
+  ASSERT_TRUE(succeeded(trace));
+  EXPECT_EQ(trace->getDescription(), "LTL \"Counterexample\"");
+  ASSERT_EQ(trace->size(), 2u);
+  EXPECT_EQ(trace->getLoopStart(), 1u);
+  EXPECT_EQ(trace->getValue(0, "model.cmp"), "a < b");
+  EXPECT_EQ(trace->getValue(1, "model.cmp"), "a < b");
+  EXPECT_EQ(trace->getValue(1, "model.count"), "1");
+  EXPECT_EQ(trace->getValue(1, "seq.outs"), "TRUE");
+  EXPECT_EQ(trace->getChanges(1),
+            (std::vector<std::string>{"model.count", "seq.outs"}));
+}
+
+TEST(SmvTraceTest, renameVariables) {
+  FailureOr<SmvTrace> trace = SmvTrace::parse(TEXT_TRACE);
+  ASSERT_TRUE(succeeded(trace));
+  trace->renameVariables([](StringRef var) {
+    var.consume_front("model.");
+    return var.str();
+  });
+  EXPECT_EQ(trace->getValue(0, "count"), "0");
+  EXPECT_EQ(trace->getValue(0, "model.count"), std::nullopt);
+  // Renamed state variables are still carried over
+  EXPECT_EQ(trace->getChanges(2), (std::vector<std::string>{"full"}));
+}
+
+TEST(SmvTraceTest, malformedTraces) {
+  EXPECT_TRUE(failed(SmvTrace::parse("-- invariant is true\n")));
+  EXPECT_TRUE(failed(SmvTrace::parse("Trace Description: empty\n")));
+  EXPECT_TRUE(failed(
+      SmvTrace::parse("Trace Description: bad\n  -> State: 1.0 <-\n")));
+  EXPECT_TRUE(failed(SmvTrace::parse("<counter-example desc=\"empty\">"
+                                     "</counter-example>")));
+  EXPECT_TRUE(failed(
+      SmvTrace::parse("<counter-example desc=\"bad\"><state id=\"x\">")));
+  EXPECT_TRUE(failed(SmvTrace::parseFromFile("/nonexistent/trace.xml")));
+}
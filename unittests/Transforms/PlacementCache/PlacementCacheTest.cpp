@@ -0,0 +1,233 @@
+//===- PlacementCacheTest.cpp - Tests for the placement cache ---*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for the stable references of channels, which key cached buffer
+// placements, and for the (de)serialization of the buffer placement cache.
+//
+//===----------------------------------------------------------------------===//
+
+#include "dynamatic/Transforms/BufferPlacement/Utils/PlacementCache.h"
+#include "dynamatic/Analysis/NameAnalysis.h"
+#include "dynamatic/Dialect/Handshake/HandshakeDialect.h"
+#include "dynamatic/Support/Fingerprint.h"
+#include "experimental/Support/StdProfiler.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::buffer;
+using namespace dynamatic::experimental;
+
+namespace {
+
+/// An adder in the first basic block feeding a subtractor in the second one.
+constexpr llvm::StringLiteral KERNEL = R"mlir(
+handshake.func @kernel(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %c: !handshake.channel<i32>, %start: !handshake.control<>, ...) -> (!handshake.channel<i32>, !handshake.control<>) attributes {argNames = ["a", "b", "c", "start"], resNames = ["out0", "end"]} {
+  %sum = addi %a, %b {handshake.bb = 0 : ui32, handshake.name = "addi0"} : <i32>
+  %diff = subi %sum, %c {handshake.bb = 1 : ui32, handshake.name = "subi0"} : <i32>
+  end {handshake.bb = 1 : ui32, handshake.name = "end0"} %diff, %start : <i32>, <>
+}
+)mlir";
+
+/// The same kernel, with an additional operation at the beginning of the
+/// second basic block.
+constexpr llvm::StringLiteral MODIFIED_KERNEL = R"mlir(
+handshake.func @kernel(%a: !handshake.channel<i32>, %b: !handshake.channel<i32>, %c: !handshake.channel<i32>, %start: !handshake.control<>, ...) -> (!handshake.channel<i32>, !handshake.control<>) attributes {argNames = ["a", "b", "c", "start"], resNames = ["out0", "end"]} {
+  %sum = addi %a, %b {handshake.bb = 0 : ui32, handshake.name = "addi0"} : <i32>
+  %twice = addi %c, %c {handshake.bb = 1 : ui32, handshake.name = "addi1"} : <i32>
+  %diff = subi %sum, %twice {handshake.bb = 1 : ui32, handshake.name = "subi0"} : <i32>
+  end {handshake.bb = 1 : ui32, handshake.name = "end0"} %diff, %start : <i32>, <>
+}
+)mlir";
+
+/// Returns the path of a new temporary JSON file.
+std::string getTemporaryPath() {
+  llvm::SmallString<128> path;
+  EXPECT_FALSE(
+      llvm::sys::fs::createTemporaryFile("placement-cache", "json", path));
+  return path.str().str();
+}
+
+/// Returns the operations of the function, mapped from their name.
+DenseMap<StringRef, Operation *> getOpsByName(handshake::FuncOp funcOp) {
+  DenseMap<StringRef, Operation *> ops;
+  for (Operation &op : funcOp.getOps())
+    ops[getUniqueName(&op)] = &op;
+  return ops;
+}
+
+/// Parses kernels in a context with the Handshake dialect loaded.
+class ChannelRefTest : public testing::Test {
+protected:
+  void SetUp() override { ctx.loadDialect<handshake::HandshakeDialect>(); }
+
+  handshake::FuncOp parse(StringRef kernel) {
+    modules.push_back(parseSourceString<ModuleOp>(kernel, &ctx));
+    EXPECT_TRUE(modules.back());
+    return *modules.back()->getOps<handshake::FuncOp>().begin();
+  }
+
+  MLIRContext ctx;
+  SmallVector<OwningOpRef<ModuleOp>> modules;
+};
+
+/// Returns a cache holding the placement of a single function, with a value
+/// for every field.
+PlacementCache getCache() {
+  CachedFuncPlacement placement;
+  placement.config = "fpga20|4.000000|components.json";
+  placement.fingerprint.func = 0xfedcba9876543210;
+  placement.fingerprint.blocks = {{0, 0x1}, {1, 0xffffffffffffffff}};
+  placement.archs.push_back(CachedArch{0, 1, 1});
+  placement.archs.push_back(CachedArch{1, 1, 99});
+
+  CachedCFDFC cfdfc;
+  cfdfc.cycle = {1};
+  cfdfc.numExecs = 99;
+  cfdfc.throughput = 0.5;
+  cfdfc.occupancy = {{"0.0#0->1.0@0", 1.5}, {"1.0#0->1.1@0", 0.0}};
+  placement.cfdfcs.push_back(cfdfc);
+
+  PlacementResult transparent;
+  transparent.numOneSlotR = 1;
+  transparent.numFifoNone = 3;
+  PlacementResult opaque;
+  opaque.numOneSlotDV = 1;
+  opaque.numShiftRegDV = 2;
+  opaque.counterBufferLatencies = {4, 7};
+  placement.placement = {{"0.0#0->1.0@0", transparent},
+                         {"arg0.2->1.0@1", opaque}};
+
+  PlacementCache cache;
+  cache.functions["kernel"] = placement;
+  return cache;
+}
+
+} // namespace
+
+TEST_F(ChannelRefTest, channelRefs) {
+  handshake::FuncOp funcOp = parse(KERNEL);
+  StableIRRefs refs(funcOp);
+  DenseMap<StringRef, Operation *> ops = getOpsByName(funcOp);
+
+  EXPECT_EQ(refs.getRef(ops["addi0"]), "0.0");
+  EXPECT_EQ(refs.getRef(ops["subi0"]), "1.0");
+  EXPECT_EQ(refs.getRef(ops["end0"]), "1.1");
+  EXPECT_EQ(refs.getBlock(ops["subi0"]), 1u);
+
+  // Channels are identified by their producer's result and consumer's operand
+  EXPECT_EQ(getChannelRef(ops["addi0"]->getResult(0), refs), "0.0#0->1.0@0");
+  EXPECT_EQ(getChannelRef(ops["subi0"]->getResult(0), refs), "1.0#0->1.1@0");
+  EXPECT_EQ(getChannelRef(funcOp.getArgument(0), refs), "arg0.0->0.0@0");
+  EXPECT_EQ(getChannelRef(funcOp.getArgument(2), refs), "arg0.2->1.0@1");
+}
+
+TEST_F(ChannelRefTest, stableAcrossBlocks) {
+  handshake::FuncOp funcOp = parse(KERNEL);
+  handshake::FuncOp modFuncOp = parse(MODIFIED_KERNEL);
+  StableIRRefs refs(funcOp), modRefs(modFuncOp);
+  DenseMap<StringRef, Operation *> ops = getOpsByName(funcOp);
+  DenseMap<StringRef, Operation *> modOps = getOpsByName(modFuncOp);
+
+  // Inserting an operation in the second block does not change references in
+  // the first one
+  EXPECT_EQ(refs.getRef(ops["addi0"]), modRefs.getRef(modOps["addi0"]));
+  EXPECT_EQ(getChannelRef(funcOp.getArgument(0), refs),
+            getChannelRef(modFuncOp.getArgument(0), modRefs));
+
+  // References inside the modified block do change
+  EXPECT_EQ(modRefs.getRef(modOps["subi0"]), "1.1");
+  EXPECT_NE(getChannelRef(ops["addi0"]->getResult(0), refs),
+            getChannelRef(modOps["addi0"]->getResult(0), modRefs));
+
+  // So does the fingerprint of the modified block, and only this one
+  FuncFingerprint fingerprint = FuncFingerprint::get(funcOp, refs);
+  FuncFingerprint modFingerprint = FuncFingerprint::get(modFuncOp, modRefs);
+  EXPECT_EQ(fingerprint.blocks[0], modFingerprint.blocks[0]);
+  EXPECT_NE(fingerprint.blocks[1], modFingerprint.blocks[1]);
+}
+
+TEST(PlacementCacheTest, roundTrip) {
+  PlacementCache cache = getCache();
+  std::string path = getTemporaryPath();
+  ASSERT_TRUE(succeeded(cache.write(path)));
+
+  PlacementCache readCache;
+  ASSERT_TRUE(succeeded(PlacementCache::read(path, readCache)));
+  ASSERT_EQ(readCache.functions.size(), 1u);
+  ASSERT_EQ(readCache.functions.count("kernel"), 1u);
+  const CachedFuncPlacement &expected = cache.functions["kernel"];
+  const CachedFuncPlacement &placement = readCache.functions["kernel"];
+
+  EXPECT_EQ(placement.config, expected.config);
+  EXPECT_EQ(placement.fingerprint.func, expected.fingerprint.func);
+  EXPECT_EQ(placement.fingerprint.blocks, expected.fingerprint.blocks);
+
+  ASSERT_EQ(placement.archs.size(), 2u);
+  EXPECT_EQ(placement.archs[1].srcBB, 1u);
+  EXPECT_EQ(placement.archs[1].dstBB, 1u);
+  EXPECT_EQ(placement.archs[1].numTrans, 99u);
+  EXPECT_TRUE(placement.hasSameArchs(
+      {ArchBB(0, 1, 1, false), ArchBB(1, 1, 99, true)}));
+  EXPECT_FALSE(placement.hasSameArchs(
+      {ArchBB(0, 1, 1, false), ArchBB(1, 1, 98, true)}));
+  EXPECT_FALSE(placement.hasSameArchs({ArchBB(0, 1, 1, false)}));
+
+  ASSERT_EQ(placement.cfdfcs.size(), 1u);
+  EXPECT_EQ(placement.cfdfcs[0].cycle, std::vector<unsigned>{1});
+  EXPECT_EQ(placement.cfdfcs[0].numExecs, 99u);
+  EXPECT_EQ(placement.cfdfcs[0].throughput, 0.5);
+  EXPECT_EQ(placement.cfdfcs[0].occupancy, expected.cfdfcs[0].occupancy);
+
+  ASSERT_EQ(placement.placement.size(), 2u);
+  const PlacementResult &transparent = placement.placement.at("0.0#0->1.0@0");
+  EXPECT_EQ(transparent.numOneSlotR, 1u);
+  EXPECT_EQ(transparent.numFifoNone, 3u);
+  EXPECT_EQ(transparent.numOneSlotDV, 0u);
+  EXPECT_TRUE(transparent.counterBufferLatencies.empty());
+  const PlacementResult &opaque = placement.placement.at("arg0.2->1.0@1");
+  EXPECT_EQ(opaque.numOneSlotDV, 1u);
+  EXPECT_EQ(opaque.numShiftRegDV, 2u);
+  EXPECT_EQ(opaque.numOneSlotR, 0u);
+  EXPECT_EQ(opaque.counterBufferLatencies,
+            (SmallVector<unsigned, 2>{4, 7}));
+}
+
+TEST(PlacementCacheTest, missingAndIncompatibleFiles) {
+  auto read = [](StringRef content, PlacementCache &cache) {
+    std::string path = getTemporaryPath();
+    std::error_code ec;
+    llvm::raw_fd_ostream(path, ec) << content;
+    EXPECT_FALSE(ec);
+    return PlacementCache::read(path, cache);
+  };
+
+  // A missing cache is an empty one, so that the first compilation succeeds
+  PlacementCache cache;
+  EXPECT_TRUE(succeeded(
+      PlacementCache::read("/nonexistent/placement-cache.json", cache)));
+  EXPECT_TRUE(cache.functions.empty());
+
+  // Caches from other versions of the format are discarded
+  EXPECT_TRUE(succeeded(
+      read(R"({"format_version": 2, "functions": {"kernel": {}}})", cache)));
+  EXPECT_TRUE(cache.functions.empty());
+  EXPECT_TRUE(succeeded(read(R"({"functions": {}})", cache)));
+  EXPECT_TRUE(cache.functions.empty());
+
+  // Caches in the current format must be well-formed
+  EXPECT_TRUE(failed(read(R"({"format_version": 1, "functions": )", cache)));
+  EXPECT_TRUE(failed(read(
+      R"({"format_version": 1, "functions": {"kernel": {"config": 1}}})",
+      cache)));
+}
@@ -0,0 +1,125 @@
+//===- ElasticMiterTest.cpp - Tests for elastic-miter -----------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Unit tests for the extraction of input sequences from counterexamples, their
+// (de)serialization, and the constraints replaying them.
+//
+//===----------------------------------------------------------------------===//
+
+#include "elastic-miter/Constraints.h"
+#include "elastic-miter/Counterexample.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::experimental;
+
+namespace {
+
+/// Input A generates three tokens. The first two are consumed at steps 0 and
+/// 2, and the last one is still pending at the end of the trace. Input B
+/// generates one token that is never consumed.
+constexpr llvm::StringLiteral TRACE = R"(
+Trace Description: LTL Counterexample
+Trace Type: Counterexample
+  -> State: 1.1 <-
+    seq_generator_A.exact_tokens = 3
+    seq_generator_A.counter = 0
+    seq_generator_A.outs = TRUE
+    seq_generator_B.exact_tokens = 1
+    seq_generator_B.counter = 0
+    seq_generator_B.outs = FALSE
+  -> State: 1.2 <-
+    seq_generator_A.counter = 1
+    seq_generator_A.outs = FALSE
+  -> State: 1.3 <-
+    seq_generator_A.outs = TRUE
+  -> State: 1.4 <-
+    seq_generator_A.counter = 2
+    seq_generator_A.outs = FALSE
+    seq_generator_B.outs = TRUE
+)";
+
+/// Returns the path of a new temporary JSON file.
+std::string getTemporaryPath() {
+  llvm::SmallString<128> path;
+  EXPECT_FALSE(
+      llvm::sys::fs::createTemporaryFile("input-sequences", "json", path));
+  return path.str().str();
+}
+
+/// Returns a miter configuration whose inputs have the given names.
+ElasticMiterConfig getConfig(ArrayRef<std::string> argumentNames) {
+  ElasticMiterConfig config;
+  for (const std::string &argumentName : argumentNames)
+    config.arguments.emplace_back(argumentName, Type());
+  return config;
+}
+
+} // namespace
+
+TEST(CounterexampleTest, extractInputSequences) {
+  FailureOr<SmvTrace> trace = SmvTrace::parse(TRACE);
+  ASSERT_TRUE(succeeded(trace));
+
+  FailureOr<InputSequences> sequences =
+      extractInputSequences(*trace, getConfig({"A", "B"}));
+  ASSERT_TRUE(succeeded(sequences));
+  // Consumed tokens take the generator's output before the counter increases,
+  // the pending token takes its last value
+  EXPECT_EQ(sequences->at("A"), (std::vector<bool>{true, true, false}));
+  EXPECT_EQ(sequences->at("B"), (std::vector<bool>{true}));
+
+  // The number of tokens of every input must be part of the trace
+  EXPECT_TRUE(failed(extractInputSequences(*trace, getConfig({"A", "C"}))));
+}
+
+TEST(CounterexampleTest, roundTrip) {
+  InputSequences sequences;
+  sequences["A"] = {true, false, true};
+  sequences["B"] = {};
+  std::string path = getTemporaryPath();
+  ASSERT_TRUE(succeeded(writeInputSequences(sequences, path)));
+
+  FailureOr<InputSequences> readSequences = readInputSequences(path);
+  ASSERT_TRUE(succeeded(readSequences));
+  EXPECT_EQ(*readSequences, sequences);
+}
+
+TEST(CounterexampleTest, malformedFiles) {
+  auto read = [](StringRef content) {
+    std::string path = getTemporaryPath();
+    std::error_code ec;
+    llvm::raw_fd_ostream(path, ec) << content;
+    EXPECT_FALSE(ec);
+    return readInputSequences(path);
+  };
+  EXPECT_TRUE(succeeded(read(R"({"A": [true]})")));
+  EXPECT_TRUE(failed(read(R"({"A": [true)")));
+  EXPECT_TRUE(failed(read(R"({"A": [1, 0]})")));
+  EXPECT_TRUE(failed(read(R"(["A"])")));
+  EXPECT_TRUE(failed(readInputSequences("/nonexistent/sequences.json")));
+}
+
+TEST(ConstraintsTest, inputSequenceConstraint) {
+  InputSequenceConstraint constraint("D", {true, false});
+  EXPECT_EQ(constraint.createSmvConstraint("model", getConfig({"D"})),
+            "INVAR seq_generator_D.exact_tokens = 2;\n"
+            "INVAR seq_generator_D.counter = 0 -> seq_generator_D.outs = "
+            "TRUE;\n"
+            "INVAR seq_generator_D.counter = 1 -> seq_generator_D.outs = "
+            "FALSE;\n"
+            "\n");
+
+  // An empty sequence only fixes the number of tokens
+  InputSequenceConstraint empty("D", {});
+  EXPECT_EQ(empty.createSmvConstraint("model", getConfig({"D"})),
+            "INVAR seq_generator_D.exact_tokens = 0;\n\n");
+}
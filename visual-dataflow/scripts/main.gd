@@ -17,6 +17,12 @@ var time_interval = 1.0;
 
 var dotFile = ""
 var csvFile = ""
+# Second trace to compare against, if any
+var otherDotFile = ""
+var otherCsvFile = ""
+
+var started = false
+var viewRect = Rect2()
 
 func _ready():
 	legend.hide()
@@ -31,15 +37,33 @@ func _ready():
 				dotFile = value
 			elif (key == "csv"):
 				csvFile = value
+			elif (key == "diff-dot"):
+				otherDotFile = value
+			elif (key == "diff-csv"):
+				otherCsvFile = value
 			else:
 				print("Unknown argument " + key)
 	if (!dotFile.is_empty() && !csvFile.is_empty()):
 		menu.hide()
 		legend.show()
 		timeline.show()
-		start(dotFile, csvFile)
+		if (!otherCsvFile.is_empty()):
+			# The second circuit has the same structure unless stated otherwise
+			if (otherDotFile.is_empty()):
+				otherDotFile = dotFile
+			startDiff(dotFile, csvFile, otherDotFile, otherCsvFile)
+		else:
+			start(dotFile, csvFile)
+		started = true
 
 func _process(delta):
+	if started:
+		# Only graph elements within the camera's view are drawn
+		var size = get_viewport_rect().size / camera.zoom
+		var rect = Rect2(camera.get_screen_center_position() - size / 2, size)
+		if rect != viewRect:
+			viewRect = rect
+			updateViewport(rect)
 	if is_playing:
 		elapsed_time += delta
 		if elapsed_time >= time_interval:
@@ -48,8 +72,15 @@ func _process(delta):
 
 func _input(event: InputEvent):
 	if event is InputEventMouseButton:
-		if event.is_action_pressed("left_click"):
+		if event.double_click and event.button_index == MOUSE_BUTTON_LEFT:
+			toggleRegion(camera.get_global_mouse_position())
+		elif event.is_action_pressed("left_click"):
 			onClick(camera.get_global_mouse_position())
+	elif event is InputEventKey and event.pressed and !event.echo:
+		if event.keycode == KEY_C:
+			collapseAll()
+		elif event.keycode == KEY_E:
+			expandAll()
 
 func _on_next_pressed():
 	nextCycle()
@@ -84,6 +115,7 @@ func _on_draw_graph_pressed():
 		legend.show()
 		timeline.show()
 		start(dotFile, csvFile)
+		started = true
 
 func _on_file_dialog_dot_file_selected(path):
 	dotFile = path
@@ -13,12 +13,18 @@
 #include "Graph.h"
 #include "dynamatic/Support/DOT.h"
 #include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <map>
 #include <set>
 #include <sstream>
+#include <tuple>
 #include <utility>
 
 using namespace mlir;
@@ -160,7 +166,213 @@ LogicalResult GodotGraph::parseDOT(StringRef filepath) {
     return success();
   };
 
-  return handleSubgraph(graph.getRoot(), true);
+  if (failed(handleSubgraph(graph.getRoot(), true)))
+    return failure();
+  buildRegions();
+  return success();
+}
+
+/// Returns the basic block number encoded in the identifier of subgraphs
+/// produced by export-dot ("cluster<N>"), if any.
+static std::optional<unsigned> getBBNumber(const DOTGraph::Subgraph &sub) {
+  StringRef id = sub.id;
+  unsigned bb;
+  if (!id.consume_front("cluster") || id.getAsInteger(10, bb))
+    return std::nullopt;
+  return bb;
+}
+
+void GodotGraph::buildRegions() {
+  // Create one basic block region per non-root subgraph, nested like the
+  // subgraphs themselves
+  std::vector<std::unique_ptr<Region>> bbRegions;
+  std::map<unsigned, Region *> regionsByBB;
+  std::function<void(const DOTGraph::Subgraph &, Region *)> addSubgraph =
+      [&](const DOTGraph::Subgraph &sub, Region *parent) {
+        const SubgraphProps &props = subgraphs.at(&sub);
+        auto &region = bbRegions.emplace_back(std::make_unique<Region>());
+        Region *reg = region.get();
+        reg->kind = Region::Kind::BASIC_BLOCK;
+        reg->label = props.label;
+        reg->subgraph = &sub;
+        if (props.boundaries.size() == 4)
+          std::copy_n(props.boundaries.begin(), 4, reg->bounds.begin());
+        reg->parent = parent;
+        if (parent)
+          parent->children.push_back(reg);
+        else if (std::optional<unsigned> bb = getBBNumber(sub))
+          regionsByBB.try_emplace(*bb, reg);
+
+        for (const DOTGraph::Node *node : sub.nodes) {
+          nodeRegions[node] = reg;
+          for (Region *r = reg; r; r = r->parent)
+            r->nodes.push_back(node);
+        }
+        for (const DOTGraph::Subgraph *subsub : sub.subgraphs)
+          addSubgraph(*subsub, reg);
+      };
+  for (const DOTGraph::Subgraph *sub : graph.getRoot().subgraphs)
+    addSubgraph(*sub, nullptr);
+
+  // Backward edges between two basic blocks delimit a loop spanning all basic
+  // blocks in between
+  DenseMap<Region *, unsigned> bbNumbers;
+  for (auto [bb, reg] : regionsByBB)
+    bbNumbers[reg] = bb;
+  auto getTopLevelBB =
+      [&](const DOTGraph::Node *node) -> std::optional<unsigned> {
+    Region *reg = nodeRegions.lookup(node);
+    if (!reg)
+      return std::nullopt;
+    while (reg->parent)
+      reg = reg->parent;
+    if (auto it = bbNumbers.find(reg); it != bbNumbers.end())
+      return it->second;
+    return std::nullopt;
+  };
+  std::map<std::pair<unsigned, unsigned>, std::vector<const DOTGraph::Edge *>>
+      backEdges;
+  for (const auto &[edge, _] : edges) {
+    std::optional<unsigned> srcBB = getTopLevelBB(edge->srcNode);
+    std::optional<unsigned> dstBB = getTopLevelBB(edge->dstNode);
+    if (srcBB && dstBB && *dstBB < *srcBB)
+      backEdges[{*dstBB, *srcBB}].push_back(edge);
+  }
+  // Sort ranges so that enclosing loops come before the loops they contain
+  std::vector<std::pair<unsigned, unsigned>> ranges;
+  for (const auto &[range, _] : backEdges)
+    ranges.push_back(range);
+  llvm::sort(ranges, [](auto lhs, auto rhs) {
+    return lhs.first < rhs.first ||
+           (lhs.first == rhs.first && lhs.second > rhs.second);
+  });
+
+  std::vector<std::unique_ptr<Region>> loopRegions;
+  std::vector<std::pair<unsigned, unsigned>> loopRanges;
+  for (auto [first, last] : ranges) {
+    // Loops are expected to be properly nested; ignore those that are not
+    Region *parent = nullptr;
+    unsigned parentSpan = 0;
+    bool overlaps = false;
+    for (auto [idx, range] : llvm::enumerate(loopRanges)) {
+      bool containsFirst = range.first <= first && first <= range.second;
+      bool containsLast = range.first <= last && last <= range.second;
+      if (containsFirst && containsLast) {
+        unsigned span = range.second - range.first;
+        if (!parent || span < parentSpan) {
+          parent = loopRegions[idx].get();
+          parentSpan = span;
+        }
+      } else if (containsFirst || containsLast) {
+        overlaps = true;
+        break;
+      }
+    }
+    if (overlaps)
+      continue;
+
+    auto region = std::make_unique<Region>();
+    region->kind = Region::Kind::LOOP;
+    region->label = "Loop (BB " + std::to_string(first) + " to BB " +
+                    std::to_string(last) + ")";
+    region->parent = parent;
+    region->backEdges = backEdges[{first, last}];
+    // Edges are not iterated over in a deterministic order
+    llvm::sort(region->backEdges, [](auto *lhs, auto *rhs) {
+      return std::make_tuple(lhs->srcNode->id, lhs->dstNode->id) <
+             std::make_tuple(rhs->srcNode->id, rhs->dstNode->id);
+    });
+    bool firstBB = true;
+    for (auto it = regionsByBB.lower_bound(first),
+              end = regionsByBB.upper_bound(last);
+         it != end; ++it) {
+      const Region &bbReg = *it->second;
+      region->nodes.insert(region->nodes.end(), bbReg.nodes.begin(),
+                           bbReg.nodes.end());
+      if (firstBB) {
+        region->bounds = bbReg.bounds;
+        firstBB = false;
+        continue;
+      }
+      region->bounds[0] = std::min(region->bounds[0], bbReg.bounds[0]);
+      region->bounds[1] = std::min(region->bounds[1], bbReg.bounds[1]);
+      region->bounds[2] = std::max(region->bounds[2], bbReg.bounds[2]);
+      region->bounds[3] = std::max(region->bounds[3], bbReg.bounds[3]);
+    }
+    if (firstBB)
+      continue;
+    if (parent)
+      parent->children.push_back(region.get());
+    loopRanges.emplace_back(first, last);
+    loopRegions.push_back(std::move(region));
+  }
+
+  // Top-level basic block regions are nested in the innermost loop containing
+  // them
+  for (auto [bb, reg] : regionsByBB) {
+    Region *loop = nullptr;
+    unsigned loopSpan = 0;
+    for (auto [idx, range] : llvm::enumerate(loopRanges)) {
+      unsigned span = range.second - range.first;
+      if (range.first <= bb && bb <= range.second &&
+          (!loop || span < loopSpan)) {
+        loop = loopRegions[idx].get();
+        loopSpan = span;
+      }
+    }
+    if (loop) {
+      reg->parent = loop;
+      loop->children.push_back(reg);
+    }
+  }
+
+  // Each edge is inside the smallest region containing both of its endpoints
+  // and all regions enclosing it
+  for (const auto &[edge, _] : edges) {
+    SmallPtrSet<Region *, 4> srcRegions;
+    for (Region *r = nodeRegions.lookup(edge->srcNode); r; r = r->parent)
+      srcRegions.insert(r);
+    Region *common = nodeRegions.lookup(edge->dstNode);
+    while (common && !srcRegions.contains(common))
+      common = common->parent;
+    for (; common; common = common->parent)
+      common->innerEdges.push_back(edge);
+  }
+
+  for (std::unique_ptr<Region> &region : loopRegions)
+    regions.push_back(std::move(region));
+  for (std::unique_ptr<Region> &region : bbRegions)
+    regions.push_back(std::move(region));
+}
+
+DenseMap<const DOTGraph::Edge *, std::vector<unsigned>>
+GodotGraph::getTransferCycles() const {
+  DenseMap<const DOTGraph::Edge *, std::vector<unsigned>> transfers;
+  for (auto [cycle, states] : llvm::enumerate(transitions)) {
+    for (const auto &[edge, state] : states) {
+      if (state.state == DataflowState::TRANSFER)
+        transfers[edge].push_back(cycle);
+    }
+  }
+  return transfers;
+}
+
+GodotGraph::RegionActivity GodotGraph::getActivity(const Region &region,
+                                                   unsigned cycle) const {
+  RegionActivity activity;
+  if (cycle >= transitions.size())
+    return activity;
+  const Transitions &states = transitions[cycle];
+  for (const DOTGraph::Edge *edge : region.innerEdges) {
+    auto it = states.find(edge);
+    if (it == states.end())
+      continue;
+    if (it->second.state == DataflowState::TRANSFER)
+      ++activity.numTransfers;
+    else if (it->second.state == DataflowState::STALL)
+      ++activity.numStalls;
+  }
+  return activity;
 }
 
 static const DenseMap<StringRef, DataflowState> STATE_DECODER = {
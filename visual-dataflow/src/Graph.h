@@ -16,6 +16,8 @@
 
 #include "dynamatic/Support/DOT.h"
 #include "dynamatic/Support/LLVM.h"
+#include <array>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -69,6 +71,42 @@ public:
     std::pair<float, float> labelSize;
   };
 
+  /// A collapsible region of the graph. Basic block regions correspond to
+  /// (non-root) DOT subgraphs. Loop regions group the contiguous range of
+  /// basic blocks between the source and destination of a backward edge
+  /// between two basic blocks.
+  struct Region {
+    enum class Kind { BASIC_BLOCK, LOOP };
+
+    /// The region's kind.
+    Kind kind;
+    /// Name of the region to display.
+    std::string label;
+    /// Bounding box of the region, as (xmin, ymin, xmax, ymax) in DOT
+    /// coordinates.
+    std::array<float, 4> bounds{};
+    /// All nodes inside the region, including those of nested regions.
+    std::vector<const DOTGraph::Node *> nodes;
+    /// All edges whose two endpoints are inside the region.
+    std::vector<const DOTGraph::Edge *> innerEdges;
+    /// Smallest region strictly containing this one, if any.
+    Region *parent = nullptr;
+    /// Regions immediately nested within this one.
+    std::vector<Region *> children;
+    /// For basic block regions, the subgraph the region was created from.
+    const DOTGraph::Subgraph *subgraph = nullptr;
+    /// For loop regions, the backward edges delimiting the loop.
+    std::vector<const DOTGraph::Edge *> backEdges;
+  };
+
+  /// Activity of the channels inside a region during a specific cycle.
+  struct RegionActivity {
+    /// Number of channels transferring a token.
+    unsigned numTransfers = 0;
+    /// Number of channels holding a valid token that is not accepted.
+    unsigned numStalls = 0;
+  };
+
   LogicalResult fromDOTAndCSV(StringRef dotFilePath, StringRef csvFilePath);
 
   void addEdgeState(unsigned cycle, const DOTGraph::Edge *edge,
@@ -86,6 +124,14 @@ public:
 
   const DOTGraph &getGraph() const { return graph; }
 
+  const DenseMap<const DOTGraph::Node *, NodeProps> &getNodes() const {
+    return nodes;
+  }
+
+  const DenseMap<const DOTGraph::Edge *, EdgeProps> &getEdges() const {
+    return edges;
+  }
+
   const NodeProps &getNodeProperties(const DOTGraph::Node *node) const {
     return nodes.at(node);
   }
@@ -99,6 +145,27 @@ public:
     return subgraphs.at(subgraph);
   }
 
+  /// Returns all regions of the graph, outer regions before nested ones.
+  const std::vector<std::unique_ptr<Region>> &getRegions() const {
+    return regions;
+  }
+
+  /// Returns the most nested region containing the node, or `nullptr` if the
+  /// node does not belong to any region.
+  Region *getRegion(const DOTGraph::Node *node) const {
+    return nodeRegions.lookup(node);
+  }
+
+  /// Aggregates the states of all channels inside the region at the given
+  /// cycle. The cost is proportional to the number of channels in the region.
+  RegionActivity getActivity(const Region &region, unsigned cycle) const;
+
+  /// Returns, for each edge, the cycles during which the edge transfers a
+  /// token, in increasing order. The i-th cycle corresponds to the transfer of
+  /// the i-th token on the edge.
+  DenseMap<const DOTGraph::Edge *, std::vector<unsigned>>
+  getTransferCycles() const;
+
 private:
   DOTGraph graph;
   std::vector<Transitions> transitions;
@@ -107,8 +174,16 @@ private:
   DenseMap<const DOTGraph::Edge *, GodotGraph::EdgeProps> edges;
   DenseMap<const DOTGraph::Subgraph *, GodotGraph::SubgraphProps> subgraphs;
 
+  /// Collapsible regions of the graph, outer regions before nested ones.
+  std::vector<std::unique_ptr<Region>> regions;
+  /// Maps nodes to the most nested region they belong to.
+  DenseMap<const DOTGraph::Node *, Region *> nodeRegions;
+
   LogicalResult parseDOT(StringRef filepath);
 
+  /// Identifies basic block and loop regions from the parsed DOT graph.
+  void buildRegions();
+
   LogicalResult parseCSV(StringRef filepath);
 };
 
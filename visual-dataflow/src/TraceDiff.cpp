@@ -0,0 +1,268 @@
+//===- TraceDiff.cpp - Compares two execution traces ------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements the comparison of two execution traces.
+//
+//===----------------------------------------------------------------------===//
+
+#include "TraceDiff.h"
+#include "Graph.h"
+#include "dynamatic/Support/DOT.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace mlir;
+using namespace dynamatic;
+using namespace dynamatic::visual;
+
+/// Determines whether the node represents a buffer.
+static bool isBuffer(const DOTGraph::Node *node) {
+  auto it = node->attrs.find("mlir_op");
+  return it != node->attrs.end() &&
+         StringRef(it->second).starts_with("handshake.buffer");
+}
+
+/// Returns a name identifying the channel independently of the buffers placed
+/// on it. Channels going into a buffer have no name; they are represented by
+/// the channel going out of the chain of buffers they belong to.
+static std::optional<std::string> getChannelName(const GodotGraph &graph,
+                                                 const DOTGraph::Edge *edge) {
+  if (isBuffer(edge->dstNode))
+    return std::nullopt;
+
+  // Walk back through chains of buffers, which have a single input
+  const DOTGraph::Edge *srcEdge = edge;
+  SmallPtrSet<const DOTGraph::Node *, 4> visited;
+  while (isBuffer(srcEdge->srcNode) &&
+         visited.insert(srcEdge->srcNode).second) {
+    ArrayRef<const DOTGraph::Edge *> preds =
+        graph.getGraph().getPredecessors(*srcEdge->srcNode);
+    if (preds.size() != 1)
+      break;
+    srcEdge = preds.front();
+  }
+
+  return srcEdge->srcNode->id + ":" +
+         std::to_string(graph.getEdgeProperties(srcEdge).fromIdx) + " -> " +
+         edge->dstNode->id + ":" +
+         std::to_string(graph.getEdgeProperties(edge).toIdx);
+}
+
+/// Returns the index of the first token whose distance to the previous token
+/// differs between the two sequences, or the length of the shortest sequence
+/// if one has more tokens than the other.
+static std::optional<unsigned> findRateDivergence(ArrayRef<unsigned> cycles,
+                                                  ArrayRef<unsigned> other) {
+  size_t numCommon = std::min(cycles.size(), other.size());
+  for (size_t i = 1; i < numCommon; ++i) {
+    if (cycles[i] - cycles[i - 1] != other[i] - other[i - 1])
+      return i;
+  }
+  if (cycles.size() != other.size())
+    return numCommon;
+  return std::nullopt;
+}
+
+std::optional<int> TraceDiff::ChannelDiff::getOffset(unsigned cycle) const {
+  auto it = llvm::lower_bound(cycles, cycle);
+  if (it == cycles.end() || *it != cycle)
+    return std::nullopt;
+  size_t idx = std::distance(cycles.begin(), it);
+  if (idx >= otherCycles.size())
+    return std::nullopt;
+  return (int)otherCycles[idx] - (int)cycle;
+}
+
+std::pair<double, double> TraceDiff::ChannelDiff::getThroughputs() const {
+  auto getThroughput = [](ArrayRef<unsigned> tokens) -> double {
+    if (tokens.empty())
+      return 0.0;
+    return (double)tokens.size() / (tokens.back() - tokens.front() + 1);
+  };
+  return {getThroughput(cycles), getThroughput(otherCycles)};
+}
+
+TraceDiff::TraceDiff(const GodotGraph &graph, const GodotGraph &otherGraph) {
+  // Distinct channels of the same graph may share a name (e.g., parallel edges
+  // between the same ports). They cannot be aligned reliably, so they are left
+  // out of the comparison and reported instead
+  llvm::StringSet<> ambiguousNames;
+
+  // Name the channels of the second graph
+  llvm::StringMap<const DOTGraph::Edge *> otherEdges;
+  for (const auto &edgeAndProps : otherGraph.getEdges()) {
+    if (std::optional<std::string> name =
+            getChannelName(otherGraph, edgeAndProps.first)) {
+      if (!otherEdges.try_emplace(*name, edgeAndProps.first).second)
+        ambiguousNames.insert(*name);
+    }
+  }
+
+  // Align the channels of both graphs, in a deterministic order
+  std::vector<std::pair<std::string, const DOTGraph::Edge *>> named;
+  llvm::StringSet<> names;
+  for (const auto &edgeAndProps : graph.getEdges()) {
+    if (std::optional<std::string> name =
+            getChannelName(graph, edgeAndProps.first)) {
+      if (!names.insert(*name).second)
+        ambiguousNames.insert(*name);
+      named.emplace_back(*name, edgeAndProps.first);
+    }
+  }
+  llvm::sort(named, llvm::less_first());
+
+  DenseMap<const DOTGraph::Edge *, std::vector<unsigned>> transfers =
+      graph.getTransferCycles();
+  DenseMap<const DOTGraph::Edge *, std::vector<unsigned>> otherTransfers =
+      otherGraph.getTransferCycles();
+  llvm::StringSet<> matched;
+  for (auto &[name, edge] : named) {
+    if (ambiguousNames.contains(name))
+      continue;
+    const DOTGraph::Edge *otherEdge = otherEdges.lookup(name);
+    if (!otherEdge) {
+      unmatched.push_back(name);
+      continue;
+    }
+    matched.insert(name);
+
+    ChannelDiff &diff = channels.emplace_back();
+    diff.name = name;
+    diff.edge = edge;
+    diff.otherEdge = otherEdge;
+    diff.cycles = transfers.lookup(edge);
+    diff.otherCycles = otherTransfers.lookup(otherEdge);
+    size_t numCommon = std::min(diff.cycles.size(), diff.otherCycles.size());
+    for (size_t i = 0; i < numCommon; ++i) {
+      if (diff.cycles[i] != diff.otherCycles[i]) {
+        diff.firstLatencyDivergence = i;
+        break;
+      }
+    }
+    diff.firstRateDivergence =
+        findRateDivergence(diff.cycles, diff.otherCycles);
+    channelIndices[edge] = channels.size() - 1;
+  }
+  for (const auto &otherEdge : otherEdges) {
+    if (!matched.count(otherEdge.getKey()) &&
+        !ambiguousNames.contains(otherEdge.getKey()))
+      otherUnmatched.push_back(otherEdge.getKey().str());
+  }
+  llvm::sort(otherUnmatched);
+  for (const auto &name : ambiguousNames)
+    ambiguous.push_back(name.getKey().str());
+  llvm::sort(ambiguous);
+
+  // A loop iterates every time a token goes through one of its backward
+  // edges. Use the busiest backward edge present in both graphs to count them
+  for (const std::unique_ptr<GodotGraph::Region> &region :
+       graph.getRegions()) {
+    if (region->kind != GodotGraph::Region::Kind::LOOP)
+      continue;
+    const ChannelDiff *busiest = nullptr;
+    for (const DOTGraph::Edge *backEdge : region->backEdges) {
+      const ChannelDiff *diff = getChannelDiff(backEdge);
+      if (diff && (!busiest || diff->cycles.size() > busiest->cycles.size()))
+        busiest = diff;
+    }
+    if (!busiest)
+      continue;
+
+    LoopDiff &loop = loops.emplace_back();
+    loop.name = region->label;
+    loop.iterations = busiest->cycles;
+    loop.otherIterations = busiest->otherCycles;
+    loop.firstDivergence =
+        findRateDivergence(loop.iterations, loop.otherIterations);
+  }
+}
+
+const TraceDiff::ChannelDiff *
+TraceDiff::getChannelDiff(const DOTGraph::Edge *edge) const {
+  if (auto it = channelIndices.find(edge); it != channelIndices.end())
+    return &channels[it->second];
+  return nullptr;
+}
+
+/// Prints the cycle at which the token is transferred in the sequence, or a
+/// dash if the sequence does not have that many tokens.
+static void printCycle(llvm::raw_ostream &os, ArrayRef<unsigned> cycles,
+                       unsigned idx) {
+  if (idx < cycles.size())
+    os << cycles[idx];
+  else
+    os << "-";
+}
+
+void TraceDiff::print(llvm::raw_ostream &os) const {
+  unsigned numDivergent = llvm::count_if(
+      channels, [](const ChannelDiff &diff) { return diff.diverges(); });
+  os << "Diverging channels: " << numDivergent << " out of " << channels.size()
+     << " aligned channels\n";
+  for (const ChannelDiff &diff : channels) {
+    if (!diff.diverges())
+      continue;
+    auto [throughput, otherThroughput] = diff.getThroughputs();
+    os << "  " << diff.name << "\n    tokens: " << diff.cycles.size() << " vs "
+       << diff.otherCycles.size() << ", throughput: ";
+    os << llvm::format("%.3f vs %.3f", throughput, otherThroughput) << "\n";
+    if (std::optional<unsigned> idx = diff.firstLatencyDivergence) {
+      os << "    first latency divergence at token " << *idx << " (cycle ";
+      printCycle(os, diff.cycles, *idx);
+      os << " vs ";
+      printCycle(os, diff.otherCycles, *idx);
+      os << ")\n";
+    }
+    if (std::optional<unsigned> idx = diff.firstRateDivergence) {
+      os << "    first throughput divergence at token " << *idx << " (cycle ";
+      printCycle(os, diff.cycles, *idx);
+      os << " vs ";
+      printCycle(os, diff.otherCycles, *idx);
+      os << ")\n";
+    }
+  }
+
+  os << "Loops: " << loops.size() << "\n";
+  for (const LoopDiff &loop : loops) {
+    os << "  " << loop.name << ": " << loop.iterations.size() << " vs "
+       << loop.otherIterations.size() << " iterations";
+    if (std::optional<unsigned> idx = loop.firstDivergence) {
+      os << ", iteration rate first differs at iteration " << *idx
+         << " (cycle ";
+      printCycle(os, loop.iterations, *idx);
+      os << " vs ";
+      printCycle(os, loop.otherIterations, *idx);
+      os << ")\n";
+    } else {
+      os << ", identical iteration rate\n";
+    }
+  }
+
+  auto printUnmatched = [&](ArrayRef<std::string> names, StringRef trace) {
+    if (names.empty())
+      return;
+    os << "Channels only in the " << trace << " trace: " << names.size()
+       << "\n";
+    for (const std::string &name : names)
+      os << "  " << name << "\n";
+  };
+  printUnmatched(unmatched, "first");
+  printUnmatched(otherUnmatched, "second");
+
+  if (!ambiguous.empty()) {
+    os << "Channels sharing their name with another channel, not compared: "
+       << ambiguous.size() << "\n";
+    for (const std::string &name : ambiguous)
+      os << "  " << name << "\n";
+  }
+}
@@ -0,0 +1,108 @@
+//===- TraceDiff.h - Compares two execution traces --------------*- C++ -*-===//
+//
+// Dynamatic is under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Compares two execution traces of the same kernel, for example obtained with
+// two different buffer placements or before and after an optimization.
+// Channels of the two graphs are aligned by their endpoints, looking through
+// buffers so that channels split by buffer placement still match, and tokens
+// on each channel are aligned by their sequence number.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef DYNAMATIC_VISUAL_DATAFLOW_TRACE_DIFF_H
+#define DYNAMATIC_VISUAL_DATAFLOW_TRACE_DIFF_H
+
+#include "Graph.h"
+#include "dynamatic/Support/DOT.h"
+#include "dynamatic/Support/LLVM.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dynamatic {
+namespace visual {
+
+class TraceDiff {
+public:
+  /// Comparison of the tokens transferred on a channel in both traces.
+  struct ChannelDiff {
+    /// Name of the channel, made up of its (non-buffer) endpoints.
+    std::string name;
+    /// The channel's edge in each graph.
+    const DOTGraph::Edge *edge, *otherEdge;
+    /// Cycles at which each token is transferred in each trace.
+    std::vector<unsigned> cycles, otherCycles;
+    /// Index of the first token that is not transferred in the same cycle in
+    /// both traces, if any.
+    std::optional<unsigned> firstLatencyDivergence;
+    /// Index of the first token whose distance to the previous token differs
+    /// between the two traces, if any.
+    std::optional<unsigned> firstRateDivergence;
+
+    /// Returns whether the channel behaves differently in the two traces.
+    bool diverges() const {
+      return firstLatencyDivergence || firstRateDivergence ||
+             cycles.size() != otherCycles.size();
+    }
+
+    /// If a token is transferred at the cycle in the first trace, returns by
+    /// how many cycles the same token is delayed in the second trace (negative
+    /// if it is transferred earlier).
+    std::optional<int> getOffset(unsigned cycle) const;
+
+    /// Returns the number of tokens transferred per cycle in each trace, over
+    /// the span of cycles during which the channel is active.
+    std::pair<double, double> getThroughputs() const;
+  };
+
+  /// Comparison of the iterations of a loop in both traces.
+  struct LoopDiff {
+    /// Name of the loop.
+    std::string name;
+    /// Cycles at which each iteration ends in each trace.
+    std::vector<unsigned> iterations, otherIterations;
+    /// Index of the first iteration whose duration differs between the two
+    /// traces (or which only exists in one trace), if any.
+    std::optional<unsigned> firstDivergence;
+  };
+
+  /// Compares the two traces, each stored in a graph.
+  TraceDiff(const GodotGraph &graph, const GodotGraph &otherGraph);
+
+  /// Returns the comparison for the channel of the first graph, or `nullptr`
+  /// if the channel has no counterpart in the second graph.
+  const ChannelDiff *getChannelDiff(const DOTGraph::Edge *edge) const;
+
+  /// Returns the comparison of all channels present in both graphs.
+  ArrayRef<ChannelDiff> getChannels() const { return channels; }
+
+  /// Returns the comparison of all loops of the first graph.
+  ArrayRef<LoopDiff> getLoops() const { return loops; }
+
+  /// Prints a human-readable report of the differences between the two
+  /// traces.
+  void print(llvm::raw_ostream &os) const;
+
+private:
+  /// Comparison of all channels present in both graphs.
+  std::vector<ChannelDiff> channels;
+  /// Maps edges of the first graph to the index of their comparison.
+  DenseMap<const DOTGraph::Edge *, unsigned> channelIndices;
+  /// Comparison of all loops of the first graph.
+  std::vector<LoopDiff> loops;
+  /// Names of channels which exist in only one of the two graphs.
+  std::vector<std::string> unmatched, otherUnmatched;
+  /// Names shared by multiple channels of one of the graphs. These channels
+  /// cannot be aligned and are left out of the comparison.
+  std::vector<std::string> ambiguous;
+};
+
+} // namespace visual
+} // namespace dynamatic
+
+#endif // DYNAMATIC_VISUAL_DATAFLOW_TRACE_DIFF_H
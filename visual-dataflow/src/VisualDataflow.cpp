@@ -28,11 +28,13 @@
 #include "godot_cpp/variant/color.hpp"
 #include "godot_cpp/variant/packed_vector2_array.hpp"
 #include "godot_cpp/variant/vector2.hpp"
+#include "godot_cpp/variant/vector2i.hpp"
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
@@ -46,10 +48,12 @@ using namespace dynamatic::visual;
 const godot::Color TRANSPARENT_BLACK(0, 0, 0, 0.075);
 const godot::Color OPAQUE_BLACK(0, 0, 0, 1.0);
 const godot::Color OPAQUE_WHITE(1, 1, 1, 1.0);
+const godot::Color COLLAPSED_REGION_COLOR(0.86, 0.86, 0.86, 1.0);
+const godot::Color DIVERGENCE_COLOR(0.78, 0.0, 0.0, 1.0);
 
-static constexpr double LINE_WIDTH = 1.5, NODE_HEIGHT = 35,
-                        NODE_WIDTH_SCALING_COEFFICIENT = 70, DASH_LENGTH = 3,
-                        DASH_SPACE_LENGTH = DASH_LENGTH * 2;
+static constexpr double LINE_WIDTH = 1.5, DIVERGENT_LINE_WIDTH = 4,
+                        NODE_HEIGHT = 35, NODE_WIDTH_SCALING_COEFFICIENT = 70,
+                        DASH_LENGTH = 3, DASH_SPACE_LENGTH = DASH_LENGTH * 2;
 static constexpr unsigned NUM_OVAL_POINTS = 50;
 
 static constexpr double SELECT_TRANSPARENCY = 1.0, UNSELECT_TRANSPARENCY = 0.3;
@@ -83,6 +87,9 @@ void VisualDataflow::_bind_methods() {
 
   ClassDB::bind_method(D_METHOD("start", "inputDOTFile", "inputCSVFile"),
                        &VisualDataflow::start);
+  ClassDB::bind_method(D_METHOD("startDiff", "inputDOTFile", "inputCSVFile",
+                                "otherDOTFile", "otherCSVFile"),
+                       &VisualDataflow::startDiff);
   ClassDB::bind_method(D_METHOD("nextCycle"), &VisualDataflow::nextCycle);
   ClassDB::bind_method(D_METHOD("previousCycle"),
                        &VisualDataflow::previousCycle);
@@ -94,6 +101,12 @@ void VisualDataflow::_bind_methods() {
                        &VisualDataflow::onClick);
   ClassDB::bind_method(D_METHOD("resetSelection"),
                        &VisualDataflow::resetSelection);
+  ClassDB::bind_method(D_METHOD("updateViewport", "area"),
+                       &VisualDataflow::updateViewport);
+  ClassDB::bind_method(D_METHOD("toggleRegion", "position"),
+                       &VisualDataflow::toggleRegion);
+  ClassDB::bind_method(D_METHOD("collapseAll"), &VisualDataflow::collapseAll);
+  ClassDB::bind_method(D_METHOD("expandAll"), &VisualDataflow::expandAll);
 }
 
 void VisualDataflow::start(const godot::String &dotFilepath,
@@ -109,11 +122,29 @@ void VisualDataflow::start(const godot::String &dotFilepath,
     llvm::errs() << "Failed to parse graph data\n";
     return;
   }
+  if (otherGraph) {
+    diff = std::make_unique<TraceDiff>(graph, *otherGraph);
+    diff->print(llvm::outs());
+  }
   maxCycle = graph.getLastCycleIdx();
   cycleSlider->set_max(maxCycle);
   drawGraph();
 }
 
+void VisualDataflow::startDiff(const godot::String &dotFilepath,
+                               const godot::String &csvFilepath,
+                               const godot::String &otherDotFilepath,
+                               const godot::String &otherCSVFilepath) {
+  otherGraph = std::make_unique<GodotGraph>();
+  if (failed(otherGraph->fromDOTAndCSV(otherDotFilepath.utf8().get_data(),
+                                       otherCSVFilepath.utf8().get_data()))) {
+    llvm::errs() << "Failed to parse graph data to compare against\n";
+    otherGraph = nullptr;
+    return;
+  }
+  start(dotFilepath, csvFilepath);
+}
+
 static void setBasicLineProps(Line2D *line) {
   line->set_width(LINE_WIDTH);
   line->set_default_color(OPAQUE_BLACK);
@@ -147,22 +178,23 @@ static void createDashedLine(PackedVector2Array &points,
   }
 }
 
-void VisualDataflow::drawSubgraph(const DOTGraph::Subgraph &sub, bool isRoot) {
-  if (!isRoot) {
-    const GodotGraph::SubgraphProps &props = graph.getSubgraphProperties(&sub);
-
-    std::vector<float> boundaries = props.boundaries;
-    Polygon2D *p = memnew(Polygon2D);
-    PackedVector2Array points;
-    points.push_back(Vector2(boundaries.at(0), -boundaries.at(1)));
-    points.push_back(Vector2(boundaries.at(2), -boundaries.at(1)));
-    points.push_back(Vector2(boundaries.at(2), -boundaries.at(3)));
-    points.push_back(Vector2(boundaries.at(0), -boundaries.at(3)));
+void VisualDataflow::drawRegion(const Region &region) {
+  RegionGeometry &geometry = regionGeometries[&region];
+  auto [xMin, yMin, xMax, yMax] = region.bounds;
+  PackedVector2Array points;
+  points.push_back(Vector2(xMin, -yMin));
+  points.push_back(Vector2(xMax, -yMin));
+  points.push_back(Vector2(xMax, -yMax));
+  points.push_back(Vector2(xMin, -yMax));
 
-    p->set_polygon(points);
-    p->set_color(TRANSPARENT_BLACK);
+  if (region.subgraph) {
+    const GodotGraph::SubgraphProps &props =
+        graph.getSubgraphProperties(region.subgraph);
 
-    add_child(p);
+    geometry.frame = memnew(Polygon2D);
+    geometry.frame->set_polygon(points);
+    geometry.frame->set_color(TRANSPARENT_BLACK);
+    add_child(geometry.frame);
 
     // Create the label and configure it
     RichTextLabel *bbLabel = memnew(RichTextLabel);
@@ -170,8 +202,8 @@ void VisualDataflow::drawSubgraph(const DOTGraph::Subgraph &sub, bool isRoot) {
     bbLabel->set_fit_content(true);
     bbLabel->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
     bbLabel->set_position(
-        Vector2(props.boundaries.at(0) + 5,
-                -props.labelPosition.second - props.labelSize.first * 35));
+        Vector2(xMin + 5, -props.labelPosition.second -
+                              props.labelSize.first * 35));
 
     // Set the label's content
     bbLabel->push_font(get_theme_default_font(), 12);
@@ -179,217 +211,461 @@ void VisualDataflow::drawSubgraph(const DOTGraph::Subgraph &sub, bool isRoot) {
     bbLabel->append_text(props.label.c_str());
     bbLabel->pop();
     bbLabel->pop();
-
+    geometry.frameLabel = bbLabel;
     add_child(bbLabel);
   }
 
-  for (const DOTGraph::Node *node : sub.nodes) {
-    const GodotGraph::NodeProps &props = graph.getNodeProperties(node);
-    NodeGeometry &geometry = nodeGeometries.try_emplace(node).first->second;
-
-    auto [centerX, centerY] = props.position;
-    float width = props.width * NODE_WIDTH_SCALING_COEFFICIENT;
-    Area2D *area2D = memnew(Area2D);
-    Polygon2D *godotNode = memnew(Polygon2D);
-    std::string shape = props.shape;
-
-    double halfWidth = width / 2;
-    double halfHeight = NODE_HEIGHT / 2;
-
-    // Define the shape of the node as a sequence of 2D points
-    PackedVector2Array points;
-    if (shape == "diamond" || shape == "box") {
-
-      if (shape == "box") {
-        // Define points for a box-shaped node
-        points.push_back(Vector2(centerX - halfWidth, -centerY + halfHeight));
-        points.push_back(Vector2(centerX + halfWidth, -centerY + halfHeight));
-        points.push_back(Vector2(centerX + halfWidth, -centerY - halfHeight));
-        points.push_back(Vector2(centerX - halfWidth, -centerY - halfHeight));
+  // The collapsed representation is drawn on top of everything created so far,
+  // hiding the region's boundary
+  geometry.box = memnew(Polygon2D);
+  geometry.box->set_polygon(points);
+  geometry.box->set_color(COLLAPSED_REGION_COLOR);
+  geometry.box->set_visible(false);
+  add_child(geometry.box);
+
+  geometry.summary = memnew(RichTextLabel);
+  geometry.summary->set_use_bbcode(true);
+  geometry.summary->set_fit_content(true);
+  geometry.summary->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
+  CenterContainer *centerContainer = memnew(CenterContainer);
+  centerContainer->set_size(Vector2(xMax - xMin, yMax - yMin));
+  centerContainer->add_child(geometry.summary);
+  geometry.box->add_child(centerContainer);
+  centerContainer->set_position(Vector2(xMin, -yMax));
+}
+
+VisualDataflow::NodeGeometry &
+VisualDataflow::drawNode(const DOTGraph::Node *node) {
+  const GodotGraph::NodeProps &props = graph.getNodeProperties(node);
+  NodeGeometry &geometry = nodeGeometries.try_emplace(node).first->second;
+
+  auto [centerX, centerY] = props.position;
+  float width = props.width * NODE_WIDTH_SCALING_COEFFICIENT;
+  Area2D *area2D = memnew(Area2D);
+  Polygon2D *godotNode = memnew(Polygon2D);
+  std::string shape = props.shape;
+
+  double halfWidth = width / 2;
+  double halfHeight = NODE_HEIGHT / 2;
+
+  // Define the shape of the node as a sequence of 2D points
+  PackedVector2Array points;
+  if (shape == "diamond" || shape == "box") {
+
+    if (shape == "box") {
+      // Define points for a box-shaped node
+      points.push_back(Vector2(centerX - halfWidth, -centerY + halfHeight));
+      points.push_back(Vector2(centerX + halfWidth, -centerY + halfHeight));
+      points.push_back(Vector2(centerX + halfWidth, -centerY - halfHeight));
+      points.push_back(Vector2(centerX - halfWidth, -centerY - halfHeight));
+    } else {
+      // Define points for a diamond-shaped node
+      points.push_back(Vector2(centerX, -centerY + halfHeight));
+      points.push_back(Vector2(centerX + halfWidth, -centerY));
+      points.push_back(Vector2(centerX, -centerY - halfHeight));
+      points.push_back(Vector2(centerX - halfWidth, -centerY));
+    }
+
+    // The collision area is the same as the node itself
+    geometry.collision = points;
+  } else {
+    // Create points to characterize an oval shape
+    double angle = 0;
+    double angleIncrement = 2 * M_PI / NUM_OVAL_POINTS;
+    for (unsigned i = 0; i < NUM_OVAL_POINTS; ++i) {
+      angle += angleIncrement;
+      double x = centerX + width / 2 * cos(angle);
+      double y = -centerY + NODE_HEIGHT / 2 * sin(angle);
+      points.push_back(Vector2(x, y));
+    }
+
+    // The collison area is a rectangle centered within the oval
+    PackedVector2Array rectanglePoints;
+    rectanglePoints.push_back(Vector2(centerX, -centerY + NODE_HEIGHT / 2));
+    rectanglePoints.push_back(Vector2(centerX + width / 2, -centerY));
+    rectanglePoints.push_back(Vector2(centerX, -centerY - NODE_HEIGHT / 2));
+    rectanglePoints.push_back(Vector2(centerX - width / 2, -centerY));
+    geometry.collision = rectanglePoints;
+  }
+
+  // Sets the node's polygon and color
+  godotNode->set_polygon(points);
+  godotNode->set_color(NAMED_COLORS.count(props.color)
+                           ? NAMED_COLORS.at(props.color)
+                           : OPAQUE_WHITE);
+
+  // Create the label and configure it
+  RichTextLabel *nodeName = memnew(RichTextLabel);
+  nodeName->set_use_bbcode(true);
+  nodeName->set_fit_content(true);
+  nodeName->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
+  nodeName->set_position(Vector2(centerX, -centerY));
+
+  // Set the label's content
+  nodeName->push_font(get_theme_default_font(), 11);
+  nodeName->push_color(OPAQUE_BLACK);
+  std::string text = "[center]" + node->id + "[/center]";
+  nodeName->append_text(text.c_str());
+  nodeName->pop();
+  nodeName->pop();
+
+  // Create a container for the label and the node
+  CenterContainer *centerContainer = memnew(CenterContainer);
+  centerContainer->set_size(Vector2(width, NODE_HEIGHT));
+  centerContainer->set_position(
+      Vector2(centerX - halfWidth, -centerY - halfHeight));
+  centerContainer->add_child(nodeName);
+  area2D->add_child(godotNode);
+  area2D->add_child(centerContainer);
+  geometry.shape = godotNode;
+  geometry.area = area2D;
+
+  // Create the ouline of the node
+  Line2D *outline = memnew(Line2D);
+  setBasicLineProps(outline);
+  std::vector<Line2D *> lines;
+  if (props.isDotted) {
+    points.push_back(points[0]);
+    createDashedLine(points, &geometry.shapeLines, area2D);
+  } else {
+    outline->set_points(points);
+    outline->add_point(points[0]);
+    geometry.shapeLines.push_back(outline);
+  }
+  // Set outline color and width, and add to the area
+  area2D->add_child(outline);
+  add_child(area2D);
+
+  // Nodes drawn while a selection is active must match the selection state
+  if (!selectedNodes.empty()) {
+    geometry.setTransparency(selectedNodes.contains(node)
+                                 ? SELECT_TRANSPARENCY
+                                 : UNSELECT_TRANSPARENCY);
+  }
+  return geometry;
+}
+
+VisualDataflow::EdgeGeometry &
+VisualDataflow::drawEdge(const DOTGraph::Edge *edge) {
+  const GodotGraph::EdgeProps &props = graph.getEdgeProperties(edge);
+  EdgeGeometry &geometry = edgeGeometries.try_emplace(edge).first->second;
+
+  Area2D *area2D = memnew(Area2D);
+  std::vector<std::pair<float, float>> positions = props.positions;
+  PackedVector2Array linePoints;
+
+  // Generate points for the edge line, inverting the y-axis due to a change
+  // of reference in Godot
+  for (auto [x, y] : llvm::drop_begin(positions, 1))
+    linePoints.push_back(Vector2(x, -y));
+
+  // Draw dashed or solid lines based on edge properties
+  if (props.isDotted) {
+    createDashedLine(linePoints, &geometry.segments, area2D);
+  } else {
+    Line2D *line = memnew(Line2D);
+    line->set_points(linePoints);
+    setBasicLineProps(line);
+    area2D->add_child(line);
+    geometry.segments.push_back(line);
+  }
+
+  size_t numPoints = linePoints.size();
+  Vector2 secondToLastPoint = linePoints[numPoints - 2];
+  Vector2 lastPoint = linePoints[numPoints - 1];
+
+  // Create and set up the arrowhead for the edge
+  Polygon2D *arrowheadPoly = memnew(Polygon2D);
+  arrowheadPoly->set_color(OPAQUE_BLACK);
+
+  PackedVector2Array points;
+  if (props.arrowhead == "normal") {
+    // Draw an arrow
+    if (secondToLastPoint.x == lastPoint.x) {
+      // Horizontal arrow
+      points.push_back(Vector2(lastPoint.x - 5, lastPoint.y));
+      points.push_back(Vector2(lastPoint.x + 5, lastPoint.y));
+      points.push_back(secondToLastPoint.y < lastPoint.y
+                           ? Vector2(lastPoint.x, lastPoint.y + 12)
+                           : Vector2(lastPoint.x, lastPoint.y - 12));
+    } else {
+      // Vertical arrow
+      points.push_back(Vector2(lastPoint.x, lastPoint.y + 5));
+      points.push_back(Vector2(lastPoint.x, lastPoint.y - 5));
+      points.push_back(secondToLastPoint.x < lastPoint.x
+                           ? Vector2(lastPoint.x + 12, lastPoint.y)
+                           : Vector2(lastPoint.x - 12, lastPoint.y));
+    }
+  } else {
+    // Draw a circle
+    double centerX = lastPoint.x, centerY = lastPoint.y, radius = 5;
+    if (secondToLastPoint.x == lastPoint.x) {
+      centerX = lastPoint.x;
+      if (secondToLastPoint.y < lastPoint.y) {
+        // Edge is going down
+        centerY += radius;
       } else {
-        // Define points for a diamond-shaped node
-        points.push_back(Vector2(centerX, -centerY + halfHeight));
-        points.push_back(Vector2(centerX + halfWidth, -centerY));
-        points.push_back(Vector2(centerX, -centerY - halfHeight));
-        points.push_back(Vector2(centerX - halfWidth, -centerY));
+        // Edge is going up
+        centerY -= radius;
       }
-
-      // The collision area is the same as the node itself
-      geometry.collision = points;
     } else {
-      // Create points to characterize an oval shape
-      double angle = 0;
-      double angleIncrement = 2 * M_PI / NUM_OVAL_POINTS;
-      for (unsigned i = 0; i < NUM_OVAL_POINTS; ++i) {
-        angle += angleIncrement;
-        double x = centerX + width / 2 * cos(angle);
-        double y = -centerY + NODE_HEIGHT / 2 * sin(angle);
-        points.push_back(Vector2(x, y));
+      centerY = lastPoint.y;
+      if (secondToLastPoint.x < lastPoint.x) {
+        // Edge is going right
+        centerX += radius;
+      } else {
+        // Edge is going left
+        centerX -= radius;
       }
+    }
+    double angle = 0;
+    double angleIncrement = 2 * M_PI / NUM_OVAL_POINTS;
+    for (unsigned i = 0; i < NUM_OVAL_POINTS; ++i) {
+      angle += angleIncrement;
+      double x = centerX + radius * cos(angle);
+      double y = centerY + radius * sin(angle);
+      points.push_back(Vector2(x, y));
+    }
+  }
 
-      // The collison area is a rectangle centered within the oval
-      PackedVector2Array rectanglePoints;
-      rectanglePoints.push_back(Vector2(centerX, -centerY + NODE_HEIGHT / 2));
-      rectanglePoints.push_back(Vector2(centerX + width / 2, -centerY));
-      rectanglePoints.push_back(Vector2(centerX, -centerY - NODE_HEIGHT / 2));
-      rectanglePoints.push_back(Vector2(centerX - width / 2, -centerY));
-      geometry.collision = rectanglePoints;
+  arrowheadPoly->set_polygon(points);
+  area2D->add_child(arrowheadPoly);
+  geometry.arrowhead = arrowheadPoly;
+  geometry.area = area2D;
+
+  // Create the label and configure it
+  geometry.data = memnew(RichTextLabel);
+  geometry.data->set_use_bbcode(true);
+  geometry.data->set_fit_content(true);
+  geometry.data->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
+  // Lightly offset the label toward the bottom right compared to the start
+  // of the line
+  Vector2 firstPoint = linePoints[0];
+  geometry.data->set_position(Vector2(firstPoint.x + 4, firstPoint.y + 4));
+
+  add_child(geometry.data);
+  add_child(area2D);
+
+  // In differential mode, make channels behaving differently in the two traces
+  // stand out
+  if (diff) {
+    const TraceDiff::ChannelDiff *chanDiff = diff->getChannelDiff(edge);
+    if (chanDiff && chanDiff->diverges()) {
+      for (Line2D *seg : geometry.segments)
+        seg->set_width(DIVERGENT_LINE_WIDTH);
     }
+  }
 
-    // Sets the node's polygon and color
-    godotNode->set_polygon(points);
-    godotNode->set_color(NAMED_COLORS.count(props.color)
-                             ? NAMED_COLORS.at(props.color)
-                             : OPAQUE_WHITE);
+  // Edges drawn while a selection is active must match the selection state
+  if (!selectedNodes.empty()) {
+    geometry.setTransparency(selectedEdges.contains(edge)
+                                 ? SELECT_TRANSPARENCY
+                                 : UNSELECT_TRANSPARENCY);
+  }
+  return geometry;
+}
 
-    // Create the label and configure it
-    RichTextLabel *nodeName = memnew(RichTextLabel);
-    nodeName->set_use_bbcode(true);
-    nodeName->set_fit_content(true);
-    nodeName->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
-    nodeName->set_position(Vector2(centerX, -centerY));
+/// Returns the range of grid cells covered by the rectangle, in Godot
+/// coordinates.
+static std::pair<Vector2i, Vector2i> getCellRange(const Rect2 &rect,
+                                                  double cellSize) {
+  Vector2 end = rect.get_end();
+  return {Vector2i(std::floor(rect.position.x / cellSize),
+                   std::floor(rect.position.y / cellSize)),
+          Vector2i(std::floor(end.x / cellSize),
+                   std::floor(end.y / cellSize))};
+}
 
-    // Set the label's content
-    nodeName->push_font(get_theme_default_font(), 11);
-    nodeName->push_color(OPAQUE_BLACK);
-    std::string text = "[center]" + node->id + "[/center]";
-    nodeName->append_text(text.c_str());
-    nodeName->pop();
-    nodeName->pop();
-
-    // Create a container for the label and the node
-    CenterContainer *centerContainer = memnew(CenterContainer);
-    centerContainer->set_size(Vector2(width, NODE_HEIGHT));
-    centerContainer->set_position(
-        Vector2(centerX - halfWidth, -centerY - halfHeight));
-    centerContainer->add_child(nodeName);
-    area2D->add_child(godotNode);
-    area2D->add_child(centerContainer);
-    geometry.shape = godotNode;
-
-    // Create the ouline of the node
-    Line2D *outline = memnew(Line2D);
-    setBasicLineProps(outline);
-    std::vector<Line2D *> lines;
-    if (props.isDotted) {
-      points.push_back(points[0]);
-      createDashedLine(points, &geometry.shapeLines, area2D);
-    } else {
-      outline->set_points(points);
-      outline->add_point(points[0]);
-      geometry.shapeLines.push_back(outline);
+void VisualDataflow::buildGrid() {
+  auto insert = [&](const Rect2 &rect, auto addToCell) {
+    auto [first, last] = getCellRange(rect, GRID_CELL_SIZE);
+    for (int64_t x = first.x; x <= last.x; ++x) {
+      for (int64_t y = first.y; y <= last.y; ++y)
+        addToCell(grid[{x, y}]);
     }
-    // Set outline color and width, and add to the area
-    area2D->add_child(outline);
-    add_child(area2D);
+  };
+
+  for (const auto &nodeAndProps : graph.getNodes()) {
+    const DOTGraph::Node *node = nodeAndProps.first;
+    auto [centerX, centerY] = nodeAndProps.second.position;
+    double width = nodeAndProps.second.width * NODE_WIDTH_SCALING_COEFFICIENT;
+    Rect2 rect(centerX - width / 2, -centerY - NODE_HEIGHT / 2, width,
+               NODE_HEIGHT);
+    insert(rect, [&](GridCell &cell) { cell.nodes.push_back(node); });
+  }
+
+  for (const auto &edgeAndProps : graph.getEdges()) {
+    const DOTGraph::Edge *edge = edgeAndProps.first;
+    const std::vector<std::pair<float, float>> &positions =
+        edgeAndProps.second.positions;
+    if (positions.empty())
+      continue;
+    Rect2 rect(positions.front().first, -positions.front().second, 0, 0);
+    for (auto [x, y] : positions)
+      rect = rect.expand(Vector2(x, -y));
+    insert(rect, [&](GridCell &cell) { cell.edges.push_back(edge); });
   }
+}
 
-  for (const DOTGraph::Edge *edge : sub.edges) {
-    const GodotGraph::EdgeProps &props = graph.getEdgeProperties(edge);
-    EdgeGeometry &geometry = edgeGeometries.try_emplace(edge).first->second;
+void VisualDataflow::drawGraph() {
+  for (const std::unique_ptr<Region> &region : graph.getRegions())
+    drawRegion(*region);
+  buildGrid();
+
+  // Large graphs start fully collapsed so that only their outermost regions
+  // are drawn until the user expands them
+  if (graph.getNodes().size() > LOD_NODE_THRESHOLD)
+    collapseAll();
+  else
+    refresh();
+}
 
-    Area2D *area2D = memnew(Area2D);
-    std::vector<std::pair<float, float>> positions = props.positions;
-    PackedVector2Array linePoints;
+const VisualDataflow::Region *
+VisualDataflow::getCollapsedRegion(const DOTGraph::Node *node) const {
+  const Region *collapsed = nullptr;
+  for (const Region *reg = graph.getRegion(node); reg; reg = reg->parent) {
+    if (collapsedRegions.contains(reg))
+      collapsed = reg;
+  }
+  return collapsed;
+}
 
-    // Generate points for the edge line, inverting the y-axis due to a change
-    // of reference in Godot
-    for (auto [x, y] : llvm::drop_begin(positions, 1))
-      linePoints.push_back(Vector2(x, -y));
+bool VisualDataflow::isInsideCollapsed(const Region &region) const {
+  for (const Region *reg = region.parent; reg; reg = reg->parent) {
+    if (collapsedRegions.contains(reg))
+      return true;
+  }
+  return false;
+}
 
-    // Draw dashed or solid lines based on edge properties
-    if (props.isDotted) {
-      createDashedLine(linePoints, &geometry.segments, area2D);
-    } else {
-      Line2D *line = memnew(Line2D);
-      line->set_points(linePoints);
-      setBasicLineProps(line);
-      area2D->add_child(line);
-      geometry.segments.push_back(line);
+bool VisualDataflow::isInViewport(const Region &region) const {
+  auto [xMin, yMin, xMax, yMax] = region.bounds;
+  return viewport &&
+         viewport->intersects(Rect2(xMin, -yMax, xMax - xMin, yMax - yMin));
+}
+
+void VisualDataflow::refresh() {
+  if (!viewport)
+    return;
+
+  // Regions are few compared to nodes and edges, so it is fine to go over all
+  // of them every time
+  visibleCollapsedRegions.clear();
+  for (const std::unique_ptr<Region> &region : graph.getRegions()) {
+    RegionGeometry &geometry = regionGeometries[region.get()];
+    bool hidden = isInsideCollapsed(*region) || !isInViewport(*region);
+    bool collapsed = !hidden && collapsedRegions.contains(region.get());
+    geometry.setExpanded(!hidden && !collapsed);
+    geometry.setCollapsed(collapsed);
+    if (collapsed) {
+      visibleCollapsedRegions.insert(region.get());
+      drawRegionActivity(*region);
     }
+  }
 
-    size_t numPoints = linePoints.size();
-    Vector2 secondToLastPoint = linePoints[numPoints - 2];
-    Vector2 lastPoint = linePoints[numPoints - 1];
-
-    // Create and set up the arrowhead for the edge
-    Polygon2D *arrowheadPoly = memnew(Polygon2D);
-    arrowheadPoly->set_color(OPAQUE_BLACK);
-
-    PackedVector2Array points;
-    if (props.arrowhead == "normal") {
-      // Draw an arrow
-      if (secondToLastPoint.x == lastPoint.x) {
-        // Horizontal arrow
-        points.push_back(Vector2(lastPoint.x - 5, lastPoint.y));
-        points.push_back(Vector2(lastPoint.x + 5, lastPoint.y));
-        points.push_back(secondToLastPoint.y < lastPoint.y
-                             ? Vector2(lastPoint.x, lastPoint.y + 12)
-                             : Vector2(lastPoint.x, lastPoint.y - 12));
-      } else {
-        // Vertical arrow
-        points.push_back(Vector2(lastPoint.x, lastPoint.y + 5));
-        points.push_back(Vector2(lastPoint.x, lastPoint.y - 5));
-        points.push_back(secondToLastPoint.x < lastPoint.x
-                             ? Vector2(lastPoint.x + 12, lastPoint.y)
-                             : Vector2(lastPoint.x - 12, lastPoint.y));
+  // Find nodes and edges intersecting with the viewport which are not hidden
+  // inside a collapsed region
+  DenseSet<const DOTGraph::Node *> newNodes;
+  DenseSet<const DOTGraph::Edge *> newEdges;
+  auto [first, last] = getCellRange(*viewport, GRID_CELL_SIZE);
+  for (int64_t x = first.x; x <= last.x; ++x) {
+    for (int64_t y = first.y; y <= last.y; ++y) {
+      auto cellIt = grid.find({x, y});
+      if (cellIt == grid.end())
+        continue;
+      for (const DOTGraph::Node *node : cellIt->second.nodes) {
+        if (!getCollapsedRegion(node))
+          newNodes.insert(node);
       }
-    } else {
-      // Draw a circle
-      double centerX = lastPoint.x, centerY = lastPoint.y, radius = 5;
-      if (secondToLastPoint.x == lastPoint.x) {
-        centerX = lastPoint.x;
-        if (secondToLastPoint.y < lastPoint.y) {
-          // Edge is going down
-          centerY += radius;
-        } else {
-          // Edge is going up
-          centerY -= radius;
-        }
-      } else {
-        centerY = lastPoint.y;
-        if (secondToLastPoint.x < lastPoint.x) {
-          // Edge is going right
-          centerX += radius;
-        } else {
-          // Edge is going left
-          centerX -= radius;
-        }
-      }
-      double angle = 0;
-      double angleIncrement = 2 * M_PI / NUM_OVAL_POINTS;
-      for (unsigned i = 0; i < NUM_OVAL_POINTS; ++i) {
-        angle += angleIncrement;
-        double x = centerX + radius * cos(angle);
-        double y = centerY + radius * sin(angle);
-        points.push_back(Vector2(x, y));
+      for (const DOTGraph::Edge *edge : cellIt->second.edges) {
+        // Edges between two nodes inside the same collapsed region are hidden,
+        // those crossing the region's boundary remain visible
+        const Region *srcRegion = getCollapsedRegion(edge->srcNode);
+        if (!srcRegion || srcRegion != getCollapsedRegion(edge->dstNode))
+          newEdges.insert(edge);
       }
     }
+  }
 
-    arrowheadPoly->set_polygon(points);
-    area2D->add_child(arrowheadPoly);
-    geometry.arrowhead = arrowheadPoly;
+  // Hide elements that are no longer visible...
+  for (const DOTGraph::Node *node : visibleNodes) {
+    if (!newNodes.contains(node))
+      nodeGeometries.find(node)->second.area->set_visible(false);
+  }
+  for (const DOTGraph::Edge *edge : visibleEdges) {
+    if (!newEdges.contains(edge))
+      edgeGeometries.find(edge)->second.setVisible(false);
+  }
 
-    // Create the label and configure it
-    geometry.data = memnew(RichTextLabel);
-    geometry.data->set_use_bbcode(true);
-    geometry.data->set_fit_content(true);
-    geometry.data->set_autowrap_mode(TextServer::AUTOWRAP_OFF);
-    // Lightly offset the label toward the bottom right compared to the start
-    // of the line
-    Vector2 firstPoint = linePoints[0];
-    geometry.data->set_position(Vector2(firstPoint.x + 4, firstPoint.y + 4));
-
-    add_child(geometry.data);
-    add_child(area2D);
+  // ...and show new ones, drawing them the first time they become visible.
+  // Edge states are only updated for visible edges, so they must be redrawn
+  // when they reappear
+  for (const DOTGraph::Node *node : newNodes) {
+    if (visibleNodes.contains(node))
+      continue;
+    if (auto it = nodeGeometries.find(node); it != nodeGeometries.end())
+      it->second.area->set_visible(true);
+    else
+      drawNode(node);
+  }
+  for (const DOTGraph::Edge *edge : newEdges) {
+    if (visibleEdges.contains(edge))
+      continue;
+    EdgeGeometry *geo;
+    if (auto it = edgeGeometries.find(edge); it != edgeGeometries.end()) {
+      geo = &it->second;
+      geo->setVisible(true);
+    } else {
+      geo = &drawEdge(edge);
+    }
+    drawEdgeState(edge, *geo);
   }
 
-  for (const DOTGraph::Subgraph *subsub : sub.subgraphs)
-    drawSubgraph(*subsub, false);
+  visibleNodes = std::move(newNodes);
+  visibleEdges = std::move(newEdges);
 }
 
-void VisualDataflow::drawGraph() {
-  drawSubgraph(graph.getGraph().getRoot(), true);
+void VisualDataflow::updateViewport(Rect2 area) {
+  viewport = area;
+  refresh();
+}
+
+void VisualDataflow::toggleRegion(Vector2 position) {
+  // Expand the collapsed region under the position, if any
+  for (const Region *region : visibleCollapsedRegions) {
+    auto [xMin, yMin, xMax, yMax] = region->bounds;
+    Rect2 rect(xMin, -yMax, xMax - xMin, yMax - yMin);
+    if (rect.has_point(position)) {
+      collapsedRegions.erase(region);
+      refresh();
+      return;
+    }
+  }
+
+  // Otherwise collapse the innermost visible region containing the position.
+  // Regions are ordered such that nested regions come after enclosing ones
+  const Region *innermost = nullptr;
+  for (const std::unique_ptr<Region> &region : graph.getRegions()) {
+    auto [xMin, yMin, xMax, yMax] = region->bounds;
+    Rect2 rect(xMin, -yMax, xMax - xMin, yMax - yMin);
+    if (rect.has_point(position) && !isInsideCollapsed(*region))
+      innermost = region.get();
+  }
+  if (innermost) {
+    collapsedRegions.insert(innermost);
+    refresh();
+  }
+}
+
+void VisualDataflow::collapseAll() {
+  for (const std::unique_ptr<Region> &region : graph.getRegions())
+    collapsedRegions.insert(region.get());
+  refresh();
+}
+
+void VisualDataflow::expandAll() {
+  collapsedRegions.clear();
+  refresh();
 }
 
 void VisualDataflow::nextCycle() {
@@ -421,26 +697,88 @@ void VisualDataflow::drawCycle() {
   cycleLabel->set_text("Cycle: " + String::num_uint64(cycle));
   cycleSlider->set_value(cycle);
 
-  for (const auto &[edge, edgeState] : graph.getChanges(cycle)) {
-    assert(edgeGeometries.contains(edge) && "unknown edge");
-    EdgeGeometry &geo = edgeGeometries.getOrInsertDefault(edge);
-    const Color &color = stateColors.at(edgeState.state);
-    geo.setColor(color);
-
-    // Display channel content if the valid wire is set
-    geo.data->clear();
-    if (edgeState.state == DataflowState::STALL ||
-        edgeState.state == DataflowState::TRANSFER) {
-      // Write the data value only when it is valid
-      geo.data->push_font(get_theme_default_font(), 11);
-      geo.data->push_color(OPAQUE_BLACK);
-      geo.data->append_text(edgeState.data.c_str());
-      geo.data->pop();
-      geo.data->pop();
+  // Only what is on screen needs to be updated; hidden edges are redrawn when
+  // they become visible again
+  for (const DOTGraph::Edge *edge : visibleEdges)
+    drawEdgeState(edge, edgeGeometries.find(edge)->second);
+  for (const Region *region : visibleCollapsedRegions)
+    drawRegionActivity(*region);
+}
+
+void VisualDataflow::drawEdgeState(const DOTGraph::Edge *edge,
+                                   EdgeGeometry &geo) {
+  // Edge case where there are no cycles
+  if (maxCycle == 0)
+    return;
+
+  const GodotGraph::Transitions &changes = graph.getChanges(cycle);
+  auto it = changes.find(edge);
+  if (it == changes.end())
+    return;
+  const EdgeState &edgeState = it->second;
+  geo.setColor(stateColors.at(edgeState.state));
+
+  // Display channel content if the valid wire is set
+  geo.data->clear();
+  if (edgeState.state == DataflowState::STALL ||
+      edgeState.state == DataflowState::TRANSFER) {
+    // Write the data value only when it is valid
+    geo.data->push_font(get_theme_default_font(), 11);
+    geo.data->push_color(OPAQUE_BLACK);
+    geo.data->append_text(edgeState.data.c_str());
+    geo.data->pop();
+    geo.data->pop();
+
+    // In differential mode, show by how many cycles the token is delayed in
+    // the second trace
+    const TraceDiff::ChannelDiff *chanDiff =
+        diff ? diff->getChannelDiff(edge) : nullptr;
+    if (chanDiff && edgeState.state == DataflowState::TRANSFER) {
+      std::optional<int> offset = chanDiff->getOffset(cycle);
+      if (offset && *offset) {
+        std::string text = " (" + std::string(*offset > 0 ? "+" : "") +
+                           std::to_string(*offset) + ")";
+        geo.data->push_font(get_theme_default_font(), 11);
+        geo.data->push_color(DIVERGENCE_COLOR);
+        geo.data->append_text(text.c_str());
+        geo.data->pop();
+        geo.data->pop();
+      }
     }
   }
 }
 
+void VisualDataflow::drawRegionActivity(const Region &region) {
+  RegionGeometry &geo = regionGeometries.find(&region)->second;
+  GodotGraph::RegionActivity activity = graph.getActivity(region, cycle);
+
+  // Tint the region with the color of the states its channels are in, in
+  // proportion to the number of channels in these states
+  Color color = COLLAPSED_REGION_COLOR;
+  if (size_t numChannels = region.innerEdges.size()) {
+    color = color.lerp(stateColors.at(DataflowState::TRANSFER),
+                       (double)activity.numTransfers / numChannels);
+    color = color.lerp(stateColors.at(DataflowState::STALL),
+                       (double)activity.numStalls / numChannels);
+  }
+  color.a = geo.box->get_color().a;
+  geo.box->set_color(color);
+
+  std::string text = "[center]" + region.label + "\n" +
+                     std::to_string(region.nodes.size()) + " units, " +
+                     std::to_string(region.innerEdges.size()) +
+                     " channels\ntransfers: " +
+                     std::to_string(activity.numTransfers) +
+                     ", stalls: " + std::to_string(activity.numStalls) +
+                     "[/center]";
+  geo.summary->clear();
+  geo.summary->push_font(get_theme_default_font(), 12);
+  geo.summary->push_color(OPAQUE_BLACK);
+  geo.summary->append_text(text.c_str());
+  geo.summary->pop();
+  geo.summary->pop();
+}
+
 void VisualDataflow::changeStateColor(int64_t state, Color color) {
   static const std::array<DataflowState, 5> intToState = {
       DataflowState::UNDEFINED, DataflowState::IDLE, DataflowState::ACCEPT,
@@ -451,14 +789,16 @@ void VisualDataflow::changeStateColor(int64_t state, Color color) {
   DataflowState stateEnum = intToState[state];
   stateColors.insert_or_assign(stateEnum, color);
 
-  // Change color of all edges currently in the state whose color was changed
-  for (const auto &[edge, edgeState] : graph.getChanges(cycle)) {
-    if (edgeState.state == stateEnum) {
-      Color &color = stateColors[edgeState.state];
-      assert(edgeGeometries.contains(edge) && "unknown edge");
-      edgeGeometries.getOrInsertDefault(edge).setColor(color);
-    }
+  // Change color of all visible edges currently in the state whose color was
+  // changed
+  const GodotGraph::Transitions &changes = graph.getChanges(cycle);
+  for (const DOTGraph::Edge *edge : visibleEdges) {
+    auto it = changes.find(edge);
+    if (it != changes.end() && it->second.state == stateEnum)
+      edgeGeometries.find(edge)->second.setColor(color);
   }
+  for (const Region *region : visibleCollapsedRegions)
+    drawRegionActivity(*region);
 }
 
 static double crossProduct(Vector2 a, Vector2 b, Vector2 c) {
@@ -472,6 +812,8 @@ static bool isInside(Vector2 p, Vector2 a, Vector2 b, Vector2 c, Vector2 d) {
 
 void VisualDataflow::onClick(Vector2 position) {
   for (auto &[node, geometry] : nodeGeometries) {
+    if (!visibleNodes.contains(node))
+      continue;
     PackedVector2Array &points = geometry.collision;
     if (!isInside(position, points[0], points[1], points[2], points[3]))
       continue;
@@ -500,8 +842,10 @@ void VisualDataflow::onClick(Vector2 position) {
           doubleSelected = false;
         } else {
           edgesToUnselect.insert(edge);
-          edgeGeometries.getOrInsertDefault(edge).setTransparency(
-              UNSELECT_TRANSPARENCY);
+          // Edges that were never drawn get their transparency when drawn
+          if (auto geoIt = edgeGeometries.find(edge);
+              geoIt != edgeGeometries.end())
+            geoIt->second.setTransparency(UNSELECT_TRANSPARENCY);
         }
       }
       llvm::for_each(edgesToUnselect,
@@ -527,8 +871,9 @@ void VisualDataflow::onClick(Vector2 position) {
           it->getSecond() = true;
         } else {
           selectedEdges.insert({edge, false});
-          edgeGeometries.getOrInsertDefault(edge).setTransparency(
-              SELECT_TRANSPARENCY);
+          if (auto geoIt = edgeGeometries.find(edge);
+              geoIt != edgeGeometries.end())
+            geoIt->second.setTransparency(SELECT_TRANSPARENCY);
         }
       }
     }
@@ -562,6 +907,22 @@ void VisualDataflow::EdgeGeometry::setColor(Color color) {
   arrowhead->set_color(color);
 }
 
+void VisualDataflow::EdgeGeometry::setVisible(bool visible) {
+  area->set_visible(visible);
+  data->set_visible(visible);
+}
+
+void VisualDataflow::RegionGeometry::setExpanded(bool expanded) {
+  if (frame)
+    frame->set_visible(expanded);
+  if (frameLabel)
+    frameLabel->set_visible(expanded);
+}
+
+void VisualDataflow::RegionGeometry::setCollapsed(bool collapsed) {
+  box->set_visible(collapsed);
+}
+
 void VisualDataflow::resetSelection() {
   selectedNodes.clear();
   selectedEdges.clear();
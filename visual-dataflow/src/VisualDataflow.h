@@ -14,7 +14,9 @@
 #define DYNAMATIC_VISUAL_DATAFLOW_VISUAL_DATAFLOW_H
 
 #include "Graph.h"
+#include "TraceDiff.h"
 #include "dynamatic/Support/DOT.h"
+#include "godot_cpp/classes/area2d.hpp"
 #include "godot_cpp/classes/control.hpp"
 #include "godot_cpp/classes/h_slider.hpp"
 #include "godot_cpp/classes/label.hpp"
@@ -22,8 +24,11 @@
 #include "godot_cpp/classes/polygon2d.hpp"
 #include "godot_cpp/classes/rich_text_label.hpp"
 #include "godot_cpp/variant/color.hpp"
+#include "godot_cpp/variant/rect2.hpp"
 #include "godot_cpp/variant/string.hpp"
 #include "godot_cpp/variant/vector2.hpp"
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace godot {
@@ -40,6 +45,16 @@ public:
   void start(const godot::String &dotFilepath,
              const godot::String &csvFilepath);
 
+  /// Draws the graph like `start` in differential mode, comparing its trace
+  /// with the trace of a second version of the same circuit (whose DOT may
+  /// differ, e.g., by the placement of buffers). Channels behaving differently
+  /// in the two traces are highlighted and a report of all differences is
+  /// printed to the standard output.
+  void startDiff(const godot::String &dotFilepath,
+                 const godot::String &csvFilepath,
+                 const godot::String &otherDotFilepath,
+                 const godot::String &otherCSVFilepath);
+
   /// Draws in Godot the state of the graph in its next cycle
   void nextCycle();
   /// Draws in Godot the state of the graph in its previous cycle
@@ -52,6 +67,16 @@ public:
   void onClick(Vector2 position);
   /// Reset the selection of nodes
   void resetSelection();
+  /// Sets the area of the graph visible on screen, in Godot coordinates. Only
+  /// graph elements intersecting with it are drawn.
+  void updateViewport(Rect2 area);
+  /// Expands the collapsed region at the position if there is one; otherwise
+  /// collapses the innermost region containing the position, if any.
+  void toggleRegion(Vector2 position);
+  /// Collapses all regions of the graph.
+  void collapseAll();
+  /// Expands all regions of the graph.
+  void expandAll();
 
   ~VisualDataflow() override = default;
 
@@ -61,7 +86,16 @@ protected:
   static void _bind_methods();
 
 private:
+  using Region = dynamatic::visual::GodotGraph::Region;
+
+  /// Graphs with more nodes than this are initially displayed with all their
+  /// regions collapsed.
+  static constexpr size_t LOD_NODE_THRESHOLD = 300;
+  /// Size of the cells of the spatial grid used for viewport culling.
+  static constexpr double GRID_CELL_SIZE = 256;
+
   struct NodeGeometry {
+    Area2D *area;
     PackedVector2Array collision;
     Polygon2D *shape;
     std::vector<Line2D *> shapeLines;
@@ -70,6 +104,7 @@ private:
   };
 
   struct EdgeGeometry {
+    Area2D *area;
     std::vector<Line2D *> segments;
     Polygon2D *arrowhead;
     RichTextLabel *data;
@@ -77,16 +112,59 @@ private:
     void setTransparency(double transparency);
 
     void setColor(Color color);
+
+    void setVisible(bool visible);
+  };
+
+  /// Visual elements to represent a region, either expanded or collapsed.
+  struct RegionGeometry {
+    /// Frame and label drawn behind the nodes of an expanded basic block.
+    Polygon2D *frame = nullptr;
+    RichTextLabel *frameLabel = nullptr;
+    /// Box and aggregated activity standing for the region when collapsed.
+    Polygon2D *box = nullptr;
+    RichTextLabel *summary = nullptr;
+
+    void setExpanded(bool expanded);
+    void setCollapsed(bool collapsed);
+  };
+
+  /// Graph elements whose bounding box intersects with one cell of the spatial
+  /// grid.
+  struct GridCell {
+    std::vector<const dynamatic::DOTGraph::Node *> nodes;
+    std::vector<const dynamatic::DOTGraph::Edge *> edges;
   };
 
   /// The underlying graph we are visualizing.
   dynamatic::visual::GodotGraph graph;
+  /// In differential mode, the graph holding the trace to compare against.
+  std::unique_ptr<dynamatic::visual::GodotGraph> otherGraph;
+  /// In differential mode, the comparison between the two traces.
+  std::unique_ptr<dynamatic::visual::TraceDiff> diff;
   /// Visual elements to represent each node.
   mlir::DenseMap<const dynamatic::DOTGraph::Node *, NodeGeometry>
       nodeGeometries;
   /// Visual elements to represent each edge.
   mlir::DenseMap<const dynamatic::DOTGraph::Edge *, EdgeGeometry>
       edgeGeometries;
+  /// Visual elements to represent each region.
+  mlir::DenseMap<const Region *, RegionGeometry> regionGeometries;
+
+  /// Uniform grid bucketing graph elements by position, indexed by cell
+  /// coordinates.
+  mlir::DenseMap<std::pair<int64_t, int64_t>, GridCell> grid;
+  /// Area of the graph visible on screen, in Godot coordinates.
+  std::optional<Rect2> viewport;
+  /// Set of currently collapsed regions. A region nested within a collapsed
+  /// region is hidden regardless of whether it is collapsed.
+  mlir::DenseSet<const Region *> collapsedRegions;
+  /// Nodes currently drawn on screen.
+  mlir::DenseSet<const dynamatic::DOTGraph::Node *> visibleNodes;
+  /// Edges currently drawn on screen.
+  mlir::DenseSet<const dynamatic::DOTGraph::Edge *> visibleEdges;
+  /// Collapsed regions currently drawn on screen.
+  mlir::DenseSet<const Region *> visibleCollapsedRegions;
 
   /// Maximum number of cycles.
   unsigned maxCycle;
@@ -111,9 +189,31 @@ private:
   Label *cycleLabel;
   HSlider *cycleSlider;
 
-  void drawSubgraph(const dynamatic::DOTGraph::Subgraph &sub, bool isRoot);
-  /// Draws each component of the graph in Godot
+  /// Creates the visual elements of the node.
+  NodeGeometry &drawNode(const dynamatic::DOTGraph::Node *node);
+  /// Creates the visual elements of the edge.
+  EdgeGeometry &drawEdge(const dynamatic::DOTGraph::Edge *edge);
+  /// Creates the visual elements of the region.
+  void drawRegion(const Region &region);
+  /// Prepares the graph for drawing; visual elements of nodes and edges are
+  /// created lazily, when they first become visible.
   void drawGraph();
+  /// Buckets all nodes and edges in the spatial grid.
+  void buildGrid();
+  /// Returns the outermost collapsed region containing the node, if any.
+  const Region *getCollapsedRegion(const dynamatic::DOTGraph::Node *node) const;
+  /// Determines whether the region is hidden inside a collapsed region.
+  bool isInsideCollapsed(const Region &region) const;
+  /// Determines whether the region intersects with the viewport.
+  bool isInViewport(const Region &region) const;
+  /// Draws, shows, and hides graph elements depending on the viewport and on
+  /// which regions are collapsed.
+  void refresh();
+  /// Colors the edge and displays its data according to its current state.
+  void drawEdgeState(const dynamatic::DOTGraph::Edge *edge, EdgeGeometry &geo);
+  /// Displays the aggregated activity of the collapsed region in the current
+  /// cycle.
+  void drawRegionActivity(const Region &region);
   /// Modifies the transparency of all graph elements
   void setGraphTransparency(double transparency);
   /// Draw the current cycle.